@@ -54,7 +54,7 @@ boolean audio_data_init_flag = false;
 
 String lrc_time[100];
 String lrc_text[100];
-Mp3Info mp3_list_info[20];
+std::vector<Mp3Info> mp3_list_info;
 unsigned long lrc_time_millis[100];
 long now_time = 0;
 long running_time = 0;
@@ -62,7 +62,7 @@ int lrc_show_index = 0;
 String mp3_url;
 int play_pos = 0;
 lv_timer_t *lrc_timer_lrc;
-lv_obj_t *ui_Image8[10];
+lv_obj_t *play_list = NULL;
 int wifi_nums = 0;
 bool net_is_ok = false;
 bool sd_is_ok = false;
@@ -386,7 +386,7 @@ void ui_event_Button4(lv_event_t *e)
         }
     }
 }
-char *all_songs[99];
+std::vector<String> all_songs;
 int is_have_music = 0;
 
 void listDirMusic(fs::FS &fs, const char *dirname, uint8_t levels)
@@ -406,7 +406,6 @@ void listDirMusic(fs::FS &fs, const char *dirname, uint8_t levels)
     }
 
     File file = root.openNextFile();
-    int i = 0;
     while (file)
     {
         if (file.isDirectory())
@@ -423,25 +422,128 @@ void listDirMusic(fs::FS &fs, const char *dirname, uint8_t levels)
 
             char *filename = (char *)file.name();
             Serial.println(filename);
-            int8_t len = strlen(filename);
-            if (strstr(strlwr(filename + (len - 4)), ".mp3"))
+            size_t len = strlen(filename);
+            if (len >= 4 && strstr(strlwr(filename + (len - 4)), ".mp3"))
             {
 
-                all_songs[i] = new char[len]; // new memory
+                all_songs.push_back(filename);
                 is_have_music = 1;
-                strcpy(all_songs[i], filename);
-                Serial.print("out:");
-                Serial.println(filename);
                 Serial.print("songs:");
-                Serial.println(all_songs[i]);
-
-                i += 1;
+                Serial.println(filename);
             }
         }
         file = root.openNextFile();
     }
 }
 
+// The play list shows the songs on a few reused rows (lv_vlist), so any number of songs fits
+static lv_obj_t *play_list_create_row(lv_obj_t *list)
+{
+    lv_obj_t *ui_Panel10;
+    lv_obj_t *ui_Label24;
+    lv_obj_t *ui_Label22;
+    lv_obj_t *ui_Label25;
+    lv_obj_t *ui_Image8;
+
+    ui_Panel10 = lv_obj_create(list);
+    lv_obj_set_width(ui_Panel10, 509);
+    lv_obj_set_height(ui_Panel10, 87);
+    lv_obj_clear_flag(ui_Panel10, LV_OBJ_FLAG_SCROLLABLE); /// Flags
+    lv_obj_set_style_bg_color(ui_Panel10, lv_color_hex(0x171717), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_Panel10, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(ui_Panel10, ui_event_play_list, LV_EVENT_ALL, NULL);
+
+    ui_Label24 = lv_label_create(ui_Panel10);
+    lv_obj_set_width(ui_Label24, LV_SIZE_CONTENT);  /// 1
+    lv_obj_set_height(ui_Label24, LV_SIZE_CONTENT); /// 1
+    lv_obj_set_x(ui_Label24, 49);
+    lv_obj_set_y(ui_Label24, -12);
+    lv_obj_set_align(ui_Label24, LV_ALIGN_LEFT_MID);
+    lv_obj_set_style_text_font(ui_Label24, &ui_font_Font1YHall20, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_Label25 = lv_label_create(ui_Panel10);
+    lv_obj_set_width(ui_Label25, 70);               /// 1
+    lv_obj_set_height(ui_Label25, LV_SIZE_CONTENT); /// 1
+    lv_obj_set_x(ui_Label25, 49);
+    lv_obj_set_y(ui_Label25, 17);
+    lv_obj_set_align(ui_Label25, LV_ALIGN_LEFT_MID);
+    lv_label_set_long_mode(ui_Label25, LV_LABEL_LONG_SCROLL_CIRCULAR);
+    lv_obj_set_style_text_font(ui_Label25, &ui_font_Font1YHall16, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_Label22 = lv_label_create(ui_Panel10);
+    lv_obj_set_width(ui_Label22, LV_SIZE_CONTENT);  /// 1
+    lv_obj_set_height(ui_Label22, LV_SIZE_CONTENT); /// 1
+    lv_obj_set_x(ui_Label22, 125);
+    lv_obj_set_y(ui_Label22, 18);
+    lv_obj_set_align(ui_Label22, LV_ALIGN_LEFT_MID);
+    lv_obj_set_style_text_font(ui_Label22, &ui_font_Font1YHall16, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_Image8 = lv_img_create(ui_Panel10);
+    lv_obj_set_width(ui_Image8, LV_SIZE_CONTENT);  /// 48
+    lv_obj_set_height(ui_Image8, LV_SIZE_CONTENT); /// 48
+    lv_obj_set_x(ui_Image8, -215);
+    lv_obj_set_y(ui_Image8, 0);
+    lv_obj_set_align(ui_Image8, LV_ALIGN_CENTER);
+    lv_obj_add_flag(ui_Image8, LV_OBJ_FLAG_ADV_HITTEST);  /// Flags
+    lv_obj_clear_flag(ui_Image8, LV_OBJ_FLAG_SCROLLABLE); /// Flags
+
+    return ui_Panel10;
+}
+
+static void play_list_bind_row(lv_obj_t *list, lv_obj_t *row, uint32_t index)
+{
+    const Mp3Info &info = mp3_list_info[index];
+    bool from_sd = !net_is_ok && sd_is_ok && is_have_music;
+
+    lv_label_set_text(lv_obj_get_child(row, 0), info.name.c_str());
+    lv_label_set_text(lv_obj_get_child(row, 1), from_sd ? "" : info.singer.c_str());
+    lv_label_set_text(lv_obj_get_child(row, 2), from_sd ? "" : info.bl.c_str());
+    lv_img_set_src(lv_obj_get_child(row, 3), info.isplaying ? &ui_img_list_pause_icon_png : &ui_img_list_play_icon_png);
+}
+
+void play_list_init()
+{
+    if (play_list == NULL)
+    {
+        play_list = lv_vlist_create(ui_Panel13);
+        lv_obj_set_width(play_list, lv_pct(100));
+        lv_obj_set_height(play_list, lv_pct(100));
+        lv_obj_set_align(play_list, LV_ALIGN_CENTER);
+        lv_obj_set_scrollbar_mode(play_list, LV_SCROLLBAR_MODE_ACTIVE);
+        lv_obj_set_style_bg_opa(play_list, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_width(play_list, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_pad_all(play_list, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_pad_row(play_list, 13, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_vlist_set_row_cb(play_list, play_list_create_row, play_list_bind_row);
+    }
+    lv_vlist_set_row_cnt(play_list, mp3_list_info.size());
+    lv_vlist_refresh(play_list);
+}
+
+// Show the play/pause icons again after isplaying changed
+void update_play_list()
+{
+    if (play_list != NULL)
+    {
+        lv_vlist_refresh(play_list);
+    }
+}
+
+// A random song other than the current one
+static int random_play_index(int last_index)
+{
+    int count = mp3_list_info.size();
+    if (count < 2)
+        return 0;
+
+    int index = random(0, count);
+    while (index == last_index)
+    {
+        index = random(0, count);
+    }
+    return index;
+}
+
 void audio_data_init_sd(void *pvParameters)
 {
     delay(1000);
@@ -453,77 +555,21 @@ void audio_data_init_sd(void *pvParameters)
         // audioInit();
         // audio.setVolume(20); // 0...21
         // Serial.println("audio init");
-        int pos = -85;
-        for (int i = 0; i < 99; i++)
+        mp3_list_info.clear();
+        for (int i = 0; i < (int)all_songs.size(); i++)
         {
-            if (all_songs[i] != NULL)
-            {
-                mp3_list_info[i].id = i;
-                mp3_list_info[i].name = all_songs[i];
-                mp3_list_info[i].singer = "singer";
-                mp3_list_info[i].bl = "bl";
-                mp3_list_info[i].time = "time";
-                mp3_list_info[i].imgurl = "imgurl";
-                mp3_list_info[i].isplaying = false;
-                mp3_list_info[i].lrc = "";
-
-                lv_obj_t *ui_Panel10;
-                lv_obj_t *ui_Label24;
-                lv_obj_t *ui_Label22;
-                lv_obj_t *ui_Label25;
-                // lv_obj_t *ui_Image8;
-
-                ui_Panel10 = lv_obj_create(ui_Panel13);
-                lv_obj_set_width(ui_Panel10, 509);
-                lv_obj_set_height(ui_Panel10, 87);
-                lv_obj_set_x(ui_Panel10, -2);
-                lv_obj_set_y(ui_Panel10, pos);
-                lv_obj_set_align(ui_Panel10, LV_ALIGN_CENTER);
-                lv_obj_clear_flag(ui_Panel10, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-                lv_obj_set_style_bg_color(ui_Panel10, lv_color_hex(0x171717), LV_PART_MAIN | LV_STATE_DEFAULT);
-                lv_obj_set_style_bg_opa(ui_Panel10, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-                lv_obj_add_event_cb(ui_Panel10, ui_event_play_list, LV_EVENT_ALL, (void *)i);
-
-                ui_Label24 = lv_label_create(ui_Panel10);
-                lv_obj_set_width(ui_Label24, LV_SIZE_CONTENT);  /// 1
-                lv_obj_set_height(ui_Label24, LV_SIZE_CONTENT); /// 1
-                lv_obj_set_x(ui_Label24, 49);
-                lv_obj_set_y(ui_Label24, -12);
-                lv_obj_set_align(ui_Label24, LV_ALIGN_LEFT_MID);
-                lv_label_set_text(ui_Label24, mp3_list_info[i].name.c_str());
-                lv_obj_set_style_text_font(ui_Label24, &ui_font_Font1YHall20, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-                ui_Label25 = lv_label_create(ui_Panel10);
-                lv_obj_set_width(ui_Label25, 70);               /// 1
-                lv_obj_set_height(ui_Label25, LV_SIZE_CONTENT); /// 1
-                lv_obj_set_x(ui_Label25, 49);
-                lv_obj_set_y(ui_Label25, 17);
-                lv_obj_set_align(ui_Label25, LV_ALIGN_LEFT_MID);
-                lv_label_set_long_mode(ui_Label25, LV_LABEL_LONG_SCROLL_CIRCULAR);
-                lv_label_set_text(ui_Label25, "");
-                lv_obj_set_style_text_font(ui_Label25, &ui_font_Font1YHall16, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-                ui_Label22 = lv_label_create(ui_Panel10);
-                lv_obj_set_width(ui_Label22, LV_SIZE_CONTENT);  /// 1
-                lv_obj_set_height(ui_Label22, LV_SIZE_CONTENT); /// 1
-                lv_obj_set_x(ui_Label22, 125);
-                lv_obj_set_y(ui_Label22, 18);
-                lv_obj_set_align(ui_Label22, LV_ALIGN_LEFT_MID);
-                lv_label_set_text(ui_Label22, "");
-                lv_obj_set_style_text_font(ui_Label22, &ui_font_Font1YHall16, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-                ui_Image8[i] = lv_img_create(ui_Panel10);
-                lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-                lv_obj_set_width(ui_Image8[i], LV_SIZE_CONTENT);  /// 48
-                lv_obj_set_height(ui_Image8[i], LV_SIZE_CONTENT); /// 48
-                lv_obj_set_x(ui_Image8[i], -215);
-                lv_obj_set_y(ui_Image8[i], 0);
-                lv_obj_set_align(ui_Image8[i], LV_ALIGN_CENTER);
-                lv_obj_add_flag(ui_Image8[i], LV_OBJ_FLAG_ADV_HITTEST);  /// Flags
-                lv_obj_clear_flag(ui_Image8[i], LV_OBJ_FLAG_SCROLLABLE); /// Flags
-                pos += 100;
-            }
+            Mp3Info info;
+            info.id = String(i);
+            info.name = all_songs[i];
+            info.singer = "singer";
+            info.bl = "bl";
+            info.time = "time";
+            info.imgurl = "imgurl";
+            info.isplaying = false;
+            info.lrc = "";
+            mp3_list_info.push_back(info);
         }
+        play_list_init();
         load_play_info_sd(0);
         lv_obj_add_flag(ui_Panel12, LV_OBJ_FLAG_HIDDEN);
         audio_data_init_flag = true;
@@ -554,7 +600,7 @@ void audio_data_init(void *pvParameters)
     httpClient.begin(URL);
     String p[10];
     int httpCode = httpClient.GET(); // 发送 POST 请求
-    int pos = -85;
+    mp3_list_info.clear();
     if (httpCode > 0)
     {                                            // 请求成功
         String payload = httpClient.getString(); // 获取响应内容
@@ -566,7 +612,7 @@ void audio_data_init(void *pvParameters)
             p[i] = payload.substring(0, payload.indexOf("\n"));
             payload = payload.substring(payload.indexOf("\n") + 1);
 
-            String mp3_info[4];
+            String mp3_info[6];
 
             for (size_t j = 0; j < 6; j++)
             {
@@ -574,77 +620,26 @@ void audio_data_init(void *pvParameters)
                 p[i] = p[i].substring(p[i].indexOf(",") + 1);
                 Serial.println(mp3_info[j]);
             }
-            mp3_list_info[i].id = mp3_info[0];
-            mp3_list_info[i].name = mp3_info[1];
-            mp3_list_info[i].singer = mp3_info[2];
-            mp3_list_info[i].bl = mp3_info[3];
-            mp3_list_info[i].time = mp3_info[4];
-            mp3_list_info[i].imgurl = mp3_info[5];
-            mp3_list_info[i].isplaying = false;
-            mp3_list_info[i].lrc = "";
-
-            lv_obj_t *ui_Panel10;
-            lv_obj_t *ui_Label24;
-            lv_obj_t *ui_Label22;
-            lv_obj_t *ui_Label25;
-            // lv_obj_t *ui_Image8;
-
-            ui_Panel10 = lv_obj_create(ui_Panel13);
-            lv_obj_set_width(ui_Panel10, 509);
-            lv_obj_set_height(ui_Panel10, 87);
-            lv_obj_set_x(ui_Panel10, -2);
-            lv_obj_set_y(ui_Panel10, pos);
-            lv_obj_set_align(ui_Panel10, LV_ALIGN_CENTER);
-            lv_obj_clear_flag(ui_Panel10, LV_OBJ_FLAG_SCROLLABLE); /// Flags
-            lv_obj_set_style_bg_color(ui_Panel10, lv_color_hex(0x171717), LV_PART_MAIN | LV_STATE_DEFAULT);
-            lv_obj_set_style_bg_opa(ui_Panel10, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
-            lv_obj_add_event_cb(ui_Panel10, ui_event_play_list, LV_EVENT_ALL, (void *)i);
-
-            ui_Label24 = lv_label_create(ui_Panel10);
-            lv_obj_set_width(ui_Label24, LV_SIZE_CONTENT);  /// 1
-            lv_obj_set_height(ui_Label24, LV_SIZE_CONTENT); /// 1
-            lv_obj_set_x(ui_Label24, 49);
-            lv_obj_set_y(ui_Label24, -12);
-            lv_obj_set_align(ui_Label24, LV_ALIGN_LEFT_MID);
-            lv_label_set_text(ui_Label24, mp3_info[1].c_str());
-            lv_obj_set_style_text_font(ui_Label24, &ui_font_Font1YHall20, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-            ui_Label25 = lv_label_create(ui_Panel10);
-            lv_obj_set_width(ui_Label25, 70);               /// 1
-            lv_obj_set_height(ui_Label25, LV_SIZE_CONTENT); /// 1
-            lv_obj_set_x(ui_Label25, 49);
-            lv_obj_set_y(ui_Label25, 17);
-            lv_obj_set_align(ui_Label25, LV_ALIGN_LEFT_MID);
-            lv_label_set_long_mode(ui_Label25, LV_LABEL_LONG_SCROLL_CIRCULAR);
-            lv_label_set_text(ui_Label25, mp3_info[2].c_str());
-            lv_obj_set_style_text_font(ui_Label25, &ui_font_Font1YHall16, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-            ui_Label22 = lv_label_create(ui_Panel10);
-            lv_obj_set_width(ui_Label22, LV_SIZE_CONTENT);  /// 1
-            lv_obj_set_height(ui_Label22, LV_SIZE_CONTENT); /// 1
-            lv_obj_set_x(ui_Label22, 125);
-            lv_obj_set_y(ui_Label22, 18);
-            lv_obj_set_align(ui_Label22, LV_ALIGN_LEFT_MID);
-            lv_label_set_text(ui_Label22, mp3_info[3].c_str());
-            lv_obj_set_style_text_font(ui_Label22, &ui_font_Font1YHall16, LV_PART_MAIN | LV_STATE_DEFAULT);
-
-            ui_Image8[i] = lv_img_create(ui_Panel10);
-            lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-            lv_obj_set_width(ui_Image8[i], LV_SIZE_CONTENT);  /// 48
-            lv_obj_set_height(ui_Image8[i], LV_SIZE_CONTENT); /// 48
-            lv_obj_set_x(ui_Image8[i], -215);
-            lv_obj_set_y(ui_Image8[i], 0);
-            lv_obj_set_align(ui_Image8[i], LV_ALIGN_CENTER);
-            lv_obj_add_flag(ui_Image8[i], LV_OBJ_FLAG_ADV_HITTEST);  /// Flags
-            lv_obj_clear_flag(ui_Image8[i], LV_OBJ_FLAG_SCROLLABLE); /// Flags
-            pos += 100;
+            Mp3Info info;
+            info.id = mp3_info[0];
+            info.name = mp3_info[1];
+            info.singer = mp3_info[2];
+            info.bl = mp3_info[3];
+            info.time = mp3_info[4];
+            info.imgurl = mp3_info[5];
+            info.isplaying = false;
+            info.lrc = "";
+            mp3_list_info.push_back(info);
         }
+        play_list_init();
     }
     httpClient.end(); // 释放 HTTPClient 对象
-    load_play_info(0);
-
     lv_obj_add_flag(ui_Panel12, LV_OBJ_FLAG_HIDDEN);
-    audio_data_init_flag = true;
+    if (!mp3_list_info.empty())
+    {
+        load_play_info(0);
+        audio_data_init_flag = true;
+    }
     vTaskDelete(NULL);
 }
 bool read_lrc_flag = false;
@@ -735,7 +730,11 @@ void ui_event_play_list(lv_event_t *e)
 
     if (event_code == LV_EVENT_CLICKED)
     {
-        int pos = (int)lv_event_get_user_data(e);
+        // The rows are reused while scrolling, so ask the list which song is on this one
+        uint32_t row_index = lv_vlist_get_row_index(play_list, lv_event_get_current_target(e));
+        if (row_index == LV_VLIST_ROW_NONE)
+            return;
+        int pos = row_index;
         Serial.printf("pos: %d\n", pos);
         if (!mp3_list_info[pos].isplaying)
         {
@@ -768,7 +767,7 @@ void ui_event_play_list(lv_event_t *e)
                 audio.connecttoSD(mp3_list_info[play_index].name.c_str());
             }
 
-            if (play_index < 9)
+            if (play_index + 1 < (int)mp3_list_info.size())
                 ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
             else
                 ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -776,17 +775,7 @@ void ui_event_play_list(lv_event_t *e)
             now_time = 0;
             play_state = 1;
             // update_play_list
-            for (int i = 0; i < 10; i++)
-            {
-                if (mp3_list_info[i].isplaying == true)
-                {
-                    lv_img_set_src(ui_Image8[i], &ui_img_list_pause_icon_png);
-                }
-                else
-                {
-                    lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-                }
-            }
+            update_play_list();
         }
     }
 }
@@ -836,12 +825,7 @@ void ui_event_play_pre(lv_event_t *e)
             mp3_list_info[play_index].isplaying = false;
             if (play_mode_select == 1)
             {
-                play_index = random(0, 9);
-                int last_index = play_index;
-                while (last_index == play_index)
-                {
-                    play_index = random(0, 9);
-                }
+                play_index = random_play_index(play_index);
             }
             else
             {
@@ -869,7 +853,7 @@ void ui_event_play_pre(lv_event_t *e)
                     audio.connecttoSD(mp3_list_info[play_index].name.c_str());
                 }
 
-                if (play_index < 9)
+                if (play_index + 1 < (int)mp3_list_info.size())
                     ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
                 else
                     ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -885,17 +869,7 @@ void ui_event_play_pre(lv_event_t *e)
             }
         }
         // update_play_state
-        for (int i = 0; i < 10; i++)
-        {
-            if (mp3_list_info[i].isplaying == true)
-            {
-                lv_img_set_src(ui_Image8[i], &ui_img_list_pause_icon_png);
-            }
-            else
-            {
-                lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-            }
-        }
+        update_play_list();
     }
 }
 
@@ -906,17 +880,12 @@ void ui_event_play_next(lv_event_t *e)
     if (event_code == LV_EVENT_CLICKED)
     {
         Serial.println(play_index);
-        if (play_index <= 10)
+        if (play_index + 1 < (int)mp3_list_info.size())
         {
             mp3_list_info[play_index].isplaying = false;
             if (play_mode_select == 1)
             {
-                play_index = random(0, 9);
-                int last_index = play_index;
-                while (last_index == play_index)
-                {
-                    play_index = random(0, 9);
-                }
+                play_index = random_play_index(play_index);
             }
             else
             {
@@ -944,7 +913,7 @@ void ui_event_play_next(lv_event_t *e)
                     audio.connecttoSD(mp3_list_info[play_index].name.c_str());
                 }
 
-                if (play_index < 9)
+                if (play_index + 1 < (int)mp3_list_info.size())
                     ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
                 else
                     ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -960,17 +929,7 @@ void ui_event_play_next(lv_event_t *e)
                 play_state = 0;
             }
             // update_play_state
-            for (int i = 0; i < 10; i++)
-            {
-                if (mp3_list_info[i].isplaying == true)
-                {
-                    lv_img_set_src(ui_Image8[i], &ui_img_list_pause_icon_png);
-                }
-                else
-                {
-                    lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-                }
-            }
+            update_play_list();
         }
     }
 }
@@ -1105,7 +1064,7 @@ void button_play_callback(const String &state)
                 audio.connecttoSD(mp3_list_info[play_index].name.c_str());
             }
 
-            if (play_index < 9)
+            if (play_index + 1 < (int)mp3_list_info.size())
                 ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
             else
                 ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -1122,17 +1081,7 @@ void button_play_callback(const String &state)
         }
 
         // update_play_state
-        for (int i = 0; i < 10; i++)
-        {
-            if (mp3_list_info[i].isplaying == true)
-            {
-                lv_img_set_src(ui_Image8[i], &ui_img_list_pause_icon_png);
-            }
-            else
-            {
-                lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-            }
-        }
+        update_play_list();
     }
     else
     {
@@ -1149,12 +1098,7 @@ void button_pre_callback(const String &state)
             mp3_list_info[play_index].isplaying = false;
             if (play_mode_select == 1)
             {
-                play_index = random(0, 9);
-                int last_index = play_index;
-                while (last_index == play_index)
-                {
-                    play_index = random(0, 9);
-                }
+                play_index = random_play_index(play_index);
             }
             else
             {
@@ -1182,7 +1126,7 @@ void button_pre_callback(const String &state)
                     audio.connecttoSD(mp3_list_info[play_index].name.c_str());
                 }
 
-                if (play_index < 9)
+                if (play_index + 1 < (int)mp3_list_info.size())
                     ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
                 else
                     ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -1199,17 +1143,7 @@ void button_pre_callback(const String &state)
             }
         }
         // update_play_state
-        for (int i = 0; i < 10; i++)
-        {
-            if (mp3_list_info[i].isplaying == true)
-            {
-                lv_img_set_src(ui_Image8[i], &ui_img_list_pause_icon_png);
-            }
-            else
-            {
-                lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-            }
-        }
+        update_play_list();
     }
     else
     {
@@ -1222,17 +1156,12 @@ void button_next_callback(const String &state)
     {
 
         Serial.println(play_index);
-        if (play_index <= 10)
+        if (play_index + 1 < (int)mp3_list_info.size())
         {
             mp3_list_info[play_index].isplaying = false;
             if (play_mode_select == 1)
             {
-                play_index = random(0, 9);
-                int last_index = play_index;
-                while (last_index == play_index)
-                {
-                    play_index = random(0, 9);
-                }
+                play_index = random_play_index(play_index);
             }
             else
             {
@@ -1261,7 +1190,7 @@ void button_next_callback(const String &state)
                     audio.connecttoSD(mp3_list_info[play_index].name.c_str());
                 }
 
-                if (play_index < 9)
+                if (play_index + 1 < (int)mp3_list_info.size())
                     ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
                 else
                     ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -1277,17 +1206,7 @@ void button_next_callback(const String &state)
                 play_state = 0;
             }
             // update_play_state
-            for (int i = 0; i < 10; i++)
-            {
-                if (mp3_list_info[i].isplaying == true)
-                {
-                    lv_img_set_src(ui_Image8[i], &ui_img_list_pause_icon_png);
-                }
-                else
-                {
-                    lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-                }
-            }
+            update_play_list();
 
             // ((BlinkerText *)text_song_name)->print(mp3_list_info[play_index].name);
         }
@@ -1360,7 +1279,7 @@ void ui_event_Button_Play(lv_event_t *e)
 {
     lv_event_code_t event_code = lv_event_get_code(e);
     lv_obj_t *target = lv_event_get_target(e);
-    if (event_code == LV_EVENT_CLICKED)
+    if (event_code == LV_EVENT_CLICKED && !mp3_list_info.empty())
     {
         if (play_state == 1)
         {
@@ -1385,7 +1304,7 @@ void ui_event_Button_Play(lv_event_t *e)
                 audio.connecttoSD(mp3_list_info[play_index].name.c_str());
             }
 
-            if (play_index < 9)
+            if (play_index + 1 < (int)mp3_list_info.size())
                 ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
             else
                 ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -1402,17 +1321,7 @@ void ui_event_Button_Play(lv_event_t *e)
         }
 
         // update_play_state
-        for (int i = 0; i < 10; i++)
-        {
-            if (mp3_list_info[i].isplaying == true)
-            {
-                lv_img_set_src(ui_Image8[i], &ui_img_list_pause_icon_png);
-            }
-            else
-            {
-                lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-            }
-        }
+        update_play_list();
     }
 }
 
@@ -1722,7 +1631,7 @@ void lrc_timer(lv_timer_t *timer)
                 if (play_mode_select == 0)
                 {
                     Serial.println(play_index);
-                    if (play_index <= 10)
+                    if (play_index + 1 < (int)mp3_list_info.size())
                     {
                         mp3_list_info[play_index].isplaying = false;
                         play_index++;
@@ -1748,7 +1657,7 @@ void lrc_timer(lv_timer_t *timer)
                                 audio.connecttoSD(mp3_list_info[play_index].name.c_str());
                             }
 
-                            if (play_index < 9)
+                            if (play_index + 1 < (int)mp3_list_info.size())
                                 ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
                             else
                                 ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -1764,27 +1673,12 @@ void lrc_timer(lv_timer_t *timer)
                             play_state = 0;
                         }
                         // update_play_state
-                        for (int i = 0; i < 10; i++)
-                        {
-                            if (mp3_list_info[i].isplaying == true)
-                            {
-                                lv_img_set_src(ui_Image8[i], &ui_img_list_pause_icon_png);
-                            }
-                            else
-                            {
-                                lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-                            }
-                        }
+                        update_play_list();
                     }
                 }
                 else if (play_mode_select == 1)
                 {
-                    int last_play_index = play_index;
-                    play_index = random(0, 9);
-                    while (play_index == last_play_index)
-                    {
-                        play_index = random(0, 9);
-                    }
+                    play_index = random_play_index(play_index);
                     if (!net_is_ok && sd_is_ok && is_have_music)
                     {
                         load_play_info_sd(play_index);
@@ -1807,7 +1701,7 @@ void lrc_timer(lv_timer_t *timer)
                             audio.connecttoSD(mp3_list_info[play_index].name.c_str());
                         }
 
-                        if (play_index < 9)
+                        if (play_index + 1 < (int)mp3_list_info.size())
                             ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
                         else
                             ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -1823,17 +1717,7 @@ void lrc_timer(lv_timer_t *timer)
                         play_state = 0;
                     }
                     // update_play_state
-                    for (int i = 0; i < 10; i++)
-                    {
-                        if (mp3_list_info[i].isplaying == true)
-                        {
-                            lv_img_set_src(ui_Image8[i], &ui_img_list_pause_icon_png);
-                        }
-                        else
-                        {
-                            lv_img_set_src(ui_Image8[i], &ui_img_list_play_icon_png);
-                        }
-                    }
+                    update_play_list();
                 }
                 else if (play_mode_select == 2)
                 {
@@ -1852,7 +1736,7 @@ void lrc_timer(lv_timer_t *timer)
                             audio.connecttoSD(mp3_list_info[play_index].name.c_str());
                         }
 
-                        if (play_index < 9)
+                        if (play_index + 1 < (int)mp3_list_info.size())
                             ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:" + mp3_list_info[play_index + 1].singer + " - " + mp3_list_info[play_index + 1].name);
                         else
                             ((BlinkerText *)text_song_name)->print("now playing:" + mp3_list_info[play_index].singer + " - " + mp3_list_info[play_index].name, "the next song is:no more songs");
@@ -1,3 +1,4 @@
+#include <vector>
 #include "lvgl.h"
 #include "player.h"
 
@@ -38,6 +39,8 @@ void ui_event_Key_Ok(lv_event_t *e);
 void serialprintln_task(void *pvParameter);
 void blinker_isok(void *pv);
 void listDirMusic(fs::FS &fs, const char * dirname, uint8_t levels);
+void play_list_init();
+void update_play_list();
 typedef struct
 {
     String id;
@@ -64,6 +67,6 @@ extern bool net_is_ok;
 extern bool sd_is_ok;
 extern int read_flag;
 extern bool read_lrc_flag;
-extern char *all_songs[99];
+extern std::vector<String> all_songs;
 extern int is_have_music;
 extern int light_brightness;
@@ -0,0 +1,155 @@
+/*
+ * Deferred cache write-back for memory mapped framebuffers.
+ *
+ * Writing a PSRAM framebuffer through the data cache needs an explicit
+ * write-back before the LCD DMA can see the pixels. Doing it per pixel or per
+ * row costs more than the drawing itself, so primitives only mark the area
+ * they touched. Between startWrite() and endWrite() the dirty area keeps
+ * growing, and it is written back once, in cache line aligned chunks, when the
+ * outermost endWrite() returns.
+ *
+ * Define ARDUINO_GFX_CACHE_WRITEBACK before including this file to route the
+ * write-back somewhere else, e.g. a counting mock on a host build.
+ */
+#ifndef _ARDUINO_CACHEWRITEBACK_H_
+#define _ARDUINO_CACHEWRITEBACK_H_
+
+#include <stdint.h>
+
+#ifndef ARDUINO_GFX_CACHE_WRITEBACK
+#define ARDUINO_GFX_CACHE_WRITEBACK(addr, size) Cache_WriteBack_Addr((addr), (size))
+#endif
+
+#ifndef ARDUINO_GFX_CACHE_LINE_SIZE
+#if defined(CONFIG_ESP32S3_DATA_CACHE_LINE_SIZE)
+#define ARDUINO_GFX_CACHE_LINE_SIZE CONFIG_ESP32S3_DATA_CACHE_LINE_SIZE
+#else
+#define ARDUINO_GFX_CACHE_LINE_SIZE 32
+#endif
+#endif
+
+class Arduino_CacheWriteBack
+{
+public:
+  Arduino_CacheWriteBack()
+      : _base(0), _row_bytes(0), _bpp(2), _depth(0), _dirty(false),
+        _x1(0), _y1(0), _x2(0), _y2(0), _calls(0), _bytes(0)
+  {
+  }
+
+  void begin(void *base, int16_t width, uint8_t bytes_per_pixel = 2)
+  {
+    _base = (uint32_t)(uintptr_t)base;
+    _bpp = bytes_per_pixel;
+    _row_bytes = (uint32_t)width * _bpp;
+    _depth = 0;
+    _dirty = false;
+  }
+
+  void resize(int16_t width)
+  {
+    flush();
+    _row_bytes = (uint32_t)width * _bpp;
+  }
+
+  void startWrite()
+  {
+    ++_depth;
+  }
+
+  void endWrite()
+  {
+    if (_depth && (--_depth == 0))
+    {
+      flush();
+    }
+  }
+
+  // Record a preclipped area as written, flush right away outside a batch
+  void mark(int16_t x, int16_t y, int16_t w, int16_t h)
+  {
+    int16_t x2 = x + w - 1;
+    int16_t y2 = y + h - 1;
+    if (!_dirty)
+    {
+      _x1 = x;
+      _y1 = y;
+      _x2 = x2;
+      _y2 = y2;
+      _dirty = true;
+    }
+    else
+    {
+      if (x < _x1)
+        _x1 = x;
+      if (y < _y1)
+        _y1 = y;
+      if (x2 > _x2)
+        _x2 = x2;
+      if (y2 > _y2)
+        _y2 = y2;
+    }
+    if (!_depth)
+    {
+      flush();
+    }
+  }
+
+  void flush()
+  {
+    if (!_dirty)
+    {
+      return;
+    }
+    _dirty = false;
+
+    uint32_t left = (uint32_t)_x1 * _bpp;
+    uint32_t right = ((uint32_t)_x2 + 1) * _bpp;
+    uint32_t first = _base + ((uint32_t)_y1 * _row_bytes);
+
+    // Wide areas are cheaper as one contiguous range than as many calls,
+    // narrow ones would drag in mostly untouched lines, so go row by row.
+    if ((_y1 == _y2) || ((right - left) * 2 >= _row_bytes))
+    {
+      writeBack(first + left, first + ((uint32_t)(_y2 - _y1) * _row_bytes) + right);
+    }
+    else
+    {
+      for (int16_t y = _y1; y <= _y2; y++)
+      {
+        writeBack(first + left, first + right);
+        first += _row_bytes;
+      }
+    }
+  }
+
+  // Statistics, handy to verify the batching actually pays off
+  uint32_t calls() const { return _calls; }
+  uint32_t bytes() const { return _bytes; }
+  void resetStats()
+  {
+    _calls = 0;
+    _bytes = 0;
+  }
+
+private:
+  void writeBack(uint32_t start, uint32_t end)
+  {
+    start &= ~(uint32_t)(ARDUINO_GFX_CACHE_LINE_SIZE - 1);
+    end = (end + ARDUINO_GFX_CACHE_LINE_SIZE - 1) & ~(uint32_t)(ARDUINO_GFX_CACHE_LINE_SIZE - 1);
+    ARDUINO_GFX_CACHE_WRITEBACK(start, end - start);
+    _calls++;
+    _bytes += end - start;
+  }
+
+  uint32_t _base;
+  uint32_t _row_bytes;
+  uint8_t _bpp;
+  uint8_t _depth;
+  bool _dirty;
+  int16_t _x1, _y1, _x2, _y2;
+  uint32_t _calls;
+  uint32_t _bytes;
+};
+
+#endif // _ARDUINO_CACHEWRITEBACK_H_
@@ -40,11 +40,12 @@ void Arduino_Canvas::begin(int32_t speed)
     {
         Serial.println(F("_framebuffer allocation failed."));
     }
+    _fb.setBuffer(_framebuffer, _width, _height);
 }
 
 void Arduino_Canvas::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
 {
-    _framebuffer[((int32_t)y * _width) + x] = color;
+    _fb.drawPixel(x, y, color);
 }
 
 void Arduino_Canvas::writeFastVLine(int16_t x, int16_t y,
@@ -73,12 +74,7 @@ void Arduino_Canvas::writeFastVLine(int16_t x, int16_t y,
                     h = _max_y - y + 1;
                 } // Clip bottom
 
-                uint16_t *fb = _framebuffer + ((int32_t)y * _width) + x;
-                while (h--)
-                {
-                    *fb = color;
-                    fb += _width;
-                }
+                _fb.drawVLine(x, y, h, color);
             }
         }
     }
@@ -110,11 +106,7 @@ void Arduino_Canvas::writeFastHLine(int16_t x, int16_t y,
                     w = _max_x - x + 1;
                 } // Clip right
 
-                uint16_t *fb = _framebuffer + ((int32_t)y * _width) + x;
-                while (w--)
-                {
-                    *(fb++) = color;
-                }
+                _fb.drawHLine(x, y, w, color);
             }
         }
     }
@@ -123,17 +115,13 @@ void Arduino_Canvas::writeFastHLine(int16_t x, int16_t y,
 void Arduino_Canvas::writeFillRectPreclipped(int16_t x, int16_t y,
                                              int16_t w, int16_t h, uint16_t color)
 {
-    uint16_t *row = _framebuffer;
-    row += y * _width;
-    row += x;
-    for (int j = 0; j < h; j++)
-    {
-        for (int i = 0; i < w; i++)
-        {
-            row[i] = color;
-        }
-        row += _width;
-    }
+    _fb.fillRect(x, y, w, h, color);
+}
+
+void Arduino_Canvas::writeSlashLine(int16_t x0, int16_t y0,
+                                    int16_t x1, int16_t y1, uint16_t color)
+{
+    _fb.drawLine(x0, y0, x1, y1, color);
 }
 
 void Arduino_Canvas::draw16bitRGBBitmap(int16_t x, int16_t y,
@@ -173,18 +161,7 @@ void Arduino_Canvas::draw16bitRGBBitmap(int16_t x, int16_t y,
             w += x;
             x = 0;
         }
-        uint16_t *row = _framebuffer;
-        row += y * _width;
-        row += x;
-        for (int j = 0; j < h; j++)
-        {
-            for (int i = 0; i < w; i++)
-            {
-                row[i] = *bitmap++;
-            }
-            bitmap += xskip;
-            row += _width;
-        }
+        _fb.copyRect(x, y, bitmap, w, h, xskip);
     }
 }
 
@@ -225,20 +202,7 @@ void Arduino_Canvas::draw16bitBeRGBBitmap(int16_t x, int16_t y,
             w += x;
             x = 0;
         }
-        uint16_t *row = _framebuffer;
-        row += y * _width;
-        row += x;
-        uint16_t color;
-        for (int j = 0; j < h; j++)
-        {
-            for (int i = 0; i < w; i++)
-            {
-                color = *bitmap++;
-                MSB_16_SET(row[i], color);
-            }
-            bitmap += xskip;
-            row += _width;
-        }
+        _fb.copyBeRect(x, y, bitmap, w, h, xskip);
     }
 }
 
@@ -247,4 +211,10 @@ void Arduino_Canvas::flush()
     _output->draw16bitRGBBitmap(_output_x, _output_y, _framebuffer, _width, _height);
 }
 
+void Arduino_Canvas::setRotation(uint8_t r)
+{
+    Arduino_GFX::setRotation(r);
+    _fb.resize(_width, _height);
+}
+
 #endif // !defined(LITTLE_FOOT_PRINT)
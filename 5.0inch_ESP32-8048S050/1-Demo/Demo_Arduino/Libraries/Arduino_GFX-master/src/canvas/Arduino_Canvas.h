@@ -5,6 +5,7 @@
 #define _ARDUINO_CANVAS_H_
 
 #include "../Arduino_GFX.h"
+#include "Arduino_Framebuffer.h"
 
 class Arduino_Canvas : public Arduino_GFX
 {
@@ -16,12 +17,15 @@ public:
   void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
   void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
   void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeSlashLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) override;
   void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
   void draw16bitBeRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
   void flush(void) override;
+  void setRotation(uint8_t r) override;
 
 protected:
   uint16_t *_framebuffer;
+  Arduino_Framebuffer<Arduino_PixelRGB565> _fb;
   Arduino_G *_output;
   int16_t _output_x, _output_y;
 
@@ -0,0 +1,260 @@
+/*
+ * Compile-time specialized framebuffer surface.
+ *
+ * Arduino_GFX routes every primitive through virtual writePixelPreclipped()/
+ * writeFastHLine()/writeFillRectPreclipped(). For memory mapped targets
+ * (canvas, RGB panel) the target is just a pixel array, so those primitives
+ * can be fully inlined. Displays keep a surface member and delegate to it.
+ *
+ * The surface is free of Arduino dependencies so it can also be built on a
+ * host for benchmarking.
+ */
+#ifndef _ARDUINO_FRAMEBUFFER_H_
+#define _ARDUINO_FRAMEBUFFER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__GNUC__)
+#define FB_INLINE __attribute__((always_inline)) inline
+#else
+#define FB_INLINE inline
+#endif
+
+// Native RGB565, as used by Arduino_GFX colors
+struct Arduino_PixelRGB565
+{
+  typedef uint16_t pixel_t;
+  enum { native_565 = 1 };
+  static FB_INLINE pixel_t from565(uint16_t c) { return c; }
+  static FB_INLINE pixel_t fromBe565(uint16_t c) { return (pixel_t)((c >> 8) | (c << 8)); }
+};
+
+// Byte swapped RGB565, for buses that shift out MSB first
+struct Arduino_PixelRGB565BE
+{
+  typedef uint16_t pixel_t;
+  enum { native_565 = 0 };
+  static FB_INLINE pixel_t from565(uint16_t c) { return (pixel_t)((c >> 8) | (c << 8)); }
+  static FB_INLINE pixel_t fromBe565(uint16_t c) { return c; }
+};
+
+// RGB332, for low memory canvases
+struct Arduino_PixelRGB332
+{
+  typedef uint8_t pixel_t;
+  enum { native_565 = 0 };
+  static FB_INLINE pixel_t from565(uint16_t c)
+  {
+    return (pixel_t)(((c >> 8) & 0xE0) | ((c >> 6) & 0x1C) | ((c >> 3) & 0x03));
+  }
+  static FB_INLINE pixel_t fromBe565(uint16_t c) { return from565((uint16_t)((c >> 8) | (c << 8))); }
+};
+
+/**
+ * @tparam FORMAT  pixel format traits (Arduino_PixelRGB565, ...)
+ * @tparam STRIDE  row stride in pixels, 0 means set at runtime by setBuffer()
+ *
+ * All primitives expect preclipped coordinates except drawLine(), which
+ * clips per pixel against the surface size.
+ */
+template <typename FORMAT, int16_t STRIDE = 0>
+class Arduino_Framebuffer
+{
+public:
+  typedef typename FORMAT::pixel_t pixel_t;
+
+  Arduino_Framebuffer() : _buf(NULL), _stride(STRIDE), _w(0), _h(0) {}
+
+  FB_INLINE void setBuffer(pixel_t *buf, int16_t w, int16_t h, int16_t stride = STRIDE)
+  {
+    _buf = buf;
+    _w = w;
+    _h = h;
+    _stride = stride ? stride : w;
+  }
+
+  FB_INLINE void resize(int16_t w, int16_t h)
+  {
+    setBuffer(_buf, w, h, STRIDE ? STRIDE : w);
+  }
+
+  FB_INLINE pixel_t *buffer() const { return _buf; }
+  FB_INLINE int16_t width() const { return _w; }
+  FB_INLINE int16_t height() const { return _h; }
+  FB_INLINE int32_t stride() const { return STRIDE ? STRIDE : _stride; }
+
+  FB_INLINE pixel_t *at(int16_t x, int16_t y) const
+  {
+    return _buf + ((int32_t)y * stride()) + x;
+  }
+
+  FB_INLINE void drawPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    *at(x, y) = FORMAT::from565(color);
+  }
+
+  FB_INLINE void drawHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    fillSpan(at(x, y), w, FORMAT::from565(color));
+  }
+
+  FB_INLINE void drawVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    const pixel_t p = FORMAT::from565(color);
+    const int32_t s = stride();
+    pixel_t *fb = at(x, y);
+    while (h--)
+    {
+      *fb = p;
+      fb += s;
+    }
+  }
+
+  FB_INLINE void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    const pixel_t p = FORMAT::from565(color);
+    const int32_t s = stride();
+    pixel_t *row = at(x, y);
+    if (w == s)
+    {
+      // full width rect is one contiguous span
+      fillSpan(row, (int32_t)w * h, p);
+      return;
+    }
+    while (h--)
+    {
+      fillSpan(row, w, p);
+      row += s;
+    }
+  }
+
+  // Bresenham's algorithm with inline clipping, no per pixel dispatch
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+  {
+    const pixel_t p = FORMAT::from565(color);
+    int16_t dx = (x1 > x0) ? (x1 - x0) : (x0 - x1);
+    int16_t dy = (y1 > y0) ? (y1 - y0) : (y0 - y1);
+    bool steep = dy > dx;
+    if (steep)
+    {
+      int16_t t;
+      t = x0, x0 = y0, y0 = t;
+      t = x1, x1 = y1, y1 = t;
+      t = dx, dx = dy, dy = t;
+    }
+    if (x0 > x1)
+    {
+      int16_t t;
+      t = x0, x0 = x1, x1 = t;
+      t = y0, y0 = y1, y1 = t;
+    }
+    int16_t err = dx >> 1;
+    int16_t ystep = (y0 < y1) ? 1 : -1;
+    const int16_t max_u = steep ? (_h - 1) : (_w - 1);
+    const int16_t max_v = steep ? (_w - 1) : (_h - 1);
+    const int32_t s = stride();
+    for (; x0 <= x1; x0++)
+    {
+      if ((x0 >= 0) && (x0 <= max_u) && (y0 >= 0) && (y0 <= max_v))
+      {
+        if (steep)
+        {
+          _buf[(int32_t)x0 * s + y0] = p;
+        }
+        else
+        {
+          _buf[(int32_t)y0 * s + x0] = p;
+        }
+      }
+      err -= dy;
+      if (err < 0)
+      {
+        err += dx;
+        y0 += ystep;
+      }
+    }
+  }
+
+  // Copy a preclipped RGB565 bitmap, skipping xskip source pixels per row
+  FB_INLINE void copyRect(int16_t x, int16_t y, const uint16_t *bitmap, int16_t w, int16_t h, int16_t xskip = 0)
+  {
+    const int32_t s = stride();
+    pixel_t *row = at(x, y);
+    while (h--)
+    {
+      if (FORMAT::native_565)
+      {
+        memcpy(row, bitmap, w * sizeof(pixel_t));
+      }
+      else
+      {
+        for (int16_t i = 0; i < w; i++)
+        {
+          row[i] = FORMAT::from565(bitmap[i]);
+        }
+      }
+      bitmap += w + xskip;
+      row += s;
+    }
+  }
+
+  // Same as copyRect() but the source is big endian RGB565
+  FB_INLINE void copyBeRect(int16_t x, int16_t y, const uint16_t *bitmap, int16_t w, int16_t h, int16_t xskip = 0)
+  {
+    const int32_t s = stride();
+    pixel_t *row = at(x, y);
+    while (h--)
+    {
+      for (int16_t i = 0; i < w; i++)
+      {
+        row[i] = FORMAT::fromBe565(bitmap[i]);
+      }
+      bitmap += w + xskip;
+      row += s;
+    }
+  }
+
+private:
+  static FB_INLINE void fillSpan(pixel_t *p, int32_t n, pixel_t c)
+  {
+    if ((sizeof(pixel_t) == 2) && (n >= 8))
+    {
+      // 16-bit pixels: align to a word then store two pixels per write
+      if (((uintptr_t)p) & 2)
+      {
+        *p++ = c;
+        n--;
+      }
+      uint32_t c2 = ((uint32_t)c << 16) | c;
+      uint32_t *p2 = (uint32_t *)p;
+      int32_t n2 = n >> 1;
+      while (n2 >= 4)
+      {
+        p2[0] = c2;
+        p2[1] = c2;
+        p2[2] = c2;
+        p2[3] = c2;
+        p2 += 4;
+        n2 -= 4;
+      }
+      while (n2--)
+      {
+        *p2++ = c2;
+      }
+      p = (pixel_t *)p2;
+      n &= 1;
+    }
+    while (n--)
+    {
+      *p++ = c;
+    }
+  }
+
+  pixel_t *_buf;
+  int16_t _stride;
+  int16_t _w, _h;
+};
+
+#endif // _ARDUINO_FRAMEBUFFER_H_
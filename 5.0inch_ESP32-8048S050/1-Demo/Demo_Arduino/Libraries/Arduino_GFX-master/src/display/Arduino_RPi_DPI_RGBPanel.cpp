@@ -27,17 +27,26 @@ void Arduino_RPi_DPI_RGBPanel::begin(int32_t speed)
       _hsync_pulse_width, _hsync_back_porch, _hsync_front_porch, _hsync_polarity,
       _vsync_pulse_width, _vsync_back_porch, _vsync_front_porch, _vsync_polarity,
       _pclk_active_neg, _prefer_speed);
+  _fb.setBuffer(_framebuffer, _width, _height);
+  _wb.begin(_framebuffer, _width);
+}
+
+void Arduino_RPi_DPI_RGBPanel::startWrite()
+{
+  _wb.startWrite();
+}
+
+void Arduino_RPi_DPI_RGBPanel::endWrite()
+{
+  _wb.endWrite();
 }
 
 void Arduino_RPi_DPI_RGBPanel::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
 {
-  uint16_t *fb = _framebuffer;
-  fb += (int32_t)y * _width;
-  fb += x;
-  *fb = color;
+  _fb.drawPixel(x, y, color);
   if (_auto_flush)
   {
-    Cache_WriteBack_Addr((uint32_t)fb, 2);
+    _wb.mark(x, y, 1, 1);
   }
 }
 
@@ -67,23 +76,10 @@ void Arduino_RPi_DPI_RGBPanel::writeFastVLine(int16_t x, int16_t y,
           h = _max_y - y + 1;
         } // Clip bottom
 
-        uint16_t *fb = _framebuffer + ((int32_t)y * _width) + x;
+        _fb.drawVLine(x, y, h, color);
         if (_auto_flush)
         {
-          while (h--)
-          {
-            *fb = color;
-            Cache_WriteBack_Addr((uint32_t)fb, 2);
-            fb += _width;
-          }
-        }
-        else
-        {
-          while (h--)
-          {
-            *fb = color;
-            fb += _width;
-          }
+          _wb.mark(x, y, 1, h);
         }
       }
     }
@@ -116,16 +112,10 @@ void Arduino_RPi_DPI_RGBPanel::writeFastHLine(int16_t x, int16_t y,
           w = _max_x - x + 1;
         } // Clip right
 
-        uint16_t *fb = _framebuffer + ((int32_t)y * _width) + x;
-        uint32_t cachePos = (uint32_t)fb;
-        int16_t writeSize = w * 2;
-        while (w--)
-        {
-          *(fb++) = color;
-        }
+        _fb.drawHLine(x, y, w, color);
         if (_auto_flush)
         {
-          Cache_WriteBack_Addr(cachePos, writeSize);
+          _wb.mark(x, y, w, 1);
         }
       }
     }
@@ -135,21 +125,20 @@ void Arduino_RPi_DPI_RGBPanel::writeFastHLine(int16_t x, int16_t y,
 void Arduino_RPi_DPI_RGBPanel::writeFillRectPreclipped(int16_t x, int16_t y,
                                                        int16_t w, int16_t h, uint16_t color)
 {
-  uint16_t *row = _framebuffer;
-  row += y * _width;
-  uint32_t cachePos = (uint32_t)row;
-  row += x;
-  for (int j = 0; j < h; j++)
+  _fb.fillRect(x, y, w, h, color);
+  if (_auto_flush)
   {
-    for (int i = 0; i < w; i++)
-    {
-      row[i] = color;
-    }
-    row += _width;
+    _wb.mark(x, y, w, h);
   }
+}
+
+void Arduino_RPi_DPI_RGBPanel::writeSlashLine(int16_t x0, int16_t y0,
+                                              int16_t x1, int16_t y1, uint16_t color)
+{
+  _fb.drawLine(x0, y0, x1, y1, color);
   if (_auto_flush)
   {
-    Cache_WriteBack_Addr(cachePos, _width * h * 2);
+    markClipped(x0, y0, x1, y1);
   }
 }
 
@@ -190,43 +179,10 @@ void Arduino_RPi_DPI_RGBPanel::draw16bitRGBBitmap(int16_t x, int16_t y,
       w += x;
       x = 0;
     }
-    uint16_t *row = _framebuffer;
-    row += y * _width;
-    uint32_t cachePos = (uint32_t)row;
-    row += x;
-    if (((_width & 1) == 0) && ((xskip & 1) == 0) && ((w & 1) == 0))
-    {
-      uint32_t *row2 = (uint32_t *)row;
-      uint32_t *bitmap2 = (uint32_t *)bitmap;
-      int16_t _width2 = _width >> 1;
-      int16_t xskip2 = xskip >> 1;
-      int16_t w2 = w >> 1;
-
-      for (int16_t j = 0; j < h; j++)
-      {
-        for (int16_t i = 0; i < w2; i++)
-        {
-          row2[i] = *bitmap2++;
-        }
-        bitmap2 += xskip2;
-        row2 += _width2;
-      }
-    }
-    else
-    {
-      for (int j = 0; j < h; j++)
-      {
-        for (int i = 0; i < w; i++)
-        {
-          row[i] = *bitmap++;
-        }
-        bitmap += xskip;
-        row += _width;
-      }
-    }
+    _fb.copyRect(x, y, bitmap, w, h, xskip);
     if (_auto_flush)
     {
-      Cache_WriteBack_Addr(cachePos, _width * h * 2);
+      _wb.mark(x, y, w, h);
     }
   }
 }
@@ -268,24 +224,10 @@ void Arduino_RPi_DPI_RGBPanel::draw16bitBeRGBBitmap(int16_t x, int16_t y,
       w += x;
       x = 0;
     }
-    uint16_t *row = _framebuffer;
-    row += y * _width;
-    uint32_t cachePos = (uint32_t)row;
-    row += x;
-    uint16_t color;
-    for (int j = 0; j < h; j++)
-    {
-      for (int i = 0; i < w; i++)
-      {
-        color = *bitmap++;
-        MSB_16_SET(row[i], color);
-      }
-      bitmap += xskip;
-      row += _width;
-    }
+    _fb.copyBeRect(x, y, bitmap, w, h, xskip);
     if (_auto_flush)
     {
-      Cache_WriteBack_Addr(cachePos, _width * h * 2);
+      _wb.mark(x, y, w, h);
     }
   }
 }
@@ -294,8 +236,40 @@ void Arduino_RPi_DPI_RGBPanel::flush(void)
 {
   if (!_auto_flush)
   {
-    Cache_WriteBack_Addr((uint32_t)_framebuffer, _framebuffer_size);
+    ARDUINO_GFX_CACHE_WRITEBACK((uint32_t)_framebuffer, _framebuffer_size);
+  }
+}
+
+void Arduino_RPi_DPI_RGBPanel::setRotation(uint8_t r)
+{
+  Arduino_GFX::setRotation(r);
+  _fb.resize(_width, _height);
+  _wb.resize(_width);
+}
+
+void Arduino_RPi_DPI_RGBPanel::markClipped(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+  if (x0 > x1)
+  {
+    _swap_int16_t(x0, x1);
+  }
+  if (y0 > y1)
+  {
+    _swap_int16_t(y0, y1);
   }
+  x0 = (x0 < 0) ? 0 : x0;
+  y0 = (y0 < 0) ? 0 : y0;
+  x1 = (x1 > _max_x) ? _max_x : x1;
+  y1 = (y1 > _max_y) ? _max_y : y1;
+  if ((x0 <= x1) && (y0 <= y1))
+  {
+    _wb.mark(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+  }
+}
+
+Arduino_CacheWriteBack *Arduino_RPi_DPI_RGBPanel::getCacheWriteBack()
+{
+  return &_wb;
 }
 
 uint16_t *Arduino_RPi_DPI_RGBPanel::getFramebuffer()
@@ -50,15 +50,24 @@ void Arduino_ST7701_RGBPanel::begin(int32_t speed)
   _framebuffer = _bus->getFrameBuffer(_width, _height,
                                       _hsync_pulse_width, _hsync_back_porch, _hsync_front_porch, 1,
                                       _vsync_pulse_width, _vsync_back_porch, _vsync_front_porch, 1);
+  _fb.setBuffer(_framebuffer, _width, _height);
+  _wb.begin(_framebuffer, _width);
+}
+
+void Arduino_ST7701_RGBPanel::startWrite()
+{
+  _wb.startWrite();
+}
+
+void Arduino_ST7701_RGBPanel::endWrite()
+{
+  _wb.endWrite();
 }
 
 void Arduino_ST7701_RGBPanel::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
 {
-  uint16_t *fb = _framebuffer;
-  fb += (int32_t)y * _width;
-  fb += x;
-  *fb = color;
-  Cache_WriteBack_Addr((uint32_t)fb, 2);
+  _fb.drawPixel(x, y, color);
+  _wb.mark(x, y, 1, 1);
 }
 
 void Arduino_ST7701_RGBPanel::writeFastVLine(int16_t x, int16_t y,
@@ -87,13 +96,8 @@ void Arduino_ST7701_RGBPanel::writeFastVLine(int16_t x, int16_t y,
           h = _max_y - y + 1;
         } // Clip bottom
 
-        uint16_t *fb = _framebuffer + ((int32_t)y * _width) + x;
-        while (h--)
-        {
-          *fb = color;
-          Cache_WriteBack_Addr((uint32_t)fb, 2);
-          fb += _width;
-        }
+        _fb.drawVLine(x, y, h, color);
+        _wb.mark(x, y, 1, h);
       }
     }
   }
@@ -125,14 +129,8 @@ void Arduino_ST7701_RGBPanel::writeFastHLine(int16_t x, int16_t y,
           w = _max_x - x + 1;
         } // Clip right
 
-        uint16_t *fb = _framebuffer + ((int32_t)y * _width) + x;
-        uint32_t cachePos = (uint32_t)fb;
-        int16_t writeSize = w * 2;
-        while (w--)
-        {
-          *(fb++) = color;
-        }
-        Cache_WriteBack_Addr(cachePos, writeSize);
+        _fb.drawHLine(x, y, w, color);
+        _wb.mark(x, y, w, 1);
       }
     }
   }
@@ -141,19 +139,15 @@ void Arduino_ST7701_RGBPanel::writeFastHLine(int16_t x, int16_t y,
 void Arduino_ST7701_RGBPanel::writeFillRectPreclipped(int16_t x, int16_t y,
                                                       int16_t w, int16_t h, uint16_t color)
 {
-  uint16_t *row = _framebuffer;
-  row += y * _width;
-  uint32_t cachePos = (uint32_t)row;
-  row += x;
-  for (int j = 0; j < h; j++)
-  {
-    for (int i = 0; i < w; i++)
-    {
-      row[i] = color;
-    }
-    row += _width;
-  }
-  Cache_WriteBack_Addr(cachePos, _width * h * 2);
+  _fb.fillRect(x, y, w, h, color);
+  _wb.mark(x, y, w, h);
+}
+
+void Arduino_ST7701_RGBPanel::writeSlashLine(int16_t x0, int16_t y0,
+                                             int16_t x1, int16_t y1, uint16_t color)
+{
+  _fb.drawLine(x0, y0, x1, y1, color);
+  markClipped(x0, y0, x1, y1);
 }
 
 void Arduino_ST7701_RGBPanel::draw16bitRGBBitmap(int16_t x, int16_t y,
@@ -193,41 +187,8 @@ void Arduino_ST7701_RGBPanel::draw16bitRGBBitmap(int16_t x, int16_t y,
       w += x;
       x = 0;
     }
-    uint16_t *row = _framebuffer;
-    row += y * _width;
-    uint32_t cachePos = (uint32_t)row;
-    row += x;
-    if (((_width & 1) == 0) && ((xskip & 1) == 0) && ((w & 1) == 0))
-    {
-      uint32_t *row2 = (uint32_t *)row;
-      uint32_t *bitmap2 = (uint32_t *)bitmap;
-      int16_t _width2 = _width >> 1;
-      int16_t xskip2 = xskip >> 1;
-      int16_t w2 = w >> 1;
-
-      for (int16_t j = 0; j < h; j++)
-      {
-        for (int16_t i = 0; i < w2; i++)
-        {
-          row2[i] = *bitmap2++;
-        }
-        bitmap2 += xskip2;
-        row2 += _width2;
-      }
-    }
-    else
-    {
-      for (int j = 0; j < h; j++)
-      {
-        for (int i = 0; i < w; i++)
-        {
-          row[i] = *bitmap++;
-        }
-        bitmap += xskip;
-        row += _width;
-      }
-    }
-    Cache_WriteBack_Addr(cachePos, _width * h * 2);
+    _fb.copyRect(x, y, bitmap, w, h, xskip);
+    _wb.mark(x, y, w, h);
   }
 }
 
@@ -268,22 +229,8 @@ void Arduino_ST7701_RGBPanel::draw16bitBeRGBBitmap(int16_t x, int16_t y,
       w += x;
       x = 0;
     }
-    uint16_t *row = _framebuffer;
-    row += y * _width;
-    uint32_t cachePos = (uint32_t)row;
-    row += x;
-    uint16_t color;
-    for (int j = 0; j < h; j++)
-    {
-      for (int i = 0; i < w; i++)
-      {
-        color = *bitmap++;
-        MSB_16_SET(row[i], color);
-      }
-      bitmap += xskip;
-      row += _width;
-    }
-    Cache_WriteBack_Addr(cachePos, _width * h * 2);
+    _fb.copyBeRect(x, y, bitmap, w, h, xskip);
+    _wb.mark(x, y, w, h);
   }
 }
 
@@ -296,6 +243,8 @@ void Arduino_ST7701_RGBPanel::draw16bitBeRGBBitmap(int16_t x, int16_t y,
 void Arduino_ST7701_RGBPanel::setRotation(uint8_t r)
 {
   Arduino_GFX::setRotation(r);
+  _fb.resize(_width, _height);
+  _wb.resize(_width);
   _bus->beginWrite();
   switch (_rotation)
   {
@@ -354,6 +303,31 @@ void Arduino_ST7701_RGBPanel::invertDisplay(bool i)
   _bus->sendCommand(_ips ? (i ? 0x20 : 0x21) : (i ? 0x21 : 0x20));
 }
 
+void Arduino_ST7701_RGBPanel::markClipped(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+  if (x0 > x1)
+  {
+    _swap_int16_t(x0, x1);
+  }
+  if (y0 > y1)
+  {
+    _swap_int16_t(y0, y1);
+  }
+  x0 = (x0 < 0) ? 0 : x0;
+  y0 = (y0 < 0) ? 0 : y0;
+  x1 = (x1 > _max_x) ? _max_x : x1;
+  y1 = (y1 > _max_y) ? _max_y : y1;
+  if ((x0 <= x1) && (y0 <= y1))
+  {
+    _wb.mark(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+  }
+}
+
+Arduino_CacheWriteBack *Arduino_ST7701_RGBPanel::getCacheWriteBack()
+{
+  return &_wb;
+}
+
 uint16_t *Arduino_ST7701_RGBPanel::getFramebuffer()
 {
   return _framebuffer;
@@ -7,6 +7,8 @@
 
 #include "../Arduino_GFX.h"
 #include "../databus/Arduino_ESP32RGBPanel.h"
+#include "../canvas/Arduino_Framebuffer.h"
+#include "../canvas/Arduino_CacheWriteBack.h"
 
 #define ST7701_TFTWIDTH 480
 #define ST7701_TFTHEIGHT 864
@@ -722,10 +724,13 @@ public:
         uint16_t vsync_front_porch = 4, uint16_t vsync_pulse_width = 10, uint16_t vsync_back_porch = 16);
 
     void begin(int32_t speed = GFX_NOT_DEFINED) override;
+    void startWrite() override;
+    void endWrite(void) override;
     void writePixelPreclipped(int16_t x, int16_t y, uint16_t color) override;
     void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
     void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
     void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void writeSlashLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) override;
     void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
     void draw16bitBeRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
 
@@ -733,9 +738,14 @@ public:
     void invertDisplay(bool) override;
 
     uint16_t *getFramebuffer();
+    Arduino_CacheWriteBack *getCacheWriteBack();
 
 protected:
+    void markClipped(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
     uint16_t *_framebuffer;
+    Arduino_Framebuffer<Arduino_PixelRGB565> _fb;
+    Arduino_CacheWriteBack _wb;
     Arduino_ESP32RGBPanel *_bus;
     int8_t _rst;
     bool _ips;
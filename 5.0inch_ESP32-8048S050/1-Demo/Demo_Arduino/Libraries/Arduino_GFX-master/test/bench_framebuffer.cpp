@@ -0,0 +1,148 @@
+/*
+ * Host micro-benchmark of Arduino_Framebuffer.
+ *
+ * Compares the inlined surface with the per pixel virtual writePixel() path
+ * the canvas and RGB panel classes used before, on an 800x480 RGB565 buffer.
+ * Both paths have to produce the same pixels.
+ *
+ *   test/run.sh bench_framebuffer
+ */
+#include "canvas/Arduino_Framebuffer.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <utility>
+#include <string.h>
+#include <vector>
+
+#define WIDTH 800
+#define HEIGHT 480
+
+// The old path: one virtual call and one clip test per pixel
+class PixelSink
+{
+public:
+  virtual ~PixelSink() {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) = 0;
+};
+
+class BufferSink : public PixelSink
+{
+public:
+  uint16_t *buf;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if ((x >= 0) && (x < WIDTH) && (y >= 0) && (y < HEIGHT))
+    {
+      buf[(int32_t)y * WIDTH + x] = color;
+    }
+  }
+};
+
+static void sinkFillRect(PixelSink *s, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  for (int16_t j = y; j < y + h; j++)
+  {
+    for (int16_t i = x; i < x + w; i++)
+    {
+      s->writePixel(i, j, color);
+    }
+  }
+}
+
+// Same Bresenham walk as Adafruit_GFX::writeLine()
+static void sinkDrawLine(PixelSink *s, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep)
+  {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1)
+  {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+  int16_t dx = x1 - x0;
+  int16_t dy = abs(y1 - y0);
+  int16_t err = dx / 2;
+  int16_t ystep = (y0 < y1) ? 1 : -1;
+  for (; x0 <= x1; x0++)
+  {
+    if (steep)
+    {
+      s->writePixel(y0, x0, color);
+    }
+    else
+    {
+      s->writePixel(x0, y0, color);
+    }
+    err -= dy;
+    if (err < 0)
+    {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+static double since(std::chrono::steady_clock::time_point t)
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t).count();
+}
+
+static int report(const char *name, double old_us, double new_us, const std::vector<uint16_t> &a, const std::vector<uint16_t> &b)
+{
+  bool same = (a == b);
+  printf("%-10s virtual %9.0f us  surface %9.0f us  %5.1fx  %s\n",
+         name, old_us, new_us, old_us / new_us, same ? "same pixels" : "PIXELS DIFFER");
+  return same ? 0 : 1;
+}
+
+int main()
+{
+  std::vector<uint16_t> a(WIDTH * HEIGHT), b(WIDTH * HEIGHT);
+  BufferSink sink;
+  sink.buf = a.data();
+  // Hidden from the optimizer so the calls stay virtual, like on a GFX pointer
+  PixelSink *volatile sink_ptr = &sink;
+  PixelSink *s = sink_ptr;
+  Arduino_Framebuffer<Arduino_PixelRGB565> fb;
+  fb.setBuffer(b.data(), WIDTH, HEIGHT);
+  int failed = 0;
+
+  auto t = std::chrono::steady_clock::now();
+  for (int k = 0; k < 100; k++)
+    sinkFillRect(s, 13, 10, 600, 390, (uint16_t)k);
+  double old_us = since(t);
+  t = std::chrono::steady_clock::now();
+  for (int k = 0; k < 100; k++)
+    fb.fillRect(13, 10, 600, 390, (uint16_t)k);
+  failed += report("fillRect", old_us, since(t), a, b);
+
+  t = std::chrono::steady_clock::now();
+  for (int k = 0; k < 2000; k++)
+    sinkDrawLine(s, 0, k % HEIGHT, WIDTH - 1, HEIGHT - 1 - (k % HEIGHT), (uint16_t)k);
+  old_us = since(t);
+  t = std::chrono::steady_clock::now();
+  for (int k = 0; k < 2000; k++)
+    fb.drawLine(0, k % HEIGHT, WIDTH - 1, HEIGHT - 1 - (k % HEIGHT), (uint16_t)k);
+  failed += report("drawLine", old_us, since(t), a, b);
+
+  std::vector<uint16_t> bitmap(320 * 240);
+  for (size_t i = 0; i < bitmap.size(); i++)
+    bitmap[i] = (uint16_t)(i * 2654435761u >> 16);
+  t = std::chrono::steady_clock::now();
+  for (int k = 0; k < 200; k++)
+    for (int16_t j = 0; j < 240; j++)
+      for (int16_t i = 0; i < 320; i++)
+        s->writePixel(100 + i + (k & 7), 50 + j, bitmap[j * 320 + i]);
+  old_us = since(t);
+  t = std::chrono::steady_clock::now();
+  for (int k = 0; k < 200; k++)
+    fb.copyRect(100 + (k & 7), 50, bitmap.data(), 320, 240);
+  failed += report("copyRect", old_us, since(t), a, b);
+
+  return failed;
+}
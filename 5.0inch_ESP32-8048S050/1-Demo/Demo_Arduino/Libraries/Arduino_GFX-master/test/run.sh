@@ -0,0 +1,29 @@
+#!/bin/bash
+# Build and run the host tests and benchmarks of this folder, they only use
+# the hardware independent headers of src/.
+#
+#   test/run.sh            all of them
+#   test/run.sh <name>...  test/<name>.cpp only
+
+cd "$(dirname "$0")/.." || exit 1
+CXX=${CXX:-g++}
+OUT=${OUT:-/tmp/arduino_gfx_test}
+mkdir -p "$OUT"
+
+names=("$@")
+if [ ${#names[@]} -eq 0 ]; then
+  for f in test/*.cpp; do
+    names+=("$(basename "$f" .cpp)")
+  done
+fi
+
+failed=0
+for name in "${names[@]}"; do
+  echo "=== $name"
+  if ! $CXX -O2 -std=gnu++17 -Wall -Isrc "test/$name.cpp" -o "$OUT/$name"; then
+    failed=1
+    continue
+  fi
+  "$OUT/$name" || failed=1
+done
+exit $failed
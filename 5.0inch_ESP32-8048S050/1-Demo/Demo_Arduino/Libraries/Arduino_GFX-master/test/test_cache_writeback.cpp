@@ -0,0 +1,215 @@
+/*
+ * Host test of Arduino_CacheWriteBack against a counting mock of
+ * Cache_WriteBack_Addr().
+ *
+ * Every write-back has to be cache line aligned and cover the marked pixels,
+ * and a batch has to end in one write-back per dirty span: one range for a
+ * wide area, one per row for a narrow one, none for a clean batch.
+ *
+ *   test/run.sh test_cache_writeback
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+struct Range
+{
+  uint32_t addr;
+  uint32_t size;
+};
+static std::vector<Range> ranges;
+
+static void mockWriteBack(uint32_t addr, uint32_t size)
+{
+  ranges.push_back({addr, size});
+}
+
+#define ARDUINO_GFX_CACHE_WRITEBACK(addr, size) mockWriteBack((addr), (size))
+#define ARDUINO_GFX_CACHE_LINE_SIZE 32
+#include "canvas/Arduino_CacheWriteBack.h"
+
+#define WIDTH 800
+#define HEIGHT 480
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do                                                                  \
+  {                                                                   \
+    if (!(cond))                                                      \
+    {                                                                 \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                     \
+    }                                                                 \
+  } while (0)
+
+// Line aligned frame buffer, so the addresses are easy to reason about
+alignas(64) static uint16_t framebuffer[WIDTH * HEIGHT];
+
+static uint32_t pixelAddr(int16_t x, int16_t y)
+{
+  return (uint32_t)(uintptr_t)&framebuffer[(int32_t)y * WIDTH + x];
+}
+
+// Every pixel of the area lies in one of the written back ranges
+static bool covered(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  for (int16_t j = y; j < y + h; j++)
+  {
+    for (int16_t i = x; i < x + w; i++)
+    {
+      uint32_t a = pixelAddr(i, j);
+      bool found = false;
+      for (const Range &r : ranges)
+      {
+        if ((a >= r.addr) && (a + 2 <= r.addr + r.size))
+        {
+          found = true;
+          break;
+        }
+      }
+      if (!found)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static bool aligned()
+{
+  for (const Range &r : ranges)
+  {
+    if ((r.addr % 32) || (r.size % 32) || (r.size == 0))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void test_unbatched()
+{
+  Arduino_CacheWriteBack wb;
+  wb.begin(framebuffer, WIDTH);
+  ranges.clear();
+
+  // Outside a batch every mark is written back right away
+  for (int16_t i = 0; i < 10; i++)
+  {
+    wb.mark(10, i, 1, 1);
+  }
+  CHECK(ranges.size() == 10);
+  CHECK(wb.calls() == 10);
+  CHECK(covered(10, 0, 1, 10));
+  CHECK(aligned());
+}
+
+static void test_batched_narrow()
+{
+  Arduino_CacheWriteBack wb;
+  wb.begin(framebuffer, WIDTH);
+  ranges.clear();
+
+  // A vertical line drawn pixel by pixel: one write-back per row, at the end
+  wb.startWrite();
+  for (int16_t i = 0; i < 100; i++)
+  {
+    wb.mark(10, 20 + i, 1, 1);
+  }
+  CHECK(ranges.empty());
+  wb.endWrite();
+  CHECK(ranges.size() == 100);
+  CHECK(covered(10, 20, 1, 100));
+  CHECK(aligned());
+  // Only the line's cache line of each row, not the whole row
+  CHECK(wb.bytes() == 100 * 32);
+}
+
+static void test_batched_wide()
+{
+  Arduino_CacheWriteBack wb;
+  wb.begin(framebuffer, WIDTH);
+  ranges.clear();
+
+  // Text drawn glyph by glyph over most of the width: one contiguous range
+  wb.startWrite();
+  for (int16_t x = 5; x < 700; x += 20)
+  {
+    wb.mark(x, 100, 16, 24);
+  }
+  wb.endWrite();
+  CHECK(ranges.size() == 1);
+  CHECK(covered(5, 100, 695, 24));
+  CHECK(aligned());
+  CHECK(ranges[0].addr == (pixelAddr(5, 100) & ~31u));
+  CHECK(ranges[0].addr + ranges[0].size == ((pixelAddr(699, 123) + 2 + 31) & ~31u));
+
+  // A single row is always one range
+  ranges.clear();
+  wb.startWrite();
+  wb.mark(3, 7, 2, 1);
+  wb.mark(400, 7, 2, 1);
+  wb.endWrite();
+  CHECK(ranges.size() == 1);
+  CHECK(covered(3, 7, 399, 1));
+}
+
+static void test_nested()
+{
+  Arduino_CacheWriteBack wb;
+  wb.begin(framebuffer, WIDTH);
+  ranges.clear();
+
+  // Only the outermost endWrite() flushes
+  wb.startWrite();
+  wb.mark(0, 0, WIDTH, 2);
+  wb.startWrite();
+  wb.mark(0, 2, WIDTH, 2);
+  wb.endWrite();
+  CHECK(ranges.empty());
+  wb.endWrite();
+  CHECK(ranges.size() == 1);
+  CHECK(covered(0, 0, WIDTH, 4));
+  CHECK(ranges[0].size == WIDTH * 2 * 4);
+
+  // A clean batch writes nothing back, an unbalanced endWrite() neither
+  ranges.clear();
+  wb.startWrite();
+  wb.endWrite();
+  wb.endWrite();
+  wb.flush();
+  CHECK(ranges.empty());
+}
+
+static void test_resize()
+{
+  Arduino_CacheWriteBack wb;
+  wb.begin(framebuffer, WIDTH);
+  ranges.clear();
+
+  // Pending areas are written back with the old width
+  wb.startWrite();
+  wb.mark(0, 0, WIDTH, 3);
+  wb.resize(HEIGHT);
+  CHECK(ranges.size() == 1);
+  CHECK(covered(0, 0, WIDTH, 3));
+  wb.endWrite();
+  CHECK(ranges.size() == 1);
+
+  wb.resetStats();
+  CHECK(wb.calls() == 0);
+  CHECK(wb.bytes() == 0);
+}
+
+int main()
+{
+  test_unbatched();
+  test_batched_narrow();
+  test_batched_wide();
+  test_nested();
+  test_resize();
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -1140,7 +1140,7 @@ int BlinkerMQTT::print(char * data, bool needCheck)
             }
 
             // if (! mqtt_MQTT->publish(BLINKER_PUB_TOPIC_MQTT, data_add.c_str()))
-            if (! mqtt_MQTT->publish(BLINKER_PUB_TOPIC_MQTT, data))
+            if (! mqtt_MQTT->publishQueued(BLINKER_PUB_TOPIC_MQTT, data))
             {
                 BLINKER_LOG_ALL(data);
                 BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1192,7 +1192,7 @@ int BlinkerMQTT::toServer(char * data)
 
     if (mqtt_MQTT->connected())
     {
-        if (! mqtt_MQTT->publish(BLINKER_PUB_TOPIC_MQTT, data))
+        if (! mqtt_MQTT->publishQueued(BLINKER_PUB_TOPIC_MQTT, data))
         {
             BLINKER_LOG_ALL(data);
             BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1311,7 +1311,7 @@ int BlinkerMQTT::bPrint(char * name, const String & data)
         //     bPubTopic = BLINKER_PUB_TOPIC_MQTT;
         // }
 
-        if (! mqtt_MQTT->publish(BLINKER_PUB_TOPIC_MQTT, data_add.c_str()))
+        if (! mqtt_MQTT->publishQueued(BLINKER_PUB_TOPIC_MQTT, data_add.c_str()))
         {
             BLINKER_LOG_ALL(data_add);
             BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1430,7 +1430,7 @@ int BlinkerMQTT::aliPrint(const String & data)
             strcpy(send_data, data_add.c_str());
         }
 
-        if (! mqtt_MQTT->publish(BLINKER_RRPC_PUB_TOPIC_MQTT, send_data))
+        if (! mqtt_MQTT->publishQueued(BLINKER_RRPC_PUB_TOPIC_MQTT, send_data))
         {
             BLINKER_LOG_ALL(data_add);
             BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1561,7 +1561,7 @@ int BlinkerMQTT::duerPrint(const String & data, bool report)
             strcpy(send_data, data_add.c_str());
         }
 
-        if (! mqtt_MQTT->publish(BLINKER_RRPC_PUB_TOPIC_MQTT, send_data))
+        if (! mqtt_MQTT->publishQueued(BLINKER_RRPC_PUB_TOPIC_MQTT, send_data))
         {
             BLINKER_LOG_ALL(data_add);
             BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1677,7 +1677,7 @@ int BlinkerMQTT::miPrint(const String & data)
             strcpy(send_data, data_add.c_str());
         }
 
-        if (! mqtt_MQTT->publish(BLINKER_RRPC_PUB_TOPIC_MQTT, send_data))
+        if (! mqtt_MQTT->publishQueued(BLINKER_RRPC_PUB_TOPIC_MQTT, send_data))
         {
             BLINKER_LOG_ALL(data_add);
             BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -1834,7 +1834,7 @@ int BlinkerMQTT::autoPrint(unsigned long id)
 
             // if (! iotPub.publish(payload.c_str())) {
 
-            if (! mqtt_MQTT->publish(BLINKER_PUB_TOPIC_MQTT, payload.c_str()))
+            if (! mqtt_MQTT->publishQueued(BLINKER_PUB_TOPIC_MQTT, payload.c_str()))
             {
                 BLINKER_LOG_ALL(payload);
                 BLINKER_LOG_ALL(BLINKER_F("...Failed"));
@@ -2227,6 +2227,9 @@ int BlinkerMQTT::connectServer() {
     //     free(BLINKER_SUB_TOPIC_MQTT);
     //     // free(BLINKER_RRPC_PUB_TOPIC_MQTT);
     //     free(BLINKER_RRPC_SUB_TOPIC_MQTT);
+    #if BLINKER_MQTT_QUEUE_SIZE
+        if (mqtt_MQTT) mqtt_MQTT->endQueue();
+    #endif
         free(mqtt_MQTT);
         free(iotSub_MQTT);
     //     // free(iotSub_RRPC_MQTT);
@@ -2500,6 +2503,10 @@ int BlinkerMQTT::connectServer() {
     mqtt_MQTT->subscribe(iotSub_MQTT);
     // mqtt_MQTT->subscribe(iotSub_RRPC_MQTT);
 
+    #if BLINKER_MQTT_QUEUE_SIZE
+        mqtt_MQTT->beginQueue(BLINKER_MQTT_QUEUE_SIZE, BLINKER_MQTT_INFLIGHT);
+    #endif
+
     #if defined(ESP8266)
         // client_s->stop();
         // if (!isMQTTinit)
@@ -218,6 +218,8 @@ enum b_nbiot_status_t {
     };
 #endif
 
+#include "BlinkerParseDoc.h"
+
 class BlinkerApi : public BlinkerProtocol
 {
     public :
@@ -807,6 +809,8 @@ class BlinkerApi : public BlinkerProtocol
         char * widgetName_rgb(uint8_t num);
         char * widgetName_int(uint8_t num);
         char * widgetName_tab(uint8_t num);
+        // Received values dispatched to the widget, 0 if there is none of this name
+        uint32_t widgetCalls(const char * _name);
 
         #if defined(BLINKER_PRO) || defined(BLINKER_PRO_SIM7020) || \
             defined(BLINKER_PRO_AIR202) || defined(BLINKER_MQTT_AUTO) || \
@@ -890,6 +894,14 @@ class BlinkerApi : public BlinkerProtocol
             uint32_t gps_air202_time = 0;
         #endif
         bool        _fresh = false;
+        #if defined(BLINKER_ARDUINOJSON)
+            #if BLINKER_PARSE_DOC_SIZE > 0
+                BlinkerParseArena   _parseArena;
+                BlinkerParseArena * parseArena() { return &_parseArena; }
+            #else
+                BlinkerParseArena * parseArena() { return NULL; }
+            #endif
+        #endif
         int16_t     ahrsValue[3];
         float       gpsValue[2];
         uint32_t    gps_get_time;
@@ -909,6 +921,9 @@ class BlinkerApi : public BlinkerProtocol
         class BlinkerWidgets_rgb *          _Widgets_rgb[BLINKER_MAX_WIDGET_SIZE/2];
         class BlinkerWidgets_int32 *        _Widgets_int[BLINKER_MAX_WIDGET_SIZE*2];
         class BlinkerWidgets_table *        _Widgets_tab[BLINKER_MAX_WIDGET_SIZE*2];
+        #if BLINKER_WIDGET_TABLE_SIZE > 0
+            BlinkerWidgetTable              _widgetTable;
+        #endif
         // class BlinkerWidgets_string *       _BUILTIN_SWITCH;
         BlinkerWidgets_string _BUILTIN_SWITCH = BlinkerWidgets_string(BLINKER_CMD_BUILTIN_SWITCH);
 
@@ -1209,6 +1224,10 @@ class BlinkerApi : public BlinkerProtocol
 
         void parse(char _data[], bool ex_data = false);
 
+        int8_t widgetNum(const char * _name, uint8_t * type);
+        char * widgetName(uint8_t type, uint8_t num);
+        void widgetAdded(char _name[], uint8_t type, uint8_t num);
+
         bool deviceHeartbeat(uint32_t heart_time = BLINKER_DEVICE_HEARTBEAT_TIME);
 
         #if defined(BLINKER_ARDUINOJSON)
@@ -1228,13 +1247,13 @@ class BlinkerApi : public BlinkerProtocol
                 defined(BLINKER_MQTT_AUTO) || defined(BLINKER_PRO_ESP)
                 void bridgeParse(char _bName[], uint8_t num, const JsonObject& data);
             #endif
-            void strWidgetsParse(char _wName[], const JsonObject& data);
+            void strWidgetsParse(uint8_t num, JsonVariant value);
             // #if defined(BLINKER_BLE)
-                void joyWidgetsParse(char _wName[], const JsonObject& data);
+                void joyWidgetsParse(uint8_t num, JsonVariant value);
             // #endif
-            void rgbWidgetsParse(char _wName[], const JsonObject& data);
-            void intWidgetsParse(char _wName[], const JsonObject& data);
-            void tabWidgetsParse(char _wName[], const JsonObject& data);
+            void rgbWidgetsParse(uint8_t num, JsonVariant value);
+            void intWidgetsParse(uint8_t num, JsonVariant value);
+            void tabWidgetsParse(uint8_t num, JsonVariant value);
 
             void json_parse(const JsonObject& data);
         #else
@@ -4827,9 +4846,9 @@ void BlinkerApi::parse(char _data[], bool ex_data)
 
                 // DynamicJsonBuffer jsonBuffer;
                 // JsonObject& root = jsonBuffer.parseObject(STRING_format(_data));
-                DynamicJsonDocument jsonBuffer(1024);
-                DeserializationError error = deserializeJson(jsonBuffer, STRING_format(_data));
-                JsonObject root = jsonBuffer.as<JsonObject>();
+                BlinkerParseDoc jsonBuffer(parseArena());
+                DeserializationError error = jsonBuffer.parse(_data);
+                JsonObject root = jsonBuffer.root();
 
                 // if (!root.success())
                 if (error)
@@ -4941,32 +4960,23 @@ void BlinkerApi::parse(char _data[], bool ex_data)
     else
     {
         #if defined(BLINKER_ARDUINOJSON)
-            String arrayData = BLINKER_F("{\"data\":");
-            arrayData += _data;
-            arrayData += BLINKER_F("}");
             // DynamicJsonBuffer jsonBuffer;
             // JsonObject& root = jsonBuffer.parseObject(arrayData);
-            DynamicJsonDocument jsonBuffer(1024);
-            DeserializationError error = deserializeJson(jsonBuffer, arrayData);
-            JsonObject root = jsonBuffer.as<JsonObject>();
+            BlinkerParseDoc jsonBuffer(parseArena());
+            DeserializationError error = jsonBuffer.parse(_data, true);
+            JsonVariant data = jsonBuffer.root()["data"];
 
             // if (!root.success()) return;
             if (error) return;
 
-            arrayData = root["data"][0].as<String>();
-
-            if (arrayData != "null")
+            if (!data[0].isNull())
             {
                 for (uint8_t a_num = 0; a_num < BLINKER_MAX_WIDGET_SIZE; a_num++)
                 {
-                    arrayData = root["data"][a_num].as<String>();
-
-                    if(arrayData != "null") {
+                    if(!data[a_num].isNull()) {
                         // DynamicJsonBuffer _jsonBuffer;
                         // JsonObject& _array = _jsonBuffer.parseObject(arrayData);
-                        DynamicJsonDocument jsonBuffer(1024);
-                        deserializeJson(jsonBuffer, arrayData);
-                        JsonObject _array = jsonBuffer.as<JsonObject>();
+                        JsonObject _array = data[a_num].as<JsonObject>();
 
                         json_parse(_array);
                         #if defined(BLINKER_WIFI) || defined(BLINKER_MQTT) || \
@@ -4995,11 +5005,7 @@ void BlinkerApi::parse(char _data[], bool ex_data)
             }
             else {
                 // JsonObject& root = jsonBuffer.parseObject(_data);
-                DeserializationError error = deserializeJson(jsonBuffer, _data);
-                JsonObject root = jsonBuffer.as<JsonObject>();
-
-                // if (!root.success()) return;
-                if (error) return;
+                JsonObject root = data.as<JsonObject>();
 
                 json_parse(root);
 
@@ -6965,20 +6971,26 @@ float BlinkerApi::gps(b_gps_t axis)
 
         time_t _time = time();
         uint8_t _second = second();
-        time_t now_time = _time - _second;
+        #if BLINKER_DATA_FREQ_TIME >= 60
+            time_t now_time = _time - _second;
+        #else
+            time_t now_time = _time - _time % BLINKER_DATA_FREQ_TIME;
+        #endif
 
         BLINKER_LOG_ALL(BLINKER_F("time: "), _time, BLINKER_F(",second: "), _second);
 
         BLINKER_LOG_ALL(BLINKER_F("now_time: "), now_time);
 
-        now_time = now_time - now_time % 10;
+        #if BLINKER_DATA_FREQ_TIME >= 60
+            now_time = now_time - now_time % 10;
+        #endif
 
         BLINKER_LOG_ALL(BLINKER_F("dataStorage num: "), num, BLINKER_F(" ,"), now_time);
         BLINKER_LOG_ALL(BLINKER_F("dataStorage count: "), data_dataCount);
 
         String data_msg = String(msg);
 
-        if (data_msg.length() > 10) return;
+        if (data_msg.length() > 20) return;
 
         if( num == BLINKER_OBJECT_NOT_AVAIL )
         {
@@ -7472,11 +7484,19 @@ float BlinkerApi::gps(b_gps_t axis)
 
             // uint32_t now_time = time() - second();
 
+            // One allocation for the whole upload, the series are written
+            // straight into it
+            size_t length = data.length() + 2;
+            for (uint8_t _num = 0; _num < data_dataCount; _num++) {
+                length += _Data[_num]->getName().length() + 4 + _Data[_num]->dataLength();
+            }
+            data.reserve(length);
+
             for (uint8_t _num = 0; _num < data_dataCount; _num++) {
                 data += BLINKER_F("\"");
                 data += _Data[_num]->getName();
                 data += BLINKER_F("\":");
-                data += _Data[_num]->getData();
+                _Data[_num]->getData(data);
                 if (_num < data_dataCount - 1) {
                     data += BLINKER_F(",");
                 }
@@ -8294,6 +8314,7 @@ uint8_t BlinkerApi::attachWidget(char _name[], blinker_callback_with_string_arg_
         {
             _Widgets_str[_wCount_str] = new BlinkerWidgets_string(_name, _func);
             _wCount_str++;
+            widgetAdded(_name, BLINKER_WIDGET_STR, _wCount_str - 1);
 
             BLINKER_LOG_ALL(BLINKER_F("new widgets: "), _name, \
                         BLINKER_F(" _wCount_str: "), _wCount_str);
@@ -8326,6 +8347,7 @@ uint8_t BlinkerApi::attachWidget(char _name[], blinker_callback_with_string_arg_
             {
                 _Widgets_joy[_wCount_joy] = new BlinkerWidgets_joy(_name, _func);
                 _wCount_joy++;
+                widgetAdded(_name, BLINKER_WIDGET_JOY, _wCount_joy - 1);
 
                 BLINKER_LOG_ALL(BLINKER_F("new widgets: "), _name, \
                 BLINKER_F(" _wCount_joy: "), _wCount_joy);
@@ -8359,6 +8381,7 @@ uint8_t BlinkerApi::attachWidget(char _name[], blinker_callback_with_rgb_arg_t _
         {
             _Widgets_rgb[_wCount_rgb] = new BlinkerWidgets_rgb(_name, _func);
             _wCount_rgb++;
+            widgetAdded(_name, BLINKER_WIDGET_RGB, _wCount_rgb - 1);
 
             BLINKER_LOG_ALL(BLINKER_F("new widgets: "), _name, \
                         BLINKER_F(" _wCount_rgb: "), _wCount_rgb);
@@ -8391,6 +8414,7 @@ uint8_t BlinkerApi::attachWidget(char _name[], blinker_callback_with_int32_arg_t
         {
             _Widgets_int[_wCount_int] = new BlinkerWidgets_int32(_name, _func);
             _wCount_int++;
+            widgetAdded(_name, BLINKER_WIDGET_INT, _wCount_int - 1);
 
             BLINKER_LOG_ALL(BLINKER_F("new widgets: "), _name, \
                         BLINKER_F(" _wCount_int: "), _wCount_int);
@@ -8424,6 +8448,7 @@ uint8_t BlinkerApi::attachWidget(char _name[], blinker_callback_with_table_arg_t
         {
             _Widgets_tab[_wCount_tab] = new BlinkerWidgets_table(_name, _func, _func2);
             _wCount_tab++;
+            widgetAdded(_name, BLINKER_WIDGET_TAB, _wCount_tab - 1);
 
             BLINKER_LOG_ALL(BLINKER_F("new widgets: "), _name, \
                         BLINKER_F(" _wCount_tab: "), _wCount_tab);
@@ -8461,6 +8486,70 @@ void BlinkerApi::attachSwitch(blinker_callback_with_string_arg_t _func)
     _BUILTIN_SWITCH.setFunc(_func);
 }
 
+void BlinkerApi::widgetAdded(char _name[], uint8_t type, uint8_t num)
+{
+    #if BLINKER_WIDGET_TABLE_SIZE > 0
+        _widgetTable.add(_name, type, num);
+    #endif
+}
+
+int8_t BlinkerApi::widgetNum(const char * _name, uint8_t * type)
+{
+    #if BLINKER_WIDGET_TABLE_SIZE > 0
+        uint32_t h = BlinkerWidgetTable::hash(_name);
+        uint16_t pos = BlinkerWidgetTable::first(h);
+        uint8_t num;
+
+        while (_widgetTable.next(h, &pos, type, &num))
+        {
+            if (strcmp(widgetName(*type, num), _name) == 0) return num;
+        }
+    #else
+        char * name = (char *)_name;
+        int8_t num;
+
+        if ((num = checkNum(name, _Widgets_str, _wCount_str)) >= 0) *type = BLINKER_WIDGET_STR;
+        else if ((num = checkNum(name, _Widgets_int, _wCount_int)) >= 0) *type = BLINKER_WIDGET_INT;
+        else if ((num = checkNum(name, _Widgets_rgb, _wCount_rgb)) >= 0) *type = BLINKER_WIDGET_RGB;
+        else if ((num = checkNum(name, _Widgets_joy, _wCount_joy)) >= 0) *type = BLINKER_WIDGET_JOY;
+        else if ((num = checkNum(name, _Widgets_tab, _wCount_tab)) >= 0) *type = BLINKER_WIDGET_TAB;
+
+        if (num >= 0) return num;
+    #endif
+
+    *type = BLINKER_WIDGET_NONE;
+    return BLINKER_OBJECT_NOT_AVAIL;
+}
+
+char * BlinkerApi::widgetName(uint8_t type, uint8_t num)
+{
+    switch (type)
+    {
+        case BLINKER_WIDGET_STR: return _Widgets_str[num]->getName();
+        case BLINKER_WIDGET_INT: return _Widgets_int[num]->getName();
+        case BLINKER_WIDGET_RGB: return _Widgets_rgb[num]->getName();
+        case BLINKER_WIDGET_JOY: return _Widgets_joy[num]->getName();
+        case BLINKER_WIDGET_TAB: return _Widgets_tab[num]->getName();
+        default: return "";
+    }
+}
+
+uint32_t BlinkerApi::widgetCalls(const char * _name)
+{
+    uint8_t type;
+    int8_t num = widgetNum(_name, &type);
+
+    switch (type)
+    {
+        case BLINKER_WIDGET_STR: return _Widgets_str[num]->calls();
+        case BLINKER_WIDGET_INT: return _Widgets_int[num]->calls();
+        case BLINKER_WIDGET_RGB: return _Widgets_rgb[num]->calls();
+        case BLINKER_WIDGET_JOY: return _Widgets_joy[num]->calls();
+        case BLINKER_WIDGET_TAB: return _Widgets_tab[num]->calls();
+        default: return 0;
+    }
+}
+
 char * BlinkerApi::widgetName_str(uint8_t num)
 {
     if (num) return _Widgets_str[num - 1]->getName();
@@ -8715,141 +8804,110 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
         }
     #endif
 
-    void BlinkerApi::strWidgetsParse(char _wName[], const JsonObject& data)
+    void BlinkerApi::strWidgetsParse(uint8_t num, JsonVariant value)
     {
-        int8_t num = checkNum(_wName, _Widgets_str, _wCount_str);
-
-        if (num == BLINKER_OBJECT_NOT_AVAIL) return;
-
-        if (data.containsKey(_wName))
-        {
-            String state = data[_wName];
-            BLINKER_LOG_ALL(BLINKER_F("strWidgetsParse isParsed"));
-            _fresh = true;
+        String state = value;
+        BLINKER_LOG_ALL(BLINKER_F("strWidgetsParse isParsed"));
+        _fresh = true;
 
-            BLINKER_LOG_ALL(BLINKER_F("strWidgetsParse: "), _wName);
+        BLINKER_LOG_ALL(BLINKER_F("strWidgetsParse: "), _Widgets_str[num]->getName());
 
-            blinker_callback_with_string_arg_t nbFunc = _Widgets_str[num]->getFunc();
+        _Widgets_str[num]->called();
+        blinker_callback_with_string_arg_t nbFunc = _Widgets_str[num]->getFunc();
 
-            if (nbFunc) nbFunc(state);
-        }
+        if (nbFunc) nbFunc(state);
     }
 
     // #if defined(BLINKER_BLE)
-        void BlinkerApi::joyWidgetsParse(char _wName[], const JsonObject& data)
+        void BlinkerApi::joyWidgetsParse(uint8_t num, JsonVariant value)
         {
-            int8_t num = checkNum(_wName, _Widgets_joy, _wCount_joy);
-
-            if (num == BLINKER_OBJECT_NOT_AVAIL) return;
-
-            if (data.containsKey(_wName))
-            {
-                int16_t jxAxisValue = data[_wName][BLINKER_J_Xaxis];
-                uint8_t jyAxisValue = data[_wName][BLINKER_J_Yaxis];
-                BLINKER_LOG_ALL(BLINKER_F("joyWidgetsParse isParsed"));
-                _fresh = true;
+            int16_t jxAxisValue = value[BLINKER_J_Xaxis];
+            uint8_t jyAxisValue = value[BLINKER_J_Yaxis];
+            BLINKER_LOG_ALL(BLINKER_F("joyWidgetsParse isParsed"));
+            _fresh = true;
 
-                blinker_callback_with_joy_arg_t wFunc = _Widgets_joy[num]->getFunc();
-                if (wFunc) wFunc(jxAxisValue, jyAxisValue);
-            }
+            _Widgets_joy[num]->called();
+            blinker_callback_with_joy_arg_t wFunc = _Widgets_joy[num]->getFunc();
+            if (wFunc) wFunc(jxAxisValue, jyAxisValue);
         }
     // #endif
 
-    void BlinkerApi::rgbWidgetsParse(char _wName[], const JsonObject& data)
+    void BlinkerApi::rgbWidgetsParse(uint8_t num, JsonVariant value)
     {
-        int8_t num = checkNum(_wName, _Widgets_rgb, _wCount_rgb);
-
-        if (num == BLINKER_OBJECT_NOT_AVAIL) return;
-
-        if (data.containsKey(_wName))
-        {
-            uint8_t _rValue = data[_wName][BLINKER_R];
-            uint8_t _gValue = data[_wName][BLINKER_G];
-            uint8_t _bValue = data[_wName][BLINKER_B];
-            uint8_t _brightValue = data[_wName][BLINKER_BRIGHT];
-            BLINKER_LOG_ALL(BLINKER_F("rgbWidgetsParse isParsed"));
-            _fresh = true;
+        uint8_t _rValue = value[BLINKER_R];
+        uint8_t _gValue = value[BLINKER_G];
+        uint8_t _bValue = value[BLINKER_B];
+        uint8_t _brightValue = value[BLINKER_BRIGHT];
+        BLINKER_LOG_ALL(BLINKER_F("rgbWidgetsParse isParsed"));
+        _fresh = true;
 
-            blinker_callback_with_rgb_arg_t wFunc = _Widgets_rgb[num]->getFunc();
-            if (wFunc) wFunc(_rValue, _gValue, _bValue, _brightValue);
-        }
+        _Widgets_rgb[num]->called();
+        blinker_callback_with_rgb_arg_t wFunc = _Widgets_rgb[num]->getFunc();
+        if (wFunc) wFunc(_rValue, _gValue, _bValue, _brightValue);
     }
 
-    void BlinkerApi::intWidgetsParse(char _wName[], const JsonObject& data)
+    void BlinkerApi::intWidgetsParse(uint8_t num, JsonVariant value)
     {
-        int8_t num = checkNum(_wName, _Widgets_int, _wCount_int);
-
-        if (num == BLINKER_OBJECT_NOT_AVAIL) return;
+        int _number = value;
+        BLINKER_LOG_ALL(BLINKER_F("intWidgetsParse isParsed"));
+        _fresh = true;
 
-        if (data.containsKey(_wName)) {
-            int _number = data[_wName];
-            BLINKER_LOG_ALL(BLINKER_F("intWidgetsParse isParsed"));
-            _fresh = true;
-
-            blinker_callback_with_int32_arg_t wFunc = _Widgets_int[num]->getFunc();
-            if (wFunc) {
-                wFunc(_number);
-            }
+        _Widgets_int[num]->called();
+        blinker_callback_with_int32_arg_t wFunc = _Widgets_int[num]->getFunc();
+        if (wFunc) {
+            wFunc(_number);
         }
     }
 
-    void BlinkerApi::tabWidgetsParse(char _wName[], const JsonObject& data)
+    void BlinkerApi::tabWidgetsParse(uint8_t num, JsonVariant value)
     {
-        int8_t num = checkNum(_wName, _Widgets_tab, _wCount_tab);
-
-        if (num == BLINKER_OBJECT_NOT_AVAIL) return;
+        String _setData = value;
 
-        if (data.containsKey(_wName)) {
-            String _setData = data[_wName];
+        _Widgets_tab[num]->called();
+        blinker_callback_with_table_arg_t wFunc = _Widgets_tab[num]->getFunc();
 
-            uint8_t _number = 0;
+        for (uint8_t tNum = 0; tNum < 5; tNum++)
+        {
+            // BLINKER_LOG_ALL(BLINKER_F("num: "), _setData.substring(tNum, tNum + 1));
 
-            blinker_callback_with_table_arg_t wFunc = _Widgets_tab[num]->getFunc();
-                    
-            for (uint8_t num = 0; num < 5; num++)
+            if (strcmp(_setData.substring(tNum, tNum + 1).c_str(), "1") == 0)
             {
-                // BLINKER_LOG_ALL(BLINKER_F("num: "), _setData.substring(num, num + 1));
-
-                if (strcmp(_setData.substring(num, num + 1).c_str(), "1") == 0)
-                {
-                    if (wFunc) {
-                        switch (num)
-                        {
-                            case 0:
-                                wFunc(BLINKER_CMD_TAB_0);
-                                break;
-                            case 1:
-                                wFunc(BLINKER_CMD_TAB_1);
-                                break;
-                            case 2:
-                                wFunc(BLINKER_CMD_TAB_2);
-                                break;
-                            case 3:
-                                wFunc(BLINKER_CMD_TAB_3);
-                                break;
-                            case 4:
-                                wFunc(BLINKER_CMD_TAB_4);
-                                break;
-                            default:
-                                break;
-                        }
+                if (wFunc) {
+                    switch (tNum)
+                    {
+                        case 0:
+                            wFunc(BLINKER_CMD_TAB_0);
+                            break;
+                        case 1:
+                            wFunc(BLINKER_CMD_TAB_1);
+                            break;
+                        case 2:
+                            wFunc(BLINKER_CMD_TAB_2);
+                            break;
+                        case 3:
+                            wFunc(BLINKER_CMD_TAB_3);
+                            break;
+                        case 4:
+                            wFunc(BLINKER_CMD_TAB_4);
+                            break;
+                        default:
+                            break;
                     }
                 }
             }
-            
+        }
 
-            // if (_setData == "10000") _number = BLINKER_CMD_TAB_0;
-            // else if (_setData == "01000") _number = BLINKER_CMD_TAB_1;
-            // else if (_setData == "00100") _number = BLINKER_CMD_TAB_2;
-            // else if (_setData == "00010") _number = BLINKER_CMD_TAB_3;
-            // else if (_setData == "00001") _number = BLINKER_CMD_TAB_4;
-            BLINKER_LOG_ALL(BLINKER_F("tabWidgetsParse isParsed"));
-            _fresh = true;
+        // if (_setData == "10000") _number = BLINKER_CMD_TAB_0;
+        // else if (_setData == "01000") _number = BLINKER_CMD_TAB_1;
+        // else if (_setData == "00100") _number = BLINKER_CMD_TAB_2;
+        // else if (_setData == "00010") _number = BLINKER_CMD_TAB_3;
+        // else if (_setData == "00001") _number = BLINKER_CMD_TAB_4;
+        BLINKER_LOG_ALL(BLINKER_F("tabWidgetsParse isParsed"));
+        _fresh = true;
 
-            blinker_callback_t wFunc2 = _Widgets_tab[num]->getFunc2();
-            if (wFunc2) {
-                wFunc2();
-            }
+        blinker_callback_t wFunc2 = _Widgets_tab[num]->getFunc2();
+        if (wFunc2) {
+            wFunc2();
         }
     }
 
@@ -8857,23 +8915,48 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
     {
         setSwitch(data);
 
-        for (uint8_t wNum = 0; wNum < _wCount_str; wNum++) {
-            strWidgetsParse(_Widgets_str[wNum]->getName(), data);
-        }
-        for (uint8_t wNum_int = 0; wNum_int < _wCount_int; wNum_int++) {
-            intWidgetsParse(_Widgets_int[wNum_int]->getName(), data);
-        }
-        for (uint8_t wNum_rgb = 0; wNum_rgb < _wCount_rgb; wNum_rgb++) {
-            rgbWidgetsParse(_Widgets_rgb[wNum_rgb]->getName(), data);
-        }
-        // #if defined(BLINKER_BLE)
-            for (uint8_t wNum_joy = 0; wNum_joy < _wCount_joy; wNum_joy++) {
-                joyWidgetsParse(_Widgets_joy[wNum_joy]->getName(), data);
+        #if BLINKER_WIDGET_TABLE_SIZE > 0
+            // A message holds a key or two: look them up instead of
+            // searching the message for every widget
+            for (JsonPair kv : data)
+            {
+                uint8_t type;
+                int8_t num = widgetNum(kv.key().c_str(), &type);
+
+                switch (type)
+                {
+                    case BLINKER_WIDGET_STR: strWidgetsParse(num, kv.value()); break;
+                    case BLINKER_WIDGET_INT: intWidgetsParse(num, kv.value()); break;
+                    case BLINKER_WIDGET_RGB: rgbWidgetsParse(num, kv.value()); break;
+                    case BLINKER_WIDGET_JOY: joyWidgetsParse(num, kv.value()); break;
+                    case BLINKER_WIDGET_TAB: tabWidgetsParse(num, kv.value()); break;
+                    default: break;
+                }
             }
-        // #endif
-        for (uint8_t wNum_tab = 0; wNum_tab < _wCount_tab; wNum_tab++) {
-            tabWidgetsParse(_Widgets_tab[wNum_tab]->getName(), data);
-        }
+        #else
+            for (uint8_t wNum = 0; wNum < _wCount_str; wNum++) {
+                if (data.containsKey(_Widgets_str[wNum]->getName()))
+                    strWidgetsParse(wNum, data[_Widgets_str[wNum]->getName()]);
+            }
+            for (uint8_t wNum_int = 0; wNum_int < _wCount_int; wNum_int++) {
+                if (data.containsKey(_Widgets_int[wNum_int]->getName()))
+                    intWidgetsParse(wNum_int, data[_Widgets_int[wNum_int]->getName()]);
+            }
+            for (uint8_t wNum_rgb = 0; wNum_rgb < _wCount_rgb; wNum_rgb++) {
+                if (data.containsKey(_Widgets_rgb[wNum_rgb]->getName()))
+                    rgbWidgetsParse(wNum_rgb, data[_Widgets_rgb[wNum_rgb]->getName()]);
+            }
+            // #if defined(BLINKER_BLE)
+                for (uint8_t wNum_joy = 0; wNum_joy < _wCount_joy; wNum_joy++) {
+                    if (data.containsKey(_Widgets_joy[wNum_joy]->getName()))
+                        joyWidgetsParse(wNum_joy, data[_Widgets_joy[wNum_joy]->getName()]);
+                }
+            // #endif
+            for (uint8_t wNum_tab = 0; wNum_tab < _wCount_tab; wNum_tab++) {
+                if (data.containsKey(_Widgets_tab[wNum_tab]->getName()))
+                    tabWidgetsParse(wNum_tab, data[_Widgets_tab[wNum_tab]->getName()]);
+            }
+        #endif
     }
 
 #else
@@ -9037,6 +9120,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             BLINKER_LOG_ALL(BLINKER_F("strWidgetsParse isParsed"));
             _fresh = true;
 
+            _Widgets_str[num]->called();
             blinker_callback_with_string_arg_t nbFunc = _Widgets_str[num]->getFunc();
             if (nbFunc) nbFunc(state);
         }
@@ -9059,6 +9143,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
                 BLINKER_LOG_ALL(BLINKER_F("joyWidgetsParse isParsed"));
                 _fresh = true;
 
+                _Widgets_joy[num]->called();
                 blinker_callback_with_joy_arg_t wFunc = _Widgets_joy[num]->getFunc();
 
                 if (wFunc) wFunc(jxAxisValue, jyAxisValue);
@@ -9083,6 +9168,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             BLINKER_LOG_ALL(BLINKER_F("rgbWidgetsParse isParsed"));
             _fresh = true;
 
+            _Widgets_rgb[num]->called();
             blinker_callback_with_rgb_arg_t wFunc = _Widgets_rgb[num]->getFunc();
 
             if (wFunc) wFunc(_rValue, _gValue, _bValue, _brightValue);
@@ -9102,6 +9188,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             BLINKER_LOG_ALL(BLINKER_F("intWidgetsParse isParsed"));
             _fresh = true;
 
+            _Widgets_int[num]->called();
             blinker_callback_with_int32_arg_t wFunc = _Widgets_int[num]->getFunc();
 
             if (wFunc) wFunc(_number);
@@ -9135,6 +9222,7 @@ char * BlinkerApi::widgetName_tab(uint8_t num)
             //     wFunc(_number);
             // }
 
+            _Widgets_tab[num]->called();
             blinker_callback_with_table_arg_t wFunc = _Widgets_tab[num]->getFunc();
                     
             for (uint8_t num = 0; num < 5; num++)
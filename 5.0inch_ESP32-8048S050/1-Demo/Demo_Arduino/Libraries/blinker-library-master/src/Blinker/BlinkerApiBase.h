@@ -4,6 +4,8 @@
 #include "BlinkerDebug.h"
 #include "BlinkerConfig.h"
 #include "BlinkerUtility.h"
+#include "BlinkerDataRing.h"
+#include "BlinkerWidgetTable.h"
 
 template <class T>
 int8_t checkNum(char * name, T * c, uint8_t count)
@@ -63,9 +65,12 @@ class BlinkerWidgets_string
         bool checkName(char * name) {
             return strcmp(name, wName) == 0;
         }
+        void called() { wCalls++; }
+        uint32_t calls() { return wCalls; }
 
     private :
         char *wName;
+        uint32_t wCalls = 0;
         blinker_callback_with_string_arg_t wfunc;
 };
 
@@ -86,9 +91,12 @@ class BlinkerWidgets_int32
         bool checkName(char * name) {
             return strcmp(name, wName) == 0;
         }
+        void called() { wCalls++; }
+        uint32_t calls() { return wCalls; }
 
     private :
         char *wName;
+        uint32_t wCalls = 0;
         blinker_callback_with_int32_arg_t wfunc;
 };
 
@@ -109,9 +117,12 @@ class BlinkerWidgets_rgb
         bool checkName(char * name) {
             return strcmp(name, wName) == 0;
         }
+        void called() { wCalls++; }
+        uint32_t calls() { return wCalls; }
 
     private :
         char *wName;
+        uint32_t wCalls = 0;
         blinker_callback_with_rgb_arg_t wfunc;
 };
 
@@ -132,9 +143,12 @@ class BlinkerWidgets_joy
         bool checkName(char * name) {
             return strcmp(name, wName) == 0;
         }
+        void called() { wCalls++; }
+        uint32_t calls() { return wCalls; }
 
     private :
         char *wName;
+        uint32_t wCalls = 0;
         blinker_callback_with_joy_arg_t wfunc;
 };
 
@@ -160,9 +174,12 @@ class BlinkerWidgets_table
         bool checkName(char * name) {
             return strcmp(name, wName) == 0;
         }
+        void called() { wCalls++; }
+        uint32_t calls() { return wCalls; }
 
     private :
         char *wName;
+        uint32_t wCalls = 0;
         blinker_callback_with_table_arg_t wfunc;
         blinker_callback_t                wfunc2;
 };
@@ -440,148 +457,58 @@ class BlinkerWidgets_table
     class BlinkerData
     {
         public :
-            BlinkerData()
-                // : _dname(NULL)
-            {
-                // data = (char*)malloc((256)*sizeof(char));
-                // memcpy(data,"\0",128);
-                for(uint8_t num = 0; num < BLINKER_MAX_DATA_COUNT; num++)
-                {
-                    time_data[num] = 0;
-                    memset(data[num], '\0', 10);
-                }
-            }
-
             void name(const String & name) { _dname = name; }
 
             String getName() { return _dname; }
 
             bool saveData(const String & _data, time_t now_time, uint32_t _limit) {
-                if (dataCount > 0)
+                if (ring.count() > 0)
                 {
                     if (now_time - latest_time < _limit) return false;
                 }
 
-                latest_time = now_time;
-
-                if (dataCount >= BLINKER_MAX_DATA_COUNT)
-                {
-                    dataCount = BLINKER_MAX_DATA_COUNT;
-
-                    for (uint8_t num = 0; num < dataCount - 1; num++) {
-                        time_data[num] = time_data[num + 1];
-                        strcpy(data[num], data[num+1]);
-                    }
-                    time_data[dataCount - 1] = now_time;
-                    strcpy(data[dataCount - 1], _data.c_str());
-                }
-                else
-                {
-                    time_data[dataCount] = now_time;
-                    strcpy(data[dataCount], _data.c_str());
-                    dataCount++;
-                }
-
-                // String _data_;
+                int64_t value;
+                if (!toFixed(_data.c_str(), &value)) return false;
+                if (!ring.begin(BLINKER_MAX_DATA_BYTES)) return false;
 
-                // if (strlen(data)) _data_ = STRING_format(data);
-
-                // if (dataCount == 6) {
-                //     _data_ += BLINKER_F(",[");
-                //     _data_ += STRING_format(now_time);
-                //     _data_ += BLINKER_F(",");
-                //     _data_ += _data;
-                //     _data_ += BLINKER_F("]");
-
-                //     _data_ = "{\"data\":[" + STRING_format(_data_);
-                //     _data_ += BLINKER_F("]}");
-
-                //     DynamicJsonBuffer jsonDataBuffer;
-                //     JsonObject& dataArray = jsonDataBuffer.parseObject(_data_);
-
-                //     for (uint8_t num = 0; num < dataCount; num++) {
-                //         dataArray["data"][num][0] = dataArray["data"][num+1][0];
-                //         dataArray["data"][num][1] = dataArray["data"][num+1][1];
-                //     }
-                    
-                //     _data_ = BLINKER_F("");
-                //     for (uint8_t num = 0; num < dataCount; num++)
-                //     {
-                //         String data_get = dataArray["data"][num];
-
-                //         _data_ += data_get;
-
-                //         if (num != dataCount - 1) _data_ += BLINKER_F(",");
-                //     }
+                latest_time = now_time;
+                ring.push(now_time, value);
 
-                //     if (_data_.length() < 128)
-                //     {
-                //         strcpy(data, _data_.c_str());
-                //     }
-                // }
-                // else
-                // {
-                //     if (_data_.length())
-                //     {
-                //         _data_ += BLINKER_F(",");
-                //     }
-
-                //     _data_ += BLINKER_F("[");
-                //     _data_ += STRING_format(now_time);
-                //     _data_ += BLINKER_F(",");
-                //     _data_ += _data;
-                //     _data_ += BLINKER_F("]");
-
-                //     if (_data_.length() < 128) {
-                //         strcpy(data, _data_.c_str());
-                //         dataCount++;
-                //     }
-                // }
                 BLINKER_LOG_ALL(BLINKER_F("saveData: "), _data);
-                BLINKER_LOG_ALL(BLINKER_F("saveData dataCount: "), dataCount);
+                BLINKER_LOG_ALL(BLINKER_F("saveData dataCount: "), ring.count(), \
+                                BLINKER_F(" bytes: "), ring.bytes());
 
                 return true;
             }
 
-            String getData() {
-                // BLINKER_LOG_ALL(BLINKER_F("getData data: "), data);
-                
-                String _data_ = BLINKER_F("[");//{\"data\":
-                // _data_ += STRING_format(data);
-                for (uint8_t num = 0; num < dataCount; num++) {
-                    _data_ += "[";
-                    _data_ += String(time_data[num]);
-                    _data_ += ",";
-                    _data_ += data[num];
-                    _data_ += "]";
-                    if (num + 1 < dataCount)
-                    {
-                        _data_ += ",";
-                    }
-
-                    // time_data[num] = latest_time;
-                    // memcpy(data[num], "\0", 10);
-                }
-                _data_ += BLINKER_F("]");//}
-
-                // dataCount = 0;
-
-                // DynamicJsonBuffer jsonDataBuffer;
-                // JsonObject& dataArray = jsonDataBuffer.parseObject(_data_);
+            // Longest text of getData()
+            size_t dataLength() { return 2 + ring.count() * (10 + 22 + 4); }
 
-                // uint32_t now_millis = millis();
+            // [[time,value],...] appended to the upload
+            void getData(String & _data_) {
+                char sample[40];
+                BlinkerDataRing::cursor_t c;
+                uint32_t _time;
+                int64_t value;
 
-                // for (uint8_t num = dataCount; num > 0; num--) {
-                //     uint8_t data_time = dataArray["data"][num][0];
-                //     uint32_t real_time = now_time - (dataCount - data_time - 1)*60;
-                //     dataArray["data"][num-1][0] = real_time;
-                    
-                //     BLINKER_LOG_ALL(BLINKER_F("data_time: "), data_time, 
-                //                     BLINKER_F(" now_time: "), now_time, 
-                //                     BLINKER_F(" real_time: "), real_time);
-                // }
+                _data_ += BLINKER_F("[");
+                ring.first(&c);
+                while (ring.next(&c, &_time, &value))
+                {
+                    char * p = sample;
+                    if (c.left + 1 < ring.count()) *p++ = ',';
+                    p += sprintf(p, "[%lu,", (unsigned long)_time);
+                    p = printFixed(p, value);
+                    *p++ = ']';
+                    *p = '\0';
+                    _data_ += sample;
+                }
+                _data_ += BLINKER_F("]");
+            }
 
-                // String _data_decode = dataArray["data"];
+            String getData() {
+                String _data_;
+                getData(_data_);
 
                 BLINKER_LOG_ALL(BLINKER_F("getData _data_: "), _data_);
 
@@ -590,23 +517,66 @@ class BlinkerWidgets_table
 
             bool checkName(const String & name) { return ((_dname == name) ? true : false); }
 
-            void flush()
+            void flush() { ring.clear(); }
+
+        private :
+            time_t  latest_time = 0;
+            String _dname;
+            BlinkerDataRing ring;
+
+            // Decimal text to a value with BLINKER_DATA_DECIMALS fixed decimals
+            static bool toFixed(const char * text, int64_t * value)
             {
-                for (uint8_t num = 0; num < dataCount; num++) {
-                    time_data[num] = latest_time;
-                    memset(data[num], '\0', 10);
+                bool neg = (*text == '-');
+                if (neg || *text == '+') text++;
+
+                int64_t v = 0;
+                uint8_t digits = 0;
+                int8_t decimals = -1;
+                for (; *text; text++)
+                {
+                    if (*text == '.' && decimals < 0) { decimals = 0; continue; }
+                    if (*text < '0' || *text > '9') return false;
+                    if (decimals == BLINKER_DATA_DECIMALS) continue;
+                    if (++digits > 18) return false;
+                    v = v * 10 + (*text - '0');
+                    if (decimals >= 0) decimals++;
                 }
+                if (digits == 0) return false;
 
-                dataCount = 0;
+                for (int8_t d = decimals < 0 ? 0 : decimals; d < BLINKER_DATA_DECIMALS; d++) v *= 10;
+                *value = neg ? -v : v;
+                return true;
             }
 
-        private :
-            uint8_t dataCount = 0;
-            time_t  latest_time = 0;
-            String _dname;
-            // char * data;
-            time_t  time_data[BLINKER_MAX_DATA_COUNT];
-            char    data[BLINKER_MAX_DATA_COUNT][10];
+            static char * printFixed(char * p, int64_t value)
+            {
+                if (value < 0)
+                {
+                    *p++ = '-';
+                    value = -value;
+                }
+
+                char digits[24];
+                uint8_t n = 0;
+                do
+                {
+                    digits[n++] = '0' + value % 10;
+                    value /= 10;
+                } while (value || n <= BLINKER_DATA_DECIMALS);
+
+                // no trailing zeros of the fraction
+                uint8_t last = 0;
+                while (last < BLINKER_DATA_DECIMALS && digits[last] == '0') last++;
+
+                while (n > BLINKER_DATA_DECIMALS) *p++ = digits[--n];
+                if (last < BLINKER_DATA_DECIMALS)
+                {
+                    *p++ = '.';
+                    while (n > last) *p++ = digits[--n];
+                }
+                return p;
+            }
     };
 
     class BlinkerRTData
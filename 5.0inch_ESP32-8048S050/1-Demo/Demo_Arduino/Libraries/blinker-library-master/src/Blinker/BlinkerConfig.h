@@ -29,6 +29,21 @@
 
 #define BLINKER_MQTT_KEEPALIVE          30000UL
 
+// Publish queue of the MQTT adapter [bytes]: messages are sent by a task,
+// several to a write. 0 publishes from the loop.
+#ifndef BLINKER_MQTT_QUEUE_SIZE
+    #if defined(ESP32)
+        #define BLINKER_MQTT_QUEUE_SIZE     4096
+    #else
+        #define BLINKER_MQTT_QUEUE_SIZE     0
+    #endif
+#endif
+
+// QoS 1 messages of the queue waiting for their PUBACK at a time
+#ifndef BLINKER_MQTT_INFLIGHT
+    #define BLINKER_MQTT_INFLIGHT           4
+#endif
+
 #define BLINKER_SMS_MSG_LIMIT           60000UL
 
 #define BLINKER_PUSH_MSG_LIMIT          60000UL
@@ -53,10 +68,12 @@
 
 #define BLINKER_SERVER_CONNECT_LIMIT    3
 
-#if defined(BLINKER_DATA_HOUR_UPDATE)
-    #define BLINKER_DATA_FREQ_TIME          3600UL
-#else
-    #define BLINKER_DATA_FREQ_TIME          60
+#ifndef BLINKER_DATA_FREQ_TIME
+    #if defined(BLINKER_DATA_HOUR_UPDATE)
+        #define BLINKER_DATA_FREQ_TIME          3600UL
+    #else
+        #define BLINKER_DATA_FREQ_TIME          60
+    #endif
 #endif
 
 #define BLINKER_DEVICE_HEARTBEAT_TIME   600
@@ -100,6 +117,21 @@
     #define BLINKER_MAX_WIDGET_SIZE         6
 #endif
 
+// Slots of the hash table of the widget keys: a power of 2, at least twice
+// the number of widgets (7 * BLINKER_MAX_WIDGET_SIZE). 0 compares a received
+// message with every widget name.
+#ifndef BLINKER_WIDGET_TABLE_SIZE
+    #if defined(ESP8266) || defined(ESP32)
+        #if BLINKER_MAX_WIDGET_SIZE > 8
+            #define BLINKER_WIDGET_TABLE_SIZE   256
+        #else
+            #define BLINKER_WIDGET_TABLE_SIZE   128
+        #endif
+    #else
+        #define BLINKER_WIDGET_TABLE_SIZE       0
+    #endif
+#endif
+
 #define BLINKER_OBJECT_NOT_AVAIL        -1
 
 #ifndef BLINKER_MAX_READ_SIZE
@@ -114,6 +146,16 @@
     #endif
 #endif
 
+// Document reused by BlinkerApi::parse() for every received message,
+// 0 allocates one per message
+#ifndef BLINKER_PARSE_DOC_SIZE
+    #if defined(ESP8266) || defined(ESP32)
+        #define BLINKER_PARSE_DOC_SIZE      1024
+    #else
+        #define BLINKER_PARSE_DOC_SIZE      0
+    #endif
+#endif
+
 #ifndef BLINKER_MAX_SEND_SIZE
     #if defined(ESP8266) || defined(ESP32)
         #if defined(BLINKER_MQTT) || defined(BLINKER_AT_MQTT) || \
@@ -644,7 +686,31 @@
 
 #define BLINKER_MAX_RTDATA_SIZE         4
 
-#define BLINKER_MAX_DATA_COUNT          4
+#ifndef BLINKER_MAX_DATA_COUNT
+    #define BLINKER_MAX_DATA_COUNT          4
+#endif
+
+// Ring of the samples of one dataStorage() series, 2-3 bytes a sample:
+// the PSRAM one holds an hour of 1 Hz samples
+#ifndef BLINKER_MAX_DATA_BYTES
+    #if defined(ESP32) && defined(BOARD_HAS_PSRAM)
+        #define BLINKER_MAX_DATA_BYTES      12288
+    #elif defined(ESP8266) || defined(ESP32)
+        #define BLINKER_MAX_DATA_BYTES      256
+    #else
+        #define BLINKER_MAX_DATA_BYTES      64
+    #endif
+#endif
+
+// The rings go to the PSRAM if there is one
+#if defined(ESP32) && defined(BOARD_HAS_PSRAM) && !defined(BLINKER_DATA_MALLOC)
+    #define BLINKER_DATA_MALLOC             ps_malloc
+#endif
+
+// Fixed decimals of the stored values
+#ifndef BLINKER_DATA_DECIMALS
+    #define BLINKER_DATA_DECIMALS           2
+#endif
 
 #define BLINKER_DATA_UPDATE_COUNT       2
 
@@ -0,0 +1,167 @@
+#ifndef BLINKER_DATA_RING_H
+#define BLINKER_DATA_RING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef BLINKER_DATA_MALLOC
+    #define BLINKER_DATA_MALLOC     malloc
+#endif
+
+// Samples of one data series in a byte ring: the time [s] and a fixed point
+// value of each sample as varint deltas to the sample before, the oldest
+// sample is kept whole. A sample a minute of a slowly changing value takes
+// 2-3 bytes. When the ring is full the oldest samples are dropped.
+class BlinkerDataRing
+{
+    public :
+        struct cursor_t
+        {
+            uint16_t pos;
+            uint16_t left;
+            uint32_t time;
+            int64_t  value;
+        };
+
+        BlinkerDataRing() {}
+        ~BlinkerDataRing() { free(buf); }
+
+        // Allocates the ring on the first call
+        bool begin(uint16_t _size)
+        {
+            if (buf) return true;
+            if (_size < 2 * BLINKER_DATA_RECORD_MAX) return false;
+
+            buf = (uint8_t *)BLINKER_DATA_MALLOC(_size);
+            if (!buf) return false;
+
+            size = _size;
+            clear();
+            return true;
+        }
+
+        void push(uint32_t _time, int64_t _value)
+        {
+            if (!buf) return;
+
+            if (num == 0)
+            {
+                firstTime = lastTime = _time;
+                firstValue = lastValue = _value;
+                num = 1;
+                return;
+            }
+
+            uint8_t record[BLINKER_DATA_RECORD_MAX];
+            uint8_t len = putVarint(record, _time - lastTime);
+            len += putVarint(record + len, zigzag(_value - lastValue));
+
+            while (size - used < len) dropOldest();
+
+            uint16_t pos = (head + used) % size;
+            for (uint8_t i = 0; i < len; i++)
+            {
+                buf[pos] = record[i];
+                if (++pos == size) pos = 0;
+            }
+            used += len;
+
+            lastTime = _time;
+            lastValue = _value;
+            num++;
+        }
+
+        void clear()
+        {
+            head = 0;
+            used = 0;
+            num = 0;
+        }
+
+        uint16_t count() const { return num; }
+
+        // Bytes of the samples, the oldest one counted as 12
+        uint16_t bytes() const { return num ? used + 12 : 0; }
+
+        // Samples from the oldest one on
+        void first(cursor_t * c) const
+        {
+            c->pos = head;
+            c->left = num;
+            c->time = firstTime;
+            c->value = firstValue;
+        }
+
+        bool next(cursor_t * c, uint32_t * _time, int64_t * _value) const
+        {
+            if (!c->left) return false;
+
+            if (c->left != num)
+            {
+                c->time += getVarint(&c->pos);
+                c->value += unzigzag(getVarint(&c->pos));
+            }
+            c->left--;
+
+            *_time = c->time;
+            *_value = c->value;
+            return true;
+        }
+
+    private :
+        enum { BLINKER_DATA_RECORD_MAX = 15 };   // 5 bytes of time, 10 of value
+
+        uint8_t *   buf = NULL;
+        uint16_t    size = 0;
+        uint16_t    head = 0;   // record of the second sample
+        uint16_t    used = 0;
+        uint16_t    num = 0;
+        uint32_t    firstTime = 0;
+        int64_t     firstValue = 0;
+        uint32_t    lastTime = 0;
+        int64_t     lastValue = 0;
+
+        static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+        static int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+        static uint8_t putVarint(uint8_t * out, uint64_t v)
+        {
+            uint8_t len = 0;
+            while (v >= 0x80)
+            {
+                out[len++] = (uint8_t)v | 0x80;
+                v >>= 7;
+            }
+            out[len++] = (uint8_t)v;
+            return len;
+        }
+
+        uint64_t getVarint(uint16_t * pos) const
+        {
+            uint64_t v = 0;
+            uint8_t shift = 0;
+            uint8_t b;
+            do
+            {
+                b = buf[*pos];
+                if (++*pos == size) *pos = 0;
+                v |= (uint64_t)(b & 0x7F) << shift;
+                shift += 7;
+            } while (b & 0x80);
+            return v;
+        }
+
+        // The second sample becomes the oldest one
+        void dropOldest()
+        {
+            uint16_t pos = head;
+            firstTime += getVarint(&pos);
+            firstValue += unzigzag(getVarint(&pos));
+            used -= (pos + size - head) % size;
+            head = pos;
+            num--;
+        }
+};
+
+#endif
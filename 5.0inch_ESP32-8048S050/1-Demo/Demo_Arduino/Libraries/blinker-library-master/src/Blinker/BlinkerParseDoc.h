@@ -0,0 +1,104 @@
+#ifndef BLINKER_PARSE_DOC_H
+#define BLINKER_PARSE_DOC_H
+
+#include <string.h>
+
+// Needs ArduinoJson, String, BLINKER_F() and the settings of
+// BlinkerConfig.h to be included before.
+
+#if defined(BLINKER_ARDUINOJSON)
+    #if BLINKER_PARSE_DOC_SIZE > 0
+        struct BlinkerParseArena
+        {
+            StaticJsonDocument<BLINKER_PARSE_DOC_SIZE> doc;
+            char    buf[BLINKER_MAX_READ_SIZE + 10];
+            bool    busy = false;
+        };
+    #else
+        struct BlinkerParseArena;
+    #endif
+
+    // Document of one received message. The arena's document is reused and
+    // the message is copied to its buffer and parsed in place there: the
+    // strings point into the copy, nothing is allocated. The receive buffer
+    // itself is left as it is, the timer commands still search it.
+    // A nested parse (Blinker.delay() in a callback) or a too long message
+    // gets a document on the heap like before.
+    class BlinkerParseDoc
+    {
+        public :
+            BlinkerParseDoc(BlinkerParseArena * arena)
+                : _arena(NULL), _doc(NULL), _heap(NULL)
+            {
+                #if BLINKER_PARSE_DOC_SIZE > 0
+                    if (arena && !arena->busy)
+                    {
+                        arena->busy = true;
+                        _arena = arena;
+                    }
+                #endif
+            }
+
+            ~BlinkerParseDoc()
+            {
+                release();
+                if (_heap) delete _heap;
+            }
+
+            // wrap: parse {"data":<data>}
+            DeserializationError parse(const char * data, bool wrap = false)
+            {
+                size_t len = strlen(data);
+
+                #if BLINKER_PARSE_DOC_SIZE > 0
+                    if (_arena && len + 10 <= sizeof(_arena->buf))
+                    {
+                        char * buf = _arena->buf;
+                        if (wrap)
+                        {
+                            memcpy(buf, "{\"data\":", 8);
+                            memcpy(buf + 8, data, len);
+                            buf[len + 8] = '}';
+                            buf[len + 9] = '\0';
+                        }
+                        else
+                        {
+                            memcpy(buf, data, len + 1);
+                        }
+                        _doc = &_arena->doc;
+                        return deserializeJson(*_doc, buf);
+                    }
+                #endif
+
+                release();
+                if (!_heap) _heap = new DynamicJsonDocument(1024);
+                _doc = _heap;
+
+                if (wrap)
+                {
+                    String arrayData = BLINKER_F("{\"data\":");
+                    arrayData += data;
+                    arrayData += BLINKER_F("}");
+                    return deserializeJson(*_doc, arrayData);
+                }
+                return deserializeJson(*_doc, data);
+            }
+
+            JsonObject root() { return _doc->as<JsonObject>(); }
+
+        private :
+            BlinkerParseArena *     _arena;
+            JsonDocument *          _doc;
+            DynamicJsonDocument *   _heap;
+
+            void release()
+            {
+                #if BLINKER_PARSE_DOC_SIZE > 0
+                    if (_arena) _arena->busy = false;
+                    _arena = NULL;
+                #endif
+            }
+    };
+#endif
+
+#endif
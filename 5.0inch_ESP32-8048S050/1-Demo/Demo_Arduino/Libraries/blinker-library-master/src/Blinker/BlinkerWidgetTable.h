@@ -0,0 +1,75 @@
+#ifndef BLINKER_WIDGET_TABLE_H
+#define BLINKER_WIDGET_TABLE_H
+
+#include <stdint.h>
+
+// Needs BLINKER_WIDGET_TABLE_SIZE of BlinkerConfig.h to be defined before.
+
+enum b_widget_type_t {
+    BLINKER_WIDGET_NONE,
+    BLINKER_WIDGET_STR,
+    BLINKER_WIDGET_INT,
+    BLINKER_WIDGET_RGB,
+    BLINKER_WIDGET_JOY,
+    BLINKER_WIDGET_TAB
+};
+
+#if BLINKER_WIDGET_TABLE_SIZE > 0
+// Keys of the attached widgets of all types, so a received key finds its
+// widget with one hash and (nearly always) one strcmp instead of a strcmp
+// with every name. Widgets are attached one by one from setup(), so this is
+// an open addressing table kept at most half full, not a perfect hash.
+// A slot holds the type and index of the widget and 8 bits of the hash.
+class BlinkerWidgetTable
+{
+    public :
+        // FNV-1a
+        static uint32_t hash(const char * name)
+        {
+            uint32_t h = 2166136261UL;
+            while (*name) h = (h ^ (uint8_t)*name++) * 16777619UL;
+            return h;
+        }
+
+        void add(const char * name, uint8_t type, uint8_t num)
+        {
+            uint32_t h = hash(name);
+            uint16_t pos = h & (BLINKER_WIDGET_TABLE_SIZE - 1);
+            while (slots[pos].type != BLINKER_WIDGET_NONE)
+                pos = (pos + 1) & (BLINKER_WIDGET_TABLE_SIZE - 1);
+
+            slots[pos].type = type;
+            slots[pos].num = num;
+            slots[pos].tag = h >> 24;
+        }
+
+        // Widgets of the key's hash, from *pos on: false at the end
+        bool next(uint32_t h, uint16_t * pos, uint8_t * type, uint8_t * num)
+        {
+            while (slots[*pos].type != BLINKER_WIDGET_NONE)
+            {
+                uint16_t cur = *pos;
+                *pos = (*pos + 1) & (BLINKER_WIDGET_TABLE_SIZE - 1);
+                if (slots[cur].tag == (uint8_t)(h >> 24))
+                {
+                    *type = slots[cur].type;
+                    *num = slots[cur].num;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static uint16_t first(uint32_t h) { return h & (BLINKER_WIDGET_TABLE_SIZE - 1); }
+
+    private :
+        struct slot_t {
+            uint8_t type;
+            uint8_t num;
+            uint8_t tag;
+        };
+        slot_t slots[BLINKER_WIDGET_TABLE_SIZE] = {};
+};
+#endif
+
+#endif
@@ -164,6 +164,41 @@ uint8_t WebSockets::createHeader(uint8_t * headerPtr, WSopcode_t opcode, size_t
     return headerSize;
 }
 
+/**
+ * XOR the payload with the mask key (masks and unmasks), a word at a time
+ * @param data uint8_t *        ptr to the payload
+ * @param length size_t         length of the payload
+ * @param maskKey uint8_t[4]    key of the frame
+ * @param offset size_t         position of data in the frame payload
+ */
+void WebSockets::maskPayload(uint8_t * data, size_t length, const uint8_t * maskKey, size_t offset) {
+    typedef uint32_t __attribute__((__may_alias__)) word_t;
+    size_t i = 0;
+
+    // bytes up to the first aligned word
+    while(i < length && ((uintptr_t)(data + i) & 3)) {
+        data[i] ^= maskKey[(offset + i) & 3];
+        i++;
+    }
+
+    // key rotated to the position of the aligned words
+    uint8_t key[4];
+    for(uint8_t x = 0; x < 4; x++) {
+        key[x] = maskKey[(offset + i + x) & 3];
+    }
+    word_t keyWord;
+    memcpy(&keyWord, key, 4);
+
+    word_t * word = (word_t *)(data + i);
+    for(; i + 4 <= length; i += 4) {
+        *word++ ^= keyWord;
+    }
+
+    for(; i < length; i++) {
+        data[i] ^= maskKey[(offset + i) & 3];
+    }
+}
+
 /**
  *
  * @param client WSclient_t *   ptr to the client struct
@@ -277,9 +312,7 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
             dataMaskPtr = payloadPtr;
         }
 
-        for(size_t x = 0; x < length; x++) {
-            dataMaskPtr[x] = (dataMaskPtr[x] ^ maskKey[x % 4]);
-        }
+        maskPayload(dataMaskPtr, length, maskKey);
     }
 
 #ifndef NODEBUG_WEBSOCKETS
@@ -433,7 +466,13 @@ void WebSockets::handleWebsocketCb(WSclient_t * client) {
     DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] fin: %u rsv1: %u rsv2: %u rsv3 %u  opCode: %u\n", client->num, header->fin, header->rsv1, header->rsv2, header->rsv3, header->opCode);
     DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] mask: %u payloadLen: %u\n", client->num, header->mask, header->payloadLen);
 
-    if(header->payloadLen > WEBSOCKETS_MAX_DATA_SIZE) {
+    // streamed frames are not held in one buffer, no limit for them
+    bool stream = false;
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    stream = _rxChunkSize && header->payloadLen > _rxChunkSize && header->opCode < WSop_close;
+#endif
+
+    if(header->payloadLen > WEBSOCKETS_MAX_DATA_SIZE && !stream) {
         DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] payload too big! (%u)\n", client->num, header->payloadLen);
         clientDisconnect(client, 1009);
         return;
@@ -449,6 +488,23 @@ void WebSockets::handleWebsocketCb(WSclient_t * client) {
     }
 
     if(header->payloadLen > 0) {
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+        // large data frames go to the callback piece by piece
+        if(stream) {
+            handleWebsocketStream(client);
+            return;
+        }
+
+#if(WEBSOCKETS_RX_STACK_SIZE > 0)
+        // readCb returns when the data is there, small frames can stay on the stack
+        if(header->payloadLen < WEBSOCKETS_RX_STACK_SIZE) {
+            uint8_t stackPayload[WEBSOCKETS_RX_STACK_SIZE];
+            readCb(client, stackPayload, header->payloadLen, std::bind(&WebSockets::handleWebsocketPayload, this, std::placeholders::_1, std::placeholders::_2, stackPayload));
+            return;
+        }
+#endif
+#endif
+
         // if text data we need one more
         payload = (uint8_t *)malloc(header->payloadLen + 1);
 
@@ -464,6 +520,19 @@ void WebSockets::handleWebsocketCb(WSclient_t * client) {
 }
 
 void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t * payload) {
+    handleWebsocketPayload(client, ok, payload);
+    if(payload) {
+        free(payload);
+    }
+}
+
+/**
+ * handle a received frame, the payload stays owned by the caller
+ * @param client WSclient_t *  ptr to the client struct
+ * @param ok bool              the payload was read
+ * @param payload uint8_t *    payload, payloadLen + 1 bytes
+ */
+void WebSockets::handleWebsocketPayload(WSclient_t * client, bool ok, uint8_t * payload) {
     WSMessageHeader_t * header = &client->cWsHeaderDecode;
     if(ok) {
         if(header->payloadLen > 0) {
@@ -471,9 +540,7 @@ void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t
 
             if(header->mask) {
                 //decode XOR
-                for(size_t i = 0; i < header->payloadLen; i++) {
-                    payload[i] = (payload[i] ^ header->maskKey[i % 4]);
-                }
+                maskPayload(payload, header->payloadLen, header->maskKey);
             }
         }
 
@@ -517,10 +584,6 @@ void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t
                 break;
         }
 
-        if(payload) {
-            free(payload);
-        }
-
         // reset input
         client->cWsRXsize = 0;
 #if(WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
@@ -530,11 +593,63 @@ void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t
 
     } else {
         DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] missing data!\n", client->num);
-        free(payload);
         clientDisconnect(client, 1002);
     }
 }
 
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+/**
+ * deliver a data frame in pieces of _rxChunkSize, each read into the same buffer
+ * the pieces arrive like the frames of a fragmented message
+ * @param client WSclient_t *  ptr to the client struct
+ */
+void WebSockets::handleWebsocketStream(WSclient_t * client) {
+    WSMessageHeader_t * header = &client->cWsHeaderDecode;
+    WSopcode_t opcode          = header->opCode;
+    size_t offset              = 0;
+
+    if(!_rxChunk) {
+        // if text data we need one more
+        _rxChunk = (uint8_t *)malloc(_rxChunkSize + 1);
+        if(!_rxChunk) {
+            DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] to less memory to handle payload %d!\n", client->num, _rxChunkSize);
+            clientDisconnect(client, 1011);
+            return;
+        }
+    }
+
+    while(offset < header->payloadLen) {
+        size_t len = header->payloadLen - offset;
+        if(len > _rxChunkSize) {
+            len = _rxChunkSize;
+        }
+
+        if(!readCb(client, _rxChunk, len, NULL)) {
+            DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] missing data!\n", client->num);
+            clientDisconnect(client, 1002);
+            return;
+        }
+
+        if(header->mask) {
+            maskPayload(_rxChunk, len, header->maskKey, offset);
+        }
+        _rxChunk[len] = 0x00;
+        offset += len;
+
+        messageReceived(client, opcode, _rxChunk, len, header->fin && offset == header->payloadLen);
+        opcode = WSop_continuation;
+
+        // the callback may have closed the connection
+        if(!client->tcp || client->status != WSC_CONNECTED) {
+            return;
+        }
+    }
+
+    // reset input
+    client->cWsRXsize = 0;
+}
+#endif
+
 /**
  * generate the key for Sec-WebSocket-Accept
  * @param clientKey String
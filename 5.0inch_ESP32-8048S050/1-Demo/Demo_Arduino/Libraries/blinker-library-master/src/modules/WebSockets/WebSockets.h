@@ -108,6 +108,15 @@
 // max size of the WS Message Header
 #define WEBSOCKETS_MAX_HEADER_SIZE (14)
 
+// frames up to this size are read into a buffer on the stack instead of the heap
+#ifndef WEBSOCKETS_RX_STACK_SIZE
+#if defined(ESP8266) || defined(ESP32)
+#define WEBSOCKETS_RX_STACK_SIZE (256)
+#else
+#define WEBSOCKETS_RX_STACK_SIZE (0)
+#endif
+#endif
+
 #if !defined(WEBSOCKETS_NETWORK_TYPE)
 // select Network type based
 #if defined(ESP8266) || defined(ESP31B)
@@ -351,6 +360,12 @@ class WebSockets {
     bool handleWebsocketWaitFor(WSclient_t * client, size_t size);
     void handleWebsocketCb(WSclient_t * client);
     void handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t * payload);
+    void handleWebsocketPayload(WSclient_t * client, bool ok, uint8_t * payload);
+#if(WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    void handleWebsocketStream(WSclient_t * client);
+#endif
+
+    static void maskPayload(uint8_t * data, size_t length, const uint8_t * maskKey, size_t offset = 0);
 
     String acceptKey(String & clientKey);
     String base64_encode(uint8_t * data, size_t length);
@@ -361,6 +376,9 @@ class WebSockets {
 
     void enableHeartbeat(WSclient_t * client, uint32_t pingInterval, uint32_t pongTimeout, uint8_t disconnectTimeoutCount);
     void handleHBTimeout(WSclient_t * client);
+
+    size_t _rxChunkSize = 0;       ///< data frames bigger than this are delivered in pieces, 0 = whole frames
+    uint8_t * _rxChunk  = NULL;    ///< buffer of the pieces
 };
 
 #ifndef UNUSED
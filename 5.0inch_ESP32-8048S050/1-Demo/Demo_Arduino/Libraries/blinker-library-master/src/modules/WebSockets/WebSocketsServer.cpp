@@ -64,6 +64,11 @@ WebSocketsServerCore::~WebSocketsServerCore() {
         delete[] _mandatoryHttpHeaders;
 
     _mandatoryHttpHeaderCount = 0;
+
+    if(_rxChunk) {
+        free(_rxChunk);
+        _rxChunk = NULL;
+    }
 }
 
 WebSocketsServer::~WebSocketsServer() {
@@ -185,22 +190,10 @@ bool WebSocketsServerCore::sendTXT(uint8_t num, String & payload) {
  * @return true if ok
  */
 bool WebSocketsServerCore::broadcastTXT(uint8_t * payload, size_t length, bool headerToPayload) {
-    WSclient_t * client;
-    bool ret = true;
     if(length == 0) {
         length = strlen((const char *)payload);
     }
-
-    for(uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
-        client = &_clients[i];
-        if(clientIsConnected(client)) {
-            if(!sendFrame(client, WSop_text, payload, length, true, headerToPayload)) {
-                ret = false;
-            }
-        }
-        WEBSOCKETS_YIELD();
-    }
-    return ret;
+    return broadcastFrame(WSop_text, payload, length, headerToPayload);
 }
 
 bool WebSocketsServerCore::broadcastTXT(const uint8_t * payload, size_t length) {
@@ -250,18 +243,7 @@ bool WebSocketsServerCore::sendBIN(uint8_t num, const uint8_t * payload, size_t
  * @return true if ok
  */
 bool WebSocketsServerCore::broadcastBIN(uint8_t * payload, size_t length, bool headerToPayload) {
-    WSclient_t * client;
-    bool ret = true;
-    for(uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
-        client = &_clients[i];
-        if(clientIsConnected(client)) {
-            if(!sendFrame(client, WSop_binary, payload, length, true, headerToPayload)) {
-                ret = false;
-            }
-        }
-        WEBSOCKETS_YIELD();
-    }
-    return ret;
+    return broadcastFrame(WSop_binary, payload, length, headerToPayload);
 }
 
 bool WebSocketsServerCore::broadcastBIN(const uint8_t * payload, size_t length) {
@@ -297,22 +279,86 @@ bool WebSocketsServerCore::sendPing(uint8_t num, String & payload) {
  * @return true if ping is send out
  */
 bool WebSocketsServerCore::broadcastPing(uint8_t * payload, size_t length) {
-    WSclient_t * client;
-    bool ret = true;
+    return broadcastFrame(WSop_ping, payload, length, false);
+}
+
+bool WebSocketsServerCore::broadcastPing(String & payload) {
+    return broadcastPing((uint8_t *)payload.c_str(), payload.length());
+}
+
+/**
+ * deliver data frames bigger than chunkSize to the callback in pieces of chunkSize
+ * instead of one buffer of the whole frame, like a fragmented message:
+ * WStype_FRAGMENT_TEXT_START / WStype_FRAGMENT_BIN_START, WStype_FRAGMENT ... WStype_FRAGMENT_FIN
+ * @param chunkSize size_t  0 = whole frames (default)
+ */
+void WebSocketsServerCore::setStreamChunkSize(size_t chunkSize) {
+    if(chunkSize != _rxChunkSize && _rxChunk) {
+        free(_rxChunk);
+        _rxChunk = NULL;
+    }
+    _rxChunkSize = chunkSize;
+}
+
+/**
+ * send one frame to all clients
+ * server frames are not masked, so the header is the same for every client and the
+ * frame is put together only once
+ * @param opcode WSopcode_t
+ * @param payload uint8_t *
+ * @param length size_t
+ * @param headerToPayload bool  (see sendFrame for more details)
+ * @return true if ok
+ */
+bool WebSocketsServerCore::broadcastFrame(WSopcode_t opcode, uint8_t * payload, size_t length, bool headerToPayload) {
+    uint8_t maskKey[4]                         = { 0x00, 0x00, 0x00, 0x00 };
+    uint8_t buffer[WEBSOCKETS_MAX_HEADER_SIZE] = { 0 };
+    uint8_t * frame                            = NULL;
+    bool useInternBuffer                       = false;
+    bool ret                                   = true;
+
+    uint8_t headerSize = createHeader(&buffer[0], opcode, length, false, maskKey, true);
+
+    if(headerToPayload) {
+        frame = payload + (WEBSOCKETS_MAX_HEADER_SIZE - headerSize);
+        memcpy(frame, &buffer[0], headerSize);
+    }
+#ifdef WEBSOCKETS_USE_BIG_MEM
+    // try to send data in one TCP package (only if some free Heap is there)
+    else if(((length > 0) && (length < 1400)) && (GET_FREE_HEAP > 6000)) {
+        frame = (uint8_t *)malloc(length + headerSize);
+        if(frame) {
+            memcpy(frame, &buffer[0], headerSize);
+            memcpy(frame + headerSize, payload, length);
+            useInternBuffer = true;
+        }
+    }
+#endif
+
     for(uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
-        client = &_clients[i];
-        if(clientIsConnected(client)) {
-            if(!sendFrame(client, WSop_ping, payload, length)) {
-                ret = false;
+        WSclient_t * client = &_clients[i];
+        if(clientIsConnected(client) && client->status == WSC_CONNECTED) {
+            if(frame) {
+                if(write(client, frame, length + headerSize) != length + headerSize) {
+                    ret = false;
+                }
+            } else {
+                if(write(client, &buffer[0], headerSize) != headerSize) {
+                    ret = false;
+                }
+                if(payload && length > 0 && write(client, payload, length) != length) {
+                    ret = false;
+                }
             }
         }
         WEBSOCKETS_YIELD();
     }
-    return ret;
-}
 
-bool WebSocketsServerCore::broadcastPing(String & payload) {
-    return broadcastPing((uint8_t *)payload.c_str(), payload.length());
+    if(useInternBuffer) {
+        free(frame);
+    }
+
+    return ret;
 }
 
 /**
@@ -92,6 +92,8 @@ class WebSocketsServerCore : protected WebSockets {
     void enableHeartbeat(uint32_t pingInterval, uint32_t pongTimeout, uint8_t disconnectTimeoutCount);
     void disableHeartbeat();
 
+    void setStreamChunkSize(size_t chunkSize);
+
 #if(WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266) || (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC) || (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP32)
     IPAddress remoteIP(uint8_t num);
 #endif
@@ -216,6 +218,8 @@ class WebSocketsServerCore : protected WebSockets {
          * @param headerName String ///< the name of the header being checked
          */
     bool hasMandatoryHeader(String headerName);
+
+    bool broadcastFrame(WSopcode_t opcode, uint8_t * payload, size_t length, bool headerToPayload);
 };
 
 class WebSocketsServer : public WebSocketsServerCore {
@@ -96,6 +96,165 @@ static uint8_t *stringprint(uint8_t *p, const char *s, uint16_t maxlen=0) {
   return p+len;
 }
 
+// Every packet id of a client comes from its packet_id_counter, the queued
+// messages' too, so two packets on the way never share one. 0 isn't a valid id.
+static uint16_t nextPacketId(uint16_t *counter) {
+  if (++*counter == 0) ++*counter;
+  return *counter;
+}
+
+
+// Adafruit_MQTT_Queue Definition //////////////////////////////////////////////
+
+bool Adafruit_MQTT_Queue::begin(uint16_t size, uint8_t window) {
+  if (buf) return true;
+  buf = (uint8_t *)malloc(size);
+  if (!buf) return false;
+  this->size = size;
+  this->window = window;
+  return true;
+}
+
+uint16_t Adafruit_MQTT_Queue::packetSize(uint16_t topiclen, uint16_t bLen, uint8_t qos) {
+  uint16_t len = 2 + topiclen + (qos ? 2 : 0) + bLen;
+  return 1 + (len < 128 ? 1 : 2) + len;
+}
+
+void Adafruit_MQTT_Queue::copyIn(uint16_t off, const uint8_t *src, uint16_t len) {
+  uint16_t pos = (head + off) % size;
+  uint16_t first = len < size - pos ? len : size - pos;
+  memcpy(buf + pos, src, first);
+  memcpy(buf, src + first, len - first);
+}
+
+void Adafruit_MQTT_Queue::copyOut(uint16_t off, uint8_t *dst, uint16_t len) {
+  uint16_t pos = (head + off) % size;
+  uint16_t first = len < size - pos ? len : size - pos;
+  memcpy(dst, buf + pos, first);
+  memcpy(dst + first, buf, len - first);
+}
+
+bool Adafruit_MQTT_Queue::push(const char *topic, const uint8_t *payload, uint16_t bLen, uint8_t qos) {
+  uint16_t topiclen = strlen(topic);
+  uint32_t len = HEADER + topiclen + bLen;
+  if (!buf || topiclen > 255 || len > (uint32_t)(size - used))
+    return false;
+
+  uint8_t header[HEADER] = {(uint8_t)len, (uint8_t)(len >> 8),
+                            (uint8_t)(qos ? FLAG_QOS1 : 0), 0, 0, (uint8_t)topiclen};
+  copyIn(used, header, HEADER);
+  copyIn(used + HEADER, (const uint8_t *)topic, topiclen);
+  copyIn(used + HEADER + topiclen, payload, bLen);
+  used += len;
+  num++;
+  return true;
+}
+
+uint16_t Adafruit_MQTT_Queue::pack(uint8_t *packet, uint16_t maxlen, uint16_t *packet_id) {
+  uint8_t *p = packet;
+  uint8_t sending = flying;
+  uint16_t off = send_off;
+
+  while (off < used) {
+    uint16_t reclen = at(off) | (at(off + 1) << 8);
+    uint8_t flags = at(off + 2);
+    if (done(flags)) {
+      off += reclen;
+      continue;
+    }
+
+    bool qos1 = flags & FLAG_QOS1;
+    if (qos1 && sending >= window)
+      break;
+
+    uint8_t topiclen = at(off + 5);
+    uint16_t bLen = reclen - HEADER - topiclen;
+    if ((p - packet) + packetSize(topiclen, bLen, qos1) > maxlen)
+      break;
+
+    // A QoS 1 message keeps its id when sent again, with the DUP flag
+    uint16_t id = (at(off + 3) << 8) | at(off + 4);
+    if (qos1 && id == 0) {
+      id = nextPacketId(packet_id);
+      at(off + 3) = id >> 8;
+      at(off + 4) = id & 0xFF;
+    }
+
+    uint16_t len = 2 + topiclen + (qos1 ? 2 : 0) + bLen;
+    *p++ = MQTT_CTRL_PUBLISH << 4 | (qos1 ? MQTT_QOS_1 << 1 : 0) | (flags & FLAG_SENT ? 0x08 : 0);
+    if (len < 128) {
+      *p++ = len;
+    } else {
+      *p++ = (len & 0x7F) | 0x80;
+      *p++ = len >> 7;
+    }
+    *p++ = 0;
+    *p++ = topiclen;
+    copyOut(off + HEADER, p, topiclen);
+    p += topiclen;
+    if (qos1) {
+      *p++ = id >> 8;
+      *p++ = id & 0xFF;
+      sending++;
+    }
+    copyOut(off + HEADER + topiclen, p, bLen);
+    p += bLen;
+
+    off += reclen;
+  }
+
+  pack_end = off;
+  return p - packet;
+}
+
+uint16_t Adafruit_MQTT_Queue::sent() {
+  uint16_t n = 0;
+  for (uint16_t off = send_off; off < pack_end; off += at(off) | (at(off + 1) << 8)) {
+    uint8_t &flags = at(off + 2);
+    if (done(flags)) continue;
+    if (flags & FLAG_QOS1) flying++;
+    flags |= FLAG_SENT;
+    n++;
+  }
+  send_off = pack_end;
+  pop();
+  return n;
+}
+
+bool Adafruit_MQTT_Queue::ack(uint16_t packet_id) {
+  for (uint16_t off = 0; off < send_off; off += at(off) | (at(off + 1) << 8)) {
+    uint8_t &flags = at(off + 2);
+    if ((flags & (FLAG_QOS1 | FLAG_SENT | FLAG_ACKED)) != (FLAG_QOS1 | FLAG_SENT))
+      continue;
+    if (((at(off + 3) << 8) | at(off + 4)) != packet_id)
+      continue;
+
+    flags |= FLAG_ACKED;
+    if (flying) flying--;
+    pop();
+    return true;
+  }
+  return false;
+}
+
+void Adafruit_MQTT_Queue::rewind() {
+  send_off = 0;
+  pack_end = 0;
+  flying = 0;
+}
+
+void Adafruit_MQTT_Queue::pop() {
+  while (used) {
+    uint16_t reclen = at(0) | (at(1) << 8);
+    if (!done(at(2))) break;
+    head = (head + reclen) % size;
+    used -= reclen;
+    send_off -= reclen;
+    pack_end -= reclen;
+    num--;
+  }
+  if (!used) head = 0;
+}
 
 // Adafruit_MQTT Definition ////////////////////////////////////////////////////
 
@@ -150,6 +309,8 @@ Adafruit_MQTT::Adafruit_MQTT(const char *server,
 }
 
 int8_t Adafruit_MQTT::connect() {
+  Adafruit_MQTT_Guard guard(this);
+
   // Connect to the server.
   if (!connectServer())
     return -1;
@@ -196,6 +357,14 @@ int8_t Adafruit_MQTT::connect() {
     if (! success) return -2; // failed to sub for some reason
   }
 
+  // New connection: what wasn't acknowledged on the old one goes again
+  if (queue) {
+    lockQueue();
+    queue->rewind();
+    unlockQueue();
+    wakeQueue();
+  }
+
   return 0;
 }
 
@@ -220,6 +389,10 @@ uint16_t Adafruit_MQTT::processPacketsUntil(uint8_t *buffer, uint8_t waitforpack
     {
       return len;
     }
+    else if ((buffer[0] >> 4) == MQTT_CTRL_PUBACK)
+    {
+      handleAck(len);
+    }
     else
     {
       ERROR_PRINTLN(F("Dropped a packet"));
@@ -289,6 +462,7 @@ const __FlashStringHelper* Adafruit_MQTT::connectErrorString(int8_t code) {
 }
 
 bool Adafruit_MQTT::disconnect() {
+  Adafruit_MQTT_Guard guard(this);
 
   // Construct and send disconnect packet.
   uint8_t len = disconnectPacket(buffer);
@@ -305,33 +479,185 @@ bool Adafruit_MQTT::publish(const char *topic, const char *data, uint8_t qos) {
 }
 
 bool Adafruit_MQTT::publish(const char *topic, uint8_t *data, uint16_t bLen, uint8_t qos) {
+  Adafruit_MQTT_Guard guard(this);
+
   // Construct and send publish packet.
   uint16_t len = publishPacket(buffer, topic, data, bLen, qos);
   if (!sendPacket(buffer, len))
     return false;
 
-  // If QOS level is high enough verify the response packet.
+  // If QOS level is high enough wait for the PUBACK of this packet, the ones
+  // of queued messages coming before it go to the queue
   if (qos > 0) {
-    len = readFullPacket(buffer, MAXBUFFERSIZE, PUBLISH_TIMEOUT_MS);
-    DEBUG_PRINT(F("Publish QOS1+ reply:\t"));
-    DEBUG_PRINTBUFFER(buffer, len);
-    if (len != 4)
-      return false;
-    if ((buffer[0] >> 4) != MQTT_CTRL_PUBACK)
-      return false;
-    uint16_t packnum = buffer[2];
-    packnum <<= 8;
-    packnum |= buffer[3];
-
-    // we increment the packet_id_counter right after publishing so inc here too to match
-    packnum++;
-    if (packnum != packet_id_counter)
-      return false;
+    uint16_t packet_id = packet_id_counter;  // taken by publishPacket()
+    uint32_t start = millis();
+    uint32_t elapsed = 0;
+
+    while (elapsed < PUBLISH_TIMEOUT_MS) {
+      len = processPacketsUntil(buffer, MQTT_CTRL_PUBACK, PUBLISH_TIMEOUT_MS - elapsed);
+      DEBUG_PRINT(F("Publish QOS1+ reply:\t"));
+      DEBUG_PRINTBUFFER(buffer, len);
+      if (!len)
+        return false;
+      if (handleAck(len) == packet_id)
+        return true;
+      elapsed = millis() - start;
+    }
+    return false;
   }
 
   return true;
 }
 
+bool Adafruit_MQTT::beginQueue(uint16_t size, uint8_t window) {
+  if (queue) return true;
+
+  queue = new Adafruit_MQTT_Queue();
+  queue_packet = (uint8_t *)malloc(MAXBUFFERSIZE);
+  if (!queue_packet || !queue->begin(size, window)) {
+    free(queue_packet);
+    queue_packet = NULL;
+    delete queue;
+    queue = NULL;
+    return false;
+  }
+
+#if defined(MQTT_QUEUE_TASK)
+  io_lock = xSemaphoreCreateRecursiveMutex();
+  queue_lock = xSemaphoreCreateMutex();
+  xTaskCreate(queueTask, "mqtt_queue", MQTT_QUEUE_TASK_STACK, this,
+              MQTT_QUEUE_TASK_PRIORITY, &queue_task);
+#endif
+  return true;
+}
+
+void Adafruit_MQTT::endQueue() {
+  if (!queue) return;
+
+#if defined(MQTT_QUEUE_TASK)
+  // Holding the lock the task can't be in the middle of a write
+  xSemaphoreTakeRecursive(io_lock, portMAX_DELAY);
+  vTaskDelete(queue_task);
+  queue_task = NULL;
+  SemaphoreHandle_t l = io_lock;
+  io_lock = NULL;
+  xSemaphoreGiveRecursive(l);
+  vSemaphoreDelete(l);
+  vSemaphoreDelete(queue_lock);
+  queue_lock = NULL;
+#endif
+
+  free(queue_packet);
+  queue_packet = NULL;
+  delete queue;
+  queue = NULL;
+}
+
+bool Adafruit_MQTT::publishQueued(const char *topic, const char *payload, uint8_t qos) {
+  return publishQueued(topic, (const uint8_t *)payload, strlen(payload), qos);
+}
+
+bool Adafruit_MQTT::publishQueued(const char *topic, const uint8_t *payload, uint16_t bLen, uint8_t qos) {
+  if (!queue || Adafruit_MQTT_Queue::packetSize(strlen(topic), bLen, qos) > MAXBUFFERSIZE)
+    return publish(topic, (uint8_t *)payload, bLen, qos);
+
+  lockQueue();
+  bool ok = queue->push(topic, payload, bLen, qos);
+  unlockQueue();
+
+  if (ok) wakeQueue();
+  return ok;
+}
+
+uint16_t Adafruit_MQTT::sendQueue() {
+  uint16_t count = 0;
+
+  while (queue) {
+    // One write at a time, the loop gets the client in between
+    Adafruit_MQTT_Guard guard(this);
+    if (!connected()) break;
+
+    lockQueue();
+    uint16_t len = queue->pack(queue_packet, MAXBUFFERSIZE, &packet_id_counter);
+    unlockQueue();
+
+    // Unsent on a failed write, they go after the reconnect
+    if (!len || !sendPacket(queue_packet, len)) break;
+
+    lockQueue();
+    count += queue->sent();
+    unlockQueue();
+  }
+  return count;
+}
+
+uint16_t Adafruit_MQTT::queued() {
+  if (!queue) return 0;
+
+  lockQueue();
+  uint16_t n = queue->count();
+  unlockQueue();
+  return n;
+}
+
+uint16_t Adafruit_MQTT::handleAck(uint16_t len) {
+  if (len != 4) return 0;
+
+  uint16_t packet_id = (buffer[2] << 8) | buffer[3];
+  if (!queue) return packet_id;
+
+  lockQueue();
+  bool freed = queue->ack(packet_id);
+  unlockQueue();
+
+  // A slot of the window is free
+  if (freed) wakeQueue();
+  return packet_id;
+}
+
+#if defined(MQTT_QUEUE_TASK)
+void Adafruit_MQTT::queueTask(void *arg) {
+  Adafruit_MQTT *mqtt = (Adafruit_MQTT *)arg;
+
+  while (true) {
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MQTT_QUEUE_POLL_MS)) && MQTT_QUEUE_COALESCE_MS)
+      vTaskDelay(pdMS_TO_TICKS(MQTT_QUEUE_COALESCE_MS));
+    mqtt->sendQueue();
+  }
+}
+
+void Adafruit_MQTT::lock() {
+  if (io_lock) xSemaphoreTakeRecursive(io_lock, portMAX_DELAY);
+}
+
+bool Adafruit_MQTT::tryLock() {
+  return !io_lock || xSemaphoreTakeRecursive(io_lock, 0) == pdTRUE;
+}
+
+void Adafruit_MQTT::unlock() {
+  if (io_lock) xSemaphoreGiveRecursive(io_lock);
+}
+
+void Adafruit_MQTT::lockQueue() {
+  if (queue_lock) xSemaphoreTake(queue_lock, portMAX_DELAY);
+}
+
+void Adafruit_MQTT::unlockQueue() {
+  if (queue_lock) xSemaphoreGive(queue_lock);
+}
+
+void Adafruit_MQTT::wakeQueue() {
+  if (queue_task) xTaskNotifyGive(queue_task);
+}
+#else
+void Adafruit_MQTT::lock() {}
+bool Adafruit_MQTT::tryLock() { return true; }
+void Adafruit_MQTT::unlock() {}
+void Adafruit_MQTT::lockQueue() {}
+void Adafruit_MQTT::unlockQueue() {}
+void Adafruit_MQTT::wakeQueue() {}
+#endif
+
 bool Adafruit_MQTT::will(const char *topic, const char *payload, uint8_t qos, uint8_t retain) {
 
   if (connected()) {
@@ -396,6 +722,8 @@ bool Adafruit_MQTT::subscribe(Adafruit_MQTT_Subscribe *sub) {
 // }
 
 int8_t Adafruit_MQTT::subscribePacketWrite(const char *_topic, uint8_t _qos) {
+  Adafruit_MQTT_Guard guard(this);
+
   if (connected()) {
     // Ignore subscriptions that aren't defined.
     // if (subscriptions[i] == 0) continue;
@@ -451,6 +779,7 @@ bool Adafruit_MQTT::subscribeTopic(const char *topic) {
 }
 
 bool Adafruit_MQTT::unsubscribe(Adafruit_MQTT_Subscribe *sub) {
+  Adafruit_MQTT_Guard guard(this);
   uint8_t i;
 
   // see if we are already subscribed
@@ -472,7 +801,7 @@ bool Adafruit_MQTT::unsubscribe(Adafruit_MQTT_Subscribe *sub) {
       if(subscriptions[i]->qos > 0 && MQTT_PROTOCOL_LEVEL > 3) {
 
         // wait for UNSUBACK
-        len = readFullPacket(buffer, MAXBUFFERSIZE, CONNECT_TIMEOUT_MS);
+        len = processPacketsUntil(buffer, MQTT_CTRL_UNSUBACK, CONNECT_TIMEOUT_MS);
         DEBUG_PRINT(F("UNSUBACK:\t"));
         DEBUG_PRINTBUFFER(buffer, len);
 
@@ -536,6 +865,11 @@ void Adafruit_MQTT::processPackets(int16_t timeout) {
 }
 
 Adafruit_MQTT_Subscribe *Adafruit_MQTT::readSubscription(int16_t timeout) {
+    // The loop doesn't wait for a write of the queue task: nothing to read
+    // this time
+    Adafruit_MQTT_Guard guard(this, false);
+    if (!guard.locked())
+        return NULL;
     uint16_t i, topiclen, datalen;
 
     // Check if data is available to read.
@@ -544,6 +878,14 @@ Adafruit_MQTT_Subscribe *Adafruit_MQTT::readSubscription(int16_t timeout) {
         return NULL;  // No data available, just quit.
     DEBUG_PRINT("Packet len: "); DEBUG_PRINTLN(len); 
     DEBUG_PRINTBUFFER(buffer, len);
+
+    // Acknowledgements of the queued messages come in between
+    if ((buffer[0] >> 4) == MQTT_CTRL_PUBACK) {
+        handleAck(len);
+        return NULL;
+    }
+    if ((buffer[0] >> 4) != MQTT_CTRL_PUBLISH)
+        return NULL;
     
     // Parse out length of packet.
     if (len < 3) return NULL;
@@ -714,6 +1056,7 @@ void Adafruit_MQTT::flushIncoming(uint16_t timeout) {
 }
 
 bool Adafruit_MQTT::ping(uint8_t num) {
+  Adafruit_MQTT_Guard guard(this);
   //flushIncoming(100);
 
   while (num--) {
@@ -872,12 +1215,10 @@ uint16_t Adafruit_MQTT::publishPacket(uint8_t *packet, const char *topic,
 
   // add packet identifier. used for checking PUBACK in QOS > 0
   if(qos > 0) {
-    p[0] = (packet_id_counter >> 8) & 0xFF;
-    p[1] = packet_id_counter & 0xFF;
+    uint16_t id = nextPacketId(&packet_id_counter);
+    p[0] = (id >> 8) & 0xFF;
+    p[1] = id & 0xFF;
     p+=2;
-
-    // increment the packet id
-    packet_id_counter++;
   }
 
   memmove(p, data, bLen);
@@ -898,13 +1239,11 @@ uint8_t Adafruit_MQTT::subscribePacket(uint8_t *packet, const char *topic,
   p+=2;
 
   // packet identifier. used for checking SUBACK
-  p[0] = (packet_id_counter >> 8) & 0xFF;
-  p[1] = packet_id_counter & 0xFF;
+  uint16_t id = nextPacketId(&packet_id_counter);
+  p[0] = (id >> 8) & 0xFF;
+  p[1] = id & 0xFF;
   p+=2;
 
-  // increment the packet id
-  packet_id_counter++;
-
   p = stringprint(p, topic);
 
   p[0] = qos;
@@ -929,13 +1268,11 @@ uint8_t Adafruit_MQTT::unsubscribePacket(uint8_t *packet, const char *topic) {
   p+=2;
 
   // packet identifier. used for checking UNSUBACK
-  p[0] = (packet_id_counter >> 8) & 0xFF;
-  p[1] = packet_id_counter & 0xFF;
+  uint16_t id = nextPacketId(&packet_id_counter);
+  p[0] = (id >> 8) & 0xFF;
+  p[1] = id & 0xFF;
   p+=2;
 
-  // increment the packet id
-  packet_id_counter++;
-
   p = stringprint(p, topic);
 
   len = p - packet;
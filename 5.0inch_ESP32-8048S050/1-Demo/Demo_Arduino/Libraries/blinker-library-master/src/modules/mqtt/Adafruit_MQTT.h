@@ -24,6 +24,14 @@
 
 #include <Arduino.h>
 
+#if defined(ESP32)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/semphr.h>
+  #include <freertos/task.h>
+  // The publish queue is sent by a task of its own
+  #define MQTT_QUEUE_TASK
+#endif
+
 #if defined(ARDUINO_SAMD_ZERO) || defined(ARDUINO_STM32_FEATHER)
 #define strncpy_P(dest, src, len) strncpy((dest), (src), (len))
 #define strncasecmp_P(f1, f2, len) strncasecmp((f1), (f2), (len))
@@ -89,6 +97,22 @@
 #define PING_TIMEOUT_MS    500
 #define SUBACK_TIMEOUT_MS  500
 
+// Publish queue: how long the task lets a burst of messages collect before
+// sending them in one write, and how often it looks for freed window slots
+// or a new connection without being woken.
+#ifndef MQTT_QUEUE_COALESCE_MS
+  #define MQTT_QUEUE_COALESCE_MS 5
+#endif
+#ifndef MQTT_QUEUE_POLL_MS
+  #define MQTT_QUEUE_POLL_MS 100
+#endif
+#ifndef MQTT_QUEUE_TASK_STACK
+  #define MQTT_QUEUE_TASK_STACK 4096
+#endif
+#ifndef MQTT_QUEUE_TASK_PRIORITY
+  #define MQTT_QUEUE_TASK_PRIORITY 1
+#endif
+
 // Adjust as necessary, in seconds.  Default to 5 minutes.
 #define MQTT_CONN_KEEPALIVE 300
 
@@ -130,6 +154,65 @@ extern void printBuffer(uint8_t *buffer, uint16_t len);
 
 class Adafruit_MQTT_Subscribe;  // forward decl
 
+// Messages waiting to be published, in one byte ring. QoS 0 messages leave
+// the ring once written to the client, QoS 1 ones once their PUBACK came
+// back; at most `window` of them are on the way at a time. Not thread safe,
+// Adafruit_MQTT locks it.
+class Adafruit_MQTT_Queue {
+ public:
+  Adafruit_MQTT_Queue() {}
+  ~Adafruit_MQTT_Queue() { free(buf); }
+
+  bool begin(uint16_t size, uint8_t window);
+
+  // Copies the message in, false if it doesn't fit
+  bool push(const char *topic, const uint8_t *payload, uint16_t bLen, uint8_t qos);
+
+  // Writes the next messages the window allows as PUBLISH packets to
+  // packet, as many as fit in maxlen. Returns the length, 0 if there is
+  // nothing to send. QoS 1 messages take the next id of the client's
+  // counter *packet_id.
+  uint16_t pack(uint8_t *packet, uint16_t maxlen, uint16_t *packet_id);
+  // The packets of the last pack() were sent, returns the number of them
+  uint16_t sent();
+  // PUBACK of a QoS 1 message, false if none waits for it
+  bool ack(uint16_t packet_id);
+  // After a reconnect the QoS 1 messages not acknowledged are sent again
+  void rewind();
+
+  uint16_t count() const { return num; }
+  uint8_t inflight() const { return flying; }
+
+  // Largest packet of a message
+  static uint16_t packetSize(uint16_t topiclen, uint16_t bLen, uint8_t qos);
+
+ private:
+  enum {
+    HEADER = 6,           // record length (2), flags, packet id (2), topic length
+    FLAG_QOS1 = 0x01,
+    FLAG_SENT = 0x02,
+    FLAG_ACKED = 0x04,
+  };
+
+  uint8_t *buf = NULL;
+  uint16_t size = 0;
+  uint16_t head = 0;
+  uint16_t used = 0;
+  uint16_t num = 0;
+  uint16_t send_off = 0;  // first record not sent, from the head
+  uint16_t pack_end = 0;  // end of the records of the last pack()
+  uint8_t window = 0;
+  uint8_t flying = 0;
+
+  uint8_t &at(uint16_t off) { return buf[(head + off) % size]; }
+  void copyIn(uint16_t off, const uint8_t *src, uint16_t len);
+  void copyOut(uint16_t off, uint8_t *dst, uint16_t len);
+  static bool done(uint8_t flags) {
+    return (flags & FLAG_ACKED) || ((flags & (FLAG_QOS1 | FLAG_SENT)) == FLAG_SENT);
+  }
+  void pop();
+};
+
 class Adafruit_MQTT {
  public:
   Adafruit_MQTT(const char *server,
@@ -193,6 +276,25 @@ class Adafruit_MQTT {
   bool publish(const char *topic, const char *payload, uint8_t qos = 0);
   bool publish(const char *topic, uint8_t *payload, uint16_t bLen, uint8_t qos = 0);
 
+  // Set up a publish queue of size bytes with up to window QoS 1 messages
+  // waiting for their PUBACK. On ESP32 a task sends the queue, elsewhere
+  // sendQueue() has to be called from the loop.
+  bool beginQueue(uint16_t size, uint8_t window = 4);
+  // Stops the task and drops the queued messages
+  void endQueue();
+
+  // Queue a message instead of waiting for the client. Returns false if the
+  // queue is full. Without a queue (or for a message too big for one packet)
+  // it's the same as publish(). Queued messages are kept over a reconnect.
+  bool publishQueued(const char *topic, const char *payload, uint8_t qos = 0);
+  bool publishQueued(const char *topic, const uint8_t *payload, uint16_t bLen, uint8_t qos = 0);
+
+  // Writes the queued messages, several packets to a write. Returns the
+  // number of packets sent.
+  uint16_t sendQueue();
+  // Messages queued or waiting for their PUBACK
+  uint16_t queued();
+
   // Add a subscription to receive messages for a topic.  Returns true if the
   // subscription could be added or was already present, false otherwise.
   // Must be called before connect(), subscribing after the connection
@@ -250,6 +352,13 @@ class Adafruit_MQTT {
   // Properly process packets until you get to one you want
   uint16_t processPacketsUntil(uint8_t *buffer, uint8_t waitforpackettype, uint16_t timeout);
 
+  // The client is used by the loop and the queue task, everything reading
+  // or writing it holds this (recursive) lock. tryLock() doesn't wait.
+  void lock();
+  bool tryLock();
+  void unlock();
+  friend class Adafruit_MQTT_Guard;
+
   // Shared state that subclasses can use:
   const char *servername;
   int16_t portnum;
@@ -269,6 +378,21 @@ class Adafruit_MQTT {
 
  private:
   Adafruit_MQTT_Subscribe *subscriptions[MAXSUBSCRIPTIONS];
+
+  Adafruit_MQTT_Queue *queue = NULL;
+  uint8_t *queue_packet = NULL;  // the loop may be halfway through a packet in buffer
+#if defined(MQTT_QUEUE_TASK)
+  SemaphoreHandle_t io_lock = NULL;
+  SemaphoreHandle_t queue_lock = NULL;
+  TaskHandle_t queue_task = NULL;
+
+  static void queueTask(void *arg);
+#endif
+  void lockQueue();
+  void unlockQueue();
+  void wakeQueue();
+  // Gives the PUBACK in buffer to the queue, returns its packet id
+  uint16_t handleAck(uint16_t len);
 //   Adafruit_MQTT_Subscribe *subrrpcscriptions;
 
   void    flushIncoming(uint16_t timeout);
@@ -284,6 +408,23 @@ class Adafruit_MQTT {
 };
 
 
+// Holds the client's lock, with wait false only if it is free (see locked())
+class Adafruit_MQTT_Guard {
+ public:
+  Adafruit_MQTT_Guard(Adafruit_MQTT *mqtt, bool wait = true) : mqtt(mqtt) {
+    if (wait) mqtt->lock();
+    has_lock = wait || mqtt->tryLock();
+  }
+  ~Adafruit_MQTT_Guard() { if (has_lock) mqtt->unlock(); }
+
+  bool locked() const { return has_lock; }
+
+ private:
+  Adafruit_MQTT *mqtt;
+  bool has_lock;
+};
+
+
 class Adafruit_MQTT_Publish {
  public:
   Adafruit_MQTT_Publish(Adafruit_MQTT *mqttserver, const char *feed, uint8_t qos = 0);
@@ -34,6 +34,8 @@ bool Adafruit_MQTT_Client::connectServer() {
 }
 
 bool Adafruit_MQTT_Client::disconnectServer() {
+  Adafruit_MQTT_Guard guard(this);
+
   // Stop connection if connected and return success (stop has no indication of
   // failure).
   if (client->connected()) {
@@ -43,7 +45,8 @@ bool Adafruit_MQTT_Client::disconnectServer() {
 }
 
 bool Adafruit_MQTT_Client::connected() {
-  // Return true if connected, false if not connected.
+  // Return true if connected, false if not connected. Without the lock: the
+  // loop asks this while the queue task may be in a write.
   return client->connected();
 }
 
@@ -75,7 +78,10 @@ uint16_t Adafruit_MQTT_Client::readPacket(uint8_t *buffer, uint16_t maxlen,
       }
     }
     timeout -= MQTT_CLIENT_READINTERVAL_MS;
+    // The queue task may write while nothing comes in
+    unlock();
     delay(MQTT_CLIENT_READINTERVAL_MS);
+    lock();
   }
   return len;
 }
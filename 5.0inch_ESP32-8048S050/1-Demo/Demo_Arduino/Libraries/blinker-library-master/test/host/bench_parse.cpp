@@ -0,0 +1,91 @@
+// BlinkerParseDoc against a DynamicJsonDocument per message, with the
+// recorded app payloads of app_payloads.txt (slider drags, RGB, buttons,
+// state polls, a shared device message, joystick, text).
+#include "host.h"
+#include "BlinkerParseDoc.h"
+
+#include <chrono>
+#include <fstream>
+#include <vector>
+
+static BlinkerParseArena arena;
+static volatile long sink;
+
+static void use(JsonObject root)
+{
+    for (JsonPair kv : root)
+    {
+        sink += kv.key().c_str()[0] +
+            (kv.value().is<int>() ? kv.value().as<int>() : 1);
+    }
+}
+
+int main()
+{
+    std::vector<std::string> msgs;
+    std::ifstream in("app_payloads.txt");
+    for (std::string line; std::getline(in, line);)
+    {
+        if (!line.empty()) msgs.push_back(line);
+    }
+    CHECK(msgs.size() == 7);
+
+    // Every payload parses the same both ways
+    for (const std::string &m : msgs)
+    {
+        DynamicJsonDocument heap(1024);
+        CHECK(deserializeJson(heap, m) == DeserializationError::Ok);
+
+        BlinkerParseDoc doc(&arena);
+        CHECK(doc.parse(m.c_str()) == DeserializationError::Ok);
+
+        std::string a, b;
+        serializeJson(heap, a);
+        serializeJson(doc.root(), b);
+        CHECK(a == b);
+    }
+    CHECK(!arena.busy);
+
+    // A nested parse gets a heap document, the outer one is kept
+    {
+        BlinkerParseDoc outer(&arena);
+        CHECK(outer.parse(msgs[4].c_str()) == DeserializationError::Ok);
+        BlinkerParseDoc inner(&arena);
+        CHECK(inner.parse(msgs[0].c_str()) == DeserializationError::Ok);
+        CHECK(outer.root()["data"]["ran-l9j"].as<int>() == 64);
+        CHECK(inner.root()["ran-l9j"].as<int>() == 128);
+
+        BlinkerParseDoc wrapped(&arena);
+        CHECK(wrapped.parse("[{\"a\":1},{\"b\":2}]", true) == DeserializationError::Ok);
+        CHECK(wrapped.root()["data"][1]["b"].as<int>() == 2);
+    }
+    CHECK(!arena.busy);
+
+    const int N = 400000;
+    for (int mode = 0; mode < 2; mode++)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < N; i++)
+        {
+            const std::string &m = msgs[i % msgs.size()];
+            if (mode == 0)
+            {
+                // Before: String copy and a document per message
+                DynamicJsonDocument jsonBuffer(1024);
+                deserializeJson(jsonBuffer, String(m.c_str()));
+                use(jsonBuffer.as<JsonObject>());
+            }
+            else
+            {
+                BlinkerParseDoc jsonBuffer(&arena);
+                jsonBuffer.parse(m.c_str());
+                use(jsonBuffer.root());
+            }
+        }
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        printf("%-34s %6.2f M msgs/s\n",
+            mode ? "reused document, in place" : "DynamicJsonDocument per message",
+            N / s / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Received key to widget: BlinkerWidgetTable against the scans of the old
+// json_parse() (checkNum() and containsKey() for every attached widget),
+// with 32 string, 32 int and 8 RGB widgets. A message carries one widget
+// like a slider drag, one in 73 is a key without a widget.
+#include "host.h"
+#include "BlinkerWidgetTable.h"
+
+#include <chrono>
+#include <vector>
+
+struct widget_t
+{
+    char     name[16];
+    uint32_t calls;
+
+    bool checkName(const char * n) { return strcmp(n, name) == 0; }
+};
+
+static widget_t str_w[32], int_w[32], rgb_w[8];
+static const uint8_t str_n = 32, int_n = 32, rgb_n = 8;
+static BlinkerWidgetTable table;
+static volatile long sink;
+
+template <class T>
+static int8_t checkNum(const char * name, T * c, uint8_t count)
+{
+    for (uint8_t n = 0; n < count; n++)
+    {
+        if (c[n].checkName(name)) return n;
+    }
+    return BLINKER_OBJECT_NOT_AVAIL;
+}
+
+static widget_t * widget(uint8_t type, uint8_t num)
+{
+    switch (type)
+    {
+        case BLINKER_WIDGET_STR: return &str_w[num];
+        case BLINKER_WIDGET_INT: return &int_w[num];
+        default: return &rgb_w[num];
+    }
+}
+
+// BlinkerApi::widgetNum()
+static int8_t widgetNum(const char * name, uint8_t * type)
+{
+    uint32_t h = BlinkerWidgetTable::hash(name);
+    uint16_t pos = BlinkerWidgetTable::first(h);
+    uint8_t num;
+
+    while (table.next(h, &pos, type, &num))
+    {
+        if (strcmp(widget(*type, num)->name, name) == 0) return num;
+    }
+    *type = BLINKER_WIDGET_NONE;
+    return BLINKER_OBJECT_NOT_AVAIL;
+}
+
+static void called(widget_t * w, JsonVariant v)
+{
+    w->calls++;
+    sink += v.is<int>() ? v.as<int>() : v.is<JsonArray>() ? v[0].as<int>() : 1;
+}
+
+static void oldParse(JsonObject data)
+{
+    for (uint8_t w = 0; w < str_n; w++)
+    {
+        int8_t num = checkNum(str_w[w].name, str_w, str_n);
+        if (num >= 0 && data.containsKey(str_w[w].name)) called(&str_w[num], data[str_w[w].name]);
+    }
+    for (uint8_t w = 0; w < int_n; w++)
+    {
+        int8_t num = checkNum(int_w[w].name, int_w, int_n);
+        if (num >= 0 && data.containsKey(int_w[w].name)) called(&int_w[num], data[int_w[w].name]);
+    }
+    for (uint8_t w = 0; w < rgb_n; w++)
+    {
+        int8_t num = checkNum(rgb_w[w].name, rgb_w, rgb_n);
+        if (num >= 0 && data.containsKey(rgb_w[w].name)) called(&rgb_w[num], data[rgb_w[w].name]);
+    }
+}
+
+static void newParse(JsonObject data)
+{
+    for (JsonPair kv : data)
+    {
+        uint8_t type;
+        int8_t num = widgetNum(kv.key().c_str(), &type);
+        if (num >= 0) called(widget(type, num), kv.value());
+    }
+}
+
+static void attach(widget_t * w, uint8_t count, const char * prefix, uint8_t type)
+{
+    for (uint8_t n = 0; n < count; n++)
+    {
+        snprintf(w[n].name, sizeof(w[n].name), "%s-%c%c%c", prefix,
+            'a' + rand() % 26, 'a' + rand() % 26, '0' + rand() % 10);
+        table.add(w[n].name, type, n);
+    }
+}
+
+int main()
+{
+    srand(1);
+    attach(str_w, str_n, "btn", BLINKER_WIDGET_STR);
+    attach(int_w, int_n, "ran", BLINKER_WIDGET_INT);
+    attach(rgb_w, rgb_n, "rgb", BLINKER_WIDGET_RGB);
+
+    std::vector<std::string> msgs;
+    for (uint8_t n = 0; n < str_n; n++)
+    {
+        msgs.push_back(std::string("{\"") + str_w[n].name + "\":\"tap\"}");
+    }
+    for (uint8_t n = 0; n < int_n; n++)
+    {
+        msgs.push_back(std::string("{\"") + int_w[n].name + "\":" + std::to_string(n) + "}");
+    }
+    for (uint8_t n = 0; n < rgb_n; n++)
+    {
+        msgs.push_back(std::string("{\"") + rgb_w[n].name + "\":[255,12,0,200]}");
+    }
+    msgs.push_back("{\"get\":\"state\"}");
+
+    std::vector<StaticJsonDocument<256>> docs(msgs.size());
+    for (size_t i = 0; i < msgs.size(); i++)
+    {
+        CHECK(deserializeJson(docs[i], msgs[i]) == DeserializationError::Ok);
+    }
+
+    // Every widget is found and gets the same value both ways
+    for (uint8_t n = 0; n < str_n; n++)
+    {
+        uint8_t type;
+        CHECK(widgetNum(str_w[n].name, &type) == checkNum(str_w[n].name, str_w, str_n));
+        CHECK(type == BLINKER_WIDGET_STR);
+    }
+    for (uint8_t n = 0; n < rgb_n; n++)
+    {
+        uint8_t type;
+        CHECK(widgetNum(rgb_w[n].name, &type) == n && type == BLINKER_WIDGET_RGB);
+    }
+    uint8_t type;
+    CHECK(widgetNum("get", &type) == BLINKER_OBJECT_NOT_AVAIL && type == BLINKER_WIDGET_NONE);
+
+    for (auto & d : docs)
+    {
+        sink = 0;
+        oldParse(d.as<JsonObject>());
+        long a = sink;
+        sink = 0;
+        newParse(d.as<JsonObject>());
+        CHECK(a == sink);
+    }
+    CHECK(str_w[3].calls == 2 && int_w[31].calls == 2 && rgb_w[7].calls == 2);
+
+    printf("%u widgets\n", str_n + int_n + rgb_n);
+    const int N = 200000;
+    for (int mode = 0; mode < 2; mode++)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < N; i++)
+        {
+            JsonObject o = docs[i % docs.size()].as<JsonObject>();
+            if (mode) newParse(o);
+            else oldParse(o);
+        }
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        printf("%-14s %6.3f us/msg\n", mode ? "hash table" : "strcmp scans", s * 1e6 / N);
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef BLINKER_HOST_H
+#define BLINKER_HOST_H
+
+// Stand-ins of the Arduino core and of BlinkerConfig.h for the host builds,
+// the settings are the ones of an ESP32.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define ARDUINOJSON_ENABLE_ARDUINO_STRING 0
+#include "ArduinoJson.h"
+
+typedef std::string String;
+
+#define BLINKER_F(x)                x
+#define BLINKER_LOG_ALL(...)
+#define BLINKER_ARDUINOJSON
+
+#define BLINKER_MAX_READ_SIZE       1024
+#ifndef BLINKER_PARSE_DOC_SIZE
+    #define BLINKER_PARSE_DOC_SIZE  1024
+#endif
+#ifndef BLINKER_WIDGET_TABLE_SIZE
+    #define BLINKER_WIDGET_TABLE_SIZE   256
+#endif
+#define BLINKER_OBJECT_NOT_AVAIL    -1
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); return 1; } \
+} while (0)
+
+#endif
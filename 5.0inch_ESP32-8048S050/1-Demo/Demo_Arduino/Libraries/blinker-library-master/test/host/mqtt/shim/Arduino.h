@@ -0,0 +1,35 @@
+// Host stand-ins of the Arduino API used by the MQTT module
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <strings.h>
+#include <chrono>
+#include <thread>
+
+typedef bool boolean;
+class __FlashStringHelper;
+#define F(x) (reinterpret_cast<const __FlashStringHelper *>(x))
+#define HEX 16
+
+inline uint32_t millis() {
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+inline void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+struct FakeSerial {
+  template <class T> void print(T) {}
+  template <class T> void print(T, int) {}
+  template <class T> void println(T) {}
+  void println() {}
+  void write(uint8_t) {}
+};
+extern FakeSerial Serial;
+
+inline char *dtostrf(double v, signed char w, unsigned char p, char *s) { sprintf(s, "%*.*f", w, p, v); return s; }
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+inline char *ltoa(long v, char *s, int) { sprintf(s, "%ld", v); return s; }
+inline char *ultoa(unsigned long v, char *s, int) { sprintf(s, "%lu", v); return s; }
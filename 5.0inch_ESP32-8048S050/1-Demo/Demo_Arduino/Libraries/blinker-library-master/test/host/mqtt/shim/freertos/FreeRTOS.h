@@ -0,0 +1,40 @@
+// FreeRTOS on std::thread: enough of it for the publish queue task
+#pragma once
+#include <atomic>
+#include <pthread.h>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portMAX_DELAY 0xFFFFFFFF
+
+struct ShimSem {
+  bool recursive;
+  std::recursive_mutex rm;
+  std::mutex m;
+};
+typedef ShimSem *SemaphoreHandle_t;
+
+struct ShimTask {
+  std::mutex m;
+  std::condition_variable cv;
+  uint32_t notes = 0;
+  std::atomic<bool> deleted{false};
+};
+typedef ShimTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// The task of this thread, NULL for the loop
+extern thread_local ShimTask *shimCurrent;
+
+// A deleted task ends at the next FreeRTOS call it makes
+inline void shimTaskCheck() {
+  if (shimCurrent && shimCurrent->deleted) pthread_exit(NULL);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "FreeRTOS.h"
+
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { auto s = new ShimSem; s->recursive = true; return s; }
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { auto s = new ShimSem; s->recursive = false; return s; }
+
+// Waits by polling, so that a task deleted while it waits can end
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t s, TickType_t ms) {
+  while (!s->rm.try_lock()) {
+    shimTaskCheck();
+    if (ms == 0) return pdFALSE;
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+  if (shimCurrent && shimCurrent->deleted) {
+    s->rm.unlock();
+    shimTaskCheck();
+  }
+  return pdTRUE;
+}
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t s) { s->rm.unlock(); return pdTRUE; }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t) { s->m.lock(); return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s) { s->m.unlock(); return pdTRUE; }
+
+// Kept: a deleted task may still be polling it
+inline void vSemaphoreDelete(SemaphoreHandle_t) {}
@@ -0,0 +1,38 @@
+#pragma once
+#include "FreeRTOS.h"
+
+inline BaseType_t xTaskCreate(TaskFunction_t f, const char *, uint32_t, void *arg, int, TaskHandle_t *h) {
+  ShimTask *t = new ShimTask;
+  *h = t;
+  std::thread([t, f, arg] { shimCurrent = t; f(arg); }).detach();
+  return pdTRUE;
+}
+
+// The task isn't freed, it only notices the delete later
+inline void vTaskDelete(TaskHandle_t t) {
+  t->deleted = true;
+  t->cv.notify_one();
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ms) {
+  ShimTask *t = shimCurrent;
+  {
+    std::unique_lock<std::mutex> l(t->m);
+    t->cv.wait_for(l, std::chrono::milliseconds(ms), [t] { return t->notes > 0 || t->deleted; });
+  }
+  shimTaskCheck();
+  std::lock_guard<std::mutex> l(t->m);
+  uint32_t n = t->notes;
+  if (clear) t->notes = 0; else if (n) t->notes--;
+  return n;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t t) {
+  { std::lock_guard<std::mutex> l(t->m); t->notes++; }
+  t->cv.notify_one();
+}
+
+inline void vTaskDelay(TickType_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  shimTaskCheck();
+}
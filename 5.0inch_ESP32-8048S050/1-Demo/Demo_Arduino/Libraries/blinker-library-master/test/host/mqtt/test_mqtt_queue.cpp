@@ -0,0 +1,403 @@
+// Publish queue of Adafruit_MQTT against a loopback stand-in broker, which
+// answers CONNACK, SUBACK, PUBACK and PINGRESP after rtt_ms. Every client
+// write costs write_us, like TLS and lwIP on the ESP32.
+//
+//   test_mqtt_queue [rtt_ms] [write_us] [messages]
+#include <Arduino.h>
+#include <Client.h>
+#include "Adafruit_MQTT_Client.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+FakeSerial Serial;
+thread_local ShimTask *shimCurrent;
+
+#define CHECK(cond) do { \
+  if (!(cond)) { printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); exit(1); } \
+} while (0)
+
+static int rtt_ms = 20;
+static int write_us = 500;
+static std::atomic<long> writes{0};
+
+static int64_t nowUs() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+class SockClient : public Client {
+ public:
+  std::atomic<int> fd{-1};
+  std::atomic<bool> hold{false};      // writes wait while it is set
+  std::atomic<bool> in_write{false};
+
+  int connect(const char *host, uint16_t port) override {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    inet_pton(AF_INET, host, &a.sin_addr);
+    if (::connect(s, (sockaddr *)&a, sizeof(a)) < 0) {
+      close(s);
+      return 0;
+    }
+    fd = s;
+    return 1;
+  }
+  size_t write(const uint8_t *b, size_t n) override {
+    in_write = true;
+    while (hold) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (write_us) std::this_thread::sleep_for(std::chrono::microseconds(write_us));
+    writes++;
+    ssize_t r = fd < 0 ? -1 : send(fd, b, n, MSG_NOSIGNAL);
+    in_write = false;
+    return r < 0 ? 0 : r;
+  }
+  int available() override {
+    int n = 0;
+    if (fd >= 0) ioctl(fd, FIONREAD, &n);
+    return n;
+  }
+  int read() override {
+    uint8_t c;
+    if (fd < 0 || recv(fd, &c, 1, 0) != 1) return -1;
+    return c;
+  }
+  uint8_t connected() override {
+    int s = fd;
+    if (s < 0) return 0;
+    char c;
+    if (recv(s, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0) {
+      stop();
+      return 0;
+    }
+    return 1;
+  }
+  void stop() override {
+    int s = fd.exchange(-1);
+    if (s >= 0) close(s);
+  }
+};
+
+// Stand-in broker, one connection at a time
+struct Broker {
+  int lfd = -1;
+  uint16_t port = 0;
+  std::thread thread;
+  std::atomic<bool> stopping{false};
+
+  std::mutex m;
+  std::map<uint32_t, int64_t> got;  // seq of the message: latency of its first arrival
+  std::set<uint16_t> unacked;       // QoS 1 packet ids without PUBACK
+  long dups = 0;
+  long bad_ids = 0;                 // id 0, or an id already on the way
+  int drop_after = -1;              // close the connection at that publish
+
+  void start() {
+    lfd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(lfd, (sockaddr *)&a, sizeof(a));
+    socklen_t l = sizeof(a);
+    getsockname(lfd, (sockaddr *)&a, &l);
+    port = ntohs(a.sin_port);
+    listen(lfd, 4);
+    thread = std::thread([this] {
+      while (!stopping) {
+        int fd = accept(lfd, NULL, NULL);
+        if (fd < 0) continue;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        serve(fd);
+        close(fd);
+      }
+    });
+  }
+
+  void stop() {
+    stopping = true;
+    shutdown(lfd, SHUT_RDWR);
+    close(lfd);
+    thread.join();
+  }
+
+  static bool readN(int fd, uint8_t *b, size_t n) {
+    while (n) {
+      ssize_t r = recv(fd, b, n, 0);
+      if (r <= 0) return false;
+      b += r;
+      n -= r;
+    }
+    return true;
+  }
+
+  void serve(int fd) {
+    std::mutex om;
+    std::condition_variable cv;
+    std::deque<std::pair<int64_t, std::vector<uint8_t>>> out;
+    bool done = false;
+
+    // Replies go out rtt_ms after their packet came in
+    std::thread sender([&] {
+      std::unique_lock<std::mutex> l(om);
+      while (true) {
+        cv.wait(l, [&] { return done || !out.empty(); });
+        if (done) break;
+        int64_t wait = out.front().first - nowUs();
+        if (wait > 0) {
+          cv.wait_for(l, std::chrono::microseconds(wait));
+          continue;
+        }
+        std::vector<uint8_t> v = out.front().second;
+        out.pop_front();
+        l.unlock();
+        if (v[0] >> 4 == MQTT_CTRL_PUBACK) {
+          std::lock_guard<std::mutex> g(m);
+          unacked.erase((v[2] << 8) | v[3]);
+        }
+        send(fd, v.data(), v.size(), MSG_NOSIGNAL);
+        l.lock();
+      }
+    });
+    auto reply = [&](std::vector<uint8_t> v) {
+      std::lock_guard<std::mutex> l(om);
+      out.push_back({nowUs() + rtt_ms * 1000, v});
+      cv.notify_one();
+    };
+
+    int pubs = 0;
+    uint8_t b[4096];
+    while (true) {
+      uint8_t h, e;
+      uint32_t len = 0, mul = 1;
+      if (!readN(fd, &h, 1)) break;
+      do {
+        if (!readN(fd, &e, 1)) goto end;
+        len += (e & 0x7F) * mul;
+        mul *= 128;
+      } while (e & 0x80);
+      if (len > sizeof(b) || !readN(fd, b, len)) break;
+
+      int64_t t = nowUs();
+      switch (h >> 4) {
+        case MQTT_CTRL_CONNECT:
+          {
+            std::lock_guard<std::mutex> g(m);
+            unacked.clear();
+          }
+          reply({MQTT_CTRL_CONNECTACK << 4, 2, 0, 0});
+          break;
+        case MQTT_CTRL_SUBSCRIBE: reply({MQTT_CTRL_SUBACK << 4, 3, b[0], b[1], 0}); break;
+        case MQTT_CTRL_PINGREQ: reply({MQTT_CTRL_PINGRESP << 4, 0}); break;
+        case MQTT_CTRL_PUBLISH: {
+          uint16_t tl = (b[0] << 8) | b[1];
+          uint8_t qos = (h >> 1) & 3;
+          uint16_t off = 2 + tl;
+          uint16_t id = 0;
+          if (qos) {
+            id = (b[off] << 8) | b[off + 1];
+            off += 2;
+          }
+          std::string payload((char *)b + off, len - off);
+          unsigned seq;
+          long long ts;
+          {
+            std::lock_guard<std::mutex> g(m);
+            if (qos && (id == 0 || !unacked.insert(id).second)) bad_ids++;
+            if (sscanf(payload.c_str(), "{\"seq\":%u,\"t\":%lld", &seq, &ts) == 2) {
+              if (got.count(seq)) dups++;
+              else got[seq] = t - ts;
+            }
+          }
+          if (++pubs == drop_after) {  // gone without its PUBACK
+            drop_after = -1;
+            goto end;
+          }
+          if (qos) reply({MQTT_CTRL_PUBACK << 4, 2, (uint8_t)(id >> 8), (uint8_t)id});
+          break;
+        }
+      }
+    }
+  end:
+    {
+      std::lock_guard<std::mutex> l(om);
+      done = true;
+      cv.notify_one();
+    }
+    sender.join();
+    shutdown(fd, SHUT_RDWR);
+  }
+};
+
+struct Result {
+  double msgs_s, stall_avg_us, stall_max_us, p50_ms, p99_ms;
+  long writes;
+  size_t got;
+  long dups, bad_ids, sync_failed;
+};
+
+static double percentile(std::vector<int64_t> &v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[std::min(v.size() - 1, (size_t)(p * v.size()))] / 1000.0;
+}
+
+enum Mode { SYNC, QUEUED, MIXED };  // MIXED: every 10th message is a sync publish
+
+// Telemetry: bursts of `burst` messages every `period_ms`, the loop reads
+// the subscription between them like BlinkerMQTT does
+static Result run(Mode mode, uint8_t qos, int total, int burst, int period_ms, int drop_after = -1) {
+  Broker br;
+  br.drop_after = drop_after;
+  br.start();
+  SockClient cl;
+  Adafruit_MQTT_Client mqtt(&cl, "127.0.0.1", br.port, "dev", "u", "p");
+  if (mode != SYNC) CHECK(mqtt.beginQueue(8192, 8));
+  CHECK(mqtt.connect() == 0);
+  writes = 0;
+
+  Result r{};
+  char msg[128];
+  int64_t stall_max = 0, stall_sum = 0;
+  int sent = 0;
+  int64_t t0 = nowUs();
+  int64_t next = t0;
+  while (true) {
+    if (!mqtt.connected()) mqtt.connect();
+    if (sent < total && nowUs() >= next) {
+      for (int i = 0; i < burst && sent < total; i++, sent++) {
+        snprintf(msg, sizeof(msg), "{\"seq\":%u,\"t\":%lld,\"temp\":[\"23.5\"],\"volt\":[\"12.1\"]}",
+                 sent, (long long)nowUs());
+        bool sync = mode == SYNC || (mode == MIXED && sent % 10 == 0);
+        int64_t a = nowUs();
+        bool ok = sync ? mqtt.publish("/device/dev/s", msg, qos)
+                       : mqtt.publishQueued("/device/dev/s", msg, qos);
+        int64_t d = nowUs() - a;
+        if (!ok && sync) r.sync_failed++;
+        if (!ok && !sync) break;  // queue full: the rest waits for the next pass
+        stall_sum += d;
+        stall_max = std::max(stall_max, d);
+      }
+      next += period_ms * 1000;
+    }
+    while (mqtt.readSubscription(10)) {}
+    {
+      std::lock_guard<std::mutex> l(br.m);
+      if ((int)br.got.size() >= total && mqtt.queued() == 0) break;
+    }
+    CHECK(nowUs() - t0 < 120000000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));  // rest of the loop (UI)
+  }
+  int64_t elapsed = nowUs() - t0;
+
+  mqtt.endQueue();
+  cl.stop();
+  br.stop();
+
+  std::vector<int64_t> latency;
+  for (auto &kv : br.got) latency.push_back(kv.second);
+  r.got = br.got.size();
+  r.dups = br.dups;
+  r.bad_ids = br.bad_ids;
+  r.stall_max_us = stall_max;
+  r.stall_avg_us = (double)stall_sum / total;
+  r.msgs_s = total * 1e6 / elapsed;
+  r.p50_ms = percentile(latency, 0.5);
+  r.p99_ms = percentile(latency, 0.99);
+  r.writes = writes;
+  return r;
+}
+
+static Result print(const char *name, Result r) {
+  printf("%-28s %6.0f msg/s  stall avg %6.0f max %6.0f us  p50/p99 %6.2f/%6.2f ms  writes %5ld  dup %ld\n",
+         name, r.msgs_s, r.stall_avg_us, r.stall_max_us, r.p50_ms, r.p99_ms, r.writes, r.dups);
+  return r;
+}
+
+// The loop doesn't wait for a write of the queue task
+static void testLoopNotBlocked() {
+  Broker br;
+  br.start();
+  SockClient cl;
+  Adafruit_MQTT_Client mqtt(&cl, "127.0.0.1", br.port, "dev", "u", "p");
+  CHECK(mqtt.beginQueue(1024, 4));
+  CHECK(mqtt.connect() == 0);
+
+  cl.hold = true;
+  CHECK(mqtt.publishQueued("/device/dev/s", "{\"seq\":0,\"t\":0}", 1));
+  while (!cl.in_write) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  // The write is held for 300 ms
+  std::thread release([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    cl.hold = false;
+  });
+  int64_t a = nowUs();
+  CHECK(mqtt.connected());
+  CHECK(mqtt.readSubscription(10) == NULL);
+  int64_t d = nowUs() - a;
+  CHECK(d < 100000);
+  release.join();
+
+  while (mqtt.queued()) {
+    mqtt.readSubscription(10);
+  }
+  printf("%-28s connected() and readSubscription() took %lld us during a held write\n",
+         "loop during a write", (long long)d);
+
+  mqtt.endQueue();
+  cl.stop();
+  br.stop();
+}
+
+int main(int argc, char **argv) {
+  setvbuf(stdout, NULL, _IONBF, 0);
+  if (argc > 1) rtt_ms = atoi(argv[1]);
+  if (argc > 2) write_us = atoi(argv[2]);
+  int n = argc > 3 ? atoi(argv[3]) : 1000;
+  printf("rtt %d ms, %d us a write, %d messages in bursts of 20 every 50 ms\n", rtt_ms, write_us, n);
+
+  Result r = print("sync QoS 0", run(SYNC, 0, n, 20, 50));
+  CHECK((int)r.got == n && r.writes == n);
+
+  r = print("queued QoS 0", run(QUEUED, 0, n, 20, 50));
+  CHECK((int)r.got == n && r.writes < n);
+
+  r = print("sync QoS 1", run(SYNC, 1, n / 10, 20, 50));
+  CHECK((int)r.got == n / 10 && r.sync_failed == 0 && r.bad_ids == 0);
+
+  r = print("queued QoS 1, window 8", run(QUEUED, 1, n, 20, 50));
+  CHECK((int)r.got == n && r.bad_ids == 0);
+
+  // Sync publishes find their PUBACK among the ones of the queue, the ids
+  // of both never clash
+  r = print("queued + sync QoS 1", run(MIXED, 1, n, 20, 50));
+  CHECK((int)r.got == n && r.sync_failed == 0 && r.bad_ids == 0);
+
+  // The messages without PUBACK go again after the reconnect, with DUP
+  r = print("queued QoS 1, drop at n/4", run(QUEUED, 1, n, 20, 50, n / 4));
+  CHECK((int)r.got == n && r.dups > 0);
+
+  r = print("queued QoS 0, one burst", run(QUEUED, 0, n, n, 50));
+  CHECK((int)r.got == n);
+
+  testLoopNotBlocked();
+  return 0;
+}
@@ -0,0 +1,67 @@
+#!/bin/bash
+# Build and run the host tests and benchmarks of this folder.
+#
+# A <name>.cpp only uses the headers of src/Blinker/ that do not need the
+# Arduino core, host.h stands in for the rest. A <name>/ folder builds the
+# files of src/ listed in <name>/sources with its own stand-ins of the
+# Arduino core in <name>/shim. <name>/flags has the defines of its C++
+# files (the board), <name>/ldflags the flags of the link.
+#
+#   test/host/run.sh            all of them
+#   test/host/run.sh <name>...  these only
+
+cd "$(dirname "$0")" || exit 1
+CC=${CC:-gcc}
+CXX=${CXX:-g++}
+OUT=${OUT:-/tmp/blinker_host_test}
+mkdir -p "$OUT"
+
+names=("$@")
+if [ ${#names[@]} -eq 0 ]; then
+  for f in *.cpp */; do
+    names+=("$(basename "$f" .cpp)")
+  done
+fi
+
+build() {
+  local name=$1
+
+  if [ ! -d "$name" ]; then
+    $CXX -O2 -std=gnu++17 -Wall -I. -I../../src/Blinker -I../../src/modules/ArduinoJson \
+      "$name.cpp" -o "$OUT/$name"
+    return
+  fi
+
+  local srcs=("$name"/*.cpp) incs=(-I"$name/shim") flags=() ldflags=() objs=() src obj warn
+  [ -f "$name/flags" ] && flags=($(cat "$name/flags"))
+  [ -f "$name/ldflags" ] && ldflags=($(cat "$name/ldflags"))
+  for src in $(cat "$name/sources"); do
+    srcs+=("../../src/$src")
+    incs+=(-I"../../src/$(dirname "$src")")
+  done
+
+  mkdir -p "$OUT/$name.o"
+  for src in "${srcs[@]}"; do
+    obj="$OUT/$name.o/$(basename "$src").o"
+    # The modules keep the warnings of their upstream code
+    warn=-Wall
+    case "$src" in ../../src/*) warn=-w ;; esac
+    case "$src" in
+      *.c) $CC -O2 $warn "${incs[@]}" -c "$src" -o "$obj" || return 1 ;;
+      *) $CXX -O2 -std=gnu++17 $warn "${flags[@]}" "${incs[@]}" -c "$src" -o "$obj" || return 1 ;;
+    esac
+    objs+=("$obj")
+  done
+  $CXX "${objs[@]}" -pthread "${ldflags[@]}" -o "$OUT/$name"
+}
+
+failed=0
+for name in "${names[@]}"; do
+  echo "=== $name"
+  if ! build "$name"; then
+    failed=1
+    continue
+  fi
+  "$OUT/$name" || failed=1
+done
+exit $failed
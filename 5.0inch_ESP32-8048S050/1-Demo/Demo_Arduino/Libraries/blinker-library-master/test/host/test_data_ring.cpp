@@ -0,0 +1,123 @@
+// BlinkerDataRing with an hour of a simulated power meter at 1 Hz (volts,
+// amps, watts, kWh with 2 decimals): round trip, size against the JSON
+// text of the upload, wrap of a small ring and the push rate.
+#include "host.h"
+#include "BlinkerDataRing.h"
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+// BLINKER_MAX_DATA_BYTES on an ESP32 with and without PSRAM
+static const uint16_t psram_bytes = 12288;
+static const uint16_t small_bytes = 256;
+
+static const int N = 3600;
+static std::vector<uint32_t> times;
+static std::vector<int64_t> values[4];
+
+// The samples of the ring have to be the last ones pushed of values[c]
+static bool same(const BlinkerDataRing & ring, int c)
+{
+    BlinkerDataRing::cursor_t cur;
+    uint32_t t;
+    int64_t v;
+    int i = N - ring.count();
+
+    ring.first(&cur);
+    while (ring.next(&cur, &t, &v))
+    {
+        if (t != times[i] || v != values[c][i]) return false;
+        i++;
+    }
+    return i == N;
+}
+
+int main()
+{
+    const char * names[] = { "voltage", "current", "power", "energy" };
+    double volts = 230, amps = 2.0, kwh = 1234.5;
+    uint32_t now = 1700000000;
+
+    srand(3);
+    for (int i = 0; i < N; i++)
+    {
+        volts += (rand() % 21 - 10) * 0.01;
+        amps += (rand() % 11 - 5) * 0.01;
+        if (amps < 0) amps = 0;
+        if (rand() % 300 == 0) amps += 3;
+        if (rand() % 300 == 0) amps = 0.5;
+        double watts = volts * amps;
+        kwh += watts / 3600000.0;
+
+        times.push_back(now++);
+        values[0].push_back(llround(volts * 100));
+        values[1].push_back(llround(amps * 100));
+        values[2].push_back(llround(watts * 100));
+        values[3].push_back(llround(kwh * 100));
+    }
+
+    // The PSRAM ring keeps the whole hour of every channel
+    for (int c = 0; c < 4; c++)
+    {
+        BlinkerDataRing ring;
+        CHECK(ring.begin(psram_bytes));
+
+        size_t text = 0;
+        for (int i = 0; i < N; i++)
+        {
+            ring.push(times[i], values[c][i]);
+            char b[48];
+            text += snprintf(b, sizeof(b), "[%u,%.2f],", times[i], values[c][i] / 100.0);
+        }
+        CHECK(ring.count() == N);
+        CHECK(same(ring, c));
+
+        printf("%-8s %u B, %.2f B/sample, JSON %zu B (%.1fx)\n", names[c], ring.bytes(),
+            ring.bytes() / (double)N, text, text / (double)ring.bytes());
+    }
+
+    // A full ring drops the oldest samples
+    {
+        BlinkerDataRing ring;
+        CHECK(ring.begin(small_bytes));
+        for (int i = 0; i < N; i++) ring.push(times[i], values[2][i]);
+        CHECK(ring.count() > 0 && ring.count() < N);
+        CHECK(ring.bytes() <= small_bytes + 12);
+        CHECK(same(ring, 2));
+        printf("%u B ring keeps the last %u samples\n", small_bytes, ring.count());
+
+        ring.clear();
+        CHECK(ring.count() == 0 && ring.bytes() == 0);
+    }
+
+    // Large steps take the longest records
+    {
+        BlinkerDataRing ring;
+        CHECK(!ring.begin(16));
+        CHECK(ring.begin(64));
+        int64_t v[] = { 0, INT64_MAX / 2, INT64_MIN / 2, -1, 1 };
+        for (int i = 0; i < 5; i++) ring.push(i * 100000, v[i]);
+
+        BlinkerDataRing::cursor_t cur;
+        uint32_t t;
+        int64_t got;
+        int n = 5 - ring.count();
+        ring.first(&cur);
+        while (ring.next(&cur, &t, &got))
+        {
+            CHECK(t == (uint32_t)n * 100000 && got == v[n]);
+            n++;
+        }
+        CHECK(n == 5);
+    }
+
+    BlinkerDataRing ring;
+    CHECK(ring.begin(4096));
+    const int M = 5000000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < M; i++) ring.push(times[i % N] + (i / N) * N, values[0][i % N]);
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("push, ring full: %.1f M samples/s\n", M / s / 1e6);
+    return 0;
+}
@@ -0,0 +1,24 @@
+// Definitions of the stand-ins in shim/
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp32/sha.h>
+
+// libsha1 is only built without a board
+#undef ESP32
+extern "C" {
+#include "libsha1/libsha1.h"
+}
+#define ESP32
+
+EspClass ESP;
+unsigned long g_writes;
+unsigned long g_delays;
+unsigned long g_writeBytes;
+
+void esp_sha(esp_sha_type, const unsigned char * input, size_t ilen, unsigned char * output)
+{
+    SHA1_CTX ctx;
+    SHA1Init(&ctx);
+    SHA1Update(&ctx, input, ilen);
+    SHA1Final(output, &ctx);
+}
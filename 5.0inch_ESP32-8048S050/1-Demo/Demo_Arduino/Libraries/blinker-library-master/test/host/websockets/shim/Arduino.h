@@ -0,0 +1,75 @@
+// Host stand-ins of the Arduino API used by the WebSockets module
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <thread>
+
+#define bit(b) (1UL << (b))
+
+inline unsigned long micros()
+{
+    using namespace std::chrono;
+    static auto t0 = steady_clock::now();
+    return duration_cast<microseconds>(steady_clock::now() - t0).count();
+}
+inline unsigned long millis() { return micros() / 1000; }
+extern unsigned long g_delays;
+inline void delay(unsigned long ms) { g_delays++; std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void yield() {}
+inline long random(long max) { return rand() % max; }
+inline void randomSeed(unsigned long s) { srand(s); }
+
+class String {
+  public:
+    std::string s;
+    String() {}
+    String(const char * c) : s(c ? c : "") {}
+    String(const std::string & x) : s(x) {}
+    String(int v) : s(std::to_string(v)) {}
+    String(unsigned v) : s(std::to_string(v)) {}
+    String(long v) : s(std::to_string(v)) {}
+    String(unsigned long v) : s(std::to_string(v)) {}
+    const char * c_str() const { return s.c_str(); }
+    unsigned length() const { return s.size(); }
+    bool reserve(unsigned n) { s.reserve(n); return true; }
+    bool equalsIgnoreCase(const String & o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+    int indexOf(char c, unsigned from = 0) const { size_t p = s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+    int indexOf(const String & o, unsigned from = 0) const { size_t p = s.find(o.s, from); return p == std::string::npos ? -1 : (int)p; }
+    String substring(unsigned a) const { return a < s.size() ? s.substr(a) : std::string(); }
+    String substring(unsigned a, unsigned b) const { return a < s.size() ? s.substr(a, b - a) : std::string(); }
+    void remove(unsigned i) { if(i < s.size()) s.erase(i); }
+    void remove(unsigned i, unsigned n) { if(i < s.size()) s.erase(i, n); }
+    long toInt() const { return atol(s.c_str()); }
+    void toLowerCase() { for(auto & c : s) c = tolower(c); }
+    void trim()
+    {
+        size_t a = s.find_first_not_of(" \t\r\n");
+        size_t b = s.find_last_not_of(" \t\r\n");
+        s = a == std::string::npos ? std::string() : s.substr(a, b - a + 1);
+    }
+    bool startsWith(const String & o) const { return s.compare(0, o.s.size(), o.s) == 0; }
+    char operator[](unsigned i) const { return s[i]; }
+    String & operator+=(const String & o) { s += o.s; return *this; }
+    String & operator+=(const char * o) { s += o; return *this; }
+    String & operator+=(char c) { s += c; return *this; }
+    String & operator+=(int v) { s += std::to_string(v); return *this; }
+    String & operator+=(unsigned v) { s += std::to_string(v); return *this; }
+    bool operator==(const String & o) const { return s == o.s; }
+    bool operator==(const char * o) const { return s == o; }
+    bool operator!=(const String & o) const { return s != o.s; }
+};
+inline String operator+(const String & a, const String & b) { return String(a.s + b.s); }
+inline String operator+(const String & a, const char * b) { return String(a.s + b); }
+inline String operator+(const char * a, const String & b) { return String(a + b.s); }
+
+struct EspClass {
+    uint32_t getFreeHeap() { return 200000; }
+};
+extern EspClass ESP;
+#define READ_PERI_REG(reg) ((uint32_t)rand())
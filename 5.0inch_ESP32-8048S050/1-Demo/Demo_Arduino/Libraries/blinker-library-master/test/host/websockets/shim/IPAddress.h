@@ -0,0 +1,8 @@
+#pragma once
+#include <stdint.h>
+class IPAddress {
+  public:
+    IPAddress(uint32_t a = 0) : addr(a) {}
+    operator uint32_t() const { return addr; }
+    uint32_t addr;
+};
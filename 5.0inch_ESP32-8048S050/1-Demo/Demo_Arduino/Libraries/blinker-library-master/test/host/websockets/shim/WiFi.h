@@ -0,0 +1,83 @@
+// WiFiClient on a socket descriptor, counts the writes
+#pragma once
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+
+extern unsigned long g_writes;
+extern unsigned long g_writeBytes;
+
+class WiFiClient {
+  public:
+    int fd = -1;
+    WiFiClient() {}
+    explicit WiFiClient(int f) : fd(f) {}
+    virtual ~WiFiClient() {}
+    int available()
+    {
+        int n = 0;
+        if(fd < 0 || ioctl(fd, FIONREAD, &n) < 0) return 0;
+        return n;
+    }
+    uint8_t connected()
+    {
+        if(fd < 0) return 0;
+        char c;
+        ssize_t r = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+        return r > 0 || (r < 0 && errno == EAGAIN);
+    }
+    int read(uint8_t * buf, size_t n)
+    {
+        ssize_t r = ::recv(fd, buf, n, MSG_DONTWAIT);
+        return r < 0 ? -1 : (int)r;
+    }
+    int read()
+    {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+    String readStringUntil(char end)
+    {
+        String s;
+        uint8_t c;
+        while(::recv(fd, &c, 1, 0) == 1 && c != end) s += (char)c;
+        return s;
+    }
+    size_t write(const uint8_t * buf, size_t n)
+    {
+        g_writes++;
+        size_t done = 0;
+        while(done < n) {
+            ssize_t w = ::send(fd, buf + done, n - done, MSG_NOSIGNAL);
+            if(w <= 0) break;
+            done += w;
+        }
+        g_writeBytes += done;
+        return done;
+    }
+    size_t write(const char * s) { return write((const uint8_t *)s, strlen(s)); }
+    void flush() {}
+    void stop()
+    {
+        if(fd >= 0) ::close(fd);
+        fd = -1;
+    }
+    int setNoDelay(bool) { return 0; }
+    void setTimeout(unsigned long) {}
+    IPAddress remoteIP() { return IPAddress(0x0100007F); }
+    operator bool() { return fd >= 0; }
+};
+
+class WiFiServer {
+  public:
+    WiFiServer(int, int = 4) {}
+    void begin() {}
+    void close() {}
+    void end() {}
+    bool hasClient() { return false; }
+    WiFiClient available() { return WiFiClient(); }
+};
@@ -0,0 +1,4 @@
+#pragma once
+#include <stddef.h>
+enum esp_sha_type { SHA1 };
+void esp_sha(esp_sha_type type, const unsigned char * input, size_t ilen, unsigned char * output);
@@ -0,0 +1,273 @@
+// WebSocketsServer built for the ESP32 against the stand-ins in shim/, with
+// its clients on TCP loopback: maskPayload() against a byte loop, the
+// payload of streamed frames for several chunk sizes, and the broadcast and
+// receive paths with their mallocs and writes.
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WebSocketsServer.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define CHECK(cond) do { \
+    if(!(cond)) { printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); exit(1); } \
+} while(0)
+
+// malloc() calls of the module (linked with --wrap=malloc), the buffers
+// that come from the ESP32 heap
+extern "C" void * __real_malloc(size_t);
+static std::atomic<unsigned long> g_mallocs;
+extern "C" void * __wrap_malloc(size_t n) {
+    g_mallocs++;
+    return __real_malloc(n);
+}
+
+static WebSocketsServer server(81);
+
+// Received payload: 'a'..'z' over the whole message
+static std::atomic<unsigned long> rxBytes;
+static unsigned long rxMessages, rxPieces, rxOffset, rxErrors;
+static WStype_t rxLast = WStype_DISCONNECTED;
+
+static void onEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length) {
+    bool data = type == WStype_TEXT || type == WStype_BIN ||
+                (type >= WStype_FRAGMENT_TEXT_START && type <= WStype_FRAGMENT_FIN);
+    if(!data) return;
+
+    bool first = type == WStype_TEXT || type == WStype_BIN || type == WStype_FRAGMENT_TEXT_START ||
+                 type == WStype_FRAGMENT_BIN_START;
+    bool last = type == WStype_TEXT || type == WStype_BIN || type == WStype_FRAGMENT_FIN;
+
+    // Pieces follow START, FRAGMENT ... FIN
+    bool open = rxLast >= WStype_FRAGMENT_TEXT_START && rxLast <= WStype_FRAGMENT;
+    if(first == open) rxErrors++;
+    rxLast = type;
+
+    if(first) rxOffset = 0;
+    for(size_t i = 0; i < length; i++) {
+        if(payload[i] != 'a' + (rxOffset + i) % 26) rxErrors++;
+    }
+    if(payload[length] != 0) rxErrors++;
+    rxOffset += length;
+    rxPieces++;
+    rxBytes += length;
+    if(last) rxMessages++;
+}
+
+// A client on TCP loopback, after the handshake
+static int connectClient() {
+    static int listener = -1;
+    static struct sockaddr_in addr;
+    if(listener < 0) {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listener, (struct sockaddr *)&addr, sizeof(addr));
+        socklen_t l = sizeof(addr);
+        getsockname(listener, (struct sockaddr *)&addr, &l);
+        listen(listener, 8);
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    CHECK(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    int sfd  = accept(listener, NULL, NULL);
+    int one  = 1;
+    int size = 1 << 20;
+    setsockopt(sfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(sfd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    server.newClient(new WiFiClient(sfd));
+
+    const char * req =
+        "GET / HTTP/1.1\r\nHost: x\r\nConnection: Upgrade\r\nUpgrade: websocket\r\n"
+        "Sec-WebSocket-Version: 13\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n\r\n";
+    send(fd, req, strlen(req), 0);
+    char buf[512];
+    std::string resp;
+    while(resp.find("\r\n\r\n") == std::string::npos) {
+        server.loop();
+        ssize_t r = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if(r > 0) resp.append(buf, r);
+    }
+    CHECK(resp.find(" 101 ") != std::string::npos);
+    return fd;
+}
+
+static std::vector<uint8_t> maskedFrame(uint8_t opcode, size_t len) {
+    std::vector<uint8_t> f;
+    f.push_back(0x80 | opcode);
+    if(len < 126) {
+        f.push_back(0x80 | len);
+    } else if(len < 0xFFFF) {
+        f.push_back(0x80 | 126);
+        f.push_back(len >> 8);
+        f.push_back(len);
+    } else {
+        f.push_back(0x80 | 127);
+        for(int i = 7; i >= 0; i--) f.push_back((uint64_t)len >> (8 * i));
+    }
+    uint8_t key[4] = { 0x12, 0x34, 0x56, 0x78 };
+    f.insert(f.end(), key, key + 4);
+    for(size_t i = 0; i < len; i++) f.push_back(('a' + i % 26) ^ key[i % 4]);
+    return f;
+}
+
+struct Access : WebSockets {
+    static void mask(uint8_t * d, size_t n, const uint8_t * k, size_t offset = 0) {
+        maskPayload(d, n, k, offset);
+    }
+};
+
+// Every alignment, key phase and length against the byte loop, and a
+// payload masked in pieces like the streamed chunks
+static void testMask() {
+    const uint8_t key[4] = { 0x9A, 0x3C, 0x01, 0xF7 };
+    uint8_t buf[96], ref[96];
+
+    for(size_t align = 0; align < 8; align++) {
+        for(size_t offset = 0; offset < 8; offset++) {
+            for(size_t len = 0; len <= 70; len++) {
+                for(size_t i = 0; i < sizeof(buf); i++) buf[i] = ref[i] = i * 7 + 3;
+                for(size_t i = 0; i < len; i++) ref[align + i] ^= key[(offset + i) % 4];
+                Access::mask(buf + align, len, key, offset);
+                CHECK(memcmp(buf, ref, sizeof(buf)) == 0);
+            }
+        }
+    }
+
+    std::vector<uint8_t> whole(5000), pieces;
+    for(size_t i = 0; i < whole.size(); i++) whole[i] = rand();
+    pieces = whole;
+    Access::mask(whole.data(), whole.size(), key);
+    for(size_t off = 0, n; off < pieces.size(); off += n) {
+        n = std::min<size_t>(1 + rand() % 77, pieces.size() - off);
+        Access::mask(pieces.data() + off, n, key, off);
+    }
+    CHECK(whole == pieces);
+
+    static uint8_t data[4097];
+    const int runs      = 20000;
+    unsigned long start = micros();
+    for(int i = 0; i < runs; i++) {
+        for(size_t x = 0; x < 4096; x++) data[1 + x] ^= key[x % 4];
+        asm volatile("" ::"r"(data) : "memory");
+    }
+    unsigned long bytes = micros() - start;
+    start               = micros();
+    for(int i = 0; i < runs; i++) {
+        Access::mask(data + 1, 4096, key);
+        asm volatile("" ::"r"(data) : "memory");
+    }
+    unsigned long words = micros() - start;
+    printf("unmask 4096 B, odd address: byte loop %.0f MB/s, maskPayload %.0f MB/s\n",
+           runs * 4096.0 / bytes, runs * 4096.0 / words);
+}
+
+static void benchBroadcast(int clients, int runs) {
+    std::vector<int> fds;
+    for(int i = 0; i < clients; i++) fds.push_back(connectClient());
+
+    std::atomic<bool> draining(true);
+    std::vector<std::thread> readers;
+    for(int fd : fds) {
+        readers.emplace_back([fd, &draining] {
+            char buf[4096];
+            while(draining) {
+                struct pollfd p = { fd, POLLIN, 0 };
+                if(poll(&p, 1, 10) > 0) recv(fd, buf, sizeof(buf), 0);
+            }
+        });
+    }
+
+    char json[200];
+    g_writes = g_mallocs = 0;
+    unsigned long start  = micros();
+    for(int i = 0; i < runs; i++) {
+        snprintf(json, sizeof(json),
+                 "{\"t\":%d,\"heap\":123456,\"psram\":4000000,\"fps\":%d.5,\"rssi\":-61,\"v\":[1,2,3,4,5,6,7,8]}", i,
+                 i % 60);
+        CHECK(server.broadcastTXT(json));
+    }
+    unsigned long us = micros() - start;
+    printf("broadcast to %d: %.2f us, %.2f writes, %.2f mallocs each\n", clients, (double)us / runs,
+           (double)g_writes / runs, (double)g_mallocs / runs);
+
+    // The frame is built once for all the clients
+    CHECK(g_writes == (unsigned long)clients * runs);
+    CHECK(g_mallocs <= (unsigned long)runs);
+
+    draining = false;
+    for(auto & t : readers) t.join();
+    server.disconnect();
+    for(int fd : fds) close(fd);
+}
+
+// Masked binary frames of len bytes, chunk 0 delivers them whole
+static void testReceive(size_t len, size_t chunk) {
+    server.setStreamChunkSize(chunk);
+    int fd = connectClient();
+    std::vector<uint8_t> frame = maskedFrame(WSop_binary, len);
+
+    unsigned long us = 0, frames = 0;
+    rxBytes    = 0;
+    rxMessages = rxPieces = rxErrors = 0;
+    rxLast                           = WStype_DISCONNECTED;
+    g_mallocs                        = 0;
+
+    for(int round = 0; round < 20; round++) {
+        // The frames are in the socket before the server reads, but one
+        // larger than the socket buffer is written while it reads
+        std::thread writer;
+        int n = 0;
+        if(frame.size() > 150000) {
+            writer = std::thread([&] { send(fd, frame.data(), frame.size(), 0); });
+            n      = 1;
+        } else {
+            for(size_t sent = 0; sent + frame.size() <= 150000; sent += frame.size(), n++) {
+                send(fd, frame.data(), frame.size(), 0);
+            }
+        }
+        frames += n;
+        unsigned long start = micros();
+        while(rxBytes < len * frames) server.loop();
+        us += micros() - start;
+        if(writer.joinable()) writer.join();
+    }
+
+    bool streamed        = chunk && len > chunk;
+    unsigned long pieces = streamed ? (len + chunk - 1) / chunk : 1;
+    printf("receive %6zu B frames, chunk %4zu: %7.1f MB/s, %.3f mallocs a frame, %lu pieces a frame\n", len,
+           chunk, (double)rxBytes / us, (double)g_mallocs / frames, rxPieces / frames);
+    CHECK(rxErrors == 0);
+    CHECK(rxMessages == frames);
+    CHECK(rxPieces == frames * pieces);
+    // Small frames are read on the stack, streamed ones into one buffer
+    if(len <= 200 || streamed) CHECK(g_mallocs <= 1);
+
+    server.disconnect();
+    close(fd);
+}
+
+int main() {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    server.begin();
+    server.onEvent(onEvent);
+
+    testMask();
+    for(int c : { 1, 4, 5 }) benchBroadcast(c, 20000);
+
+    testReceive(64, 0);
+    testReceive(200, 0);
+    testReceive(4096, 0);
+    testReceive(14000, 0);
+    testReceive(14000, 1024);
+    testReceive(200000, 1024);
+    for(size_t chunk : { 250, 1001, 1024 }) testReceive(1003, chunk);
+    return 0;
+}
@@ -46,7 +46,7 @@
  *=========================*/
 
 /*1: use custom malloc/free, 0: use the built-in `lv_mem_alloc()` and `lv_mem_free()`*/
-#define LV_MEM_CUSTOM 1
+#define LV_MEM_CUSTOM 0
 #if LV_MEM_CUSTOM == 0
     /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
     #define LV_MEM_SIZE (64U * 1024U)          /*[bytes]*/
@@ -59,6 +59,20 @@
         #undef LV_MEM_POOL_ALLOC
     #endif
 
+    /*Size of an optional second pool for large allocations (image caches, layers, canvases), e.g. in PSRAM.
+     *Small, frequently used objects stay in the fast pool above. 0: disable*/
+    #define LV_MEM_LARGE_SIZE (2048U * 1024U)
+    #if LV_MEM_LARGE_SIZE
+        /*Allocations of at least this size are served from the large pool first, smaller ones from the fast pool first*/
+        #define LV_MEM_LARGE_THRESHOLD 1024
+        /*Address of the large pool or an allocator to get it. E.g. `heap_caps_malloc(size, MALLOC_CAP_SPIRAM)`*/
+        #define LV_MEM_LARGE_ADR 0     /*0: unused*/
+        #if LV_MEM_LARGE_ADR == 0
+            #define LV_MEM_LARGE_POOL_INCLUDE <esp_heap_caps.h>
+            #define LV_MEM_LARGE_POOL_ALLOC(size) heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+        #endif
+    #endif
+
 #else       /*LV_MEM_CUSTOM*/
     #define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
     #define LV_MEM_CUSTOM_ALLOC   malloc
@@ -66,6 +80,24 @@
     #define LV_MEM_CUSTOM_REALLOC realloc
 #endif     /*LV_MEM_CUSTOM*/
 
+/*Serve small allocations which are created and deleted often (objects, list nodes, animations,
+ *event descriptors) from fixed size slabs of a dedicated arena. Alloc and free are O(1) and
+ *deleting screens doesn't leave holes in the heap. Not available with `LV_ENABLE_GC`.*/
+#define LV_USE_SLAB 1
+#if LV_USE_SLAB
+    /*Size of the arena. When it's full the heap is used.*/
+    #define LV_SLAB_ARENA_SIZE (24U * 1024U)   /*[bytes]*/
+    /*The arena is given to the size classes in pages of this size*/
+    #define LV_SLAB_PAGE_SIZE 1024             /*[bytes]*/
+    /*Larger allocations always use the heap. Multiple of 8, not larger than `LV_SLAB_PAGE_SIZE`.*/
+    #define LV_SLAB_MAX_SIZE 256               /*[bytes]*/
+#endif
+
+/*Operating system to run background work with (e.g. `LV_USE_IMG_ASYNC`).
+ *With an OS `lv_mem_alloc()`, `lv_mem_free()` and `lv_mem_realloc()` are protected by a mutex.
+ *LV_OS_NONE, LV_OS_PTHREAD or LV_OS_FREERTOS*/
+#define LV_USE_OS LV_OS_FREERTOS
+
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
  *You will see an error log message if there wasn't enough buffers. */
 #define LV_MEM_BUF_MAX_NUM 16
@@ -141,7 +173,29 @@
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
  *However the opened images might consume additional RAM.
  *0: to disable caching*/
-#define LV_IMG_CACHE_DEF_SIZE 0
+#define LV_IMG_CACHE_DEF_SIZE 16
+
+/*Limit the memory used by the decoded images in the cache [bytes].
+ *The least recently used images are closed to stay below it. Images which are not decoded to RAM don't count.
+ *The decoded images are allocated with `lv_mem_alloc()` so large ones go to `LV_MEM_LARGE_SIZE` pool if enabled.
+ *0: limit only the number of images*/
+#define LV_IMG_CACHE_DEF_BYTES (768U * 1024U)
+
+/*Decode the images of the non built-in decoders (e.g. PNG, JPG) in a background thread.
+ *A placeholder is drawn until the image is ready, then the image is redrawn.
+ *Needs `LV_USE_OS` and `LV_IMG_CACHE_DEF_SIZE > 0`.*/
+#define LV_USE_IMG_ASYNC 1
+#if LV_USE_IMG_ASYNC
+    /*Max. number of images waiting for or under decoding. If it's full the images are decoded while drawing.*/
+    #define LV_IMG_ASYNC_QUEUE_LEN 8
+    /*Show the images decoded line by line (e.g. split JPG) in bands of this many rows while decoding. 0: don't*/
+    #define LV_IMG_ASYNC_BAND_ROWS 16
+    #define LV_IMG_ASYNC_PLACEHOLDER_COLOR lv_color_hex(0xc0c0c0)
+    /*Worker thread settings*/
+    #define LV_IMG_ASYNC_STACK_SIZE (8 * 1024)   /*[bytes]*/
+    #define LV_IMG_ASYNC_PRIO 1
+    #define LV_IMG_ASYNC_CORE 0                  /*The Arduino loop and so LVGL runs on core 1*/
+#endif
 
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
@@ -293,6 +347,18 @@
     #define LV_SPRINTF_USE_FLOAT 0
 #endif  /*LV_SPRINTF_CUSTOM*/
 
+/*Cache the resolved style properties of each object to make `lv_obj_get_style_prop()` faster.
+ *The cache of an object is dropped when its styles or state change.
+ *If a style used by objects is modified `lv_obj_report_style_change()` has to be called.*/
+#define LV_USE_OBJ_STYLE_CACHE 1
+#if LV_USE_OBJ_STYLE_CACHE
+    /*Number of cached properties per object. Power of 2.
+     *A cache takes 12 + 8 * size bytes on 32 bit MCUs and every drawn object gets one.
+     *16 (140 bytes) still fits into the slabs (`LV_SLAB_MAX_SIZE`), larger caches come from the heap.
+     *Drawing a button needs ~50 properties, so more slots give more hits (~43% with 16, ~90% with 64).*/
+    #define LV_OBJ_STYLE_CACHE_SIZE 16
+#endif
+
 #define LV_USE_USER_DATA 1
 
 /*Garbage Collector settings
@@ -408,6 +474,10 @@
 /*Enable drawing placeholders when glyph dsc is not found*/
 #define LV_USE_FONT_PLACEHOLDER 1
 
+/*Number of glyph widths to cache (power of 2). The widths are used a lot while the texts are measured.
+ *Set 0 to disable*/
+#define LV_FONT_ADV_CACHE_SIZE 256
+
 /*=================
  *  TEXT SETTINGS
  *=================*/
@@ -480,6 +550,7 @@
 #if LV_USE_LABEL
     #define LV_LABEL_TEXT_SELECTION 1 /*Enable selecting text of the label*/
     #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
+    #define LV_LABEL_LAYOUT_CACHE 1   /*Store the line breaks and widths of the text to measure it only when it changes*/
 #endif
 
 #define LV_USE_LINE       1
@@ -555,6 +626,8 @@
 
 #define LV_USE_TILEVIEW   1
 
+#define LV_USE_VLIST      1
+
 #define LV_USE_WIN        1
 
 /*-----------
@@ -694,6 +767,9 @@
 /*1: Enable a published subscriber based messaging system */
 #define LV_USE_MSG 0
 
+/*1: Enable image packs: images converted by `scripts/imgpack.py` and drawn right from flash*/
+#define LV_USE_IMGPACK 1
+
 /*1: Enable Pinyin input method*/
 /*Requires: lv_keyboard*/
 #define LV_USE_IME_PINYIN 0
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+##################################################################
+# Image pack maker for lv_imgpack
+# Dependencies: (PYTHON-3) Pillow, only for image files:
+#   pip install pillow
+#
+# Converts images to the display's native color format and packs
+# them into one binary which can be flashed to a data partition
+# and drawn by LVGL right from the mapped flash.
+#  - Opaque images become LV_IMG_CF_TRUE_COLOR
+#  - Images with transparent pixels become LV_IMG_CF_RGB565A8 with
+#    16 bit colors (the colors first, then the alpha values). Unlike
+#    LV_IMG_CF_TRUE_COLOR_ALPHA these are blended without copying.
+#    With 32 bit colors they become LV_IMG_CF_TRUE_COLOR_ALPHA.
+#
+# Inputs can be image files (PNG, BMP, ...) or C arrays made by the
+# LVGL image converter or SquareLine Studio in LV_IMG_CF_TRUE_COLOR
+# or LV_IMG_CF_TRUE_COLOR_ALPHA format for the same color depth.
+#
+# usage:
+#   python3 imgpack.py -o assets.bin --depth 16 assets/*.png ui_img_*.c
+#
+# A manifest with the name, size, format and place of each image is
+# written next to the pack (assets.json).
+##################################################################
+import argparse, json, os, re, struct, sys
+
+PACK_MAGIC = b"LVIP"
+PACK_VERSION = 1
+FLAG_16_SWAP = 0x01
+HEADER_FORMAT = "<4sHBBII"
+ENTRY_FORMAT = "<IIIHHB3x"
+DATA_ALIGN = 4
+
+# lv_img_cf_t values
+CF_TRUE_COLOR = 4
+CF_TRUE_COLOR_ALPHA = 5
+CF_RGB565A8 = 20
+CF_NAMES = {CF_TRUE_COLOR: "LV_IMG_CF_TRUE_COLOR",
+            CF_TRUE_COLOR_ALPHA: "LV_IMG_CF_TRUE_COLOR_ALPHA",
+            CF_RGB565A8: "LV_IMG_CF_RGB565A8"}
+
+
+def color_bytes(r, g, b, depth, swap):
+    if depth == 16:
+        c = ((r & 0xf8) << 8) | ((g & 0xfc) << 3) | (b >> 3)
+        return struct.pack(">H" if swap else "<H", c)
+    if depth == 32:
+        return bytes((b, g, r, 0xff))
+    raise ValueError("unsupported color depth: %d" % depth)
+
+
+def convert_image_file(path, depth, swap):
+    """Return (w, h, colors, alphas or None) of an image file"""
+    try:
+        from PIL import Image
+    except ImportError:
+        raise ValueError("Pillow is needed for %s, install it with: pip install pillow" % path)
+    im = Image.open(path).convert("RGBA")
+    w, h = im.size
+    colors = bytearray()
+    alphas = bytearray()
+    px = im.tobytes()
+    for i in range(0, len(px), 4):
+        colors += color_bytes(px[i], px[i + 1], px[i + 2], depth, swap)
+        alphas.append(px[i + 3])
+    if min(alphas) == 0xff:
+        alphas = None
+    return w, h, colors, alphas
+
+
+def color_cond(cond, depth, swap):
+    """Evaluate the #if of a color format section of a C array.
+    Only LV_COLOR_DEPTH and LV_COLOR_16_SWAP compared with == or != to
+    a number, joined by && or ||, are understood."""
+    values = {"LV_COLOR_DEPTH": depth, "LV_COLOR_16_SWAP": int(swap)}
+
+    def term(t):
+        t = t.strip()
+        while t.startswith("(") and t.endswith(")"):
+            t = t[1:-1].strip()
+        m = re.fullmatch(r"(LV_COLOR_DEPTH|LV_COLOR_16_SWAP)\s*(==|!=)\s*(\d+)", t)
+        if not m:
+            raise ValueError("unsupported condition: #if " + cond)
+        equal = values[m.group(1)] == int(m.group(3))
+        return equal if m.group(2) == "==" else not equal
+
+    expr = re.split(r"/[/*]", cond)[0].strip()
+    if expr.startswith("(") and expr.endswith(")") and expr.count("(") == 1:
+        expr = expr[1:-1]
+    return any(all(term(t) for t in part.split("&&")) for part in expr.split("||"))
+
+
+def convert_c_array(path, depth, swap):
+    """Return (name, w, h, colors, alphas or None) of an LVGL C array.
+    The data has to be made for the same color depth (and byte order)"""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        src = f.read()
+
+    m = re.search(r"lv_img_dsc_t\s+(\w+)\s*=\s*\{(.*?)\};", src, re.S)
+    if not m:
+        raise ValueError("no lv_img_dsc_t in " + path)
+    name, fields = m.group(1), m.group(2)
+
+    def field(key):
+        f = re.search(r"\.header\." + key + r"\s*=\s*(\w+)", fields)
+        if not f:
+            raise ValueError("no header.%s in %s" % (key, path))
+        return f.group(1)
+
+    w, h, cf = int(field("w"), 0), int(field("h"), 0), field("cf")
+    m = re.search(r"\.data\s*=\s*(\w+)", fields)
+    if not m:
+        raise ValueError("no .data in " + path)
+    data_name = m.group(1)
+
+    # The arrays might have per color format sections, use the right one
+    m = re.search(r"\b" + data_name + r"\s*\[\s*\]\s*=\s*\{(.*?)\};", src, re.S)
+    if not m:
+        raise ValueError("no %s[] array in %s" % (data_name, path))
+    body = m.group(1)
+    sections = re.split(r"#if\s+([^\n]*LV_COLOR_DEPTH[^\n]*)\n", body)
+    if len(sections) > 1:
+        body = ""
+        for i in range(1, len(sections), 2):
+            if color_cond(sections[i], depth, swap):
+                body = sections[i + 1].split("#endif")[0]
+    raw = bytes(int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]{1,2}\b", body))
+
+    px_size = depth // 8
+    if cf == "LV_IMG_CF_TRUE_COLOR":
+        if len(raw) < w * h * px_size:
+            raise ValueError("%s has no data for %d bit colors" % (path, depth))
+        return name, w, h, bytearray(raw[:w * h * px_size]), None
+    if cf == "LV_IMG_CF_TRUE_COLOR_ALPHA":
+        # The alpha byte is after the color, with 32 bit colors in place of the color's alpha
+        px_alpha_size = 4 if depth == 32 else px_size + 1
+        if len(raw) < w * h * px_alpha_size:
+            raise ValueError("%s has no data for %d bit colors" % (path, depth))
+        colors = bytearray()
+        alphas = bytearray()
+        for i in range(w * h):
+            px = raw[i * px_alpha_size:(i + 1) * px_alpha_size]
+            colors += color_bytes(px[2], px[1], px[0], depth, swap) if depth == 32 else px[:px_size]
+            alphas.append(px[px_alpha_size - 1])
+        if min(alphas) == 0xff:
+            alphas = None
+        return name, w, h, colors, alphas
+    raise ValueError("%s: %s is not supported, only true color images" % (path, cf))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack images for lv_imgpack")
+    parser.add_argument("inputs", nargs="+", help="image files or LVGL C arrays")
+    parser.add_argument("-o", "--output", required=True, help="the pack to create")
+    parser.add_argument("--depth", type=int, choices=(16, 32), default=16, help="LV_COLOR_DEPTH")
+    parser.add_argument("--swap", action="store_true", help="LV_COLOR_16_SWAP")
+    parser.add_argument("--max-size", type=lambda v: int(v, 0), help="size of the partition, fail if it's larger")
+    args = parser.parse_args()
+
+    images = {}
+    for path in args.inputs:
+        try:
+            if path.endswith(".c"):
+                name, w, h, colors, alphas = convert_c_array(path, args.depth, args.swap)
+            else:
+                name = os.path.splitext(os.path.basename(path))[0]
+                w, h, colors, alphas = convert_image_file(path, args.depth, args.swap)
+        except (OSError, ValueError) as e:
+            sys.exit("error: %s" % e)
+        if name in images:
+            sys.exit("error: %s and %s are both called %s" % (images[name]["source"], path, name))
+        if alphas is None:
+            cf, data = CF_TRUE_COLOR, colors
+        elif args.depth == 16:
+            cf, data = CF_RGB565A8, colors + alphas
+        else:
+            # LV_IMG_CF_RGB565A8 is only for 16 bit colors
+            for i, a in enumerate(alphas):
+                colors[i * 4 + 3] = a
+            cf, data = CF_TRUE_COLOR_ALPHA, colors
+        images[name] = dict(name=name, source=path, w=w, h=h, cf=cf, data=bytes(data))
+
+    # The runtime looks up the names with binary search
+    names = sorted(images, key=lambda n: n.encode("utf-8"))
+
+    header_size = struct.calcsize(HEADER_FORMAT)
+    entry_size = struct.calcsize(ENTRY_FORMAT)
+    name_table = bytearray()
+    name_ofs = {}
+    for n in names:
+        name_ofs[n] = header_size + entry_size * len(names) + len(name_table)
+        name_table += n.encode("utf-8") + b"\0"
+
+    ofs = header_size + entry_size * len(names) + len(name_table)
+    body = bytearray()
+    for n in names:
+        pad = -(ofs + len(body)) % DATA_ALIGN
+        body += b"\0" * pad
+        images[n]["offset"] = ofs + len(body)
+        body += images[n]["data"]
+    size = ofs + len(body)
+
+    if args.max_size is not None and size > args.max_size:
+        sys.exit("error: the pack is %d bytes, larger than %d" % (size, args.max_size))
+
+    pack = bytearray(struct.pack(HEADER_FORMAT, PACK_MAGIC, PACK_VERSION, args.depth,
+                                 FLAG_16_SWAP if args.swap and args.depth == 16 else 0, len(names), size))
+    for n in names:
+        img = images[n]
+        pack += struct.pack(ENTRY_FORMAT, name_ofs[n], img["offset"], len(img["data"]), img["w"], img["h"], img["cf"])
+    pack += name_table
+    pack += body
+
+    with open(args.output, "wb") as f:
+        f.write(pack)
+
+    manifest = dict(version=PACK_VERSION, color_depth=args.depth, swap=bool(args.swap and args.depth == 16),
+                    size=size, images=[dict(name=n, source=images[n]["source"], w=images[n]["w"], h=images[n]["h"],
+                                            cf=CF_NAMES[images[n]["cf"]], offset=images[n]["offset"],
+                                            size=len(images[n]["data"])) for n in names])
+    manifest_path = os.path.splitext(args.output)[0] + ".json"
+    with open(manifest_path, "w") as f:
+        json.dump(manifest, f, indent=2)
+        f.write("\n")
+
+    print("%s: %d images, %d bytes (manifest: %s)" % (args.output, len(names), size, manifest_path))
+
+
+if __name__ == "__main__":
+    main()
@@ -8,6 +8,7 @@
  *********************/
 #include "lv_obj.h"
 #include "lv_indev.h"
+#include "../misc/lv_slab.h"
 
 /*********************
  *      DEFINES
@@ -166,8 +167,8 @@ struct _lv_event_dsc_t * lv_obj_add_event_cb(lv_obj_t * obj, lv_event_cb_t event
     lv_obj_allocate_spec_attr(obj);
 
     obj->spec_attr->event_dsc_cnt++;
-    obj->spec_attr->event_dsc = lv_mem_realloc(obj->spec_attr->event_dsc,
-                                               obj->spec_attr->event_dsc_cnt * sizeof(lv_event_dsc_t));
+    obj->spec_attr->event_dsc = lv_slab_realloc(obj->spec_attr->event_dsc,
+                                                obj->spec_attr->event_dsc_cnt * sizeof(lv_event_dsc_t));
     LV_ASSERT_MALLOC(obj->spec_attr->event_dsc);
 
     obj->spec_attr->event_dsc[obj->spec_attr->event_dsc_cnt - 1].cb = event_cb;
@@ -190,8 +191,8 @@ bool lv_obj_remove_event_cb(lv_obj_t * obj, lv_event_cb_t event_cb)
                 obj->spec_attr->event_dsc[i] = obj->spec_attr->event_dsc[i + 1];
             }
             obj->spec_attr->event_dsc_cnt--;
-            obj->spec_attr->event_dsc = lv_mem_realloc(obj->spec_attr->event_dsc,
-                                                       obj->spec_attr->event_dsc_cnt * sizeof(lv_event_dsc_t));
+            obj->spec_attr->event_dsc = lv_slab_realloc(obj->spec_attr->event_dsc,
+                                                        obj->spec_attr->event_dsc_cnt * sizeof(lv_event_dsc_t));
             LV_ASSERT_MALLOC(obj->spec_attr->event_dsc);
             return true;
         }
@@ -215,8 +216,8 @@ bool lv_obj_remove_event_cb_with_user_data(lv_obj_t * obj, lv_event_cb_t event_c
                 obj->spec_attr->event_dsc[i] = obj->spec_attr->event_dsc[i + 1];
             }
             obj->spec_attr->event_dsc_cnt--;
-            obj->spec_attr->event_dsc = lv_mem_realloc(obj->spec_attr->event_dsc,
-                                                       obj->spec_attr->event_dsc_cnt * sizeof(lv_event_dsc_t));
+            obj->spec_attr->event_dsc = lv_slab_realloc(obj->spec_attr->event_dsc,
+                                                        obj->spec_attr->event_dsc_cnt * sizeof(lv_event_dsc_t));
             LV_ASSERT_MALLOC(obj->spec_attr->event_dsc);
             return true;
         }
@@ -240,8 +241,8 @@ bool lv_obj_remove_event_dsc(lv_obj_t * obj, struct _lv_event_dsc_t * event_dsc)
                 obj->spec_attr->event_dsc[i] = obj->spec_attr->event_dsc[i + 1];
             }
             obj->spec_attr->event_dsc_cnt--;
-            obj->spec_attr->event_dsc = lv_mem_realloc(obj->spec_attr->event_dsc,
-                                                       obj->spec_attr->event_dsc_cnt * sizeof(lv_event_dsc_t));
+            obj->spec_attr->event_dsc = lv_slab_realloc(obj->spec_attr->event_dsc,
+                                                        obj->spec_attr->event_dsc_cnt * sizeof(lv_event_dsc_t));
             LV_ASSERT_MALLOC(obj->spec_attr->event_dsc);
             return true;
         }
@@ -18,6 +18,7 @@
 #include "../misc/lv_timer.h"
 #include "../misc/lv_async.h"
 #include "../misc/lv_fs.h"
+#include "../misc/lv_slab.h"
 #include "../misc/lv_gc.h"
 #include "../misc/lv_math.h"
 #include "../misc/lv_log.h"
@@ -61,6 +62,7 @@ static void draw_scrollbar(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx);
 static lv_res_t scrollbar_init_draw_dsc(lv_obj_t * obj, lv_draw_rect_dsc_t * dsc);
 static bool obj_valid_child(const lv_obj_t * parent, const lv_obj_t * obj_to_find);
 static void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state);
+static bool depends_on_parent_size(lv_obj_t * obj, bool parent_rtl);
 
 /**********************
  *  STATIC VARIABLES
@@ -104,6 +106,8 @@ void lv_init(void)
     /*Initialize the misc modules*/
     lv_mem_init();
 
+    lv_slab_init();
+
     _lv_timer_core_init();
 
     _lv_fs_init();
@@ -138,6 +142,9 @@ void lv_init(void)
     _lv_img_decoder_init();
 #if LV_IMG_CACHE_DEF_SIZE
     lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+#endif
+#if LV_USE_IMG_ASYNC
+    _lv_img_async_init();
 #endif
     /*Test if the IDE has UTF-8 encoding*/
     char * txt = "Á";
@@ -190,6 +197,7 @@ void lv_deinit(void)
     _lv_gc_clear_roots();
 
     lv_disp_set_default(NULL);
+    lv_slab_deinit();
     lv_mem_deinit();
     lv_initialized = false;
 
@@ -343,7 +351,7 @@ void lv_obj_allocate_spec_attr(lv_obj_t * obj)
     if(obj->spec_attr == NULL) {
         static uint32_t x = 0;
         x++;
-        obj->spec_attr = lv_mem_alloc(sizeof(_lv_obj_spec_attr_t));
+        obj->spec_attr = lv_slab_alloc(sizeof(_lv_obj_spec_attr_t));
         LV_ASSERT_MALLOC(obj->spec_attr);
         if(obj->spec_attr == NULL) return;
 
@@ -448,15 +456,15 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
 
     if(obj->spec_attr) {
         if(obj->spec_attr->children) {
-            lv_mem_free(obj->spec_attr->children);
+            lv_slab_free(obj->spec_attr->children);
             obj->spec_attr->children = NULL;
         }
         if(obj->spec_attr->event_dsc) {
-            lv_mem_free(obj->spec_attr->event_dsc);
+            lv_slab_free(obj->spec_attr->event_dsc);
             obj->spec_attr->event_dsc = NULL;
         }
 
-        lv_mem_free(obj->spec_attr);
+        lv_slab_free(obj->spec_attr);
         obj->spec_attr = NULL;
     }
 }
@@ -822,11 +830,13 @@ static void lv_obj_event(const lv_obj_class_t * class_p, lv_event_t * e)
             lv_obj_mark_layout_as_dirty(obj);
         }
 
+        /*Refresh only the children whose size or position is calculated from the size of this object*/
+        bool rtl = lv_obj_get_style_base_dir(obj, LV_PART_MAIN) == LV_BASE_DIR_RTL;
         uint32_t i;
         uint32_t child_cnt = lv_obj_get_child_cnt(obj);
         for(i = 0; i < child_cnt; i++) {
             lv_obj_t * child = obj->spec_attr->children[i];
-            lv_obj_mark_layout_as_dirty(child);
+            if(depends_on_parent_size(child, rtl)) lv_obj_mark_layout_as_dirty(child);
         }
     }
     else if(code == LV_EVENT_CHILD_CHANGED) {
@@ -866,6 +876,9 @@ static void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state)
     /*If there is no difference in styles there is nothing else to do*/
     if(cmp_res == _LV_STYLE_STATE_CMP_SAME) return;
 
+    /*The children might inherit the new values*/
+    _lv_obj_style_cache_drop(obj, LV_STYLE_PROP_ANY);
+
     _lv_obj_style_transition_dsc_t * ts = lv_mem_buf_get(sizeof(_lv_obj_style_transition_dsc_t) * STYLE_TRANSITION_MAX);
     lv_memset_00(ts, sizeof(_lv_obj_style_transition_dsc_t) * STYLE_TRANSITION_MAX);
     uint32_t tsi = 0;
@@ -926,6 +939,33 @@ static void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state)
     }
 }
 
+/**
+ * Tell if the size or the position of an object is calculated from the size of its parent.
+ * The position of the objects positioned by a layout is set by the parent's layout.
+ */
+static bool depends_on_parent_size(lv_obj_t * obj, bool parent_rtl)
+{
+    if(LV_COORD_IS_PCT(lv_obj_get_style_width(obj, LV_PART_MAIN)) ||
+       LV_COORD_IS_PCT(lv_obj_get_style_height(obj, LV_PART_MAIN)) ||
+       LV_COORD_IS_PCT(lv_obj_get_style_min_width(obj, LV_PART_MAIN)) ||
+       LV_COORD_IS_PCT(lv_obj_get_style_max_width(obj, LV_PART_MAIN)) ||
+       LV_COORD_IS_PCT(lv_obj_get_style_min_height(obj, LV_PART_MAIN)) ||
+       LV_COORD_IS_PCT(lv_obj_get_style_max_height(obj, LV_PART_MAIN))) {
+        return true;
+    }
+
+    if(lv_obj_is_layout_positioned(obj)) return false;
+
+    /*The right aligned objects are moved if the parent gets wider*/
+    if(parent_rtl) return true;
+
+    lv_align_t align = lv_obj_get_style_align(obj, LV_PART_MAIN);
+    if(align != LV_ALIGN_DEFAULT && align != LV_ALIGN_TOP_LEFT) return true;
+
+    return LV_COORD_IS_PCT(lv_obj_get_style_x(obj, LV_PART_MAIN)) ||
+           LV_COORD_IS_PCT(lv_obj_get_style_y(obj, LV_PART_MAIN));
+}
+
 static bool obj_valid_child(const lv_obj_t * parent, const lv_obj_t * obj_to_find)
 {
     /*Check all children of `parent`*/
@@ -176,6 +176,9 @@ typedef struct _lv_obj_t {
     struct _lv_obj_t * parent;
     _lv_obj_spec_attr_t * spec_attr;
     _lv_obj_style_t * styles;
+#if LV_USE_OBJ_STYLE_CACHE
+    struct _lv_obj_style_cache_t * style_cache;
+#endif
 #if LV_USE_USER_DATA
     void * user_data;
 #endif
@@ -184,6 +187,7 @@ typedef struct _lv_obj_t {
     lv_state_t state;
     uint16_t layout_inv : 1;
     uint16_t scr_layout_inv : 1;
+    uint16_t child_layout_inv : 1;  /**< A descendant is marked for layout update*/
     uint16_t skip_trans : 1;
     uint16_t style_cnt  : 6;
     uint16_t h_layout   : 1;
@@ -32,6 +32,7 @@ static void transform_point(const lv_obj_t * obj, lv_point_t * p, bool inv);
  *  STATIC VARIABLES
  **********************/
 static uint32_t layout_cnt;
+static lv_layout_stat_t layout_stat;
 
 /**********************
  *      MACROS
@@ -289,8 +290,14 @@ void lv_obj_mark_layout_as_dirty(lv_obj_t * obj)
 {
     obj->layout_inv = 1;
 
+    /*Mark the path to the screen to find the dirty objects without walking the whole screen*/
+    lv_obj_t * scr = obj;
+    while(scr->parent) {
+        scr = scr->parent;
+        scr->child_layout_inv = 1;
+    }
+
     /*Mark the screen as dirty too to mark that there is something to do on this screen*/
-    lv_obj_t * scr = lv_obj_get_screen(obj);
     scr->scr_layout_inv = 1;
 
     /*Make the display refreshing*/
@@ -309,10 +316,13 @@ void lv_obj_update_layout(const lv_obj_t * obj)
 
     lv_obj_t * scr = lv_obj_get_screen(obj);
 
+    if(scr->scr_layout_inv) layout_stat.update_cnt++;
+
     /*Repeat until there where layout invalidations*/
     while(scr->scr_layout_inv) {
         LV_LOG_INFO("Layout update begin");
         scr->scr_layout_inv = 0;
+        layout_stat.pass_cnt++;
         layout_update_core(scr);
         LV_LOG_TRACE("Layout update end");
     }
@@ -331,6 +341,16 @@ uint32_t lv_layout_register(lv_layout_update_cb_t cb, void * user_data)
     return layout_cnt;  /*No -1 to skip 0th index*/
 }
 
+void lv_obj_get_layout_stat(lv_layout_stat_t * stat)
+{
+    *stat = layout_stat;
+}
+
+void lv_obj_reset_layout_stat(void)
+{
+    lv_memset_00(&layout_stat, sizeof(lv_layout_stat_t));
+}
+
 void lv_obj_set_align(lv_obj_t * obj, lv_align_t align)
 {
     lv_obj_set_style_align(obj, align, 0);
@@ -1130,16 +1150,24 @@ static lv_coord_t calc_content_height(lv_obj_t * obj)
 
 static void layout_update_core(lv_obj_t * obj)
 {
+    layout_stat.visit_cnt++;
+
+    /*Go only into the children having something dirty in them.
+     *Clear the flag first as the children might mark an other sibling again.*/
     uint32_t i;
     uint32_t child_cnt = lv_obj_get_child_cnt(obj);
-    for(i = 0; i < child_cnt; i++) {
-        lv_obj_t * child = obj->spec_attr->children[i];
-        layout_update_core(child);
+    if(obj->child_layout_inv) {
+        obj->child_layout_inv = 0;
+        for(i = 0; i < child_cnt; i++) {
+            lv_obj_t * child = obj->spec_attr->children[i];
+            if(child->layout_inv || child->child_layout_inv) layout_update_core(child);
+        }
     }
 
     if(obj->layout_inv == 0) return;
 
     obj->layout_inv = 0;
+    layout_stat.refr_cnt++;
 
     lv_obj_refr_size(obj);
     lv_obj_refr_pos(obj);
@@ -1148,6 +1176,7 @@ static void layout_update_core(lv_obj_t * obj)
         uint32_t layout_id = lv_obj_get_style_layout(obj, LV_PART_MAIN);
         if(layout_id > 0 && layout_id <= layout_cnt) {
             void  * user_data = LV_GC_ROOT(_lv_layout_list)[layout_id - 1].user_data;
+            layout_stat.layout_cnt++;
             LV_GC_ROOT(_lv_layout_list)[layout_id - 1].cb(obj, user_data);
         }
     }
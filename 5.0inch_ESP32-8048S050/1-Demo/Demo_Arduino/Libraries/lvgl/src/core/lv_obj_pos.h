@@ -30,6 +30,17 @@ typedef struct {
     void * user_data;
 } lv_layout_dsc_t;
 
+/**
+ * Counters of the layout updates
+ */
+typedef struct {
+    uint32_t update_cnt;    /**< `lv_obj_update_layout()` calls which had something to update*/
+    uint32_t pass_cnt;      /**< Walks of the screens, more than one per update if the layout was invalidated again*/
+    uint32_t visit_cnt;     /**< Objects visited by the walks*/
+    uint32_t refr_cnt;      /**< Objects whose size and position were refreshed*/
+    uint32_t layout_cnt;    /**< Layout callbacks called on the children of the refreshed objects*/
+} lv_layout_stat_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -148,10 +159,22 @@ void lv_obj_mark_layout_as_dirty(struct _lv_obj_t * obj);
 
 /**
  * Update the layout of an object.
+ * Only the objects marked as dirty and their ancestors are visited.
  * @param obj      pointer to an object whose children needs to be updated
  */
 void lv_obj_update_layout(const struct _lv_obj_t * obj);
 
+/**
+ * Get the counters of the layout updates
+ * @param stat      pointer to a `lv_layout_stat_t` variable to store the result
+ */
+void lv_obj_get_layout_stat(lv_layout_stat_t * stat);
+
+/**
+ * Reset the counters of the layout updates
+ */
+void lv_obj_reset_layout_stat(void);
+
 /**
  * Register a new layout
  * @param cb        the layout update callback
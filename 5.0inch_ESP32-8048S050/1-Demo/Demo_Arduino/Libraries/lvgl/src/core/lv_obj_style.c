@@ -9,12 +9,23 @@
 #include "lv_obj.h"
 #include "lv_disp.h"
 #include "../misc/lv_gc.h"
+#include "../misc/lv_slab.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define MY_CLASS &lv_obj_class
 
+#if LV_USE_OBJ_STYLE_CACHE
+    #if LV_OBJ_STYLE_CACHE_SIZE < 2 || LV_OBJ_STYLE_CACHE_SIZE & (LV_OBJ_STYLE_CACHE_SIZE - 1)
+        #error "LV_OBJ_STYLE_CACHE_SIZE has to be a power of 2"
+    #endif
+    /*2 way set associative: a property can be in any of the 2 slots of its set.
+     *The group is mixed in as the first properties of each group are used the most.*/
+    #define STYLE_CACHE_SET(prop, part_id) \
+        ((((prop) + ((prop) >> 4) * 3 + (part_id) * 7) & (LV_OBJ_STYLE_CACHE_SIZE / 2 - 1)) * 2)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -35,6 +46,22 @@ typedef enum {
     CACHE_NEED_CHECK = 4,
 } cache_t;
 
+#if LV_USE_OBJ_STYLE_CACHE
+typedef struct {
+    lv_style_value_t value;
+    lv_style_prop_t prop;       /*`LV_STYLE_PROP_INV` if the slot is empty*/
+    uint8_t part_id;            /*`part >> 16`*/
+    uint8_t inherited;          /*1: the value was found on a parent*/
+} style_cache_slot_t;
+
+struct _lv_obj_style_cache_t {
+    uint32_t gen;               /*Value of `cache_gen` when the slots were cleared*/
+    uint32_t inherit_gen;       /*Value of `cache_inherit_gen` when the inherited slots were cleared*/
+    lv_state_t state;           /*The slots are valid only in this state*/
+    style_cache_slot_t slots[LV_OBJ_STYLE_CACHE_SIZE];
+};
+#endif
+
 /**********************
  *  GLOBAL PROTOTYPES
  **********************/
@@ -54,11 +81,20 @@ static void trans_anim_ready_cb(lv_anim_t * a);
 static lv_layer_type_t calculate_layer_type(lv_obj_t * obj);
 static void fade_anim_cb(void * obj, int32_t v);
 static void fade_in_anim_ready(lv_anim_t * a);
+#if LV_USE_OBJ_STYLE_CACHE
+    static style_cache_slot_t * style_cache_get_set(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static bool style_refr = true;
+#if LV_USE_OBJ_STYLE_CACHE
+    static bool style_cache_en = true;
+    static uint32_t cache_gen = 1;          /*Incremented to drop the cache of all objects*/
+    static uint32_t cache_inherit_gen;      /*Incremented to drop the inherited values of all objects*/
+    static lv_obj_style_cache_stat_t cache_stat;
+#endif
 
 /**********************
  *      MACROS
@@ -152,6 +188,9 @@ void lv_obj_remove_style(lv_obj_t * obj, lv_style_t * style, lv_style_selector_t
 
 void lv_obj_report_style_change(lv_style_t * style)
 {
+    /*The style can be used by any object*/
+    _lv_obj_style_cache_drop(NULL, LV_STYLE_PROP_ANY);
+
     if(!style_refr) return;
     lv_disp_t * d = lv_disp_get_next(NULL);
 
@@ -168,6 +207,9 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+    /*Drop the cache even if refreshing is disabled, the style has changed anyway*/
+    _lv_obj_style_cache_drop(obj, prop);
+
     if(!style_refr) return;
 
     lv_obj_invalidate(obj);
@@ -220,9 +262,81 @@ void lv_obj_enable_style_refresh(bool en)
     style_refr = en;
 }
 
+void lv_obj_enable_style_cache(bool en)
+{
+#if LV_USE_OBJ_STYLE_CACHE
+    style_cache_en = en;
+    _lv_obj_style_cache_drop(NULL, LV_STYLE_PROP_ANY);
+#else
+    LV_UNUSED(en);
+#endif
+}
+
+void lv_obj_style_cache_get_stat(lv_obj_style_cache_stat_t * stat)
+{
+#if LV_USE_OBJ_STYLE_CACHE
+    *stat = cache_stat;
+#else
+    lv_memset_00(stat, sizeof(lv_obj_style_cache_stat_t));
+#endif
+}
+
+void lv_obj_style_cache_reset_stat(void)
+{
+#if LV_USE_OBJ_STYLE_CACHE
+    lv_memset_00(&cache_stat, sizeof(lv_obj_style_cache_stat_t));
+#endif
+}
+
+void _lv_obj_style_cache_drop(lv_obj_t * obj, lv_style_prop_t prop)
+{
+#if LV_USE_OBJ_STYLE_CACHE
+    cache_stat.drop_cnt++;
+    if(obj == NULL) {
+        cache_gen++;
+        return;
+    }
+
+    /*Make the generation outdated, the slots will be cleared on the next lookup*/
+    if(obj->style_cache) obj->style_cache->gen = cache_gen - 1;
+
+    /*Only the children can inherit from this object*/
+    if(lv_obj_get_child_cnt(obj) > 0 &&
+       (prop == LV_STYLE_PROP_ANY || lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT))) {
+        cache_inherit_gen++;
+    }
+#else
+    LV_UNUSED(obj);
+    LV_UNUSED(prop);
+#endif
+}
+
 lv_style_value_t lv_obj_get_style_prop(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
 {
     lv_style_value_t value_act;
+
+#if LV_USE_OBJ_STYLE_CACHE
+    const lv_obj_t * obj_start = obj;
+    lv_part_t part_start = part;
+    style_cache_slot_t * set = NULL;
+    /*Skip the cache while an object's state is temporarily changed to get the values without transitions*/
+    if(style_cache_en && !obj->skip_trans) {
+        set = style_cache_get_set(obj, part, prop);
+        if(set) {
+            uint8_t part_id = (uint8_t)(part >> 16);
+            if(set[0].prop == prop && set[0].part_id == part_id) {
+                cache_stat.hit_cnt++;
+                return set[0].value;
+            }
+            if(set[1].prop == prop && set[1].part_id == part_id) {
+                cache_stat.hit_cnt++;
+                return set[1].value;
+            }
+        }
+        cache_stat.miss_cnt++;
+    }
+#endif
+
     bool inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT);
     lv_style_res_t found = LV_STYLE_RES_NOT_FOUND;
     while(obj) {
@@ -264,6 +378,18 @@ lv_style_value_t lv_obj_get_style_prop(const lv_obj_t * obj, lv_part_t part, lv_
             value_act = lv_style_prop_get_default(prop);
         }
     }
+
+#if LV_USE_OBJ_STYLE_CACHE
+    if(set) {
+        /*Keep the last used property in the first slot and evict the other one*/
+        set[1] = set[0];
+        set[0].value = value_act;
+        set[0].prop = prop;
+        set[0].part_id = (uint8_t)(part_start >> 16);
+        set[0].inherited = obj != obj_start;
+    }
+#endif
+
     return value_act;
 }
 
@@ -342,6 +468,7 @@ void _lv_obj_style_create_transition(lv_obj_t * obj, lv_part_t part, lv_state_t
 
     _lv_obj_style_t * style_trans = get_trans_style(obj, part);
     lv_style_set_prop(style_trans->style, tr_dsc->prop, v1);   /*Be sure `trans_style` has a valid value*/
+    _lv_obj_style_cache_drop(obj, tr_dsc->prop);
 
     if(tr_dsc->prop == LV_STYLE_RADIUS) {
         if(v1.num == LV_RADIUS_CIRCLE || v2.num == LV_RADIUS_CIRCLE) {
@@ -706,6 +833,7 @@ static bool trans_del(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, tran
                     lv_style_remove_prop(obj->styles[i].style, tr->prop);
                 }
             }
+            _lv_obj_style_cache_drop(obj, tr->prop);
 
             /*Free the transition descriptor too*/
             lv_anim_del(tr, NULL);
@@ -800,6 +928,7 @@ static void trans_anim_start_cb(lv_anim_t * a)
 
     _lv_obj_style_t * style_trans = get_trans_style(tr->obj, tr->selector);
     lv_style_set_prop(style_trans->style, tr->prop, tr->start_value);   /*Be sure `trans_style` has a valid value*/
+    _lv_obj_style_cache_drop(tr->obj, tr->prop);
 
 }
 
@@ -830,6 +959,7 @@ static void trans_anim_ready_cb(lv_anim_t * a)
 
                 _lv_obj_style_t * obj_style = &obj->styles[i];
                 lv_style_remove_prop(obj_style->style, prop);
+                _lv_obj_style_cache_drop(obj, prop);
 
                 if(lv_style_is_empty(obj->styles[i].style)) {
                     lv_obj_remove_style(obj, obj_style->style, obj_style->selector);
@@ -863,4 +993,40 @@ static void fade_in_anim_ready(lv_anim_t * a)
     lv_obj_remove_local_style_prop(a->var, LV_STYLE_OPA, 0);
 }
 
+#if LV_USE_OBJ_STYLE_CACHE
+
+/**
+ * Get the cache set (2 slots) of a property. Allocate the cache and clear the outdated slots if needed.
+ * @param obj       pointer to an object
+ * @param part      the part of the object
+ * @param prop      the property
+ * @return          the first slot of the set where `prop` is or should be stored, NULL if the cache couldn't be allocated
+ */
+static style_cache_slot_t * style_cache_get_set(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
+{
+    struct _lv_obj_style_cache_t * cache = obj->style_cache;
+    if(cache == NULL) {
+        cache = lv_slab_alloc(sizeof(struct _lv_obj_style_cache_t));
+        if(cache == NULL) return NULL;
+        cache->gen = cache_gen - 1;
+        ((lv_obj_t *)obj)->style_cache = cache;
+    }
+
+    if(cache->gen != cache_gen || cache->state != obj->state) {
+        lv_memset_00(cache->slots, sizeof(cache->slots));
+        cache->gen = cache_gen;
+        cache->inherit_gen = cache_inherit_gen;
+        cache->state = obj->state;
+    }
+    else if(cache->inherit_gen != cache_inherit_gen) {
+        uint32_t i;
+        for(i = 0; i < LV_OBJ_STYLE_CACHE_SIZE; i++) {
+            if(cache->slots[i].inherited) cache->slots[i].prop = LV_STYLE_PROP_INV;
+        }
+        cache->inherit_gen = cache_inherit_gen;
+    }
+
+    return &cache->slots[STYLE_CACHE_SET(prop, part >> 16)];
+}
 
+#endif /*LV_USE_OBJ_STYLE_CACHE*/
@@ -36,6 +36,15 @@ typedef enum {
 
 typedef uint32_t lv_style_selector_t;
 
+/**
+ * Statistics of the style property cache
+ */
+typedef struct {
+    uint32_t hit_cnt;   /**< Lookups served from the cache*/
+    uint32_t miss_cnt;  /**< Lookups resolved from the styles*/
+    uint32_t drop_cnt;  /**< Number of times the cache of an object or all objects was dropped*/
+} lv_obj_style_cache_stat_t;
+
 typedef struct {
     lv_style_t * style;
     uint32_t selector : 24;
@@ -118,6 +127,32 @@ void lv_obj_refresh_style(struct _lv_obj_t * obj, lv_part_t part, lv_style_prop_
  */
 void lv_obj_enable_style_refresh(bool en);
 
+/**
+ * Enable or disable the cache of the resolved style properties. Requires `LV_USE_OBJ_STYLE_CACHE`.
+ * Enabled by default, disabling is useful to compare the performance.
+ * @param en        true: use the cache; false: always resolve the properties from the styles
+ */
+void lv_obj_enable_style_cache(bool en);
+
+/**
+ * Get the statistics of the style property cache
+ * @param stat      pointer to a `lv_obj_style_cache_stat_t` variable, the statistics will be stored here
+ */
+void lv_obj_style_cache_get_stat(lv_obj_style_cache_stat_t * stat);
+
+/**
+ * Reset the statistics of the style property cache
+ */
+void lv_obj_style_cache_reset_stat(void);
+
+/**
+ * Drop the cached style properties of an object
+ * @param obj       pointer to an object, or NULL to drop the cache of all objects
+ * @param prop      the changed property or `LV_STYLE_PROP_ANY`.
+ *                  The children's cache is dropped too if the property is inherited.
+ */
+void _lv_obj_style_cache_drop(struct _lv_obj_t * obj, lv_style_prop_t prop);
+
 /**
  * Get the value of a style property. The current state of the object will be considered.
  * Inherited properties will be inherited.
@@ -13,6 +13,7 @@
 #include "../misc/lv_anim.h"
 #include "../misc/lv_gc.h"
 #include "../misc/lv_async.h"
+#include "../misc/lv_slab.h"
 
 /*********************
  *      DEFINES
@@ -156,22 +157,25 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
     }
     old_parent->spec_attr->child_cnt--;
     if(old_parent->spec_attr->child_cnt) {
-        old_parent->spec_attr->children = lv_mem_realloc(old_parent->spec_attr->children,
-                                                         old_parent->spec_attr->child_cnt * (sizeof(lv_obj_t *)));
+        old_parent->spec_attr->children = lv_slab_realloc(old_parent->spec_attr->children,
+                                                          old_parent->spec_attr->child_cnt * (sizeof(lv_obj_t *)));
     }
     else {
-        lv_mem_free(old_parent->spec_attr->children);
+        lv_slab_free(old_parent->spec_attr->children);
         old_parent->spec_attr->children = NULL;
     }
 
     /*Add the child to the new parent as the last (newest child)*/
     parent->spec_attr->child_cnt++;
-    parent->spec_attr->children = lv_mem_realloc(parent->spec_attr->children,
-                                                 parent->spec_attr->child_cnt * (sizeof(lv_obj_t *)));
+    parent->spec_attr->children = lv_slab_realloc(parent->spec_attr->children,
+                                                  parent->spec_attr->child_cnt * (sizeof(lv_obj_t *)));
     parent->spec_attr->children[lv_obj_get_child_cnt(parent) - 1] = obj;
 
     obj->parent = parent;
 
+    /*The inherited values will come from the new parent*/
+    _lv_obj_style_cache_drop(obj, LV_STYLE_PROP_ANY);
+
     /*Notify the original parent because one of its children is lost*/
     lv_obj_readjust_scroll(old_parent, LV_ANIM_OFF);
     lv_obj_scrollbar_invalidate(old_parent);
@@ -412,12 +416,15 @@ static void obj_del_core(lv_obj_t * obj)
             obj->parent->spec_attr->children[i] = obj->parent->spec_attr->children[i + 1];
         }
         obj->parent->spec_attr->child_cnt--;
-        obj->parent->spec_attr->children = lv_mem_realloc(obj->parent->spec_attr->children,
-                                                          obj->parent->spec_attr->child_cnt * sizeof(lv_obj_t *));
+        obj->parent->spec_attr->children = lv_slab_realloc(obj->parent->spec_attr->children,
+                                                           obj->parent->spec_attr->child_cnt * sizeof(lv_obj_t *));
     }
 
     /*Free the object itself*/
-    lv_mem_free(obj);
+#if LV_USE_OBJ_STYLE_CACHE
+    lv_slab_free(obj->style_cache);
+#endif
+    lv_slab_free(obj);
 }
 
 
@@ -8,6 +8,7 @@
  *********************/
 #include "lv_draw_img.h"
 #include "lv_img_cache.h"
+#include "lv_img_async.h"
 #include "../hal/lv_hal_disp.h"
 #include "../misc/lv_log.h"
 #include "../core/lv_refr.h"
@@ -29,6 +30,10 @@ LV_ATTRIBUTE_FAST_MEM static lv_res_t decode_and_draw(lv_draw_ctx_t * draw_ctx,
                                                       const lv_area_t * coords, const void * src);
 
 static void show_error(lv_draw_ctx_t * draw_ctx, const lv_area_t * coords, const char * msg);
+#if LV_USE_IMG_ASYNC
+    static lv_res_t draw_pending(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * draw_dsc,
+                                 const lv_area_t * coords, const void * src);
+#endif
 static void draw_cleanup(_lv_img_cache_entry_t * cache);
 
 /**********************
@@ -234,7 +239,12 @@ LV_ATTRIBUTE_FAST_MEM static lv_res_t decode_and_draw(lv_draw_ctx_t * draw_ctx,
 
     _lv_img_cache_entry_t * cdsc = _lv_img_cache_open(src, draw_dsc->recolor, draw_dsc->frame_id);
 
+#if LV_USE_IMG_ASYNC
+    /*Maybe it's just not decoded yet*/
+    if(cdsc == NULL) return draw_pending(draw_ctx, draw_dsc, coords, src);
+#else
     if(cdsc == NULL) return LV_RES_INV;
+#endif
 
     lv_img_cf_t cf;
     if(lv_img_cf_is_chroma_keyed(cdsc->dec_dsc.header.cf)) cf = LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED;
@@ -318,7 +328,6 @@ LV_ATTRIBUTE_FAST_MEM static lv_res_t decode_and_draw(lv_draw_ctx_t * draw_ctx,
 
             read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y, width, buf);
             if(read_res != LV_RES_OK) {
-                lv_img_decoder_close(&cdsc->dec_dsc);
                 LV_LOG_WARN("Image draw can't read the line");
                 lv_mem_buf_release(buf);
                 draw_cleanup(cdsc);
@@ -353,12 +362,75 @@ static void show_error(lv_draw_ctx_t * draw_ctx, const lv_area_t * coords, const
     lv_draw_label(draw_ctx, &label_dsc, coords, msg, NULL);
 }
 
+#if LV_USE_IMG_ASYNC
+/**
+ * Draw the already decoded rows of an image which is decoded in the background
+ * and a placeholder instead of the rest
+ */
+static lv_res_t draw_pending(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * draw_dsc,
+                             const lv_area_t * coords, const void * src)
+{
+    bool transformed = draw_dsc->angle || draw_dsc->zoom != LV_IMG_ZOOM_NONE;
+
+    /*Refresh the whole transformed area when the image is ready*/
+    lv_area_t map_area_rot;
+    lv_area_copy(&map_area_rot, coords);
+    if(transformed) {
+        int32_t w = lv_area_get_width(coords);
+        int32_t h = lv_area_get_height(coords);
+
+        _lv_img_buf_get_transformed_area(&map_area_rot, w, h, draw_dsc->angle, draw_dsc->zoom, &draw_dsc->pivot);
+
+        map_area_rot.x1 += coords->x1;
+        map_area_rot.y1 += coords->y1;
+        map_area_rot.x2 += coords->x1;
+        map_area_rot.y2 += coords->y1;
+    }
+
+    _lv_img_async_progress_t progress;
+    if(!_lv_img_async_get_progress(src, draw_dsc->recolor, draw_dsc->frame_id, &map_area_rot, &progress)) {
+        return LV_RES_INV;
+    }
+
+    lv_area_t placeholder;
+    lv_area_copy(&placeholder, coords);
+
+    /*The rows can be drawn only as they are, transforming would need the whole image*/
+    if(progress.data && progress.rows_ready > 0 && !transformed &&
+       progress.header.w == lv_area_get_width(coords) && progress.header.h == lv_area_get_height(coords)) {
+        lv_area_t ready_area;
+        lv_area_copy(&ready_area, coords);
+        ready_area.y2 = coords->y1 + progress.rows_ready - 1;
+
+        lv_area_t clip_com;
+        if(_lv_area_intersect(&clip_com, draw_ctx->clip_area, &ready_area)) {
+            lv_img_cf_t cf;
+            if(lv_img_cf_is_chroma_keyed(progress.header.cf)) cf = LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED;
+            else if(lv_img_cf_has_alpha(progress.header.cf)) cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+            else cf = LV_IMG_CF_TRUE_COLOR;
+
+            const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+            draw_ctx->clip_area = &clip_com;
+            lv_draw_img_decoded(draw_ctx, draw_dsc, coords, progress.data, cf);
+            draw_ctx->clip_area = clip_area_ori;
+        }
+
+        placeholder.y1 = ready_area.y2 + 1;
+        if(placeholder.y1 > placeholder.y2) return LV_RES_OK;
+    }
+
+    lv_draw_rect_dsc_t rect_dsc;
+    lv_draw_rect_dsc_init(&rect_dsc);
+    rect_dsc.bg_color = LV_IMG_ASYNC_PLACEHOLDER_COLOR;
+    rect_dsc.bg_opa = draw_dsc->opa;
+    lv_draw_rect(draw_ctx, &rect_dsc, &placeholder);
+
+    return LV_RES_OK;
+}
+#endif
+
 static void draw_cleanup(_lv_img_cache_entry_t * cache)
 {
     /*Automatically close images with no caching*/
-#if LV_IMG_CACHE_DEF_SIZE == 0
-    lv_img_decoder_close(&cache->dec_dsc);
-#else
-    LV_UNUSED(cache);
-#endif
+    _lv_img_cache_release(cache);
 }
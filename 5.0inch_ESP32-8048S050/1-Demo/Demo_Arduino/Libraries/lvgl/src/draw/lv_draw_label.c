@@ -35,6 +35,10 @@ typedef uint8_t cmd_state_t;
  **********************/
 
 static uint8_t hex_char_to_num(char hex);
+static uint32_t get_line_end(const lv_draw_label_dsc_t * dsc, const lv_txt_layout_t * layout, uint32_t line_id,
+                             const char * txt, uint32_t line_start, lv_coord_t w);
+static lv_coord_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_txt_layout_t * layout, uint32_t line_id,
+                                 const char * txt, uint32_t line_start, uint32_t line_end);
 
 /**********************
  *  STATIC VARIABLES
@@ -106,10 +110,20 @@ LV_ATTRIBUTE_FAST_MEM void lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 
     lv_bidi_calculate_align(&align, &base_dir, txt);
 
+    /*Use the line breaks and widths of the layout instead of measuring the text*/
+    const lv_txt_layout_t * layout = dsc->layout;
+    if(layout && !_lv_txt_layout_is_valid(layout, font, dsc->letter_space, lv_area_get_width(coords), dsc->flag)) {
+        layout = NULL;
+    }
+    uint32_t line_id = 0;
+
     if((dsc->flag & LV_TEXT_FLAG_EXPAND) == 0) {
         /*Normally use the label's width as width*/
         w = lv_area_get_width(coords);
     }
+    else if(layout) {
+        w = layout->size.x;
+    }
     else {
         /*If EXPAND is enabled then not limit the text's width to the object's width*/
         lv_point_t p;
@@ -137,7 +151,7 @@ LV_ATTRIBUTE_FAST_MEM void lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
     int32_t last_line_start = -1;
 
     /*Check the hint to use the cached info*/
-    if(hint && y_ofs == 0 && coords->y1 < 0) {
+    if(hint && layout == NULL && y_ofs == 0 && coords->y1 < 0) {
         /*If the label changed too much recalculate the hint.*/
         if(LV_ABS(hint->coord_y - coords->y1) > LV_LABEL_HINT_UPDATE_TH - 2 * line_height) {
             hint->line_start = -1;
@@ -151,13 +165,24 @@ LV_ATTRIBUTE_FAST_MEM void lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
         pos.y += hint->y;
     }
 
-    uint32_t line_end = line_start + _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+    uint32_t line_end = get_line_end(dsc, layout, line_id, txt, line_start, w);
 
     /*Go the first visible line*/
+    if(layout && line_height > 0 && pos.y + line_height_font < draw_ctx->clip_area->y1) {
+        /*The lines are known so jump there directly*/
+        uint32_t skip = (draw_ctx->clip_area->y1 - pos.y - line_height_font - 1) / line_height;
+        if(skip >= layout->line_cnt) return;
+        line_id = skip;
+        line_start = layout->lines[line_id].start;
+        line_end = get_line_end(dsc, layout, line_id, txt, line_start, w);
+        pos.y += skip * line_height;
+    }
+
     while(pos.y + line_height_font < draw_ctx->clip_area->y1) {
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_id++;
+        line_end = get_line_end(dsc, layout, line_id, txt, line_start, w);
         pos.y += line_height;
 
         /*Save at the threshold coordinate*/
@@ -172,14 +197,14 @@ LV_ATTRIBUTE_FAST_MEM void lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 
     /*Align to middle*/
     if(align == LV_TEXT_ALIGN_CENTER) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+        line_width = get_line_width(dsc, layout, line_id, txt, line_start, line_end);
 
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
     }
     /*Align to the right*/
     else if(align == LV_TEXT_ALIGN_RIGHT) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+        line_width = get_line_width(dsc, layout, line_id, txt, line_start, line_end);
         pos.x += lv_area_get_width(coords) - line_width;
     }
     uint32_t sel_start = dsc->sel_start;
@@ -334,21 +359,20 @@ LV_ATTRIBUTE_FAST_MEM void lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 #endif
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_txt_get_next_line(&txt[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_id++;
+        line_end = get_line_end(dsc, layout, line_id, txt, line_start, w);
 
         pos.x = coords->x1;
         /*Align to middle*/
         if(align == LV_TEXT_ALIGN_CENTER) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+            line_width = get_line_width(dsc, layout, line_id, txt, line_start, line_end);
 
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
         }
         /*Align to the right*/
         else if(align == LV_TEXT_ALIGN_RIGHT) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, dsc->letter_space, dsc->flag);
+            line_width = get_line_width(dsc, layout, line_id, txt, line_start, line_end);
             pos.x += lv_area_get_width(coords) - line_width;
         }
 
@@ -372,6 +396,30 @@ void lv_draw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Get the end of a line from the layout or by measuring the text
+ * @param line_id index of the line, used only with a layout
+ * @param line_start byte index of the line's start
+ * @return byte index of the next line's start
+ */
+static uint32_t get_line_end(const lv_draw_label_dsc_t * dsc, const lv_txt_layout_t * layout, uint32_t line_id,
+                             const char * txt, uint32_t line_start, lv_coord_t w)
+{
+    if(layout) {
+        return line_id < layout->line_cnt ? layout->lines[line_id + 1].start : line_start;
+    }
+    return line_start + _lv_txt_get_next_line(&txt[line_start], dsc->font, dsc->letter_space, w, NULL, dsc->flag);
+}
+
+static lv_coord_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_txt_layout_t * layout, uint32_t line_id,
+                                 const char * txt, uint32_t line_start, uint32_t line_end)
+{
+    if(layout) {
+        return line_id < layout->line_cnt ? layout->lines[line_id].width : 0;
+    }
+    return lv_txt_get_width(&txt[line_start], line_end - line_start, dsc->font, dsc->letter_space, dsc->flag);
+}
+
 /**
  * Convert a hexadecimal characters to a number (0..15)
  * @param hex Pointer to a hexadecimal character (0..9, A..F)
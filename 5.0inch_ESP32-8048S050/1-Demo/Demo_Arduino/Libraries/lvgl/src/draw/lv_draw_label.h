@@ -29,6 +29,7 @@ extern "C" {
 
 typedef struct {
     const lv_font_t * font;
+    const lv_txt_layout_t * layout;     /*Line breaks of the text if already known. Used if made with the same parameters*/
     uint32_t sel_start;
     uint32_t sel_end;
     lv_color_t color;
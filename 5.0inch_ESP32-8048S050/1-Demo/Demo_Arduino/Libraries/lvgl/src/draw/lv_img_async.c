@@ -0,0 +1,569 @@
+/**
+ * @file lv_img_async.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_img_async.h"
+#if LV_USE_IMG_ASYNC
+
+#include "lv_draw_img.h"
+#include "../core/lv_refr.h"
+#include "../hal/lv_hal_disp.h"
+#include "../hal/lv_hal_tick.h"
+#include "../misc/lv_assert.h"
+#include "../misc/lv_gc.h"
+#include "../misc/lv_mem.h"
+#include "../misc/lv_os.h"
+#include "../misc/lv_timer.h"
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+enum {
+    REQ_FREE,
+    REQ_QUEUED,     /*Waiting for the worker*/
+    REQ_DECODING,   /*The worker is decoding it*/
+    REQ_DONE,       /*`dsc` is opened and can be taken by the cache*/
+    REQ_TAKEN,      /*`dsc` is moved to the cache, only the area needs to be invalidated*/
+    REQ_FAILED,     /*Kept to not try again in every frame*/
+};
+typedef uint8_t req_state_t;
+
+typedef struct {
+    lv_img_decoder_dsc_t dsc;   /*The result. Touched only by the worker until `REQ_DONE`*/
+    const void * src;           /*To find the request: the variable or `src_copy`*/
+    char * src_copy;            /*Own copy of file paths as the caller's might be freed meanwhile*/
+    lv_color_t color;
+    int32_t frame_id;
+    lv_coord_t fit_w;           /*The fit size when it was requested, the worker decodes with these*/
+    lv_coord_t fit_h;
+    uint32_t seq;               /*To serve the requests in order*/
+
+    /*Progressive decoding*/
+    uint8_t * buf;              /*The image, filled row by row by the worker*/
+    lv_img_header_t header;
+    uint32_t rows_ready;        /*Set by the worker after every band*/
+    uint32_t rows_shown;        /*`rows_ready` when the area was last invalidated*/
+
+    /*Where the placeholder was drawn*/
+    lv_disp_t * disp;
+    lv_area_t area;
+
+    req_state_t state;
+    uint8_t area_valid  : 1;
+    uint8_t notified    : 1;    /*The area was invalidated after the final state*/
+    uint8_t discard     : 1;    /*The source was invalidated while the worker was using it*/
+} req_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void worker_cb(void * user_data);
+static void decode(req_t * req);
+static lv_res_t decode_progressive(req_t * req, lv_img_decoder_dsc_t * dsc);
+static void timer_cb(lv_timer_t * t);
+static req_t * find_req(const void * src, lv_color_t color, int32_t frame_id);
+static req_t * get_free_req(void);
+static void req_free(req_t * req);
+static bool src_match(const void * src, const req_t * req);
+static bool is_built_in(const void * src);
+static void buf_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/*The worker and the request table are not in the LVGL heap's life cycle: started once, never stopped*/
+static req_t reqs[LV_IMG_ASYNC_QUEUE_LEN];
+static lv_mutex_t lock;
+static lv_thread_sync_t worker_sync;
+static lv_thread_t worker;
+static bool worker_started;
+static uint32_t seq_cnt;
+static bool enabled = true;
+static lv_timer_t * timer;
+static lv_img_async_stat_t async_stat;
+
+/*Owns the images decoded row by row. It's not registered so it's never used for opening.*/
+static lv_img_decoder_t buf_decoder = {
+    .close_cb = buf_decoder_close,
+};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_img_async_init(void)
+{
+    /*The timers are freed by `lv_deinit()` but the worker keeps running*/
+    timer = lv_timer_create(timer_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
+    lv_timer_pause(timer);
+
+    if(worker_started) return;
+
+    if(lv_mutex_init(&lock) != LV_RES_OK || lv_thread_sync_init(&worker_sync) != LV_RES_OK) {
+        LV_LOG_ERROR("couldn't create the sync objects, decoding images in the UI thread");
+        enabled = false;
+        return;
+    }
+
+    if(lv_thread_init(&worker, worker_cb, LV_IMG_ASYNC_STACK_SIZE, LV_IMG_ASYNC_PRIO, LV_IMG_ASYNC_CORE,
+                      NULL) != LV_RES_OK) {
+        LV_LOG_ERROR("couldn't start the worker, decoding images in the UI thread");
+        enabled = false;
+        return;
+    }
+
+    worker_started = true;
+}
+
+_lv_img_async_res_t _lv_img_async_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color,
+                                       int32_t frame_id)
+{
+    if(!enabled || !worker_started) return _LV_IMG_ASYNC_SYNC;
+
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    if(src_type != LV_IMG_SRC_VARIABLE && src_type != LV_IMG_SRC_FILE) return _LV_IMG_ASYNC_SYNC;
+
+    lv_mutex_lock(&lock);
+
+    _lv_img_async_res_t res;
+    req_t * req = find_req(src, color, frame_id);
+    if(req) {
+        if(req->state == REQ_DONE) {
+            *dsc = req->dsc;
+            /*The buffer is owned by `dsc` now*/
+            req->buf = NULL;
+            req->src = NULL;
+            req->state = REQ_TAKEN;
+            lv_timer_resume(timer);
+            res = _LV_IMG_ASYNC_READY;
+        }
+        else if(req->state == REQ_FAILED) {
+            res = _LV_IMG_ASYNC_FAILED;
+        }
+        else {
+            res = _LV_IMG_ASYNC_PENDING;
+        }
+        lv_mutex_unlock(&lock);
+        return res;
+    }
+
+    /*Images in LVGL's own format are just pointed to or read line by line. Not worth a thread.*/
+    if(is_built_in(src)) {
+        lv_mutex_unlock(&lock);
+        return _LV_IMG_ASYNC_SYNC;
+    }
+
+    req = get_free_req();
+    if(req == NULL) {
+        async_stat.sync_cnt++;
+        lv_mutex_unlock(&lock);
+        LV_LOG_INFO("the queue is full, decoding in the UI thread");
+        return _LV_IMG_ASYNC_SYNC;
+    }
+
+    if(src_type == LV_IMG_SRC_FILE) {
+        size_t len = strlen(src);
+        req->src_copy = lv_mem_alloc(len + 1);
+        LV_ASSERT_MALLOC(req->src_copy);
+        if(req->src_copy == NULL) {
+            lv_mutex_unlock(&lock);
+            return _LV_IMG_ASYNC_SYNC;
+        }
+        lv_memcpy(req->src_copy, src, len + 1);
+        req->src = req->src_copy;
+    }
+    else {
+        req->src = src;
+    }
+
+    req->color = color;
+    req->frame_id = frame_id;
+    lv_img_decoder_get_fit_size(&req->fit_w, &req->fit_h);
+    req->seq = seq_cnt++;
+    req->state = REQ_QUEUED;
+    async_stat.req_cnt++;
+    lv_timer_resume(timer);
+    lv_mutex_unlock(&lock);
+
+    lv_thread_sync_signal(&worker_sync);
+    return _LV_IMG_ASYNC_PENDING;
+}
+
+bool _lv_img_async_get_progress(const void * src, lv_color_t color, int32_t frame_id, const lv_area_t * area,
+                                _lv_img_async_progress_t * progress)
+{
+    lv_memset_00(progress, sizeof(_lv_img_async_progress_t));
+    if(!worker_started) return false;
+
+    lv_mutex_lock(&lock);
+    req_t * req = find_req(src, color, frame_id);
+    /*It can be `REQ_DONE` too if it was finished right after the cache checked it. It's drawn in the next refresh.*/
+    if(req == NULL || req->state == REQ_FAILED) {
+        lv_mutex_unlock(&lock);
+        return false;
+    }
+
+    /*Remember where to refresh when there is something new*/
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    if(!req->area_valid || req->disp != disp) {
+        req->disp = disp;
+        req->area = *area;
+        req->area_valid = 1;
+    }
+    else {
+        _lv_area_join(&req->area, &req->area, area);
+    }
+
+    progress->data = req->buf;
+    progress->header = req->header;
+    progress->rows_ready = req->rows_ready;
+    lv_mutex_unlock(&lock);
+    return true;
+}
+
+void _lv_img_async_invalidate_src(const void * src)
+{
+    if(!worker_started) return;
+
+    lv_mutex_lock(&lock);
+    uint32_t i;
+    for(i = 0; i < LV_IMG_ASYNC_QUEUE_LEN; i++) {
+        req_t * req = &reqs[i];
+        if(req->state == REQ_FREE || req->state == REQ_TAKEN) continue;
+        if(src && !src_match(src, req)) continue;
+
+        /*The worker still uses it, the timer will free it*/
+        if(req->state == REQ_DECODING) {
+            req->discard = 1;
+            lv_timer_resume(timer);
+        }
+        else {
+            req_free(req);
+        }
+    }
+    lv_mutex_unlock(&lock);
+}
+
+void lv_img_async_enable(bool en)
+{
+    enabled = en;
+}
+
+bool lv_img_async_is_busy(void)
+{
+    if(!worker_started) return false;
+
+    bool busy = false;
+    lv_mutex_lock(&lock);
+    uint32_t i;
+    for(i = 0; i < LV_IMG_ASYNC_QUEUE_LEN; i++) {
+        if(reqs[i].state == REQ_QUEUED || reqs[i].state == REQ_DECODING) {
+            busy = true;
+            break;
+        }
+    }
+    lv_mutex_unlock(&lock);
+    return busy;
+}
+
+void lv_img_async_get_stat(lv_img_async_stat_t * stat)
+{
+    if(worker_started) lv_mutex_lock(&lock);
+    *stat = async_stat;
+    if(worker_started) lv_mutex_unlock(&lock);
+}
+
+void lv_img_async_reset_stat(void)
+{
+    if(worker_started) lv_mutex_lock(&lock);
+    lv_memset_00(&async_stat, sizeof(async_stat));
+    if(worker_started) lv_mutex_unlock(&lock);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void worker_cb(void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    while(1) {
+        lv_thread_sync_wait(&worker_sync);
+
+        /*Do everything which was queued until the signal*/
+        while(1) {
+            lv_mutex_lock(&lock);
+            req_t * req = NULL;
+            uint32_t i;
+            for(i = 0; i < LV_IMG_ASYNC_QUEUE_LEN; i++) {
+                if(reqs[i].state != REQ_QUEUED) continue;
+                if(req == NULL || (int32_t)(reqs[i].seq - req->seq) < 0) req = &reqs[i];
+            }
+            if(req) req->state = REQ_DECODING;
+            lv_mutex_unlock(&lock);
+
+            if(req == NULL) break;
+            decode(req);
+        }
+    }
+}
+
+/**
+ * Open an image in the worker. Only `lock` protected fields and `dsc` are written.
+ */
+static void decode(req_t * req)
+{
+    uint32_t t_start = lv_tick_get();
+
+    lv_img_decoder_dsc_t dsc;
+    lv_res_t res = _lv_img_decoder_open_fit(&dsc, req->src, req->color, req->frame_id, req->fit_w, req->fit_h);
+    if(res == LV_RES_OK && dsc.img_data == NULL && dsc.error_msg == NULL && dsc.decoder->read_line_cb &&
+       (dsc.header.cf == LV_IMG_CF_TRUE_COLOR || dsc.header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA ||
+        dsc.header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED)) {
+        /*Read the lines to a buffer so that they can be shown while the rest is decoded*/
+        res = decode_progressive(req, &dsc);
+    }
+
+    uint32_t t = lv_tick_elaps(t_start);
+    if(res == LV_RES_OK && dsc.time_to_open == 0) dsc.time_to_open = t ? t : 1;
+
+    lv_mutex_lock(&lock);
+    async_stat.decode_time += t;
+    if(res == LV_RES_OK) {
+        req->dsc = dsc;
+        req->state = REQ_DONE;
+        async_stat.done_cnt++;
+    }
+    else {
+        /*If there is a buffer it's still drawn by the UI thread, so it's freed by the UI thread too*/
+        req->state = REQ_FAILED;
+        if(!req->discard) async_stat.fail_cnt++;
+    }
+    lv_mutex_unlock(&lock);
+}
+
+static lv_res_t decode_progressive(req_t * req, lv_img_decoder_dsc_t * dsc)
+{
+    lv_img_header_t header = dsc->header;
+    uint32_t stride = (uint32_t)header.w * lv_img_cf_get_px_size(header.cf) / 8;
+    uint8_t * buf = lv_mem_alloc(stride * header.h);
+    if(buf == NULL) {
+        LV_LOG_WARN("not enough memory to decode the image");
+        lv_img_decoder_close(dsc);
+        return LV_RES_INV;
+    }
+
+    lv_mutex_lock(&lock);
+    req->buf = buf;
+    req->header = header;
+    req->rows_ready = 0;
+    lv_mutex_unlock(&lock);
+
+    lv_res_t res = LV_RES_OK;
+    uint32_t y;
+    for(y = 0; y < header.h; y++) {
+        res = lv_img_decoder_read_line(dsc, 0, (lv_coord_t)y, (lv_coord_t)header.w, buf + y * stride);
+        if(res != LV_RES_OK) break;
+
+#if LV_IMG_ASYNC_BAND_ROWS
+        bool publish = (y + 1) % LV_IMG_ASYNC_BAND_ROWS == 0 || y + 1 == header.h;
+#else
+        bool publish = y + 1 == header.h;
+#endif
+        if(publish) {
+            lv_mutex_lock(&lock);
+            req->rows_ready = y + 1;
+            bool discard = req->discard;
+            lv_mutex_unlock(&lock);
+            /*Nobody needs it anymore*/
+            if(discard) {
+                res = LV_RES_INV;
+                break;
+            }
+        }
+    }
+
+    /*The original session is not needed anymore, only the buffer*/
+    lv_img_decoder_close(dsc);
+    if(res != LV_RES_OK) return res;
+
+    lv_memset_00(dsc, sizeof(lv_img_decoder_dsc_t));
+    dsc->decoder = &buf_decoder;
+    dsc->header = header;
+    dsc->color = req->color;
+    dsc->frame_id = req->frame_id;
+    dsc->fit_w = req->fit_w;
+    dsc->fit_h = req->fit_h;
+    dsc->img_data = buf;
+
+    lv_mutex_lock(&lock);
+    if(req->src_copy) {
+        /*The source copy goes with the descriptor, `lv_img_decoder_close()` will free it*/
+        dsc->src_type = LV_IMG_SRC_FILE;
+        dsc->src = req->src_copy;
+        req->src_copy = NULL;
+    }
+    else {
+        dsc->src_type = LV_IMG_SRC_VARIABLE;
+        dsc->src = req->src;
+    }
+    lv_mutex_unlock(&lock);
+
+    return LV_RES_OK;
+}
+
+/**
+ * Invalidate the areas where something new can be drawn and free the discarded requests
+ */
+static void timer_cb(lv_timer_t * t)
+{
+    LV_UNUSED(t);
+
+    lv_disp_t * inv_disp[LV_IMG_ASYNC_QUEUE_LEN];
+    lv_area_t inv_area[LV_IMG_ASYNC_QUEUE_LEN];
+    uint32_t inv_cnt = 0;
+    bool active = false;
+
+    lv_mutex_lock(&lock);
+    uint32_t i;
+    for(i = 0; i < LV_IMG_ASYNC_QUEUE_LEN; i++) {
+        req_t * req = &reqs[i];
+        if(req->state == REQ_FREE) continue;
+
+        bool final = req->state == REQ_DONE || req->state == REQ_FAILED || req->state == REQ_TAKEN;
+        if(req->discard) {
+            if(final) req_free(req);
+            else active = true;
+            continue;
+        }
+
+        bool inv = false;
+        if(final) {
+            inv = !req->notified;
+            req->notified = 1;
+        }
+        else {
+            active = true;
+            inv = req->rows_ready != req->rows_shown;
+        }
+        req->rows_shown = req->rows_ready;
+
+        if(inv && req->area_valid) {
+            inv_disp[inv_cnt] = req->disp;
+            inv_area[inv_cnt] = req->area;
+            inv_cnt++;
+        }
+
+        /*Nothing else to do with it*/
+        if(req->state == REQ_TAKEN) req_free(req);
+    }
+
+    if(!active) lv_timer_pause(timer);
+    lv_mutex_unlock(&lock);
+
+    for(i = 0; i < inv_cnt; i++) {
+        /*The display might be removed since then*/
+        lv_disp_t * d = lv_disp_get_next(NULL);
+        while(d && d != inv_disp[i]) d = lv_disp_get_next(d);
+        if(d) _lv_inv_area(d, &inv_area[i]);
+    }
+}
+
+static req_t * find_req(const void * src, lv_color_t color, int32_t frame_id)
+{
+    /*The decoder is not known yet so a request of an other fit size is never used*/
+    lv_coord_t fit_w;
+    lv_coord_t fit_h;
+    lv_img_decoder_get_fit_size(&fit_w, &fit_h);
+
+    uint32_t i;
+    for(i = 0; i < LV_IMG_ASYNC_QUEUE_LEN; i++) {
+        req_t * req = &reqs[i];
+        if(req->state == REQ_FREE || req->state == REQ_TAKEN || req->discard) continue;
+        if(req->fit_w != fit_w || req->fit_h != fit_h) continue;
+        if(req->color.full == color.full && req->frame_id == frame_id && src_match(src, req)) return req;
+    }
+    return NULL;
+}
+
+/**
+ * Get an unused request. Decoded images which were not drawn since then and failed ones are dropped if needed.
+ */
+static req_t * get_free_req(void)
+{
+    req_t * reuse = NULL;
+    uint32_t i;
+    for(i = 0; i < LV_IMG_ASYNC_QUEUE_LEN; i++) {
+        req_t * req = &reqs[i];
+        if(req->state == REQ_FREE) return req;
+        if(req->discard) continue;
+        if(req->state == REQ_DONE || req->state == REQ_FAILED) {
+            if(reuse == NULL || (int32_t)(req->seq - reuse->seq) < 0) reuse = req;
+        }
+    }
+
+    if(reuse) req_free(reuse);
+    return reuse;
+}
+
+static void req_free(req_t * req)
+{
+    if(req->state == REQ_DONE) {
+        lv_img_decoder_close(&req->dsc);
+    }
+    else {
+        /*Owned by the request only if it wasn't handed over*/
+        lv_mem_free(req->buf);
+    }
+    lv_mem_free(req->src_copy);
+    lv_memset_00(req, sizeof(req_t));
+}
+
+static bool src_match(const void * src, const req_t * req)
+{
+    if(req->src == NULL) return false;
+    if(req->src_copy == NULL && lv_img_src_get_type(src) == LV_IMG_SRC_VARIABLE) return src == req->src;
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_FILE) return false;
+    if(lv_img_src_get_type(req->src) != LV_IMG_SRC_FILE) return false;
+    return strcmp(src, req->src) == 0;
+}
+
+/**
+ * Tell if the first decoder which can open the image is the built-in one
+ */
+static bool is_built_in(const void * src)
+{
+    lv_img_header_t header;
+    lv_img_decoder_t * decoder;
+    _LV_LL_READ(&LV_GC_ROOT(_lv_img_decoder_ll), decoder) {
+        if(decoder->info_cb == NULL || decoder->open_cb == NULL) continue;
+        if(decoder->info_cb(decoder, src, &header) != LV_RES_OK) continue;
+        return decoder->info_cb == lv_img_decoder_built_in_info;
+    }
+
+    /*Nobody can open it, let the usual error handling deal with it*/
+    return true;
+}
+
+static void buf_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    lv_mem_free((void *)dsc->img_data);
+    dsc->img_data = NULL;
+}
+
+#endif /*LV_USE_IMG_ASYNC*/
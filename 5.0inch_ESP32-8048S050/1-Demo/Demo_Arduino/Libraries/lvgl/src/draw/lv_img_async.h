@@ -0,0 +1,137 @@
+/**
+ * @file lv_img_async.h
+ * Decode images in a background thread instead of in the middle of the rendering.
+ * While an image is being decoded a placeholder is drawn instead of it, and the
+ * rows which are already decoded are revealed band by band.
+ */
+
+#ifndef LV_IMG_ASYNC_H
+#define LV_IMG_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#if LV_USE_IMG_ASYNC
+
+#include "lv_img_decoder.h"
+#include "../misc/lv_area.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_USE_OS == LV_OS_NONE
+    #error "lv_img_async: LV_USE_OS is required"
+#endif
+
+#if LV_IMG_CACHE_DEF_SIZE == 0
+    #error "lv_img_async: the decoded images are stored in the image cache, LV_IMG_CACHE_DEF_SIZE can't be 0"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+enum {
+    _LV_IMG_ASYNC_SYNC,     /**< The image has to be opened right away (built-in format or the queue is full)*/
+    _LV_IMG_ASYNC_PENDING,  /**< Queued or being decoded, draw a placeholder*/
+    _LV_IMG_ASYNC_READY,    /**< Decoded, the returned descriptor can be cached*/
+    _LV_IMG_ASYNC_FAILED,   /**< The image couldn't be opened*/
+};
+typedef uint8_t _lv_img_async_res_t;
+
+/**
+ * What can be already drawn from a pending image
+ */
+typedef struct {
+    const uint8_t * data;   /**< The image with `header.w * header.h` pixels or NULL if nothing is ready*/
+    lv_img_header_t header;
+    uint32_t rows_ready;    /**< The first `rows_ready` rows of `data` are decoded*/
+} _lv_img_async_progress_t;
+
+/**
+ * Statistics of the background decoding
+ */
+typedef struct {
+    uint32_t req_cnt;       /**< Images queued to the worker*/
+    uint32_t done_cnt;      /**< Images decoded by the worker*/
+    uint32_t fail_cnt;      /**< Images the worker couldn't open*/
+    uint32_t sync_cnt;      /**< Images opened in the UI thread because the queue was full*/
+    uint32_t decode_time;   /**< Sum of the time the worker spent with decoding [ms]*/
+} lv_img_async_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start the worker thread. Called by `lv_init()`.
+ */
+void _lv_img_async_init(void);
+
+/**
+ * Open an image which is not in the image cache.
+ * Called by the image cache on a miss.
+ * @param dsc       the decoded image is copied here if `_LV_IMG_ASYNC_READY` is returned.
+ *                  It belongs to the caller from then on and has to be closed by `lv_img_decoder_close()`.
+ * @param src       source of the image
+ * @param color     color of `LV_IMG_CF_ALPHA_...` images
+ * @param frame_id  index of the frame
+ * @return          see `_lv_img_async_res_t`
+ */
+_lv_img_async_res_t _lv_img_async_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color,
+                                       int32_t frame_id);
+
+/**
+ * Get the rows of a pending image which can be drawn already.
+ * The area is remembered and invalidated when new rows are ready or the image is decoded.
+ * @param src       source of the image
+ * @param color     color of `LV_IMG_CF_ALPHA_...` images
+ * @param frame_id  index of the frame
+ * @param area      the area on the display where the image is drawn
+ * @param progress  store the result here
+ * @return          true: the image is pending; false: it's not queued or it has failed
+ */
+bool _lv_img_async_get_progress(const void * src, lv_color_t color, int32_t frame_id, const lv_area_t * area,
+                                _lv_img_async_progress_t * progress);
+
+/**
+ * Drop the queued and decoded but not yet cached versions of an image.
+ * Called by `lv_img_cache_invalidate_src()`.
+ * @param src source of an image or NULL to drop everything
+ */
+void _lv_img_async_invalidate_src(const void * src);
+
+/**
+ * Enable or disable the background decoding. When disabled every image is opened in the UI thread again.
+ * Useful e.g. to take screenshots with every image already drawn.
+ * @param en true: enable; false: disable
+ */
+void lv_img_async_enable(bool en);
+
+/**
+ * Tell whether images are waiting for or being decoded by the worker
+ * @return true: the worker has something to do
+ */
+bool lv_img_async_is_busy(void);
+
+void lv_img_async_get_stat(lv_img_async_stat_t * stat);
+
+void lv_img_async_reset_stat(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_IMG_ASYNC*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_IMG_ASYNC_H*/
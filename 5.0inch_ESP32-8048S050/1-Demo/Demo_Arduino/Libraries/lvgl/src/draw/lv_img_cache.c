@@ -9,6 +9,7 @@
 #include "../misc/lv_assert.h"
 #include "lv_img_cache.h"
 #include "lv_img_decoder.h"
+#include "lv_img_async.h"
 #include "lv_draw_img.h"
 #include "../hal/lv_hal_tick.h"
 #include "../misc/lv_gc.h"
@@ -16,15 +17,8 @@
 /*********************
  *      DEFINES
  *********************/
-/*Decrement life with this value on every open*/
-#define LV_IMG_CACHE_AGING 1
-
-/*Boost life by this factor (multiply time_to_open with this value)*/
-#define LV_IMG_CACHE_LIFE_GAIN 1
-
-/*Don't let life to be greater than this limit because it would require a lot of time to
- * "die" from very high values*/
-#define LV_IMG_CACHE_LIFE_LIMIT 1000
+/*Marks the end of the LRU, free and bucket lists*/
+#define CACHE_NONE 0xFFFF
 
 /**********************
  *      TYPEDEFS
@@ -33,8 +27,16 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static _lv_img_cache_entry_t * cache_open(const void * src, lv_color_t color, int32_t frame_id, bool allow_async);
 #if LV_IMG_CACHE_DEF_SIZE
     static bool lv_img_cache_match(const void * src1, const void * src2);
+    static uint32_t get_hash(const void * src, lv_color_t color, int32_t frame_id);
+    static uint16_t find_entry(const void * src, lv_color_t color, int32_t frame_id, uint32_t hash);
+    static uint32_t get_decoded_size(const lv_img_decoder_dsc_t * dsc);
+    static void lru_unlink(uint16_t i);
+    static void lru_push_front(uint16_t i);
+    static void entry_close(uint16_t i);
+    static void shrink_to_max_bytes(uint16_t keep);
 #endif
 
 /**********************
@@ -42,6 +44,15 @@
  **********************/
 #if LV_IMG_CACHE_DEF_SIZE
     static uint16_t entry_cnt;
+    static uint16_t * buckets;      /*Stored after the entries in `_lv_img_cache_array`*/
+    static uint16_t bucket_mask;
+    static uint16_t lru_head;       /*Most recently used*/
+    static uint16_t lru_tail;       /*Least recently used, closed first*/
+    static uint16_t free_head;
+    static uint32_t cache_size;
+    static uint32_t max_bytes = LV_IMG_CACHE_DEF_BYTES;
+    static lv_img_cache_stat_t cache_stat;
+    static _lv_img_cache_entry_t uncached_entry;   /*Opened when every entry is pinned, closed after the draw*/
 #endif
 
 /**********************
@@ -62,82 +73,7 @@
  */
 _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, int32_t frame_id)
 {
-    /*Is the image cached?*/
-    _lv_img_cache_entry_t * cached_src = NULL;
-
-#if LV_IMG_CACHE_DEF_SIZE
-    if(entry_cnt == 0) {
-        LV_LOG_WARN("lv_img_cache_open: the cache size is 0");
-        return NULL;
-    }
-
-    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
-
-    /*Decrement all lifes. Make the entries older*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].life > INT32_MIN + LV_IMG_CACHE_AGING) {
-            cache[i].life -= LV_IMG_CACHE_AGING;
-        }
-    }
-
-    for(i = 0; i < entry_cnt; i++) {
-        if(color.full == cache[i].dec_dsc.color.full &&
-           frame_id == cache[i].dec_dsc.frame_id &&
-           lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            /*If opened increment its life.
-             *Image difficult to open should live longer to keep avoid frequent their recaching.
-             *Therefore increase `life` with `time_to_open`*/
-            cached_src = &cache[i];
-            cached_src->life += cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
-            if(cached_src->life > LV_IMG_CACHE_LIFE_LIMIT) cached_src->life = LV_IMG_CACHE_LIFE_LIMIT;
-            LV_LOG_TRACE("image source found in the cache");
-            break;
-        }
-    }
-
-    /*The image is not cached then cache it now*/
-    if(cached_src) return cached_src;
-
-    /*Find an entry to reuse. Select the entry with the least life*/
-    cached_src = &cache[0];
-    for(i = 1; i < entry_cnt; i++) {
-        if(cache[i].life < cached_src->life) {
-            cached_src = &cache[i];
-        }
-    }
-
-    /*Close the decoder to reuse if it was opened (has a valid source)*/
-    if(cached_src->dec_dsc.src) {
-        lv_img_decoder_close(&cached_src->dec_dsc);
-        LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
-    }
-    else {
-        LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
-    }
-#else
-    cached_src = &LV_GC_ROOT(_lv_img_cache_single);
-#endif
-    /*Open the image and measure the time to open*/
-    uint32_t t_start  = lv_tick_get();
-    lv_res_t open_res = lv_img_decoder_open(&cached_src->dec_dsc, src, color, frame_id);
-    if(open_res == LV_RES_INV) {
-        LV_LOG_WARN("Image draw cannot open the image resource");
-        lv_memset_00(cached_src, sizeof(_lv_img_cache_entry_t));
-        cached_src->life = INT32_MIN; /*Make the empty entry very "weak" to force its us*/
-        return NULL;
-    }
-
-    cached_src->life = 0;
-
-    /*If `time_to_open` was not set in the open function set it here*/
-    if(cached_src->dec_dsc.time_to_open == 0) {
-        cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
-    }
-
-    if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
-
-    return cached_src;
+    return cache_open(src, color, frame_id, true);
 }
 
 /**
@@ -158,17 +94,48 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
         lv_mem_free(LV_GC_ROOT(_lv_img_cache_array));
     }
 
+    /*The last index marks the end of the lists*/
+    if(new_entry_cnt >= CACHE_NONE) new_entry_cnt = CACHE_NONE - 1;
+
+    /*At least as many buckets as entries, and a power of 2*/
+    uint32_t bucket_cnt = 1;
+    while(bucket_cnt < new_entry_cnt) bucket_cnt <<= 1;
+
     /*Reallocate the cache*/
-    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(_lv_img_cache_entry_t) * new_entry_cnt);
+    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(_lv_img_cache_entry_t) * new_entry_cnt +
+                                                   sizeof(uint16_t) * bucket_cnt);
     LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_img_cache_array));
     if(LV_GC_ROOT(_lv_img_cache_array) == NULL) {
         entry_cnt = 0;
         return;
     }
     entry_cnt = new_entry_cnt;
+    buckets = (uint16_t *)&LV_GC_ROOT(_lv_img_cache_array)[entry_cnt];
+    bucket_mask = bucket_cnt - 1;
 
     /*Clean the cache*/
-    lv_memset_00(LV_GC_ROOT(_lv_img_cache_array), entry_cnt * sizeof(_lv_img_cache_entry_t));
+    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    lv_memset_00(cache, entry_cnt * sizeof(_lv_img_cache_entry_t));
+    lv_memset_ff(buckets, bucket_cnt * sizeof(uint16_t));
+
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        cache[i].next = i + 1 < entry_cnt ? i + 1 : CACHE_NONE;
+    }
+    free_head = entry_cnt ? 0 : CACHE_NONE;
+    lru_head = CACHE_NONE;
+    lru_tail = CACHE_NONE;
+    cache_size = 0;
+#endif
+}
+
+void lv_img_cache_set_max_bytes(uint32_t new_max_bytes)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    max_bytes = new_max_bytes;
+    shrink_to_max_bytes(CACHE_NONE);
+#else
+    LV_UNUSED(new_max_bytes);
 #endif
 }
 
@@ -180,26 +147,232 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
 void lv_img_cache_invalidate_src(const void * src)
 {
     LV_UNUSED(src);
+#if LV_USE_IMG_ASYNC
+    _lv_img_async_invalidate_src(src);
+#endif
 #if LV_IMG_CACHE_DEF_SIZE
     _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
 
     uint16_t i;
     for(i = 0; i < entry_cnt; i++) {
+        if(cache[i].dec_dsc.src == NULL) continue;
         if(src == NULL || lv_img_cache_match(src, cache[i].dec_dsc.src)) {
-            if(cache[i].dec_dsc.src != NULL) {
-                lv_img_decoder_close(&cache[i].dec_dsc);
-            }
-
-            lv_memset_00(&cache[i], sizeof(_lv_img_cache_entry_t));
+            entry_close(i);
         }
     }
 #endif
 }
 
+lv_res_t lv_img_cache_pin_src(const void * src, lv_color_t color)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    /*Pinned images are needed right away*/
+    _lv_img_cache_entry_t * entry = cache_open(src, color, 0, false);
+    if(entry == NULL) return LV_RES_INV;
+    if(entry == &uncached_entry) {
+        /*Every entry is pinned already*/
+        _lv_img_cache_release(entry);
+        return LV_RES_INV;
+    }
+
+    uint16_t i = (uint16_t)(entry - LV_GC_ROOT(_lv_img_cache_array));
+    if(entry->pin_cnt == 0) lru_unlink(i);
+    entry->pin_cnt++;
+    return LV_RES_OK;
+#else
+    LV_UNUSED(src);
+    LV_UNUSED(color);
+    return LV_RES_INV;
+#endif
+}
+
+void lv_img_cache_unpin_src(const void * src, lv_color_t color)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    if(entry_cnt == 0) return;
+
+    uint16_t i = find_entry(src, color, 0, get_hash(src, color, 0));
+    if(i == CACHE_NONE) return;
+
+    _lv_img_cache_entry_t * entry = &LV_GC_ROOT(_lv_img_cache_array)[i];
+    if(entry->pin_cnt == 0) return;
+
+    entry->pin_cnt--;
+    if(entry->pin_cnt == 0) {
+        lru_push_front(i);
+        shrink_to_max_bytes(CACHE_NONE);
+    }
+#else
+    LV_UNUSED(src);
+    LV_UNUSED(color);
+#endif
+}
+
+/**
+ * Release an entry returned by `_lv_img_cache_open()` after it was drawn.
+ * Images opened without caching are closed here, cached ones stay open.
+ * @param entry the entry returned by `_lv_img_cache_open()`
+ */
+void _lv_img_cache_release(_lv_img_cache_entry_t * entry)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    if(entry != &uncached_entry) return;
+#endif
+    lv_img_decoder_close(&entry->dec_dsc);
+    lv_memset_00(entry, sizeof(_lv_img_cache_entry_t));
+}
+
+void lv_img_cache_get_stat(lv_img_cache_stat_t * stat)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    *stat = cache_stat;
+    stat->size = cache_size;
+    stat->entry_cnt = 0;
+
+    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        if(cache[i].dec_dsc.src) stat->entry_cnt++;
+    }
+#else
+    lv_memset_00(stat, sizeof(lv_img_cache_stat_t));
+#endif
+}
+
+void lv_img_cache_reset_stat(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_memset_00(&cache_stat, sizeof(lv_img_cache_stat_t));
+#endif
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Open an image and cache it
+ * @param allow_async true: images of custom decoders can be decoded in the background (`NULL` is returned meanwhile)
+ */
+static _lv_img_cache_entry_t * cache_open(const void * src, lv_color_t color, int32_t frame_id, bool allow_async)
+{
+    /*Is the image cached?*/
+    _lv_img_cache_entry_t * cached_src = NULL;
+
+#if LV_IMG_CACHE_DEF_SIZE
+    if(entry_cnt == 0) {
+        LV_LOG_WARN("lv_img_cache_open: the cache size is 0");
+        return NULL;
+    }
+
+    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+
+    uint32_t hash = get_hash(src, color, frame_id);
+    uint16_t i = find_entry(src, color, frame_id, hash);
+    if(i != CACHE_NONE) {
+        cached_src = &cache[i];
+        if(cached_src->pin_cnt == 0) {
+            lru_unlink(i);
+            lru_push_front(i);
+        }
+        cache_stat.hit_cnt++;
+        LV_LOG_TRACE("image source found in the cache");
+        return cached_src;
+    }
+
+    /*Every entry is pinned, i.e. in use, so none of them can be closed.
+     *Open the image without caching it, it's closed after the draw.*/
+    bool uncached = free_head == CACHE_NONE && lru_tail == CACHE_NONE;
+
+#if LV_USE_IMG_ASYNC
+    /*Leave the slow decoders to the worker and draw a placeholder meanwhile*/
+    lv_img_decoder_dsc_t async_dsc;
+    _lv_img_async_res_t async_res = _LV_IMG_ASYNC_SYNC;
+    if(allow_async && !uncached) async_res = _lv_img_async_open(&async_dsc, src, color, frame_id);
+    if(async_res == _LV_IMG_ASYNC_PENDING || async_res == _LV_IMG_ASYNC_FAILED) return NULL;
+#else
+    LV_UNUSED(allow_async);
+#endif
+
+    /*The image is not cached then cache it now*/
+    cache_stat.miss_cnt++;
+
+    if(uncached) {
+        LV_LOG_WARN("image draw: every cache entry is pinned, open the image without caching it");
+        cached_src = &uncached_entry;
+    }
+    else {
+        /*Close the least recently used image if there is no free entry*/
+        if(free_head == CACHE_NONE) {
+            entry_close(lru_tail);
+            cache_stat.evict_cnt++;
+            LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
+        }
+        else {
+            LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
+        }
+
+        i = free_head;
+        cached_src = &cache[i];
+        free_head = cached_src->next;
+    }
+#else
+    LV_UNUSED(allow_async);
+    cached_src = &LV_GC_ROOT(_lv_img_cache_single);
+#endif
+    /*Open the image and measure the time to open*/
+    uint32_t t_start  = lv_tick_get();
+    lv_res_t open_res;
+#if LV_USE_IMG_ASYNC
+    if(async_res == _LV_IMG_ASYNC_READY) {
+        cached_src->dec_dsc = async_dsc;
+        open_res = LV_RES_OK;
+    }
+    else
+#endif
+    {
+        open_res = lv_img_decoder_open(&cached_src->dec_dsc, src, color, frame_id);
+    }
+    if(open_res == LV_RES_INV) {
+        LV_LOG_WARN("Image draw cannot open the image resource");
+        lv_memset_00(cached_src, sizeof(_lv_img_cache_entry_t));
+#if LV_IMG_CACHE_DEF_SIZE
+        if(!uncached) {
+            cached_src->next = free_head;
+            free_head = i;
+        }
+#endif
+        return NULL;
+    }
+
+    /*If `time_to_open` was not set in the open function set it here*/
+    if(cached_src->dec_dsc.time_to_open == 0) {
+        cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
+    }
+
+    if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
+
+#if LV_IMG_CACHE_DEF_SIZE
+    cache_stat.decode_time += cached_src->dec_dsc.time_to_open;
+    if(uncached) return cached_src;
+
+    cached_src->hash = hash;
+    cached_src->pin_cnt = 0;
+    cached_src->size = get_decoded_size(&cached_src->dec_dsc);
+    cache_size += cached_src->size;
+
+    uint16_t * bucket = &buckets[hash & bucket_mask];
+    cached_src->hash_next = *bucket;
+    *bucket = i;
+    lru_push_front(i);
+
+    /*Make room for the new image but keep it as it's about to be drawn*/
+    shrink_to_max_bytes(i);
+#endif
+
+    return cached_src;
+}
+
 #if LV_IMG_CACHE_DEF_SIZE
 static bool lv_img_cache_match(const void * src1, const void * src2)
 {
@@ -212,4 +385,128 @@ static bool lv_img_cache_match(const void * src1, const void * src2)
         return false;
     return strcmp(src1, src2) == 0;
 }
+
+static uint32_t get_hash(const void * src, lv_color_t color, int32_t frame_id)
+{
+    uint32_t h;
+    if(lv_img_src_get_type(src) == LV_IMG_SRC_FILE) {
+        /*FNV-1a of the path*/
+        const uint8_t * p = src;
+        h = 2166136261U;
+        while(*p) {
+            h ^= *p;
+            h *= 16777619U;
+            p++;
+        }
+    }
+    else {
+        h = (uint32_t)((lv_uintptr_t)src >> 2);
+    }
+
+    h ^= (uint32_t)color.full * 0x9E3779B1U;
+    h ^= (uint32_t)frame_id * 0x85EBCA77U;
+
+    /*Mix the high bits into the low bits used for the bucket index*/
+    h ^= h >> 16;
+    h *= 0x7FEB352DU;
+    h ^= h >> 15;
+    return h;
+}
+
+/**
+ * Find an opened entry
+ * @return index of the entry or `CACHE_NONE` if not found
+ */
+static uint16_t find_entry(const void * src, lv_color_t color, int32_t frame_id, uint32_t hash)
+{
+    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    uint16_t i;
+    for(i = buckets[hash & bucket_mask]; i != CACHE_NONE; i = cache[i].hash_next) {
+        if(cache[i].hash == hash &&
+           color.full == cache[i].dec_dsc.color.full &&
+           frame_id == cache[i].dec_dsc.frame_id &&
+           lv_img_cache_match(src, cache[i].dec_dsc.src) &&
+           _lv_img_decoder_fit_match(&cache[i].dec_dsc)) {
+            return i;
+        }
+    }
+
+    return CACHE_NONE;
+}
+
+/**
+ * Bytes of the decoded image kept in RAM by an opened image
+ */
+static uint32_t get_decoded_size(const lv_img_decoder_dsc_t * dsc)
+{
+    /*Decoded line by line. The decoder might have some small buffers but not the image.*/
+    if(dsc->img_data == NULL) return 0;
+
+    /*The built-in decoder just points to the image's own data*/
+    if(dsc->src_type == LV_IMG_SRC_VARIABLE && dsc->img_data == ((const lv_img_dsc_t *)dsc->src)->data) return 0;
+
+    return lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, dsc->header.cf);
+}
+
+static void lru_unlink(uint16_t i)
+{
+    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    if(cache[i].prev != CACHE_NONE) cache[cache[i].prev].next = cache[i].next;
+    else lru_head = cache[i].next;
+    if(cache[i].next != CACHE_NONE) cache[cache[i].next].prev = cache[i].prev;
+    else lru_tail = cache[i].prev;
+}
+
+static void lru_push_front(uint16_t i)
+{
+    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    cache[i].prev = CACHE_NONE;
+    cache[i].next = lru_head;
+    if(lru_head != CACHE_NONE) cache[lru_head].prev = i;
+    else lru_tail = i;
+    lru_head = i;
+}
+
+/**
+ * Close an opened entry and put it to the free list
+ */
+static void entry_close(uint16_t i)
+{
+    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    _lv_img_cache_entry_t * entry = &cache[i];
+
+    uint16_t * p = &buckets[entry->hash & bucket_mask];
+    while(*p != i) p = &cache[*p].hash_next;
+    *p = entry->hash_next;
+
+    if(entry->pin_cnt == 0) lru_unlink(i);
+
+    lv_img_decoder_close(&entry->dec_dsc);
+    cache_size -= entry->size;
+
+    lv_memset_00(entry, sizeof(_lv_img_cache_entry_t));
+    entry->next = free_head;
+    free_head = i;
+}
+
+/**
+ * Close the least recently used images until the cache fits into `max_bytes`
+ * @param keep index of an entry which can't be closed or `CACHE_NONE`
+ */
+static void shrink_to_max_bytes(uint16_t keep)
+{
+    if(max_bytes == 0) return;
+
+    _lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    uint16_t i = lru_tail;
+    while(cache_size > max_bytes && i != CACHE_NONE) {
+        uint16_t prev = cache[i].prev;
+        /*Closing images which don't take memory wouldn't help*/
+        if(i != keep && cache[i].size > 0) {
+            entry_close(i);
+            cache_stat.evict_cnt++;
+        }
+        i = prev;
+    }
+}
 #endif
@@ -27,16 +27,32 @@ extern "C" {
  * When loading images from the network it can take a long time to download and decode the image.
  *
  * To avoid repeating this heavy load images can be cached.
+ * The entries are found by a hash of the source, color and frame and the least recently used one is closed
+ * when a new image doesn't fit.
  */
 typedef struct {
     lv_img_decoder_dsc_t dec_dsc; /**< Image information*/
 
-    /** Count the cache entries's life. Add `time_to_open` to `life` when the entry is used.
-     * Decrement all lifes by one every in every ::lv_img_cache_open.
-     * If life == 0 the entry can be reused*/
-    int32_t life;
+    uint32_t size;          /**< Bytes of decoded image data kept by the entry*/
+    uint32_t hash;          /**< Hash of the source, color and frame*/
+    uint16_t prev;          /**< Previous (more recently used) entry in the LRU list*/
+    uint16_t next;          /**< Next (less recently used) entry in the LRU list or in the free list*/
+    uint16_t hash_next;     /**< Next entry in the same hash bucket*/
+    uint16_t pin_cnt;       /**< Pinned entries are not in the LRU list and are not closed to make room*/
 } _lv_img_cache_entry_t;
 
+/**
+ * Statistics of the image cache
+ */
+typedef struct {
+    uint32_t hit_cnt;       /**< Opened images found in the cache*/
+    uint32_t miss_cnt;      /**< Opened images which had to be decoded*/
+    uint32_t evict_cnt;     /**< Entries closed to make room for a new image*/
+    uint32_t decode_time;   /**< Sum of the time to open of the missed images [ms]*/
+    uint32_t entry_cnt;     /**< Number of opened images in the cache*/
+    uint32_t size;          /**< Bytes of decoded image data in the cache*/
+} lv_img_cache_stat_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -48,10 +64,18 @@ typedef struct {
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
  * @param frame_id the index of the frame. Used only with animated images, set 0 for normal images
- * @return pointer to the cache entry or NULL if can open the image
+ * @return pointer to the cache entry or NULL if can open the image.
+ *         Has to be released with `_lv_img_cache_release()` after the draw.
  */
 _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, int32_t frame_id);
 
+/**
+ * Release an entry returned by `_lv_img_cache_open()` after it was drawn.
+ * Images opened without caching (cache disabled or every entry pinned) are closed here.
+ * @param entry the entry returned by `_lv_img_cache_open()`
+ */
+void _lv_img_cache_release(_lv_img_cache_entry_t * entry);
+
 /**
  * Set the number of images to be cached.
  * More cached images mean more opened image at same time which might mean more memory usage.
@@ -60,6 +84,14 @@ _lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color, i
  */
 void lv_img_cache_set_size(uint16_t new_slot_num);
 
+/**
+ * Limit the memory used by the decoded images in the cache.
+ * The least recently used images are closed to stay below the limit.
+ * Images not decoded to RAM (e.g. C arrays drawn by the built-in decoder) don't count.
+ * @param max_bytes the limit in bytes, 0: limit only the number of images
+ */
+void lv_img_cache_set_max_bytes(uint32_t max_bytes);
+
 /**
  * Invalidate an image source in the cache.
  * Useful if the image source is updated therefore it needs to be cached again.
@@ -67,6 +99,35 @@ void lv_img_cache_set_size(uint16_t new_slot_num);
  */
 void lv_img_cache_invalidate_src(const void * src);
 
+/**
+ * Open an image into the cache (if it's not there yet) and keep it there even if the cache is over its byte limit.
+ * Useful for images which are on the screen and expensive to decode.
+ * Every pin has to be released with `lv_img_cache_unpin_src()`.
+ * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
+ * @param color the recolor of the image as it's drawn (`img_recolor` style property)
+ * @return LV_RES_OK: pinned; LV_RES_INV: the image couldn't be opened, every entry is pinned or the cache is disabled
+ * @note `lv_img_cache_invalidate_src()` removes the pins of the source too
+ */
+lv_res_t lv_img_cache_pin_src(const void * src, lv_color_t color);
+
+/**
+ * Release a pin set by `lv_img_cache_pin_src()`
+ * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
+ * @param color the same color as in `lv_img_cache_pin_src()`
+ */
+void lv_img_cache_unpin_src(const void * src, lv_color_t color);
+
+/**
+ * Get the statistics of the image cache
+ * @param stat pointer to a `lv_img_cache_stat_t` variable to store the result
+ */
+void lv_img_cache_get_stat(lv_img_cache_stat_t * stat);
+
+/**
+ * Reset the hit, miss, eviction and decode time counters
+ */
+void lv_img_cache_reset_stat(void);
+
 /**********************
  *      MACROS
  **********************/
@@ -41,6 +41,8 @@ static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc,
 /**********************
  *  STATIC VARIABLES
  **********************/
+static lv_coord_t fit_w;
+static lv_coord_t fit_h;
 
 /**********************
  *      MACROS
@@ -97,7 +99,10 @@ lv_res_t lv_img_decoder_get_info(const void * src, lv_img_header_t * header)
     _LV_LL_READ(&LV_GC_ROOT(_lv_img_decoder_ll), d) {
         if(d->info_cb) {
             res = d->info_cb(d, src, header);
-            if(res == LV_RES_OK) break;
+            if(res == LV_RES_OK) {
+                if(d->fit_cb && (fit_w > 0 || fit_h > 0)) d->fit_cb(d, src, header, fit_w, fit_h);
+                break;
+            }
         }
     }
 
@@ -105,6 +110,12 @@ lv_res_t lv_img_decoder_get_info(const void * src, lv_img_header_t * header)
 }
 
 lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color, int32_t frame_id)
+{
+    return _lv_img_decoder_open_fit(dsc, src, color, frame_id, fit_w, fit_h);
+}
+
+lv_res_t _lv_img_decoder_open_fit(lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color, int32_t frame_id,
+                                  lv_coord_t w, lv_coord_t h)
 {
     lv_memset_00(dsc, sizeof(lv_img_decoder_dsc_t));
 
@@ -118,6 +129,8 @@ lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_co
     dsc->color    = color;
     dsc->src_type = src_type;
     dsc->frame_id = frame_id;
+    dsc->fit_w    = w;
+    dsc->fit_h    = h;
 
     if(dsc->src_type == LV_IMG_SRC_FILE) {
         size_t fnlen = strlen(src);
@@ -142,6 +155,7 @@ lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_co
 
         res = decoder->info_cb(decoder, src, &dsc->header);
         if(res != LV_RES_OK) continue;
+        if(decoder->fit_cb && (w > 0 || h > 0)) decoder->fit_cb(decoder, src, &dsc->header, w, h);
 
         dsc->decoder = decoder;
         res = decoder->open_cb(decoder, dsc);
@@ -164,6 +178,24 @@ lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_co
     return res;
 }
 
+void lv_img_decoder_set_fit_size(lv_coord_t w, lv_coord_t h)
+{
+    fit_w = w;
+    fit_h = h;
+}
+
+void lv_img_decoder_get_fit_size(lv_coord_t * w, lv_coord_t * h)
+{
+    *w = fit_w;
+    *h = fit_h;
+}
+
+bool _lv_img_decoder_fit_match(const lv_img_decoder_dsc_t * dsc)
+{
+    if(dsc->decoder == NULL || dsc->decoder->fit_cb == NULL) return true;
+    return dsc->fit_w == fit_w && dsc->fit_h == fit_h;
+}
+
 /**
  * Read a line from an opened image
  * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
@@ -263,6 +295,16 @@ void lv_img_decoder_set_close_cb(lv_img_decoder_t * decoder, lv_img_decoder_clos
     decoder->close_cb = close_cb;
 }
 
+/**
+ * Set a callback to get the size the decoder scales the images to
+ * @param decoder pointer to an image decoder
+ * @param fit_cb a function to adjust the size of an image to the size it's decoded in
+ */
+void lv_img_decoder_set_fit_cb(lv_img_decoder_t * decoder, lv_img_decoder_fit_f_t fit_cb)
+{
+    decoder->fit_cb = fit_cb;
+}
+
 /**
  * Get info about a built-in image
  * @param decoder the decoder where this function belongs
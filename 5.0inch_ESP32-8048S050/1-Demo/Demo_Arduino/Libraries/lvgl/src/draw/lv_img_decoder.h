@@ -82,12 +82,24 @@ typedef lv_res_t (*lv_img_decoder_read_line_f_t)(struct _lv_img_decoder_t * deco
  */
 typedef void (*lv_img_decoder_close_f_t)(struct _lv_img_decoder_t * decoder, struct _lv_img_decoder_dsc_t * dsc);
 
+/**
+ * Adjust the size of an image to the size it's decoded in to cover a given size.
+ * Required only by decoders which can scale down the images while decoding.
+ * @param decoder pointer to the decoder the function associated with
+ * @param src the image source
+ * @param header the info of the image in its original size. Only `w` and `h` should be changed.
+ * @param fit_w the width to cover or 0 to care only about the height
+ * @param fit_h the height to cover or 0 to care only about the width
+ */
+typedef void (*lv_img_decoder_fit_f_t)(struct _lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header,
+                                       lv_coord_t fit_w, lv_coord_t fit_h);
 
 typedef struct _lv_img_decoder_t {
     lv_img_decoder_info_f_t info_cb;
     lv_img_decoder_open_f_t open_cb;
     lv_img_decoder_read_line_f_t read_line_cb;
     lv_img_decoder_close_f_t close_cb;
+    lv_img_decoder_fit_f_t fit_cb;
 
 #if LV_USE_USER_DATA
     void * user_data;
@@ -109,6 +121,11 @@ typedef struct _lv_img_decoder_dsc_t {
     /**Frame of the image, using with animated images*/
     int32_t frame_id;
 
+    /**The size to cover if the decoder can scale down the image (see `lv_img_decoder_set_fit_size()`).
+     * Set when the image is opened, the decoder should use only these and not the current setting.*/
+    lv_coord_t fit_w;
+    lv_coord_t fit_h;
+
     /**Type of the source: file or variable. Can be set in `open` function if required*/
     lv_img_src_t src_type;
 
@@ -167,6 +184,45 @@ lv_res_t lv_img_decoder_get_info(const void * src, lv_img_header_t * header);
  */
 lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color, int32_t frame_id);
 
+/**
+ * Open an image to cover the given size instead of the size set by `lv_img_decoder_set_fit_size()`.
+ * Used when the image is opened in an other thread than where the setting can change.
+ * @param dsc describes a decoding session. Simply a pointer to an `lv_img_decoder_dsc_t` variable.
+ * @param src the image source
+ * @param color The color of the image with `LV_IMG_CF_ALPHA_...`
+ * @param frame_id the index of the frame. Used only with animated images, set 0 for normal images
+ * @param fit_w the width to cover or 0 to care only about the height
+ * @param fit_h the height to cover or 0 to care only about the width
+ * @return LV_RES_OK: opened the image; LV_RES_INV: none of the image decoders were able to open the image.
+ */
+lv_res_t _lv_img_decoder_open_fit(lv_img_decoder_dsc_t * dsc, const void * src, lv_color_t color, int32_t frame_id,
+                                  lv_coord_t fit_w, lv_coord_t fit_h);
+
+/**
+ * Decode the images only in the size needed if the decoder can scale them down while decoding
+ * (e.g. JPGs with `LV_USE_SJPG`). It's much faster and uses much less memory for large photos.
+ * @param w     the width to cover or 0 to care only about the height
+ * @param h     the height to cover or 0 to care only about the width
+ * @note        `w = 0` and `h = 0` (default) means decoding the images in their original size.
+ *              It affects the images opened after it. The image cache keeps the images of
+ *              every fit size separately.
+ */
+void lv_img_decoder_set_fit_size(lv_coord_t w, lv_coord_t h);
+
+/**
+ * Get the size set by `lv_img_decoder_set_fit_size()`
+ * @param w     store the width to cover here
+ * @param h     store the height to cover here
+ */
+void lv_img_decoder_get_fit_size(lv_coord_t * w, lv_coord_t * h);
+
+/**
+ * Tell whether an opened image looks the same as it'd be opened with the current fit size
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @return true: the decoder doesn't scale or it was opened with the current fit size
+ */
+bool _lv_img_decoder_fit_match(const lv_img_decoder_dsc_t * dsc);
+
 /**
  * Read a line from an opened image
  * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
@@ -225,6 +281,13 @@ void lv_img_decoder_set_read_line_cb(lv_img_decoder_t * decoder, lv_img_decoder_
  */
 void lv_img_decoder_set_close_cb(lv_img_decoder_t * decoder, lv_img_decoder_close_f_t close_cb);
 
+/**
+ * Set a callback to get the size the decoder scales the images to. Only for decoders which can scale.
+ * @param decoder pointer to an image decoder
+ * @param fit_cb a function to adjust the size of an image to the size it's decoded in
+ */
+void lv_img_decoder_set_fit_cb(lv_img_decoder_t * decoder, lv_img_decoder_fit_f_t fit_cb);
+
 /**
  * Get info about a built-in image
  * @param decoder the decoder where this function belongs
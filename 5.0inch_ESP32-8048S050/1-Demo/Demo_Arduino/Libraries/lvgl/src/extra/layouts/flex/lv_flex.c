@@ -24,6 +24,7 @@ typedef struct {
     uint8_t row : 1;
     uint8_t wrap : 1;
     uint8_t rev : 1;
+    lv_area_t inv_area;     /*Where the moved items were and are, invalidated once at the end*/
 } flex_t;
 
 typedef struct {
@@ -61,6 +62,7 @@ static void children_repos(lv_obj_t * cont, flex_t * f, int32_t item_first_id, i
 static void place_content(lv_flex_align_t place, lv_coord_t max_size, lv_coord_t content_size, lv_coord_t item_cnt,
                           lv_coord_t * start_pos, lv_coord_t * gap);
 static lv_obj_t * get_next_item(lv_obj_t * cont, bool rev, int32_t * item_id);
+static void invalidate_item(flex_t * f, lv_obj_t * item);
 
 /**********************
  *  GLOBAL VARIABLES
@@ -219,6 +221,7 @@ static void flex_update(lv_obj_t * cont, void * user_data)
     f.main_place = lv_obj_get_style_flex_main_place(cont, LV_PART_MAIN);
     f.cross_place = lv_obj_get_style_flex_cross_place(cont, LV_PART_MAIN);
     f.track_place = lv_obj_get_style_flex_track_place(cont, LV_PART_MAIN);
+    lv_area_set(&f.inv_area, LV_COORD_MAX, LV_COORD_MAX, LV_COORD_MIN, LV_COORD_MIN);
 
     bool rtl = lv_obj_get_style_base_dir(cont, LV_PART_MAIN) == LV_BASE_DIR_RTL ? true : false;
     lv_coord_t track_gap = !f.row ? lv_obj_get_style_pad_column(cont, LV_PART_MAIN) : lv_obj_get_style_pad_row(cont,
@@ -302,6 +305,8 @@ static void flex_update(lv_obj_t * cont, void * user_data)
     }
     LV_ASSERT_MEM_INTEGRITY();
 
+    if(f.inv_area.x1 <= f.inv_area.x2) lv_obj_invalidate_area(cont, &f.inv_area);
+
     if(w_set == LV_SIZE_CONTENT || h_set == LV_SIZE_CONTENT) {
         lv_obj_refr_size(cont);
     }
@@ -520,12 +525,12 @@ static void children_repos(lv_obj_t * cont, flex_t * f, int32_t item_first_id, i
         diff_y += f->row ? cross_pos : main_pos;
 
         if(diff_x || diff_y) {
-            lv_obj_invalidate(item);
+            invalidate_item(f, item);
             item->coords.x1 += diff_x;
             item->coords.x2 += diff_x;
             item->coords.y1 += diff_y;
             item->coords.y2 += diff_y;
-            lv_obj_invalidate(item);
+            invalidate_item(f, item);
             lv_obj_move_children_by(item, diff_x, diff_y, false);
         }
 
@@ -536,6 +541,23 @@ static void children_repos(lv_obj_t * cont, flex_t * f, int32_t item_first_id, i
     }
 }
 
+/**
+ * Add the area of an item to the area to invalidate.
+ * When many items move (e.g. one item in a long list grew) checking the visibility of each is expensive.
+ */
+static void invalidate_item(flex_t * f, lv_obj_t * item)
+{
+    /*The area of transformed items is calculated by the object*/
+    if(_lv_obj_get_layer_type(item) == LV_LAYER_TYPE_TRANSFORM) {
+        lv_obj_invalidate(item);
+        return;
+    }
+
+    lv_area_t a = item->coords;
+    lv_area_increase(&a, _lv_obj_get_ext_draw_size(item), _lv_obj_get_ext_draw_size(item));
+    _lv_area_join(&f->inv_area, &f->inv_area, &a);
+}
+
 /**
  * Tell a start coordinate and gap for a placement type.
  */
@@ -77,7 +77,7 @@ enum io_source_type {
 typedef struct {
     enum io_source_type type;
     lv_fs_file_t lv_file;
-    uint8_t * img_cache_buff;
+    lv_color_t * img_cache_buff;          //Decoded pixels are written here
     int img_cache_x_res;
     int img_cache_y_res;
     uint8_t * raw_sjpg_data;              //Used when type==SJPEG_IO_SOURCE_C_ARRAY.
@@ -96,7 +96,7 @@ typedef struct {
     int sjpeg_cache_frame_index;
     uint8_t ** frame_base_array;        //to save base address of each split frames upto sjpeg_total_frames.
     int * frame_base_offset;            //to save base offset for fseek
-    uint8_t * frame_cache;
+    lv_color_t * frame_cache;           //decoded pixels of a frame in the display's color format
     uint8_t * workb;                    //JPG work buffer for jpeg library
     JDEC * tjpeg_jd;
     io_source_t io;
@@ -110,8 +110,12 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
 static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
                                   lv_coord_t len, uint8_t * buf);
 static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static void decoder_fit(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header, lv_coord_t fit_w,
+                        lv_coord_t fit_h);
 static size_t input_func(JDEC * jd, uint8_t * buff, size_t ndata);
 static int is_jpg(const uint8_t * raw_data, size_t len);
+static uint8_t get_scale(uint32_t w, uint32_t h, lv_coord_t fit_w, lv_coord_t fit_h);
+static lv_res_t decode_jpg(SJPEG * sjpeg, lv_img_decoder_dsc_t * dsc);
 static void lv_sjpg_cleanup(SJPEG * sjpeg);
 static void lv_sjpg_free(SJPEG * sjpeg);
 
@@ -133,6 +137,12 @@ void lv_split_jpeg_init(void)
     lv_img_decoder_set_open_cb(dec, decoder_open);
     lv_img_decoder_set_close_cb(dec, decoder_close);
     lv_img_decoder_set_read_line_cb(dec, decoder_read_line);
+    lv_img_decoder_set_fit_cb(dec, decoder_fit);
+}
+
+void lv_split_jpeg_set_fit_size(lv_coord_t w, lv_coord_t h)
+{
+    lv_img_decoder_set_fit_size(w, h);
 }
 
 /**********************
@@ -165,7 +175,7 @@ static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_im
 
             raw_sjpeg_data += 14; //seek to res info ... refer sjpeg format
             header->always_zero = 0;
-            header->cf = LV_IMG_CF_RAW;
+            header->cf = LV_IMG_CF_TRUE_COLOR;
 
             header->w = *raw_sjpeg_data++;
             header->w |= *raw_sjpeg_data++ << 8;
@@ -178,7 +188,7 @@ static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_im
         }
         else if(is_jpg(raw_sjpeg_data, raw_sjpeg_data_size) == true) {
             header->always_zero = 0;
-            header->cf = LV_IMG_CF_RAW;
+            header->cf = LV_IMG_CF_TRUE_COLOR;
 
             uint8_t * workb_temp = lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
             if(!workb_temp) return LV_RES_INV;
@@ -195,7 +205,6 @@ static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_im
             if(rc == JDR_OK) {
                 header->w = jd_tmp.width;
                 header->h = jd_tmp.height;
-
             }
             else {
                 ret = LV_RES_INV;
@@ -235,7 +244,7 @@ end:
                     return LV_RES_INV;
                 }
                 header->always_zero = 0;
-                header->cf = LV_IMG_CF_RAW;
+                header->cf = LV_IMG_CF_TRUE_COLOR;
                 uint8_t * raw_sjpeg_data = buff;
                 header->w = *raw_sjpeg_data++;
                 header->w |= *raw_sjpeg_data++ << 8;
@@ -270,7 +279,7 @@ end:
 
             if(rc == JDR_OK) {
                 header->always_zero = 0;
-                header->cf = LV_IMG_CF_RAW;
+                header->cf = LV_IMG_CF_TRUE_COLOR;
                 header->w = jd_tmp.width;
                 header->h = jd_tmp.height;
                 return LV_RES_OK;
@@ -280,21 +289,38 @@ end:
     return LV_RES_INV;
 }
 
+/*Called by tjpgd with every decoded MCU. Store its pixels right where they are in the image.*/
 static int img_data_cb(JDEC * jd, void * data, JRECT * rect)
 {
     io_source_t * io = jd->device;
-    uint8_t * cache = io->img_cache_buff;
     const int xres = io->img_cache_x_res;
-    uint8_t * buf = data;
-    const int INPUT_PIXEL_SIZE = 3;
     const int row_width = rect->right - rect->left + 1; // Row width in pixels.
-    const int row_size = row_width * INPUT_PIXEL_SIZE;  // Row size (bytes).
+    lv_color_t * dest = io->img_cache_buff + rect->top * xres + rect->left;
 
+#if JD_FORMAT == 1
+    /*tjpgd has converted the pixels to RGB565 already*/
+    const uint16_t * buf = data;
+    for(int y = rect->top; y <= rect->bottom; y++) {
+#if LV_COLOR_16_SWAP
+        for(int x = 0; x < row_width; x++) {
+            dest[x].full = (uint16_t)((buf[x] >> 8) | (buf[x] << 8));
+        }
+#else
+        lv_memcpy(dest, buf, row_width * sizeof(lv_color_t));
+#endif
+        buf += row_width;
+        dest += xres;
+    }
+#else
+    const uint8_t * buf = data;
     for(int y = rect->top; y <= rect->bottom; y++) {
-        int row_offset = y * xres * INPUT_PIXEL_SIZE + rect->left * INPUT_PIXEL_SIZE;
-        memcpy(cache + row_offset, buf, row_size);
-        buf += row_size;
+        for(int x = 0; x < row_width; x++) {
+            dest[x] = lv_color_make(buf[0], buf[1], buf[2]);
+            buf += 3;
+        }
+        dest += xres;
     }
+#endif
 
     return 1;
 }
@@ -396,7 +422,7 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
                 sjpeg->frame_base_array[i] = sjpeg->frame_base_array[i - 1] + offset;
             }
             sjpeg->sjpeg_cache_frame_index = -1;
-            sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3/*2*/);
+            sjpeg->frame_cache = lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * sizeof(lv_color_t));
             if(! sjpeg->frame_cache) {
                 lv_sjpg_cleanup(sjpeg);
                 sjpeg = NULL;
@@ -423,78 +449,17 @@ static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t *
             return lv_ret;
         }
         else if(is_jpg(sjpeg->sjpeg_data, raw_sjpeg_data_size) == true) {
+            sjpeg->io.type = SJPEG_IO_SOURCE_C_ARRAY;
+            sjpeg->io.lv_file.file_d = NULL;
+            sjpeg->io.raw_sjpg_data = sjpeg->sjpeg_data;
+            sjpeg->io.raw_sjpg_data_size = sjpeg->sjpeg_data_size;
+            sjpeg->io.raw_sjpg_data_next_read_pos = 0;
 
-            uint8_t * workb_temp = lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
-            if(! workb_temp) {
+            lv_ret = decode_jpg(sjpeg, dsc);
+            if(lv_ret != LV_RES_OK) {
                 lv_sjpg_cleanup(sjpeg);
-                sjpeg = NULL;
-                return LV_RES_INV;
+                dsc->user_data = NULL;
             }
-            io_source_t io_source_temp;
-            io_source_temp.type = SJPEG_IO_SOURCE_C_ARRAY;
-            io_source_temp.raw_sjpg_data =  sjpeg->sjpeg_data;
-            io_source_temp.raw_sjpg_data_size = sjpeg->sjpeg_data_size;
-            io_source_temp.raw_sjpg_data_next_read_pos = 0;
-
-            JDEC jd_tmp;
-            JRESULT rc = jd_prepare(&jd_tmp, input_func, workb_temp, (size_t)TJPGD_WORKBUFF_SIZE, &io_source_temp);
-            lv_mem_free(workb_temp);
-
-
-            if(rc == JDR_OK) {
-                sjpeg->sjpeg_x_res = jd_tmp.width;
-                sjpeg->sjpeg_y_res = jd_tmp.height;
-                sjpeg->sjpeg_total_frames = 1;
-                sjpeg->sjpeg_single_frame_height = jd_tmp.height;
-
-                sjpeg->frame_base_array = lv_mem_alloc(sizeof(uint8_t *) * sjpeg->sjpeg_total_frames);
-                if(! sjpeg->frame_base_array) {
-                    lv_sjpg_cleanup(sjpeg);
-                    sjpeg = NULL;
-                    return LV_RES_INV;
-                }
-                sjpeg->frame_base_offset = NULL;
-
-                uint8_t * img_frame_base = sjpeg->sjpeg_data;
-                sjpeg->frame_base_array[0] = img_frame_base;
-
-                sjpeg->sjpeg_cache_frame_index = -1;
-                sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
-                if(! sjpeg->frame_cache) {
-                    lv_sjpg_cleanup(sjpeg);
-                    sjpeg = NULL;
-                    return LV_RES_INV;
-                }
-
-                sjpeg->io.img_cache_buff = sjpeg->frame_cache;
-                sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
-                sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
-                if(! sjpeg->workb) {
-                    lv_sjpg_cleanup(sjpeg);
-                    sjpeg = NULL;
-                    return LV_RES_INV;
-                }
-
-                sjpeg->tjpeg_jd =   lv_mem_alloc(sizeof(JDEC));
-                if(! sjpeg->tjpeg_jd) {
-                    lv_sjpg_cleanup(sjpeg);
-                    sjpeg = NULL;
-                    return LV_RES_INV;
-                }
-
-                sjpeg->io.type = SJPEG_IO_SOURCE_C_ARRAY;
-                sjpeg->io.lv_file.file_d = NULL;
-                dsc->img_data = NULL;
-                return lv_ret;
-            }
-            else {
-                lv_ret = LV_RES_INV;
-                goto end;
-            }
-
-end:
-            lv_mem_free(workb_temp);
-
             return lv_ret;
         }
     }
@@ -578,7 +543,7 @@ end:
                 }
 
                 sjpeg->sjpeg_cache_frame_index = -1; //INVALID AT BEGINNING for a forced compare mismatch at first time.
-                sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
+                sjpeg->frame_cache = lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * sizeof(lv_color_t));
                 if(! sjpeg->frame_cache) {
                     lv_fs_close(&lv_file);
                     lv_sjpg_cleanup(sjpeg);
@@ -624,82 +589,22 @@ end:
 
                 memset(sjpeg, 0, sizeof(SJPEG));
                 dsc->user_data = sjpeg;
-                sjpeg->sjpeg_data = (uint8_t *)((lv_img_dsc_t *)(dsc->src))->data;
-                sjpeg->sjpeg_data_size = ((lv_img_dsc_t *)(dsc->src))->data_size;
             }
 
-            uint8_t * workb_temp = lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
-            if(! workb_temp) {
-                lv_fs_close(&lv_file);
-                lv_sjpg_cleanup(sjpeg);
-                return LV_RES_INV;
-            }
-
-            io_source_t io_source_temp;
-            io_source_temp.type = SJPEG_IO_SOURCE_DISK;
-            io_source_temp.raw_sjpg_data_next_read_pos = 0;
-            io_source_temp.img_cache_buff = NULL;
-            io_source_temp.lv_file = lv_file;
-
-            JDEC jd_tmp;
-
-            JRESULT rc = jd_prepare(&jd_tmp, input_func, workb_temp, (size_t)TJPGD_WORKBUFF_SIZE, &io_source_temp);
-
-            lv_mem_free(workb_temp);
-
-
-            if(rc == JDR_OK) {
-                sjpeg->sjpeg_x_res = jd_tmp.width;
-                sjpeg->sjpeg_y_res = jd_tmp.height;
-                sjpeg->sjpeg_total_frames = 1;
-                sjpeg->sjpeg_single_frame_height = jd_tmp.height;
-
-                sjpeg->frame_base_array = NULL;
-                sjpeg->frame_base_offset =  lv_mem_alloc(sizeof(uint8_t *) * sjpeg->sjpeg_total_frames);
-                if(! sjpeg->frame_base_offset) {
-                    lv_fs_close(&lv_file);
-                    lv_sjpg_cleanup(sjpeg);
-                    return LV_RES_INV;
-                }
-
-                int img_frame_start_offset = 0;
-                sjpeg->frame_base_offset[0] = img_frame_start_offset;
-
-                sjpeg->sjpeg_cache_frame_index = -1;
-                sjpeg->frame_cache = (void *)lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_single_frame_height * 3);
-                if(! sjpeg->frame_cache) {
-                    lv_fs_close(&lv_file);
-                    lv_sjpg_cleanup(sjpeg);
-                    return LV_RES_INV;
-                }
-
-                sjpeg->io.img_cache_buff = sjpeg->frame_cache;
-                sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
-                sjpeg->workb =   lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
-                if(! sjpeg->workb) {
-                    lv_fs_close(&lv_file);
-                    lv_sjpg_cleanup(sjpeg);
-                    return LV_RES_INV;
-                }
-
-                sjpeg->tjpeg_jd =   lv_mem_alloc(sizeof(JDEC));
-                if(! sjpeg->tjpeg_jd) {
-                    lv_fs_close(&lv_file);
-                    lv_sjpg_cleanup(sjpeg);
-                    return LV_RES_INV;
-                }
+            sjpeg->io.type = SJPEG_IO_SOURCE_DISK;
+            sjpeg->io.lv_file = lv_file;
+            sjpeg->io.raw_sjpg_data_next_read_pos = 0;
 
-                sjpeg->io.type = SJPEG_IO_SOURCE_DISK;
-                sjpeg->io.lv_file = lv_file;
-                dsc->img_data = NULL;
-                return LV_RES_OK;
+            lv_ret = decode_jpg(sjpeg, dsc);
 
+            /*The whole image is decoded, the file is not needed anymore*/
+            lv_fs_close(&(sjpeg->io.lv_file));
+            sjpeg->io.lv_file.file_d = NULL;
+            if(lv_ret != LV_RES_OK) {
+                lv_sjpg_cleanup(sjpeg);
+                dsc->user_data = NULL;
             }
-            else {
-                if(dsc->user_data) lv_mem_free(dsc->user_data);
-                lv_fs_close(&lv_file);
-                return  LV_RES_INV;
-            }
+            return lv_ret;
         }
     }
 
@@ -722,14 +627,14 @@ static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc
                                   lv_coord_t len, uint8_t * buf)
 {
     LV_UNUSED(decoder);
-    if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
-        SJPEG * sjpeg = (SJPEG *) dsc->user_data;
-        JRESULT rc;
+    SJPEG * sjpeg = (SJPEG *) dsc->user_data;
+    JRESULT rc;
 
-        int sjpeg_req_frame_index = y / sjpeg->sjpeg_single_frame_height;
+    int sjpeg_req_frame_index = y / sjpeg->sjpeg_single_frame_height;
 
-        /*If line not from cache, refresh cache */
-        if(sjpeg_req_frame_index != sjpeg->sjpeg_cache_frame_index) {
+    /*If line not from cache, refresh cache */
+    if(sjpeg_req_frame_index != sjpeg->sjpeg_cache_frame_index) {
+        if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
             sjpeg->io.raw_sjpg_data = sjpeg->frame_base_array[ sjpeg_req_frame_index ];
             if(sjpeg_req_frame_index == (sjpeg->sjpeg_total_frames - 1)) {
                 /*This is the last frame. */
@@ -741,124 +646,26 @@ static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc
                     (uint32_t)(sjpeg->frame_base_array[sjpeg_req_frame_index + 1] - sjpeg->io.raw_sjpg_data);
             }
             sjpeg->io.raw_sjpg_data_next_read_pos = 0;
-            rc = jd_prepare(sjpeg->tjpeg_jd, input_func, sjpeg->workb, (size_t)TJPGD_WORKBUFF_SIZE, &(sjpeg->io));
-            if(rc != JDR_OK) return LV_RES_INV;
-            rc = jd_decomp(sjpeg->tjpeg_jd, img_data_cb, 0);
-            if(rc != JDR_OK) return LV_RES_INV;
-            sjpeg->sjpeg_cache_frame_index = sjpeg_req_frame_index;
-        }
-
-        int offset = 0;
-        uint8_t * cache = (uint8_t *)sjpeg->frame_cache + x * 3 + (y % sjpeg->sjpeg_single_frame_height) * sjpeg->sjpeg_x_res *
-                          3;
-
-#if  LV_COLOR_DEPTH == 32
-        for(int i = 0; i < len; i++) {
-            buf[offset + 3] = 0xff;
-            buf[offset + 2] = *cache++;
-            buf[offset + 1] = *cache++;
-            buf[offset + 0] = *cache++;
-            offset += 4;
-        }
-
-#elif  LV_COLOR_DEPTH == 16
-
-        for(int i = 0; i < len; i++) {
-            uint16_t col_16bit = (*cache++ & 0xf8) << 8;
-            col_16bit |= (*cache++ & 0xFC) << 3;
-            col_16bit |= (*cache++ >> 3);
-#if  LV_BIG_ENDIAN_SYSTEM == 1 || LV_COLOR_16_SWAP == 1
-            buf[offset++] = col_16bit >> 8;
-            buf[offset++] = col_16bit & 0xff;
-#else
-            buf[offset++] = col_16bit & 0xff;
-            buf[offset++] = col_16bit >> 8;
-#endif // LV_BIG_ENDIAN_SYSTEM
-        }
-
-#elif  LV_COLOR_DEPTH == 8
-
-        for(int i = 0; i < len; i++) {
-            uint8_t col_8bit = (*cache++ & 0xC0);
-            col_8bit |= (*cache++ & 0xe0) >> 2;
-            col_8bit |= (*cache++ & 0xe0) >> 5;
-            buf[offset++] = col_8bit;
         }
-#else
-#error Unsupported LV_COLOR_DEPTH
-
-
-#endif // LV_COLOR_DEPTH
-        return LV_RES_OK;
-    }
-    else if(dsc->src_type == LV_IMG_SRC_FILE) {
-        SJPEG * sjpeg = (SJPEG *) dsc->user_data;
-        JRESULT rc;
-        int sjpeg_req_frame_index = y / sjpeg->sjpeg_single_frame_height;
-
-        lv_fs_file_t * lv_file_p = &(sjpeg->io.lv_file);
-        if(!lv_file_p) goto end;
-
-        /*If line not from cache, refresh cache */
-        if(sjpeg_req_frame_index != sjpeg->sjpeg_cache_frame_index) {
+        else if(dsc->src_type == LV_IMG_SRC_FILE) {
             sjpeg->io.raw_sjpg_data_next_read_pos = (int)(sjpeg->frame_base_offset [ sjpeg_req_frame_index ]);
             lv_fs_seek(&(sjpeg->io.lv_file), sjpeg->io.raw_sjpg_data_next_read_pos, LV_FS_SEEK_SET);
-
-            rc = jd_prepare(sjpeg->tjpeg_jd, input_func, sjpeg->workb, (size_t)TJPGD_WORKBUFF_SIZE, &(sjpeg->io));
-            if(rc != JDR_OK) return LV_RES_INV;
-
-            rc = jd_decomp(sjpeg->tjpeg_jd, img_data_cb, 0);
-            if(rc != JDR_OK) return LV_RES_INV;
-
-            sjpeg->sjpeg_cache_frame_index = sjpeg_req_frame_index;
         }
-
-        int offset = 0;
-        uint8_t * cache = (uint8_t *)sjpeg->frame_cache + x * 3 + (y % sjpeg->sjpeg_single_frame_height) * sjpeg->sjpeg_x_res *
-                          3;
-
-#if LV_COLOR_DEPTH == 32
-        for(int i = 0; i < len; i++) {
-            buf[offset + 3] = 0xff;
-            buf[offset + 2] = *cache++;
-            buf[offset + 1] = *cache++;
-            buf[offset + 0] = *cache++;
-            offset += 4;
-        }
-#elif  LV_COLOR_DEPTH == 16
-
-        for(int i = 0; i < len; i++) {
-            uint16_t col_8bit = (*cache++ & 0xf8) << 8;
-            col_8bit |= (*cache++ & 0xFC) << 3;
-            col_8bit |= (*cache++ >> 3);
-#if  LV_BIG_ENDIAN_SYSTEM == 1 || LV_COLOR_16_SWAP == 1
-            buf[offset++] = col_8bit >> 8;
-            buf[offset++] = col_8bit & 0xff;
-#else
-            buf[offset++] = col_8bit & 0xff;
-            buf[offset++] = col_8bit >> 8;
-#endif // LV_BIG_ENDIAN_SYSTEM
-        }
-
-#elif  LV_COLOR_DEPTH == 8
-
-        for(int i = 0; i < len; i++) {
-            uint8_t col_8bit = (*cache++ & 0xC0);
-            col_8bit |= (*cache++ & 0xe0) >> 2;
-            col_8bit |= (*cache++ & 0xe0) >> 5;
-            buf[offset++] = col_8bit;
+        else {
+            return LV_RES_INV;
         }
 
-#else
-#error Unsupported LV_COLOR_DEPTH
-
-
-#endif // LV_COLOR_DEPTH
-
-        return LV_RES_OK;
+        rc = jd_prepare(sjpeg->tjpeg_jd, input_func, sjpeg->workb, (size_t)TJPGD_WORKBUFF_SIZE, &(sjpeg->io));
+        if(rc != JDR_OK) return LV_RES_INV;
+        rc = jd_decomp(sjpeg->tjpeg_jd, img_data_cb, 0);
+        if(rc != JDR_OK) return LV_RES_INV;
+        sjpeg->sjpeg_cache_frame_index = sjpeg_req_frame_index;
     }
-end:
-    return LV_RES_INV;
+
+    /*The frame is stored in the display's color format so it can be copied as it is*/
+    const lv_color_t * cache = sjpeg->frame_cache + (y % sjpeg->sjpeg_single_frame_height) * sjpeg->sjpeg_x_res + x;
+    lv_memcpy(buf, cache, len * sizeof(lv_color_t));
+    return LV_RES_OK;
 }
 
 /**
@@ -890,6 +697,102 @@ static void decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc
     }
 }
 
+/**
+ * Get the size a JPG is decoded in to cover a given size. SJPGs are always decoded in their original size.
+ * @param decoder pointer to the decoder where this function belongs
+ * @param src the image source
+ * @param header the info of the image in its original size, `w` and `h` are scaled in it
+ * @param fit_w the width to cover or 0 to care only about the height
+ * @param fit_h the height to cover or 0 to care only about the width
+ */
+static void decoder_fit(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header, lv_coord_t fit_w,
+                        lv_coord_t fit_h)
+{
+    LV_UNUSED(decoder);
+
+    if(lv_img_src_get_type(src) == LV_IMG_SRC_FILE) {
+        if(strcmp(lv_fs_get_ext(src), "jpg") != 0) return;
+    }
+    else {
+        const lv_img_dsc_t * img_dsc = src;
+        if(!is_jpg(img_dsc->data, img_dsc->data_size)) return;
+    }
+
+    uint8_t scale = get_scale(header->w, header->h, fit_w, fit_h);
+    header->w >>= scale;
+    header->h >>= scale;
+}
+
+/**
+ * Get the tjpgd scale (image size is divided by 2^scale) to use with an image
+ * @param w original width of the image
+ * @param h original height of the image
+ * @param fit_w the width to cover or 0 to care only about the height
+ * @param fit_h the height to cover or 0 to care only about the width
+ * @return the largest scale which still covers `fit_w` and `fit_h`
+ */
+static uint8_t get_scale(uint32_t w, uint32_t h, lv_coord_t fit_w, lv_coord_t fit_h)
+{
+    if(fit_w <= 0 && fit_h <= 0) return 0;
+
+    uint8_t scale = 0;
+    while(scale < 3) {
+        /*tjpgd drops the pixels which don't fill a whole output pixel, so the result is simply w >> scale*/
+        uint32_t next = scale + 1;
+        if(fit_w > 0 && (w >> next) < (uint32_t)fit_w) break;
+        if(fit_h > 0 && (h >> next) < (uint32_t)fit_h) break;
+        scale = next;
+    }
+
+    return scale;
+}
+
+/**
+ * Decode a normal JPG image in one go, straight into the image data of `dsc`.
+ * `sjpeg->io` needs to be set up to read the image from its beginning.
+ * @param sjpeg pointer to the decoder's data of the image
+ * @param dsc pointer to the decoder descriptor. `img_data` is set on success.
+ * @return LV_RES_OK: the image is decoded; LV_RES_INV: error
+ */
+static lv_res_t decode_jpg(SJPEG * sjpeg, lv_img_decoder_dsc_t * dsc)
+{
+    sjpeg->workb = lv_mem_alloc(TJPGD_WORKBUFF_SIZE);
+    sjpeg->tjpeg_jd = lv_mem_alloc(sizeof(JDEC));
+    if(!sjpeg->workb || !sjpeg->tjpeg_jd) return LV_RES_INV;
+
+    JDEC * jd = sjpeg->tjpeg_jd;
+    JRESULT rc = jd_prepare(jd, input_func, sjpeg->workb, (size_t)TJPGD_WORKBUFF_SIZE, &(sjpeg->io));
+    if(rc != JDR_OK) return LV_RES_INV;
+
+    /*Scale with the fit size the image was opened with, it might have changed since then*/
+    uint8_t scale = get_scale(jd->width, jd->height, dsc->fit_w, dsc->fit_h);
+    sjpeg->sjpeg_x_res = jd->width >> scale;
+    sjpeg->sjpeg_y_res = jd->height >> scale;
+    sjpeg->sjpeg_total_frames = 1;
+    sjpeg->sjpeg_single_frame_height = sjpeg->sjpeg_y_res;
+
+    /*The MCUs are written right to their place in the image, no other pixel buffer is needed*/
+    sjpeg->frame_cache = lv_mem_alloc(sjpeg->sjpeg_x_res * sjpeg->sjpeg_y_res * sizeof(lv_color_t));
+    if(!sjpeg->frame_cache) return LV_RES_INV;
+
+    sjpeg->io.img_cache_buff = sjpeg->frame_cache;
+    sjpeg->io.img_cache_x_res = sjpeg->sjpeg_x_res;
+    rc = jd_decomp(jd, img_data_cb, scale);
+
+    /*Only the pixels are kept*/
+    lv_mem_free(sjpeg->workb);
+    lv_mem_free(sjpeg->tjpeg_jd);
+    sjpeg->workb = NULL;
+    sjpeg->tjpeg_jd = NULL;
+    if(rc != JDR_OK) return LV_RES_INV;
+
+    sjpeg->sjpeg_cache_frame_index = 0;
+    dsc->header.w = sjpeg->sjpeg_x_res;
+    dsc->header.h = sjpeg->sjpeg_y_res;
+    dsc->img_data = (const uint8_t *)sjpeg->frame_cache;
+    return LV_RES_OK;
+}
+
 static int is_jpg(const uint8_t * raw_data, size_t len)
 {
     const uint8_t jpg_signature[] = {0xFF, 0xD8, 0xFF,  0xE0,  0x00,  0x10, 0x4A,  0x46, 0x49, 0x46};
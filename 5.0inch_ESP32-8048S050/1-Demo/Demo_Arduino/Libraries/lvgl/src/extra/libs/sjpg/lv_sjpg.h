@@ -30,6 +30,18 @@ extern "C" {
 
 void lv_split_jpeg_init(void);
 
+/**
+ * Decode normal JPG images only in the size needed: 1/2, 1/4 or 1/8 of the original size is used
+ * if it still covers the given size. It's much faster and uses much less memory for large photos.
+ * SJPG images are always decoded in their original size.
+ * The same as `lv_img_decoder_set_fit_size()`.
+ * @param w     the width to cover or 0 to care only about the height
+ * @param h     the height to cover or 0 to care only about the width
+ * @note        `w = 0` and `h = 0` (default) means decoding the images in their original size.
+ *              It affects the images opened after it, the image cache keeps every fit size separately.
+ */
+void lv_split_jpeg_set_fit_size(lv_coord_t w, lv_coord_t h);
+
 /**********************
  *      MACROS
  **********************/
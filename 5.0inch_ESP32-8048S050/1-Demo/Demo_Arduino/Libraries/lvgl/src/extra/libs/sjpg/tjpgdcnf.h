@@ -5,11 +5,16 @@
 #define	JD_SZBUF		512
 /* Specifies size of stream input buffer */
 
+#if LV_COLOR_DEPTH == 16
+#define JD_FORMAT		1
+#else
 #define JD_FORMAT		0
+#endif
 /* Specifies output pixel format.
 /  0: RGB888 (24-bit/pix)
 /  1: RGB565 (16-bit/pix)
 /  2: Grayscale (8-bit/pix)
+/  LVGL: with 16 bit colors the decoded pixels are stored in RGB565 as they are
 */
 
 #define	JD_USE_SCALE	1
@@ -24,7 +29,7 @@
 /  1: Enable
 */
 
-#define JD_FASTDECODE	0
+#define JD_FASTDECODE	1
 /* Optimization level
 /  0: Basic optimization. Suitable for 8/16-bit MCUs.
 /  1: + 32-bit barrel shifter. Suitable for 32-bit MCUs.
@@ -78,6 +78,8 @@ void lv_imgfont_destroy(lv_font_t * font)
         return;
     }
 
+    lv_font_clear_adv_cache(font);
+
     imgfont_dsc_t * dsc = (imgfont_dsc_t *)font->dsc;
     lv_mem_free(dsc);
 }
@@ -0,0 +1,268 @@
+/**
+ * @file lv_imgpack.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_imgpack.h"
+
+#if LV_USE_IMGPACK
+
+#if defined(ESP_PLATFORM)
+    #include "esp_partition.h"
+    #include "esp_idf_version.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IMGPACK_VERSION     1
+
+/*Flags of the pack header*/
+#define IMGPACK_FLAG_16_SWAP    0x01
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*The file format is little endian. The images are 4 byte aligned.
+ *
+ * header
+ * entries[img_cnt] ordered by name
+ * names (`\0` terminated)
+ * image data*/
+typedef struct {
+    char magic[4];          /*"LVIP"*/
+    uint16_t version;
+    uint8_t color_depth;
+    uint8_t flags;
+    uint32_t img_cnt;
+    uint32_t size;          /*Size of the whole pack*/
+} pack_header_t;
+
+typedef struct {
+    uint32_t name_ofs;
+    uint32_t data_ofs;
+    uint32_t data_size;
+    uint16_t w;
+    uint16_t h;
+    uint8_t cf;
+    uint8_t reserved[3];
+} pack_entry_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_res_t check_header(const pack_header_t * header, uint32_t size);
+static bool check_name(const lv_imgpack_t * pack, uint32_t ofs);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+#define ENTRIES(pack) ((const pack_entry_t *)((pack)->data + sizeof(pack_header_t)))
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_res_t lv_imgpack_open(lv_imgpack_t * pack, const void * data, uint32_t size)
+{
+    LV_ASSERT_NULL(pack);
+    lv_memset_00(pack, sizeof(lv_imgpack_t));
+    if(data == NULL) return LV_RES_INV;
+
+    const pack_header_t * header = data;
+    if(check_header(header, size) != LV_RES_OK) return LV_RES_INV;
+
+    pack->data = data;
+    pack->size = header->size;
+    pack->img_cnt = header->img_cnt;
+
+    /*Check everything once so that the images can be used without further checks*/
+    const pack_entry_t * entries = ENTRIES(pack);
+    uint32_t i;
+    for(i = 0; i < pack->img_cnt; i++) {
+        const pack_entry_t * e = &entries[i];
+        if(!check_name(pack, e->name_ofs)) {
+            LV_LOG_WARN("invalid name of image %"LV_PRIu32, i);
+            return LV_RES_INV;
+        }
+
+        if(i > 0 && strcmp((const char *)pack->data + entries[i - 1].name_ofs, (const char *)pack->data + e->name_ofs) >= 0) {
+            LV_LOG_WARN("the images are not ordered by name");
+            return LV_RES_INV;
+        }
+
+        /*LV_IMG_CF_RGB565A8 is supported only with 16 bit colors*/
+        if(e->cf != LV_IMG_CF_TRUE_COLOR && e->cf != LV_IMG_CF_TRUE_COLOR_ALPHA &&
+           (e->cf != LV_IMG_CF_RGB565A8 || LV_COLOR_DEPTH != 16)) {
+            LV_LOG_WARN("unsupported color format of %s", (const char *)pack->data + e->name_ofs);
+            return LV_RES_INV;
+        }
+
+        if(e->data_ofs > pack->size || e->data_size > pack->size - e->data_ofs ||
+           e->data_size != lv_img_buf_get_img_size(e->w, e->h, e->cf)) {
+            LV_LOG_WARN("invalid data of %s", (const char *)pack->data + e->name_ofs);
+            return LV_RES_INV;
+        }
+    }
+
+    /*Only the descriptors are in RAM, they point into the pack*/
+    if(pack->img_cnt) {
+        pack->dscs = lv_mem_alloc(pack->img_cnt * sizeof(lv_img_dsc_t));
+        LV_ASSERT_MALLOC(pack->dscs);
+        if(pack->dscs == NULL) return LV_RES_INV;
+    }
+
+    for(i = 0; i < pack->img_cnt; i++) {
+        const pack_entry_t * e = &entries[i];
+        lv_img_dsc_t * dsc = &pack->dscs[i];
+        lv_memset_00(dsc, sizeof(lv_img_dsc_t));
+        dsc->header.w = e->w;
+        dsc->header.h = e->h;
+        dsc->header.cf = e->cf;
+        dsc->data_size = e->data_size;
+        dsc->data = pack->data + e->data_ofs;
+    }
+
+    return LV_RES_OK;
+}
+
+#if defined(ESP_PLATFORM)
+lv_res_t lv_imgpack_open_partition(lv_imgpack_t * pack, const char * label)
+{
+    LV_ASSERT_NULL(pack);
+    lv_memset_00(pack, sizeof(lv_imgpack_t));
+
+    const esp_partition_t * part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if(part == NULL) {
+        LV_LOG_WARN("no `%s` partition", label);
+        return LV_RES_INV;
+    }
+
+    /*Map only the pack, not the whole partition*/
+    pack_header_t header;
+    if(esp_partition_read(part, 0, &header, sizeof(header)) != ESP_OK) return LV_RES_INV;
+    if(check_header(&header, part->size) != LV_RES_OK) return LV_RES_INV;
+
+    const void * data;
+    uint32_t handle;
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+    esp_err_t err = esp_partition_mmap(part, 0, header.size, ESP_PARTITION_MMAP_DATA, &data,
+                                       (esp_partition_mmap_handle_t *)&handle);
+#else
+    esp_err_t err = esp_partition_mmap(part, 0, header.size, SPI_FLASH_MMAP_DATA, &data,
+                                       (spi_flash_mmap_handle_t *)&handle);
+#endif
+    if(err != ESP_OK) {
+        LV_LOG_WARN("couldn't map the `%s` partition", label);
+        return LV_RES_INV;
+    }
+
+    if(lv_imgpack_open(pack, data, header.size) != LV_RES_OK) {
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+        esp_partition_munmap(handle);
+#else
+        spi_flash_munmap(handle);
+#endif
+        return LV_RES_INV;
+    }
+
+    pack->mmap_handle = handle;
+    return LV_RES_OK;
+}
+#endif
+
+void lv_imgpack_close(lv_imgpack_t * pack)
+{
+    LV_ASSERT_NULL(pack);
+
+    lv_mem_free(pack->dscs);
+
+#if defined(ESP_PLATFORM)
+    if(pack->mmap_handle) {
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+        esp_partition_munmap(pack->mmap_handle);
+#else
+        spi_flash_munmap(pack->mmap_handle);
+#endif
+    }
+#endif
+
+    lv_memset_00(pack, sizeof(lv_imgpack_t));
+}
+
+const lv_img_dsc_t * lv_imgpack_get(const lv_imgpack_t * pack, const char * name)
+{
+    LV_ASSERT_NULL(pack);
+    LV_ASSERT_NULL(name);
+
+    /*Binary search, the images are ordered by name*/
+    const pack_entry_t * entries = ENTRIES(pack);
+    uint32_t first = 0;
+    uint32_t last = pack->img_cnt;
+    while(first < last) {
+        uint32_t mid = first + (last - first) / 2;
+        int cmp = strcmp(name, (const char *)pack->data + entries[mid].name_ofs);
+        if(cmp == 0) return &pack->dscs[mid];
+        if(cmp < 0) last = mid;
+        else first = mid + 1;
+    }
+
+    return NULL;
+}
+
+const char * lv_imgpack_get_name(const lv_imgpack_t * pack, uint32_t id)
+{
+    LV_ASSERT_NULL(pack);
+    if(id >= pack->img_cnt) return NULL;
+
+    return (const char *)pack->data + ENTRIES(pack)[id].name_ofs;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_res_t check_header(const pack_header_t * header, uint32_t size)
+{
+    if(size < sizeof(pack_header_t) || memcmp(header->magic, "LVIP", 4) != 0) {
+        LV_LOG_WARN("not an image pack");
+        return LV_RES_INV;
+    }
+
+    if(header->version != IMGPACK_VERSION) {
+        LV_LOG_WARN("unsupported version: %d", header->version);
+        return LV_RES_INV;
+    }
+
+    bool swap = (header->flags & IMGPACK_FLAG_16_SWAP) != 0;
+    if(header->color_depth != LV_COLOR_DEPTH || (LV_COLOR_DEPTH == 16 && swap != LV_COLOR_16_SWAP)) {
+        LV_LOG_WARN("the pack is made for %d bit colors%s", header->color_depth, swap ? " with swapped bytes" : "");
+        return LV_RES_INV;
+    }
+
+    if(header->size > size || header->size < sizeof(pack_header_t) ||
+       header->img_cnt > (header->size - sizeof(pack_header_t)) / sizeof(pack_entry_t)) {
+        LV_LOG_WARN("the pack is truncated");
+        return LV_RES_INV;
+    }
+
+    return LV_RES_OK;
+}
+
+static bool check_name(const lv_imgpack_t * pack, uint32_t ofs)
+{
+    if(ofs >= pack->size) return false;
+
+    /*Has to be terminated within the pack*/
+    return memchr(pack->data + ofs, '\0', pack->size - ofs) != NULL;
+}
+
+#endif /*LV_USE_IMGPACK*/
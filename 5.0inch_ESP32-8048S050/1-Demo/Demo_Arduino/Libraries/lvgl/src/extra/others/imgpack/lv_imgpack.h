@@ -0,0 +1,94 @@
+/**
+ * @file lv_imgpack.h
+ * Use the images of an image pack (made by `scripts/imgpack.py`) right from where the pack is,
+ * typically from a memory mapped flash partition. The images are already in the display's color format
+ * so they are drawn from there without decoding or copying them to RAM.
+ */
+
+#ifndef LV_IMGPACK_H
+#define LV_IMGPACK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../../lvgl.h"
+
+#if LV_USE_IMGPACK
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    const uint8_t * data;       /**< The whole pack*/
+    uint32_t size;              /**< Size of the pack in bytes*/
+    uint32_t img_cnt;           /**< Number of images in the pack*/
+    lv_img_dsc_t * dscs;        /**< Image descriptors pointing into `data`*/
+    uint32_t mmap_handle;       /**< Used by `lv_imgpack_open_partition()`*/
+} lv_imgpack_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Open an image pack which is already in the address space (e.g. linked in, or mapped from flash)
+ * @param pack      pointer to an `lv_imgpack_t` variable to initialize
+ * @param data      the pack. It's used directly so it needs to be valid while the images are used.
+ * @param size      size of `data` in bytes
+ * @return          LV_RES_OK: the pack can be used; LV_RES_INV: invalid pack or it's made for an other color format
+ */
+lv_res_t lv_imgpack_open(lv_imgpack_t * pack, const void * data, uint32_t size);
+
+#if defined(ESP_PLATFORM)
+/**
+ * Map a flash partition containing an image pack to the address space and open it
+ * @param pack      pointer to an `lv_imgpack_t` variable to initialize
+ * @param label     label of the data partition in the partition table
+ * @return          LV_RES_OK: the pack can be used; LV_RES_INV: no such partition or it has no valid pack
+ */
+lv_res_t lv_imgpack_open_partition(lv_imgpack_t * pack, const char * label);
+#endif
+
+/**
+ * Close an image pack. The images of it can't be used after this.
+ * Remove the images from the widgets and call `lv_img_cache_invalidate_src()` for them before closing the pack.
+ * @param pack      pointer to an opened pack
+ */
+void lv_imgpack_close(lv_imgpack_t * pack);
+
+/**
+ * Get an image of a pack by its name
+ * @param pack      pointer to an opened pack
+ * @param name      name of the image, by default the file name without extension given to `imgpack.py`
+ * @return          an image descriptor which can be used as an image source or NULL if not found
+ */
+const lv_img_dsc_t * lv_imgpack_get(const lv_imgpack_t * pack, const char * name);
+
+/**
+ * Get the name of an image of a pack
+ * @param pack      pointer to an opened pack
+ * @param id        index of the image, `0` ... `pack->img_cnt - 1`. The images are ordered by their name.
+ * @return          the name of the image or NULL if `id` is too large
+ */
+const char * lv_imgpack_get_name(const lv_imgpack_t * pack, uint32_t id);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_IMGPACK*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_IMGPACK_H*/
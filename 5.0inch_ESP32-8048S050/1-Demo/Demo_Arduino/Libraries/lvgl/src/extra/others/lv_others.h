@@ -20,6 +20,7 @@ extern "C" {
 #include "imgfont/lv_imgfont.h"
 #include "msg/lv_msg.h"
 #include "ime/lv_ime_pinyin.h"
+#include "imgpack/lv_imgpack.h"
 
 /*********************
  *      DEFINES
@@ -1066,6 +1066,14 @@ static void theme_apply(lv_theme_t * th, lv_obj_t * obj)
 
     }
 #endif
+#if LV_USE_VLIST
+    else if(lv_obj_check_type(obj, &lv_vlist_class)) {
+        lv_obj_add_style(obj, &styles->card, 0);
+        lv_obj_add_style(obj, &styles->scrollbar, LV_PART_SCROLLBAR);
+        lv_obj_add_style(obj, &styles->scrollbar_scrolled, LV_PART_SCROLLBAR | LV_STATE_SCROLLED);
+        return;
+    }
+#endif
 #if LV_USE_MENU
     else if(lv_obj_check_type(obj, &lv_menu_class)) {
         lv_obj_add_style(obj, &styles->card, 0);
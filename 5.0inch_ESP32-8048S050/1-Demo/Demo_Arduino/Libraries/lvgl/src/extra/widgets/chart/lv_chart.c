@@ -10,6 +10,9 @@
 #if LV_USE_CHART != 0
 
 #include "../../../misc/lv_assert.h"
+#include "../../../core/lv_refr.h"
+#include "../../../draw/sw/lv_draw_sw.h"
+#include <string.h>
 
 /*********************
  *      DEFINES
@@ -21,6 +24,9 @@
 #define LV_CHART_POINT_CNT_DEF 10
 #define LV_CHART_LABEL_MAX_TEXT_LENGTH 16
 
+/*Drawing the cache costs about as much as drawing this many points per pixel directly*/
+#define LV_CHART_CACHE_MIN_POINTS_PER_PX 10
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -39,6 +45,12 @@ static void draw_series_scatter(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx);
 static void draw_cursors(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx);
 static void draw_axes(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx);
 static uint32_t get_index_from_x(lv_obj_t * obj, lv_coord_t x);
+static lv_coord_t get_point_x(lv_obj_t * obj, lv_chart_series_t * ser, lv_coord_t w, uint32_t id);
+static uint32_t get_first_point_from_x(lv_obj_t * obj, lv_chart_series_t * ser, lv_coord_t w, lv_coord_t x);
+static bool cache_update(lv_obj_t * obj);
+static void cache_render(lv_obj_t * obj, const lv_area_t * area);
+static void cache_invalidate(lv_obj_t * obj);
+static void cache_free(lv_obj_t * obj);
 static void invalidate_point(lv_obj_t * obj, uint16_t i);
 static void new_points_alloc(lv_obj_t * obj, lv_chart_series_t * ser, uint32_t cnt, lv_coord_t ** a);
 lv_chart_tick_dsc_t * get_tick_gsc(lv_obj_t * obj, lv_chart_axis_t axis);
@@ -165,6 +177,7 @@ void lv_chart_set_update_mode(lv_obj_t * obj, lv_chart_update_mode_t update_mode
     if(chart->update_mode == update_mode) return;
 
     chart->update_mode = update_mode;
+    cache_invalidate(obj);
     lv_obj_invalidate(obj);
 }
 
@@ -190,6 +203,7 @@ void lv_chart_set_zoom_x(lv_obj_t * obj, uint16_t zoom_x)
     if(chart->zoom_x == zoom_x) return;
 
     chart->zoom_x = zoom_x;
+    cache_invalidate(obj);
     lv_obj_refresh_self_size(obj);
     /*Be the chart doesn't remain scrolled out*/
     lv_obj_readjust_scroll(obj, LV_ANIM_OFF);
@@ -204,6 +218,7 @@ void lv_chart_set_zoom_y(lv_obj_t * obj, uint16_t zoom_y)
     if(chart->zoom_y == zoom_y) return;
 
     chart->zoom_y = zoom_y;
+    cache_invalidate(obj);
     lv_obj_refresh_self_size(obj);
     /*Be the chart doesn't remain scrolled out*/
     lv_obj_readjust_scroll(obj, LV_ANIM_OFF);
@@ -243,6 +258,27 @@ void lv_chart_set_axis_tick(lv_obj_t * obj, lv_chart_axis_t axis, lv_coord_t maj
     lv_obj_invalidate(obj);
 }
 
+void lv_chart_set_cache(lv_obj_t * obj, bool en)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_chart_t * chart  = (lv_chart_t *)obj;
+    if(chart->cache_en == en) return;
+
+    chart->cache_en = en;
+    if(!en) cache_free(obj);
+    cache_invalidate(obj);
+    lv_obj_invalidate(obj);
+}
+
+bool lv_chart_get_cache(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_chart_t * chart  = (lv_chart_t *)obj;
+    return chart->cache_en;
+}
+
 lv_chart_type_t lv_chart_get_type(const lv_obj_t * obj)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
@@ -326,6 +362,7 @@ void lv_chart_refresh(lv_obj_t * obj)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+    cache_invalidate(obj);
     lv_obj_invalidate(obj);
 }
 
@@ -340,6 +377,10 @@ lv_chart_series_t * lv_chart_add_series(lv_obj_t * obj, lv_color_t color, lv_cha
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
     lv_chart_t * chart    = (lv_chart_t *)obj;
+    /*Start in step with the other series to keep the cache shiftable*/
+    lv_chart_series_t * ser_head = _lv_ll_get_head(&chart->series_ll);
+    uint32_t shift_cnt = ser_head ? ser_head->shift_cnt : 0;
+
     lv_chart_series_t * ser = _lv_ll_ins_head(&chart->series_ll);
     LV_ASSERT_MALLOC(ser);
     if(ser == NULL) return NULL;
@@ -361,6 +402,7 @@ lv_chart_series_t * lv_chart_add_series(lv_obj_t * obj, lv_color_t color, lv_cha
     }
 
     ser->start_point = 0;
+    ser->shift_cnt = shift_cnt;
     ser->y_ext_buf_assigned = false;
     ser->hidden = 0;
     ser->x_axis_sec = axis & LV_CHART_AXIS_SECONDARY_X ? 1 : 0;
@@ -386,6 +428,7 @@ void lv_chart_remove_series(lv_obj_t * obj, lv_chart_series_t * series)
 
     _lv_ll_remove(&chart->series_ll, series);
     lv_mem_free(series);
+    cache_invalidate(obj);
 
     return;
 }
@@ -417,6 +460,7 @@ void lv_chart_set_x_start_point(lv_obj_t * obj, lv_chart_series_t * ser, uint16_
     lv_chart_t * chart  = (lv_chart_t *)obj;
     if(id >= chart->point_cnt) return;
     ser->start_point = id;
+    cache_invalidate(obj);
 }
 
 lv_chart_series_t * lv_chart_get_series_next(const lv_obj_t * obj, const lv_chart_series_t * ser)
@@ -538,6 +582,7 @@ void lv_chart_set_next_value(lv_obj_t * obj, lv_chart_series_t * ser, lv_coord_t
     ser->y_points[ser->start_point] = value;
     invalidate_point(obj, ser->start_point);
     ser->start_point = (ser->start_point + 1) % chart->point_cnt;
+    ser->shift_cnt++;
     invalidate_point(obj, ser->start_point);
 }
 
@@ -567,6 +612,7 @@ void lv_chart_set_value_by_id(lv_obj_t * obj, lv_chart_series_t * ser, uint16_t
 
     if(id >= chart->point_cnt) return;
     ser->y_points[id] = value;
+    cache_invalidate(obj);
     invalidate_point(obj, id);
 }
 
@@ -585,6 +631,7 @@ void lv_chart_set_value_by_id2(lv_obj_t * obj, lv_chart_series_t * ser, uint16_t
     if(id >= chart->point_cnt) return;
     ser->x_points[id] = x_value;
     ser->y_points[id] = y_value;
+    cache_invalidate(obj);
     invalidate_point(obj, id);
 }
 
@@ -596,6 +643,7 @@ void lv_chart_set_ext_y_array(lv_obj_t * obj, lv_chart_series_t * ser, lv_coord_
     if(!ser->y_ext_buf_assigned && ser->y_points) lv_mem_free(ser->y_points);
     ser->y_ext_buf_assigned = true;
     ser->y_points = array;
+    cache_invalidate(obj);
     lv_obj_invalidate(obj);
 }
 
@@ -673,6 +721,8 @@ static void lv_chart_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     LV_TRACE_OBJ_CREATE("begin");
 
     lv_chart_t * chart = (lv_chart_t *)obj;
+    cache_free(obj);
+
     lv_chart_series_t * ser;
     while(chart->series_ll.head) {
         ser = _lv_ll_get_head(&chart->series_ll);
@@ -728,8 +778,12 @@ static void lv_chart_event(const lv_obj_class_t * class_p, lv_event_t * e)
         chart->pressed_point_id = LV_CHART_POINT_NONE;
     }
     else if(code == LV_EVENT_SIZE_CHANGED) {
+        cache_invalidate(obj);
         lv_obj_refresh_self_size(obj);
     }
+    else if(code == LV_EVENT_STYLE_CHANGED) {
+        cache_invalidate(obj);
+    }
     else if(code == LV_EVENT_REFR_EXT_DRAW_SIZE) {
         lv_event_set_ext_draw_size(e, LV_MAX4(chart->tick[0].draw_size, chart->tick[1].draw_size, chart->tick[2].draw_size,
                                               chart->tick[3].draw_size));
@@ -745,7 +799,16 @@ static void lv_chart_event(const lv_obj_class_t * class_p, lv_event_t * e)
         draw_axes(obj, draw_ctx);
 
         if(_lv_ll_is_empty(&chart->series_ll) == false) {
-            if(chart->type == LV_CHART_TYPE_LINE) draw_series_line(obj, draw_ctx);
+            if(chart->type == LV_CHART_TYPE_LINE) {
+                if(cache_update(obj)) {
+                    lv_draw_img_dsc_t img_dsc;
+                    lv_draw_img_dsc_init(&img_dsc);
+                    lv_draw_img(draw_ctx, &img_dsc, &obj->coords, chart->cache);
+                }
+                else {
+                    draw_series_line(obj, draw_ctx);
+                }
+            }
             else if(chart->type == LV_CHART_TYPE_BAR) draw_series_bar(obj, draw_ctx);
             else if(chart->type == LV_CHART_TYPE_SCATTER) draw_series_scatter(obj, draw_ctx);
         }
@@ -907,6 +970,9 @@ static void draw_series_line(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx)
     /*If there are at least as much points as pixels then draw only vertical lines*/
     bool crowded_mode = chart->point_cnt >= w ? true : false;
 
+    /*Points farther from the clip area than this can't affect it*/
+    lv_coord_t clip_ext = LV_MAX(point_w, line_dsc_default.width / 2) + 1;
+
     /*Go through all data lines*/
     _LV_LL_READ_BACK(&chart->series_ll, ser) {
         if(ser->hidden) continue;
@@ -915,13 +981,15 @@ static void draw_series_line(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx)
 
         lv_coord_t start_point = chart->update_mode == LV_CHART_UPDATE_MODE_SHIFT ? ser->start_point : 0;
 
-        p1.x = x_ofs;
-        p2.x = x_ofs;
+        /*Start from the point before the first one in the clip area*/
+        uint16_t i_start = get_first_point_from_x(obj, ser, w, clip_area_ori->x1 - clip_ext - x_ofs);
+        if(i_start > 0) i_start--;
 
-        lv_coord_t p_act = start_point;
-        lv_coord_t p_prev = start_point;
+        lv_coord_t p_act = (start_point + i_start) % chart->point_cnt;
+        lv_coord_t p_prev = p_act;
         int32_t y_tmp = (int32_t)((int32_t)ser->y_points[p_prev] - chart->ymin[ser->y_axis_sec]) * h;
         y_tmp  = y_tmp / (chart->ymax[ser->y_axis_sec] - chart->ymin[ser->y_axis_sec]);
+        p2.x   = get_point_x(obj, ser, w, i_start) + x_ofs;
         p2.y   = h - y_tmp + y_ofs;
 
         lv_obj_draw_part_dsc_t part_draw_dsc;
@@ -936,12 +1004,12 @@ static void draw_series_line(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx)
         lv_coord_t y_min = p2.y;
         lv_coord_t y_max = p2.y;
 
-        for(i = 0; i < chart->point_cnt; i++) {
+        for(i = i_start; i < chart->point_cnt; i++) {
             p1.x = p2.x;
             p1.y = p2.y;
 
-            if(p1.x > clip_area_ori->x2 + point_w + 1) break;
-            p2.x = ((w * i) / (chart->point_cnt - 1)) + x_ofs;
+            if(p1.x > clip_area_ori->x2 + clip_ext) break;
+            p2.x = get_point_x(obj, ser, w, i) + x_ofs;
 
             p_act = (start_point + i) % chart->point_cnt;
 
@@ -949,13 +1017,8 @@ static void draw_series_line(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx)
             y_tmp = y_tmp / (chart->ymax[ser->y_axis_sec] - chart->ymin[ser->y_axis_sec]);
             p2.y  = h - y_tmp + y_ofs;
 
-            if(p2.x < clip_area_ori->x1 - point_w - 1) {
-                p_prev = p_act;
-                continue;
-            }
-
             /*Don't draw the first point. A second point is also required to draw the line*/
-            if(i != 0) {
+            if(i != i_start) {
                 if(crowded_mode) {
                     if(ser->y_points[p_prev] != LV_CHART_POINT_NONE && ser->y_points[p_act] != LV_CHART_POINT_NONE) {
                         /*Draw only one vertical line between the min and max y-values on the same x-value*/
@@ -1673,6 +1736,48 @@ static uint32_t get_index_from_x(lv_obj_t * obj, lv_coord_t x)
     return 0;
 }
 
+/**
+ * Get the X coordinate of a point of a line series
+ * @param obj       pointer to a chart object
+ * @param ser       pointer to a series
+ * @param w         width of the series area
+ * @param id        index of the point from the left
+ * @return          the X coordinate relative to the series area
+ */
+static lv_coord_t get_point_x(lv_obj_t * obj, lv_chart_series_t * ser, lv_coord_t w, uint32_t id)
+{
+    lv_chart_t * chart  = (lv_chart_t *)obj;
+    uint32_t last = chart->point_cnt - 1;
+    if(chart->cache == NULL) return ((int32_t)w * id) / last;
+
+    /*Place the points as if the series was never shifted and measure from the first point.
+     *This way the points move by the same whole pixels when a value is added so the cache can be shifted.*/
+    uint32_t shift = ser->shift_cnt % last;
+    return (lv_coord_t)((uint64_t)w * (shift + id) / last - (uint64_t)w * shift / last);
+}
+
+/**
+ * Find the first point of a line series which is not on the left of an X coordinate
+ * @param obj       pointer to a chart object
+ * @param ser       pointer to a series
+ * @param w         width of the series area
+ * @param x         X coordinate relative to the series area
+ * @return          index of the point from the left
+ */
+static uint32_t get_first_point_from_x(lv_obj_t * obj, lv_chart_series_t * ser, lv_coord_t w, lv_coord_t x)
+{
+    lv_chart_t * chart  = (lv_chart_t *)obj;
+    uint32_t min = 0;
+    uint32_t max = chart->point_cnt - 1;
+    while(min < max) {
+        uint32_t mid = (min + max) / 2;
+        if(get_point_x(obj, ser, w, mid) < x) min = mid + 1;
+        else max = mid;
+    }
+
+    return min;
+}
+
 static void invalidate_point(lv_obj_t * obj, uint16_t i)
 {
     lv_chart_t * chart  = (lv_chart_t *)obj;
@@ -1681,9 +1786,11 @@ static void invalidate_point(lv_obj_t * obj, uint16_t i)
     lv_coord_t w  = ((int32_t)lv_obj_get_content_width(obj) * chart->zoom_x) >> 8;
     lv_coord_t scroll_left = lv_obj_get_scroll_left(obj);
 
-    /*In shift mode the whole chart changes so the whole object*/
+    /*In shift mode the whole series area changes but the ticks and labels around it not*/
     if(chart->update_mode == LV_CHART_UPDATE_MODE_SHIFT) {
-        lv_obj_invalidate(obj);
+        lv_area_t coords;
+        lv_area_copy(&coords, &obj->coords);
+        lv_obj_invalidate_area(obj, &coords);
         return;
     }
 
@@ -1735,6 +1842,167 @@ static void invalidate_point(lv_obj_t * obj, uint16_t i)
     }
 }
 
+/**
+ * Bring the cache up to date. Shift it if the series were shifted since the last update
+ * and draw only the new points, else render all the series.
+ * @param obj       pointer to a chart object
+ * @return          true: the cache can be drawn; false: the series need to be drawn directly
+ */
+static bool cache_update(lv_obj_t * obj)
+{
+    lv_chart_t * chart  = (lv_chart_t *)obj;
+    bool usable = chart->cache_en && chart->update_mode == LV_CHART_UPDATE_MODE_SHIFT &&
+                  chart->zoom_x == LV_IMG_ZOOM_NONE && chart->zoom_y == LV_IMG_ZOOM_NONE &&
+                  lv_obj_get_scroll_left(obj) == 0 && lv_obj_get_scroll_top(obj) == 0 && chart->point_cnt >= 2 &&
+                  chart->point_cnt >= (uint32_t)lv_obj_get_content_width(obj) * LV_CHART_CACHE_MIN_POINTS_PER_PX;
+    if(!usable) {
+        /*Don't keep the buffer while the series are drawn directly*/
+        cache_free(obj);
+        return false;
+    }
+
+    lv_coord_t obj_w = lv_obj_get_width(obj);
+    lv_coord_t obj_h = lv_obj_get_height(obj);
+    if(chart->cache == NULL || chart->cache->header.w != obj_w || chart->cache->header.h != obj_h) {
+        cache_free(obj);
+        chart->cache = lv_img_buf_alloc(obj_w, obj_h, LV_IMG_CF_TRUE_COLOR_ALPHA);
+        if(chart->cache == NULL) {
+            LV_LOG_WARN("Not enough memory for the cache, drawing the series directly");
+            chart->cache_en = 0;
+            return false;
+        }
+        chart->cache_valid = 0;
+    }
+
+    /*The pixels can be shifted only if all the series were shifted by the same number of values*/
+    bool same_shift = true;
+    uint32_t shift_cnt = chart->cache_shift_cnt;
+    lv_chart_series_t * ser;
+    lv_chart_series_t * ser_first = NULL;
+    _LV_LL_READ_BACK(&chart->series_ll, ser) {
+        if(ser->hidden) continue;
+        if(ser_first == NULL) {
+            ser_first = ser;
+            shift_cnt = ser->shift_cnt;
+        }
+        else if(ser->shift_cnt != shift_cnt) {
+            same_shift = false;
+        }
+    }
+
+    uint32_t new_cnt = shift_cnt - chart->cache_shift_cnt;
+    uint32_t last = chart->point_cnt - 1;
+    if(!chart->cache_valid || !same_shift || new_cnt >= last) {
+        cache_render(obj, &obj->coords);
+        chart->cache_valid = 1;
+        chart->cache_shift_cnt = shift_cnt;
+        return true;
+    }
+
+    if(new_cnt == 0) return true;
+
+    lv_coord_t w = lv_obj_get_content_width(obj);
+    uint32_t old_shift = chart->cache_shift_cnt % last;
+    lv_coord_t dx = (lv_coord_t)((uint64_t)w * (old_shift + new_cnt) / last - (uint64_t)w * old_shift / last);
+    chart->cache_shift_cnt = shift_cnt;
+
+    uint32_t px_size = LV_IMG_PX_SIZE_ALPHA_BYTE;
+    if(dx > 0 && dx < obj_w) {
+        uint8_t * row = (uint8_t *)chart->cache->data;
+        lv_coord_t y;
+        for(y = 0; y < obj_h; y++) {
+            memmove(row, row + dx * px_size, (obj_w - dx) * px_size);
+            row += obj_w * px_size;
+        }
+    }
+
+    lv_coord_t point_w = lv_obj_get_style_width(obj, LV_PART_INDICATOR) / 2;
+    lv_coord_t line_w = lv_obj_get_style_line_width(obj, LV_PART_ITEMS);
+    lv_coord_t ext = LV_MAX(point_w, line_w / 2) + 2;
+    lv_coord_t x_ofs = obj->coords.x1 + lv_obj_get_style_pad_left(obj, LV_PART_MAIN) +
+                       lv_obj_get_style_border_width(obj, LV_PART_MAIN);
+
+    /*The first point was cut on the left, redraw it without the removed points*/
+    lv_area_t a;
+    lv_area_copy(&a, &obj->coords);
+    a.x2 = LV_MIN(x_ofs + ext, obj->coords.x2);
+    cache_render(obj, &a);
+
+    /*Draw the new points on the right*/
+    lv_area_copy(&a, &obj->coords);
+    a.x1 = LV_MAX(x_ofs + get_point_x(obj, ser_first, w, last - new_cnt) - ext, obj->coords.x1);
+    cache_render(obj, &a);
+
+    return true;
+}
+
+/**
+ * Clear an area of the cache and draw the series there
+ * @param obj       pointer to a chart object
+ * @param area      the area to render in absolute coordinates. Must be on the chart.
+ */
+static void cache_render(lv_obj_t * obj, const lv_area_t * area)
+{
+    lv_chart_t * chart  = (lv_chart_t *)obj;
+    lv_img_dsc_t * cache = chart->cache;
+    uint32_t px_size = LV_IMG_PX_SIZE_ALPHA_BYTE;
+
+    uint8_t * row = (uint8_t *)cache->data;
+    row += ((area->y1 - obj->coords.y1) * cache->header.w + area->x1 - obj->coords.x1) * px_size;
+    lv_coord_t y;
+    for(y = area->y1; y <= area->y2; y++) {
+        lv_memset_00(row, lv_area_get_width(area) * px_size);
+        row += cache->header.w * px_size;
+    }
+
+    /*Create a display which draws to the cache. The buffer is on the chart so the series
+     *can be drawn with their normal absolute coordinates.*/
+    lv_area_t buf_area;
+    lv_area_t clip_area;
+    lv_area_copy(&buf_area, &obj->coords);
+    lv_area_copy(&clip_area, area);
+
+    lv_disp_t disp;
+    lv_disp_drv_t drv;
+    lv_memset_00(&disp, sizeof(lv_disp_t));
+    disp.driver = &drv;
+    lv_disp_drv_init(&drv);
+    drv.hor_res = cache->header.w;
+    drv.ver_res = cache->header.h;
+    lv_disp_drv_use_generic_set_px_cb(&drv, LV_IMG_CF_TRUE_COLOR_ALPHA);
+
+    lv_draw_sw_ctx_t draw_ctx;
+    lv_draw_sw_init_ctx(&drv, (lv_draw_ctx_t *)&draw_ctx);
+    draw_ctx.base_draw.buf = (void *)cache->data;
+    draw_ctx.base_draw.buf_area = &buf_area;
+    draw_ctx.base_draw.clip_area = &clip_area;
+    drv.draw_ctx = (lv_draw_ctx_t *)&draw_ctx;
+
+    lv_disp_t * refr_ori = _lv_refr_get_disp_refreshing();
+    _lv_refr_set_disp_refreshing(&disp);
+    draw_series_line(obj, (lv_draw_ctx_t *)&draw_ctx);
+    _lv_refr_set_disp_refreshing(refr_ori);
+
+    lv_draw_sw_deinit_ctx(&drv, (lv_draw_ctx_t *)&draw_ctx);
+}
+
+static void cache_invalidate(lv_obj_t * obj)
+{
+    lv_chart_t * chart  = (lv_chart_t *)obj;
+    chart->cache_valid = 0;
+}
+
+static void cache_free(lv_obj_t * obj)
+{
+    lv_chart_t * chart  = (lv_chart_t *)obj;
+    if(chart->cache == NULL) return;
+
+    lv_img_cache_invalidate_src(chart->cache);
+    lv_img_buf_free(chart->cache);
+    chart->cache = NULL;
+    chart->cache_valid = 0;
+}
+
 static void new_points_alloc(lv_obj_t * obj, lv_chart_series_t * ser, uint32_t cnt, lv_coord_t ** a)
 {
     if((*a) == NULL) return;
@@ -73,6 +73,7 @@ typedef struct {
     lv_coord_t * y_points;
     lv_color_t color;
     uint16_t start_point;
+    uint32_t shift_cnt;     /**< Number of values added in `LV_CHART_UPDATE_MODE_SHIFT`*/
     uint8_t hidden : 1;
     uint8_t x_ext_buf_assigned : 1;
     uint8_t y_ext_buf_assigned : 1;
@@ -114,8 +115,12 @@ typedef struct {
     uint16_t point_cnt;    /**< Point number in a data line*/
     uint16_t zoom_x;
     uint16_t zoom_y;
+    lv_img_dsc_t * cache;   /**< The rendered series if the cache is enabled*/
+    uint32_t cache_shift_cnt; /**< `shift_cnt` of the series when the cache was last updated*/
     lv_chart_type_t type  : 3; /**< Line or column chart*/
     lv_chart_update_mode_t update_mode : 1;
+    uint8_t cache_en : 1;
+    uint8_t cache_valid : 1;
 } lv_chart_t;
 
 extern const lv_obj_class_t lv_chart_class;
@@ -210,6 +215,13 @@ uint16_t lv_chart_get_zoom_x(const lv_obj_t * obj);
  */
 uint16_t lv_chart_get_zoom_y(const lv_obj_t * obj);
 
+/**
+ * Tell whether the series are drawn from a cache
+ * @param obj       pointer to a chart object
+ * @return          true: the cache is enabled
+ */
+bool lv_chart_get_cache(const lv_obj_t * obj);
+
 /**
  * Set the number of tick lines on an axis
  * @param obj           pointer to a chart object
@@ -225,6 +237,17 @@ uint16_t lv_chart_get_zoom_y(const lv_obj_t * obj);
 void lv_chart_set_axis_tick(lv_obj_t * obj, lv_chart_axis_t axis, lv_coord_t major_len, lv_coord_t minor_len,
                             lv_coord_t major_cnt, lv_coord_t minor_cnt, bool label_en, lv_coord_t draw_size);
 
+/**
+ * Keep the rendered series of a line chart in a buffer. In `LV_CHART_UPDATE_MODE_SHIFT`
+ * the buffer is shifted when new values are added with `lv_chart_set_next_value` and only
+ * the new part is drawn. Used only without zoom and with at least 10 points per pixel,
+ * with fewer points drawing the series directly is faster.
+ * The buffer needs `width * height * LV_IMG_PX_SIZE_ALPHA_BYTE` bytes.
+ * @param obj       pointer to a chart object
+ * @param en        true: enable the cache; false: draw the series directly
+ */
+void lv_chart_set_cache(lv_obj_t * obj, bool en);
+
 /**
  * Get the type of a chart
  * @param obj       pointer to chart object
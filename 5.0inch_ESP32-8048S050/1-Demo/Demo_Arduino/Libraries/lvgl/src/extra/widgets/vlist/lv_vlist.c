@@ -0,0 +1,473 @@
+/**
+ * @file lv_vlist.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_vlist.h"
+#if LV_USE_VLIST != 0
+
+#include "../../../misc/lv_assert.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MY_CLASS &lv_vlist_class
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void lv_vlist_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void lv_vlist_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj);
+static void lv_vlist_event(const lv_obj_class_t * class_p, lv_event_t * e);
+static void measure_row(lv_obj_t * obj);
+static void refr_pool(lv_obj_t * obj);
+static void refr_rows(lv_obj_t * obj, bool rebind);
+static int32_t get_total_height(lv_obj_t * obj);
+static int32_t get_window_size(lv_obj_t * obj);
+static int32_t get_max_base(lv_obj_t * obj);
+static void set_base(lv_obj_t * obj, int32_t base_y);
+static void rebase(lv_obj_t * obj);
+static void scroll_to_y(lv_obj_t * obj, int32_t y, lv_anim_enable_t anim_en);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+const lv_obj_class_t lv_vlist_class = {
+    .constructor_cb = lv_vlist_constructor,
+    .destructor_cb = lv_vlist_destructor,
+    .event_cb = lv_vlist_event,
+    .width_def = (LV_DPI_DEF * 3) / 2,
+    .height_def = LV_DPI_DEF * 2,
+    .instance_size = sizeof(lv_vlist_t),
+    .base_class = &lv_obj_class
+};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_obj_t * lv_vlist_create(lv_obj_t * parent)
+{
+    LV_LOG_INFO("begin");
+    lv_obj_t * obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+void lv_vlist_set_row_cb(lv_obj_t * obj, lv_vlist_create_row_cb_t create_cb, lv_vlist_bind_row_cb_t bind_cb)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+
+    /*Delete the rows made by the previous create_cb*/
+    uint32_t i;
+    for(i = 0; i < vlist->pool_size; i++) lv_obj_del(vlist->rows[i]);
+    vlist->pool_size = 0;
+    vlist->row_h = 0;
+
+    vlist->create_cb = create_cb;
+    vlist->bind_cb = bind_cb;
+
+    refr_pool(obj);
+}
+
+void lv_vlist_set_row_cnt(lv_obj_t * obj, uint32_t row_cnt)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    if(vlist->row_cnt == row_cnt) return;
+
+    vlist->row_cnt = row_cnt;
+
+    /*The row height is measured on a bound row*/
+    if(vlist->row_h == 0) {
+        refr_pool(obj);
+        return;
+    }
+
+    /*Don't remain scrolled below the last item*/
+    int32_t y = lv_vlist_get_scroll_y(obj);
+    int32_t max_y = LV_MAX(get_total_height(obj) - lv_obj_get_content_height(obj), 0);
+    if(y > max_y || vlist->base_y > get_max_base(obj)) scroll_to_y(obj, LV_MIN(y, max_y), LV_ANIM_OFF);
+
+    refr_pool(obj);
+    refr_rows(obj, true);
+}
+
+void lv_vlist_refresh(lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    refr_rows(obj, true);
+}
+
+void lv_vlist_refresh_row(lv_obj_t * obj, uint32_t index)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    lv_obj_t * row = lv_vlist_get_row(obj, index);
+    if(row) vlist->bind_cb(obj, row, index);
+}
+
+void lv_vlist_scroll_to_row(lv_obj_t * obj, uint32_t index, lv_anim_enable_t anim_en)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    if(vlist->row_h == 0) return;
+
+    scroll_to_y(obj, (int32_t)index * vlist->row_h, anim_en);
+}
+
+/*=====================
+ * Getter functions
+ *====================*/
+
+uint32_t lv_vlist_get_row_cnt(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    return vlist->row_cnt;
+}
+
+lv_coord_t lv_vlist_get_row_height(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    return vlist->row_h;
+}
+
+uint32_t lv_vlist_get_pool_size(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    return vlist->pool_size;
+}
+
+int32_t lv_vlist_get_scroll_y(const lv_obj_t * obj)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    return vlist->base_y + lv_obj_get_scroll_y(obj);
+}
+
+uint32_t lv_vlist_get_row_index(const lv_obj_t * obj, const lv_obj_t * row)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    uint32_t i;
+    for(i = 0; i < vlist->pool_size; i++) {
+        if(vlist->rows[i] == row) return vlist->row_ids[i];
+    }
+
+    return LV_VLIST_ROW_NONE;
+}
+
+lv_obj_t * lv_vlist_get_row(const lv_obj_t * obj, uint32_t index)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    if(index >= vlist->row_cnt) return NULL;
+
+    uint32_t i;
+    for(i = 0; i < vlist->pool_size; i++) {
+        if(vlist->row_ids[i] == index) return vlist->rows[i];
+    }
+
+    return NULL;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void lv_vlist_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    LV_UNUSED(class_p);
+    LV_TRACE_OBJ_CREATE("begin");
+
+    lv_obj_set_scroll_dir(obj, LV_DIR_VER);
+
+    LV_TRACE_OBJ_CREATE("finished");
+}
+
+static void lv_vlist_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
+{
+    LV_UNUSED(class_p);
+    LV_TRACE_OBJ_CREATE("begin");
+
+    /*The rows are children so they are deleted anyway*/
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    lv_mem_free(vlist->rows);
+    lv_mem_free(vlist->row_ids);
+    vlist->rows = NULL;
+    vlist->row_ids = NULL;
+    vlist->pool_size = 0;
+}
+
+static void lv_vlist_event(const lv_obj_class_t * class_p, lv_event_t * e)
+{
+    LV_UNUSED(class_p);
+
+    lv_res_t res;
+
+    /*Call the ancestor's event handler*/
+    res = lv_obj_event_base(MY_CLASS, e);
+    if(res != LV_RES_OK) return;
+
+    /*The events of the rows' children bubble up here too*/
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t * obj = lv_event_get_current_target(e);
+    if(lv_event_get_target(e) != obj) return;
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+
+    /*Nothing to do until the rows are measured*/
+    if(vlist->row_h == 0) return;
+
+    if(code == LV_EVENT_SCROLL || code == LV_EVENT_SCROLL_END) {
+        refr_rows(obj, false);
+    }
+    else if(code == LV_EVENT_SIZE_CHANGED) {
+        refr_pool(obj);
+    }
+    else if(code == LV_EVENT_STYLE_CHANGED) {
+        /*The row gap might have changed*/
+        vlist->row_h = lv_obj_get_height(vlist->rows[0]) + lv_obj_get_style_pad_row(obj, LV_PART_MAIN);
+        if(vlist->row_h <= 0) vlist->row_h = 1;
+        refr_pool(obj);
+    }
+    else if(code == LV_EVENT_GET_SELF_SIZE) {
+        lv_point_t * p = lv_event_get_param(e);
+        int32_t h = LV_MIN(get_total_height(obj) - vlist->base_y, get_window_size(obj) + vlist->row_h);
+        p->y = LV_MAX(p->y, (lv_coord_t)h);
+    }
+}
+
+/**
+ * Create the first row and measure its height. All rows are supposed to have this height.
+ * @param obj   pointer to a virtual list object
+ */
+static void measure_row(lv_obj_t * obj)
+{
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+
+    if(vlist->pool_size == 0) {
+        lv_obj_t * row = vlist->create_cb(obj);
+        LV_ASSERT_MSG(lv_obj_get_parent(row) == obj, "The rows need to be the children of the list");
+
+        vlist->rows = lv_mem_alloc(sizeof(lv_obj_t *));
+        LV_ASSERT_MALLOC(vlist->rows);
+        vlist->row_ids = lv_mem_alloc(sizeof(uint32_t));
+        LV_ASSERT_MALLOC(vlist->row_ids);
+        if(vlist->rows == NULL || vlist->row_ids == NULL) return;
+
+        vlist->rows[0] = row;
+        vlist->pool_size = 1;
+    }
+
+    vlist->row_ids[0] = 0;
+    vlist->bind_cb(obj, vlist->rows[0], 0);
+    lv_obj_update_layout(vlist->rows[0]);
+
+    vlist->row_h = lv_obj_get_height(vlist->rows[0]) + lv_obj_get_style_pad_row(obj, LV_PART_MAIN);
+    if(vlist->row_h <= 0) vlist->row_h = 1;
+}
+
+/**
+ * Create or delete rows to have enough of them to fill the list
+ * @param obj   pointer to a virtual list object
+ */
+static void refr_pool(lv_obj_t * obj)
+{
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    if(vlist->create_cb == NULL || vlist->bind_cb == NULL) return;
+    if(vlist->row_cnt == 0 && vlist->row_h == 0) return;
+
+    if(vlist->row_h == 0) {
+        measure_row(obj);
+        if(vlist->row_h == 0) return;
+    }
+
+    /*A partially visible row on the top and on the bottom*/
+    uint32_t size = lv_obj_get_content_height(obj) / vlist->row_h + 2;
+    if(size > vlist->row_cnt) size = LV_MAX(vlist->row_cnt, 1);
+
+    if(size != vlist->pool_size) {
+        uint32_t i;
+        for(i = size; i < vlist->pool_size; i++) lv_obj_del(vlist->rows[i]);
+
+        lv_obj_t ** rows = lv_mem_realloc(vlist->rows, size * sizeof(lv_obj_t *));
+        LV_ASSERT_MALLOC(rows);
+        uint32_t * row_ids = lv_mem_realloc(vlist->row_ids, size * sizeof(uint32_t));
+        LV_ASSERT_MALLOC(row_ids);
+        if(rows) vlist->rows = rows;
+        if(row_ids) vlist->row_ids = row_ids;
+        if(rows == NULL || row_ids == NULL) {
+            vlist->pool_size = LV_MIN(size, vlist->pool_size);
+            return;
+        }
+
+        for(i = vlist->pool_size; i < size; i++) {
+            vlist->rows[i] = vlist->create_cb(obj);
+            vlist->row_ids[i] = LV_VLIST_ROW_NONE;
+        }
+        vlist->pool_size = size;
+    }
+
+    lv_obj_refresh_self_size(obj);
+    refr_rows(obj, false);
+}
+
+/**
+ * Put the rows to the visible items
+ * @param obj       pointer to a virtual list object
+ * @param rebind    true: bind all rows again, false: bind only the rows which show an other item
+ */
+static void refr_rows(lv_obj_t * obj, bool rebind)
+{
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    if(vlist->row_h == 0 || vlist->pool_size == 0) return;
+
+    rebase(obj);
+
+    int32_t top = lv_vlist_get_scroll_y(obj);
+    if(top < 0) top = 0;
+    uint32_t first = top / vlist->row_h;
+    uint32_t n = vlist->pool_size;
+
+    /*The `i`th row shows the item `id` in [first, first + n) where `id % n == i`,
+     *so scrolling by a row binds only one row*/
+    uint32_t i;
+    for(i = 0; i < n; i++) {
+        lv_obj_t * row = vlist->rows[i];
+        uint32_t id = first + (i + n - first % n) % n;
+        if(id >= vlist->row_cnt) {
+            vlist->row_ids[i] = LV_VLIST_ROW_NONE;
+            if(!lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN)) lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+
+        if(lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN)) lv_obj_clear_flag(row, LV_OBJ_FLAG_HIDDEN);
+        if(rebind || vlist->row_ids[i] != id) {
+            vlist->row_ids[i] = id;
+            vlist->bind_cb(obj, row, id);
+        }
+        lv_obj_set_y(row, (lv_coord_t)((int32_t)id * vlist->row_h - vlist->base_y));
+    }
+}
+
+static int32_t get_total_height(lv_obj_t * obj)
+{
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    return (int32_t)vlist->row_cnt * vlist->row_h;
+}
+
+/**
+ * The rows are positioned with `lv_coord_t` so only a window of the list can be scrolled by LVGL.
+ * It's moved to keep the visible area around its middle.
+ */
+static int32_t get_window_size(lv_obj_t * obj)
+{
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    return ((LV_COORD_MAX / 2) / vlist->row_h) * vlist->row_h;
+}
+
+static int32_t get_max_base(lv_obj_t * obj)
+{
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    int32_t max_base = get_total_height(obj) - get_window_size(obj);
+    if(max_base <= 0) return 0;
+    return (max_base / vlist->row_h) * vlist->row_h;
+}
+
+/**
+ * Move the window without moving the content on the screen
+ * @param obj       pointer to a virtual list object
+ * @param base_y    the new virtual y coordinate of the window
+ */
+static void set_base(lv_obj_t * obj, int32_t base_y)
+{
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    base_y = LV_CLAMP(0, base_y, get_max_base(obj));
+    base_y = (base_y / vlist->row_h) * vlist->row_h;
+
+    int32_t diff = base_y - vlist->base_y;
+    if(diff == 0) return;
+
+    vlist->base_y = base_y;
+
+    /*The rows are moved by the same amount in `refr_rows`*/
+    lv_obj_allocate_spec_attr(obj);
+    obj->spec_attr->scroll.y += (lv_coord_t)diff;
+    lv_obj_refresh_self_size(obj);
+}
+
+/**
+ * Move the window if the visible area is close to its edges
+ * @param obj   pointer to a virtual list object
+ */
+static void rebase(lv_obj_t * obj)
+{
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    if(get_max_base(obj) == 0 && vlist->base_y == 0) return;
+
+    /*The scroll animations use absolute positions*/
+    if(lv_anim_get(obj, NULL)) return;
+
+    int32_t win = get_window_size(obj);
+    int32_t h = lv_obj_get_content_height(obj);
+    int32_t sy = lv_obj_get_scroll_y(obj);
+    bool top_ok = sy > win / 4 || vlist->base_y == 0;
+    bool bottom_ok = sy + h < win - win / 4 || vlist->base_y >= get_max_base(obj);
+    if(top_ok && bottom_ok) return;
+
+    set_base(obj, vlist->base_y + sy - (win - h) / 2);
+}
+
+/**
+ * Scroll to a virtual y coordinate
+ * @param obj       pointer to a virtual list object
+ * @param y         the virtual y coordinate to show on the top
+ * @param anim_en   LV_ANIM_ON: scroll with animation
+ */
+static void scroll_to_y(lv_obj_t * obj, int32_t y, lv_anim_enable_t anim_en)
+{
+    lv_vlist_t * vlist = (lv_vlist_t *)obj;
+    int32_t h = lv_obj_get_content_height(obj);
+    int32_t max_y = LV_MAX(get_total_height(obj) - h, 0);
+    y = LV_CLAMP(0, y, max_y);
+
+    /*Move the window first to have the target in it*/
+    if(y < vlist->base_y || y + h > vlist->base_y + get_window_size(obj)) {
+        set_base(obj, y - (get_window_size(obj) - h) / 2);
+        refr_rows(obj, false);
+    }
+
+    lv_obj_scroll_to_y(obj, (lv_coord_t)(y - vlist->base_y), anim_en);
+}
+
+#endif
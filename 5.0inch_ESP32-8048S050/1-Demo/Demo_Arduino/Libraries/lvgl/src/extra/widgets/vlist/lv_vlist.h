@@ -0,0 +1,167 @@
+/**
+ * @file lv_vlist.h
+ *
+ */
+
+#ifndef LV_VLIST_H
+#define LV_VLIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../../core/lv_obj.h"
+
+#if LV_USE_VLIST
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**Returned as index for rows which are not bound to any item*/
+#define LV_VLIST_ROW_NONE   UINT32_MAX
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Create a row on the list. The row needs to be a direct child of `vlist`
+ * and all rows should have the same height.
+ */
+typedef lv_obj_t * (*lv_vlist_create_row_cb_t)(lv_obj_t * vlist);
+
+/**
+ * Show the `index`th item on a row created by the `lv_vlist_create_row_cb_t`.
+ * The rows are reused, so everything which depends on the item needs to be set here.
+ */
+typedef void (*lv_vlist_bind_row_cb_t)(lv_obj_t * vlist, lv_obj_t * row, uint32_t index);
+
+/*Data of virtual list*/
+typedef struct {
+    lv_obj_t obj;
+    lv_vlist_create_row_cb_t create_cb;
+    lv_vlist_bind_row_cb_t bind_cb;
+    lv_obj_t ** rows;       /*The pool of rows*/
+    uint32_t * row_ids;     /*The item index shown on each row of the pool*/
+    uint32_t pool_size;
+    uint32_t row_cnt;       /*Number of items*/
+    int32_t base_y;         /*Virtual y coordinate of the scroll position 0*/
+    lv_coord_t row_h;       /*Row height with the row gap, measured on the first row*/
+} lv_vlist_t;
+
+extern const lv_obj_class_t lv_vlist_class;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a virtual list object: only the visible rows are created and they are reused while scrolling
+ * @param parent    pointer to an object, it will be the parent of the new list
+ * @return          pointer to the created list
+ */
+lv_obj_t * lv_vlist_create(lv_obj_t * parent);
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * Set the functions to create and fill the rows. The row height is measured on the first row.
+ * @param obj       pointer to a virtual list object
+ * @param create_cb called to create the rows of the pool
+ * @param bind_cb   called when a row shows an other item
+ */
+void lv_vlist_set_row_cb(lv_obj_t * obj, lv_vlist_create_row_cb_t create_cb, lv_vlist_bind_row_cb_t bind_cb);
+
+/**
+ * Set the number of items
+ * @param obj       pointer to a virtual list object
+ * @param row_cnt   number of items
+ */
+void lv_vlist_set_row_cnt(lv_obj_t * obj, uint32_t row_cnt);
+
+/**
+ * Bind all visible rows again. Use it if the data of the items has changed.
+ * @param obj       pointer to a virtual list object
+ */
+void lv_vlist_refresh(lv_obj_t * obj);
+
+/**
+ * Bind a row again if the item is visible
+ * @param obj       pointer to a virtual list object
+ * @param index     index of the changed item
+ */
+void lv_vlist_refresh_row(lv_obj_t * obj, uint32_t index);
+
+/**
+ * Scroll to an item
+ * @param obj       pointer to a virtual list object
+ * @param index     index of the item
+ * @param anim_en   LV_ANIM_ON: scroll with animation
+ */
+void lv_vlist_scroll_to_row(lv_obj_t * obj, uint32_t index, lv_anim_enable_t anim_en);
+
+/*=====================
+ * Getter functions
+ *====================*/
+
+/**
+ * Get the number of items
+ * @param obj       pointer to a virtual list object
+ * @return          number of items
+ */
+uint32_t lv_vlist_get_row_cnt(const lv_obj_t * obj);
+
+/**
+ * Get the height of the rows
+ * @param obj       pointer to a virtual list object
+ * @return          the height of a row with the row gap
+ */
+lv_coord_t lv_vlist_get_row_height(const lv_obj_t * obj);
+
+/**
+ * Get the number of row objects. It depends only on the height of the list and the rows.
+ * @param obj       pointer to a virtual list object
+ * @return          number of row objects
+ */
+uint32_t lv_vlist_get_pool_size(const lv_obj_t * obj);
+
+/**
+ * Get the position of the visible part from the top of the first item
+ * @param obj       pointer to a virtual list object
+ * @return          the scroll position in pixels
+ */
+int32_t lv_vlist_get_scroll_y(const lv_obj_t * obj);
+
+/**
+ * Get the index of the item shown on a row. Useful in the event handlers of the rows.
+ * @param obj       pointer to a virtual list object
+ * @param row       pointer to a row of the list
+ * @return          index of the item or `LV_VLIST_ROW_NONE` if the row is unused
+ */
+uint32_t lv_vlist_get_row_index(const lv_obj_t * obj, const lv_obj_t * row);
+
+/**
+ * Get the row which shows an item
+ * @param obj       pointer to a virtual list object
+ * @param index     index of an item
+ * @return          the row or NULL if the item is not visible
+ */
+lv_obj_t * lv_vlist_get_row(const lv_obj_t * obj, uint32_t index);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_VLIST*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_VLIST_H*/
@@ -8,6 +8,7 @@
  *********************/
 
 #include "lv_font.h"
+#include "lv_font_fmt_txt.h"
 #include "../misc/lv_utils.h"
 #include "../misc/lv_log.h"
 #include "../misc/lv_assert.h"
@@ -19,14 +20,28 @@
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_FONT_ADV_CACHE_SIZE
+typedef struct {
+    const lv_font_t * font;
+    uint32_t letter;
+    uint32_t letter_next;   /*0 if the font has no kerning*/
+    uint16_t adv_w;
+} adv_cache_entry_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_FONT_ADV_CACHE_SIZE
+    static bool has_kerning(const lv_font_t * font);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_FONT_ADV_CACHE_SIZE
+    static adv_cache_entry_t adv_cache[LV_FONT_ADV_CACHE_SIZE];
+#endif
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -136,11 +151,60 @@ bool lv_font_get_glyph_dsc(const lv_font_t * font_p, lv_font_glyph_dsc_t * dsc_o
 uint16_t lv_font_get_glyph_width(const lv_font_t * font, uint32_t letter, uint32_t letter_next)
 {
     LV_ASSERT_NULL(font);
+#if LV_FONT_ADV_CACHE_SIZE
+    /*Without kerning the next letter doesn't matter, so cache only the letter*/
+    if(!has_kerning(font)) letter_next = 0;
+
+    uint32_t h = (letter * 2654435761U) ^ (letter_next * 40503U) ^ ((uint32_t)(lv_uintptr_t)font >> 3);
+    adv_cache_entry_t * entry = &adv_cache[(h ^ (h >> 16)) & (LV_FONT_ADV_CACHE_SIZE - 1)];
+    if(entry->font == font && entry->letter == letter && entry->letter_next == letter_next) return entry->adv_w;
+#endif
+
     lv_font_glyph_dsc_t g;
     lv_font_get_glyph_dsc(font, &g, letter, letter_next);
+
+#if LV_FONT_ADV_CACHE_SIZE
+    entry->font = font;
+    entry->letter = letter;
+    entry->letter_next = letter_next;
+    entry->adv_w = g.adv_w;
+#endif
     return g.adv_w;
 }
 
+/**
+ * Remove the glyph widths of a font from the cache. Needs to be called before a font is freed or changed.
+ * @param font pointer to a font or NULL to clear the whole cache
+ */
+void lv_font_clear_adv_cache(const lv_font_t * font)
+{
+#if LV_FONT_ADV_CACHE_SIZE
+    uint32_t i;
+    for(i = 0; i < LV_FONT_ADV_CACHE_SIZE; i++) {
+        if(font == NULL || adv_cache[i].font == font) adv_cache[i].font = NULL;
+    }
+#else
+    LV_UNUSED(font);
+#endif
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+#if LV_FONT_ADV_CACHE_SIZE
+/**
+ * Check if the width of a glyph might depend on the next letter.
+ * Only the built-in font format without kerning data is known to be kerning free.
+ */
+static bool has_kerning(const lv_font_t * font)
+{
+    while(font) {
+        if(font->get_glyph_dsc != lv_font_get_glyph_dsc_fmt_txt) return true;
+        const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+        if(fdsc->kern_dsc) return true;
+        font = font->fallback;
+    }
+    return false;
+}
+#endif
@@ -116,6 +116,12 @@ bool lv_font_get_glyph_dsc(const lv_font_t * font_p, lv_font_glyph_dsc_t * dsc_o
  */
 uint16_t lv_font_get_glyph_width(const lv_font_t * font, uint32_t letter, uint32_t letter_next);
 
+/**
+ * Remove the glyph widths of a font from the cache. Needs to be called before a font is freed or changed.
+ * @param font pointer to a font or NULL to clear the whole cache
+ */
+void lv_font_clear_adv_cache(const lv_font_t * font);
+
 /**
  * Get the line height of a font. All characters fit into this height
  * @param font_p pointer to a font
@@ -10,6 +10,10 @@
 
 #include <stdint.h>
 
+#define LV_OS_NONE          0
+#define LV_OS_PTHREAD       1
+#define LV_OS_FREERTOS      2
+
 /* Handle special Kconfig options */
 #ifndef LV_KCONFIG_IGNORE
     #include "lv_conf_kconfig.h"
@@ -157,6 +161,50 @@
         #endif
     #endif
 
+    /*Size of an optional second pool for large allocations (image caches, layers, canvases), e.g. in PSRAM.
+     *Small, frequently used objects stay in the fast pool above. 0: disable*/
+    #ifndef LV_MEM_LARGE_SIZE
+        #ifdef CONFIG_LV_MEM_LARGE_SIZE
+            #define LV_MEM_LARGE_SIZE CONFIG_LV_MEM_LARGE_SIZE
+        #else
+            #define LV_MEM_LARGE_SIZE 0
+        #endif
+    #endif
+    #if LV_MEM_LARGE_SIZE
+        /*Allocations of at least this size are served from the large pool first, smaller ones from the fast pool first*/
+        #ifndef LV_MEM_LARGE_THRESHOLD
+            #ifdef CONFIG_LV_MEM_LARGE_THRESHOLD
+                #define LV_MEM_LARGE_THRESHOLD CONFIG_LV_MEM_LARGE_THRESHOLD
+            #else
+                #define LV_MEM_LARGE_THRESHOLD 1024
+            #endif
+        #endif
+        /*Address of the large pool or an allocator to get it. E.g. `heap_caps_malloc(size, MALLOC_CAP_SPIRAM)`*/
+        #ifndef LV_MEM_LARGE_ADR
+            #ifdef CONFIG_LV_MEM_LARGE_ADR
+                #define LV_MEM_LARGE_ADR CONFIG_LV_MEM_LARGE_ADR
+            #else
+                #define LV_MEM_LARGE_ADR 0     /*0: unused*/
+            #endif
+        #endif
+        #if LV_MEM_LARGE_ADR == 0
+            #ifndef LV_MEM_LARGE_POOL_INCLUDE
+                #ifdef CONFIG_LV_MEM_LARGE_POOL_INCLUDE
+                    #define LV_MEM_LARGE_POOL_INCLUDE CONFIG_LV_MEM_LARGE_POOL_INCLUDE
+                #else
+                    #undef LV_MEM_LARGE_POOL_INCLUDE
+                #endif
+            #endif
+            #ifndef LV_MEM_LARGE_POOL_ALLOC
+                #ifdef CONFIG_LV_MEM_LARGE_POOL_ALLOC
+                    #define LV_MEM_LARGE_POOL_ALLOC CONFIG_LV_MEM_LARGE_POOL_ALLOC
+                #else
+                    #undef LV_MEM_LARGE_POOL_ALLOC
+                #endif
+            #endif
+        #endif
+    #endif
+
 #else       /*LV_MEM_CUSTOM*/
     #ifndef LV_MEM_CUSTOM_INCLUDE
         #ifdef CONFIG_LV_MEM_CUSTOM_INCLUDE
@@ -188,6 +236,54 @@
     #endif
 #endif     /*LV_MEM_CUSTOM*/
 
+/*Serve small allocations which are created and deleted often (objects, list nodes, animations,
+ *event descriptors) from fixed size slabs of a dedicated arena. Alloc and free are O(1) and
+ *deleting screens doesn't leave holes in the heap. Not available with `LV_ENABLE_GC`.*/
+#ifndef LV_USE_SLAB
+    #ifdef CONFIG_LV_USE_SLAB
+        #define LV_USE_SLAB CONFIG_LV_USE_SLAB
+    #else
+        #define LV_USE_SLAB 0
+    #endif
+#endif
+#if LV_USE_SLAB
+    /*Size of the arena. When it's full the heap is used.*/
+    #ifndef LV_SLAB_ARENA_SIZE
+        #ifdef CONFIG_LV_SLAB_ARENA_SIZE
+            #define LV_SLAB_ARENA_SIZE CONFIG_LV_SLAB_ARENA_SIZE
+        #else
+            #define LV_SLAB_ARENA_SIZE (16U * 1024U)   /*[bytes]*/
+        #endif
+    #endif
+    /*The arena is given to the size classes in pages of this size*/
+    #ifndef LV_SLAB_PAGE_SIZE
+        #ifdef CONFIG_LV_SLAB_PAGE_SIZE
+            #define LV_SLAB_PAGE_SIZE CONFIG_LV_SLAB_PAGE_SIZE
+        #else
+            #define LV_SLAB_PAGE_SIZE 1024             /*[bytes]*/
+        #endif
+    #endif
+    /*Larger allocations always use the heap. Multiple of 8, not larger than `LV_SLAB_PAGE_SIZE`.*/
+    #ifndef LV_SLAB_MAX_SIZE
+        #ifdef CONFIG_LV_SLAB_MAX_SIZE
+            #define LV_SLAB_MAX_SIZE CONFIG_LV_SLAB_MAX_SIZE
+        #else
+            #define LV_SLAB_MAX_SIZE 256               /*[bytes]*/
+        #endif
+    #endif
+#endif
+
+/*Operating system to run background work with (e.g. `LV_USE_IMG_ASYNC`).
+ *With an OS `lv_mem_alloc()`, `lv_mem_free()` and `lv_mem_realloc()` are protected by a mutex.
+ *LV_OS_NONE, LV_OS_PTHREAD or LV_OS_FREERTOS*/
+#ifndef LV_USE_OS
+    #ifdef CONFIG_LV_USE_OS
+        #define LV_USE_OS CONFIG_LV_USE_OS
+    #else
+        #define LV_USE_OS LV_OS_NONE
+    #endif
+#endif
+
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
  *You will see an error log message if there wasn't enough buffers. */
 #ifndef LV_MEM_BUF_MAX_NUM
@@ -353,6 +449,80 @@
     #endif
 #endif
 
+/*Limit the memory used by the decoded images in the cache [bytes].
+ *The least recently used images are closed to stay below it. Images which are not decoded to RAM don't count.
+ *The decoded images are allocated with `lv_mem_alloc()` so large ones go to `LV_MEM_LARGE_SIZE` pool if enabled.
+ *0: limit only the number of images*/
+#ifndef LV_IMG_CACHE_DEF_BYTES
+    #ifdef CONFIG_LV_IMG_CACHE_DEF_BYTES
+        #define LV_IMG_CACHE_DEF_BYTES CONFIG_LV_IMG_CACHE_DEF_BYTES
+    #else
+        #define LV_IMG_CACHE_DEF_BYTES 0
+    #endif
+#endif
+
+/*Decode the images of the non built-in decoders (e.g. PNG, JPG) in a background thread.
+ *A placeholder is drawn until the image is ready, then the image is redrawn.
+ *Needs `LV_USE_OS` and `LV_IMG_CACHE_DEF_SIZE > 0`.*/
+#ifndef LV_USE_IMG_ASYNC
+    #ifdef CONFIG_LV_USE_IMG_ASYNC
+        #define LV_USE_IMG_ASYNC CONFIG_LV_USE_IMG_ASYNC
+    #else
+        #define LV_USE_IMG_ASYNC 0
+    #endif
+#endif
+#if LV_USE_IMG_ASYNC
+    /*Max. number of images waiting for or under decoding. If it's full the images are decoded while drawing.*/
+    #ifndef LV_IMG_ASYNC_QUEUE_LEN
+        #ifdef CONFIG_LV_IMG_ASYNC_QUEUE_LEN
+            #define LV_IMG_ASYNC_QUEUE_LEN CONFIG_LV_IMG_ASYNC_QUEUE_LEN
+        #else
+            #define LV_IMG_ASYNC_QUEUE_LEN 8
+        #endif
+    #endif
+    /*Show the images decoded line by line (e.g. split JPG) in bands of this many rows while decoding. 0: don't*/
+    #ifndef LV_IMG_ASYNC_BAND_ROWS
+        #ifdef CONFIG_LV_IMG_ASYNC_BAND_ROWS
+            #define LV_IMG_ASYNC_BAND_ROWS CONFIG_LV_IMG_ASYNC_BAND_ROWS
+        #else
+            #define LV_IMG_ASYNC_BAND_ROWS 16
+        #endif
+    #endif
+    #ifndef LV_IMG_ASYNC_PLACEHOLDER_COLOR
+        #ifdef CONFIG_LV_IMG_ASYNC_PLACEHOLDER_COLOR
+            #define LV_IMG_ASYNC_PLACEHOLDER_COLOR CONFIG_LV_IMG_ASYNC_PLACEHOLDER_COLOR
+        #else
+            #define LV_IMG_ASYNC_PLACEHOLDER_COLOR lv_color_hex(0xc0c0c0)
+        #endif
+    #endif
+    /*Worker thread settings*/
+    #ifndef LV_IMG_ASYNC_STACK_SIZE
+        #ifdef CONFIG_LV_IMG_ASYNC_STACK_SIZE
+            #define LV_IMG_ASYNC_STACK_SIZE CONFIG_LV_IMG_ASYNC_STACK_SIZE
+        #else
+            #define LV_IMG_ASYNC_STACK_SIZE (8 * 1024)   /*[bytes]*/
+        #endif
+    #endif
+    #ifndef LV_IMG_ASYNC_PRIO
+        #ifdef _LV_KCONFIG_PRESENT
+            #ifdef CONFIG_LV_IMG_ASYNC_PRIO
+                #define LV_IMG_ASYNC_PRIO CONFIG_LV_IMG_ASYNC_PRIO
+            #else
+                #define LV_IMG_ASYNC_PRIO 0
+            #endif
+        #else
+            #define LV_IMG_ASYNC_PRIO 1
+        #endif
+    #endif
+    #ifndef LV_IMG_ASYNC_CORE
+        #ifdef CONFIG_LV_IMG_ASYNC_CORE
+            #define LV_IMG_ASYNC_CORE CONFIG_LV_IMG_ASYNC_CORE
+        #else
+            #define LV_IMG_ASYNC_CORE -1                 /*-1: any core*/
+        #endif
+    #endif
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #ifndef LV_GRADIENT_MAX_STOPS
@@ -813,6 +983,30 @@
     #endif
 #endif  /*LV_SPRINTF_CUSTOM*/
 
+/*Cache the resolved style properties of each object to make `lv_obj_get_style_prop()` faster.
+ *The cache of an object is dropped when its styles or state change.
+ *If a style used by objects is modified `lv_obj_report_style_change()` has to be called.*/
+#ifndef LV_USE_OBJ_STYLE_CACHE
+    #ifdef CONFIG_LV_USE_OBJ_STYLE_CACHE
+        #define LV_USE_OBJ_STYLE_CACHE CONFIG_LV_USE_OBJ_STYLE_CACHE
+    #else
+        #define LV_USE_OBJ_STYLE_CACHE 0
+    #endif
+#endif
+#if LV_USE_OBJ_STYLE_CACHE
+    /*Number of cached properties per object. Power of 2.
+     *A cache takes 12 + 8 * size bytes on 32 bit MCUs and every drawn object gets one.
+     *16 (140 bytes) still fits into the slabs (`LV_SLAB_MAX_SIZE`), larger caches come from the heap.
+     *Drawing a button needs ~50 properties, so more slots give more hits (~43% with 16, ~90% with 64).*/
+    #ifndef LV_OBJ_STYLE_CACHE_SIZE
+        #ifdef CONFIG_LV_OBJ_STYLE_CACHE_SIZE
+            #define LV_OBJ_STYLE_CACHE_SIZE CONFIG_LV_OBJ_STYLE_CACHE_SIZE
+        #else
+            #define LV_OBJ_STYLE_CACHE_SIZE 16
+        #endif
+    #endif
+#endif
+
 #ifndef LV_USE_USER_DATA
     #ifdef _LV_KCONFIG_PRESENT
         #ifdef CONFIG_LV_USE_USER_DATA
@@ -1238,6 +1432,16 @@
     #endif
 #endif
 
+/*Number of glyph widths to cache (power of 2). The widths are used a lot while the texts are measured.
+ *Set 0 to disable*/
+#ifndef LV_FONT_ADV_CACHE_SIZE
+    #ifdef CONFIG_LV_FONT_ADV_CACHE_SIZE
+        #define LV_FONT_ADV_CACHE_SIZE CONFIG_LV_FONT_ADV_CACHE_SIZE
+    #else
+        #define LV_FONT_ADV_CACHE_SIZE 256
+    #endif
+#endif
+
 /*=================
  *  TEXT SETTINGS
  *=================*/
@@ -1474,6 +1678,17 @@
             #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
         #endif
     #endif
+    #ifndef LV_LABEL_LAYOUT_CACHE
+        #ifdef _LV_KCONFIG_PRESENT
+            #ifdef CONFIG_LV_LABEL_LAYOUT_CACHE
+                #define LV_LABEL_LAYOUT_CACHE CONFIG_LV_LABEL_LAYOUT_CACHE
+            #else
+                #define LV_LABEL_LAYOUT_CACHE 0
+            #endif
+        #else
+            #define LV_LABEL_LAYOUT_CACHE 1   /*Store the line breaks and widths of the text to measure it only when it changes*/
+        #endif
+    #endif
 #endif
 
 #ifndef LV_USE_LINE
@@ -1831,6 +2046,18 @@
     #endif
 #endif
 
+#ifndef LV_USE_VLIST
+    #ifdef _LV_KCONFIG_PRESENT
+        #ifdef CONFIG_LV_USE_VLIST
+            #define LV_USE_VLIST CONFIG_LV_USE_VLIST
+        #else
+            #define LV_USE_VLIST 0
+        #endif
+    #else
+        #define LV_USE_VLIST      1
+    #endif
+#endif
+
 #ifndef LV_USE_WIN
     #ifdef _LV_KCONFIG_PRESENT
         #ifdef CONFIG_LV_USE_WIN
@@ -2256,6 +2483,15 @@
     #endif
 #endif
 
+/*1: Enable image packs: images converted by `scripts/imgpack.py` and drawn right from flash*/
+#ifndef LV_USE_IMGPACK
+    #ifdef CONFIG_LV_USE_IMGPACK
+        #define LV_USE_IMGPACK CONFIG_LV_USE_IMGPACK
+    #else
+        #define LV_USE_IMGPACK 0
+    #endif
+#endif
+
 /*1: Enable Pinyin input method*/
 /*Requires: lv_keyboard*/
 #ifndef LV_USE_IME_PINYIN
@@ -13,6 +13,7 @@
 #include "lv_timer.h"
 #include "lv_math.h"
 #include "lv_mem.h"
+#include "lv_slab.h"
 #include "lv_gc.h"
 
 /*********************
@@ -31,12 +32,14 @@
 static void anim_timer(lv_timer_t * param);
 static void anim_mark_list_change(void);
 static void anim_ready_handler(lv_anim_t * a);
+static void anim_remove(lv_anim_t * a);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static uint32_t last_timer_run;
 static bool anim_list_changed;
+static lv_anim_t * anim_next;   /*The next animation to handle in `anim_timer`, kept valid by `anim_remove`*/
 static bool anim_run_round;
 static lv_timer_t * _lv_anim_tmr;
 
@@ -106,8 +109,7 @@ lv_anim_t * lv_anim_start(const lv_anim_t * a)
         if(new_anim->exec_cb && new_anim->var) new_anim->exec_cb(new_anim->var, new_anim->start_value);
     }
 
-    /*Creating an animation changed the linked list.
-     *It's important if it happens in a ready callback. (see `anim_timer`)*/
+    /*Resume the animation timer if it was paused with an empty list*/
     anim_mark_list_change();
 
     TRACE_ANIM("finished");
@@ -146,11 +148,10 @@ bool lv_anim_del(void * var, lv_anim_exec_xcb_t exec_cb)
         a_next = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
 
         if((a->var == var || var == NULL) && (a->exec_cb == exec_cb || exec_cb == NULL)) {
-            _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
+            anim_remove(a);
             if(a->deleted_cb != NULL) a->deleted_cb(a);
-            lv_mem_free(a);
-            anim_mark_list_change(); /*Read by `anim_timer`. It need to know if a delete occurred in
-                                       the linked list*/
+            lv_slab_free(a);
+            anim_mark_list_change();
             del = true;
         }
 
@@ -163,6 +164,7 @@ bool lv_anim_del(void * var, lv_anim_exec_xcb_t exec_cb)
 void lv_anim_del_all(void)
 {
     _lv_ll_clear(&LV_GC_ROOT(_lv_anim_ll));
+    anim_next = NULL;
     anim_mark_list_change();
 }
 
@@ -359,11 +361,11 @@ static void anim_timer(lv_timer_t * param)
     lv_anim_t * a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
 
     while(a != NULL) {
-        /*It can be set by `lv_anim_del()` typically in `end_cb`. If set then an animation delete
-         * happened in `anim_ready_handler` which could make this linked list reading corrupt
-         * because the list is changed meanwhile
-         */
+        /*Deleting animations (e.g. in `ready_cb`) moves `anim_next` forward if needed,
+         *and new animations are added to the head so no need to start over from the head.
+         *Only a nested call (e.g. `lv_anim_refr_now()` in a callback) sets `anim_list_changed`*/
         anim_list_changed = false;
+        anim_next = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
 
         if(a->run_round != anim_run_round) {
             a->run_round = anim_run_round; /*The list readying might be reset so need to know which anim has run already*/
@@ -399,14 +401,16 @@ static void anim_timer(lv_timer_t * param)
             }
         }
 
-        /*If the linked list changed due to anim. delete then it's not safe to continue
-         *the reading of the list from here -> start from the head*/
+        /*After a nested call `anim_next` is not valid -> start from the head.
+         *The animations which already ran in this round are skipped.*/
         if(anim_list_changed)
             a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
         else
-            a = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
+            a = anim_next;
     }
 
+    anim_next = NULL;
+    anim_list_changed = true;
     last_timer_run = lv_tick_get();
 }
 
@@ -429,14 +433,14 @@ static void anim_ready_handler(lv_anim_t * a)
 
         /*Delete the animation from the list.
          * This way the `ready_cb` will see the animations like it's animation is ready deleted*/
-        _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
+        anim_remove(a);
         /*Flag that the list has changed*/
         anim_mark_list_change();
 
         /*Call the callback function at the end*/
         if(a->ready_cb != NULL) a->ready_cb(a);
         if(a->deleted_cb != NULL) a->deleted_cb(a);
-        lv_mem_free(a);
+        lv_slab_free(a);
     }
     /*If the animation is not deleted then restart it*/
     else {
@@ -460,9 +464,18 @@ static void anim_ready_handler(lv_anim_t * a)
     }
 }
 
+/**
+ * Remove an animation from the linked list without breaking the iteration in `anim_timer`
+ * @param a pointer to an animation descriptor
+ */
+static void anim_remove(lv_anim_t * a)
+{
+    if(a == anim_next) anim_next = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
+    _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
+}
+
 static void anim_mark_list_change(void)
 {
-    anim_list_changed = true;
     if(_lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll)) == NULL)
         lv_timer_pause(_lv_anim_tmr);
     else
@@ -9,6 +9,7 @@
  *********************/
 #include "lv_ll.h"
 #include "lv_mem.h"
+#include "lv_slab.h"
 
 /*********************
  *      DEFINES
@@ -68,7 +69,7 @@ void * _lv_ll_ins_head(lv_ll_t * ll_p)
 {
     lv_ll_node_t * n_new;
 
-    n_new = lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+    n_new = lv_slab_alloc(ll_p->n_size + LL_NODE_META_SIZE);
 
     if(n_new != NULL) {
         node_set_prev(ll_p, n_new, NULL);       /*No prev. before the new head*/
@@ -104,7 +105,7 @@ void * _lv_ll_ins_prev(lv_ll_t * ll_p, void * n_act)
         if(n_new == NULL) return NULL;
     }
     else {
-        n_new = lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+        n_new = lv_slab_alloc(ll_p->n_size + LL_NODE_META_SIZE);
         if(n_new == NULL) return NULL;
 
         lv_ll_node_t * n_prev;
@@ -127,7 +128,7 @@ void * _lv_ll_ins_tail(lv_ll_t * ll_p)
 {
     lv_ll_node_t * n_new;
 
-    n_new = lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+    n_new = lv_slab_alloc(ll_p->n_size + LL_NODE_META_SIZE);
 
     if(n_new != NULL) {
         node_set_next(ll_p, n_new, NULL);       /*No next after the new tail*/
@@ -200,7 +201,7 @@ void _lv_ll_clear(lv_ll_t * ll_p)
         i_next = _lv_ll_get_next(ll_p, i);
 
         _lv_ll_remove(ll_p, i);
-        lv_mem_free(i);
+        lv_slab_free(i);
 
         i = i_next;
     }
@@ -8,10 +8,12 @@
  *      INCLUDES
  *********************/
 #include "lv_mem.h"
+#include "lv_slab.h"
 #include "lv_tlsf.h"
 #include "lv_gc.h"
 #include "lv_assert.h"
 #include "lv_log.h"
+#include "lv_os.h"
 
 #if LV_MEM_CUSTOM != 0
     #include LV_MEM_CUSTOM_INCLUDE
@@ -21,6 +23,15 @@
     #include LV_MEM_POOL_INCLUDE
 #endif
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_LARGE_SIZE
+    #define MEM_LARGE_POOL 1
+    #ifdef LV_MEM_LARGE_POOL_INCLUDE
+        #include LV_MEM_LARGE_POOL_INCLUDE
+    #endif
+#else
+    #define MEM_LARGE_POOL 0
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -39,6 +50,13 @@
 
 #define ZERO_MEM_SENTINEL  0xa1b2c3d4
 
+/*Other threads (e.g. the image decoder worker) can allocate too. The system's malloc is thread safe already.*/
+#if LV_USE_OS != LV_OS_NONE && LV_MEM_CUSTOM == 0
+    #define MEM_USE_LOCK 1
+#else
+    #define MEM_USE_LOCK 0
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -46,9 +64,16 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void * alloc_core(size_t size);
+static void free_core(void * data);
+static void * realloc_core(void * data_p, size_t new_size);
 #if LV_MEM_CUSTOM == 0
     static void lv_mem_walker(void * ptr, size_t size, int used, void * user);
 #endif
+#if MEM_LARGE_POOL
+    static bool is_large(const void * p);
+    static void * alloc_large(size_t size);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -59,6 +84,18 @@
     static uint32_t max_used;
 #endif
 
+#if MEM_LARGE_POOL
+    static lv_tlsf_t tlsf_large;
+    static uint8_t * large_mem;
+    static uint32_t large_cur_used;
+    static uint32_t large_max_used;
+#endif
+
+#if MEM_USE_LOCK
+    static lv_mutex_t mem_lock;
+    static bool mem_lock_inited;
+#endif
+
 static uint32_t zero_mem = ZERO_MEM_SENTINEL; /*Give the address of this variable if 0 byte should be allocated*/
 
 /**********************
@@ -70,6 +107,14 @@ static uint32_t zero_mem = ZERO_MEM_SENTINEL; /*Give the address of this variabl
     #define MEM_TRACE(...)
 #endif
 
+#if MEM_USE_LOCK
+    #define MEM_LOCK()      lv_mutex_lock(&mem_lock)
+    #define MEM_UNLOCK()    lv_mutex_unlock(&mem_lock)
+#else
+    #define MEM_LOCK()
+    #define MEM_UNLOCK()
+#endif
+
 #define COPY32 *d32 = *s32; d32++; s32++;
 #define COPY8 *d8 = *s8; d8++; s8++;
 #define SET32(x) *d32 = x; d32++;
@@ -85,6 +130,14 @@ static uint32_t zero_mem = ZERO_MEM_SENTINEL; /*Give the address of this variabl
  */
 void lv_mem_init(void)
 {
+#if MEM_USE_LOCK
+    /*`lv_mem_deinit()` calls it again, but the mutex can stay*/
+    if(!mem_lock_inited) {
+        lv_mutex_init(&mem_lock);
+        mem_lock_inited = true;
+    }
+#endif
+
 #if LV_MEM_CUSTOM == 0
 
 #if LV_MEM_ADR == 0
@@ -100,6 +153,22 @@ void lv_mem_init(void)
 #endif
 #endif
 
+#if MEM_LARGE_POOL
+#if LV_MEM_LARGE_ADR == 0
+#ifdef LV_MEM_LARGE_POOL_ALLOC
+    /*Get the pool only once, `lv_mem_deinit()` just resets it*/
+    if(large_mem == NULL) large_mem = (uint8_t *)LV_MEM_LARGE_POOL_ALLOC(LV_MEM_LARGE_SIZE);
+#else
+    static LV_ATTRIBUTE_LARGE_RAM_ARRAY MEM_UNIT work_mem_large[LV_MEM_LARGE_SIZE / sizeof(MEM_UNIT)];
+    large_mem = (uint8_t *)work_mem_large;
+#endif
+#else
+    large_mem = (uint8_t *)LV_MEM_LARGE_ADR;
+#endif
+    LV_ASSERT_MALLOC(large_mem);
+    tlsf_large = large_mem ? lv_tlsf_create_with_pool((void *)large_mem, LV_MEM_LARGE_SIZE) : NULL;
+#endif
+
 #if LV_MEM_ADD_JUNK
     LV_LOG_WARN("LV_MEM_ADD_JUNK is enabled which makes LVGL much slower");
 #endif
@@ -113,6 +182,11 @@ void lv_mem_deinit(void)
 {
 #if LV_MEM_CUSTOM == 0
     lv_tlsf_destroy(tlsf);
+#if MEM_LARGE_POOL
+    if(tlsf_large) lv_tlsf_destroy(tlsf_large);
+    large_cur_used = 0;
+    large_max_used = 0;
+#endif
     lv_mem_init();
 #endif
 }
@@ -124,41 +198,9 @@ void lv_mem_deinit(void)
  */
 void * lv_mem_alloc(size_t size)
 {
-    MEM_TRACE("allocating %lu bytes", (unsigned long)size);
-    if(size == 0) {
-        MEM_TRACE("using zero_mem");
-        return &zero_mem;
-    }
-
-#if LV_MEM_CUSTOM == 0
-    void * alloc = lv_tlsf_malloc(tlsf, size);
-#else
-    void * alloc = LV_MEM_CUSTOM_ALLOC(size);
-#endif
-
-    if(alloc == NULL) {
-        LV_LOG_INFO("couldn't allocate memory (%lu bytes)", (unsigned long)size);
-#if LV_LOG_LEVEL <= LV_LOG_LEVEL_INFO
-        lv_mem_monitor_t mon;
-        lv_mem_monitor(&mon);
-        LV_LOG_INFO("used: %6d (%3d %%), frag: %3d %%, biggest free: %6d",
-                    (int)(mon.total_size - mon.free_size), mon.used_pct, mon.frag_pct,
-                    (int)mon.free_biggest_size);
-#endif
-    }
-#if LV_MEM_ADD_JUNK
-    else {
-        lv_memset(alloc, 0xaa, size);
-    }
-#endif
-
-    if(alloc) {
-#if LV_MEM_CUSTOM == 0
-        cur_used += size;
-        max_used = LV_MAX(cur_used, max_used);
-#endif
-        MEM_TRACE("allocated at %p", alloc);
-    }
+    MEM_LOCK();
+    void * alloc = alloc_core(size);
+    MEM_UNLOCK();
     return alloc;
 }
 
@@ -168,20 +210,9 @@ void * lv_mem_alloc(size_t size)
  */
 void lv_mem_free(void * data)
 {
-    MEM_TRACE("freeing %p", data);
-    if(data == &zero_mem) return;
-    if(data == NULL) return;
-
-#if LV_MEM_CUSTOM == 0
-#  if LV_MEM_ADD_JUNK
-    lv_memset(data, 0xbb, lv_tlsf_block_size(data));
-#  endif
-    size_t size = lv_tlsf_free(tlsf, data);
-    if(cur_used > size) cur_used -= size;
-    else cur_used = 0;
-#else
-    LV_MEM_CUSTOM_FREE(data);
-#endif
+    MEM_LOCK();
+    free_core(data);
+    MEM_UNLOCK();
 }
 
 /**
@@ -193,26 +224,9 @@ void lv_mem_free(void * data)
  */
 void * lv_mem_realloc(void * data_p, size_t new_size)
 {
-    MEM_TRACE("reallocating %p with %lu size", data_p, (unsigned long)new_size);
-    if(new_size == 0) {
-        MEM_TRACE("using zero_mem");
-        lv_mem_free(data_p);
-        return &zero_mem;
-    }
-
-    if(data_p == &zero_mem) return lv_mem_alloc(new_size);
-
-#if LV_MEM_CUSTOM == 0
-    void * new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
-#else
-    void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
-#endif
-    if(new_p == NULL) {
-        LV_LOG_ERROR("couldn't allocate memory");
-        return NULL;
-    }
-
-    MEM_TRACE("allocated at %p", new_p);
+    MEM_LOCK();
+    void * new_p = realloc_core(data_p, new_size);
+    MEM_UNLOCK();
     return new_p;
 }
 
@@ -233,6 +247,12 @@ lv_res_t lv_mem_test(void)
         LV_LOG_WARN("pool failed");
         return LV_RES_INV;
     }
+#endif
+#if MEM_LARGE_POOL
+    if(tlsf_large && (lv_tlsf_check(tlsf_large) || lv_tlsf_check_pool(lv_tlsf_get_pool(tlsf_large)))) {
+        LV_LOG_WARN("large pool failed");
+        return LV_RES_INV;
+    }
 #endif
     MEM_TRACE("passed");
     return LV_RES_OK;
@@ -250,7 +270,9 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
 #if LV_MEM_CUSTOM == 0
     MEM_TRACE("begin");
 
+    MEM_LOCK();
     lv_tlsf_walk_pool(lv_tlsf_get_pool(tlsf), lv_mem_walker, mon_p);
+    MEM_UNLOCK();
 
     mon_p->total_size = LV_MEM_SIZE;
     mon_p->used_pct = 100 - (100U * mon_p->free_size) / mon_p->total_size;
@@ -268,6 +290,47 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
 #endif
 }
 
+/**
+ * Give information about the large memory pool
+ * @param mon_p pointer to a lv_mem_monitor_t variable,
+ *              the result of the analysis will be stored here
+ */
+void lv_mem_monitor_large(lv_mem_monitor_t * mon_p)
+{
+    lv_memset(mon_p, 0, sizeof(lv_mem_monitor_t));
+#if MEM_LARGE_POOL
+    if(tlsf_large == NULL) return;
+
+    MEM_LOCK();
+    lv_tlsf_walk_pool(lv_tlsf_get_pool(tlsf_large), lv_mem_walker, mon_p);
+    MEM_UNLOCK();
+
+    mon_p->total_size = LV_MEM_LARGE_SIZE;
+    mon_p->used_pct = 100 - (100U * mon_p->free_size) / mon_p->total_size;
+    if(mon_p->free_size > 0) {
+        mon_p->frag_pct = mon_p->free_biggest_size * 100U / mon_p->free_size;
+        mon_p->frag_pct = 100 - mon_p->frag_pct;
+    }
+    else {
+        mon_p->frag_pct = 0;
+    }
+
+    mon_p->max_used = large_max_used;
+#endif
+}
+
+void lv_mem_reset_max_used(void)
+{
+    MEM_LOCK();
+#if LV_MEM_CUSTOM == 0
+    max_used = cur_used;
+#endif
+#if MEM_LARGE_POOL
+    large_max_used = large_cur_used;
+#endif
+    MEM_UNLOCK();
+}
+
 
 /**
  * Get a temporal buffer with the given size.
@@ -547,6 +610,152 @@ LV_ATTRIBUTE_FAST_MEM void lv_memset_ff(void * dst, size_t len)
  *   STATIC FUNCTIONS
  **********************/
 
+static void * alloc_core(size_t size)
+{
+    MEM_TRACE("allocating %lu bytes", (unsigned long)size);
+    if(size == 0) {
+        MEM_TRACE("using zero_mem");
+        return &zero_mem;
+    }
+
+#if MEM_LARGE_POOL
+    void * alloc;
+    if(size >= LV_MEM_LARGE_THRESHOLD) {
+        alloc = alloc_large(size);
+        if(alloc == NULL) alloc = lv_tlsf_malloc(tlsf, size);
+    }
+    else {
+        /*Small objects fall back to the large pool only when the fast pool is full*/
+        alloc = lv_tlsf_malloc(tlsf, size);
+        if(alloc == NULL) alloc = alloc_large(size);
+    }
+#elif LV_MEM_CUSTOM == 0
+    void * alloc = lv_tlsf_malloc(tlsf, size);
+#else
+    void * alloc = LV_MEM_CUSTOM_ALLOC(size);
+#endif
+
+    if(alloc == NULL) {
+        LV_LOG_INFO("couldn't allocate memory (%lu bytes)", (unsigned long)size);
+#if LV_LOG_LEVEL <= LV_LOG_LEVEL_INFO
+        lv_mem_monitor_t mon;
+        lv_mem_monitor(&mon);
+        LV_LOG_INFO("used: %6d (%3d %%), frag: %3d %%, biggest free: %6d",
+                    (int)(mon.total_size - mon.free_size), mon.used_pct, mon.frag_pct,
+                    (int)mon.free_biggest_size);
+#endif
+    }
+#if LV_MEM_ADD_JUNK
+    else {
+        lv_memset(alloc, 0xaa, size);
+    }
+#endif
+
+    if(alloc) {
+#if MEM_LARGE_POOL
+        if(is_large(alloc)) {
+            large_cur_used += size;
+            large_max_used = LV_MAX(large_cur_used, large_max_used);
+        }
+        else
+#endif
+#if LV_MEM_CUSTOM == 0
+        {
+            cur_used += size;
+            max_used = LV_MAX(cur_used, max_used);
+        }
+#endif
+        MEM_TRACE("allocated at %p", alloc);
+    }
+    return alloc;
+}
+
+static void free_core(void * data)
+{
+    MEM_TRACE("freeing %p", data);
+    if(data == &zero_mem) return;
+    if(data == NULL) return;
+
+#if LV_SLAB_ENABLED
+    if(_lv_slab_owns(data)) {
+        lv_slab_free(data);
+        return;
+    }
+#endif
+
+#if LV_MEM_CUSTOM == 0
+#  if LV_MEM_ADD_JUNK
+    lv_memset(data, 0xbb, lv_tlsf_block_size(data));
+#  endif
+#if MEM_LARGE_POOL
+    if(is_large(data)) {
+        size_t size = lv_tlsf_free(tlsf_large, data);
+        if(large_cur_used > size) large_cur_used -= size;
+        else large_cur_used = 0;
+        return;
+    }
+#endif
+    size_t size = lv_tlsf_free(tlsf, data);
+    if(cur_used > size) cur_used -= size;
+    else cur_used = 0;
+#else
+    LV_MEM_CUSTOM_FREE(data);
+#endif
+}
+
+static void * realloc_core(void * data_p, size_t new_size)
+{
+    MEM_TRACE("reallocating %p with %lu size", data_p, (unsigned long)new_size);
+    if(new_size == 0) {
+        MEM_TRACE("using zero_mem");
+        lv_mem_free(data_p);
+        return &zero_mem;
+    }
+
+    if(data_p == &zero_mem) return lv_mem_alloc(new_size);
+
+#if LV_SLAB_ENABLED
+    if(_lv_slab_owns(data_p)) return lv_slab_realloc(data_p, new_size);
+#endif
+
+#if MEM_LARGE_POOL
+    void * new_p = lv_tlsf_realloc(is_large(data_p) ? tlsf_large : tlsf, data_p, new_size);
+    if(new_p == NULL) {
+        /*The own pool is full, try to move the data to the other one*/
+        new_p = lv_mem_alloc(new_size);
+        if(new_p) {
+            size_t old_size = lv_tlsf_block_size(data_p);
+            lv_memcpy(new_p, data_p, LV_MIN(old_size, new_size));
+            lv_mem_free(data_p);
+        }
+    }
+#elif LV_MEM_CUSTOM == 0
+    void * new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
+#else
+    void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
+#endif
+    if(new_p == NULL) {
+        LV_LOG_ERROR("couldn't allocate memory");
+        return NULL;
+    }
+
+    MEM_TRACE("allocated at %p", new_p);
+    return new_p;
+}
+
+#if MEM_LARGE_POOL
+static bool is_large(const void * p)
+{
+    return large_mem && (const uint8_t *)p >= large_mem && (const uint8_t *)p < large_mem + LV_MEM_LARGE_SIZE;
+}
+
+static void * alloc_large(size_t size)
+{
+    if(tlsf_large == NULL) return NULL;
+    return lv_tlsf_malloc(tlsf_large, size);
+}
+#endif
+
 #if LV_MEM_CUSTOM == 0
 static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
 {
@@ -101,6 +101,20 @@ lv_res_t lv_mem_test(void);
  */
 void lv_mem_monitor(lv_mem_monitor_t * mon_p);
 
+/**
+ * Give information about the large memory pool (`LV_MEM_LARGE_SIZE`).
+ * All fields are zero if the large pool is not used.
+ * @param mon_p pointer to a lv_mem_monitor_t variable,
+ *              the result of the analysis will be stored here
+ */
+void lv_mem_monitor_large(lv_mem_monitor_t * mon_p);
+
+/**
+ * Start measuring `max_used` of `lv_mem_monitor()` and `lv_mem_monitor_large()` again from the current usage.
+ * Useful to see the peak memory need of an operation.
+ */
+void lv_mem_reset_max_used(void);
+
 
 /**
  * Get a temporal buffer with the given size.
@@ -0,0 +1,264 @@
+/**
+ * @file lv_os.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_os.h"
+#include "lv_log.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_USE_OS == LV_OS_PTHREAD
+    static void * thread_entry(void * arg);
+#elif LV_USE_OS == LV_OS_FREERTOS
+    static void thread_entry(void * arg);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+#if LV_USE_OS == LV_OS_PTHREAD
+
+lv_res_t lv_thread_init(lv_thread_t * thread, void (*callback)(void *), uint32_t stack_size, int32_t prio,
+                        int32_t core, void * user_data)
+{
+    LV_UNUSED(stack_size);
+    LV_UNUSED(prio);
+    LV_UNUSED(core);
+
+    thread->callback = callback;
+    thread->user_data = user_data;
+    if(pthread_create(&thread->thread, NULL, thread_entry, thread) != 0) {
+        LV_LOG_ERROR("couldn't create the thread");
+        return LV_RES_INV;
+    }
+    pthread_detach(thread->thread);
+    return LV_RES_OK;
+}
+
+lv_res_t lv_mutex_init(lv_mutex_t * mutex)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    int ret = pthread_mutex_init(mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return ret == 0 ? LV_RES_OK : LV_RES_INV;
+}
+
+void lv_mutex_lock(lv_mutex_t * mutex)
+{
+    pthread_mutex_lock(mutex);
+}
+
+void lv_mutex_unlock(lv_mutex_t * mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+
+void lv_mutex_delete(lv_mutex_t * mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+lv_res_t lv_thread_sync_init(lv_thread_sync_t * sync)
+{
+    sync->v = false;
+    if(pthread_mutex_init(&sync->mutex, NULL) != 0) return LV_RES_INV;
+    if(pthread_cond_init(&sync->cond, NULL) != 0) {
+        pthread_mutex_destroy(&sync->mutex);
+        return LV_RES_INV;
+    }
+    return LV_RES_OK;
+}
+
+void lv_thread_sync_wait(lv_thread_sync_t * sync)
+{
+    pthread_mutex_lock(&sync->mutex);
+    while(!sync->v) {
+        pthread_cond_wait(&sync->cond, &sync->mutex);
+    }
+    sync->v = false;
+    pthread_mutex_unlock(&sync->mutex);
+}
+
+void lv_thread_sync_signal(lv_thread_sync_t * sync)
+{
+    pthread_mutex_lock(&sync->mutex);
+    sync->v = true;
+    pthread_cond_signal(&sync->cond);
+    pthread_mutex_unlock(&sync->mutex);
+}
+
+void lv_thread_sync_delete(lv_thread_sync_t * sync)
+{
+    pthread_cond_destroy(&sync->cond);
+    pthread_mutex_destroy(&sync->mutex);
+}
+
+#elif LV_USE_OS == LV_OS_FREERTOS
+
+lv_res_t lv_thread_init(lv_thread_t * thread, void (*callback)(void *), uint32_t stack_size, int32_t prio,
+                        int32_t core, void * user_data)
+{
+    thread->callback = callback;
+    thread->user_data = user_data;
+
+    BaseType_t ret;
+#ifdef ESP_PLATFORM
+    ret = xTaskCreatePinnedToCore(thread_entry, "lvgl", stack_size, thread, (UBaseType_t)prio, &thread->task,
+                                  core < 0 ? tskNO_AFFINITY : (BaseType_t)core);
+#else
+    LV_UNUSED(core);
+    ret = xTaskCreate(thread_entry, "lvgl", (configSTACK_DEPTH_TYPE)(stack_size / sizeof(StackType_t)), thread,
+                      (UBaseType_t)prio, &thread->task);
+#endif
+    if(ret != pdPASS) {
+        LV_LOG_ERROR("couldn't create the task");
+        return LV_RES_INV;
+    }
+    return LV_RES_OK;
+}
+
+lv_res_t lv_mutex_init(lv_mutex_t * mutex)
+{
+    *mutex = xSemaphoreCreateRecursiveMutex();
+    return *mutex ? LV_RES_OK : LV_RES_INV;
+}
+
+void lv_mutex_lock(lv_mutex_t * mutex)
+{
+    xSemaphoreTakeRecursive(*mutex, portMAX_DELAY);
+}
+
+void lv_mutex_unlock(lv_mutex_t * mutex)
+{
+    xSemaphoreGiveRecursive(*mutex);
+}
+
+void lv_mutex_delete(lv_mutex_t * mutex)
+{
+    vSemaphoreDelete(*mutex);
+    *mutex = NULL;
+}
+
+lv_res_t lv_thread_sync_init(lv_thread_sync_t * sync)
+{
+    *sync = xSemaphoreCreateBinary();
+    return *sync ? LV_RES_OK : LV_RES_INV;
+}
+
+void lv_thread_sync_wait(lv_thread_sync_t * sync)
+{
+    xSemaphoreTake(*sync, portMAX_DELAY);
+}
+
+void lv_thread_sync_signal(lv_thread_sync_t * sync)
+{
+    xSemaphoreGive(*sync);
+}
+
+void lv_thread_sync_delete(lv_thread_sync_t * sync)
+{
+    vSemaphoreDelete(*sync);
+    *sync = NULL;
+}
+
+#else /*LV_OS_NONE*/
+
+lv_res_t lv_thread_init(lv_thread_t * thread, void (*callback)(void *), uint32_t stack_size, int32_t prio,
+                        int32_t core, void * user_data)
+{
+    LV_UNUSED(thread);
+    LV_UNUSED(callback);
+    LV_UNUSED(stack_size);
+    LV_UNUSED(prio);
+    LV_UNUSED(core);
+    LV_UNUSED(user_data);
+    return LV_RES_INV;
+}
+
+lv_res_t lv_mutex_init(lv_mutex_t * mutex)
+{
+    LV_UNUSED(mutex);
+    return LV_RES_OK;
+}
+
+void lv_mutex_lock(lv_mutex_t * mutex)
+{
+    LV_UNUSED(mutex);
+}
+
+void lv_mutex_unlock(lv_mutex_t * mutex)
+{
+    LV_UNUSED(mutex);
+}
+
+void lv_mutex_delete(lv_mutex_t * mutex)
+{
+    LV_UNUSED(mutex);
+}
+
+lv_res_t lv_thread_sync_init(lv_thread_sync_t * sync)
+{
+    LV_UNUSED(sync);
+    return LV_RES_INV;
+}
+
+void lv_thread_sync_wait(lv_thread_sync_t * sync)
+{
+    LV_UNUSED(sync);
+}
+
+void lv_thread_sync_signal(lv_thread_sync_t * sync)
+{
+    LV_UNUSED(sync);
+}
+
+void lv_thread_sync_delete(lv_thread_sync_t * sync)
+{
+    LV_UNUSED(sync);
+}
+
+#endif
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_USE_OS == LV_OS_PTHREAD
+static void * thread_entry(void * arg)
+{
+    lv_thread_t * thread = arg;
+    thread->callback(thread->user_data);
+    return NULL;
+}
+#elif LV_USE_OS == LV_OS_FREERTOS
+static void thread_entry(void * arg)
+{
+    lv_thread_t * thread = arg;
+    thread->callback(thread->user_data);
+    vTaskDelete(NULL);
+}
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file lv_os.h
+ * Minimal threading layer for the parts of LVGL which can work in the background.
+ * LVGL itself is still not thread safe: only `lv_mem` is protected, everything else
+ * has to be called from the thread running `lv_timer_handler()`.
+ */
+
+#ifndef LV_OS_H
+#define LV_OS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "lv_types.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if LV_USE_OS == LV_OS_PTHREAD
+    #include <pthread.h>
+#elif LV_USE_OS == LV_OS_FREERTOS
+    #ifdef ESP_PLATFORM
+        #include "freertos/FreeRTOS.h"
+        #include "freertos/task.h"
+        #include "freertos/semphr.h"
+    #else
+        #include "FreeRTOS.h"
+        #include "task.h"
+        #include "semphr.h"
+    #endif
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+#if LV_USE_OS == LV_OS_PTHREAD
+
+typedef struct {
+    pthread_t thread;
+    void (*callback)(void *);
+    void * user_data;
+} lv_thread_t;
+
+typedef pthread_mutex_t lv_mutex_t;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool v;
+} lv_thread_sync_t;
+
+#elif LV_USE_OS == LV_OS_FREERTOS
+
+typedef struct {
+    TaskHandle_t task;
+    void (*callback)(void *);
+    void * user_data;
+} lv_thread_t;
+
+typedef SemaphoreHandle_t lv_mutex_t;
+
+typedef SemaphoreHandle_t lv_thread_sync_t;
+
+#else
+
+typedef int lv_thread_t;
+typedef int lv_mutex_t;
+typedef int lv_thread_sync_t;
+
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start a thread. It's deleted when `callback` returns.
+ * @param thread        pointer to a `lv_thread_t` variable, has to stay valid while the thread runs
+ * @param callback      the function to run
+ * @param stack_size    stack size in bytes (only for FreeRTOS)
+ * @param prio          priority of the task (only for FreeRTOS)
+ * @param core          CPU to run on, -1: any (only for ESP-IDF FreeRTOS)
+ * @param user_data     parameter of `callback`
+ * @return LV_RES_OK: started; LV_RES_INV: error or no OS
+ */
+lv_res_t lv_thread_init(lv_thread_t * thread, void (*callback)(void *), uint32_t stack_size, int32_t prio,
+                        int32_t core, void * user_data);
+
+/**
+ * Create a recursive mutex
+ * @param mutex pointer to a `lv_mutex_t` variable
+ * @return LV_RES_OK: created; LV_RES_INV: error
+ */
+lv_res_t lv_mutex_init(lv_mutex_t * mutex);
+
+void lv_mutex_lock(lv_mutex_t * mutex);
+
+void lv_mutex_unlock(lv_mutex_t * mutex);
+
+void lv_mutex_delete(lv_mutex_t * mutex);
+
+/**
+ * Create a binary signal: `lv_thread_sync_wait()` blocks until `lv_thread_sync_signal()` is called.
+ * Signals sent while nobody waits are not lost but not counted either.
+ * @param sync pointer to a `lv_thread_sync_t` variable
+ * @return LV_RES_OK: created; LV_RES_INV: error
+ */
+lv_res_t lv_thread_sync_init(lv_thread_sync_t * sync);
+
+void lv_thread_sync_wait(lv_thread_sync_t * sync);
+
+void lv_thread_sync_signal(lv_thread_sync_t * sync);
+
+void lv_thread_sync_delete(lv_thread_sync_t * sync);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_OS_H*/
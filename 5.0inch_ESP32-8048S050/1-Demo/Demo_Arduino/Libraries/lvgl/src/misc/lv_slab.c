@@ -0,0 +1,316 @@
+/**
+ * @file lv_slab.c
+ * Fixed size block pools carved out of a dedicated arena.
+ *
+ * The arena is split into equal pages. A page is handed to a size class (multiples of 8 bytes)
+ * on demand and split into blocks of that size. Free blocks are chained in a per page list,
+ * and the pages with free blocks are chained per class, so alloc and free are O(1).
+ * A page which becomes empty goes back to the arena and can serve any other class,
+ * so creating and deleting screens fragments neither the arena nor the heap.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_slab.h"
+#include "lv_mem.h"
+#include "lv_math.h"
+#include "lv_assert.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_SLAB_ENABLED
+
+#define SLAB_ALIGN      8
+#define SLAB_CLASS_CNT  (LV_SLAB_MAX_SIZE / SLAB_ALIGN)
+#define SLAB_PAGE_CNT   (LV_SLAB_ARENA_SIZE / LV_SLAB_PAGE_SIZE)
+#define SLAB_NONE       0xFFFF
+
+#if LV_SLAB_PAGE_SIZE % SLAB_ALIGN || LV_SLAB_MAX_SIZE % SLAB_ALIGN
+    #error "LV_SLAB_PAGE_SIZE and LV_SLAB_MAX_SIZE have to be multiples of 8"
+#endif
+
+#if LV_SLAB_MAX_SIZE > LV_SLAB_PAGE_SIZE
+    #error "LV_SLAB_MAX_SIZE can't be larger than LV_SLAB_PAGE_SIZE"
+#endif
+
+#if SLAB_PAGE_CNT == 0 || SLAB_PAGE_CNT >= SLAB_NONE
+    #error "LV_SLAB_ARENA_SIZE has to contain at least 1 and less than 65535 pages"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    void * free_head;   /*Freed blocks of the page, chained through their first word*/
+    uint16_t next;      /*Next page in the partial list of the class or in the free page list*/
+    uint16_t prev;
+    uint16_t used;      /*Number of allocated blocks*/
+    uint16_t carved;    /*Blocks given out at least once. The rest of the page is untouched.*/
+    uint16_t cls;       /*Index of the owner size class*/
+} slab_page_t;
+
+typedef struct {
+    uint16_t partial;   /*First page with free blocks*/
+    uint16_t page_cnt;
+    uint32_t used_cnt;
+    uint32_t max_used;
+} slab_class_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint16_t page_get(uint32_t c);
+static void page_release(uint16_t pi);
+static void partial_add(slab_class_t * cls, uint16_t pi);
+static void partial_remove(slab_class_t * cls, uint16_t pi);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static LV_ATTRIBUTE_LARGE_RAM_ARRAY uint64_t arena[LV_SLAB_ARENA_SIZE / sizeof(uint64_t)];
+static slab_page_t pages[SLAB_PAGE_CNT];
+static slab_class_t classes[SLAB_CLASS_CNT];
+static uint16_t free_page;
+static uint32_t free_page_cnt;
+static uint32_t fallback_cnt;
+
+/**********************
+ *      MACROS
+ **********************/
+#define SIZE_TO_CLASS(size)     (((size) - 1) / SLAB_ALIGN)
+#define CLASS_BLOCK_SIZE(c)     (((uint32_t)(c) + 1) * SLAB_ALIGN)
+#define CLASS_BLOCK_CNT(c)      (LV_SLAB_PAGE_SIZE / CLASS_BLOCK_SIZE(c))
+#define PAGE_ADDR(pi)           ((uint8_t *)arena + (uint32_t)(pi) * LV_SLAB_PAGE_SIZE)
+
+#endif /*LV_SLAB_ENABLED*/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_slab_init(void)
+{
+#if LV_SLAB_ENABLED
+    uint32_t i;
+    for(i = 0; i < SLAB_PAGE_CNT; i++) {
+        lv_memset_00(&pages[i], sizeof(slab_page_t));
+        pages[i].next = i + 1 < SLAB_PAGE_CNT ? (uint16_t)(i + 1) : SLAB_NONE;
+    }
+    free_page = 0;
+    free_page_cnt = SLAB_PAGE_CNT;
+
+    lv_memset_00(classes, sizeof(classes));
+    for(i = 0; i < SLAB_CLASS_CNT; i++) {
+        classes[i].partial = SLAB_NONE;
+    }
+    fallback_cnt = 0;
+#endif
+}
+
+void lv_slab_deinit(void)
+{
+    lv_slab_init();
+}
+
+void * lv_slab_alloc(size_t size)
+{
+#if LV_SLAB_ENABLED
+    if(size == 0 || size > LV_SLAB_MAX_SIZE) return lv_mem_alloc(size);
+
+    uint32_t c = SIZE_TO_CLASS(size);
+    slab_class_t * cls = &classes[c];
+    uint16_t pi = cls->partial;
+    if(pi == SLAB_NONE) {
+        pi = page_get(c);
+        if(pi == SLAB_NONE) {
+            fallback_cnt++;
+            return lv_mem_alloc(size);
+        }
+    }
+
+    slab_page_t * page = &pages[pi];
+    void * block;
+    if(page->free_head) {
+        block = page->free_head;
+        page->free_head = *(void **)block;
+    }
+    else {
+        block = PAGE_ADDR(pi) + page->carved * CLASS_BLOCK_SIZE(c);
+        page->carved++;
+    }
+
+    page->used++;
+    if(page->used == CLASS_BLOCK_CNT(c)) partial_remove(cls, pi);
+
+    cls->used_cnt++;
+    if(cls->used_cnt > cls->max_used) cls->max_used = cls->used_cnt;
+
+    return block;
+#else
+    return lv_mem_alloc(size);
+#endif
+}
+
+void lv_slab_free(void * data)
+{
+#if LV_SLAB_ENABLED
+    if(!_lv_slab_owns(data)) {
+        lv_mem_free(data);
+        return;
+    }
+
+    uint16_t pi = (uint16_t)(((uint8_t *)data - (uint8_t *)arena) / LV_SLAB_PAGE_SIZE);
+    slab_page_t * page = &pages[pi];
+    slab_class_t * cls = &classes[page->cls];
+    LV_ASSERT_MSG(page->used > 0, "Slab block freed twice");
+
+    bool was_full = page->used == CLASS_BLOCK_CNT(page->cls);
+    *(void **)data = page->free_head;
+    page->free_head = data;
+    page->used--;
+    cls->used_cnt--;
+
+    if(page->used == 0) {
+        if(!was_full) partial_remove(cls, pi);
+        page_release(pi);
+    }
+    else if(was_full) {
+        partial_add(cls, pi);
+    }
+#else
+    lv_mem_free(data);
+#endif
+}
+
+void * lv_slab_realloc(void * data, size_t new_size)
+{
+#if LV_SLAB_ENABLED
+    /*`lv_mem_alloc(0)` gives a sentinel for empty arrays, start them again from a slab too*/
+    if(data == NULL || data == lv_mem_alloc(0)) return lv_slab_alloc(new_size);
+    if(!_lv_slab_owns(data)) return lv_mem_realloc(data, new_size);
+
+    if(new_size == 0) {
+        lv_slab_free(data);
+        return lv_mem_alloc(0);
+    }
+
+    /*Stay in place if the size class doesn't change*/
+    uint16_t pi = (uint16_t)(((uint8_t *)data - (uint8_t *)arena) / LV_SLAB_PAGE_SIZE);
+    uint32_t old_c = pages[pi].cls;
+    if(new_size <= LV_SLAB_MAX_SIZE && SIZE_TO_CLASS(new_size) == old_c) return data;
+
+    void * new_p = lv_slab_alloc(new_size);
+    if(new_p == NULL) return NULL;
+
+    lv_memcpy(new_p, data, LV_MIN(CLASS_BLOCK_SIZE(old_c), new_size));
+    lv_slab_free(data);
+    return new_p;
+#else
+    return lv_mem_realloc(data, new_size);
+#endif
+}
+
+bool _lv_slab_owns(const void * data)
+{
+#if LV_SLAB_ENABLED
+    const uint8_t * p = data;
+    return p >= (const uint8_t *)arena && p < (const uint8_t *)arena + sizeof(arena);
+#else
+    LV_UNUSED(data);
+    return false;
+#endif
+}
+
+void lv_slab_monitor(lv_slab_monitor_t * mon_p)
+{
+    lv_memset_00(mon_p, sizeof(lv_slab_monitor_t));
+#if LV_SLAB_ENABLED
+    mon_p->page_cnt = SLAB_PAGE_CNT;
+    mon_p->free_page_cnt = free_page_cnt;
+    mon_p->fallback_cnt = fallback_cnt;
+
+    uint32_t i;
+    for(i = 0; i < SLAB_CLASS_CNT; i++) {
+        mon_p->used_cnt += classes[i].used_cnt;
+    }
+#endif
+}
+
+void lv_slab_monitor_class(size_t size, lv_slab_class_monitor_t * mon_p)
+{
+    lv_memset_00(mon_p, sizeof(lv_slab_class_monitor_t));
+#if LV_SLAB_ENABLED
+    if(size == 0 || size > LV_SLAB_MAX_SIZE) return;
+
+    uint32_t c = SIZE_TO_CLASS(size);
+    mon_p->block_size = CLASS_BLOCK_SIZE(c);
+    mon_p->page_cnt = classes[c].page_cnt;
+    mon_p->capacity = classes[c].page_cnt * CLASS_BLOCK_CNT(c);
+    mon_p->used_cnt = classes[c].used_cnt;
+    mon_p->max_used = classes[c].max_used;
+#else
+    LV_UNUSED(size);
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_SLAB_ENABLED
+
+/**
+ * Take a page from the arena and give it to a size class
+ * @param c index of the size class
+ * @return index of the page or `SLAB_NONE` if the arena is full
+ */
+static uint16_t page_get(uint32_t c)
+{
+    uint16_t pi = free_page;
+    if(pi == SLAB_NONE) return SLAB_NONE;
+
+    slab_page_t * page = &pages[pi];
+    free_page = page->next;
+    free_page_cnt--;
+
+    page->free_head = NULL;
+    page->used = 0;
+    page->carved = 0;
+    page->cls = (uint16_t)c;
+
+    classes[c].page_cnt++;
+    partial_add(&classes[c], pi);
+    return pi;
+}
+
+/**
+ * Give an empty page back to the arena
+ * @param pi index of the page
+ */
+static void page_release(uint16_t pi)
+{
+    classes[pages[pi].cls].page_cnt--;
+    pages[pi].next = free_page;
+    free_page = pi;
+    free_page_cnt++;
+}
+
+static void partial_add(slab_class_t * cls, uint16_t pi)
+{
+    pages[pi].prev = SLAB_NONE;
+    pages[pi].next = cls->partial;
+    if(cls->partial != SLAB_NONE) pages[cls->partial].prev = pi;
+    cls->partial = pi;
+}
+
+static void partial_remove(slab_class_t * cls, uint16_t pi)
+{
+    slab_page_t * page = &pages[pi];
+    if(page->prev != SLAB_NONE) pages[page->prev].next = page->next;
+    else cls->partial = page->next;
+    if(page->next != SLAB_NONE) pages[page->next].prev = page->prev;
+}
+
+#endif /*LV_SLAB_ENABLED*/
@@ -0,0 +1,126 @@
+/**
+ * @file lv_slab.h
+ * Fixed size block pools for small, frequently created and deleted data
+ * (objects, linked list nodes, animations, event descriptors).
+ */
+
+#ifndef LV_SLAB_H
+#define LV_SLAB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The slab arena isn't scanned by a garbage collector so it can't be used together with it*/
+#if LV_USE_SLAB && !LV_ENABLE_GC
+    #define LV_SLAB_ENABLED 1
+#else
+    #define LV_SLAB_ENABLED 0
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Arena level information
+ */
+typedef struct {
+    uint32_t page_cnt;      /**< Number of pages in the arena*/
+    uint32_t free_page_cnt; /**< Pages not owned by any size class*/
+    uint32_t used_cnt;      /**< Allocated blocks in all size classes*/
+    uint32_t fallback_cnt;  /**< Allocations which went to `lv_mem_alloc()` because the arena was full*/
+} lv_slab_monitor_t;
+
+/**
+ * Information about one size class
+ */
+typedef struct {
+    uint32_t block_size;    /**< Size of the blocks in bytes*/
+    uint32_t page_cnt;      /**< Pages owned by the class*/
+    uint32_t capacity;      /**< Number of blocks fitting into the owned pages*/
+    uint32_t used_cnt;      /**< Allocated blocks*/
+    uint32_t max_used;      /**< Max. number of allocated blocks*/
+} lv_slab_class_monitor_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the slab arena. All pages become free.
+ */
+void lv_slab_init(void);
+
+/**
+ * Forget every allocation and reinitialize the arena.
+ * @note Only for `lv_deinit()`, when nothing refers to the blocks anymore
+ */
+void lv_slab_deinit(void);
+
+/**
+ * Allocate a block from the slab of the size class of `size`.
+ * Too large sizes and allocations when the arena is full are passed to `lv_mem_alloc()`.
+ * The result can be freed with `lv_mem_free()` or `lv_slab_free()`.
+ * @param size size of the memory to allocate in bytes
+ * @return pointer to the allocated memory or NULL on error
+ */
+void * lv_slab_alloc(size_t size);
+
+/**
+ * Free a block allocated with `lv_slab_alloc()`. Blocks not in the arena are passed to `lv_mem_free()`.
+ * @param data pointer to an allocated memory
+ */
+void lv_slab_free(void * data);
+
+/**
+ * Reallocate a memory with a new size. The old content will be kept.
+ * Unlike `lv_mem_realloc()` a `NULL`, empty or slab allocated `data` gets its new block from the slabs.
+ * @param data pointer to an allocated memory or NULL
+ * @param new_size the desired new size in bytes
+ * @return pointer to the new memory
+ */
+void * lv_slab_realloc(void * data, size_t new_size);
+
+/**
+ * Tell whether a pointer belongs to the slab arena
+ * @param data pointer to check
+ * @return true: `data` was allocated from a slab
+ */
+bool _lv_slab_owns(const void * data);
+
+/**
+ * Give information about the whole arena
+ * @param mon_p pointer to a `lv_slab_monitor_t` variable, the result of the analysis will be stored here
+ */
+void lv_slab_monitor(lv_slab_monitor_t * mon_p);
+
+/**
+ * Give information about the size class serving allocations of `size` bytes
+ * @param size an allocation size, e.g. `sizeof(lv_anim_t)`
+ * @param mon_p pointer to a `lv_slab_class_monitor_t` variable, the result of the analysis will be stored here.
+ *              It will be zeroed if `size` is not served by the slabs.
+ */
+void lv_slab_monitor_class(size_t size, lv_slab_class_monitor_t * mon_p);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_SLAB_H*/
@@ -49,27 +49,43 @@ extern "C" {
 #define LV_IMG_ZOOM_NONE            256        /*Value for not zooming the image*/
 LV_EXPORT_CONST_INT(LV_IMG_ZOOM_NONE);
 
+/**
+ * The `has_group` bit of a property as a constant expression. Same as `1 << _lv_style_get_prop_group(prop)`.
+ */
+#define LV_STYLE_PROP_GROUP_BIT(prop) \
+    ((uint8_t)(1 << (((prop) & 0x1FF) >> 4 > 7 ? 7 : ((prop) & 0x1FF) >> 4)))
+
 // *INDENT-OFF*
+/**
+ * Create a constant style which stays in ROM.
+ * `groups` is the OR-ed `LV_STYLE_PROP_GROUP_BIT()` of the properties in `prop_array`.
+ * With the exact groups the style is skipped when looking for properties it doesn't have.
+ */
 #if LV_USE_ASSERT_STYLE
-#define LV_STYLE_CONST_INIT(var_name, prop_array)                       \
+#define LV_STYLE_CONST_INIT_GROUPS(var_name, prop_array, groups)        \
     const lv_style_t var_name = {                                       \
         .sentinel = LV_STYLE_SENTINEL_VALUE,                            \
         .v_p = { .const_props = prop_array },                           \
-        .has_group = 0xFF,                                              \
+        .has_group = (groups),                                          \
         .prop1 = LV_STYLE_PROP_ANY,                                     \
         .prop_cnt = (sizeof(prop_array) / sizeof((prop_array)[0])),     \
     }
 #else
-#define LV_STYLE_CONST_INIT(var_name, prop_array)                       \
+#define LV_STYLE_CONST_INIT_GROUPS(var_name, prop_array, groups)        \
     const lv_style_t var_name = {                                       \
         .v_p = { .const_props = prop_array },                           \
-        .has_group = 0xFF,                                              \
+        .has_group = (groups),                                          \
         .prop1 = LV_STYLE_PROP_ANY,                                     \
         .prop_cnt = (sizeof(prop_array) / sizeof((prop_array)[0])),     \
     }
 #endif
 // *INDENT-ON*
 
+/**
+ * Create a constant style which stays in ROM and can contain properties from any group.
+ */
+#define LV_STYLE_CONST_INIT(var_name, prop_array) LV_STYLE_CONST_INIT_GROUPS(var_name, prop_array, 0xFF)
+
 /** On simple system, don't waste resources on gradients */
 #if !defined(LV_DRAW_COMPLEX) || !defined(LV_GRADIENT_MAX_STOPS)
 #define LV_GRADIENT_MAX_STOPS 2
@@ -9,6 +9,7 @@
 #include "../hal/lv_hal_tick.h"
 #include "lv_assert.h"
 #include "lv_mem.h"
+#include "lv_slab.h"
 #include "lv_ll.h"
 #include "lv_gc.h"
 
@@ -17,6 +18,11 @@
  *********************/
 #define IDLE_MEAS_PERIOD 500 /*[ms]*/
 #define DEF_PERIOD 500
+#define QUEUE_NONE 0xFFFFFFFF   /*`queue_id` of paused timers*/
+#define QUEUE_MIN_SIZE 8
+
+/*The next runs are compared with wrapping ticks so they need to be close to each other*/
+#define MAX_PERIOD 0x3FFFFFFF
 
 /**********************
  *      TYPEDEFS
@@ -27,6 +33,12 @@
  **********************/
 static bool lv_timer_exec(lv_timer_t * timer);
 static uint32_t lv_timer_time_remaining(lv_timer_t * timer);
+static uint32_t timer_period(const lv_timer_t * timer);
+static bool timer_before(const lv_timer_t * a, const lv_timer_t * b);
+static void queue_add(lv_timer_t * timer);
+static void queue_remove(lv_timer_t * timer);
+static void queue_update(lv_timer_t * timer);
+static void queue_set(uint32_t id, lv_timer_t * timer);
 
 /**********************
  *  STATIC VARIABLES
@@ -34,7 +46,10 @@ static uint32_t lv_timer_time_remaining(lv_timer_t * timer);
 static bool lv_timer_run = false;
 static uint8_t idle_last = 0;
 static bool timer_deleted;
-static bool timer_created;
+static uint32_t handler_round;
+static uint32_t create_cnt;
+static uint32_t queue_cnt;
+static uint32_t queue_size;
 
 /**********************
  *      MACROS
@@ -55,6 +70,11 @@ static bool timer_created;
 void _lv_timer_core_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_timer_ll), sizeof(lv_timer_t));
+    LV_GC_ROOT(_lv_timer_queue) = NULL;
+    queue_cnt = 0;
+    queue_size = 0;
+    handler_round = 0;
+    create_cnt = 0;
 
     /*Initially enable the lv_timer handling*/
     lv_timer_enable(true);
@@ -95,40 +115,20 @@ LV_ATTRIBUTE_TIMER_HANDLER uint32_t lv_timer_handler(void)
         }
     }
 
-    /*Run all timer from the list*/
-    lv_timer_t * next;
-    do {
-        timer_deleted             = false;
-        timer_created             = false;
-        LV_GC_ROOT(_lv_timer_act) = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-        while(LV_GC_ROOT(_lv_timer_act)) {
-            /*The timer might be deleted if it runs only once ('repeat_count = 1')
-             *So get next element until the current is surely valid*/
-            next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), LV_GC_ROOT(_lv_timer_act));
-
-            if(lv_timer_exec(LV_GC_ROOT(_lv_timer_act))) {
-                /*If a timer was created or deleted then this or the next item might be corrupted*/
-                if(timer_created || timer_deleted) {
-                    TIMER_TRACE("Start from the first timer again because a timer was created or deleted");
-                    break;
-                }
-            }
-
-            LV_GC_ROOT(_lv_timer_act) = next; /*Load the next timer*/
-        }
-    } while(LV_GC_ROOT(_lv_timer_act));
-
-    uint32_t time_till_next = LV_NO_TIMER_READY;
-    next = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-    while(next) {
-        if(!next->paused) {
-            uint32_t delay = lv_timer_time_remaining(next);
-            if(delay < time_till_next)
-                time_till_next = delay;
-        }
+    /*Run the ready timers. They are taken from the top of the queue, so if nothing is ready
+     *only the first timer is checked. Each timer runs at most once in a round.*/
+    handler_round++;
+    while(queue_cnt > 0) {
+        lv_timer_t * timer = LV_GC_ROOT(_lv_timer_queue)[0];
+        /*The remaining timers ran already in this round or they are not ready yet*/
+        if(timer->run_round == handler_round || lv_timer_time_remaining(timer) > 0) break;
 
-        next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), next); /*Find the next timer*/
+        LV_GC_ROOT(_lv_timer_act) = timer;
+        lv_timer_exec(timer);
     }
+    LV_GC_ROOT(_lv_timer_act) = NULL;
+
+    uint32_t time_till_next = lv_timer_get_time_until_next();
 
     busy_time += lv_tick_elaps(handler_start);
     uint32_t idle_period_time = lv_tick_elaps(idle_period_start);
@@ -178,8 +178,10 @@ lv_timer_t * lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void * us
     new_timer->paused = 0;
     new_timer->last_run = lv_tick_get();
     new_timer->user_data = user_data;
-
-    timer_created = true;
+    new_timer->run_round = handler_round - 1;   /*Can run in the current round too*/
+    new_timer->create_id = create_cnt++;
+    new_timer->queue_id = QUEUE_NONE;
+    queue_add(new_timer);
 
     return new_timer;
 }
@@ -201,9 +203,10 @@ void lv_timer_set_cb(lv_timer_t * timer, lv_timer_cb_t timer_cb)
 void lv_timer_del(lv_timer_t * timer)
 {
     _lv_ll_remove(&LV_GC_ROOT(_lv_timer_ll), timer);
+    queue_remove(timer);
     timer_deleted = true;
 
-    lv_mem_free(timer);
+    lv_slab_free(timer);
 }
 
 /**
@@ -212,12 +215,23 @@ void lv_timer_del(lv_timer_t * timer)
  */
 void lv_timer_pause(lv_timer_t * timer)
 {
+    if(timer->paused) return;
+
     timer->paused = true;
+    queue_remove(timer);
 }
 
 void lv_timer_resume(lv_timer_t * timer)
 {
+    if(!timer->paused) return;
+
+    /*If it was paused for long, it's simply ready*/
+    if(lv_tick_elaps(timer->last_run) > timer_period(timer)) {
+        timer->last_run = lv_tick_get() - timer_period(timer);
+    }
+
     timer->paused = false;
+    queue_add(timer);
 }
 
 /**
@@ -228,6 +242,7 @@ void lv_timer_resume(lv_timer_t * timer)
 void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 {
     timer->period = period;
+    queue_update(timer);
 }
 
 /**
@@ -236,7 +251,8 @@ void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
  */
 void lv_timer_ready(lv_timer_t * timer)
 {
-    timer->last_run = lv_tick_get() - timer->period - 1;
+    timer->last_run = lv_tick_get() - timer_period(timer) - 1;
+    queue_update(timer);
 }
 
 /**
@@ -257,6 +273,7 @@ void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 void lv_timer_reset(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get();
+    queue_update(timer);
 }
 
 /**
@@ -277,6 +294,13 @@ uint8_t lv_timer_get_idle(void)
     return idle_last;
 }
 
+uint32_t lv_timer_get_time_until_next(void)
+{
+    /*Paused timers are not in the queue*/
+    if(queue_cnt == 0) return LV_NO_TIMER_READY;
+    return lv_timer_time_remaining(LV_GC_ROOT(_lv_timer_queue)[0]);
+}
+
 /**
  * Iterate through the timers
  * @param timer NULL to start iteration or the previous return value to get the next timer
@@ -301,6 +325,7 @@ static bool lv_timer_exec(lv_timer_t * timer)
 {
     if(timer->paused) return false;
 
+    timer_deleted = false;
     bool exec = false;
     if(lv_timer_time_remaining(timer) == 0) {
         /* Decrement the repeat count before executing the timer_cb.
@@ -309,6 +334,9 @@ static bool lv_timer_exec(lv_timer_t * timer)
         int32_t original_repeat_count = timer->repeat_count;
         if(timer->repeat_count > 0) timer->repeat_count--;
         timer->last_run = lv_tick_get();
+        timer->run_round = handler_round;
+        /*Reorder now, the callback might delete the timer*/
+        queue_update(timer);
         TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
         if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
         TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
@@ -334,8 +362,116 @@ static bool lv_timer_exec(lv_timer_t * timer)
 static uint32_t lv_timer_time_remaining(lv_timer_t * timer)
 {
     /*Check if at least 'period' time elapsed*/
+    uint32_t period = timer_period(timer);
     uint32_t elp = lv_tick_elaps(timer->last_run);
-    if(elp >= timer->period)
+    if(elp >= period)
         return 0;
-    return timer->period - elp;
+    return period - elp;
+}
+
+static uint32_t timer_period(const lv_timer_t * timer)
+{
+    return LV_MIN(timer->period, MAX_PERIOD);
+}
+
+/**
+ * Tell whether a timer needs to run before an other
+ * @param a pointer to a timer
+ * @param b pointer to an other timer
+ * @return true: `a` has an earlier next run. At the same time the ones which haven't run in this round
+ *         and then the newer ones are the first, as they were in the linked list.
+ */
+static bool timer_before(const lv_timer_t * a, const lv_timer_t * b)
+{
+    int32_t diff = (int32_t)((a->last_run + timer_period(a)) - (b->last_run + timer_period(b)));
+    if(diff != 0) return diff < 0;
+
+    bool a_ran = a->run_round == handler_round;
+    bool b_ran = b->run_round == handler_round;
+    if(a_ran != b_ran) return b_ran;
+
+    /*`create_id` is 31 bit, shift it to compare with wrapping*/
+    return (int32_t)((uint32_t)(b->create_id - a->create_id) << 1) < 0;
+}
+
+/**
+ * Add a not paused timer to the queue
+ * @param timer pointer to a timer
+ */
+static void queue_add(lv_timer_t * timer)
+{
+    if(timer->paused) return;
+
+    if(queue_cnt == queue_size) {
+        uint32_t new_size = queue_size ? queue_size * 2 : QUEUE_MIN_SIZE;
+        lv_timer_t ** new_queue = lv_mem_realloc(LV_GC_ROOT(_lv_timer_queue), new_size * sizeof(lv_timer_t *));
+        LV_ASSERT_MALLOC(new_queue);
+        if(new_queue == NULL) {
+            LV_LOG_ERROR("couldn't add the timer to the queue, it won't run");
+            return;
+        }
+        LV_GC_ROOT(_lv_timer_queue) = new_queue;
+        queue_size = new_size;
+    }
+
+    queue_set(queue_cnt, timer);
+    queue_cnt++;
+    queue_update(timer);
+}
+
+/**
+ * Remove a timer from the queue
+ * @param timer pointer to a timer
+ */
+static void queue_remove(lv_timer_t * timer)
+{
+    uint32_t id = timer->queue_id;
+    if(id == QUEUE_NONE) return;
+
+    timer->queue_id = QUEUE_NONE;
+    queue_cnt--;
+    if(id == queue_cnt) return;
+
+    /*Fill the gap with the last timer*/
+    lv_timer_t * last = LV_GC_ROOT(_lv_timer_queue)[queue_cnt];
+    queue_set(id, last);
+    queue_update(last);
+}
+
+/**
+ * Move a timer to its place in the queue after its next run has changed
+ * @param timer pointer to a timer
+ */
+static void queue_update(lv_timer_t * timer)
+{
+    if(timer->queue_id == QUEUE_NONE) return;
+
+    lv_timer_t ** queue = LV_GC_ROOT(_lv_timer_queue);
+    uint32_t id = timer->queue_id;
+
+    /*Move up while it's before its parent*/
+    while(id > 0) {
+        uint32_t parent = (id - 1) / 2;
+        if(!timer_before(timer, queue[parent])) break;
+        queue_set(id, queue[parent]);
+        id = parent;
+    }
+
+    /*Move down while a child is before it*/
+    while(true) {
+        uint32_t child = id * 2 + 1;
+        if(child >= queue_cnt) break;
+        if(child + 1 < queue_cnt && timer_before(queue[child + 1], queue[child])) child++;
+        if(!timer_before(queue[child], timer)) break;
+        queue_set(id, queue[child]);
+        id = child;
+    }
+
+    queue_set(id, timer);
+}
+
+static void queue_set(uint32_t id, lv_timer_t * timer)
+{
+    LV_GC_ROOT(_lv_timer_queue)[id] = timer;
+    timer->queue_id = id;
 }
@@ -48,6 +48,9 @@ typedef struct _lv_timer_t {
     void * user_data; /**< Custom user data*/
     int32_t repeat_count; /**< 1: One time;  -1 : infinity;  n>0: residual times*/
     uint32_t paused : 1;
+    uint32_t create_id : 31; /**< Newer timers run first if they are ready at the same time, internal*/
+    uint32_t queue_id; /**< Index in the queue of running timers, internal*/
+    uint32_t run_round; /**< Round of `lv_timer_handler()` in which it ran last time, internal*/
 } lv_timer_t;
 
 /**********************
@@ -165,6 +168,13 @@ void lv_timer_enable(bool en);
  */
 uint8_t lv_timer_get_idle(void);
 
+/**
+ * Get the time until the next timer needs to run. It's the same as what `lv_timer_handler()` returned
+ * unless a timer was created, made ready, etc. since then.
+ * @return time till the next timer run (in ms) or `LV_NO_TIMER_READY` if there are no running timers
+ */
+uint32_t lv_timer_get_time_until_next(void);
+
 /**
  * Iterate through the timers
  * @param timer NULL to start iteration or the previous return value to get the next timer
@@ -26,6 +26,11 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static bool txt_get_lines(lv_point_t * size_res, const char * text, const lv_font_t * font, lv_coord_t letter_space,
+                          lv_coord_t line_space, lv_coord_t max_width, lv_text_flag_t flag, lv_txt_layout_t * layout);
+static bool layout_reserve(lv_txt_layout_t * layout, uint32_t cnt);
+static void layout_normalize(lv_coord_t * max_width, lv_text_flag_t * flag);
+
 
 #if LV_TXT_ENC == LV_TXT_ENC_UTF8
     static uint8_t lv_txt_utf8_size(const char * str);
@@ -91,49 +96,64 @@
 void lv_txt_get_size(lv_point_t * size_res, const char * text, const lv_font_t * font, lv_coord_t letter_space,
                      lv_coord_t line_space, lv_coord_t max_width, lv_text_flag_t flag)
 {
-    size_res->x = 0;
-    size_res->y = 0;
-
-    if(text == NULL) return;
-    if(font == NULL) return;
-
-    if(flag & LV_TEXT_FLAG_EXPAND) max_width = LV_COORD_MAX;
-
-    uint32_t line_start     = 0;
-    uint32_t new_line_start = 0;
-    uint16_t letter_height = lv_font_get_line_height(font);
+    txt_get_lines(size_res, text, font, letter_space, line_space, max_width, flag, NULL);
+}
 
-    /*Calc. the height and longest line*/
-    while(text[line_start] != '\0') {
-        new_line_start += _lv_txt_get_next_line(&text[line_start], font, letter_space, max_width, NULL, flag);
+void _lv_txt_layout_init(lv_txt_layout_t * layout)
+{
+    lv_memset_00(layout, sizeof(lv_txt_layout_t));
+}
 
-        if((unsigned long)size_res->y + (unsigned long)letter_height + (unsigned long)line_space > LV_MAX_OF(lv_coord_t)) {
-            LV_LOG_WARN("lv_txt_get_size: integer overflow while calculating text height");
-            return;
-        }
-        else {
-            size_res->y += letter_height;
-            size_res->y += line_space;
-        }
+const lv_txt_layout_t * _lv_txt_layout_get(lv_txt_layout_t * layout, const char * text, const lv_font_t * font,
+                                           lv_coord_t letter_space, lv_coord_t line_space, lv_coord_t max_width,
+                                           lv_text_flag_t flag)
+{
+    if(text == NULL) return NULL;
+    if(font == NULL) return NULL;
 
-        /*Calculate the longest line*/
-        lv_coord_t act_line_length = lv_txt_get_width(&text[line_start], new_line_start - line_start, font, letter_space,
-                                                      flag);
+    layout_normalize(&max_width, &flag);
 
-        size_res->x = LV_MAX(act_line_length, size_res->x);
-        line_start  = new_line_start;
+    /*FNV-1a hash of the text to see if it has changed*/
+    uint32_t len = 0;
+    uint32_t hash = 2166136261U;
+    while(text[len] != '\0') {
+        hash = (hash ^ (uint8_t)text[len]) * 16777619U;
+        len++;
     }
 
-    /*Make the text one line taller if the last character is '\n' or '\r'*/
-    if((line_start != 0) && (text[line_start - 1] == '\n' || text[line_start - 1] == '\r')) {
-        size_res->y += letter_height + line_space;
+    if(layout->font == font && layout->txt_len == len && layout->txt_hash == hash &&
+       layout->letter_space == letter_space && layout->line_space == line_space &&
+       layout->max_width == max_width && layout->flag == flag) {
+        return layout;
     }
 
-    /*Correction with the last line space or set the height manually if the text is empty*/
-    if(size_res->y == 0)
-        size_res->y = letter_height;
-    else
-        size_res->y -= line_space;
+    layout->font = NULL;
+    layout->line_cnt = 0;
+    if(!layout_reserve(layout, 1)) return NULL;
+    if(!txt_get_lines(&layout->size, text, font, letter_space, line_space, max_width, flag, layout)) return NULL;
+
+    layout->font = font;
+    layout->txt_len = len;
+    layout->txt_hash = hash;
+    layout->letter_space = letter_space;
+    layout->line_space = line_space;
+    layout->max_width = max_width;
+    layout->flag = flag;
+    return layout;
+}
+
+bool _lv_txt_layout_is_valid(const lv_txt_layout_t * layout, const lv_font_t * font, lv_coord_t letter_space,
+                             lv_coord_t max_width, lv_text_flag_t flag)
+{
+    layout_normalize(&max_width, &flag);
+    return layout->font != NULL && layout->font == font && layout->letter_space == letter_space &&
+           layout->max_width == max_width && layout->flag == flag;
+}
+
+void _lv_txt_layout_free(lv_txt_layout_t * layout)
+{
+    lv_mem_free(layout->lines);
+    _lv_txt_layout_init(layout);
 }
 
 /**
@@ -496,6 +516,110 @@ void _lv_txt_encoded_letter_next_2(const char * txt, uint32_t * letter, uint32_t
     *letter_next = *letter != '\0' ? _lv_txt_encoded_next(&txt[*ofs], NULL) : 0;
 }
 
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Break a text into lines and get its size
+ * @param layout if not NULL the lines are stored here too
+ * @return false if the text is too high or `layout` couldn't be allocated
+ */
+static bool txt_get_lines(lv_point_t * size_res, const char * text, const lv_font_t * font, lv_coord_t letter_space,
+                          lv_coord_t line_space, lv_coord_t max_width, lv_text_flag_t flag, lv_txt_layout_t * layout)
+{
+    size_res->x = 0;
+    size_res->y = 0;
+
+    if(text == NULL) return false;
+    if(font == NULL) return false;
+
+    if(flag & LV_TEXT_FLAG_EXPAND) max_width = LV_COORD_MAX;
+
+    uint32_t line_start     = 0;
+    uint32_t new_line_start = 0;
+    uint16_t letter_height = lv_font_get_line_height(font);
+
+    /*Calc. the height and longest line*/
+    while(text[line_start] != '\0') {
+        new_line_start += _lv_txt_get_next_line(&text[line_start], font, letter_space, max_width, NULL, flag);
+
+        if((unsigned long)size_res->y + (unsigned long)letter_height + (unsigned long)line_space > LV_MAX_OF(lv_coord_t)) {
+            LV_LOG_WARN("lv_txt_get_size: integer overflow while calculating text height");
+            return false;
+        }
+        else {
+            size_res->y += letter_height;
+            size_res->y += line_space;
+        }
+
+        /*Calculate the longest line*/
+        lv_coord_t act_line_length = lv_txt_get_width(&text[line_start], new_line_start - line_start, font, letter_space,
+                                                      flag);
+
+        size_res->x = LV_MAX(act_line_length, size_res->x);
+
+        if(layout) {
+            if(!layout_reserve(layout, layout->line_cnt + 2)) return false;
+            layout->lines[layout->line_cnt].start = line_start;
+            layout->lines[layout->line_cnt].width = act_line_length;
+            layout->line_cnt++;
+        }
+
+        line_start  = new_line_start;
+    }
+
+    if(layout) {
+        layout->lines[layout->line_cnt].start = line_start;
+        layout->lines[layout->line_cnt].width = 0;
+    }
+
+    /*Make the text one line taller if the last character is '\n' or '\r'*/
+    if((line_start != 0) && (text[line_start - 1] == '\n' || text[line_start - 1] == '\r')) {
+        size_res->y += letter_height + line_space;
+    }
+
+    /*Correction with the last line space or set the height manually if the text is empty*/
+    if(size_res->y == 0)
+        size_res->y = letter_height;
+    else
+        size_res->y -= line_space;
+
+    return true;
+}
+
+/**
+ * Make sure that a layout has space for some lines
+ * @param cnt the required number of items in `layout->lines`
+ * @return false if the memory couldn't be allocated
+ */
+static bool layout_reserve(lv_txt_layout_t * layout, uint32_t cnt)
+{
+    if(cnt <= layout->line_cap) return true;
+
+    uint32_t new_cap = LV_MAX(layout->line_cap * 2, 2);
+    while(new_cap < cnt) new_cap *= 2;
+    lv_txt_line_t * lines = lv_mem_realloc(layout->lines, new_cap * sizeof(lv_txt_line_t));
+    LV_ASSERT_MALLOC(lines);
+    if(lines == NULL) return false;
+
+    layout->lines = lines;
+    layout->line_cap = new_cap;
+    return true;
+}
+
+/**
+ * Without wrapping the width doesn't matter, and `LV_TEXT_FLAG_EXPAND` and `LV_TEXT_FLAG_FIT`
+ * give the same lines, so make these parameters the same for the layouts.
+ */
+static void layout_normalize(lv_coord_t * max_width, lv_text_flag_t * flag)
+{
+    if(*flag & (LV_TEXT_FLAG_EXPAND | LV_TEXT_FLAG_FIT)) {
+        *max_width = LV_COORD_MAX;
+        *flag = (*flag & ~LV_TEXT_FLAG_FIT) | LV_TEXT_FLAG_EXPAND;
+    }
+}
+
 #if LV_TXT_ENC == LV_TXT_ENC_UTF8
 /*******************************
  *   UTF-8 ENCODER/DECODER
@@ -65,6 +65,30 @@ enum {
 };
 typedef uint8_t lv_text_align_t;
 
+/** A line of a text layout*/
+typedef struct {
+    uint32_t start;         /**< Byte index of the first character of the line*/
+    lv_coord_t width;       /**< Width of the line in pixels*/
+} lv_txt_line_t;
+
+/**
+ * Line breaks and line widths of a text. The text is measured only once
+ * and reused while the text, the font and the other parameters are the same.
+ */
+typedef struct {
+    const lv_font_t * font;     /**< NULL if the layout is invalid*/
+    uint32_t txt_len;           /**< Length of the measured text in bytes*/
+    uint32_t txt_hash;          /**< Hash of the measured text*/
+    lv_coord_t letter_space;
+    lv_coord_t line_space;
+    lv_coord_t max_width;       /**< `LV_COORD_MAX` if the lines are not wrapped*/
+    lv_text_flag_t flag;
+    uint32_t line_cnt;
+    uint32_t line_cap;          /**< Number of allocated items in `lines`*/
+    lv_txt_line_t * lines;      /**< `line_cnt` lines and the end of the text in `lines[line_cnt].start`*/
+    lv_point_t size;            /**< Size of the text, the same as `lv_txt_get_size()` gives*/
+} lv_txt_layout_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -83,6 +107,36 @@ typedef uint8_t lv_text_align_t;
 void lv_txt_get_size(lv_point_t * size_res, const char * text, const lv_font_t * font, lv_coord_t letter_space,
                      lv_coord_t line_space, lv_coord_t max_width, lv_text_flag_t flag);
 
+/**
+ * Initialize a text layout
+ * @param layout pointer to a text layout
+ */
+void _lv_txt_layout_init(lv_txt_layout_t * layout);
+
+/**
+ * Get the layout of a text. It's measured again only if the text or any parameter has changed.
+ * The parameters are the same as in `lv_txt_get_size()`.
+ * @param layout pointer to an initialized text layout
+ * @return `layout` or NULL if the layout couldn't be created
+ */
+const lv_txt_layout_t * _lv_txt_layout_get(lv_txt_layout_t * layout, const char * text, const lv_font_t * font,
+                                           lv_coord_t letter_space, lv_coord_t line_space, lv_coord_t max_width,
+                                           lv_text_flag_t flag);
+
+/**
+ * Check if the lines of a layout are valid with the given parameters. The text itself is not checked.
+ * @param layout pointer to a text layout
+ * @return true: the line breaks and widths of `layout` can be used
+ */
+bool _lv_txt_layout_is_valid(const lv_txt_layout_t * layout, const lv_font_t * font, lv_coord_t letter_space,
+                             lv_coord_t max_width, lv_text_flag_t flag);
+
+/**
+ * Free the memory of a text layout
+ * @param layout pointer to a text layout
+ */
+void _lv_txt_layout_free(lv_txt_layout_t * layout);
+
 /**
  * Get the next line of text. Check line length and break chars too.
  * @param txt a '\0' terminated string
@@ -48,6 +48,10 @@ static char * lv_label_get_dot_tmp(lv_obj_t * label);
 static void lv_label_dot_tmp_free(lv_obj_t * label);
 static void set_ofs_x_anim(void * obj, int32_t v);
 static void set_ofs_y_anim(void * obj, int32_t v);
+static const lv_txt_layout_t * get_layout(lv_obj_t * obj, const lv_font_t * font, lv_coord_t letter_space,
+                                          lv_coord_t line_space, lv_coord_t max_w, lv_text_flag_t flag);
+static void get_txt_size(lv_obj_t * obj, lv_point_t * size, const lv_font_t * font, lv_coord_t letter_space,
+                         lv_coord_t line_space, lv_coord_t max_w, lv_text_flag_t flag);
 
 /**********************
  *  STATIC VARIABLES
@@ -706,6 +710,10 @@ static void lv_label_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     label->hint.y          = 0;
 #endif
 
+#if LV_LABEL_LAYOUT_CACHE
+    _lv_txt_layout_init(&label->layout);
+#endif
+
 #if LV_LABEL_TEXT_SELECTION
     label->sel_start = LV_DRAW_LABEL_NO_TXT_SEL;
     label->sel_end   = LV_DRAW_LABEL_NO_TXT_SEL;
@@ -729,6 +737,10 @@ static void lv_label_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_label_dot_tmp_free(obj);
     if(!label->static_txt) lv_mem_free(label->text);
     label->text = NULL;
+
+#if LV_LABEL_LAYOUT_CACHE
+    _lv_txt_layout_free(&label->layout);
+#endif
 }
 
 static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
@@ -773,10 +785,14 @@ static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
         if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
 
         lv_coord_t w = lv_obj_get_content_width(obj);
-        if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) w = LV_COORD_MAX;
+        if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) {
+            /*Measure the lines in the same way as they are drawn*/
+            w = LV_COORD_MAX;
+            flag |= LV_TEXT_FLAG_FIT;
+        }
         else w = lv_obj_get_content_width(obj);
 
-        lv_txt_get_size(&size, label->text, font, letter_space, line_space, w, flag);
+        get_txt_size(obj, &size, font, letter_space, line_space, w, flag);
 
         lv_point_t * self_size = lv_event_get_param(e);
         self_size->x = LV_MAX(self_size->x, size.x);
@@ -810,6 +826,8 @@ static void draw_main(lv_event_t * e)
 
     label_draw_dsc.flag = flag;
     lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &label_draw_dsc);
+    label_draw_dsc.layout = get_layout(obj, label_draw_dsc.font, label_draw_dsc.letter_space,
+                                       label_draw_dsc.line_space, lv_area_get_width(&txt_coords), flag);
     lv_bidi_calculate_align(&label_draw_dsc.align, &label_draw_dsc.bidi_dir, label->text);
 
     label_draw_dsc.sel_start = lv_label_get_text_selection_start(obj);
@@ -824,8 +842,8 @@ static void draw_main(lv_event_t * e)
     if((label->long_mode == LV_LABEL_LONG_SCROLL || label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR) &&
        (label_draw_dsc.align == LV_TEXT_ALIGN_CENTER || label_draw_dsc.align == LV_TEXT_ALIGN_RIGHT)) {
         lv_point_t size;
-        lv_txt_get_size(&size, label->text, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
-                        LV_COORD_MAX, flag);
+        get_txt_size(obj, &size, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
+                     LV_COORD_MAX, flag);
         if(size.x > lv_area_get_width(&txt_coords)) {
             label_draw_dsc.align = LV_TEXT_ALIGN_LEFT;
         }
@@ -864,8 +882,8 @@ static void draw_main(lv_event_t * e)
 
     if(label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR) {
         lv_point_t size;
-        lv_txt_get_size(&size, label->text, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
-                        LV_COORD_MAX, flag);
+        get_txt_size(obj, &size, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
+                     LV_COORD_MAX, flag);
 
         /*Draw the text again on label to the original to make a circular effect */
         if(size.x > lv_area_get_width(&txt_coords)) {
@@ -914,7 +932,7 @@ static void lv_label_refr_text(lv_obj_t * obj)
     if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
     if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) flag |= LV_TEXT_FLAG_FIT;
 
-    lv_txt_get_size(&size, label->text, font, letter_space, line_space, max_w, flag);
+    get_txt_size(obj, &size, font, letter_space, line_space, max_w, flag);
 
     lv_obj_refresh_self_size(obj);
 
@@ -1270,5 +1288,42 @@ static void set_ofs_y_anim(void * obj, int32_t v)
     lv_obj_invalidate(obj);
 }
 
+/**
+ * Get the layout of the label's text. The text is measured again only if it or the parameters have changed.
+ * @return the layout or NULL if it's not available
+ */
+static const lv_txt_layout_t * get_layout(lv_obj_t * obj, const lv_font_t * font, lv_coord_t letter_space,
+                                          lv_coord_t line_space, lv_coord_t max_w, lv_text_flag_t flag)
+{
+#if LV_LABEL_LAYOUT_CACHE
+    lv_label_t * label = (lv_label_t *)obj;
+    return _lv_txt_layout_get(&label->layout, label->text, font, letter_space, line_space, max_w, flag);
+#else
+    LV_UNUSED(obj);
+    LV_UNUSED(font);
+    LV_UNUSED(letter_space);
+    LV_UNUSED(line_space);
+    LV_UNUSED(max_w);
+    LV_UNUSED(flag);
+    return NULL;
+#endif
+}
+
+/**
+ * Get the size of the label's text like `lv_txt_get_size()`, but from the layout if possible
+ */
+static void get_txt_size(lv_obj_t * obj, lv_point_t * size, const lv_font_t * font, lv_coord_t letter_space,
+                         lv_coord_t line_space, lv_coord_t max_w, lv_text_flag_t flag)
+{
+    const lv_txt_layout_t * layout = get_layout(obj, font, letter_space, line_space, max_w, flag);
+    if(layout) {
+        *size = layout->size;
+        return;
+    }
+
+    lv_label_t * label = (lv_label_t *)obj;
+    lv_txt_get_size(size, label->text, font, letter_space, line_space, max_w, flag);
+}
+
 
 #endif
@@ -218,7 +218,8 @@ void lv_table_set_row_cnt(lv_obj_t * obj, uint16_t row_cnt)
         lv_memset_00(&table->cell_data[old_cell_cnt], (new_cell_cnt - old_cell_cnt) * sizeof(table->cell_data[0]));
     }
 
-    refr_size_form_row(obj, 0);
+    /*The height of the kept rows doesn't change*/
+    refr_size_form_row(obj, LV_MIN(old_row_cnt, row_cnt));
 }
 
 void lv_table_set_col_cnt(lv_obj_t * obj, uint16_t col_cnt)
@@ -630,6 +631,12 @@ static void draw_main(lv_event_t * e)
 
         if(cell_area.y1 > clip_area.y2) break;
 
+        /*Skip the rows above the clip area*/
+        if(cell_area.y2 < clip_area.y1) {
+            cell += table->col_cnt;
+            continue;
+        }
+
         if(rtl) cell_area.x1 = obj->coords.x2 - bg_right - 1 - scroll_x - border_width;
         else cell_area.x2 = obj->coords.x1 + bg_left - 1 - scroll_x + border_width;
 
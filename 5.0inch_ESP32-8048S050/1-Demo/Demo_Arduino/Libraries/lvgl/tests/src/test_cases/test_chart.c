@@ -0,0 +1,276 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <sys/time.h>
+
+#define SCR_W   800
+#define CHART_W 400
+#define CHART_H 200
+
+/*Frame buffer of the test display, the whole screen is in it after a full refresh*/
+extern lv_color_t test_fb[];
+
+static lv_obj_t * chart;
+static lv_chart_series_t * ser1;
+static lv_chart_series_t * ser2;
+static lv_color_t ref_fb[CHART_W * CHART_H];
+static uint32_t rnd_seed;
+
+void setUp(void)
+{
+    rnd_seed = 1;
+    chart = lv_chart_create(lv_scr_act());
+    lv_obj_set_size(chart, CHART_W, CHART_H);
+    lv_obj_set_pos(chart, 50, 50);
+    lv_obj_set_style_line_width(chart, 3, LV_PART_ITEMS);
+    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, 1000);
+    ser1 = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_RED), LV_CHART_AXIS_PRIMARY_Y);
+    ser2 = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_BLUE), LV_CHART_AXIS_PRIMARY_Y);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+static lv_coord_t rnd(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return (rnd_seed >> 16) % 1000;
+}
+
+static void add_values(uint32_t cnt)
+{
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        lv_chart_set_next_value(chart, ser1, rnd());
+        lv_chart_set_next_value(chart, ser2, rnd() / 2 + 250);
+    }
+}
+
+/*Refresh the whole screen to have it in `test_fb`*/
+static void refr_screen(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+static void save_chart(void)
+{
+    uint32_t y;
+    for(y = 0; y < CHART_H; y++) {
+        lv_memcpy(&ref_fb[y * CHART_W], &test_fb[(y + 50) * SCR_W + 50], CHART_W * sizeof(lv_color_t));
+    }
+}
+
+/*Compare the chart on the screen to the saved one, allowing `tolerance` difference in the color channels*/
+static void assert_chart(uint32_t tolerance)
+{
+    uint32_t y;
+    uint32_t x;
+    for(y = 0; y < CHART_H; y++) {
+        for(x = 0; x < CHART_W; x++) {
+            lv_color32_t exp;
+            lv_color32_t act;
+            exp.full = lv_color_to32(ref_fb[y * CHART_W + x]);
+            act.full = lv_color_to32(test_fb[(y + 50) * SCR_W + 50 + x]);
+            if(tolerance == 0 && exp.full == act.full) continue;
+            if(LV_ABS(exp.ch.red - act.ch.red) <= tolerance && LV_ABS(exp.ch.green - act.ch.green) <= tolerance &&
+               LV_ABS(exp.ch.blue - act.ch.blue) <= tolerance) continue;
+
+            char msg[64];
+            lv_snprintf(msg, sizeof(msg), "at x=%d y=%d", x, y);
+            TEST_ASSERT_EQUAL_HEX32_MESSAGE(exp.full, act.full, msg);
+        }
+    }
+}
+
+/*The least points with which the cache is used: 10 points per pixel*/
+static uint32_t cache_point_cnt(void)
+{
+    lv_obj_update_layout(chart);
+    return lv_obj_get_content_width(chart) * 10;
+}
+
+/*Add values in steps, refreshing after each, and compare the shifted cache to a fully rendered one*/
+static void test_shift(uint32_t point_cnt, const uint32_t steps[], uint32_t step_cnt)
+{
+    lv_chart_set_point_count(chart, point_cnt);
+    lv_chart_set_cache(chart, true);
+    add_values(point_cnt);
+    refr_screen();
+    TEST_ASSERT_NOT_NULL(((lv_chart_t *)chart)->cache);
+
+    uint32_t i;
+    for(i = 0; i < step_cnt; i++) {
+        add_values(steps[i]);
+        lv_refr_now(NULL);
+    }
+
+    refr_screen();
+    save_chart();
+
+    lv_chart_refresh(chart);
+    refr_screen();
+    assert_chart(0);
+}
+
+void test_chart_cache_shift(void)
+{
+    static const uint32_t steps[] = {1, 1, 2, 1, 5, 1, 3, 1, 1, 8, 1};
+    test_shift(cache_point_cnt(), steps, sizeof(steps) / sizeof(steps[0]));
+}
+
+void test_chart_cache_shift_many(void)
+{
+    /*More new values than points per pixel between the refreshes too*/
+    static const uint32_t steps[] = {1, 1, 1, 3, 10, 1, 50, 1, 200, 1, 1};
+    test_shift(cache_point_cnt() * 2, steps, sizeof(steps) / sizeof(steps[0]));
+}
+
+void test_chart_cache_few_points(void)
+{
+    /*With fewer points drawing directly is faster, the cache is not used*/
+    lv_obj_set_style_size(chart, 6, LV_PART_INDICATOR);
+    lv_chart_set_point_count(chart, 40);
+    add_values(40);
+    refr_screen();
+    save_chart();
+
+    lv_chart_set_cache(chart, true);
+    add_values(1);
+    lv_refr_now(NULL);
+    add_values(2);
+    refr_screen();
+    TEST_ASSERT_NULL(((lv_chart_t *)chart)->cache);
+
+    lv_chart_set_cache(chart, false);
+    lv_chart_set_cache(chart, true);
+    refr_screen();
+    TEST_ASSERT_TRUE(lv_chart_get_cache(chart));
+    TEST_ASSERT_NULL(((lv_chart_t *)chart)->cache);
+
+    /*Drawn the same way as without the cache*/
+    lv_chart_set_cache(chart, false);
+    refr_screen();
+    save_chart();
+    lv_chart_set_cache(chart, true);
+    refr_screen();
+    assert_chart(0);
+
+    /*The buffer is allocated once there are enough points, and freed when there aren't*/
+    lv_chart_set_point_count(chart, cache_point_cnt());
+    refr_screen();
+    TEST_ASSERT_NOT_NULL(((lv_chart_t *)chart)->cache);
+    lv_chart_set_point_count(chart, cache_point_cnt() - 1);
+    refr_screen();
+    TEST_ASSERT_NULL(((lv_chart_t *)chart)->cache);
+}
+
+void test_chart_cache_not_in_step(void)
+{
+    lv_chart_set_point_count(chart, cache_point_cnt());
+    lv_chart_set_cache(chart, true);
+    add_values(cache_point_cnt());
+    refr_screen();
+
+    /*Only one series is shifted so the cache needs to be rendered again*/
+    lv_chart_set_next_value(chart, ser1, 500);
+    lv_refr_now(NULL);
+    lv_chart_set_next_value(chart, ser2, 500);
+    lv_chart_set_value_by_id(chart, ser2, 10, 0);
+    refr_screen();
+    save_chart();
+
+    lv_chart_refresh(chart);
+    refr_screen();
+    assert_chart(0);
+
+    /*A series added later is shifted in step with the others*/
+    lv_chart_series_t * ser3 = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_GREEN), LV_CHART_AXIS_PRIMARY_Y);
+    TEST_ASSERT_EQUAL_UINT32(ser1->shift_cnt, ser3->shift_cnt);
+    add_values(1);
+    lv_chart_set_next_value(chart, ser3, 100);
+    refr_screen();
+    save_chart();
+
+    lv_chart_refresh(chart);
+    refr_screen();
+    assert_chart(0);
+}
+
+void test_chart_cache_same_as_direct(void)
+{
+    uint32_t point_cnt = cache_point_cnt();
+    lv_chart_set_point_count(chart, point_cnt);
+    uint32_t i;
+    for(i = 0; i < point_cnt; i++) {
+        lv_chart_set_value_by_id(chart, ser1, i, rnd());
+        lv_chart_set_value_by_id(chart, ser2, i, rnd());
+    }
+    refr_screen();
+    save_chart();
+
+    /*The series are blended to the cache first, so a small difference is possible at the edges*/
+    lv_chart_set_cache(chart, true);
+    TEST_ASSERT_TRUE(lv_chart_get_cache(chart));
+    refr_screen();
+    assert_chart(4);
+    TEST_ASSERT_NOT_NULL(((lv_chart_t *)chart)->cache);
+
+    /*Not used with zoom*/
+    lv_chart_set_zoom_x(chart, 512);
+    refr_screen();
+    TEST_ASSERT_NULL(((lv_chart_t *)chart)->cache);
+    lv_chart_set_zoom_x(chart, LV_IMG_ZOOM_NONE);
+    refr_screen();
+    assert_chart(4);
+
+    lv_chart_set_cache(chart, false);
+    TEST_ASSERT_NULL(((lv_chart_t *)chart)->cache);
+    refr_screen();
+    assert_chart(0);
+}
+
+/*The test ticks are incremented manually, so measure the real time*/
+static uint32_t time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000000 + tv.tv_usec);
+}
+
+void test_chart_benchmark(void)
+{
+    static const uint32_t point_cnts[] = {1000, 10000, 65000};
+    lv_obj_set_size(chart, 760, 300);
+    lv_obj_set_pos(chart, 20, 20);
+
+    uint32_t i;
+    for(i = 0; i < sizeof(point_cnts) / sizeof(point_cnts[0]); i++) {
+        uint32_t c;
+        for(c = 0; c < 2; c++) {
+            bool cache = c == 1;
+            lv_chart_set_cache(chart, cache);
+            lv_chart_set_point_count(chart, point_cnts[i]);
+            add_values(point_cnts[i]);
+            refr_screen();
+
+            /*A new value in each series and a redraw, like a live chart*/
+            uint32_t upd_cnt = 100;
+            uint32_t u;
+            uint32_t t = time_us();
+            for(u = 0; u < upd_cnt; u++) {
+                add_values(1);
+                lv_refr_now(NULL);
+            }
+            t = time_us() - t;
+            printf("chart: %5"LV_PRIu32" points, %-8s %7"LV_PRIu32" us/update\n", point_cnts[i],
+                   cache ? "cache" : "direct", t / upd_cnt);
+        }
+    }
+}
+
+#endif
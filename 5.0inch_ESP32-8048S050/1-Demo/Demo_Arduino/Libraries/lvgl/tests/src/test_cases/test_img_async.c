@@ -0,0 +1,295 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#define PHOTO_CNT       6
+#define PHOTO_SIZE      64
+#define DECODE_TIME     40  /*Time to decode a photo [ms]*/
+
+#define PHOTO_COLOR     0x3060a0
+
+/*Frame buffer of the test display, the whole screen is in it after a full refresh*/
+extern lv_color_t test_fb[];
+
+/*"Compressed" photos which can be opened only by `photo_decoder`.
+ *The first data byte tells how to open them*/
+enum {
+    PHOTO_AT_ONCE,
+    PHOTO_LINES,
+    PHOTO_FAIL,
+};
+static const uint8_t photo_kinds[] = {PHOTO_AT_ONCE, PHOTO_LINES, PHOTO_FAIL};
+static lv_img_dsc_t photos[PHOTO_CNT];
+static lv_img_decoder_t * photo_decoder;
+static volatile uint32_t open_cnt;
+static volatile uint32_t rows_allowed;
+
+static lv_res_t photo_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(decoder);
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+    const lv_img_dsc_t * dsc = src;
+    if(dsc->header.cf != LV_IMG_CF_RAW) return LV_RES_INV;
+
+    header->w = dsc->header.w;
+    header->h = dsc->header.h;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    return LV_RES_OK;
+}
+
+static lv_res_t photo_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    const lv_img_dsc_t * img = dsc->src;
+    if(dsc->src_type != LV_IMG_SRC_VARIABLE || img->header.cf != LV_IMG_CF_RAW) return LV_RES_INV;
+
+    open_cnt++;
+    if(img->data[0] == PHOTO_FAIL) return LV_RES_INV;
+    if(img->data[0] == PHOTO_LINES) return LV_RES_OK;
+
+    usleep(DECODE_TIME * 1000);
+    lv_color_t * px = lv_mem_alloc(PHOTO_SIZE * PHOTO_SIZE * sizeof(lv_color_t));
+    uint32_t i;
+    for(i = 0; i < PHOTO_SIZE * PHOTO_SIZE; i++) px[i] = lv_color_hex(PHOTO_COLOR);
+    dsc->img_data = (const uint8_t *)px;
+    return LV_RES_OK;
+}
+
+static lv_res_t photo_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
+                                lv_coord_t len, uint8_t * buf)
+{
+    LV_UNUSED(decoder);
+    LV_UNUSED(dsc);
+    LV_UNUSED(x);
+
+    /*Wait until the test lets this row be decoded*/
+    while((uint32_t)y >= rows_allowed) usleep(1000);
+
+    lv_color_t * px = (lv_color_t *)buf;
+    lv_coord_t i;
+    for(i = 0; i < len; i++) px[i] = lv_color_hex(PHOTO_COLOR);
+    return LV_RES_OK;
+}
+
+static void photo_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    lv_mem_free((void *)dsc->img_data);
+    dsc->img_data = NULL;
+}
+
+void setUp(void)
+{
+    uint32_t i;
+    for(i = 0; i < PHOTO_CNT; i++) {
+        photos[i].header.cf = LV_IMG_CF_RAW;
+        photos[i].header.w = PHOTO_SIZE;
+        photos[i].header.h = PHOTO_SIZE;
+        photos[i].data = &photo_kinds[PHOTO_AT_ONCE];
+        photos[i].data_size = 1;
+    }
+
+    photo_decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(photo_decoder, photo_info);
+    lv_img_decoder_set_open_cb(photo_decoder, photo_open);
+    lv_img_decoder_set_read_line_cb(photo_decoder, photo_read_line);
+    lv_img_decoder_set_close_cb(photo_decoder, photo_close);
+
+    open_cnt = 0;
+    rows_allowed = PHOTO_SIZE;
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(NULL);
+#if LV_USE_IMG_ASYNC
+    lv_img_async_enable(true);
+#endif
+    lv_img_decoder_delete(photo_decoder);
+}
+
+#if LV_USE_IMG_ASYNC
+static void wait_for_worker(void)
+{
+    uint32_t i;
+    for(i = 0; lv_img_async_is_busy(); i++) {
+        TEST_ASSERT_LESS_THAN_UINT32(5000, i);
+        usleep(1000);
+    }
+}
+
+/*The test ticks are incremented manually, so measure the real time*/
+static uint32_t time_ms(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
+static uint32_t refr_time(void)
+{
+    uint32_t t = time_ms();
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    return time_ms() - t;
+}
+
+static uint32_t get_px(lv_coord_t x, lv_coord_t y)
+{
+    return lv_color_to32(test_fb[y * LV_HOR_RES + x]) & 0xffffff;
+}
+
+static void create_photos(void)
+{
+    uint32_t i;
+    for(i = 0; i < PHOTO_CNT; i++) {
+        lv_obj_t * img = lv_img_create(lv_scr_act());
+        lv_img_set_src(img, &photos[i]);
+        lv_obj_set_pos(img, 10 + i * (PHOTO_SIZE + 10), 10);
+    }
+}
+#endif
+
+void test_img_async_no_stall(void)
+{
+#if LV_USE_IMG_ASYNC
+    /*Decoding everything while rendering blocks the UI*/
+    lv_img_async_enable(false);
+    create_photos();
+    uint32_t t_sync = refr_time();
+    TEST_ASSERT_EQUAL_UINT32(PHOTO_CNT, open_cnt);
+
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_async_enable(true);
+    lv_img_async_reset_stat();
+    open_cnt = 0;
+
+    /*Placeholders are drawn right away*/
+    create_photos();
+    uint32_t t_async = refr_time();
+    TEST_ASSERT_EQUAL_HEX32(0xc0c0c0, get_px(10 + PHOTO_SIZE / 2, 10 + PHOTO_SIZE / 2));
+
+    wait_for_worker();
+    uint32_t t_ready = refr_time();
+    TEST_ASSERT_EQUAL_HEX32(PHOTO_COLOR, get_px(10 + PHOTO_SIZE / 2, 10 + PHOTO_SIZE / 2));
+
+    lv_img_async_stat_t stat;
+    lv_img_async_get_stat(&stat);
+    printf("img async: %d photos, %"LV_PRIu32" ms frame decoding in the UI thread, %"LV_PRIu32" ms frame with "
+           "placeholders, %"LV_PRIu32" ms frame when ready\n", PHOTO_CNT, t_sync, t_async, t_ready);
+
+    TEST_ASSERT_EQUAL_UINT32(PHOTO_CNT, stat.req_cnt);
+    TEST_ASSERT_EQUAL_UINT32(PHOTO_CNT, stat.done_cnt);
+    TEST_ASSERT_EQUAL_UINT32(PHOTO_CNT, open_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(PHOTO_CNT * DECODE_TIME, t_sync);
+    TEST_ASSERT_LESS_THAN_UINT32(t_sync / 2, t_async);
+
+    /*Everything is in the cache now*/
+    refr_time();
+    TEST_ASSERT_EQUAL_UINT32(PHOTO_CNT, open_cnt);
+    lv_img_cache_stat_t cache_stat;
+    lv_img_cache_get_stat(&cache_stat);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(PHOTO_CNT, cache_stat.entry_cnt);
+#endif
+}
+
+void test_img_async_progressive(void)
+{
+#if LV_USE_IMG_ASYNC
+    photos[0].data = &photo_kinds[PHOTO_LINES];
+    rows_allowed = 0;
+
+    lv_obj_t * img = lv_img_create(lv_scr_act());
+    lv_img_set_src(img, &photos[0]);
+    lv_obj_set_pos(img, 100, 100);
+
+    refr_time();
+    TEST_ASSERT_EQUAL_HEX32(0xc0c0c0, get_px(100, 100));
+    TEST_ASSERT_TRUE(lv_img_async_is_busy());
+
+    /*Let the first 2 bands be decoded*/
+    rows_allowed = 2 * LV_IMG_ASYNC_BAND_ROWS;
+    _lv_img_async_progress_t progress;
+    uint32_t i = 0;
+    do {
+        TEST_ASSERT_LESS_THAN_UINT32(5000, i++);
+        usleep(1000);
+        TEST_ASSERT_TRUE(_lv_img_async_get_progress(&photos[0], lv_color_black(), 0, &img->coords, &progress));
+    } while(progress.rows_ready < 2 * LV_IMG_ASYNC_BAND_ROWS);
+
+    refr_time();
+    TEST_ASSERT_EQUAL_HEX32(PHOTO_COLOR, get_px(100, 100));
+    TEST_ASSERT_EQUAL_HEX32(PHOTO_COLOR, get_px(100, 100 + 2 * LV_IMG_ASYNC_BAND_ROWS - 1));
+    TEST_ASSERT_EQUAL_HEX32(0xc0c0c0, get_px(100, 100 + 2 * LV_IMG_ASYNC_BAND_ROWS));
+
+    rows_allowed = PHOTO_SIZE;
+    wait_for_worker();
+
+    /*The timer invalidates the image when it's ready and it's drawn in the next refresh*/
+    lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+    lv_timer_handler();
+    lv_refr_now(NULL);
+    lv_img_cache_stat_t cache_stat;
+    lv_img_cache_get_stat(&cache_stat);
+    TEST_ASSERT_EQUAL_UINT32(1, cache_stat.entry_cnt);
+
+    refr_time();
+    TEST_ASSERT_EQUAL_HEX32(PHOTO_COLOR, get_px(100, 100 + PHOTO_SIZE - 1));
+#endif
+}
+
+void test_img_async_fail_and_invalidate(void)
+{
+#if LV_USE_IMG_ASYNC
+    photos[0].data = &photo_kinds[PHOTO_FAIL];
+    lv_img_async_reset_stat();
+
+    lv_obj_t * img = lv_img_create(lv_scr_act());
+    lv_img_set_src(img, &photos[0]);
+    refr_time();
+    wait_for_worker();
+
+    /*Not tried again in every frame*/
+    refr_time();
+    refr_time();
+    lv_img_async_stat_t stat;
+    lv_img_async_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(1, stat.req_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, stat.fail_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, open_cnt);
+
+    /*Until the source is updated*/
+    photos[0].data = &photo_kinds[PHOTO_AT_ONCE];
+    lv_img_cache_invalidate_src(&photos[0]);
+    refr_time();
+    wait_for_worker();
+    refr_time();
+    TEST_ASSERT_EQUAL_HEX32(PHOTO_COLOR, get_px(PHOTO_SIZE / 2, PHOTO_SIZE / 2));
+
+    /*Invalidated while decoding: the result is dropped*/
+    photos[1].data = &photo_kinds[PHOTO_LINES];
+    rows_allowed = 0;
+    lv_img_set_src(img, &photos[1]);
+    refr_time();
+    lv_img_cache_invalidate_src(&photos[1]);
+    rows_allowed = PHOTO_SIZE;
+    wait_for_worker();
+    lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+    lv_timer_handler();
+
+    /*So it's requested again, in the handler if the display was refreshed after the result was dropped*/
+    refr_time();
+    lv_img_async_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(4, stat.req_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, stat.fail_cnt);
+    wait_for_worker();
+#endif
+}
+
+#endif
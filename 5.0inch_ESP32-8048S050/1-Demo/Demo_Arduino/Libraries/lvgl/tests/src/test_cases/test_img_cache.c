@@ -0,0 +1,311 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+
+#define COVER_CNT       30
+#define COVER_SIZE      48
+#define COVER_BYTES     (COVER_SIZE * COVER_SIZE * LV_COLOR_SIZE / 8)
+#define DECODE_TIME     20  /*Pretended time to decode a cover [ms]*/
+
+/*"Compressed" album covers which can be opened only by `cover_decoder`*/
+static lv_img_dsc_t covers[COVER_CNT];
+static lv_img_decoder_t * cover_decoder;
+static uint32_t decode_cnt;
+
+static lv_res_t cover_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    LV_UNUSED(decoder);
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+    const lv_img_dsc_t * dsc = src;
+    if(dsc->header.cf != LV_IMG_CF_RAW) return LV_RES_INV;
+
+    header->w = dsc->header.w;
+    header->h = dsc->header.h;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    return LV_RES_OK;
+}
+
+static lv_res_t cover_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    const lv_img_dsc_t * img = dsc->src;
+    if(dsc->src_type != LV_IMG_SRC_VARIABLE || img->header.cf != LV_IMG_CF_RAW) return LV_RES_INV;
+
+    lv_color_t * px = lv_mem_alloc(COVER_BYTES);
+    TEST_ASSERT_NOT_NULL(px);
+    uint32_t i;
+    for(i = 0; i < COVER_SIZE * COVER_SIZE; i++) px[i] = lv_color_hex(img->data[0] * 0x080808);
+
+    dsc->img_data = (const uint8_t *)px;
+    dsc->time_to_open = DECODE_TIME;
+    decode_cnt++;
+    return LV_RES_OK;
+}
+
+static void cover_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+    lv_mem_free((void *)dsc->img_data);
+    dsc->img_data = NULL;
+}
+
+static const uint8_t cover_seeds[COVER_CNT] = {
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30
+};
+
+void setUp(void)
+{
+    uint32_t i;
+    for(i = 0; i < COVER_CNT; i++) {
+        covers[i].header.cf = LV_IMG_CF_RAW;
+        covers[i].header.w = COVER_SIZE;
+        covers[i].header.h = COVER_SIZE;
+        covers[i].data = &cover_seeds[i];
+        covers[i].data_size = 1;
+    }
+
+    cover_decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(cover_decoder, cover_info);
+    lv_img_decoder_set_open_cb(cover_decoder, cover_open);
+    lv_img_decoder_set_close_cb(cover_decoder, cover_close);
+
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_size(16);
+#endif
+    lv_img_cache_set_max_bytes(0);
+    lv_img_cache_reset_stat();
+    decode_cnt = 0;
+
+#if LV_USE_IMG_ASYNC
+    /*Measure the cache alone*/
+    lv_img_async_enable(false);
+#endif
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_set_max_bytes(LV_IMG_CACHE_DEF_BYTES);
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+#endif
+    lv_img_decoder_delete(cover_decoder);
+#if LV_USE_IMG_ASYNC
+    lv_img_async_enable(true);
+#endif
+}
+
+void test_img_cache_lru(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_size(4);
+
+    uint32_t i;
+    for(i = 0; i < 4; i++) TEST_ASSERT_NOT_NULL(_lv_img_cache_open(&covers[i], lv_color_black(), 0));
+    TEST_ASSERT_EQUAL_UINT32(4, decode_cnt);
+
+    /*Use the first one to make the second one the least recently used*/
+    _lv_img_cache_entry_t * e0 = _lv_img_cache_open(&covers[0], lv_color_black(), 0);
+    TEST_ASSERT_EQUAL_PTR(&covers[0], e0->dec_dsc.src);
+    TEST_ASSERT_EQUAL_UINT32(4, decode_cnt);
+
+    /*No free entry, the second one is closed*/
+    _lv_img_cache_open(&covers[4], lv_color_black(), 0);
+    TEST_ASSERT_EQUAL_UINT32(5, decode_cnt);
+
+    _lv_img_cache_open(&covers[0], lv_color_black(), 0);
+    _lv_img_cache_open(&covers[2], lv_color_black(), 0);
+    _lv_img_cache_open(&covers[3], lv_color_black(), 0);
+    TEST_ASSERT_EQUAL_UINT32(5, decode_cnt);
+    _lv_img_cache_open(&covers[1], lv_color_black(), 0);
+    TEST_ASSERT_EQUAL_UINT32(6, decode_cnt);
+
+    lv_img_cache_stat_t stat;
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(6, stat.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(4, stat.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2, stat.evict_cnt);
+    TEST_ASSERT_EQUAL_UINT32(4, stat.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(4 * COVER_BYTES, stat.size);
+    TEST_ASSERT_EQUAL_UINT32(6 * DECODE_TIME, stat.decode_time);
+
+    /*Invalidated images are decoded again*/
+    lv_img_cache_invalidate_src(&covers[1]);
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(3, stat.entry_cnt);
+    _lv_img_cache_open(&covers[1], lv_color_black(), 0);
+    TEST_ASSERT_EQUAL_UINT32(7, decode_cnt);
+#endif
+}
+
+void test_img_cache_max_bytes(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_max_bytes(3 * COVER_BYTES);
+
+    uint32_t i;
+    for(i = 0; i < 5; i++) TEST_ASSERT_NOT_NULL(_lv_img_cache_open(&covers[i], lv_color_black(), 0));
+
+    lv_img_cache_stat_t stat;
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(3, stat.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(3 * COVER_BYTES, stat.size);
+    TEST_ASSERT_EQUAL_UINT32(2, stat.evict_cnt);
+
+    /*The newest ones are kept*/
+    _lv_img_cache_open(&covers[4], lv_color_black(), 0);
+    _lv_img_cache_open(&covers[2], lv_color_black(), 0);
+    TEST_ASSERT_EQUAL_UINT32(5, decode_cnt);
+
+    /*Shrinking the limit closes images right away*/
+    lv_img_cache_set_max_bytes(COVER_BYTES);
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(1, stat.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(COVER_BYTES, stat.size);
+#endif
+}
+
+void test_img_cache_pin(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_max_bytes(2 * COVER_BYTES);
+
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_cache_pin_src(&covers[0], lv_color_black()));
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_cache_pin_src(&covers[1], lv_color_black()));
+
+    /*Over the limit, but the pinned ones stay*/
+    uint32_t i;
+    for(i = 2; i < 10; i++) _lv_img_cache_open(&covers[i], lv_color_black(), 0);
+    _lv_img_cache_open(&covers[0], lv_color_black(), 0);
+    _lv_img_cache_open(&covers[1], lv_color_black(), 0);
+    TEST_ASSERT_EQUAL_UINT32(10, decode_cnt);
+
+    lv_img_cache_stat_t stat;
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(3, stat.entry_cnt);
+
+    /*Unpinned they are closed as soon as they don't fit*/
+    lv_img_cache_unpin_src(&covers[0], lv_color_black());
+    lv_img_cache_unpin_src(&covers[1], lv_color_black());
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2 * COVER_BYTES, stat.size);
+#endif
+}
+
+void test_img_cache_all_pinned(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_size(2);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_cache_pin_src(&covers[0], lv_color_black()));
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_cache_pin_src(&covers[1], lv_color_black()));
+    _lv_img_cache_entry_t * pinned0 = _lv_img_cache_open(&covers[0], lv_color_black(), 0);
+    _lv_img_cache_entry_t * pinned1 = _lv_img_cache_open(&covers[1], lv_color_black(), 0);
+    const uint8_t * data0 = pinned0->dec_dsc.img_data;
+    const uint8_t * data1 = pinned1->dec_dsc.img_data;
+
+    /*No entry can be closed: the image is opened without caching*/
+    _lv_img_cache_entry_t * entry = _lv_img_cache_open(&covers[2], lv_color_black(), 0);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_TRUE(entry != pinned0 && entry != pinned1);
+    TEST_ASSERT_EQUAL_UINT32(lv_color_hex(3 * 0x080808).full, ((const lv_color_t *)entry->dec_dsc.img_data)[0].full);
+    _lv_img_cache_release(entry);
+    TEST_ASSERT_EQUAL_UINT32(3, decode_cnt);
+
+    /*The pinned images are untouched*/
+    TEST_ASSERT_EQUAL_PTR(data0, pinned0->dec_dsc.img_data);
+    TEST_ASSERT_EQUAL_PTR(data1, pinned1->dec_dsc.img_data);
+    TEST_ASSERT_EQUAL_UINT32(lv_color_hex(1 * 0x080808).full, ((const lv_color_t *)data0)[0].full);
+    TEST_ASSERT_EQUAL_UINT32(lv_color_hex(2 * 0x080808).full, ((const lv_color_t *)data1)[0].full);
+    lv_img_cache_stat_t stat;
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(2, stat.entry_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, stat.evict_cnt);
+
+    /*No room for one more pin*/
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_cache_pin_src(&covers[3], lv_color_black()));
+    TEST_ASSERT_EQUAL_UINT32(4, decode_cnt);
+
+    /*Not cached, so decoded again. Once unpinned, entries can be reused again.*/
+    _lv_img_cache_release(_lv_img_cache_open(&covers[2], lv_color_black(), 0));
+    TEST_ASSERT_EQUAL_UINT32(5, decode_cnt);
+    lv_img_cache_unpin_src(&covers[0], lv_color_black());
+    entry = _lv_img_cache_open(&covers[2], lv_color_black(), 0);
+    TEST_ASSERT_EQUAL_PTR(pinned0, entry);
+    _lv_img_cache_release(entry);
+    TEST_ASSERT_EQUAL_PTR(pinned0, _lv_img_cache_open(&covers[2], lv_color_black(), 0));
+    TEST_ASSERT_EQUAL_UINT32(6, decode_cnt);
+
+    lv_img_cache_unpin_src(&covers[1], lv_color_black());
+#endif
+}
+
+#if LV_IMG_CACHE_DEF_SIZE
+/*Scroll through a list of tracks with album covers like the music player, return the number of decodes*/
+static uint32_t scroll_music_list(uint32_t max_bytes)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_set_max_bytes(max_bytes);
+    lv_img_cache_reset_stat();
+    decode_cnt = 0;
+
+    lv_obj_t * list = lv_list_create(lv_scr_act());
+    lv_obj_set_size(list, 400, LV_PCT(100));
+    uint32_t i;
+    for(i = 0; i < COVER_CNT; i++) {
+        char buf[32];
+        lv_snprintf(buf, sizeof(buf), "Track %"LV_PRIu32, i + 1);
+        lv_list_add_btn(list, &covers[i], buf);
+    }
+    lv_refr_now(NULL);
+
+    /*Down and back up twice*/
+    uint32_t round;
+    for(round = 0; round < 2; round++) {
+        int32_t dir;
+        for(dir = -1; dir <= 1; dir += 2) {
+            uint32_t step;
+            for(step = 0; step < 80; step++) {
+                lv_obj_scroll_by(list, 0, dir * 20, LV_ANIM_OFF);
+                lv_refr_now(NULL);
+            }
+        }
+    }
+
+    lv_img_cache_stat_t stat;
+    lv_img_cache_get_stat(&stat);
+    printf("img cache: %"LV_PRIu32" bytes limit, %"LV_PRIu32" hits, %"LV_PRIu32" misses, %"LV_PRIu32" evictions, "
+           "%"LV_PRIu32" ms decoding\n", max_bytes, stat.hit_cnt, stat.miss_cnt, stat.evict_cnt, stat.decode_time);
+
+    TEST_ASSERT_EQUAL_UINT32(decode_cnt, stat.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(decode_cnt * DECODE_TIME, stat.decode_time);
+    if(max_bytes) TEST_ASSERT_LESS_OR_EQUAL_UINT32(max_bytes, stat.size);
+    return decode_cnt;
+}
+#endif
+
+void test_img_cache_scroll_music_list(void)
+{
+#if LV_IMG_CACHE_DEF_SIZE
+    lv_img_cache_set_size(32);
+
+    /*Only one cover fits, so practically no caching*/
+    uint32_t decode_min = scroll_music_list(COVER_BYTES);
+
+    /*All the visible covers fit*/
+    uint32_t decode_visible = scroll_music_list(12 * COVER_BYTES);
+
+    /*Everything fits, every cover which was shown is decoded only once*/
+    uint32_t decode_all = scroll_music_list(0);
+
+    lv_img_cache_stat_t stat;
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(stat.entry_cnt, decode_all);
+    TEST_ASSERT_LESS_THAN_UINT32(decode_min / 4, decode_visible);
+#endif
+}
+
+#endif
@@ -0,0 +1,292 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+/*Made by `scripts/imgpack.py --depth 32` and `--depth 16` from the PNGs next to it:
+ * - imgpack_bg: 96x64 opaque, the left half is (255, y * 4, 0), the right half is (0, y * 4, 255)
+ * - imgpack_icon: 64x64 transparent with a blue disc (r < 24) and a half transparent blue ring (r < 30)*/
+#define PACK_PATH   "A:src/test_files/imgpack_32.bin"
+#define PACK16_PATH "A:src/test_files/imgpack_16.bin"
+#define BG_PNG      "A:src/test_files/imgpack_bg.png"
+#define ICON_PNG    "A:src/test_files/imgpack_icon.png"
+
+/*Frame buffer of the test display, the whole screen is in it after a full refresh*/
+extern lv_color_t test_fb[];
+
+#if LV_USE_IMGPACK
+static uint8_t * pack_data;
+static uint32_t pack_size;
+static lv_imgpack_t pack;
+#endif
+
+#if LV_USE_IMGPACK
+/*Simulate the mapped flash partition with a buffer*/
+static uint8_t * load_pack(const char * path, uint32_t * size)
+{
+    lv_fs_file_t f;
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, path, LV_FS_MODE_RD));
+    lv_fs_seek(&f, 0, LV_FS_SEEK_END);
+    lv_fs_tell(&f, size);
+    lv_fs_seek(&f, 0, LV_FS_SEEK_SET);
+    uint8_t * data = lv_mem_alloc(*size);
+    TEST_ASSERT_NOT_NULL(data);
+    uint32_t rn;
+    lv_fs_read(&f, data, *size, &rn);
+    lv_fs_close(&f);
+    TEST_ASSERT_EQUAL(*size, rn);
+    return data;
+}
+#endif
+
+void setUp(void)
+{
+#if LV_USE_IMGPACK
+    pack_data = load_pack(PACK_PATH, &pack_size);
+#endif
+#if LV_USE_IMG_ASYNC
+    lv_img_async_enable(false);
+#endif
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(NULL);
+#if LV_USE_IMGPACK
+    lv_imgpack_close(&pack);
+    lv_mem_free(pack_data);
+    pack_data = NULL;
+#endif
+#if LV_USE_IMG_ASYNC
+    lv_img_async_enable(true);
+#endif
+}
+
+#if LV_USE_IMGPACK
+static void assert_color(uint32_t exp, lv_color_t c)
+{
+    lv_color32_t act;
+    act.full = lv_color_to32(c);
+    TEST_ASSERT_UINT32_WITHIN(8, (exp >> 16) & 0xff, act.ch.red);
+    TEST_ASSERT_UINT32_WITHIN(8, (exp >> 8) & 0xff, act.ch.green);
+    TEST_ASSERT_UINT32_WITHIN(8, exp & 0xff, act.ch.blue);
+}
+
+static uint32_t read_u32(const uint8_t * p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read_u16(const uint8_t * p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+/*A pixel of a not swapped 16 bit pack*/
+static void assert_color16(uint32_t exp, const uint8_t * px)
+{
+    uint16_t c = read_u16(px);
+    assert_color(exp, lv_color_make((c >> 11) << 3, ((c >> 5) & 0x3f) << 2, (c & 0x1f) << 3));
+}
+
+/*Find an image in a pack the way `lv_imgpack_open()` does, for packs of an other color depth*/
+static const uint8_t * find_entry(const uint8_t * data, const char * name)
+{
+    uint32_t img_cnt = read_u32(data + 8);
+    uint32_t i;
+    for(i = 0; i < img_cnt; i++) {
+        const uint8_t * entry = data + 16 + i * 20;
+        if(strcmp((const char *)data + read_u32(entry), name) == 0) return entry;
+    }
+    return NULL;
+}
+
+/*The test ticks are incremented manually, so measure the real time*/
+static uint32_t time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000000 + tv.tv_usec);
+}
+
+static uint32_t mem_used(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor_t mon_large;
+    lv_mem_monitor(&mon);
+    lv_mem_monitor_large(&mon_large);
+    return mon.max_used + mon_large.max_used;
+}
+
+/*Draw the images on an empty screen and return the time of the first draw*/
+static uint32_t draw(const void * bg_src, const void * icon_src)
+{
+    lv_obj_t * bg = lv_img_create(lv_scr_act());
+    lv_img_set_src(bg, bg_src);
+    lv_obj_set_pos(bg, 100, 0);
+
+    lv_obj_t * icon = lv_img_create(lv_scr_act());
+    lv_img_set_src(icon, icon_src);
+
+    uint32_t t = time_us();
+    lv_refr_now(NULL);
+    return time_us() - t;
+}
+#endif
+
+void test_imgpack_open(void)
+{
+#if LV_USE_IMGPACK
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_imgpack_open(&pack, pack_data, pack_size));
+    TEST_ASSERT_EQUAL(2, pack.img_cnt);
+    TEST_ASSERT_EQUAL_STRING("imgpack_bg", lv_imgpack_get_name(&pack, 0));
+    TEST_ASSERT_EQUAL_STRING("imgpack_icon", lv_imgpack_get_name(&pack, 1));
+    TEST_ASSERT_NULL(lv_imgpack_get_name(&pack, 2));
+
+    const lv_img_dsc_t * bg = lv_imgpack_get(&pack, "imgpack_bg");
+    TEST_ASSERT_NOT_NULL(bg);
+    TEST_ASSERT_EQUAL(96, bg->header.w);
+    TEST_ASSERT_EQUAL(64, bg->header.h);
+    TEST_ASSERT_EQUAL(LV_IMG_CF_TRUE_COLOR, bg->header.cf);
+
+    const lv_img_dsc_t * icon = lv_imgpack_get(&pack, "imgpack_icon");
+    TEST_ASSERT_NOT_NULL(icon);
+    TEST_ASSERT_EQUAL(64, icon->header.w);
+    /*LV_IMG_CF_RGB565A8 would be used with 16 bit colors*/
+    TEST_ASSERT_EQUAL(LV_IMG_CF_TRUE_COLOR_ALPHA, icon->header.cf);
+
+    /*Not copied*/
+    TEST_ASSERT_TRUE(icon->data > pack_data && icon->data + icon->data_size <= pack_data + pack_size);
+    TEST_ASSERT_EQUAL(0, (lv_uintptr_t)icon->data % 4);
+
+    TEST_ASSERT_NULL(lv_imgpack_get(&pack, "imgpack"));
+    TEST_ASSERT_NULL(lv_imgpack_get(&pack, "imgpack_icons"));
+    TEST_ASSERT_NULL(lv_imgpack_get(&pack, ""));
+#endif
+}
+
+void test_imgpack_invalid(void)
+{
+#if LV_USE_IMGPACK
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_imgpack_open(&pack, NULL, 0));
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_imgpack_open(&pack, pack_data, 8));
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_imgpack_open(&pack, pack_data, pack_size - 1));
+    TEST_ASSERT_NULL(pack.dscs);
+
+    pack_data[0] = 'X';
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_imgpack_open(&pack, pack_data, pack_size));
+    pack_data[0] = 'L';
+
+    /*Made for an other color depth*/
+    pack_data[6] = 16;
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_imgpack_open(&pack, pack_data, pack_size));
+    pack_data[6] = 32;
+
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_imgpack_open(&pack, pack_data, pack_size));
+#endif
+}
+
+void test_imgpack_16bit(void)
+{
+#if LV_USE_IMGPACK
+    uint32_t size;
+    uint8_t * data = load_pack(PACK16_PATH, &size);
+    TEST_ASSERT_EQUAL_MEMORY("LVIP", data, 4);
+    TEST_ASSERT_EQUAL(16, data[6]);
+    TEST_ASSERT_EQUAL(0, data[7]);
+    TEST_ASSERT_EQUAL(2, read_u32(data + 8));
+    TEST_ASSERT_EQUAL(size, read_u32(data + 12));
+#if LV_COLOR_DEPTH != 16
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_imgpack_open(&pack, data, size));
+#endif
+
+    /*Opaque: RGB565 colors*/
+    const uint8_t * entry = find_entry(data, "imgpack_bg");
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL(96, read_u16(entry + 12));
+    TEST_ASSERT_EQUAL(64, read_u16(entry + 14));
+    TEST_ASSERT_EQUAL(LV_IMG_CF_TRUE_COLOR, entry[16]);
+    TEST_ASSERT_EQUAL(96 * 64 * 2, read_u32(entry + 8));
+    TEST_ASSERT_EQUAL(0, read_u32(entry + 4) % 4);
+    const uint8_t * px = data + read_u32(entry + 4);
+    assert_color16(0xff0000, px + 10 * 2);
+    assert_color16(0x00fcff, px + (63 * 96 + 90) * 2);
+
+    /*Transparent: RGB565 colors, then the alpha values*/
+    entry = find_entry(data, "imgpack_icon");
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL(64, read_u16(entry + 12));
+    TEST_ASSERT_EQUAL(LV_IMG_CF_RGB565A8, entry[16]);
+    TEST_ASSERT_EQUAL(64 * 64 * 3, read_u32(entry + 8));
+    TEST_ASSERT_EQUAL(0, read_u32(entry + 4) % 4);
+    px = data + read_u32(entry + 4);
+    const uint8_t * alpha = px + 64 * 64 * 2;
+    assert_color16(0x0000ff, px + (32 * 64 + 32) * 2);
+    TEST_ASSERT_EQUAL(0xff, alpha[32 * 64 + 32]);
+    TEST_ASSERT_EQUAL(0, alpha[0]);
+    assert_color16(0x0000ff, px + (32 * 64 + 32 + 27) * 2);
+    TEST_ASSERT_UINT32_WITHIN(2, LV_OPA_50, alpha[32 * 64 + 32 + 27]);
+
+    lv_mem_free(data);
+#endif
+}
+
+void test_imgpack_draw(void)
+{
+#if LV_USE_IMGPACK
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_imgpack_open(&pack, pack_data, pack_size));
+    draw(lv_imgpack_get(&pack, "imgpack_bg"), lv_imgpack_get(&pack, "imgpack_icon"));
+
+    lv_color_t scr_bg = test_fb[LV_HOR_RES - 1];
+    assert_color(0xff0000, test_fb[100 + 10]);
+    assert_color(0x00fcff, test_fb[63 * LV_HOR_RES + 100 + 90]);
+
+    /*Opaque, transparent and half transparent part of the icon*/
+    assert_color(0x0000ff, test_fb[32 * LV_HOR_RES + 32]);
+    TEST_ASSERT_EQUAL_HEX32(lv_color_to32(scr_bg), lv_color_to32(test_fb[0]));
+    lv_color_t ring = test_fb[32 * LV_HOR_RES + 32 + 27];
+    assert_color(lv_color_to32(lv_color_mix(lv_color_hex(0x0000ff), scr_bg, LV_OPA_50)) & 0xffffff, ring);
+#endif
+}
+
+void test_imgpack_benchmark(void)
+{
+#if LV_USE_IMGPACK && LV_USE_PNG
+    uint32_t i;
+    for(i = 0; i < 2; i++) {
+        bool png = i == 1;
+        lv_img_cache_invalidate_src(NULL);
+        lv_mem_reset_max_used();
+        uint32_t used_start = mem_used();
+
+        uint32_t t;
+        if(png) {
+            t = draw(BG_PNG, ICON_PNG);
+        }
+        else {
+            TEST_ASSERT_EQUAL(LV_RES_OK, lv_imgpack_open(&pack, pack_data, pack_size));
+            t = draw(lv_imgpack_get(&pack, "imgpack_bg"), lv_imgpack_get(&pack, "imgpack_icon"));
+        }
+
+        printf("imgpack: %-7s first draw %6"LV_PRIu32" us", png ? "PNG" : "pack", t);
+#if LV_MEM_CUSTOM == 0
+        uint32_t peak = mem_used() - used_start;
+        printf(", peak RAM %7"LV_PRIu32" B\n", peak);
+        /*The PNGs are decoded to RAM, the pack is drawn from where it is*/
+        if(png) TEST_ASSERT_GREATER_OR_EQUAL_UINT32(96 * 64 * 4 + 64 * 64 * 4, peak);
+        else TEST_ASSERT_LESS_THAN_UINT32(8 * 1024, peak);
+#else
+        LV_UNUSED(used_start);
+        printf("\n");
+#endif
+        lv_obj_clean(lv_scr_act());
+        lv_img_cache_invalidate_src(NULL);
+    }
+#endif
+}
+
+#endif
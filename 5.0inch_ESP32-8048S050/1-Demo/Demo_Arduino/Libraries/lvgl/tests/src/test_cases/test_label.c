@@ -0,0 +1,293 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <sys/time.h>
+
+#if LV_LABEL_LAYOUT_CACHE
+
+#define SCR_W   800
+#define SCR_H   480
+
+/*Frame buffer of the test display, the whole screen is in it after a full refresh*/
+extern lv_color_t test_fb[];
+
+static const char * long_txt =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit. "
+#if LV_FONT_SIMSUN_16_CJK
+    "今天天气很好，我在家中放歌曲。你的歌表中有很多好歌，我想看看。"
+#endif
+    "Sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\n"
+    "Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat. "
+#if LV_FONT_SIMSUN_16_CJK
+    "春眠不知多少，夜来雨声。白日依山，明月光是地上。"
+#endif
+    "Duis aute irure dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur.";
+
+/*A font which counts the glyph lookups of a real font*/
+static lv_font_t counting_font;
+static uint32_t glyph_dsc_cnt;
+static lv_color_t ref_fb[SCR_W * SCR_H];
+
+static const lv_font_t * get_font(void)
+{
+#if LV_FONT_SIMSUN_16_CJK
+    return &lv_font_simsun_16_cjk;
+#else
+    return &lv_font_montserrat_14;
+#endif
+}
+
+static bool counting_get_glyph_dsc(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t letter,
+                                   uint32_t letter_next)
+{
+    LV_UNUSED(font);
+    glyph_dsc_cnt++;
+    return lv_font_get_glyph_dsc(get_font(), dsc_out, letter, letter_next);
+}
+
+static const uint8_t * counting_get_glyph_bitmap(const lv_font_t * font, uint32_t letter)
+{
+    LV_UNUSED(font);
+    return lv_font_get_glyph_bitmap(get_font(), letter);
+}
+
+void setUp(void)
+{
+    counting_font = *get_font();
+    counting_font.get_glyph_dsc = counting_get_glyph_dsc;
+    counting_font.get_glyph_bitmap = counting_get_glyph_bitmap;
+    counting_font.fallback = NULL;
+    glyph_dsc_cnt = 0;
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_font_clear_adv_cache(&counting_font);
+}
+
+static lv_obj_t * create_label(lv_label_long_mode_t long_mode)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_style_text_font(label, get_font(), 0);
+    lv_label_set_long_mode(label, long_mode);
+    lv_obj_set_width(label, 300);
+    lv_label_set_text_static(label, long_txt);
+    lv_obj_update_layout(label);
+    return label;
+}
+
+static void refr_screen(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+void test_label_layout_same_as_measured(void)
+{
+    static const lv_text_flag_t flags[] = {LV_TEXT_FLAG_NONE, LV_TEXT_FLAG_EXPAND, LV_TEXT_FLAG_FIT, LV_TEXT_FLAG_RECOLOR};
+    static const lv_coord_t widths[] = {100, 301, LV_COORD_MAX};
+    const lv_font_t * font = get_font();
+    lv_txt_layout_t layout;
+    _lv_txt_layout_init(&layout);
+
+    uint32_t f;
+    uint32_t w;
+    for(f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+        for(w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+            const lv_txt_layout_t * l = _lv_txt_layout_get(&layout, long_txt, font, 2, 3, widths[w], flags[f]);
+            TEST_ASSERT_NOT_NULL(l);
+
+            lv_point_t size;
+            lv_txt_get_size(&size, long_txt, font, 2, 3, widths[w], flags[f]);
+            TEST_ASSERT_EQUAL_INT32(size.x, l->size.x);
+            TEST_ASSERT_EQUAL_INT32(size.y, l->size.y);
+
+            uint32_t start = 0;
+            uint32_t i;
+            for(i = 0; i < l->line_cnt; i++) {
+                TEST_ASSERT_EQUAL_UINT32(start, l->lines[i].start);
+                uint32_t end = start + _lv_txt_get_next_line(&long_txt[start], font, 2, widths[w], NULL, flags[f]);
+                TEST_ASSERT_EQUAL_INT32(lv_txt_get_width(&long_txt[start], end - start, font, 2, flags[f]), l->lines[i].width);
+                start = end;
+            }
+            TEST_ASSERT_EQUAL_UINT32(strlen(long_txt), start);
+            TEST_ASSERT_EQUAL_UINT32(start, l->lines[l->line_cnt].start);
+        }
+    }
+
+    _lv_txt_layout_free(&layout);
+    TEST_ASSERT_NULL(layout.lines);
+}
+
+void test_label_layout_is_kept_for_same_text(void)
+{
+    lv_obj_t * label = create_label(LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_text_font(label, &counting_font, 0);
+    lv_obj_update_layout(label);
+
+    /*Set the same text in a new buffer: nothing is measured*/
+    lv_font_clear_adv_cache(&counting_font);
+    glyph_dsc_cnt = 0;
+    lv_label_set_text(label, long_txt);
+    lv_obj_update_layout(label);
+    TEST_ASSERT_EQUAL_UINT32(0, glyph_dsc_cnt);
+
+    /*Different text with the same length is measured again*/
+    lv_obj_set_width(label, LV_SIZE_CONTENT);
+    lv_label_set_text(label, "abcd");
+    lv_obj_update_layout(label);
+    lv_coord_t h = lv_obj_get_content_height(label);
+    TEST_ASSERT_NOT_EQUAL(0, glyph_dsc_cnt);
+    lv_label_set_text(label, "ab\nc");
+    lv_obj_update_layout(label);
+    TEST_ASSERT_GREATER_THAN(h, lv_obj_get_content_height(label));
+
+    /*New width*/
+    lv_obj_set_width(label, 100);
+    lv_label_set_text(label, long_txt);
+    lv_obj_update_layout(label);
+    lv_point_t size;
+    lv_txt_get_size(&size, long_txt, &counting_font, 0, 0, lv_obj_get_content_width(label), LV_TEXT_FLAG_NONE);
+    TEST_ASSERT_EQUAL_INT32(size.y, lv_obj_get_content_height(label));
+}
+
+void test_label_adv_cache(void)
+{
+    lv_font_get_glyph_width(&counting_font, 'A', 'V');
+    TEST_ASSERT_EQUAL_UINT32(1, glyph_dsc_cnt);
+    lv_font_get_glyph_width(&counting_font, 'A', 'V');
+    TEST_ASSERT_EQUAL_UINT32(1, glyph_dsc_cnt);
+
+    /*The font might have kerning, so the next letter matters*/
+    lv_font_get_glyph_width(&counting_font, 'A', 'B');
+    TEST_ASSERT_EQUAL_UINT32(2, glyph_dsc_cnt);
+
+    lv_font_clear_adv_cache(&counting_font);
+    lv_font_get_glyph_width(&counting_font, 'A', 'V');
+    TEST_ASSERT_EQUAL_UINT32(3, glyph_dsc_cnt);
+
+    /*Cached widths are the same as the real ones*/
+    const char * txt = long_txt;
+    uint32_t i = 0;
+    while(txt[i] != '\0') {
+        uint32_t letter;
+        uint32_t letter_next;
+        _lv_txt_encoded_letter_next_2(txt, &letter, &letter_next, &i);
+        lv_font_glyph_dsc_t g;
+        lv_font_get_glyph_dsc(get_font(), &g, letter, letter_next);
+        TEST_ASSERT_EQUAL_UINT16(g.adv_w, lv_font_get_glyph_width(get_font(), letter, letter_next));
+        TEST_ASSERT_EQUAL_UINT16(g.adv_w, lv_font_get_glyph_width(get_font(), letter, letter_next));
+    }
+}
+
+static void draw_event_cb(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    const lv_txt_layout_t * layout = lv_event_get_user_data(e);
+
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+    dsc.font = get_font();
+    dsc.align = LV_TEXT_ALIGN_CENTER;
+    dsc.line_space = 4;
+    dsc.layout = layout;
+
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    lv_draw_label(lv_event_get_draw_ctx(e), &dsc, &coords, long_txt, NULL);
+}
+
+void test_label_draw_with_layout(void)
+{
+    lv_txt_layout_t layout;
+    _lv_txt_layout_init(&layout);
+    TEST_ASSERT_NOT_NULL(_lv_txt_layout_get(&layout, long_txt, get_font(), 0, 4, 280, LV_TEXT_FLAG_NONE));
+
+    /*Start above the screen to skip some lines*/
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_size(obj, 280, 600);
+    lv_obj_set_pos(obj, 10, -50);
+    lv_obj_add_event_cb(obj, draw_event_cb, LV_EVENT_DRAW_MAIN, NULL);
+    refr_screen();
+    lv_memcpy(ref_fb, test_fb, sizeof(ref_fb));
+
+    lv_obj_remove_event_cb(obj, draw_event_cb);
+    lv_obj_add_event_cb(obj, draw_event_cb, LV_EVENT_DRAW_MAIN, &layout);
+    refr_screen();
+    TEST_ASSERT_EQUAL_MEMORY(ref_fb, test_fb, sizeof(ref_fb));
+
+    /*Not used with other parameters*/
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, get_font(), 0, 281, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, get_font(), 1, 280, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_FALSE(_lv_txt_layout_is_valid(&layout, &lv_font_montserrat_14, 0, 280, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_TRUE(_lv_txt_layout_is_valid(&layout, get_font(), 0, 280, LV_TEXT_FLAG_NONE));
+
+    _lv_txt_layout_free(&layout);
+}
+
+/*The test ticks are incremented manually, so measure the real time*/
+static uint32_t time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000000 + tv.tv_usec);
+}
+
+/*Set a new or the same static text in each update and get the average time*/
+static uint32_t update_label(lv_obj_t * label, bool new_txt, bool draw, uint32_t cnt)
+{
+    static char buf[2][600];
+    uint32_t i;
+    uint32_t t = time_us();
+    for(i = 0; i < cnt; i++) {
+        if(new_txt) {
+            /*E.g. the next line of lyrics*/
+            lv_snprintf(buf[i & 1], sizeof(buf[0]), "%"LV_PRIu32" %s", i, long_txt);
+            lv_label_set_text_static(label, buf[i & 1]);
+        }
+        else {
+            lv_label_set_text_static(label, long_txt);
+        }
+
+        if(draw) lv_refr_now(NULL);
+        else lv_obj_update_layout(label);
+    }
+    return (time_us() - t) / cnt;
+}
+
+void test_label_benchmark(void)
+{
+    uint32_t cnt = 100;
+    uint32_t i;
+
+    uint32_t t = time_us();
+    for(i = 0; i < cnt; i++) {
+        lv_point_t size;
+        lv_txt_get_size(&size, long_txt, get_font(), 0, 0, 300, LV_TEXT_FLAG_NONE);
+    }
+    printf("label: %d bytes, lv_txt_get_size %5"LV_PRIu32" us\n", (int)strlen(long_txt), (time_us() - t) / cnt);
+
+    lv_obj_t * label = create_label(LV_LABEL_LONG_WRAP);
+    printf("label: new text %5"LV_PRIu32" us, same text %5"LV_PRIu32" us\n", update_label(label, true, false, cnt),
+           update_label(label, false, false, cnt));
+    printf("label: new text and draw %5"LV_PRIu32" us, same text and draw %5"LV_PRIu32" us\n",
+           update_label(label, true, true, cnt), update_label(label, false, true, cnt));
+    lv_obj_del(label);
+
+    label = create_label(LV_LABEL_LONG_SCROLL_CIRCULAR);
+    refr_screen();
+    t = time_us();
+    for(i = 0; i < cnt; i++) {
+        lv_obj_invalidate(label);
+        lv_refr_now(NULL);
+    }
+    printf("label: circular scroll frame %5"LV_PRIu32" us\n", (time_us() - t) / cnt);
+}
+
+#endif
+
+#endif
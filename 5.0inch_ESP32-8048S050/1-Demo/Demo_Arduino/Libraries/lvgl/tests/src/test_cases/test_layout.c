@@ -0,0 +1,300 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <sys/time.h>
+
+#if LV_USE_FLEX && LV_USE_GRID
+
+#define ITEM_CNT    1000
+
+static lv_obj_t * cont;
+static lv_area_t * ref_coords;
+static uint32_t ref_cnt;
+
+void setUp(void)
+{
+    cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(cont, 300, 400);
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_mem_free(ref_coords);
+    ref_coords = NULL;
+}
+
+static lv_obj_t * create_item(lv_obj_t * parent, uint32_t id)
+{
+    lv_obj_t * btn = lv_btn_create(parent);
+    lv_obj_set_width(btn, lv_pct(100));
+    lv_obj_t * label = lv_label_create(btn);
+    lv_label_set_text_fmt(label, "Item %"LV_PRIu32, id);
+    return btn;
+}
+
+static void create_items(lv_obj_t * parent, uint32_t cnt)
+{
+    uint32_t i;
+    for(i = 0; i < cnt; i++) create_item(parent, i);
+}
+
+static uint32_t obj_cnt(lv_obj_t * obj)
+{
+    uint32_t cnt = 1;
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(obj); i++) cnt += obj_cnt(lv_obj_get_child(obj, i));
+    return cnt;
+}
+
+static void save_coords(lv_obj_t * obj)
+{
+    ref_coords[ref_cnt++] = obj->coords;
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(obj); i++) save_coords(lv_obj_get_child(obj, i));
+}
+
+static void assert_coords(lv_obj_t * obj)
+{
+    char msg[64];
+    lv_snprintf(msg, sizeof(msg), "object %"LV_PRIu32, ref_cnt);
+    lv_area_t * a = &ref_coords[ref_cnt++];
+    TEST_ASSERT_EQUAL_INT_MESSAGE(a->x1, obj->coords.x1, msg);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(a->y1, obj->coords.y1, msg);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(a->x2, obj->coords.x2, msg);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(a->y2, obj->coords.y2, msg);
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(obj); i++) assert_coords(lv_obj_get_child(obj, i));
+}
+
+static void mark_all(lv_obj_t * obj)
+{
+    lv_obj_mark_layout_as_dirty(obj);
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(obj); i++) mark_all(lv_obj_get_child(obj, i));
+}
+
+/*Check that the incrementally updated coordinates are the same as after updating everything*/
+static void assert_same_as_full_update(void)
+{
+    lv_obj_t * scr = lv_scr_act();
+    lv_obj_update_layout(scr);
+
+    lv_mem_free(ref_coords);
+    ref_coords = lv_mem_alloc(obj_cnt(scr) * sizeof(lv_area_t));
+    ref_cnt = 0;
+    save_coords(scr);
+
+    mark_all(scr);
+    lv_obj_update_layout(scr);
+    ref_cnt = 0;
+    assert_coords(scr);
+}
+
+void test_layout_flex_incremental(void)
+{
+    create_items(cont, ITEM_CNT);
+    lv_obj_update_layout(cont);
+    lv_obj_scroll_to_y(cont, 10000, LV_ANIM_OFF);
+
+    lv_obj_reset_layout_stat();
+    lv_obj_set_height(lv_obj_get_child(cont, 500), 80);
+    lv_obj_update_layout(cont);
+
+    /*Only the item, its label and the container are refreshed*/
+    lv_layout_stat_t stat;
+    lv_obj_get_layout_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(1, stat.update_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(4, stat.refr_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, stat.layout_cnt);
+    TEST_ASSERT_LESS_THAN_UINT32(20, stat.visit_cnt);
+    assert_same_as_full_update();
+
+    lv_obj_t * item = lv_obj_get_child(cont, 10);
+    lv_label_set_text(lv_obj_get_child(item, 0), "A longer text\nin two lines");
+    lv_obj_add_flag(lv_obj_get_child(cont, 20), LV_OBJ_FLAG_HIDDEN);
+    lv_obj_move_to_index(lv_obj_get_child(cont, 30), 900);
+    assert_same_as_full_update();
+
+    /*Nothing is walked if nothing is dirty*/
+    lv_obj_reset_layout_stat();
+    lv_obj_update_layout(cont);
+    lv_obj_get_layout_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(0, stat.visit_cnt);
+}
+
+void test_layout_other_branch(void)
+{
+    create_items(cont, ITEM_CNT);
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_align(label, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    lv_obj_update_layout(cont);
+
+    /*A change outside the list doesn't go into the list*/
+    lv_obj_reset_layout_stat();
+    lv_label_set_text(label, "Hello world");
+    lv_obj_update_layout(label);
+
+    lv_layout_stat_t stat;
+    lv_obj_get_layout_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(0, stat.layout_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, stat.refr_cnt);
+    TEST_ASSERT_LESS_THAN_UINT32(5, stat.visit_cnt);
+    assert_same_as_full_update();
+}
+
+void test_layout_parent_size(void)
+{
+    /*A content sized column in a row, the column grows with its items*/
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_ROW);
+    lv_obj_t * col = lv_obj_create(cont);
+    lv_obj_set_size(col, 150, LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(col, LV_FLEX_FLOW_COLUMN);
+    create_items(col, 5);
+
+    /*Children which depend on the column's size*/
+    lv_obj_t * pct = lv_obj_create(col);
+    lv_obj_add_flag(pct, LV_OBJ_FLAG_IGNORE_LAYOUT);
+    lv_obj_set_size(pct, lv_pct(50), 20);
+    lv_obj_t * center = lv_obj_create(col);
+    lv_obj_add_flag(center, LV_OBJ_FLAG_FLOATING);
+    lv_obj_set_size(center, 20, 20);
+    lv_obj_center(center);
+    lv_obj_t * fixed = lv_obj_create(col);
+    lv_obj_add_flag(fixed, LV_OBJ_FLAG_IGNORE_LAYOUT);
+    lv_obj_set_size(fixed, 10, 10);
+    lv_obj_set_pos(fixed, 5, 5);
+
+    /*A grid next to it*/
+    static lv_coord_t col_dsc[] = {LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
+    static lv_coord_t row_dsc[] = {LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_TEMPLATE_LAST};
+    lv_obj_t * grid = lv_obj_create(cont);
+    lv_obj_set_size(grid, 100, LV_SIZE_CONTENT);
+    lv_obj_set_grid_dsc_array(grid, col_dsc, row_dsc);
+    uint32_t i;
+    for(i = 0; i < 4; i++) {
+        lv_obj_t * item = create_item(grid, i);
+        lv_obj_set_grid_cell(item, LV_GRID_ALIGN_STRETCH, i % 2, 1, LV_GRID_ALIGN_STRETCH, i / 2, 1);
+    }
+    assert_same_as_full_update();
+
+    lv_coord_t h = lv_obj_get_height(col);
+    lv_obj_set_height(lv_obj_get_child(col, 2), 100);
+    lv_obj_update_layout(cont);
+    TEST_ASSERT_GREATER_THAN(h, lv_obj_get_height(col));
+    assert_same_as_full_update();
+
+    lv_obj_set_style_pad_all(col, 30, 0);
+    lv_obj_set_width(col, 120);
+    lv_obj_update_layout(cont);
+    TEST_ASSERT_EQUAL_INT(lv_obj_get_content_width(col) / 2, lv_obj_get_width(pct));
+    assert_same_as_full_update();
+
+    lv_obj_set_style_base_dir(col, LV_BASE_DIR_RTL, 0);
+    assert_same_as_full_update();
+    lv_obj_set_width(col, 160);
+    assert_same_as_full_update();
+
+    lv_obj_set_height(lv_obj_get_child(grid, 3), 70);
+    lv_obj_set_width(grid, 130);
+    assert_same_as_full_update();
+}
+
+static void size_changed_cb(lv_event_t * e)
+{
+    /*Change an other item when this one changes its size*/
+    lv_obj_t * item = lv_event_get_target(e);
+    lv_obj_t * other = lv_obj_get_child(cont, lv_obj_get_index(item) + 1);
+    lv_obj_set_height(other, lv_obj_get_height(item));
+}
+
+void test_layout_change_in_event(void)
+{
+    create_items(cont, 20);
+    lv_obj_add_event_cb(lv_obj_get_child(cont, 5), size_changed_cb, LV_EVENT_SIZE_CHANGED, NULL);
+    lv_obj_update_layout(cont);
+
+    lv_obj_reset_layout_stat();
+    lv_obj_set_height(lv_obj_get_child(cont, 5), 90);
+    lv_obj_update_layout(cont);
+    TEST_ASSERT_EQUAL_INT(90, lv_obj_get_height(lv_obj_get_child(cont, 6)));
+
+    lv_layout_stat_t stat;
+    lv_obj_get_layout_stat(&stat);
+    TEST_ASSERT_EQUAL_UINT32(1, stat.update_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2, stat.pass_cnt);
+    assert_same_as_full_update();
+}
+
+/*The test ticks are incremented manually, so measure the real time*/
+static uint32_t time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000000 + tv.tv_usec);
+}
+
+void test_layout_benchmark(void)
+{
+    lv_obj_t * side = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(side, 200, 400);
+    lv_obj_set_pos(side, 400, 0);
+    lv_obj_t * side_label = lv_label_create(side);
+
+    uint32_t t = time_us();
+    create_items(cont, ITEM_CNT);
+    lv_obj_update_layout(cont);
+    t = time_us() - t;
+    printf("layout: %d items, create %6"LV_PRIu32" us\n", ITEM_CNT, t);
+
+    uint32_t upd_cnt = 200;
+    uint32_t i;
+    lv_layout_stat_t stat;
+
+    /*Resize an item, the items below it need to be moved*/
+    lv_obj_reset_layout_stat();
+    t = time_us();
+    for(i = 0; i < upd_cnt; i++) {
+        lv_obj_set_height(lv_obj_get_child(cont, (i * 397) % ITEM_CNT), 40 + (i % 3) * 10);
+        lv_obj_update_layout(cont);
+    }
+    t = time_us() - t;
+    lv_obj_get_layout_stat(&stat);
+    printf("layout: resize item    %5"LV_PRIu32" us/update, %5"LV_PRIu32" visited, %4"LV_PRIu32" refreshed, "
+           "%2"LV_PRIu32" laid out\n", t / upd_cnt, stat.visit_cnt / upd_cnt, stat.refr_cnt / upd_cnt,
+           stat.layout_cnt / upd_cnt);
+
+    /*Change the text of an item, the size of the item doesn't change*/
+    lv_obj_reset_layout_stat();
+    t = time_us();
+    for(i = 0; i < upd_cnt; i++) {
+        lv_obj_t * label = lv_obj_get_child(lv_obj_get_child(cont, (i * 397) % ITEM_CNT), 0);
+        lv_label_set_text(label, i % 2 ? "Playing" : "Paused");
+        lv_obj_update_layout(cont);
+    }
+    t = time_us() - t;
+    lv_obj_get_layout_stat(&stat);
+    printf("layout: item text      %5"LV_PRIu32" us/update, %5"LV_PRIu32" visited, %4"LV_PRIu32" refreshed, "
+           "%2"LV_PRIu32" laid out\n", t / upd_cnt, stat.visit_cnt / upd_cnt, stat.refr_cnt / upd_cnt,
+           stat.layout_cnt / upd_cnt);
+
+    /*Change an object next to the list*/
+    lv_obj_reset_layout_stat();
+    t = time_us();
+    for(i = 0; i < upd_cnt; i++) {
+        lv_label_set_text_fmt(side_label, "%"LV_PRIu32" %%", i);
+        lv_obj_update_layout(side);
+    }
+    t = time_us() - t;
+    lv_obj_get_layout_stat(&stat);
+    printf("layout: other object   %5"LV_PRIu32" us/update, %5"LV_PRIu32" visited, %4"LV_PRIu32" refreshed, "
+           "%2"LV_PRIu32" laid out\n", t / upd_cnt, stat.visit_cnt / upd_cnt, stat.refr_cnt / upd_cnt,
+           stat.layout_cnt / upd_cnt);
+}
+
+#endif
+
+#endif
@@ -2,6 +2,9 @@
 #include "../lvgl.h"
 
 #include "unity/unity.h"
+#include "../src/misc/lv_tlsf.h"
+#include <stdlib.h>
+#include <time.h>
 
 void setUp(void)
 {
@@ -23,4 +26,198 @@ void test_mem_buf_realloc(void)
 #endif
 }
 
+void test_mem_large_pool_by_size(void)
+{
+#if LV_MEM_CUSTOM == 0 && LV_MEM_LARGE_SIZE
+    lv_mem_monitor_t mon_start;
+    lv_mem_monitor_large(&mon_start);
+
+    /*Small objects stay in the fast pool*/
+    void * small = lv_mem_alloc(LV_MEM_LARGE_THRESHOLD / 2);
+    lv_mem_monitor_t mon;
+    lv_mem_monitor_large(&mon);
+    TEST_ASSERT_EQUAL_UINT32(mon_start.used_cnt, mon.used_cnt);
+
+    /*Large ones go to the large pool*/
+    void * big = lv_mem_alloc(LV_MEM_LARGE_THRESHOLD * 4);
+    lv_mem_monitor_large(&mon);
+    TEST_ASSERT_EQUAL_UINT32(mon_start.used_cnt + 1, mon.used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(LV_MEM_LARGE_SIZE, mon.total_size);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(LV_MEM_LARGE_THRESHOLD * 4, mon.max_used);
+
+    /*Growing a block keeps its content*/
+    lv_memset(big, 0x5a, LV_MEM_LARGE_THRESHOLD * 4);
+    big = lv_mem_realloc(big, LV_MEM_LARGE_THRESHOLD * 8);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_EACH_EQUAL_HEX8(0x5a, big, LV_MEM_LARGE_THRESHOLD * 4);
+
+    lv_mem_free(small);
+    lv_mem_free(big);
+    lv_mem_monitor_large(&mon);
+    TEST_ASSERT_EQUAL_UINT32(mon_start.used_cnt, mon.used_cnt);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+#endif
+}
+
+void test_mem_large_pool_churn(void)
+{
+#if LV_MEM_CUSTOM == 0 && LV_MEM_LARGE_SIZE
+    /*Mix of small objects and large buffers, freed out of order*/
+    static void * ptrs[256];
+    uint32_t seed = 1;
+    uint32_t round;
+    uint32_t i;
+    for(round = 0; round < 20; round++) {
+        for(i = 0; i < 256; i++) {
+            seed = seed * 1103515245 + 12345;
+            size_t size = (seed >> 16) % 8 == 0 ? 4096 + (seed >> 8) % 8192 : 16 + (seed >> 8) % 128;
+            ptrs[i] = lv_mem_alloc(size);
+            TEST_ASSERT_NOT_NULL(ptrs[i]);
+        }
+        for(i = 0; i < 256; i += 2) lv_mem_free(ptrs[i]);
+        for(i = 1; i < 256; i += 2) lv_mem_free(ptrs[i]);
+    }
+
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+
+    /*Everything was freed so both pools have to be in one piece again*/
+    lv_mem_monitor_t mon;
+    lv_mem_monitor_large(&mon);
+    TEST_ASSERT_EQUAL_UINT8(0, mon.frag_pct);
+#endif
+}
+
+
+#if LV_MEM_CUSTOM == 0 && LV_MEM_LARGE_SIZE
+
+#define BENCH_SMALL_CNT     300     /*Live small objects (widgets, styles, event lists)*/
+#define BENCH_LARGE_CNT     24      /*Live large buffers (decoded images, layers)*/
+#define BENCH_ROUNDS        20000   /*Small objects replaced, a large buffer every 16th round*/
+
+typedef struct {
+    void * (*alloc)(size_t size);
+    void (*free)(void * p);
+    void * small[BENCH_SMALL_CNT];
+    void * large[BENCH_LARGE_CNT];
+    uint32_t lat_ns[BENCH_ROUNDS];
+    uint32_t avg_ns;
+    uint32_t p99_ns;
+    uint32_t max_ns;
+} bench_heap_t;
+
+/*The allocator before the split: one LV_MEM_SIZE TLSF pool for everything*/
+static lv_tlsf_t base_tlsf;
+
+static void * base_alloc(size_t size)
+{
+    return lv_tlsf_malloc(base_tlsf, size);
+}
+
+static void base_free(void * p)
+{
+    lv_tlsf_free(base_tlsf, p);
+}
+
+static void base_walker(void * ptr, size_t size, int used, void * user)
+{
+    LV_UNUSED(ptr);
+    uint32_t * free_info = user;  /*Free size and biggest free block*/
+    if(used) return;
+    free_info[0] += size;
+    if(size > free_info[1]) free_info[1] = size;
+}
+
+static uint32_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+static int cmp_u32(const void * a, const void * b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/*UI churn: widgets come and go while the image cache replaces its buffers*/
+static void bench_churn(bench_heap_t * heap)
+{
+    void ** small = heap->small;
+    void ** large = heap->large;
+    uint32_t seed = 1;
+    uint32_t i;
+
+    for(i = 0; i < BENCH_SMALL_CNT; i++) small[i] = heap->alloc(16 + i % 240);
+    for(i = 0; i < BENCH_LARGE_CNT; i++) large[i] = heap->alloc(8192 + i * 1536);
+
+    uint64_t sum = 0;
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        seed = seed * 1103515245 + 12345;
+        if(i % 16 == 0) {
+            uint32_t l = (seed >> 8) % BENCH_LARGE_CNT;
+            heap->free(large[l]);
+            large[l] = heap->alloc(8192 + (seed >> 12) % 40960);
+            TEST_ASSERT_NOT_NULL(large[l]);
+        }
+
+        uint32_t s = (seed >> 16) % BENCH_SMALL_CNT;
+        heap->free(small[s]);
+        uint32_t t = now_ns();
+        small[s] = heap->alloc(16 + (seed >> 4) % 240);
+        heap->lat_ns[i] = now_ns() - t;
+        TEST_ASSERT_NOT_NULL(small[s]);
+        sum += heap->lat_ns[i];
+    }
+
+    qsort(heap->lat_ns, BENCH_ROUNDS, sizeof(uint32_t), cmp_u32);
+    heap->avg_ns = (uint32_t)(sum / BENCH_ROUNDS);
+    heap->p99_ns = heap->lat_ns[BENCH_ROUNDS * 99 / 100];
+    heap->max_ns = heap->lat_ns[BENCH_ROUNDS - 1];
+}
+
+/*The live set stays allocated until the fragmentation was measured*/
+static void bench_release(bench_heap_t * heap)
+{
+    uint32_t i;
+    for(i = 0; i < BENCH_SMALL_CNT; i++) heap->free(heap->small[i]);
+    for(i = 0; i < BENCH_LARGE_CNT; i++) heap->free(heap->large[i]);
+}
+#endif
+
+void test_mem_large_pool_benchmark(void)
+{
+#if LV_MEM_CUSTOM == 0 && LV_MEM_LARGE_SIZE
+    static bench_heap_t split = {.alloc = lv_mem_alloc, .free = lv_mem_free};
+    static bench_heap_t base = {.alloc = base_alloc, .free = base_free};
+    static LV_ATTRIBUTE_LARGE_RAM_ARRAY uint64_t base_mem[LV_MEM_SIZE / sizeof(uint64_t)];
+    base_tlsf = lv_tlsf_create_with_pool(base_mem, sizeof(base_mem));
+
+    bench_churn(&base);
+    uint32_t base_free_info[2] = {0, 0};
+    lv_tlsf_walk_pool(lv_tlsf_get_pool(base_tlsf), base_walker, base_free_info);
+    uint32_t base_frag = 100 - (uint32_t)((uint64_t)base_free_info[1] * 100 / base_free_info[0]);
+    bench_release(&base);
+    lv_tlsf_destroy(base_tlsf);
+
+    bench_churn(&split);
+    lv_mem_monitor_t mon;
+    lv_mem_monitor_t mon_large;
+    lv_mem_monitor(&mon);
+    lv_mem_monitor_large(&mon_large);
+
+    printf("mem: small alloc avg/p99/max [ns]: split %"LV_PRIu32"/%"LV_PRIu32"/%"LV_PRIu32", "
+           "one pool %"LV_PRIu32"/%"LV_PRIu32"/%"LV_PRIu32"; "
+           "fragmentation: fast pool %d%%, large pool %d%%, one pool %"LV_PRIu32"%%\n",
+           split.avg_ns, split.p99_ns, split.max_ns, base.avg_ns, base.p99_ns, base.max_ns,
+           mon.frag_pct, mon_large.frag_pct, base_frag);
+
+    /*The image buffers don't cut up the pool of the small objects any more*/
+    TEST_ASSERT_LESS_THAN_UINT32(base_frag, mon.frag_pct);
+    bench_release(&split);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+#endif
+}
+
 #endif
@@ -0,0 +1,257 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+/*Baseline JPGs: the left half is (220, y, 20), the right half is (20, y, 220) where `y` goes from 0 to 255*/
+#define PHOTO_S     "A:src/test_files/photo_400x240.jpg"
+#define PHOTO_M     "A:src/test_files/photo_800x480.jpg"
+#define PHOTO_L     "A:src/test_files/photo_1600x960.jpg"
+
+/*Frame buffer of the test display, the whole screen is in it after a full refresh*/
+extern lv_color_t test_fb[];
+
+void setUp(void)
+{
+#if LV_USE_SJPG
+    lv_split_jpeg_set_fit_size(0, 0);
+#endif
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_img_cache_invalidate_src(NULL);
+#if LV_USE_SJPG
+    lv_split_jpeg_set_fit_size(0, 0);
+#endif
+}
+
+#if LV_USE_SJPG
+static void assert_color(uint32_t exp, lv_color_t c)
+{
+    lv_color32_t act;
+    act.full = lv_color_to32(c);
+    TEST_ASSERT_UINT32_WITHIN(16, (exp >> 16) & 0xff, act.ch.red);
+    TEST_ASSERT_UINT32_WITHIN(16, (exp >> 8) & 0xff, act.ch.green);
+    TEST_ASSERT_UINT32_WITHIN(16, exp & 0xff, act.ch.blue);
+}
+
+static void assert_photo(const lv_color_t * px, lv_coord_t w, lv_coord_t h)
+{
+    assert_color(0xdc0014, px[w / 4]);
+    assert_color(0x14ffdc, px[(h - 1) * w + w * 3 / 4]);
+    assert_color(0xdc8014, px[(h / 2) * w + w / 4]);
+}
+
+/*The test ticks are incremented manually, so measure the real time*/
+static uint32_t time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000000 + tv.tv_usec);
+}
+#endif
+
+void test_sjpg_fit_size(void)
+{
+#if LV_USE_SJPG
+    lv_img_header_t header;
+
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_get_info(PHOTO_L, &header));
+    TEST_ASSERT_EQUAL(1600, header.w);
+    TEST_ASSERT_EQUAL(960, header.h);
+    TEST_ASSERT_EQUAL(LV_IMG_CF_TRUE_COLOR, header.cf);
+
+    /*The smallest size which still covers the screen*/
+    lv_split_jpeg_set_fit_size(800, 480);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_get_info(PHOTO_L, &header));
+    TEST_ASSERT_EQUAL(800, header.w);
+    TEST_ASSERT_EQUAL(480, header.h);
+
+    lv_split_jpeg_set_fit_size(801, 100);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_get_info(PHOTO_L, &header));
+    TEST_ASSERT_EQUAL(1600, header.w);
+
+    /*1/8 at most*/
+    lv_split_jpeg_set_fit_size(10, 10);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_get_info(PHOTO_L, &header));
+    TEST_ASSERT_EQUAL(200, header.w);
+    TEST_ASSERT_EQUAL(120, header.h);
+
+    /*Only the height matters*/
+    lv_split_jpeg_set_fit_size(0, 200);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_get_info(PHOTO_M, &header));
+    TEST_ASSERT_EQUAL(400, header.w);
+    TEST_ASSERT_EQUAL(240, header.h);
+#endif
+}
+
+void test_sjpg_decode(void)
+{
+#if LV_USE_SJPG
+    lv_img_decoder_dsc_t dsc;
+
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, PHOTO_S, lv_color_black(), 0));
+    TEST_ASSERT_NOT_NULL(dsc.img_data);
+    TEST_ASSERT_EQUAL(400, dsc.header.w);
+    TEST_ASSERT_EQUAL(240, dsc.header.h);
+    assert_photo((const lv_color_t *)dsc.img_data, 400, 240);
+    lv_img_decoder_close(&dsc);
+
+    /*A scaled down large photo looks the same*/
+    lv_split_jpeg_set_fit_size(400, 240);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, PHOTO_L, lv_color_black(), 0));
+    TEST_ASSERT_NOT_NULL(dsc.img_data);
+    TEST_ASSERT_EQUAL(400, dsc.header.w);
+    TEST_ASSERT_EQUAL(240, dsc.header.h);
+    assert_photo((const lv_color_t *)dsc.img_data, 400, 240);
+    lv_img_decoder_close(&dsc);
+#endif
+}
+
+void test_sjpg_cache_fit_size(void)
+{
+#if LV_USE_SJPG && LV_IMG_CACHE_DEF_SIZE
+#if LV_USE_IMG_ASYNC
+    lv_img_async_enable(false);
+#endif
+    lv_split_jpeg_set_fit_size(800, 480);
+    _lv_img_cache_entry_t * big = _lv_img_cache_open(PHOTO_L, lv_color_black(), 0);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_EQUAL(800, big->dec_dsc.header.w);
+
+    /*The same source with an other fit size is an other image*/
+    lv_split_jpeg_set_fit_size(200, 120);
+    _lv_img_cache_entry_t * small = _lv_img_cache_open(PHOTO_L, lv_color_black(), 0);
+    TEST_ASSERT_NOT_NULL(small);
+    TEST_ASSERT_TRUE(small != big);
+    TEST_ASSERT_EQUAL(200, small->dec_dsc.header.w);
+    TEST_ASSERT_EQUAL(120, small->dec_dsc.header.h);
+    assert_photo((const lv_color_t *)small->dec_dsc.img_data, 200, 120);
+
+    /*Both stay cached*/
+    lv_split_jpeg_set_fit_size(800, 480);
+    TEST_ASSERT_EQUAL_PTR(big, _lv_img_cache_open(PHOTO_L, lv_color_black(), 0));
+    TEST_ASSERT_EQUAL(800, big->dec_dsc.header.w);
+#if LV_USE_IMG_ASYNC
+    lv_img_async_enable(true);
+#endif
+#endif
+}
+
+void test_sjpg_async_fit_size(void)
+{
+#if LV_USE_SJPG && LV_USE_IMG_ASYNC && LV_IMG_CACHE_DEF_SIZE
+    /*The fit size is taken when the image is requested, changing it later doesn't affect the worker*/
+    lv_split_jpeg_set_fit_size(400, 240);
+    TEST_ASSERT_NULL(_lv_img_cache_open(PHOTO_L, lv_color_black(), 0));
+    lv_split_jpeg_set_fit_size(200, 120);
+
+    uint32_t i;
+    for(i = 0; lv_img_async_is_busy(); i++) {
+        TEST_ASSERT_LESS_THAN_UINT32(5000, i);
+        usleep(1000);
+    }
+
+    /*The finished request is not for this fit size*/
+    _lv_img_cache_entry_t * small = NULL;
+    for(i = 0; small == NULL; i++) {
+        TEST_ASSERT_LESS_THAN_UINT32(5000, i);
+        small = _lv_img_cache_open(PHOTO_L, lv_color_black(), 0);
+        if(small == NULL) usleep(1000);
+    }
+    TEST_ASSERT_EQUAL(200, small->dec_dsc.header.w);
+
+    lv_split_jpeg_set_fit_size(400, 240);
+    _lv_img_cache_entry_t * mid = _lv_img_cache_open(PHOTO_L, lv_color_black(), 0);
+    TEST_ASSERT_NOT_NULL(mid);
+    TEST_ASSERT_EQUAL(400, mid->dec_dsc.header.w);
+    TEST_ASSERT_EQUAL(240, mid->dec_dsc.header.h);
+    assert_photo((const lv_color_t *)mid->dec_dsc.img_data, 400, 240);
+#endif
+}
+
+void test_sjpg_draw_scaled(void)
+{
+#if LV_USE_SJPG
+    lv_split_jpeg_set_fit_size(LV_HOR_RES, LV_VER_RES);
+    lv_obj_t * img = lv_img_create(lv_scr_act());
+    lv_img_set_src(img, PHOTO_L);
+    lv_obj_update_layout(img);
+    TEST_ASSERT_EQUAL(LV_HOR_RES, lv_obj_get_width(img));
+    TEST_ASSERT_EQUAL(LV_VER_RES, lv_obj_get_height(img));
+
+    lv_refr_now(NULL);
+#if LV_USE_IMG_ASYNC
+    uint32_t i;
+    for(i = 0; lv_img_async_is_busy(); i++) {
+        TEST_ASSERT_LESS_THAN_UINT32(5000, i);
+        usleep(1000);
+    }
+    lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+    lv_timer_handler();
+#endif
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    assert_photo(test_fb, LV_HOR_RES, LV_VER_RES);
+#endif
+}
+
+void test_sjpg_benchmark(void)
+{
+#if LV_USE_SJPG
+    static const struct {
+        const char * src;
+        lv_coord_t fit_w;
+        lv_coord_t fit_h;
+    } cases[] = {
+        {PHOTO_S, 0, 0},
+        {PHOTO_M, 0, 0},
+        {PHOTO_L, 800, 480},
+        {PHOTO_L, 400, 240},
+        {PHOTO_L, 200, 120},
+    };
+
+    uint32_t i;
+    for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        lv_split_jpeg_set_fit_size(cases[i].fit_w, cases[i].fit_h);
+
+        /*Right after the reset `max_used` is the current usage*/
+        lv_mem_reset_max_used();
+        lv_mem_monitor_t mon;
+        lv_mem_monitor_t mon_large;
+        lv_mem_monitor(&mon);
+        lv_mem_monitor_large(&mon_large);
+        uint32_t used_start = mon.max_used + mon_large.max_used;
+
+        lv_img_decoder_dsc_t dsc;
+        uint32_t t = time_us();
+        TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_decoder_open(&dsc, cases[i].src, lv_color_black(), 0));
+        t = time_us() - t;
+
+        lv_mem_monitor(&mon);
+        lv_mem_monitor_large(&mon_large);
+        uint32_t img_size = (uint32_t)dsc.header.w * dsc.header.h * sizeof(lv_color_t);
+        printf("sjpg: %-36s -> %4dx%-4d %6"LV_PRIu32" us, image %7"LV_PRIu32" B", cases[i].src,
+               dsc.header.w, dsc.header.h, t, img_size);
+#if LV_MEM_CUSTOM == 0
+        uint32_t peak = mon.max_used + mon_large.max_used - used_start;
+        printf(", peak RAM %7"LV_PRIu32" B\n", peak);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(img_size, peak);
+        /*Only the work buffers of tjpgd are needed besides the image*/
+        TEST_ASSERT_LESS_THAN_UINT32(img_size + 16 * 1024, peak);
+#else
+        LV_UNUSED(used_start);
+        printf("\n");
+#endif
+        assert_photo((const lv_color_t *)dsc.img_data, dsc.header.w, dsc.header.h);
+        lv_img_decoder_close(&dsc);
+    }
+#endif
+}
+
+#endif
@@ -0,0 +1,174 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+    /* Function run after every test */
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_slab_alloc_free(void)
+{
+#if LV_SLAB_ENABLED
+    lv_slab_monitor_t mon_start;
+    lv_slab_monitor(&mon_start);
+
+    void * a = lv_slab_alloc(20);
+    void * b = lv_slab_alloc(24);
+    TEST_ASSERT_TRUE(_lv_slab_owns(a));
+    TEST_ASSERT_TRUE(_lv_slab_owns(b));
+
+    /*Same size class, different blocks*/
+    lv_slab_class_monitor_t cmon;
+    lv_slab_monitor_class(20, &cmon);
+    TEST_ASSERT_EQUAL_UINT32(24, cmon.block_size);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(2, cmon.used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(LV_SLAB_PAGE_SIZE / 24 * cmon.page_cnt, cmon.capacity);
+    TEST_ASSERT_NOT_EQUAL(a, b);
+
+    /*A freed block is given out again first*/
+    lv_slab_free(b);
+    void * c = lv_slab_alloc(17);
+    TEST_ASSERT_EQUAL_PTR(b, c);
+
+    /*`lv_mem_free()` knows slab blocks too*/
+    lv_mem_free(a);
+    lv_slab_free(c);
+
+    lv_slab_monitor_t mon;
+    lv_slab_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(mon_start.used_cnt, mon.used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(mon_start.free_page_cnt, mon.free_page_cnt);
+
+    /*Too large sizes go to the heap*/
+    void * big = lv_slab_alloc(LV_SLAB_MAX_SIZE + 1);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_FALSE(_lv_slab_owns(big));
+    lv_slab_free(big);
+#endif
+}
+
+void test_slab_realloc(void)
+{
+#if LV_SLAB_ENABLED
+    uint8_t * p = lv_slab_realloc(NULL, 8);
+    TEST_ASSERT_TRUE(_lv_slab_owns(p));
+    lv_memset(p, 0x5a, 8);
+
+    /*Same class: stays in place*/
+    TEST_ASSERT_EQUAL_PTR(p, lv_slab_realloc(p, 5));
+
+    /*Grows into another class, then out to the heap*/
+    p = lv_slab_realloc(p, 40);
+    TEST_ASSERT_TRUE(_lv_slab_owns(p));
+    TEST_ASSERT_EACH_EQUAL_HEX8(0x5a, p, 8);
+    p = lv_mem_realloc(p, LV_SLAB_MAX_SIZE * 2);
+    TEST_ASSERT_FALSE(_lv_slab_owns(p));
+    TEST_ASSERT_EACH_EQUAL_HEX8(0x5a, p, 8);
+    lv_mem_free(p);
+#endif
+}
+
+void test_slab_fallback_when_full(void)
+{
+#if LV_SLAB_ENABLED
+    static void * ptrs[LV_SLAB_ARENA_SIZE / LV_SLAB_MAX_SIZE + 16];
+    lv_slab_monitor_t mon_start;
+    lv_slab_monitor(&mon_start);
+
+    uint32_t i;
+    for(i = 0; i < sizeof(ptrs) / sizeof(ptrs[0]); i++) {
+        ptrs[i] = lv_slab_alloc(LV_SLAB_MAX_SIZE);
+        TEST_ASSERT_NOT_NULL(ptrs[i]);
+    }
+
+    lv_slab_monitor_t mon;
+    lv_slab_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(0, mon.free_page_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(mon_start.fallback_cnt, mon.fallback_cnt);
+
+    for(i = 0; i < sizeof(ptrs) / sizeof(ptrs[0]); i++) {
+        lv_slab_free(ptrs[i]);
+    }
+
+    /*Empty pages are returned to the arena*/
+    lv_slab_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(mon_start.free_page_cnt, mon.free_page_cnt);
+    lv_slab_class_monitor_t cmon;
+    lv_slab_monitor_class(LV_SLAB_MAX_SIZE, &cmon);
+    TEST_ASSERT_EQUAL_UINT32(0, cmon.page_cnt);
+#endif
+}
+
+#if LV_SLAB_ENABLED
+static void soak_event_cb(lv_event_t * e)
+{
+    LV_UNUSED(e);
+}
+
+static void soak_anim_cb(void * var, int32_t v)
+{
+    lv_obj_set_x(var, v);
+}
+
+/*Create and delete a screen like the music demo does on every screen change*/
+static void soak_screen(void)
+{
+    lv_obj_t * scr = lv_obj_create(NULL);
+    lv_obj_t * btn = lv_btn_create(scr);
+    lv_obj_add_event_cb(btn, soak_event_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_t * label = lv_label_create(btn);
+    lv_label_set_text_static(label, "Play");
+    label = lv_label_create(scr);
+    lv_label_set_text_static(label, "Title");
+    lv_obj_add_event_cb(label, soak_event_cb, LV_EVENT_ALL, NULL);
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, label);
+    lv_anim_set_values(&a, 0, 100);
+    lv_anim_set_exec_cb(&a, soak_anim_cb);
+    lv_anim_start(&a);
+
+    lv_obj_del(scr);
+}
+#endif
+
+void test_slab_screen_soak(void)
+{
+#if LV_SLAB_ENABLED
+    /*The first screen initializes some permanent data (e.g. theme styles)*/
+    soak_screen();
+
+    lv_slab_monitor_t slab_start;
+    lv_mem_monitor_t mem_start;
+    lv_slab_monitor(&slab_start);
+    lv_mem_monitor(&mem_start);
+
+    uint32_t round;
+    for(round = 0; round < 100000; round++) {
+        soak_screen();
+    }
+
+    /*Everything went back where it came from*/
+    lv_slab_monitor_t slab;
+    lv_mem_monitor_t mem;
+    lv_slab_monitor(&slab);
+    lv_mem_monitor(&mem);
+    TEST_ASSERT_EQUAL_UINT32(slab_start.used_cnt, slab.used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(slab_start.free_page_cnt, slab.free_page_cnt);
+    TEST_ASSERT_EQUAL_UINT32(slab_start.fallback_cnt, slab.fallback_cnt);
+    TEST_ASSERT_EQUAL_UINT32(mem_start.used_cnt, mem.used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(mem_start.free_biggest_size, mem.free_biggest_size);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+#endif
+}
+
+#endif
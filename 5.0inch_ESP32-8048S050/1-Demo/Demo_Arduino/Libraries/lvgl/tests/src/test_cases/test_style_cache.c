@@ -0,0 +1,191 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_WIDGET_CNT    500
+#define BENCH_FRAME_CNT     10
+
+static const lv_style_const_prop_t card_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x20, 0x40, 0x80)),
+    LV_STYLE_CONST_RADIUS(6),
+    LV_STYLE_CONST_PAD_TOP(4),
+    LV_STYLE_CONST_PAD_BOTTOM(4),
+};
+
+static LV_STYLE_CONST_INIT_GROUPS(card_style, card_props,
+                                  LV_STYLE_PROP_GROUP_BIT(LV_STYLE_BG_COLOR) |
+                                  LV_STYLE_PROP_GROUP_BIT(LV_STYLE_RADIUS) |
+                                  LV_STYLE_PROP_GROUP_BIT(LV_STYLE_PAD_TOP) |
+                                  LV_STYLE_PROP_GROUP_BIT(LV_STYLE_PAD_BOTTOM));
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+    /* Function run after every test */
+    lv_obj_clean(lv_scr_act());
+    lv_obj_enable_style_cache(true);
+}
+
+void test_style_cache_const_groups(void)
+{
+    /*The precomputed groups have to match the ones set by the style setters*/
+    lv_style_t style;
+    lv_style_init(&style);
+    lv_style_set_bg_color(&style, lv_color_hex(0x204080));
+    lv_style_set_radius(&style, 6);
+    lv_style_set_pad_top(&style, 4);
+    lv_style_set_pad_bottom(&style, 4);
+    TEST_ASSERT_EQUAL_HEX8(style.has_group, card_style.has_group);
+    lv_style_reset(&style);
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_add_style(obj, (lv_style_t *)&card_style, 0);
+    TEST_ASSERT_EQUAL_HEX32(lv_color_to32(lv_color_hex(0x204080)),
+                            lv_color_to32(lv_obj_get_style_bg_color(obj, LV_PART_MAIN)));
+    TEST_ASSERT_EQUAL(6, lv_obj_get_style_radius(obj, LV_PART_MAIN));
+}
+
+#if LV_USE_OBJ_STYLE_CACHE
+static lv_obj_t * create_widgets(void)
+{
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(cont, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_ROW_WRAP);
+
+    uint32_t i;
+    for(i = 0; i < BENCH_WIDGET_CNT; i++) {
+        lv_obj_t * btn = lv_btn_create(cont);
+        lv_obj_add_style(btn, (lv_style_t *)&card_style, 0);
+        lv_obj_set_style_border_width(btn, 1, 0);
+        lv_obj_set_style_text_color(btn, lv_color_hex(0xffffff), 0);
+        lv_obj_t * label = lv_label_create(btn);
+        lv_label_set_text_fmt(label, "%"LV_PRIu32, i);
+    }
+
+    /*Do the layout once so that the frames measure only the drawing*/
+    lv_refr_now(NULL);
+    return cont;
+}
+
+static uint32_t draw_frames(lv_obj_t * cont)
+{
+    clock_t start = clock();
+    uint32_t i;
+    for(i = 0; i < BENCH_FRAME_CNT; i++) {
+        lv_obj_invalidate(cont);
+        lv_refr_now(NULL);
+    }
+    return (uint32_t)((clock() - start) * 1000 / CLOCKS_PER_SEC);
+}
+#endif
+
+void test_style_cache_benchmark(void)
+{
+#if LV_USE_OBJ_STYLE_CACHE
+    lv_obj_t * cont = create_widgets();
+
+    lv_obj_enable_style_cache(false);
+    lv_obj_style_cache_reset_stat();
+    uint32_t time_off = draw_frames(cont);
+
+    lv_obj_enable_style_cache(true);
+    lv_obj_style_cache_reset_stat();
+    uint32_t time_on = draw_frames(cont);
+
+    lv_obj_style_cache_stat_t stat;
+    lv_obj_style_cache_get_stat(&stat);
+    uint32_t total = stat.hit_cnt + stat.miss_cnt;
+    printf("style cache: %d widgets, %d frames, %"LV_PRIu32" lookups, %"LV_PRIu32" hits, %"LV_PRIu32" misses, "
+           "%"LV_PRIu32" drops, %"LV_PRIu32" ms with cache, %"LV_PRIu32" ms without\n",
+           BENCH_WIDGET_CNT, BENCH_FRAME_CNT, total, stat.hit_cnt, stat.miss_cnt, stat.drop_cnt, time_on, time_off);
+
+    /*Nothing changes between the frames, so after the first one almost every lookup should hit*/
+    TEST_ASSERT_GREATER_THAN_UINT32(0, total);
+    TEST_ASSERT_GREATER_THAN_UINT32(total * 8 / 10, stat.hit_cnt);
+#endif
+}
+
+#if LV_USE_OBJ_STYLE_CACHE
+static void assert_same_as_uncached(lv_obj_t * obj, lv_part_t part)
+{
+    static const lv_style_prop_t props[] = {
+        LV_STYLE_BG_COLOR, LV_STYLE_BG_OPA, LV_STYLE_RADIUS, LV_STYLE_BORDER_WIDTH,
+        LV_STYLE_TEXT_COLOR, LV_STYLE_TEXT_FONT, LV_STYLE_PAD_TOP, LV_STYLE_WIDTH,
+    };
+
+    uint32_t i;
+    for(i = 0; i < sizeof(props) / sizeof(props[0]); i++) {
+        /*Read twice to surely read from the cache*/
+        lv_obj_get_style_prop(obj, part, props[i]);
+        lv_style_value_t cached = lv_obj_get_style_prop(obj, part, props[i]);
+        lv_obj_enable_style_cache(false);
+        lv_style_value_t v = lv_obj_get_style_prop(obj, part, props[i]);
+        lv_obj_enable_style_cache(true);
+        TEST_ASSERT_EQUAL_MEMORY(&v, &cached, sizeof(lv_style_value_t));
+    }
+}
+#endif
+
+void test_style_cache_invalidation(void)
+{
+#if LV_USE_OBJ_STYLE_CACHE
+    static lv_style_t style_pr;
+    lv_style_init(&style_pr);
+    lv_style_set_bg_color(&style_pr, lv_color_hex(0xff0000));
+    lv_style_set_text_color(&style_pr, lv_color_hex(0x00ff00));
+
+    lv_obj_t * parent1 = lv_obj_create(lv_scr_act());
+    lv_obj_t * parent2 = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_text_color(parent2, lv_color_hex(0x0000ff), 0);
+    lv_obj_t * btn = lv_btn_create(parent1);
+    lv_obj_add_style(btn, &style_pr, LV_STATE_PRESSED);
+    lv_obj_t * label = lv_label_create(btn);
+    assert_same_as_uncached(btn, LV_PART_MAIN);
+    assert_same_as_uncached(label, LV_PART_MAIN);
+
+    /*State change, also inherited by the label*/
+    lv_obj_add_state(btn, LV_STATE_PRESSED);
+    assert_same_as_uncached(btn, LV_PART_MAIN);
+    assert_same_as_uncached(label, LV_PART_MAIN);
+    TEST_ASSERT_EQUAL_HEX32(0x00ff00, lv_color_to32(lv_obj_get_style_text_color(label, LV_PART_MAIN)) & 0xffffff);
+
+    /*Modified shared style*/
+    lv_style_set_text_color(&style_pr, lv_color_hex(0xffffff));
+    lv_obj_report_style_change(&style_pr);
+    assert_same_as_uncached(label, LV_PART_MAIN);
+    TEST_ASSERT_EQUAL_HEX32(0xffffff, lv_color_to32(lv_obj_get_style_text_color(label, LV_PART_MAIN)) & 0xffffff);
+
+    /*Local style on a parent*/
+    lv_obj_clear_state(btn, LV_STATE_PRESSED);
+    lv_obj_set_style_text_color(parent1, lv_color_hex(0x123456), 0);
+    assert_same_as_uncached(label, LV_PART_MAIN);
+
+    /*New parent, new inherited values*/
+    lv_obj_set_parent(btn, parent2);
+    assert_same_as_uncached(btn, LV_PART_MAIN);
+    assert_same_as_uncached(label, LV_PART_MAIN);
+    lv_obj_set_parent(label, parent2);
+    assert_same_as_uncached(label, LV_PART_MAIN);
+    TEST_ASSERT_EQUAL_HEX32(0x0000ff, lv_color_to32(lv_obj_get_style_text_color(label, LV_PART_MAIN)) & 0xffffff);
+    lv_obj_set_parent(label, btn);
+
+    /*Removed style*/
+    lv_obj_add_state(btn, LV_STATE_PRESSED);
+    lv_obj_remove_style(btn, &style_pr, LV_STATE_PRESSED);
+    assert_same_as_uncached(btn, LV_PART_MAIN);
+    assert_same_as_uncached(label, LV_PART_MAIN);
+
+    lv_obj_del(parent1);
+    lv_obj_del(parent2);
+    lv_style_reset(&style_pr);
+#endif
+}
+
+#endif
@@ -103,6 +103,26 @@ void test_table_row_height_should_increase_with_multiline_cell_value(void)
     TEST_ASSERT_GREATER_THAN(singleline_row_height, multiline_row_height);
 }
 
+void test_table_row_height_should_be_kept_when_adding_rows(void)
+{
+    lv_table_t * table_ptr = (lv_table_t *) table;
+
+    lv_table_set_cell_value(table, 0, 0, "LVGL\nRocks");
+    lv_table_set_cell_value(table, 1, 0, "LVGL");
+    lv_coord_t multiline_row_height = table_ptr->row_h[0];
+    lv_coord_t singleline_row_height = table_ptr->row_h[1];
+
+    lv_table_set_row_cnt(table, 5);
+    TEST_ASSERT_EQUAL(multiline_row_height, table_ptr->row_h[0]);
+    TEST_ASSERT_EQUAL(singleline_row_height, table_ptr->row_h[1]);
+    TEST_ASSERT_EQUAL(table_ptr->row_h[4], table_ptr->row_h[2]);
+    TEST_ASSERT_LESS_OR_EQUAL(singleline_row_height, table_ptr->row_h[2]);
+
+    lv_table_set_row_cnt(table, 1);
+    TEST_ASSERT_EQUAL(multiline_row_height, table_ptr->row_h[0]);
+    TEST_ASSERT_EQUAL(multiline_row_height - 1, lv_obj_get_self_height(table));
+}
+
 void test_table_should_wrap_long_texts(void)
 {
     lv_table_t * table_ptr = (lv_table_t *) table;
@@ -0,0 +1,286 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <sys/time.h>
+
+#define BENCH_CNT   1000
+
+/*The timers of the test environment (display refresh, input devices, etc), paused during the tests*/
+static lv_timer_t * env_timers[16];
+static uint32_t env_timer_cnt;
+
+static uint32_t run_cnt[8];
+static uint32_t run_order[32];
+static uint32_t run_order_cnt;
+
+void setUp(void)
+{
+    lv_memset_00(run_cnt, sizeof(run_cnt));
+    run_order_cnt = 0;
+
+    env_timer_cnt = 0;
+    lv_timer_t * t = lv_timer_get_next(NULL);
+    while(t && env_timer_cnt < sizeof(env_timers) / sizeof(env_timers[0])) {
+        if(!t->paused) {
+            lv_timer_pause(t);
+            env_timers[env_timer_cnt++] = t;
+        }
+        t = lv_timer_get_next(t);
+    }
+}
+
+void tearDown(void)
+{
+    lv_anim_del_all();
+    uint32_t i;
+    for(i = 0; i < env_timer_cnt; i++) lv_timer_resume(env_timers[i]);
+    lv_obj_clean(lv_scr_act());
+}
+
+static void count_cb(lv_timer_t * t)
+{
+    uint32_t id = (lv_uintptr_t)t->user_data;
+    run_cnt[id]++;
+    if(run_order_cnt < sizeof(run_order) / sizeof(run_order[0])) run_order[run_order_cnt++] = id;
+}
+
+static void del_self_cb(lv_timer_t * t)
+{
+    count_cb(t);
+    lv_timer_del(t);
+}
+
+static lv_timer_t * other_timer;
+static void del_other_cb(lv_timer_t * t)
+{
+    count_cb(t);
+    if(other_timer) {
+        lv_timer_del(other_timer);
+        other_timer = NULL;
+    }
+}
+
+static void async_cb(void * user_data)
+{
+    run_cnt[(lv_uintptr_t)user_data]++;
+}
+
+static void create_async_cb(lv_timer_t * t)
+{
+    count_cb(t);
+    lv_async_call(async_cb, (void *)4);
+}
+
+/*Let `ms` milliseconds pass calling the handler in every millisecond*/
+static void run_ms(uint32_t ms)
+{
+    uint32_t i;
+    for(i = 0; i < ms; i++) {
+        lv_tick_inc(1);
+        lv_timer_handler();
+    }
+}
+
+void test_timer_order(void)
+{
+    lv_timer_t * t1 = lv_timer_create(count_cb, 30, (void *)1);
+    lv_timer_t * t2 = lv_timer_create(count_cb, 20, (void *)2);
+    lv_timer_t * t3 = lv_timer_create(count_cb, 50, (void *)3);
+
+    TEST_ASSERT_EQUAL_UINT32(20, lv_timer_get_time_until_next());
+    TEST_ASSERT_EQUAL_UINT32(20, lv_timer_handler());
+
+    run_ms(60);
+    TEST_ASSERT_EQUAL_UINT32(2, run_cnt[1]);
+    TEST_ASSERT_EQUAL_UINT32(3, run_cnt[2]);
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[3]);
+    /*20: t2, 30: t1, 40: t2, 50: t3, 60: t1 and t2*/
+    uint32_t order[] = {2, 1, 2, 3};
+    TEST_ASSERT_EQUAL_UINT32(6, run_order_cnt);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(order, run_order, 4);
+
+    /*A paused timer doesn't count*/
+    lv_timer_pause(t2);
+    lv_timer_pause(t2);
+    TEST_ASSERT_EQUAL_UINT32(30, lv_timer_get_time_until_next());
+    lv_timer_pause(t1);
+    lv_timer_pause(t3);
+    TEST_ASSERT_EQUAL_UINT32(LV_NO_TIMER_READY, lv_timer_get_time_until_next());
+    TEST_ASSERT_EQUAL_UINT32(LV_NO_TIMER_READY, lv_timer_handler());
+
+    /*Resuming after a long pause makes it ready*/
+    run_ms(100);
+    lv_timer_resume(t1);
+    lv_timer_resume(t1);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_timer_get_time_until_next());
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(3, run_cnt[1]);
+    TEST_ASSERT_EQUAL_UINT32(30, lv_timer_get_time_until_next());
+
+    lv_timer_del(t1);
+    lv_timer_del(t2);
+    lv_timer_del(t3);
+    TEST_ASSERT_EQUAL_UINT32(LV_NO_TIMER_READY, lv_timer_get_time_until_next());
+}
+
+void test_timer_change(void)
+{
+    lv_timer_t * t1 = lv_timer_create(count_cb, 100, (void *)1);
+    lv_timer_t * t2 = lv_timer_create(count_cb, 200, (void *)2);
+
+    lv_timer_set_period(t2, 50);
+    TEST_ASSERT_EQUAL_UINT32(50, lv_timer_get_time_until_next());
+
+    run_ms(40);
+    lv_timer_reset(t2);
+    TEST_ASSERT_EQUAL_UINT32(50, lv_timer_get_time_until_next());
+
+    lv_timer_ready(t1);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_timer_get_time_until_next());
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[1]);
+    TEST_ASSERT_EQUAL_UINT32(50, lv_timer_get_time_until_next());
+
+    /*Runs only once in a round even with 0 period*/
+    lv_timer_set_period(t1, 0);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(2, run_cnt[1]);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(3, run_cnt[1]);
+
+    lv_timer_set_repeat_count(t1, 2);
+    run_ms(10);
+    TEST_ASSERT_EQUAL_UINT32(5, run_cnt[1]);
+    TEST_ASSERT_EQUAL_UINT32(40, lv_timer_get_time_until_next());
+
+    lv_timer_del(t2);
+}
+
+void test_timer_del_in_cb(void)
+{
+    lv_timer_create(del_self_cb, 10, (void *)1);
+    lv_timer_t * t2 = lv_timer_create(del_other_cb, 10, (void *)2);
+    other_timer = lv_timer_create(count_cb, 10, (void *)3);
+    lv_timer_t * t4 = lv_timer_create(create_async_cb, 10, (void *)5);
+
+    run_ms(10);
+    /*Either t2 deleted t3 before it ran or t3 ran first*/
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[2]);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, run_cnt[3]);
+    TEST_ASSERT_NULL(other_timer);
+    /*The async call made in a timer runs in the same round*/
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[5]);
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[4]);
+
+    run_ms(10);
+    TEST_ASSERT_EQUAL_UINT32(1, run_cnt[1]);
+    TEST_ASSERT_EQUAL_UINT32(2, run_cnt[2]);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, run_cnt[3]);
+    TEST_ASSERT_EQUAL_UINT32(2, run_cnt[4]);
+
+    lv_timer_del(t2);
+    lv_timer_del(t4);
+    TEST_ASSERT_EQUAL_UINT32(LV_NO_TIMER_READY, lv_timer_get_time_until_next());
+}
+
+static uint32_t anim_exec_cnt;
+static uint32_t anim_ready_cnt;
+
+static void anim_exec_cb(void * var, int32_t v)
+{
+    LV_UNUSED(var);
+    LV_UNUSED(v);
+    anim_exec_cnt++;
+}
+
+static void anim_ready_cb(lv_anim_t * a)
+{
+    anim_ready_cnt++;
+    /*Delete the next animation too, the iteration needs to continue well*/
+    lv_anim_del((uint8_t *)a->var - 1, NULL);
+}
+
+/*The test ticks are incremented manually, so measure the real time*/
+static uint32_t time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000000 + tv.tv_usec);
+}
+
+void test_timer_anim_del_in_ready_cb(void)
+{
+    static uint8_t vars[10];
+    uint32_t i;
+    for(i = 0; i < 10; i++) {
+        lv_anim_t a;
+        lv_anim_init(&a);
+        lv_anim_set_var(&a, &vars[i]);
+        lv_anim_set_exec_cb(&a, anim_exec_cb);
+        lv_anim_set_ready_cb(&a, anim_ready_cb);
+        lv_anim_set_time(&a, 100);
+        lv_anim_start(&a);
+    }
+
+    anim_ready_cnt = 0;
+    run_ms(200);
+    /*The animations are handled from the last started and each ready one deletes the next one*/
+    TEST_ASSERT_EQUAL_UINT32(5, anim_ready_cnt);
+    TEST_ASSERT_EQUAL_UINT16(0, lv_anim_count_running());
+    TEST_ASSERT_TRUE(lv_anim_get_timer()->paused);
+}
+
+void test_timer_benchmark(void)
+{
+    static uint8_t vars[BENCH_CNT];
+    lv_timer_t ** timers = lv_mem_alloc(BENCH_CNT * sizeof(lv_timer_t *));
+    TEST_ASSERT_NOT_NULL(timers);
+
+    uint32_t i;
+    for(i = 0; i < BENCH_CNT; i++) {
+        /*100 ms ... 10 s*/
+        timers[i] = lv_timer_create(count_cb, 100 + (i * 7919) % 9900, (void *)0);
+    }
+
+    /*Idle calls: nothing is ready*/
+    uint32_t t = time_us();
+    for(i = 0; i < 10000; i++) lv_timer_handler();
+    t = time_us() - t;
+    printf("timer: %d timers, idle lv_timer_handler() %5"LV_PRIu32" ns\n", BENCH_CNT, t / 10);
+
+    /*Simulate 10 seconds with a call in every millisecond*/
+    t = time_us();
+    run_ms(10000);
+    t = time_us() - t;
+    printf("timer: %d timers, 10 s in 1 ms steps %7"LV_PRIu32" us, %"LV_PRIu32" runs\n", BENCH_CNT, t, run_cnt[0]);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(BENCH_CNT, run_cnt[0]);
+
+    for(i = 0; i < BENCH_CNT; i++) lv_timer_del(timers[i]);
+    lv_mem_free(timers);
+
+    /*Animations with different delays and times*/
+    anim_exec_cnt = 0;
+    for(i = 0; i < BENCH_CNT; i++) {
+        lv_anim_t a;
+        lv_anim_init(&a);
+        lv_anim_set_var(&a, &vars[i]);
+        lv_anim_set_exec_cb(&a, anim_exec_cb);
+        lv_anim_set_values(&a, 0, 10000);
+        lv_anim_set_time(&a, 200 + i % 800);
+        lv_anim_set_delay(&a, i % 500);
+        lv_anim_start(&a);
+    }
+    TEST_ASSERT_EQUAL_UINT16(BENCH_CNT, lv_anim_count_running());
+
+    t = time_us();
+    run_ms(1600);
+    t = time_us() - t;
+    printf("timer: %d animations, 1.6 s in 1 ms steps %7"LV_PRIu32" us, %"LV_PRIu32" updates\n", BENCH_CNT, t,
+           anim_exec_cnt);
+    TEST_ASSERT_EQUAL_UINT16(0, lv_anim_count_running());
+}
+
+#endif
@@ -0,0 +1,287 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#if LV_USE_VLIST
+
+static lv_obj_t * vlist;
+static uint32_t bind_cnt;
+
+void setUp(void)
+{
+    bind_cnt = 0;
+    vlist = lv_vlist_create(lv_scr_act());
+    lv_obj_set_size(vlist, 300, 400);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+static lv_obj_t * create_row(lv_obj_t * list)
+{
+    lv_obj_t * btn = lv_btn_create(list);
+    lv_obj_set_width(btn, lv_pct(100));
+    lv_label_create(btn);
+    return btn;
+}
+
+static void bind_row(lv_obj_t * list, lv_obj_t * row, uint32_t index)
+{
+    LV_UNUSED(list);
+    lv_label_set_text_fmt(lv_obj_get_child(row, 0), "Item %"LV_PRIu32, index);
+    bind_cnt++;
+}
+
+static lv_obj_t * create_tall_row(lv_obj_t * list)
+{
+    lv_obj_t * row = create_row(list);
+    lv_obj_set_height(row, 150);
+    return row;
+}
+
+/*Check that the visible items are on the rows with the right text and position*/
+static void check_rows(void)
+{
+    lv_obj_update_layout(vlist);
+
+    int32_t row_h = lv_vlist_get_row_height(vlist);
+    int32_t sy = lv_vlist_get_scroll_y(vlist);
+    int32_t top = vlist->coords.y1 + lv_obj_get_style_pad_top(vlist, LV_PART_MAIN) +
+                  lv_obj_get_style_border_width(vlist, LV_PART_MAIN);
+
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(vlist); i++) {
+        lv_obj_t * row = lv_obj_get_child(vlist, i);
+        if(lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN)) continue;
+
+        uint32_t id = lv_vlist_get_row_index(vlist, row);
+        TEST_ASSERT_NOT_EQUAL(LV_VLIST_ROW_NONE, id);
+        TEST_ASSERT_LESS_THAN_UINT32(lv_vlist_get_row_cnt(vlist), id);
+
+        char buf[32];
+        lv_snprintf(buf, sizeof(buf), "Item %"LV_PRIu32, id);
+        TEST_ASSERT_EQUAL_STRING(buf, lv_label_get_text(lv_obj_get_child(row, 0)));
+        TEST_ASSERT_EQUAL_INT32(top + (int32_t)id * row_h - sy, row->coords.y1);
+    }
+
+    /*All visible items have a row*/
+    int32_t first = LV_MAX(sy, 0) / row_h;
+    int32_t last = (sy + lv_obj_get_content_height(vlist) - 1) / row_h;
+    last = LV_MIN(last, (int32_t)lv_vlist_get_row_cnt(vlist) - 1);
+    int32_t id;
+    for(id = first; id <= last; id++) {
+        TEST_ASSERT_NOT_NULL(lv_vlist_get_row(vlist, id));
+    }
+}
+
+void test_vlist_bind(void)
+{
+    lv_vlist_set_row_cb(vlist, create_row, bind_row);
+    lv_vlist_set_row_cnt(vlist, 100);
+    lv_obj_update_layout(vlist);
+
+    lv_coord_t row_h = lv_vlist_get_row_height(vlist);
+    TEST_ASSERT_GREATER_THAN(0, row_h);
+    TEST_ASSERT_EQUAL_UINT32(lv_obj_get_content_height(vlist) / row_h + 2, lv_vlist_get_pool_size(vlist));
+    TEST_ASSERT_EQUAL_UINT32(lv_vlist_get_pool_size(vlist), lv_obj_get_child_cnt(vlist));
+    check_rows();
+
+    /*Scrolling by less than a row doesn't bind anything*/
+    bind_cnt = 0;
+    lv_obj_scroll_by(vlist, 0, -row_h / 3, LV_ANIM_OFF);
+    check_rows();
+    TEST_ASSERT_EQUAL_UINT32(0, bind_cnt);
+
+    /*Scrolling by a row binds only one row*/
+    lv_obj_scroll_by(vlist, 0, -row_h, LV_ANIM_OFF);
+    check_rows();
+    TEST_ASSERT_EQUAL_UINT32(1, bind_cnt);
+
+    uint32_t i;
+    for(i = 0; i < 50; i++) {
+        lv_obj_scroll_by(vlist, 0, -37, LV_ANIM_OFF);
+        check_rows();
+    }
+
+    for(i = 0; i < 80; i++) {
+        lv_obj_scroll_by(vlist, 0, 23, LV_ANIM_OFF);
+        check_rows();
+    }
+
+    lv_vlist_scroll_to_row(vlist, 99, LV_ANIM_OFF);
+    check_rows();
+    TEST_ASSERT_NOT_NULL(lv_vlist_get_row(vlist, 99));
+    TEST_ASSERT_NULL(lv_vlist_get_row(vlist, 0));
+}
+
+void test_vlist_refresh(void)
+{
+    lv_vlist_set_row_cb(vlist, create_row, bind_row);
+    lv_vlist_set_row_cnt(vlist, 1000);
+    lv_vlist_scroll_to_row(vlist, 500, LV_ANIM_OFF);
+    check_rows();
+
+    bind_cnt = 0;
+    lv_vlist_refresh_row(vlist, 501);
+    TEST_ASSERT_EQUAL_UINT32(1, bind_cnt);
+    lv_vlist_refresh_row(vlist, 10);
+    TEST_ASSERT_EQUAL_UINT32(1, bind_cnt);
+
+    bind_cnt = 0;
+    lv_vlist_refresh(vlist);
+    TEST_ASSERT_EQUAL_UINT32(lv_vlist_get_pool_size(vlist), bind_cnt);
+
+    /*Less items: scrolled back to the last one*/
+    lv_vlist_set_row_cnt(vlist, 20);
+    check_rows();
+    TEST_ASSERT_NOT_NULL(lv_vlist_get_row(vlist, 19));
+    TEST_ASSERT_EQUAL_INT32(20 * lv_vlist_get_row_height(vlist) - lv_obj_get_content_height(vlist),
+                            lv_vlist_get_scroll_y(vlist));
+
+    /*Less items than the rows fitting into the list*/
+    lv_vlist_set_row_cnt(vlist, 3);
+    check_rows();
+    TEST_ASSERT_EQUAL_INT32(0, lv_vlist_get_scroll_y(vlist));
+    TEST_ASSERT_EQUAL_UINT32(3, lv_vlist_get_pool_size(vlist));
+
+    lv_vlist_set_row_cnt(vlist, 0);
+    check_rows();
+    lv_vlist_set_row_cnt(vlist, 1000);
+    check_rows();
+    TEST_ASSERT_NOT_NULL(lv_vlist_get_row(vlist, 0));
+}
+
+void test_vlist_pool_size_is_constant(void)
+{
+    static const uint32_t row_cnts[] = {100, 10000, 1000000};
+    lv_vlist_set_row_cb(vlist, create_row, bind_row);
+
+    uint32_t pool_size = 0;
+    uint32_t i;
+    for(i = 0; i < sizeof(row_cnts) / sizeof(row_cnts[0]); i++) {
+        lv_obj_clean(lv_scr_act());
+        vlist = lv_vlist_create(lv_scr_act());
+        lv_obj_set_size(vlist, 300, 400);
+        lv_vlist_set_row_cb(vlist, create_row, bind_row);
+
+#if LV_MEM_CUSTOM == 0
+        lv_mem_monitor_t mon1;
+        lv_mem_monitor(&mon1);
+#endif
+        lv_vlist_set_row_cnt(vlist, row_cnts[i]);
+        lv_obj_update_layout(vlist);
+        lv_vlist_scroll_to_row(vlist, row_cnts[i] / 2, LV_ANIM_OFF);
+        check_rows();
+
+        if(i == 0) pool_size = lv_vlist_get_pool_size(vlist);
+        TEST_ASSERT_EQUAL_UINT32(pool_size, lv_vlist_get_pool_size(vlist));
+        TEST_ASSERT_EQUAL_UINT32(pool_size, lv_obj_get_child_cnt(vlist));
+
+#if LV_MEM_CUSTOM == 0
+        lv_mem_monitor_t mon2;
+        lv_mem_monitor(&mon2);
+        printf("vlist: %7"LV_PRIu32" items, %2"LV_PRIu32" rows, %6d bytes\n", row_cnts[i], pool_size,
+               (int)(mon1.free_size - mon2.free_size));
+#endif
+    }
+}
+
+void test_vlist_window(void)
+{
+    /*Higher than the coordinates can go: the scrolled window is moved*/
+    lv_vlist_set_row_cb(vlist, create_tall_row, bind_row);
+    lv_vlist_set_row_cnt(vlist, 1000000);
+    lv_obj_update_layout(vlist);
+    TEST_ASSERT_EQUAL_INT(150 + lv_obj_get_style_pad_row(vlist, LV_PART_MAIN), lv_vlist_get_row_height(vlist));
+
+    lv_vlist_scroll_to_row(vlist, 999999, LV_ANIM_OFF);
+    check_rows();
+    TEST_ASSERT_NOT_NULL(lv_vlist_get_row(vlist, 999999));
+
+    uint32_t i;
+    for(i = 0; i < 100; i++) {
+        lv_obj_scroll_by(vlist, 0, 131, LV_ANIM_OFF);
+        check_rows();
+    }
+
+    lv_vlist_scroll_to_row(vlist, 500000, LV_ANIM_OFF);
+    check_rows();
+    TEST_ASSERT_EQUAL_INT32(500000 * lv_vlist_get_row_height(vlist), lv_vlist_get_scroll_y(vlist));
+
+    for(i = 0; i < 100; i++) {
+        lv_obj_scroll_by(vlist, 0, (i & 1) ? 2000 : -1500, LV_ANIM_OFF);
+        check_rows();
+    }
+
+    lv_vlist_scroll_to_row(vlist, 0, LV_ANIM_OFF);
+    check_rows();
+    TEST_ASSERT_EQUAL_INT32(0, lv_vlist_get_scroll_y(vlist));
+}
+
+/*The test ticks are incremented manually, so measure the real time*/
+static uint32_t time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)(tv.tv_sec * 1000000 + tv.tv_usec);
+}
+
+/*Scroll a list by a few pixels in every frame*/
+static uint32_t scroll_frames(lv_obj_t * list, uint32_t frame_cnt)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    uint32_t i;
+    uint32_t t = time_us();
+    for(i = 0; i < frame_cnt; i++) {
+        lv_obj_scroll_by(list, 0, -7, LV_ANIM_OFF);
+        lv_refr_now(NULL);
+    }
+    return (time_us() - t) / frame_cnt;
+}
+
+void test_vlist_benchmark(void)
+{
+    uint32_t frame_cnt = 200;
+
+    uint32_t t = time_us();
+    lv_vlist_set_row_cb(vlist, create_row, bind_row);
+    lv_vlist_set_row_cnt(vlist, 10000);
+    lv_obj_update_layout(vlist);
+    t = time_us() - t;
+    uint32_t t_scroll = scroll_frames(vlist, frame_cnt);
+    printf("vlist: 10000 items, create %6"LV_PRIu32" us, scroll %5"LV_PRIu32" us/frame, %"LV_PRIu32" objects\n",
+           t, t_scroll, lv_obj_get_child_cnt(vlist));
+    lv_obj_del(vlist);
+
+    /*The same with a normal list having an object for each item*/
+    static const uint32_t item_cnts[] = {100, 1000};
+    uint32_t i;
+    for(i = 0; i < sizeof(item_cnts) / sizeof(item_cnts[0]); i++) {
+        t = time_us();
+        lv_obj_t * list = lv_list_create(lv_scr_act());
+        lv_obj_set_size(list, 300, 400);
+        uint32_t j;
+        for(j = 0; j < item_cnts[i]; j++) {
+            lv_obj_t * btn = create_row(list);
+            bind_row(list, btn, j);
+        }
+        lv_obj_update_layout(list);
+        t = time_us() - t;
+        t_scroll = scroll_frames(list, frame_cnt);
+        printf("list:  %5"LV_PRIu32" items, create %6"LV_PRIu32" us, scroll %5"LV_PRIu32" us/frame, %"LV_PRIu32" objects\n",
+               item_cnts[i], t, t_scroll, lv_obj_get_child_cnt(list));
+        lv_obj_del(list);
+    }
+}
+
+#endif
+
+#endif
@@ -85,4 +85,8 @@
 // Buffer size calculations for 16-bit color (2 bytes per pixel)
 #define LVGL_BUFFER_SIZE (PANEL_WIDTH * LVGL_BUFFER_LINES)
 
+// UI loop: longest sleep when LVGL has nothing to do, and how often the duty cycle is printed
+#define LVGL_MAX_SLEEP_MS 1000
+#define LVGL_STATS_PERIOD_MS 60000
+
 #endif // DISPLAY_CONFIG_H
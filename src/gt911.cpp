@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * GT911 touch controller implementation
+ ******************************************************************************/
+
+#include "gt911.h"
+
+bool Gt911::begin()
+{
+  uint8_t res[4];
+  if (!bus_.read(bus_.ctx, GT911_REG_RESOLUTION, res, sizeof(res)))
+    return false;
+
+  width_ = res[0] | (res[1] << 8);
+  height_ = res[2] | (res[3] << 8);
+  return true;
+}
+
+Gt911Result Gt911::read(Gt911Frame *frame)
+{
+  uint8_t burst[GT911_BURST_SIZE];
+  if (!bus_.read(bus_.ctx, GT911_REG_STATUS, burst, sizeof(burst)))
+    return GT911_ERROR;
+
+  return parse(burst, frame);
+}
+
+Gt911Result Gt911::poll(Gt911Frame *frame)
+{
+  uint8_t burst[GT911_BURST_SIZE];
+  if (!bus_.read(bus_.ctx, GT911_REG_STATUS, burst, 1))
+    return GT911_ERROR;
+  if (!(burst[0] & GT911_STATUS_READY))
+    return GT911_NO_DATA;
+
+  // Read only the touching points after the status
+  uint8_t count = burst[0] & GT911_STATUS_POINTS;
+  if (count > GT911_MAX_POINTS)
+    count = GT911_MAX_POINTS;
+  if (count && !bus_.read(bus_.ctx, GT911_REG_POINT_1, burst + 1, count * GT911_POINT_SIZE))
+    return GT911_ERROR;
+
+  return parse(burst, frame);
+}
+
+Gt911Result Gt911::parse(const uint8_t *burst, Gt911Frame *frame)
+{
+  uint8_t status = burst[0];
+  if (!(status & GT911_STATUS_READY))
+    return GT911_NO_DATA;
+
+  uint8_t count = status & GT911_STATUS_POINTS;
+  if (count > GT911_MAX_POINTS)
+    count = GT911_MAX_POINTS;
+
+  frame->count = count;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    const uint8_t *p = burst + 1 + i * GT911_POINT_SIZE;
+    frame->points[i].id = p[0];
+    frame->points[i].x = p[1] | (p[2] << 8);
+    frame->points[i].y = p[3] | (p[4] << 8);
+    frame->points[i].size = p[5] | (p[6] << 8);
+  }
+
+  // Let the controller write the next coordinates
+  uint8_t zero = 0;
+  if (!bus_.write(bus_.ctx, GT911_REG_STATUS, &zero, 1))
+    return GT911_ERROR;
+
+  return GT911_NEW_DATA;
+}
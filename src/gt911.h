@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * GT911 touch controller
+ *
+ * The status register and the 5 touch points follow each other in the register
+ * map, so after an interrupt everything is read in a single 41 byte burst and
+ * the status is cleared with one write: 2 I2C transactions per touch event
+ * instead of a status read, a read for each point and a write.
+ *
+ * The I2C bus is passed as callbacks so the driver can be tested on the host
+ * with a simulated register map.
+ ******************************************************************************/
+
+#ifndef GT911_H
+#define GT911_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GT911_ADDR1 0x5D
+#define GT911_ADDR2 0x14
+
+#define GT911_REG_RESOLUTION 0x8048 // x max low/high, y max low/high
+#define GT911_REG_STATUS 0x814E     // buffer ready bit, large touch bit, number of points
+#define GT911_REG_POINT_1 0x814F    // 8 bytes per point: id, x, y, size, reserved
+
+#define GT911_MAX_POINTS 5
+#define GT911_POINT_SIZE 8
+#define GT911_BURST_SIZE (1 + GT911_MAX_POINTS * GT911_POINT_SIZE)
+
+#define GT911_STATUS_READY 0x80
+#define GT911_STATUS_POINTS 0x0F
+
+// One I2C transaction each: the 16 bit register address and the data
+struct Gt911Bus
+{
+  void *ctx;
+  bool (*read)(void *ctx, uint16_t reg, uint8_t *buf, size_t len);
+  bool (*write)(void *ctx, uint16_t reg, const uint8_t *data, size_t len);
+};
+
+struct Gt911Point
+{
+  uint8_t id;
+  uint16_t x;
+  uint16_t y;
+  uint16_t size;
+};
+
+struct Gt911Frame
+{
+  uint8_t count; // number of touching points
+  Gt911Point points[GT911_MAX_POINTS];
+};
+
+enum Gt911Result
+{
+  GT911_ERROR = -1,
+  GT911_NO_DATA = 0, // the controller has no new coordinates yet
+  GT911_NEW_DATA = 1,
+};
+
+class Gt911
+{
+public:
+  explicit Gt911(const Gt911Bus &bus) : bus_(bus) {}
+
+  // Read the resolution set in the controller's configuration
+  bool begin();
+
+  // Read the status and all points in one burst. Use it after an interrupt.
+  Gt911Result read(Gt911Frame *frame);
+
+  // Read only the status and the points only if there are new ones.
+  // Cheaper than read() if most of the polls find nothing (no INT line).
+  Gt911Result poll(Gt911Frame *frame);
+
+  uint16_t width() const { return width_; }
+  uint16_t height() const { return height_; }
+
+private:
+  Gt911Result parse(const uint8_t *burst, Gt911Frame *frame);
+
+  Gt911Bus bus_;
+  uint16_t width_ = 0;
+  uint16_t height_ = 0;
+};
+
+#endif // GT911_H
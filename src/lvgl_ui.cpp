@@ -3,6 +3,9 @@
 #include <Arduino_GFX_Library.h>
 #include <esp_heap_caps.h>
 #include "display_config.h"
+#include "touch.h"
+#include "ui_runner.h"
+#include "metrics/metrics_server.h"
 
 static lv_obj_t *timer_label = nullptr;
 static int timer_seconds = 0;
@@ -21,6 +24,29 @@ static uint32_t my_tick_function(void)
   return millis();
 }
 
+// Clock of the UI runner's duty cycle measurement
+static uint32_t ui_clock_us(void)
+{
+  return micros();
+}
+
+// A timer was created or resumed (possibly from an other task), recompute the deadline
+static void ui_timer_resume_cb(void *data)
+{
+  ui_runner_notify(UI_EVENT_TIMER);
+}
+
+static uint32_t ui_last_report = 0;
+
+// Flush statistics of the current metrics period, only touched in the UI task
+static uint32_t flush_count = 0;
+static uint32_t flush_frames = 0;
+static uint32_t flush_pixels = 0;
+static uint32_t flush_us = 0;
+static uint32_t flush_max_us = 0;
+static uint32_t metrics_last = 0;
+static UiRunnerStats metrics_ui_last = {};
+
 // Updated flush callback for LVGL v9: no user_data argument, get user data from display
 void gfx_disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *color_p)
 {
@@ -28,11 +54,20 @@ void gfx_disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *color_p)
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
   uint16_t *rgb565_data = (uint16_t *)color_p;
+  uint32_t start = micros();
 #if (LV_COLOR_16_SWAP != 0)
   gfx->draw16bitBeRGBBitmap(area->x1, area->y1, rgb565_data, w, h);
 #else
   gfx->draw16bitRGBBitmap(area->x1, area->y1, rgb565_data, w, h);
 #endif
+  uint32_t elapsed = micros() - start;
+  flush_count++;
+  flush_pixels += w * h;
+  flush_us += elapsed;
+  if (elapsed > flush_max_us)
+    flush_max_us = elapsed;
+  if (lv_display_flush_is_last(disp))
+    flush_frames++;
   lv_display_flush_ready(disp);
 }
 
@@ -68,6 +103,14 @@ void lvgl_setup(Arduino_RGB_Display *gfx)
   lv_display_set_flush_cb(lvgl_display, gfx_disp_flush);
   lv_display_set_user_data(lvgl_display, gfx);
   lv_display_set_buffers(lvgl_display, disp_draw_buf1, disp_draw_buf2, LVGL_BUFFER_SIZE, LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+  // Sleep until the next LVGL deadline instead of polling
+  ui_runner_init(lv_timer_handler, ui_clock_us, LVGL_MAX_SLEEP_MS);
+  lv_timer_handler_set_resume_cb(ui_timer_resume_cb, nullptr);
+
+  // The touch task wakes up the UI loop with UI_EVENT_TOUCH
+  if (touch_init())
+    touch_create_indev();
   Serial.println("LVGL initialized with RGB parallel display driver (PARTIAL render mode for RGB parallel stability)!");
 }
 
@@ -115,7 +158,76 @@ void createUI()
   lv_obj_center(rect_label);
 }
 
+// Hand the UI fields of the period to the metrics server, which publishes
+// the snapshot for its clients without the UI waiting for them
+static void publish_metrics()
+{
+  uint32_t now = millis();
+  uint32_t period = now - metrics_last;
+  metrics_last = now;
+
+  // The runner stats are reset by the report, then the counters start over
+  UiRunnerStats ui;
+  ui_runner_get_stats(&ui);
+  uint32_t busy = ui.busy_us, total = ui.total_us;
+  if (total >= metrics_ui_last.total_us)
+  {
+    busy -= metrics_ui_last.busy_us;
+    total -= metrics_ui_last.total_us;
+  }
+  metrics_ui_last = ui;
+
+  MetricsSample sample = {};
+  sample.fps_x10 = period ? (flush_frames * 10000 + period / 2) / period : 0;
+  sample.flushes = flush_count;
+  sample.flush_pixels = flush_pixels;
+  sample.flush_us = flush_us;
+  sample.flush_max_us = flush_max_us;
+  sample.ui_duty = total ? (uint8_t)((uint64_t)busy * 100 / total) : 0;
+  metrics_server_publish(&sample);
+
+  flush_count = 0;
+  flush_frames = 0;
+  flush_pixels = 0;
+  flush_us = 0;
+  flush_max_us = 0;
+}
+
+static void set_backlight(void *arg)
+{
+  digitalWrite(TFT_BL, arg ? HIGH : LOW);
+}
+
+bool lvgl_ui_control(void *arg, const char *key, const char *value)
+{
+  if (strcmp(key, "backlight") == 0 && (strcmp(value, "0") == 0 || strcmp(value, "1") == 0))
+    return ui_runner_post(set_backlight, (void *)(uintptr_t)(value[0] == '1'));
+  return false;
+}
+
 void lvgl_ui_loop()
 {
-  lv_timer_handler();
+  // Runs LVGL and blocks until the next deadline or a touch/vsync/message event
+  uint32_t events = ui_runner_run_once();
+  if (events & UI_EVENT_TOUCH)
+    touch_handle_event();
+
+  if (millis() - metrics_last >= METRICS_PERIOD_MS)
+    publish_metrics();
+
+  if (millis() - ui_last_report >= LVGL_STATS_PERIOD_MS)
+  {
+    ui_last_report = millis();
+    UiRunnerStats stats;
+    ui_runner_get_stats(&stats);
+    Serial.printf("UI: %u wakeups (%u deadline, %u event), %u messages, duty cycle %u%%\n",
+                  stats.wakeups, stats.deadline_wakeups, stats.event_wakeups, stats.messages,
+                  stats.duty_percent);
+    TouchStats touch;
+    touch_get_stats(&touch);
+    Serial.printf("Touch: %u reads, %u events, %u coalesced, %u I2C errors\n",
+                  touch.reads, touch.events, touch.coalesced, touch.errors);
+    ui_runner_reset_stats();
+    metrics_ui_last = {};
+  }
 }
@@ -6,3 +6,5 @@ void lvgl_setup(Arduino_RGB_Display *gfx);
 void createUI();
 void lvgl_ui_loop();
 void gfx_disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *color_p);
+// Key=value pairs of POST /control (backlight=0|1), from the metrics server
+bool lvgl_ui_control(void *arg, const char *key, const char *value);
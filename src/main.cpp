@@ -5,6 +5,8 @@
 
 // Function declarations
 #include "lvgl_ui.h"
+#include "wifi/wifi_manager.h"
+#include "metrics/metrics_server.h"
 
 // Create RGB Panel databus and display with auto_flush enabled for stable sync
 Arduino_ESP32RGBPanel *rgbBus = new Arduino_ESP32RGBPanel(
@@ -55,13 +57,15 @@ void setup()
   // LVGL setup and UI rendering are now in ui.cpp
   lvgl_setup(gfx);
   createUI();
+
+  // Telemetry and control over HTTP, served from the AsyncTCP task
+  wifiManager.begin();
+  metrics_server_begin(lvgl_ui_control);
   Serial.println("Setup complete! Enjoying 40MHz RGB parallel performance!");
 }
 
 void loop()
 {
-  // Handle LVGL tasks with precise timing to prevent display tearing
+  // Handle LVGL tasks, then sleep until the next LVGL deadline or a UI event
   lvgl_ui_loop();
-  // Minimal delay optimized for 60Hz refresh rate synchronization
-  delay(1); // Very short delay to maintain display synchronization
 }
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Double buffered metrics block implementation
+ ******************************************************************************/
+
+#include "metrics_block.h"
+#include <stdio.h>
+#include <string.h>
+
+size_t metrics_serialize(const MetricsSample &s, uint32_t seq, char *out, size_t max)
+{
+  int len = snprintf(out, max,
+                     "{\"seq\":%u,\"uptime_ms\":%u,"
+                     "\"heap\":{\"free\":%u,\"min\":%u},"
+                     "\"psram\":{\"free\":%u,\"min\":%u},"
+                     "\"fps\":%u.%u,"
+                     "\"flush\":{\"count\":%u,\"pixels\":%u,\"us\":%u,\"max_us\":%u},"
+                     "\"ui_duty\":%u,\"audio_underruns\":%u,\"rssi\":%d}",
+                     (unsigned)seq, (unsigned)s.uptime_ms,
+                     (unsigned)s.heap_free, (unsigned)s.heap_min,
+                     (unsigned)s.psram_free, (unsigned)s.psram_min,
+                     (unsigned)(s.fps_x10 / 10), (unsigned)(s.fps_x10 % 10),
+                     (unsigned)s.flushes, (unsigned)s.flush_pixels, (unsigned)s.flush_us, (unsigned)s.flush_max_us,
+                     (unsigned)s.ui_duty, (unsigned)s.audio_underruns, (int)s.rssi);
+  if (len < 0 || (size_t)len >= max)
+    return 0;
+  return len;
+}
+
+void MetricsBlock::publish(const MetricsSample &sample)
+{
+  uint32_t count = _count.load(std::memory_order_relaxed);
+  Slot &slot = _slots[count & 1]; // the back buffer
+
+  uint32_t version = slot.version.load(std::memory_order_relaxed);
+  slot.version.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.len = metrics_serialize(sample, count + 1, slot.json, sizeof(slot.json));
+
+  slot.version.store(version + 2, std::memory_order_release);
+  _count.store(count + 1, std::memory_order_release);
+}
+
+size_t MetricsBlock::read(char *out, size_t max, uint32_t *seq) const
+{
+  while (true)
+  {
+    uint32_t count = _count.load(std::memory_order_acquire);
+    if (count == 0)
+      return 0;
+
+    const Slot &slot = _slots[(count - 1) & 1];
+    uint32_t version = slot.version.load(std::memory_order_acquire);
+    if ((version & 1) == 0)
+    {
+      size_t len = slot.len;
+      if (len > max)
+        len = max;
+      memcpy(out, slot.json, len);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // The writer can publish twice between the loads of _count and the
+      // version: the copy is then a newer snapshot than count
+      if (slot.version.load(std::memory_order_relaxed) == version &&
+          _count.load(std::memory_order_acquire) == count)
+      {
+        *seq = count;
+        return len;
+      }
+    }
+    _retries.fetch_add(1, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Double buffered metrics block
+ *
+ * The UI task samples the device state once a period, serializes it to JSON
+ * into the back buffer and flips the buffers. The metrics server reads the
+ * front buffer from its own task: there is no lock, nothing is serialized per
+ * request and a slow reader never holds up the UI.
+ *
+ * Each buffer has a version (odd while it is written). A reader which was so
+ * slow that the writer came around to its buffer sees the version change, or
+ * the snapshot count move, and copies again.
+ ******************************************************************************/
+
+#ifndef METRICS_BLOCK_H
+#define METRICS_BLOCK_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#define METRICS_JSON_MAX 384 // longest serialized snapshot
+
+struct MetricsSample
+{
+  uint32_t uptime_ms;
+  uint32_t heap_free;       // internal RAM [bytes]
+  uint32_t heap_min;        // lowest free internal RAM since boot
+  uint32_t psram_free;
+  uint32_t psram_min;
+  uint16_t fps_x10;         // frames per second * 10, over the last period
+  uint32_t flushes;         // flush calls in the last period
+  uint32_t flush_pixels;    // pixels sent to the panel in the last period
+  uint32_t flush_us;        // time spent flushing in the last period
+  uint32_t flush_max_us;    // longest flush in the last period
+  uint8_t ui_duty;          // UI loop duty cycle [%]
+  uint32_t audio_underruns; // since boot
+  int8_t rssi;              // [dBm], 0: not connected
+};
+
+// Serialize a sample, returns the length (0 if it doesn't fit)
+size_t metrics_serialize(const MetricsSample &sample, uint32_t seq, char *out, size_t max);
+
+class MetricsBlock
+{
+public:
+  // Called by one task only (the UI task)
+  void publish(const MetricsSample &sample);
+
+  // Copy of the newest snapshot, any task. Returns its length, 0 if nothing
+  // was published yet. seq gets the number of the snapshot (1, 2, ...).
+  size_t read(char *out, size_t max, uint32_t *seq) const;
+
+  // Number of the newest snapshot, 0: none yet
+  uint32_t sequence() const { return _count.load(std::memory_order_acquire); }
+
+  // Copies repeated because the writer overtook the reader
+  uint32_t retries() const { return _retries.load(std::memory_order_relaxed); }
+
+private:
+  struct Slot
+  {
+    std::atomic<uint32_t> version{0}; // odd while written
+    uint16_t len = 0;
+    char json[METRICS_JSON_MAX];
+  };
+
+  Slot _slots[2];
+  std::atomic<uint32_t> _count{0}; // published snapshots, the newest is in slot (count - 1) & 1
+  mutable std::atomic<uint32_t> _retries{0};
+};
+
+#endif // METRICS_BLOCK_H
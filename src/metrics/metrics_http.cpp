@@ -0,0 +1,404 @@
+/*******************************************************************************
+ * HTTP connection of the metrics server implementation
+ ******************************************************************************/
+
+#include "metrics_http.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Longest response: the headers and a snapshot. A request is only parsed
+// when its response fits into the output buffer.
+#define RESPONSE_MAX (192 + METRICS_JSON_MAX)
+// Chunk of a stream: size line, snapshot, newline, CRLF
+#define CHUNK_HEAD 6
+#define CHUNK_MAX (CHUNK_HEAD + METRICS_JSON_MAX + 3)
+
+static const char *statusText(int status)
+{
+  switch (status)
+  {
+  case 200:
+    return "OK";
+  case 204:
+    return "No Content";
+  case 400:
+    return "Bad Request";
+  case 404:
+    return "Not Found";
+  case 405:
+    return "Method Not Allowed";
+  case 431:
+    return "Request Header Fields Too Large";
+  case 501:
+    return "Not Implemented";
+  case 503:
+    return "Service Unavailable";
+  default:
+    return "HTTP Version Not Supported";
+  }
+}
+
+// Token of a comma separated header value, case insensitive
+static bool hasToken(const char *value, const char *token)
+{
+  size_t len = strlen(token);
+  while (*value)
+  {
+    while (*value == ' ' || *value == '\t' || *value == ',')
+      value++;
+    if (strncasecmp(value, token, len) == 0 && (value[len] == '\0' || value[len] == ',' || value[len] == ' '))
+      return true;
+    while (*value && *value != ',')
+      value++;
+  }
+  return false;
+}
+
+void MetricsHttpConnection::begin(const MetricsSink &sink, const MetricsBlock *block,
+                                  metrics_control_cb_t control, void *control_arg)
+{
+  _sink = sink;
+  _block = block;
+  _control = control;
+  _controlArg = control_arg;
+  _inLen = 0;
+  _bodyLeft = 0;
+  _outStart = 0;
+  _outLen = 0;
+  _streaming = false;
+  _chunked = false;
+  _closing = false;
+  _closed = false;
+  _lastSeq = 0;
+  _requests = 0;
+  _chunks = 0;
+}
+
+void MetricsHttpConnection::receive(const char *data, size_t len)
+{
+  // Nothing is read after a stream started or the connection is closing
+  while (len > 0 && !_streaming && !_closing)
+  {
+    size_t take = sizeof(_in) - _inLen;
+    if (take == 0)
+    {
+      // The client keeps sending requests but doesn't read the responses
+      _closing = true;
+      break;
+    }
+    if (take > len)
+      take = len;
+    memcpy(_in + _inLen, data, take);
+    _inLen += take;
+    data += take;
+    len -= take;
+    parse();
+  }
+  send();
+}
+
+void MetricsHttpConnection::flush()
+{
+  send();
+  if (_streaming && !_closing)
+  {
+    if (appendChunk())
+      send();
+  }
+  else if (!_closing && _inLen > 0)
+  {
+    // Requests which waited for room in the output buffer
+    parse();
+    send();
+  }
+}
+
+void MetricsHttpConnection::parse()
+{
+  while (!_streaming && !_closing)
+  {
+    size_t used = 0;
+    if (_bodyLeft > 0)
+    {
+      used = _bodyLeft < _inLen ? _bodyLeft : _inLen;
+      _bodyLeft -= used;
+    }
+    else
+    {
+      if (room() < RESPONSE_MAX)
+        return;
+
+      char *end = nullptr;
+      for (size_t i = 3; i < _inLen; i++)
+      {
+        if (memcmp(_in + i - 3, "\r\n\r\n", 4) == 0)
+        {
+          end = _in + i - 3;
+          break;
+        }
+      }
+      if (!end)
+      {
+        if (_inLen == sizeof(_in))
+          fail(431);
+        return;
+      }
+
+      *end = '\0';
+      used = end - _in + 4;
+      handleRequest(_in);
+    }
+
+    if (used == 0)
+      return;
+    _inLen -= used;
+    memmove(_in, _in + used, _inLen);
+  }
+}
+
+void MetricsHttpConnection::handleRequest(char *head)
+{
+  _requests++;
+
+  // Request line
+  char *line_end = strstr(head, "\r\n");
+  char *headers = nullptr;
+  if (line_end)
+  {
+    *line_end = '\0';
+    headers = line_end + 2;
+  }
+  char *method = head;
+  char *target = strchr(method, ' ');
+  char *version = target ? strchr(target + 1, ' ') : nullptr;
+  if (!version)
+  {
+    fail(400);
+    return;
+  }
+  *target++ = '\0';
+  *version++ = '\0';
+  if (strncmp(version, "HTTP/1.", 7) != 0)
+  {
+    fail(505);
+    return;
+  }
+  bool http11 = strcmp(version, "HTTP/1.0") != 0;
+  bool keepAlive = http11;
+
+  // Headers
+  while (headers && *headers)
+  {
+    char *next = strstr(headers, "\r\n");
+    if (next)
+    {
+      *next = '\0';
+      next += 2;
+    }
+    char *value = strchr(headers, ':');
+    if (value)
+    {
+      *value++ = '\0';
+      while (*value == ' ' || *value == '\t')
+        value++;
+
+      if (strcasecmp(headers, "Connection") == 0)
+      {
+        if (hasToken(value, "close"))
+          keepAlive = false;
+        else if (hasToken(value, "keep-alive"))
+          keepAlive = true;
+      }
+      else if (strcasecmp(headers, "Content-Length") == 0)
+      {
+        _bodyLeft = strtoul(value, nullptr, 10);
+      }
+      else if (strcasecmp(headers, "Transfer-Encoding") == 0)
+      {
+        // Request bodies are not used, don't bother with chunked ones
+        fail(501);
+        return;
+      }
+    }
+    headers = next;
+  }
+
+  char *query = strchr(target, '?');
+  if (query)
+    *query++ = '\0';
+
+  bool get = strcmp(method, "GET") == 0;
+  if (strcmp(target, "/metrics") == 0)
+  {
+    if (get)
+      respondSnapshot(keepAlive);
+    else
+      respond(405, nullptr, nullptr, 0, keepAlive);
+  }
+  else if (strcmp(target, "/metrics/stream") == 0)
+  {
+    if (get)
+      startStream(http11);
+    else
+      respond(405, nullptr, nullptr, 0, keepAlive);
+  }
+  else if (strcmp(target, "/control") == 0)
+  {
+    if (strcmp(method, "POST") != 0)
+      respond(405, nullptr, nullptr, 0, keepAlive);
+    else if (query && control(query))
+      respond(204, nullptr, nullptr, 0, keepAlive);
+    else
+      respond(400, nullptr, nullptr, 0, keepAlive);
+  }
+  else
+  {
+    respond(404, nullptr, nullptr, 0, keepAlive);
+  }
+}
+
+void MetricsHttpConnection::respond(int status, const char *type, const char *body, size_t bodyLen, bool keepAlive)
+{
+  char head[192];
+  int len = snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\n", status, statusText(status));
+  if (type)
+    len += snprintf(head + len, sizeof(head) - len, "Content-Type: %s\r\nCache-Control: no-store\r\n", type);
+  if (status != 204)
+    len += snprintf(head + len, sizeof(head) - len, "Content-Length: %u\r\n", (unsigned)bodyLen);
+  len += snprintf(head + len, sizeof(head) - len, "Connection: %s\r\n\r\n", keepAlive ? "keep-alive" : "close");
+
+  char *out = reserve(len + bodyLen);
+  if (out)
+  {
+    memcpy(out, head, len);
+    if (bodyLen)
+      memcpy(out + len, body, bodyLen);
+  }
+  if (!keepAlive)
+    _closing = true;
+}
+
+void MetricsHttpConnection::respondSnapshot(bool keepAlive)
+{
+  char json[METRICS_JSON_MAX];
+  uint32_t seq;
+  size_t len = _block ? _block->read(json, sizeof(json), &seq) : 0;
+  if (len == 0)
+    respond(503, nullptr, nullptr, 0, keepAlive); // nothing published yet
+  else
+    respond(200, "application/json", json, len, keepAlive);
+}
+
+void MetricsHttpConnection::startStream(bool http11)
+{
+  // One JSON object per line. HTTP/1.0 clients get the lines without the
+  // chunk framing, the end of the stream is the end of the connection.
+  const char *head = http11 ? "HTTP/1.1 200 OK\r\n"
+                              "Content-Type: application/x-ndjson\r\n"
+                              "Cache-Control: no-store\r\n"
+                              "Transfer-Encoding: chunked\r\n\r\n"
+                            : "HTTP/1.1 200 OK\r\n"
+                              "Content-Type: application/x-ndjson\r\n"
+                              "Cache-Control: no-store\r\n"
+                              "Connection: close\r\n\r\n";
+  size_t len = strlen(head);
+  memcpy(reserve(len), head, len);
+
+  _streaming = true;
+  _chunked = http11;
+  _lastSeq = 0;
+  appendChunk();
+}
+
+bool MetricsHttpConnection::appendChunk()
+{
+  uint32_t seq = _block ? _block->sequence() : 0;
+  if (seq == _lastSeq || room() < CHUNK_MAX)
+    return false;
+
+  // The snapshot is copied straight into the output buffer
+  size_t head = _chunked ? CHUNK_HEAD : 0;
+  char *out = reserve(CHUNK_MAX);
+  size_t len = _block->read(out + head, METRICS_JSON_MAX, &seq);
+  out[head + len] = '\n';
+  len++;
+  if (_chunked)
+  {
+    char size[CHUNK_HEAD + 1];
+    snprintf(size, sizeof(size), "%04x\r\n", (unsigned)len);
+    memcpy(out, size, CHUNK_HEAD);
+    memcpy(out + CHUNK_HEAD + len, "\r\n", 2);
+    len += CHUNK_HEAD + 2;
+  }
+  _outLen -= CHUNK_MAX - len; // give back what the chunk didn't use
+
+  _lastSeq = seq;
+  _chunks++;
+  return true;
+}
+
+bool MetricsHttpConnection::control(char *query)
+{
+  if (!_control || !*query)
+    return false;
+
+  bool ok = true;
+  while (query)
+  {
+    char *next = strchr(query, '&');
+    if (next)
+      *next++ = '\0';
+    char *value = strchr(query, '=');
+    if (value)
+      *value++ = '\0';
+    if (!_control(_controlArg, query, value ? value : ""))
+      ok = false;
+    query = next;
+  }
+  return ok;
+}
+
+void MetricsHttpConnection::fail(int status)
+{
+  const char *text = statusText(status);
+  respond(status, "text/plain", text, strlen(text), false);
+}
+
+char *MetricsHttpConnection::reserve(size_t len)
+{
+  if (room() < len)
+    return nullptr;
+  if (sizeof(_out) - _outLen < len)
+  {
+    // Move the pending bytes to the front
+    memmove(_out, _out + _outStart, _outLen - _outStart);
+    _outLen -= _outStart;
+    _outStart = 0;
+  }
+  char *p = _out + _outLen;
+  _outLen += len;
+  return p;
+}
+
+void MetricsHttpConnection::send()
+{
+  while (_outStart < _outLen)
+  {
+    size_t n = _sink.write(_sink.ctx, _out + _outStart, _outLen - _outStart);
+    if (n == 0)
+      break;
+    _outStart += n;
+  }
+  if (_outStart == _outLen)
+  {
+    _outStart = 0;
+    _outLen = 0;
+    if (_closing && !_closed)
+    {
+      _closed = true;
+      _sink.close(_sink.ctx);
+    }
+  }
+}
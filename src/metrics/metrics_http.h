@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * HTTP connection of the metrics server
+ *
+ * Parses the requests of one keep-alive connection and writes the responses
+ * to a sink: an AsyncClient on the ESP32, a socket in the host benchmark. It
+ * never blocks. What the sink doesn't take stays in the output buffer until
+ * the next flush() (on an ACK or a poll), and no further request is answered
+ * until there is room for its response.
+ *
+ *   GET  /metrics          newest snapshot
+ *   GET  /metrics/stream   chunked response, one chunk per new snapshot
+ *   POST /control?key=val  handed to the control callback (&-separated pairs)
+ *
+ * The snapshots are serialized by the publisher (see metrics_block.h), a
+ * request only copies the newest one into the output buffer.
+ ******************************************************************************/
+
+#ifndef METRICS_HTTP_H
+#define METRICS_HTTP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "metrics_block.h"
+
+#define METRICS_HTTP_MAX_REQUEST 512 // request line and headers, longer ones get a 431
+#define METRICS_HTTP_OUT_SIZE 2048   // responses waiting for the sink, room for a few snapshots
+
+struct MetricsSink
+{
+  void *ctx;
+  // Send data, returns how much was taken (may be less than len, or 0)
+  size_t (*write)(void *ctx, const char *data, size_t len);
+  // Close the connection once the written data is out
+  void (*close)(void *ctx);
+};
+
+// Handles one key=value pair of a control request, returns false if it was rejected.
+// Called in the task of the server.
+typedef bool (*metrics_control_cb_t)(void *arg, const char *key, const char *value);
+
+class MetricsHttpConnection
+{
+public:
+  void begin(const MetricsSink &sink, const MetricsBlock *block,
+             metrics_control_cb_t control = nullptr, void *control_arg = nullptr);
+
+  // Data received from the client
+  void receive(const char *data, size_t len);
+
+  // Send what is pending, then the newest snapshot to a stream or the
+  // answers of requests that waited for room. Call on ACK and poll.
+  void flush();
+
+  bool streaming() const { return _streaming; }
+  bool closing() const { return _closing; }
+  uint32_t requests() const { return _requests; }
+  uint32_t chunks() const { return _chunks; }
+
+private:
+  MetricsSink _sink;
+  const MetricsBlock *_block;
+  metrics_control_cb_t _control;
+  void *_controlArg;
+
+  char _in[METRICS_HTTP_MAX_REQUEST];
+  size_t _inLen;
+  size_t _bodyLeft; // body of the current request to skip
+  char _out[METRICS_HTTP_OUT_SIZE];
+  size_t _outStart;
+  size_t _outLen;
+
+  bool _streaming;
+  bool _chunked;
+  bool _closing; // no more requests, close when the output is out
+  bool _closed;
+  uint32_t _lastSeq; // newest snapshot sent to the stream
+  uint32_t _requests;
+  uint32_t _chunks;
+
+  void parse();
+  void handleRequest(char *head);
+  void respond(int status, const char *type, const char *body, size_t bodyLen, bool keepAlive);
+  void respondSnapshot(bool keepAlive);
+  void startStream(bool http11);
+  bool appendChunk();
+  bool control(char *query);
+  void fail(int status);
+  char *reserve(size_t len);
+  size_t room() const { return sizeof(_out) - (_outLen - _outStart); }
+  void send();
+};
+
+#endif // METRICS_HTTP_H
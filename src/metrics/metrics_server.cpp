@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * Metrics and control server implementation (AsyncTCP)
+ ******************************************************************************/
+
+#include "metrics_server.h"
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+#include <atomic>
+
+// Connection slots, only used in the AsyncTCP task
+struct MetricsClient
+{
+  AsyncClient *tcp; // nullptr: free
+  bool closeRequested;
+  MetricsHttpConnection http;
+};
+
+static AsyncServer *s_server = nullptr;
+static MetricsBlock s_block;
+static MetricsClient s_clients[METRICS_MAX_CLIENTS];
+static metrics_control_cb_t s_control = nullptr;
+static void *s_control_arg = nullptr;
+static MetricsServerStats s_stats;
+static std::atomic<uint32_t> s_underruns{0};
+
+// =============================================================================
+// Sink of the HTTP connections
+// =============================================================================
+
+static size_t clientWrite(void *ctx, const char *data, size_t len)
+{
+  AsyncClient *tcp = ((MetricsClient *)ctx)->tcp;
+  size_t space = tcp->space();
+  if (len > space)
+    len = space;
+  if (len == 0)
+    return 0;
+  return tcp->add(data, len); // copied, the connection's buffer is reused right away
+}
+
+static void clientClose(void *ctx)
+{
+  // Closing may free the client at once, it is done after the callback
+  ((MetricsClient *)ctx)->closeRequested = true;
+}
+
+// Push out what the connection added and close it if it asked for it
+static void clientSend(MetricsClient *c)
+{
+  AsyncClient *tcp = c->tcp;
+  tcp->send();
+  if (c->closeRequested)
+  {
+    c->closeRequested = false;
+    tcp->close();
+  }
+}
+
+// =============================================================================
+// AsyncTCP callbacks
+// =============================================================================
+
+static void onData(void *arg, AsyncClient *tcp, void *data, size_t len)
+{
+  MetricsClient *c = (MetricsClient *)arg;
+  uint32_t requests = c->http.requests();
+  c->http.receive((const char *)data, len);
+  s_stats.requests += c->http.requests() - requests;
+
+  // A stream client only reads
+  if (c->http.streaming())
+    tcp->setRxTimeout(0);
+  clientSend(c);
+}
+
+// On ACK and every 125 ms: pending output, new snapshots for the streams
+static void onFlush(MetricsClient *c)
+{
+  uint32_t chunks = c->http.chunks();
+  uint32_t requests = c->http.requests();
+  c->http.flush();
+  s_stats.chunks += c->http.chunks() - chunks;
+  s_stats.requests += c->http.requests() - requests;
+  clientSend(c);
+}
+
+static void onAck(void *arg, AsyncClient *tcp, size_t len, uint32_t time)
+{
+  onFlush((MetricsClient *)arg);
+}
+
+static void onPoll(void *arg, AsyncClient *tcp)
+{
+  onFlush((MetricsClient *)arg);
+}
+
+static void onTimeout(void *arg, AsyncClient *tcp, uint32_t time)
+{
+  tcp->close();
+}
+
+static void onDisconnect(void *arg, AsyncClient *tcp)
+{
+  MetricsClient *c = (MetricsClient *)arg;
+  c->tcp = nullptr;
+  delete tcp;
+}
+
+static void onClient(void *arg, AsyncClient *tcp)
+{
+  MetricsClient *c = nullptr;
+  for (int i = 0; i < METRICS_MAX_CLIENTS && !c; i++)
+  {
+    if (!s_clients[i].tcp)
+      c = &s_clients[i];
+  }
+  if (!c)
+  {
+    s_stats.refused++;
+    tcp->onDisconnect([](void *arg, AsyncClient *tcp) { delete tcp; }, nullptr);
+    tcp->close(true);
+    return;
+  }
+
+  s_stats.connections++;
+  c->tcp = tcp;
+  c->closeRequested = false;
+  c->http.begin({c, clientWrite, clientClose}, &s_block, s_control, s_control_arg);
+
+  tcp->setNoDelay(true);
+  tcp->setRxTimeout(METRICS_IDLE_TIMEOUT_S);
+  tcp->onData(onData, c);
+  tcp->onAck(onAck, c);
+  tcp->onPoll(onPoll, c);
+  tcp->onTimeout(onTimeout, c);
+  tcp->onDisconnect(onDisconnect, c);
+}
+
+// =============================================================================
+// Public functions
+// =============================================================================
+
+bool metrics_server_begin(metrics_control_cb_t control, void *control_arg, uint16_t port)
+{
+  if (s_server)
+    return true;
+
+  s_control = control;
+  s_control_arg = control_arg;
+  s_server = new AsyncServer(port);
+  s_server->onClient(onClient, nullptr);
+  s_server->begin();
+  Serial.printf("Metrics server on port %u\n", port);
+  return s_server->status() != 0;
+}
+
+void metrics_server_publish(MetricsSample *sample)
+{
+  sample->uptime_ms = millis();
+  sample->heap_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  sample->heap_min = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+  sample->psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+  sample->psram_min = heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM);
+  sample->audio_underruns = s_underruns.load(std::memory_order_relaxed);
+  sample->rssi = WiFi.status() == WL_CONNECTED ? WiFi.RSSI() : 0;
+  s_block.publish(*sample);
+}
+
+void metrics_server_count_audio_underrun()
+{
+  s_underruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+void metrics_server_get_stats(MetricsServerStats *stats)
+{
+  *stats = s_stats;
+  stats->retries = s_block.retries();
+}
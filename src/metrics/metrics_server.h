@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * Metrics and control server
+ *
+ * Serves the device telemetry over HTTP from the AsyncTCP task. The UI loop
+ * only publishes a sample once a period, which serializes it into the metrics
+ * block (a few 10 us), and never waits for the network. Keep-alive requests
+ * and streams are answered from the newest snapshot, see metrics_http.h.
+ *
+ *   curl http://<board>/metrics
+ *   curl -N http://<board>/metrics/stream
+ *   curl -X POST "http://<board>/control?backlight=0"
+ ******************************************************************************/
+
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <stdint.h>
+#include "metrics_block.h"
+#include "metrics_http.h"
+
+#define METRICS_SERVER_PORT 80
+#define METRICS_MAX_CLIENTS 4     // further connections are refused
+#define METRICS_IDLE_TIMEOUT_S 30 // keep-alive connections without a request are closed
+#define METRICS_PERIOD_MS 1000    // how often the UI loop publishes a sample
+
+struct MetricsServerStats
+{
+  uint32_t connections; // accepted since boot
+  uint32_t refused;     // all slots were taken
+  uint32_t requests;
+  uint32_t chunks;      // snapshots sent to streams
+  uint32_t retries;     // snapshot copies repeated because the UI loop overtook the reader
+};
+
+// Start listening (WiFi may still be connecting). control handles the
+// key=value pairs of POST /control, in the AsyncTCP task.
+bool metrics_server_begin(metrics_control_cb_t control = nullptr, void *control_arg = nullptr,
+                          uint16_t port = METRICS_SERVER_PORT);
+
+// Called by the UI task once a period with the UI fields of the sample filled
+// in, adds the heap, PSRAM, WiFi and audio fields and publishes it
+void metrics_server_publish(MetricsSample *sample);
+
+// The audio output ran dry, from any task
+void metrics_server_count_audio_underrun();
+
+void metrics_server_get_stats(MetricsServerStats *stats);
+
+#endif // METRICS_SERVER_H
@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * Lock-free single producer, single consumer queue
+ *
+ * One task pushes (e.g. the touch task), one task pops (e.g. the UI task).
+ * Neither side ever blocks or takes a lock, so it can be used between tasks
+ * of different priority without priority inversion.
+ ******************************************************************************/
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stdint.h>
+
+// N has to be a power of 2, N - 1 items can be stored
+template <typename T, uint32_t N>
+class SpscQueue
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "The size of the queue has to be a power of 2");
+
+public:
+  // Called only by the producer. Returns false if the queue is full.
+  bool push(const T &item)
+  {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    uint32_t next = (head + 1) & (N - 1);
+    if (next == tail_.load(std::memory_order_acquire))
+      return false;
+
+    items_[head] = item;
+    head_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Called only by the consumer. Returns false if the queue is empty.
+  bool pop(T *item)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+      return false;
+
+    *item = items_[tail];
+    tail_.store((tail + 1) & (N - 1), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const
+  {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+private:
+  T items_[N];
+  std::atomic<uint32_t> head_{0}; // next item to write, owned by the producer
+  std::atomic<uint32_t> tail_{0}; // next item to read, owned by the consumer
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * Touch input implementation: INT driven GT911 task and LVGL input device
+ ******************************************************************************/
+
+#include "touch.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "display_config.h"
+#include "gt911.h"
+#include "spsc_queue.h"
+#include "ui_runner.h"
+
+static uint8_t s_addr = GT911_ADDR1;
+static TaskHandle_t s_task = nullptr;
+static SpscQueue<TouchEvent, TOUCH_QUEUE_LEN> s_queue;
+static TouchStats s_stats;
+static lv_indev_t *s_indev = nullptr;
+static TouchEvent s_last = {0, 0, 0, 0, false};
+static const TouchFilterConfig s_filter_config = touch_filter_default_config(TOUCH_FILTER);
+static TouchFilter s_filter(s_filter_config);
+static lv_point_t s_point = {0, 0};
+
+// =============================================================================
+// I2C bus of the driver
+// =============================================================================
+
+static bool i2c_read(void *ctx, uint16_t reg, uint8_t *buf, size_t len)
+{
+  Wire.beginTransmission(s_addr);
+  Wire.write(reg >> 8);
+  Wire.write(reg & 0xFF);
+  // Repeated start: the address and the data are one transaction
+  if (Wire.endTransmission(false) != 0)
+    return false;
+  if (Wire.requestFrom(s_addr, (uint8_t)len) != len)
+    return false;
+  Wire.readBytes(buf, len);
+  return true;
+}
+
+static bool i2c_write(void *ctx, uint16_t reg, const uint8_t *data, size_t len)
+{
+  Wire.beginTransmission(s_addr);
+  Wire.write(reg >> 8);
+  Wire.write(reg & 0xFF);
+  Wire.write(data, len);
+  return Wire.endTransmission() == 0;
+}
+
+static Gt911 s_gt911({nullptr, i2c_read, i2c_write});
+
+// =============================================================================
+// Touch task
+// =============================================================================
+
+#if TOUCH_GT911_INT >= 0
+static void IRAM_ATTR touch_isr()
+{
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(s_task, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+#endif
+
+static TouchEvent frame_to_event(const Gt911Frame &frame, const TouchEvent &prev, uint32_t t_us)
+{
+  TouchEvent ev = prev;
+  ev.t_us = t_us;
+  ev.count = frame.count;
+  ev.pressed = frame.count > 0;
+  if (ev.pressed)
+  {
+    // Scale if the controller is configured to an other resolution than the panel
+    uint32_t x = frame.points[0].x;
+    uint32_t y = frame.points[0].y;
+    if (s_gt911.width() && s_gt911.width() != PANEL_WIDTH)
+      x = x * PANEL_WIDTH / s_gt911.width();
+    if (s_gt911.height() && s_gt911.height() != PANEL_HEIGHT)
+      y = y * PANEL_HEIGHT / s_gt911.height();
+    ev.x = x < PANEL_WIDTH ? x : PANEL_WIDTH - 1;
+    ev.y = y < PANEL_HEIGHT ? y : PANEL_HEIGHT - 1;
+  }
+  return ev;
+}
+
+static void touch_task(void *arg)
+{
+  TouchEvent ev = {0, 0, 0, 0, false};
+  bool pending = false;
+
+  while (true)
+  {
+    // Retry soon if the UI task hasn't made room in the queue yet
+    TickType_t wait = TOUCH_GT911_INT >= 0 ? portMAX_DELAY : pdMS_TO_TICKS(TOUCH_POLL_MS);
+    if (pending)
+      wait = pdMS_TO_TICKS(1);
+    ulTaskNotifyTake(pdTRUE, wait);
+
+    Gt911Frame frame;
+    uint32_t t_us = micros();
+    s_stats.reads++;
+    Gt911Result res = TOUCH_GT911_INT >= 0 ? s_gt911.read(&frame) : s_gt911.poll(&frame);
+    if (res == GT911_ERROR)
+      s_stats.errors++;
+
+    if (res == GT911_NEW_DATA)
+    {
+      // Keep only the newest state if the previous one is still waiting
+      if (pending)
+        s_stats.coalesced++;
+      ev = frame_to_event(frame, ev, t_us);
+      pending = true;
+#if TOUCH_TRACE
+      Serial.printf("%u,%u,%u,%u\n", ev.t_us, ev.x, ev.y, ev.pressed);
+#endif
+    }
+
+    if (pending && s_queue.push(ev))
+    {
+      pending = false;
+      s_stats.events++;
+      ui_runner_notify(UI_EVENT_TOUCH);
+    }
+  }
+}
+
+bool touch_init()
+{
+  Wire.begin(TOUCH_GT911_SDA, TOUCH_GT911_SCL, TOUCH_I2C_FREQ);
+
+  // The address depends on the INT level at reset, try both
+  if (!s_gt911.begin())
+  {
+    s_addr = GT911_ADDR2;
+    if (!s_gt911.begin())
+    {
+      Serial.println("GT911 not found");
+      return false;
+    }
+  }
+  Serial.printf("GT911 at 0x%02X, %ux%u\n", s_addr, s_gt911.width(), s_gt911.height());
+
+  xTaskCreatePinnedToCore(touch_task, "touch", 3072, nullptr, TOUCH_TASK_PRIORITY, &s_task, TOUCH_TASK_CORE);
+
+#if TOUCH_GT911_INT >= 0
+  pinMode(TOUCH_GT911_INT, INPUT);
+  attachInterrupt(digitalPinToInterrupt(TOUCH_GT911_INT), touch_isr, FALLING);
+#endif
+  return true;
+}
+
+// =============================================================================
+// LVGL input device
+// =============================================================================
+
+static void touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
+{
+  TouchEvent ev;
+  if (s_queue.pop(&ev))
+  {
+    s_last = ev;
+    if (ev.pressed)
+    {
+      TouchSample s = s_filter.update({ev.t_us, (float)ev.x, (float)ev.y});
+      // The older states are history (drag speed, gestures), only the newest
+      // one is shown: move it to where the finger will be on the next frame
+      if (s_queue.empty())
+        s = s_filter.predict(micros() + s_filter_config.predict_us);
+      s_point.x = LV_CLAMP(0, (int32_t)lroundf(s.x), PANEL_WIDTH - 1);
+      s_point.y = LV_CLAMP(0, (int32_t)lroundf(s.y), PANEL_HEIGHT - 1);
+    }
+    else
+    {
+      // Release where the finger was last shown, without extrapolating
+      s_filter.reset();
+    }
+  }
+
+  data->point = s_point;
+  data->state = s_last.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+  data->continue_reading = !s_queue.empty();
+
+  // Nothing to read until the next touch: stop waking up the UI loop.
+  // Keep reading while a scroll is being thrown after the release.
+  if (!s_last.pressed && s_queue.empty() && lv_indev_get_scroll_obj(indev) == nullptr)
+    lv_timer_pause(lv_indev_get_read_timer(indev));
+}
+
+lv_indev_t *touch_create_indev()
+{
+  s_indev = lv_indev_create();
+  lv_indev_set_type(s_indev, LV_INDEV_TYPE_POINTER);
+  lv_indev_set_read_cb(s_indev, touch_read_cb);
+  return s_indev;
+}
+
+void touch_handle_event()
+{
+  if (!s_indev)
+    return;
+
+  // Read right away instead of waiting for the read timer
+  lv_timer_resume(lv_indev_get_read_timer(s_indev));
+  lv_indev_read(s_indev);
+}
+
+void touch_get_stats(TouchStats *stats)
+{
+  *stats = s_stats;
+}
@@ -0,0 +1,62 @@
+/*******************************************************************************
+ * Touch input of the 5.0" board (GT911)
+ *
+ * A task reads the controller when its INT line fires (or polls it if the INT
+ * line is not connected) and pushes the touch states into a lock-free queue.
+ * The LVGL input device only pops from the queue, it never touches the I2C bus,
+ * and its read timer is paused while the screen is not touched. Every queued
+ * state is passed to LVGL, filtered and the newest one extrapolated to the time
+ * it will be on the panel.
+ ******************************************************************************/
+
+#ifndef TOUCH_H
+#define TOUCH_H
+
+#include <lvgl.h>
+#include <stdint.h>
+#include "touch_filter.h"
+
+// GT911 wiring
+#define TOUCH_GT911_SDA 19
+#define TOUCH_GT911_SCL 20
+#define TOUCH_GT911_INT -1 // GPIO of the INT line, -1: not connected, the touch task polls
+#define TOUCH_GT911_RST 38
+#define TOUCH_I2C_FREQ 400000
+
+#define TOUCH_POLL_MS 10      // polling period without INT line
+#define TOUCH_QUEUE_LEN 16    // touch states waiting for the UI task (power of 2)
+#define TOUCH_TASK_PRIORITY 5 // above the UI loop so a touch is read right away
+#define TOUCH_TASK_CORE 0
+
+#define TOUCH_FILTER TOUCH_FILTER_KALMAN // jitter filter and prediction, see touch_filter.h
+#define TOUCH_TRACE 0                    // 1: print the raw samples for the replay test
+
+struct TouchEvent
+{
+  uint32_t t_us; // time of the read
+  uint16_t x;
+  uint16_t y;
+  uint8_t count; // number of touching points
+  bool pressed;
+};
+
+struct TouchStats
+{
+  uint32_t reads;     // reads of the controller
+  uint32_t events;    // touch states pushed to the queue
+  uint32_t coalesced; // states replaced by a newer one while the queue was full
+  uint32_t errors;    // failed I2C transactions
+};
+
+// Start the touch task. Returns false if the controller doesn't answer.
+bool touch_init();
+
+// Create the LVGL input device reading the queue
+lv_indev_t *touch_create_indev();
+
+// Call in the UI task when it was woken by UI_EVENT_TOUCH
+void touch_handle_event();
+
+void touch_get_stats(TouchStats *stats);
+
+#endif // TOUCH_H
@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * Touch filter implementation
+ ******************************************************************************/
+
+#include "touch_filter.h"
+#include <math.h>
+
+// Samples further apart than this belong to a new stroke
+#define TOUCH_FILTER_MAX_DT 0.1f
+
+TouchFilterConfig touch_filter_default_config(TouchFilterMode mode)
+{
+  TouchFilterConfig config;
+  config.mode = mode;
+  config.min_cutoff = 1.5f;
+  config.beta = 0.02f;
+  config.d_cutoff = 5.0f;
+  config.accel_noise = 3000.0f;
+  config.meas_noise = 1.5f;
+  config.predict_us = 16000; // one refresh period
+  config.max_predict_us = 33000;
+  config.predict_speed = 200.0f;
+  return config;
+}
+
+// Smoothing factor of a first order low pass
+static float lowpass_alpha(float cutoff, float dt)
+{
+  float tau = 1.0f / (2.0f * (float)M_PI * cutoff);
+  return 1.0f / (1.0f + tau / dt);
+}
+
+void TouchFilter::start(Axis &a, float z)
+{
+  a.p = z;
+  a.v = 0;
+  a.raw = z;
+  a.lag = 0;
+  // Unknown speed: let the first samples set it
+  a.p00 = config_.meas_noise * config_.meas_noise;
+  a.p01 = 0;
+  a.p11 = 1000.0f * 1000.0f;
+}
+
+void TouchFilter::one_euro(Axis &a, float z, float dt)
+{
+  float dz = (z - a.raw) / dt;
+  a.raw = z;
+  a.v += lowpass_alpha(config_.d_cutoff, dt) * (dz - a.v);
+
+  float cutoff = config_.min_cutoff + config_.beta * fabsf(a.v);
+  float alpha = lowpass_alpha(cutoff, dt);
+  a.p += alpha * (z - a.p);
+  a.lag = dt * (1 - alpha) / alpha;
+}
+
+void TouchFilter::kalman(Axis &a, float z, float dt)
+{
+  // Predict with constant speed, the acceleration is white noise
+  float q = config_.accel_noise * config_.accel_noise;
+  float dt2 = dt * dt;
+  a.p += a.v * dt;
+  a.p00 += dt * (2 * a.p01 + dt * a.p11) + q * dt2 * dt2 / 4;
+  a.p01 += dt * a.p11 + q * dt2 * dt / 2;
+  a.p11 += q * dt2;
+
+  // Correct with the measured position
+  float s = a.p00 + config_.meas_noise * config_.meas_noise;
+  float k0 = a.p00 / s;
+  float k1 = a.p01 / s;
+  float err = z - a.p;
+  a.p += k0 * err;
+  a.v += k1 * err;
+  a.p11 -= k1 * a.p01;
+  a.p01 -= k1 * a.p00;
+  a.p00 -= k0 * a.p00;
+}
+
+TouchSample TouchFilter::update(const TouchSample &raw)
+{
+  float dt = (uint32_t)(raw.t_us - t_us_) / 1e6f;
+  if (!started_ || dt > TOUCH_FILTER_MAX_DT)
+  {
+    start(x_, raw.x);
+    start(y_, raw.y);
+    started_ = true;
+  }
+  else if (dt > 0)
+  {
+    switch (config_.mode)
+    {
+    case TOUCH_FILTER_ONE_EURO:
+      one_euro(x_, raw.x, dt);
+      one_euro(y_, raw.y, dt);
+      break;
+    case TOUCH_FILTER_KALMAN:
+      kalman(x_, raw.x, dt);
+      kalman(y_, raw.y, dt);
+      break;
+    default:
+      x_.v = (raw.x - x_.p) / dt;
+      y_.v = (raw.y - y_.p) / dt;
+      x_.p = raw.x;
+      y_.p = raw.y;
+      break;
+    }
+  }
+  t_us_ = raw.t_us;
+  return {t_us_, x_.p, y_.p};
+}
+
+TouchSample TouchFilter::predict(uint32_t t_us) const
+{
+  if (!started_ || config_.mode == TOUCH_FILTER_NONE)
+    return {t_us, x_.p, y_.p};
+
+  // Only forward and not too far: a wrong guess is worse than the lag
+  int32_t ahead = (int32_t)(t_us - t_us_);
+  if (ahead < 0)
+    ahead = 0;
+  if ((uint32_t)ahead > config_.max_predict_us)
+    ahead = config_.max_predict_us;
+
+  // A resting finger has some speed from the noise, don't amplify it
+  float speed2 = x_.v * x_.v + y_.v * y_.v;
+  float min2 = config_.predict_speed * config_.predict_speed;
+  float gain = min2 > 0 ? speed2 / (speed2 + min2) : 1.0f;
+
+  float dt = ahead / 1e6f;
+  return {t_us, x_.p + gain * x_.v * (dt + x_.lag), y_.p + gain * y_.v * (dt + y_.lag)};
+}
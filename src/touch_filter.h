@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * Touch filter: jitter filtering and prediction of the finger position
+ *
+ * The raw GT911 coordinates jitter by a few pixels while the finger rests and
+ * lag behind a moving finger by the time until the frame is on the panel.
+ * The filter smooths the timestamped samples (1-euro or Kalman filter) and
+ * extrapolates the position to the time the next frame will be displayed.
+ *
+ * Hardware independent so recorded traces can be replayed on the host.
+ ******************************************************************************/
+
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#include <stdint.h>
+
+enum TouchFilterMode
+{
+  TOUCH_FILTER_NONE,     // raw coordinates
+  TOUCH_FILTER_ONE_EURO, // low pass whose cutoff rises with the speed
+  TOUCH_FILTER_KALMAN,   // constant velocity model
+};
+
+struct TouchFilterConfig
+{
+  TouchFilterMode mode;
+  // 1-euro filter
+  float min_cutoff; // [Hz] cutoff at rest, lower: less jitter
+  float beta;       // cutoff increase per px/s, higher: less lag
+  float d_cutoff;   // [Hz] cutoff of the speed estimate
+  // Kalman filter
+  float accel_noise; // [px/s^2] how fast the finger can change its speed
+  float meas_noise;  // [px] standard deviation of the raw coordinates
+  // Prediction
+  uint32_t predict_us;     // from the read to the frame on the panel
+  uint32_t max_predict_us; // the extrapolation is limited to this horizon
+  float predict_speed;     // [px/s] slower than this the prediction fades out
+};
+
+struct TouchSample
+{
+  uint32_t t_us; // time of the read
+  float x;
+  float y;
+};
+
+// Default settings for the GT911 of the 5.0" board
+TouchFilterConfig touch_filter_default_config(TouchFilterMode mode);
+
+class TouchFilter
+{
+public:
+  explicit TouchFilter(const TouchFilterConfig &config) : config_(config) {}
+
+  // Call on release so the next press doesn't start from the old position
+  void reset() { started_ = false; }
+
+  // Feed a raw sample, returns the filtered position at the sample's time
+  TouchSample update(const TouchSample &raw);
+
+  // Position extrapolated from the last sample to t_us
+  TouchSample predict(uint32_t t_us) const;
+
+  float vx() const { return x_.v; }
+  float vy() const { return y_.v; }
+
+private:
+  // State of one axis
+  struct Axis
+  {
+    float p;             // position
+    float v;             // speed [px/s]
+    float p00, p01, p11; // covariance (Kalman)
+    float raw;           // previous raw position (1-euro)
+    float lag;           // [s] the position lags a steady motion by this (1-euro)
+  };
+
+  void start(Axis &a, float z);
+  void one_euro(Axis &a, float z, float dt);
+  void kalman(Axis &a, float z, float dt);
+
+  TouchFilterConfig config_;
+  bool started_ = false;
+  uint32_t t_us_ = 0;
+  Axis x_ = {};
+  Axis y_ = {};
+};
+
+#endif // TOUCH_FILTER_H
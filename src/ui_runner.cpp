@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * Event driven UI runner implementation
+ ******************************************************************************/
+
+#include "ui_runner.h"
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/queue.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#endif
+
+struct UiMessage
+{
+  ui_message_cb_t cb;
+  void *arg;
+};
+
+static ui_handler_cb_t s_handler = nullptr;
+static ui_clock_cb_t s_clock = nullptr;
+static uint32_t s_max_sleep_ms = UI_RUNNER_WAIT_FOREVER;
+static UiRunnerStats s_stats;
+static uint32_t s_stats_start = 0;
+
+// =============================================================================
+// Waiting for the events
+// =============================================================================
+
+#if defined(ESP_PLATFORM)
+
+static EventGroupHandle_t s_events = nullptr;
+static QueueHandle_t s_messages = nullptr;
+
+static void events_init()
+{
+  if (!s_events)
+    s_events = xEventGroupCreate();
+  if (!s_messages)
+    s_messages = xQueueCreate(UI_RUNNER_QUEUE_LEN, sizeof(UiMessage));
+}
+
+void ui_runner_notify(uint32_t events)
+{
+  xEventGroupSetBits(s_events, events & UI_EVENT_ALL);
+}
+
+void ui_runner_notify_from_isr(uint32_t events)
+{
+  BaseType_t woken = pdFALSE;
+  xEventGroupSetBitsFromISR(s_events, events & UI_EVENT_ALL, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+static bool message_push(const UiMessage &msg)
+{
+  return xQueueSend(s_messages, &msg, 0) == pdTRUE;
+}
+
+static bool message_pop(UiMessage *msg)
+{
+  return xQueueReceive(s_messages, msg, 0) == pdTRUE;
+}
+
+static uint32_t events_wait(uint32_t timeout_ms)
+{
+  TickType_t ticks = timeout_ms == UI_RUNNER_WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+  return xEventGroupWaitBits(s_events, UI_EVENT_ALL, pdTRUE, pdFALSE, ticks) & UI_EVENT_ALL;
+}
+
+#else
+
+// Host stand-in for the event group and the queue
+static std::mutex s_lock;
+static std::condition_variable s_cond;
+static uint32_t s_pending = 0;
+static std::deque<UiMessage> s_queue;
+
+static void events_init()
+{
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_pending = 0;
+  s_queue.clear();
+}
+
+void ui_runner_notify(uint32_t events)
+{
+  {
+    std::lock_guard<std::mutex> guard(s_lock);
+    s_pending |= events & UI_EVENT_ALL;
+  }
+  s_cond.notify_one();
+}
+
+void ui_runner_notify_from_isr(uint32_t events)
+{
+  ui_runner_notify(events);
+}
+
+static bool message_push(const UiMessage &msg)
+{
+  std::lock_guard<std::mutex> guard(s_lock);
+  if (s_queue.size() >= UI_RUNNER_QUEUE_LEN)
+    return false;
+  s_queue.push_back(msg);
+  return true;
+}
+
+static bool message_pop(UiMessage *msg)
+{
+  std::lock_guard<std::mutex> guard(s_lock);
+  if (s_queue.empty())
+    return false;
+  *msg = s_queue.front();
+  s_queue.pop_front();
+  return true;
+}
+
+static uint32_t events_wait(uint32_t timeout_ms)
+{
+  std::unique_lock<std::mutex> guard(s_lock);
+  auto ready = [] { return s_pending != 0; };
+  if (timeout_ms == UI_RUNNER_WAIT_FOREVER)
+    s_cond.wait(guard, ready);
+  else
+    s_cond.wait_for(guard, std::chrono::milliseconds(timeout_ms), ready);
+
+  uint32_t events = s_pending;
+  s_pending = 0;
+  return events;
+}
+
+#endif
+
+// =============================================================================
+// Runner
+// =============================================================================
+
+void ui_runner_init(ui_handler_cb_t handler, ui_clock_cb_t clock_us, uint32_t max_sleep_ms)
+{
+  s_handler = handler;
+  s_clock = clock_us;
+  s_max_sleep_ms = max_sleep_ms;
+  events_init();
+  ui_runner_reset_stats();
+}
+
+bool ui_runner_post(ui_message_cb_t cb, void *arg)
+{
+  UiMessage msg = {cb, arg};
+  if (!message_push(msg))
+    return false;
+
+  ui_runner_notify(UI_EVENT_MESSAGE);
+  return true;
+}
+
+uint32_t ui_runner_run_once()
+{
+  uint32_t start = s_clock();
+
+  // Handle the messages first so their changes are drawn right away
+  UiMessage msg;
+  while (message_pop(&msg))
+  {
+    msg.cb(msg.arg);
+    s_stats.messages++;
+  }
+
+  uint32_t next = s_handler();
+  s_stats.busy_us += s_clock() - start;
+
+  uint32_t timeout = next < s_max_sleep_ms ? next : s_max_sleep_ms;
+  uint32_t events = timeout == 0 ? 0 : events_wait(timeout);
+
+  s_stats.wakeups++;
+  if (events)
+    s_stats.event_wakeups++;
+  else
+    s_stats.deadline_wakeups++;
+
+  return events;
+}
+
+void ui_runner_get_stats(UiRunnerStats *stats)
+{
+  *stats = s_stats;
+  stats->total_us = s_clock() - s_stats_start;
+  stats->duty_percent = stats->total_us ? (uint64_t)stats->busy_us * 100 / stats->total_us : 0;
+}
+
+void ui_runner_reset_stats()
+{
+  s_stats = UiRunnerStats();
+  s_stats_start = s_clock();
+}
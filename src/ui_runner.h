@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * Event driven UI runner
+ *
+ * Runs the UI (lv_timer_handler) and then sleeps until the next LVGL deadline
+ * or until something wakes it up: touch interrupt, vsync, a queued UI message
+ * or a timer created from an other task.
+ *
+ * On the ESP32 it blocks on a FreeRTOS event group, on the host a condition
+ * variable stands in for it so the runner can be tested without hardware.
+ ******************************************************************************/
+
+#ifndef UI_RUNNER_H
+#define UI_RUNNER_H
+
+#include <stdint.h>
+
+#define UI_RUNNER_QUEUE_LEN 16 // UI messages which can wait to be handled
+#define UI_RUNNER_WAIT_FOREVER 0xFFFFFFFF
+
+// Events which wake up the UI loop
+enum UiEvent : uint32_t
+{
+  UI_EVENT_TOUCH = 1 << 0,   // touch controller interrupt
+  UI_EVENT_VSYNC = 1 << 1,   // frame sent to the panel
+  UI_EVENT_MESSAGE = 1 << 2, // message queued with ui_runner_post()
+  UI_EVENT_TIMER = 1 << 3,   // LVGL timer created or resumed
+  UI_EVENT_ALL = 0x0F
+};
+
+// Runs the UI and returns the time until it needs to run again in ms
+// (UI_RUNNER_WAIT_FOREVER if only an event can make it run)
+typedef uint32_t (*ui_handler_cb_t)(void);
+// Monotonic clock in microseconds
+typedef uint32_t (*ui_clock_cb_t)(void);
+// Function queued with ui_runner_post(), called in the UI task
+typedef void (*ui_message_cb_t)(void *arg);
+
+struct UiRunnerStats
+{
+  uint32_t wakeups;          // number of loop runs
+  uint32_t deadline_wakeups; // woken by the LVGL deadline
+  uint32_t event_wakeups;    // woken by an event
+  uint32_t messages;         // handled UI messages
+  uint32_t busy_us;          // time spent in the handler and the messages
+  uint32_t total_us;         // time since the stats were reset
+  uint8_t duty_percent;      // busy_us / total_us
+};
+
+// Set up the runner. max_sleep_ms limits the sleep even if LVGL has nothing to do.
+void ui_runner_init(ui_handler_cb_t handler, ui_clock_cb_t clock_us, uint32_t max_sleep_ms);
+
+// Wake up the UI task, from a task or from an interrupt
+void ui_runner_notify(uint32_t events);
+void ui_runner_notify_from_isr(uint32_t events);
+
+// Call a function in the UI task. Returns false if the queue is full.
+bool ui_runner_post(ui_message_cb_t cb, void *arg);
+
+// Run the UI once and sleep until the next deadline or event.
+// Returns the events which woke it up (0: the deadline).
+uint32_t ui_runner_run_once();
+
+void ui_runner_get_stats(UiRunnerStats *stats);
+void ui_runner_reset_stats();
+
+#endif // UI_RUNNER_H
@@ -18,7 +18,22 @@
 #define WIFI_TIMEOUT_MS 10000 // WiFi connection timeout (default: 10 seconds)
 #define WIFI_RETRY_ATTEMPTS 3 // Number of connection retry attempts
 
+// Reconnect settings
+#define WIFI_FAST_TIMEOUT_MS 1500 // Timeout of a connection with the cached BSSID/channel/IP
+#define WIFI_BACKOFF_MIN_MS 1000  // First retry delay, doubled after each failure
+#define WIFI_BACKOFF_MAX_MS 60000 // Longest retry delay
+#define WIFI_REUSE_IP false       // Reuse the last DHCP address as static IP (only with a reserved address)
+
+// Background scan and roaming
+#define WIFI_SCAN_INTERVAL_MS 60000      // Scan period while the signal is good
+#define WIFI_SCAN_FAST_INTERVAL_MS 10000 // Scan period while it is weak or not connected
+#define WIFI_MIN_RSSI -85                // Weaker APs are not used
+#define WIFI_ROAM_RSSI -70               // Look for a better AP below this signal
+#define WIFI_ROAM_HYSTERESIS_DB 8        // The better AP has to be this much stronger
+
 // Backup WiFi credentials (optional - useful for mobile hotspot fallback)
+// Stored with a lower priority on the first start, more networks can be added
+// with wifiManager.addNetwork()
 #define WIFI_BACKUP_SSID "BACKUP_WIFI_NAME"    // Optional backup WiFi network
 #define WIFI_BACKUP_PASSWORD "BACKUP_PASSWORD" // Optional backup WiFi password
 
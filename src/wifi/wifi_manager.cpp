@@ -3,90 +3,215 @@
  ******************************************************************************/
 
 #include "wifi_manager.h"
+#include <Preferences.h>
 #include "wifi_config.h" // Contains WiFi credentials
 
+// Settings added after the first wifi_config.h files were created
+#ifndef WIFI_FAST_TIMEOUT_MS
+#define WIFI_FAST_TIMEOUT_MS 1500 // Connection with the cached BSSID/channel/IP
+#endif
+#ifndef WIFI_BACKOFF_MIN_MS
+#define WIFI_BACKOFF_MIN_MS 1000 // First retry delay, doubled after each failure
+#endif
+#ifndef WIFI_BACKOFF_MAX_MS
+#define WIFI_BACKOFF_MAX_MS 60000
+#endif
+#ifndef WIFI_REUSE_IP
+#define WIFI_REUSE_IP false // Reuse the last DHCP address as static IP on reconnect (lease not renewed)
+#endif
+#ifndef WIFI_SCAN_INTERVAL_MS
+#define WIFI_SCAN_INTERVAL_MS 60000 // Background scan while the signal is good
+#endif
+#ifndef WIFI_SCAN_FAST_INTERVAL_MS
+#define WIFI_SCAN_FAST_INTERVAL_MS 10000 // ... while it is weak or not connected
+#endif
+#ifndef WIFI_SCAN_DWELL_MS
+#define WIFI_SCAN_DWELL_MS 120 // Passive listening time per channel
+#endif
+#ifndef WIFI_MIN_RSSI
+#define WIFI_MIN_RSSI -85 // Weaker APs are not used
+#endif
+#ifndef WIFI_ROAM_RSSI
+#define WIFI_ROAM_RSSI -70 // Look for a better AP below this signal
+#endif
+#ifndef WIFI_ROAM_HYSTERESIS_DB
+#define WIFI_ROAM_HYSTERESIS_DB 8 // The better AP has to be this much stronger
+#endif
+
+#define WIFI_NVS_NAMESPACE "wifi"
+#define WIFI_SCAN_TIME_MS (13 * WIFI_SCAN_DWELL_MS + 200) // channels 1-13 one after the other
+#define WIFI_SCAN_TASK_PRIORITY 1 // below the UI and the touch task
+
 // Global instance
 WiFiManager wifiManager;
 
+static const WiFiTimings wifiTimings = {WIFI_FAST_TIMEOUT_MS, WIFI_TIMEOUT_MS, WIFI_BACKOFF_MIN_MS,
+                                        WIFI_BACKOFF_MAX_MS};
+static const WiFiRoamParams roamParams = {WIFI_MIN_RSSI, WIFI_ROAM_RSSI, WIFI_ROAM_HYSTERESIS_DB};
+
 WiFiManager::WiFiManager()
+    : _sm({this, driverConnect, driverDisconnect, driverSave}, wifiTimings)
 {
-  _ssid = nullptr;
-  _password = nullptr;
-  _status = WIFI_DISCONNECTED;
-  _lastConnectionAttempt = 0;
-  _connectionTimeout = 10000; // 10 seconds timeout
-  _reconnectAttempts = 0;
+  memset(&_current, 0, sizeof(_current));
+  _started = false;
+  _lock = nullptr;
+  _timer = nullptr;
+  _scanTask = nullptr;
+  _scanCount = 0;
+  _scanTime = 0;
+  _scanned = false;
 }
 
 void WiFiManager::begin()
 {
-  // Use credentials from wifi_config.h
-  begin(WIFI_SSID, WIFI_PASSWORD);
-}
-
-void WiFiManager::begin(const char *ssid, const char *password)
-{
-  _ssid = ssid;
-  _password = password;
-
   Serial.println("=== WiFi Manager Initializing ===");
-  Serial.print("SSID: ");
-  Serial.println(_ssid);
 
-  // Set WiFi mode to station
+  if (!_lock)
+  {
+    _lock = xSemaphoreCreateMutex();
+    esp_timer_create_args_t args = {};
+    args.callback = onTimer;
+    args.arg = this;
+    args.name = "wifi";
+    esp_timer_create(&args, &_timer);
+    WiFi.onEvent(onEvent);
+    xTaskCreate(scanTask, "wifi_scan", 4096, this, WIFI_SCAN_TASK_PRIORITY, &_scanTask);
+  }
+
+  // The state machine does the reconnecting and the caching
+  WiFi.persistent(false);
+  WiFi.setAutoReconnect(false);
   WiFi.mode(WIFI_STA);
 
-  // Disconnect any previous connection
-  WiFi.disconnect();
-  delay(100);
+  Preferences prefs;
+  WiFiProfile stored[WIFI_MAX_PROFILES];
+  WiFiLink link;
+  String cachedSsid;
+  bool cached = false;
+  int count = 0;
+  if (prefs.begin(WIFI_NVS_NAMESPACE, true))
+  {
+    count = prefs.getBytes("profiles", stored, sizeof(stored)) / sizeof(WiFiProfile);
+    cachedSsid = prefs.getString("ssid");
+    cached = prefs.getBytes("link", &link, sizeof(link)) == sizeof(link);
+    prefs.end();
+  }
 
-  // Start connection attempt
-  connect();
-}
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  _profiles.load(stored, count);
+  if (_profiles.count() == 0)
+  {
+    // First start: the networks of wifi_config.h
+    _profiles.add(WIFI_SSID, WIFI_PASSWORD, 0);
+#ifdef WIFI_BACKUP_SSID
+    _profiles.add(WIFI_BACKUP_SSID, WIFI_BACKUP_PASSWORD, -10);
+#endif
+    saveProfiles();
+  }
+  for (int i = 0; i < _profiles.count(); i++)
+    Serial.printf("WiFi network %d: %s (priority %d)\n", i, _profiles.get(i).ssid, _profiles.get(i).priority);
 
-bool WiFiManager::connect()
-{
-  if (_status == WIFI_CONNECTING)
+  _started = true;
+  int p = _profiles.find(cachedSsid.c_str());
+  if (cached && p >= 0)
   {
-    return false; // Already trying to connect
+    // Join the AP of the last run right away
+    _current = _profiles.get(p);
+    _sm.start(millis(), &link);
+    armTimer();
   }
+  xSemaphoreGive(_lock);
+
+  // Otherwise the first scan chooses the network
+  requestScan();
+}
+
+void WiFiManager::begin(const char *ssid, const char *password)
+{
+  begin();
+  // Considered from the first scan on
+  addNetwork(ssid, password);
+}
+
+bool WiFiManager::addNetwork(const char *ssid, const char *password, int8_t priority)
+{
+  if (!_lock)
+    return false;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  bool ok = _profiles.add(ssid, password, priority);
+  if (ok)
+    saveProfiles();
+  xSemaphoreGive(_lock);
+  return ok;
+}
 
-  setStatus(WIFI_CONNECTING);
-  _lastConnectionAttempt = millis();
-  _reconnectAttempts++;
+bool WiFiManager::removeNetwork(const char *ssid)
+{
+  if (!_lock)
+    return false;
 
-  Serial.print("WiFi connecting to: ");
-  Serial.print(_ssid);
-  Serial.print(" (attempt ");
-  Serial.print(_reconnectAttempts);
-  Serial.println(")");
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  bool ok = _profiles.remove(ssid);
+  if (ok)
+    saveProfiles();
+  xSemaphoreGive(_lock);
+  return ok;
+}
 
-  WiFi.begin(_ssid, _password);
+int WiFiManager::getNetworks(WiFiProfile *profiles, int max)
+{
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  int count = _profiles.count() < max ? _profiles.count() : max;
+  memcpy(profiles, _profiles.data(), count * sizeof(WiFiProfile));
+  xSemaphoreGive(_lock);
+  return count;
+}
 
-  return true;
+// Called with the lock held
+void WiFiManager::saveProfiles()
+{
+  Preferences prefs;
+  if (!prefs.begin(WIFI_NVS_NAMESPACE, false))
+    return;
+  prefs.putBytes("profiles", _profiles.data(), _profiles.count() * sizeof(WiFiProfile));
+  prefs.end();
 }
 
 bool WiFiManager::isConnected()
 {
-  return WiFi.status() == WL_CONNECTED && _status == WIFI_CONNECTED;
+  return _sm.getState() == WIFI_SM_CONNECTED;
 }
 
 void WiFiManager::disconnect()
 {
-  WiFi.disconnect();
-  setStatus(WIFI_DISCONNECTED);
-  _reconnectAttempts = 0;
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  _started = false;
+  _sm.stop(millis());
+  armTimer();
+  xSemaphoreGive(_lock);
   Serial.println("WiFi disconnected");
 }
 
 WiFiStatus WiFiManager::getStatus()
 {
-  return _status;
+  switch (_sm.getState())
+  {
+  case WIFI_SM_FAST_CONNECT:
+  case WIFI_SM_CONNECT:
+    return WIFI_CONNECTING;
+  case WIFI_SM_CONNECTED:
+    return WIFI_CONNECTED;
+  case WIFI_SM_BACKOFF:
+    return WIFI_CONNECTION_FAILED;
+  default:
+    return WIFI_DISCONNECTED;
+  }
 }
 
 String WiFiManager::getStatusString()
 {
-  switch (_status)
+  switch (getStatus())
   {
   case WIFI_DISCONNECTED:
     return "Disconnected";
@@ -107,7 +232,7 @@ String WiFiManager::getSSID()
   {
     return WiFi.SSID();
   }
-  return String(_ssid ? _ssid : "N/A");
+  return String(_current.ssid[0] ? _current.ssid : "N/A");
 }
 
 String WiFiManager::getLocalIP()
@@ -128,75 +253,279 @@ int WiFiManager::getRSSI()
   return 0;
 }
 
-void WiFiManager::update()
+WiFiStats WiFiManager::getStats()
 {
-  wl_status_t wifiStatus = WiFi.status();
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  WiFiStats stats = _sm.getStats();
+  xSemaphoreGive(_lock);
+  return stats;
+}
 
-  switch (_status)
+// =============================================================================
+// Background scan and network selection
+// =============================================================================
+
+int WiFiManager::getScanResults(WiFiScanEntry *entries, int max)
+{
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  int count = _scanCount < max ? _scanCount : max;
+  memcpy(entries, _scan, count * sizeof(WiFiScanEntry));
+  xSemaphoreGive(_lock);
+  return count;
+}
+
+uint32_t WiFiManager::getScanAgeMs()
+{
+  return _scanned ? millis() - _scanTime : 0xFFFFFFFF;
+}
+
+void WiFiManager::requestScan()
+{
+  if (_scanTask)
+    xTaskNotifyGive(_scanTask);
+}
+
+void WiFiManager::scanTask(void *arg)
+{
+  WiFiManager *self = (WiFiManager *)arg;
+  WiFiScanEntry results[WIFI_MAX_SCAN];
+
+  while (true)
   {
-  case WIFI_CONNECTING:
-    if (wifiStatus == WL_CONNECTED)
+    // Look around more often when a better AP may be needed soon
+    bool good = self->isConnected() && WiFi.RSSI() >= WIFI_ROAM_RSSI;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(good ? WIFI_SCAN_INTERVAL_MS : WIFI_SCAN_FAST_INTERVAL_MS));
+
+    // Going off channel would disturb an attempt in progress or starting soon.
+    // Attempts which are due during the scan wait for its end.
+    xSemaphoreTake(self->_lock, portMAX_DELAY);
+    bool scan = self->_sm.scanStart(millis(), WIFI_SCAN_TIME_MS);
+    xSemaphoreGive(self->_lock);
+    if (!scan)
+      continue;
+
+    // Passive: only listens to the beacons, no probe requests
+    int16_t n = WiFi.scanNetworks(false, false, true, WIFI_SCAN_DWELL_MS);
+    int count = 0;
+    for (int16_t i = 0; i < n && count < WIFI_MAX_SCAN; i++)
     {
-      setStatus(WIFI_CONNECTED);
-      printConnectionInfo();
+      WiFiScanEntry &e = results[count++];
+      memset(&e, 0, sizeof(e));
+      strncpy(e.ssid, WiFi.SSID(i).c_str(), WIFI_SSID_LEN);
+      memcpy(e.bssid, WiFi.BSSID(i), sizeof(e.bssid));
+      e.channel = WiFi.channel(i);
+      e.rssi = WiFi.RSSI(i);
     }
-    else if (millis() - _lastConnectionAttempt > _connectionTimeout)
+    WiFi.scanDelete();
+
+    xSemaphoreTake(self->_lock, portMAX_DELAY);
+    self->_sm.scanEnd(millis());
+    if (n >= 0)
     {
-      // Connection timeout
-      if (_reconnectAttempts >= _maxReconnectAttempts)
-      {
-        setStatus(WIFI_CONNECTION_FAILED);
-        Serial.println("WiFi connection failed after maximum attempts");
-      }
-      else
-      {
-        // Try again
-        Serial.println("WiFi connection timeout, retrying...");
-        connect();
-      }
+      memcpy(self->_scan, results, count * sizeof(WiFiScanEntry));
+      self->_scanCount = count;
+      self->_scanTime = millis();
+      self->_scanned = true;
+      self->selectNetwork();
     }
-    break;
+    self->armTimer();
+    xSemaphoreGive(self->_lock);
+  }
+}
 
-  case WIFI_CONNECTED:
-    if (wifiStatus != WL_CONNECTED)
+// Called with the lock held after a scan
+void WiFiManager::selectNetwork()
+{
+  if (!_started)
+    return;
+
+  WiFiState state = _sm.getState();
+  WiFiScanEntry current;
+  const WiFiScanEntry *connected = nullptr;
+  if (state == WIFI_SM_CONNECTED)
+  {
+    memset(&current, 0, sizeof(current));
+    strncpy(current.ssid, _current.ssid, WIFI_SSID_LEN);
+    memcpy(current.bssid, WiFi.BSSID(), sizeof(current.bssid));
+    current.channel = WiFi.channel();
+    current.rssi = WiFi.RSSI();
+    connected = &current;
+  }
+  else if (state != WIFI_SM_IDLE && state != WIFI_SM_BACKOFF)
+  {
+    return;
+  }
+
+  WiFiChoice choice = wifiSelectNetwork(_profiles, _scan, _scanCount, connected, roamParams);
+  if (choice.entry < 0)
+  {
+    // No known AP seen (maybe hidden): try the preferred network the normal way
+    if (state == WIFI_SM_IDLE && _profiles.count() > 0)
     {
-      Serial.println("WiFi connection lost, attempting to reconnect...");
-      setStatus(WIFI_DISCONNECTED);
-      _reconnectAttempts = 0;
-      connect();
+      int best = 0;
+      for (int i = 1; i < _profiles.count(); i++)
+      {
+        if (_profiles.get(i).priority > _profiles.get(best).priority)
+          best = i;
+      }
+      _current = _profiles.get(best);
+      _sm.start(millis(), nullptr);
+      armTimer();
     }
+    return;
+  }
+
+  // The failed network is retried by the backoff
+  if (state == WIFI_SM_BACKOFF && strcmp(_profiles.get(choice.profile).ssid, _current.ssid) == 0)
+    return;
+
+  const WiFiScanEntry &e = _scan[choice.entry];
+  WiFiLink link = {};
+  memcpy(link.bssid, e.bssid, sizeof(link.bssid));
+  link.channel = e.channel;
+
+  if (state == WIFI_SM_CONNECTED)
+    Serial.printf("WiFi roaming from %d dBm to %s %d dBm\n", current.rssi, e.ssid, e.rssi);
+  _current = _profiles.get(choice.profile);
+  if (state == WIFI_SM_IDLE)
+    _sm.start(millis(), &link);
+  else
+    _sm.roam(millis(), link);
+  armTimer();
+}
+
+// =============================================================================
+// Events and deadline
+// =============================================================================
+
+// Called in the Arduino event task
+void WiFiManager::onEvent(arduino_event_id_t event, arduino_event_info_t info)
+{
+  WiFiManager *self = &wifiManager;
+  if (!self->_lock)
+    return;
+
+  switch (event)
+  {
+  case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+  {
+    WiFiLink link = {};
+    memcpy(link.bssid, WiFi.BSSID(), sizeof(link.bssid));
+    link.channel = WiFi.channel();
+    link.ip = info.got_ip.ip_info.ip.addr;
+    link.gateway = info.got_ip.ip_info.gw.addr;
+    link.subnet = info.got_ip.ip_info.netmask.addr;
+    link.dns = (uint32_t)WiFi.dnsIP();
+    if (!WIFI_REUSE_IP)
+      link.ip = 0;
+
+    xSemaphoreTake(self->_lock, portMAX_DELAY);
+    bool fast = self->_sm.getState() == WIFI_SM_FAST_CONNECT;
+    self->_sm.gotIP(millis(), link);
+    self->armTimer();
+    uint32_t ms = self->_sm.getStats().lastConnectMs;
+    xSemaphoreGive(self->_lock);
+
+    Serial.printf("WiFi connected in %u ms (%s)\n", ms, fast ? "cached link" : "scan");
+    self->printConnectionInfo();
     break;
+  }
 
-  case WIFI_CONNECTION_FAILED:
-    // Wait a bit before trying again
-    if (millis() - _lastConnectionAttempt > 30000)
-    { // Wait 30 seconds
-      Serial.println("Retrying WiFi connection after failure...");
-      _reconnectAttempts = 0;
-      connect();
-    }
+  case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+    // Our own disconnect() before the next attempt
+    if (info.wifi_sta_disconnected.reason == WIFI_REASON_ASSOC_LEAVE)
+      break;
+
+    Serial.printf("WiFi disconnected, reason %u\n", info.wifi_sta_disconnected.reason);
+    xSemaphoreTake(self->_lock, portMAX_DELAY);
+    self->_sm.disconnected(millis());
+    self->afterStateChange();
+    xSemaphoreGive(self->_lock);
     break;
 
-  case WIFI_DISCONNECTED:
-    // Auto-reconnect if we have credentials
-    if (_ssid && _password)
-    {
-      connect();
-    }
+  default:
     break;
   }
 }
 
-void WiFiManager::setStatus(WiFiStatus status)
+// Called in the esp_timer task when the attempt timed out or the backoff ended
+void WiFiManager::onTimer(void *arg)
 {
-  if (_status != status)
+  WiFiManager *self = (WiFiManager *)arg;
+  xSemaphoreTake(self->_lock, portMAX_DELAY);
+  self->_sm.timeout(millis());
+  self->afterStateChange();
+  WiFiState state = self->_sm.getState();
+  bool waiting = self->_sm.timeUntilDeadline(millis()) != WIFI_SM_NO_DEADLINE;
+  uint32_t backoff = self->_sm.getStats().backoffMs;
+  xSemaphoreGive(self->_lock);
+
+  if (state == WIFI_SM_BACKOFF)
   {
-    _status = status;
-    Serial.print("WiFi status changed to: ");
-    Serial.println(getStatusString());
+    if (waiting)
+      Serial.printf("WiFi connection failed, retrying in %u ms\n", backoff);
+    else
+      Serial.println("WiFi retrying after the scan");
   }
 }
 
+// Called with the lock held
+void WiFiManager::afterStateChange()
+{
+  armTimer();
+  // An other stored network may be in reach while this one is failing
+  if (_sm.getState() == WIFI_SM_BACKOFF)
+    requestScan();
+}
+
+// Called with the lock held
+void WiFiManager::armTimer()
+{
+  esp_timer_stop(_timer);
+  uint32_t ms = _sm.timeUntilDeadline(millis());
+  if (ms != WIFI_SM_NO_DEADLINE)
+    esp_timer_start_once(_timer, (ms ? ms : 1) * 1000ULL);
+}
+
+// =============================================================================
+// Driver of the state machine
+// =============================================================================
+
+void WiFiManager::driverConnect(void *ctx, const WiFiLink *link)
+{
+  WiFiManager *self = (WiFiManager *)ctx;
+  if (link)
+  {
+    // No scan: the AP is known. With the address of the last lease DHCP is skipped too.
+    if (link->ip)
+      WiFi.config(IPAddress(link->ip), IPAddress(link->gateway), IPAddress(link->subnet), IPAddress(link->dns));
+    else
+      WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    WiFi.begin(self->_current.ssid, self->_current.password, link->channel, link->bssid);
+  }
+  else
+  {
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    WiFi.begin(self->_current.ssid, self->_current.password);
+  }
+}
+
+void WiFiManager::driverDisconnect(void *ctx)
+{
+  WiFi.disconnect();
+}
+
+void WiFiManager::driverSave(void *ctx, const WiFiLink *link)
+{
+  WiFiManager *self = (WiFiManager *)ctx;
+  Preferences prefs;
+  if (!prefs.begin(WIFI_NVS_NAMESPACE, false))
+    return;
+  prefs.putString("ssid", self->_current.ssid);
+  prefs.putBytes("link", link, sizeof(*link));
+  prefs.end();
+}
+
 void WiFiManager::printConnectionInfo()
 {
   Serial.println("=== WiFi Connected Successfully ===");
@@ -209,6 +538,7 @@ void WiFiManager::printConnectionInfo()
   Serial.print("Signal Strength (RSSI): ");
   Serial.print(WiFi.RSSI());
   Serial.println(" dBm");
+  Serial.printf("BSSID: %s, channel %d\n", WiFi.BSSIDstr().c_str(), WiFi.channel());
   Serial.print("Gateway: ");
   Serial.println(WiFi.gatewayIP());
   Serial.print("DNS: ");
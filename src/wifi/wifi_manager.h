@@ -3,6 +3,15 @@
  *
  * This module handles WiFi connection and provides status information
  * WiFi credentials are stored in wifi_config.h (not committed to git)
+ *
+ * The connection is driven by the WiFi events and a one-shot timer, nothing has
+ * to be called from the loop. The link of the last connection is kept in NVS
+ * so a reconnect (or the next boot) joins the AP without a scan.
+ *
+ * Several networks can be stored (NVS). A low priority task scans passively in
+ * the background, the manager connects to the best known AP and roams to a
+ * better one when the signal gets weak. The UI reads the cached scan results
+ * instead of scanning itself.
  ******************************************************************************/
 
 #ifndef WIFI_MANAGER_H
@@ -10,6 +19,12 @@
 
 #include <WiFi.h>
 #include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "wifi_profiles.h"
+#include "wifi_state_machine.h"
 
 // WiFi connection status
 enum WiFiStatus
@@ -25,12 +40,18 @@ class WiFiManager
 public:
   WiFiManager();
 
-  // Initialize and connect to WiFi
+  // Initialize and connect to the best stored network, returns right away.
+  // The networks of wifi_config.h are stored on the first start.
   void begin();
+  // Store the network and connect to the best one
   void begin(const char *ssid, const char *password);
 
+  // Stored networks (after begin). priority [dB] is added to the RSSI when comparing APs.
+  bool addNetwork(const char *ssid, const char *password, int8_t priority = 0);
+  bool removeNetwork(const char *ssid);
+  int getNetworks(WiFiProfile *profiles, int max);
+
   // Connection management
-  bool connect();
   bool isConnected();
   void disconnect();
 
@@ -41,19 +62,38 @@ public:
   String getLocalIP();
   int getRSSI();
 
-  // Update loop - call this regularly to maintain connection
-  void update();
+  // Connection attempts and their latency
+  WiFiStats getStats();
+
+  // Result of the last background scan, doesn't wait
+  int getScanResults(WiFiScanEntry *entries, int max);
+  uint32_t getScanAgeMs(); // 0xFFFFFFFF if there was no scan yet
+  void requestScan();      // scan now instead of at the next period
 
 private:
-  const char *_ssid;
-  const char *_password;
-  WiFiStatus _status;
-  unsigned long _lastConnectionAttempt;
-  unsigned long _connectionTimeout;
-  int _reconnectAttempts;
-  const int _maxReconnectAttempts = 5;
-
-  void setStatus(WiFiStatus status);
+  WiFiProfileStore _profiles;
+  WiFiProfile _current; // network being connected or connected
+  bool _started;
+  WiFiStateMachine _sm;
+  SemaphoreHandle_t _lock;
+  esp_timer_handle_t _timer;
+  TaskHandle_t _scanTask;
+  WiFiScanEntry _scan[WIFI_MAX_SCAN];
+  int _scanCount;
+  uint32_t _scanTime;
+  bool _scanned;
+
+  static void onEvent(arduino_event_id_t event, arduino_event_info_t info);
+  static void onTimer(void *arg);
+  static void scanTask(void *arg);
+  static void driverConnect(void *ctx, const WiFiLink *link);
+  static void driverDisconnect(void *ctx);
+  static void driverSave(void *ctx, const WiFiLink *link);
+
+  void selectNetwork();
+  void afterStateChange();
+  void armTimer();
+  void saveProfiles();
   void printConnectionInfo();
 };
 
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * WiFi profiles and network selection implementation
+ ******************************************************************************/
+
+#include "wifi_profiles.h"
+#include <string.h>
+
+bool WiFiProfileStore::add(const char *ssid, const char *password, int8_t priority)
+{
+  if (strlen(ssid) == 0 || strlen(ssid) > WIFI_SSID_LEN || strlen(password) > WIFI_PASSWORD_LEN)
+    return false;
+
+  int i = find(ssid);
+  if (i < 0)
+  {
+    if (_count == WIFI_MAX_PROFILES)
+      return false;
+    i = _count++;
+  }
+
+  WiFiProfile &p = _profiles[i];
+  memset(&p, 0, sizeof(p));
+  strcpy(p.ssid, ssid);
+  strcpy(p.password, password);
+  p.priority = priority;
+  return true;
+}
+
+bool WiFiProfileStore::remove(const char *ssid)
+{
+  int i = find(ssid);
+  if (i < 0)
+    return false;
+
+  memmove(&_profiles[i], &_profiles[i + 1], (_count - i - 1) * sizeof(WiFiProfile));
+  _count--;
+  return true;
+}
+
+int WiFiProfileStore::find(const char *ssid) const
+{
+  for (int i = 0; i < _count; i++)
+  {
+    if (strcmp(_profiles[i].ssid, ssid) == 0)
+      return i;
+  }
+  return -1;
+}
+
+void WiFiProfileStore::load(const WiFiProfile *profiles, int count)
+{
+  _count = 0;
+  for (int i = 0; i < count && i < WIFI_MAX_PROFILES; i++)
+  {
+    // Don't trust the stored strings to be terminated
+    WiFiProfile p = profiles[i];
+    p.ssid[WIFI_SSID_LEN] = '\0';
+    p.password[WIFI_PASSWORD_LEN] = '\0';
+    if (p.ssid[0])
+      _profiles[_count++] = p;
+  }
+}
+
+WiFiChoice wifiSelectNetwork(const WiFiProfileStore &profiles, const WiFiScanEntry *scan, int count,
+                             const WiFiScanEntry *current, const WiFiRoamParams &params)
+{
+  WiFiChoice none = {-1, -1};
+
+  // Best known AP
+  WiFiChoice best = none;
+  int bestScore = 0;
+  for (int i = 0; i < count; i++)
+  {
+    const WiFiScanEntry &e = scan[i];
+    int p = profiles.find(e.ssid);
+    if (p < 0 || e.rssi < params.minRssi)
+      continue;
+
+    int score = e.rssi + profiles.get(p).priority;
+    if (best.entry < 0 || score > bestScore || (score == bestScore && e.rssi > scan[best.entry].rssi))
+    {
+      best = {p, i};
+      bestScore = score;
+    }
+  }
+
+  if (!current)
+    return best;
+
+  int cur = profiles.find(current->ssid);
+  int curPriority = cur >= 0 ? profiles.get(cur).priority : 0;
+  int curScore = current->rssi + curPriority;
+
+  if (current->rssi >= params.roamRssi)
+  {
+    // A good link is only left for a preferred network which is good as well
+    WiFiChoice preferred = none;
+    for (int i = 0; i < count; i++)
+    {
+      int p = profiles.find(scan[i].ssid);
+      if (p < 0 || profiles.get(p).priority <= curPriority || scan[i].rssi < params.roamRssi)
+        continue;
+      if (preferred.entry < 0 || scan[i].rssi + profiles.get(p).priority >
+                                     scan[preferred.entry].rssi + profiles.get(preferred.profile).priority)
+        preferred = {p, i};
+    }
+    return preferred;
+  }
+
+  // The link is getting weak: move before it is lost, but not back and forth
+  // between two APs of about the same strength
+  if (best.entry < 0 || memcmp(scan[best.entry].bssid, current->bssid, sizeof(current->bssid)) == 0)
+    return none;
+  if (bestScore >= curScore + params.hysteresisDb)
+    return best;
+  return none;
+}
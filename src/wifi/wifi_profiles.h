@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * WiFi profiles and network selection
+ *
+ * The known networks (SSID, password, priority) and the policy choosing the
+ * access point from a scan: the strongest known AP, but a connected AP is only
+ * left for a clearly better one (hysteresis) and before its signal gets too
+ * weak to carry traffic, not after the link is lost.
+ *
+ * No WiFi calls here so the policy can be tested on the host with synthetic
+ * scan tables.
+ ******************************************************************************/
+
+#ifndef WIFI_PROFILES_H
+#define WIFI_PROFILES_H
+
+#include <stdint.h>
+
+#define WIFI_MAX_PROFILES 8
+#define WIFI_MAX_SCAN 32 // scan results kept
+#define WIFI_SSID_LEN 32
+#define WIFI_PASSWORD_LEN 64
+
+struct WiFiProfile
+{
+  char ssid[WIFI_SSID_LEN + 1];
+  char password[WIFI_PASSWORD_LEN + 1];
+  int8_t priority; // [dB] added to the RSSI of its APs, to prefer a network
+};
+
+struct WiFiScanEntry
+{
+  char ssid[WIFI_SSID_LEN + 1];
+  uint8_t bssid[6];
+  uint8_t channel;
+  int8_t rssi; // [dBm]
+};
+
+struct WiFiRoamParams
+{
+  int8_t minRssi;       // weaker APs are not used at all
+  int8_t roamRssi;      // below this the connected AP is left for a better one
+  uint8_t hysteresisDb; // how much better the new AP has to be
+};
+
+// Result of the selection, -1: none
+struct WiFiChoice
+{
+  int profile; // index in the store
+  int entry;   // index in the scan table
+};
+
+class WiFiProfileStore
+{
+public:
+  // Add or update a network. Returns false if the store is full or a string is too long.
+  bool add(const char *ssid, const char *password, int8_t priority);
+  bool remove(const char *ssid);
+  int find(const char *ssid) const;
+
+  int count() const { return _count; }
+  const WiFiProfile &get(int i) const { return _profiles[i]; }
+
+  // Raw access to store the profiles in NVS
+  const WiFiProfile *data() const { return _profiles; }
+  void load(const WiFiProfile *profiles, int count);
+
+private:
+  WiFiProfile _profiles[WIFI_MAX_PROFILES];
+  int _count = 0;
+};
+
+// Choose the AP to connect to or to roam to.
+// current: the connected AP with its live RSSI, NULL if not connected.
+// Returns -1 / -1 if the connection should stay as it is (or nothing fits).
+WiFiChoice wifiSelectNetwork(const WiFiProfileStore &profiles, const WiFiScanEntry *scan, int count,
+                             const WiFiScanEntry *current, const WiFiRoamParams &params);
+
+#endif // WIFI_PROFILES_H
@@ -0,0 +1,213 @@
+/*******************************************************************************
+ * WiFi connection state machine implementation
+ ******************************************************************************/
+
+#include "wifi_state_machine.h"
+#include <string.h>
+
+static bool sameLink(const WiFiLink &a, const WiFiLink &b)
+{
+  return memcmp(a.bssid, b.bssid, sizeof(a.bssid)) == 0 && a.channel == b.channel && a.ip == b.ip &&
+         a.gateway == b.gateway && a.subnet == b.subnet && a.dns == b.dns;
+}
+
+WiFiStateMachine::WiFiStateMachine(const WiFiDriver &driver, const WiFiTimings &timings)
+    : _driver(driver), _timings(timings)
+{
+}
+
+void WiFiStateMachine::start(uint32_t now, const WiFiLink *cached)
+{
+  if (cached)
+  {
+    _link = *cached;
+    _linkValid = true;
+    _linkSaved = true;
+  }
+  _failures = 0;
+  connect(now);
+}
+
+void WiFiStateMachine::stop(uint32_t now)
+{
+  if (_state != WIFI_SM_IDLE)
+    _driver.disconnect(_driver.ctx);
+  _state = WIFI_SM_IDLE;
+  _hasDeadline = false;
+  _connectAfterScan = false;
+}
+
+void WiFiStateMachine::roam(uint32_t now, const WiFiLink &link)
+{
+  if (_state != WIFI_SM_CONNECTED && _state != WIFI_SM_BACKOFF)
+    return;
+
+  if (_state == WIFI_SM_CONNECTED)
+  {
+    _stats.roams++;
+    _driver.disconnect(_driver.ctx);
+  }
+  _link = link;
+  _linkValid = true;
+  _linkSaved = false;
+  connect(now);
+}
+
+void WiFiStateMachine::connect(uint32_t now)
+{
+  if (_scanning)
+  {
+    // WiFi.begin() would abort the scan or fail: wait for its end
+    _state = WIFI_SM_BACKOFF;
+    _hasDeadline = false;
+    _connectAfterScan = true;
+    return;
+  }
+
+  _attemptStart = now;
+  _stats.attempts++;
+
+  if (_linkValid)
+  {
+    _state = WIFI_SM_FAST_CONNECT;
+    _stats.fastAttempts++;
+    setDeadline(now, _timings.fastTimeoutMs);
+    _driver.connect(_driver.ctx, &_link);
+  }
+  else
+  {
+    _state = WIFI_SM_CONNECT;
+    setDeadline(now, _timings.connectTimeoutMs);
+    _driver.connect(_driver.ctx, nullptr);
+  }
+}
+
+void WiFiStateMachine::fail(uint32_t now)
+{
+  _stats.failures++;
+
+  if (_state == WIFI_SM_FAST_CONNECT)
+  {
+    // The cached link is stale (other channel, AP replaced):
+    // forget it and connect the normal way right away
+    _linkValid = false;
+    _driver.disconnect(_driver.ctx);
+    connect(now);
+    return;
+  }
+
+  _driver.disconnect(_driver.ctx);
+  _failures++;
+  uint32_t backoff = _timings.backoffMaxMs;
+  if (_failures <= 16)
+  {
+    backoff = _timings.backoffMinMs << (_failures - 1);
+    if (backoff > _timings.backoffMaxMs)
+      backoff = _timings.backoffMaxMs;
+  }
+  _stats.backoffMs = backoff;
+  _state = WIFI_SM_BACKOFF;
+  setDeadline(now, backoff);
+}
+
+void WiFiStateMachine::gotIP(uint32_t now, const WiFiLink &link)
+{
+  if (_state != WIFI_SM_FAST_CONNECT && _state != WIFI_SM_CONNECT)
+    return;
+
+  uint32_t ms = now - _attemptStart;
+  _stats.connects++;
+  _stats.lastConnectMs = ms;
+  if (_state == WIFI_SM_FAST_CONNECT)
+  {
+    _stats.fastConnects++;
+    _fastTotalMs += ms;
+    _stats.fastConnectMs = _fastTotalMs / _stats.fastConnects;
+  }
+  else
+  {
+    _totalMs += ms;
+    _stats.connectMs = _totalMs / (_stats.connects - _stats.fastConnects);
+  }
+
+  // Write the flash only if the network changed
+  if (!_linkValid || !_linkSaved || !sameLink(_link, link))
+  {
+    _link = link;
+    _linkValid = true;
+    _linkSaved = true;
+    _driver.save(_driver.ctx, &_link);
+  }
+
+  _failures = 0;
+  _stats.backoffMs = 0;
+  _state = WIFI_SM_CONNECTED;
+  _hasDeadline = false;
+}
+
+void WiFiStateMachine::disconnected(uint32_t now)
+{
+  switch (_state)
+  {
+  case WIFI_SM_CONNECTED:
+    // Rejoin the same AP without waiting
+    _stats.disconnects++;
+    connect(now);
+    break;
+  case WIFI_SM_FAST_CONNECT:
+  case WIFI_SM_CONNECT:
+    fail(now);
+    break;
+  default:
+    break;
+  }
+}
+
+void WiFiStateMachine::timeout(uint32_t now)
+{
+  if (!_hasDeadline || (int32_t)(now - _deadline) < 0)
+    return;
+
+  _hasDeadline = false;
+  if (_state == WIFI_SM_BACKOFF)
+    connect(now);
+  else if (_state == WIFI_SM_FAST_CONNECT || _state == WIFI_SM_CONNECT)
+    fail(now);
+}
+
+bool WiFiStateMachine::scanStart(uint32_t now, uint32_t scanMs)
+{
+  if (_state == WIFI_SM_FAST_CONNECT || _state == WIFI_SM_CONNECT)
+    return false;
+  if (_state == WIFI_SM_BACKOFF && _hasDeadline && timeUntilDeadline(now) < scanMs)
+    return false;
+
+  _scanning = true;
+  return true;
+}
+
+void WiFiStateMachine::scanEnd(uint32_t now)
+{
+  _scanning = false;
+  if (!_connectAfterScan)
+    return;
+
+  _connectAfterScan = false;
+  if (_state == WIFI_SM_BACKOFF)
+    setDeadline(now, 0);
+}
+
+uint32_t WiFiStateMachine::timeUntilDeadline(uint32_t now) const
+{
+  if (!_hasDeadline)
+    return WIFI_SM_NO_DEADLINE;
+
+  int32_t left = (int32_t)(_deadline - now);
+  return left > 0 ? left : 0;
+}
+
+void WiFiStateMachine::setDeadline(uint32_t now, uint32_t ms)
+{
+  _deadline = now + ms;
+  _hasDeadline = true;
+}
@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * WiFi connection state machine
+ *
+ * Driven by the WiFi events (got IP, disconnected) and by a single deadline
+ * (attempt timeout or end of the backoff), it never polls or blocks.
+ *
+ * The link of the last connection (BSSID, channel, IP) is cached: a reconnect
+ * first tries it directly, which skips the scan and the DHCP exchange. If that
+ * fails it falls back to a normal connection, and failed connections are
+ * retried with an exponential backoff.
+ *
+ * A scan keeps the radio busy for a while, so no attempt is started during
+ * one: an attempt due meanwhile is started when the scan ends.
+ *
+ * The WiFi calls go through a driver so the state machine can be tested on
+ * the host with a fake event source.
+ ******************************************************************************/
+
+#ifndef WIFI_STATE_MACHINE_H
+#define WIFI_STATE_MACHINE_H
+
+#include <stdint.h>
+
+#define WIFI_SM_NO_DEADLINE 0xFFFFFFFF
+
+enum WiFiState
+{
+  WIFI_SM_IDLE = 0,
+  WIFI_SM_FAST_CONNECT = 1, // connecting with the cached link
+  WIFI_SM_CONNECT = 2,      // connecting with a scan and DHCP
+  WIFI_SM_CONNECTED = 3,
+  WIFI_SM_BACKOFF = 4       // waiting before the next attempt
+};
+
+// Everything needed to join the network again without scanning
+struct WiFiLink
+{
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint32_t ip; // 0: use DHCP
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+};
+
+struct WiFiDriver
+{
+  void *ctx;
+  // Start connecting. link is NULL for a normal connection (scan, DHCP).
+  void (*connect)(void *ctx, const WiFiLink *link);
+  void (*disconnect)(void *ctx);
+  // Store the link of a new connection (only called if it changed)
+  void (*save)(void *ctx, const WiFiLink *link);
+};
+
+struct WiFiTimings
+{
+  uint32_t fastTimeoutMs;    // a fast connection takes a few 100 ms
+  uint32_t connectTimeoutMs; // scan, association and DHCP
+  uint32_t backoffMinMs;     // wait after the first failure, doubled after each
+  uint32_t backoffMaxMs;
+};
+
+struct WiFiStats
+{
+  uint32_t attempts;      // connection attempts
+  uint32_t fastAttempts;  // of which with the cached link
+  uint32_t connects;      // successful attempts
+  uint32_t fastConnects;  // of which with the cached link
+  uint32_t failures;      // failed or timed out attempts
+  uint32_t disconnects;   // connection lost
+  uint32_t roams;         // moves to an other AP
+  uint32_t lastConnectMs; // from the start of the attempt to the IP
+  uint32_t fastConnectMs; // average of the fast connections
+  uint32_t connectMs;     // average of the normal connections
+  uint32_t backoffMs;     // current backoff
+};
+
+class WiFiStateMachine
+{
+public:
+  WiFiStateMachine(const WiFiDriver &driver, const WiFiTimings &timings);
+
+  // Start connecting, with the link stored by the last run if there is one
+  void start(uint32_t now, const WiFiLink *cached);
+  void stop(uint32_t now);
+
+  // Move to an other AP (or network) while connected, or try it right away
+  // while waiting in the backoff. Falls back to a normal connection if it fails.
+  void roam(uint32_t now, const WiFiLink &link);
+
+  // WiFi events
+  void gotIP(uint32_t now, const WiFiLink &link);
+  void disconnected(uint32_t now);
+
+  // Call when the deadline is reached
+  void timeout(uint32_t now);
+
+  // Call before scanning. Returns false if the scan would disturb an attempt
+  // in progress or one starting within scanMs: then don't scan.
+  bool scanStart(uint32_t now, uint32_t scanMs);
+  // Call after the scan. An attempt which was due meanwhile gets a deadline
+  // of now, so the next timeout() starts it.
+  void scanEnd(uint32_t now);
+
+  // Time until timeout() has to be called, WIFI_SM_NO_DEADLINE if none
+  uint32_t timeUntilDeadline(uint32_t now) const;
+
+  WiFiState getState() const { return _state; }
+  const WiFiStats &getStats() const { return _stats; }
+
+private:
+  void connect(uint32_t now);
+  void fail(uint32_t now);
+  void setDeadline(uint32_t now, uint32_t ms);
+
+  WiFiDriver _driver;
+  WiFiTimings _timings;
+  WiFiState _state = WIFI_SM_IDLE;
+  WiFiLink _link = {};
+  bool _linkValid = false;
+  bool _linkSaved = false; // _link is the stored one
+  uint32_t _attemptStart = 0;
+  uint32_t _deadline = 0;
+  bool _hasDeadline = false;
+  uint32_t _failures = 0; // consecutive failures
+  bool _scanning = false;
+  bool _connectAfterScan = false; // an attempt was due during the scan
+  uint32_t _fastTotalMs = 0;
+  uint32_t _totalMs = 0;
+  WiFiStats _stats = {};
+};
+
+#endif // WIFI_STATE_MACHINE_H
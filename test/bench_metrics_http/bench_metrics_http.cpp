@@ -0,0 +1,281 @@
+/*******************************************************************************
+ * Loopback benchmark of the metrics server (host only, not a pio test)
+ *
+ * A poll() loop stands in for the AsyncTCP task: it drives one
+ * MetricsHttpConnection per socket, with a socket write as the sink, and
+ * flushes every connection each round like the ACK and poll callbacks do.
+ * Keep-alive clients send GET /metrics back to back, stream clients read
+ * GET /metrics/stream. A UI thread wakes at 60 Hz, does some frame work and
+ * publishes a snapshot, which measures the publish time and how late the UI
+ * wakes up, without clients and with them.
+ *
+ *   g++ -std=gnu++17 -O2 -pthread -I src test/bench_metrics_http/bench_metrics_http.cpp \
+ *       src/metrics/metrics_http.cpp src/metrics/metrics_block.cpp -o bench_metrics_http
+ *   ./bench_metrics_http [clients] [streams]     (default 4 and 2)
+ ******************************************************************************/
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "metrics/metrics_http.h"
+
+using namespace std::chrono;
+
+#define UI_PERIOD_US 16667 // 60 Hz
+#define SERVER_POLL_MS 8   // the 125 ms AsyncTCP poll, scaled to the request rate
+
+struct Connection
+{
+  int fd;
+  bool close;
+  MetricsHttpConnection http;
+};
+
+struct UiResult
+{
+  double publish_avg_us;
+  double publish_max_us;
+  double late_avg_us;
+  double late_p99_us;
+};
+
+static MetricsBlock block;
+static std::atomic<bool> stop{false};
+static std::atomic<uint64_t> requests{0};
+static std::atomic<uint64_t> lines{0};
+static uint16_t port;
+
+static size_t socketWrite(void *ctx, const char *data, size_t len)
+{
+  ssize_t sent = ::send(((Connection *)ctx)->fd, data, len, MSG_NOSIGNAL);
+  return sent > 0 ? sent : 0;
+}
+
+static void socketClose(void *ctx)
+{
+  ((Connection *)ctx)->close = true;
+}
+
+static void server(int listener)
+{
+  std::vector<Connection *> conns;
+  std::vector<pollfd> fds;
+
+  while (!stop)
+  {
+    fds.clear();
+    fds.push_back({listener, POLLIN, 0});
+    for (Connection *c : conns)
+      fds.push_back({c->fd, POLLIN, 0});
+    poll(fds.data(), fds.size(), SERVER_POLL_MS);
+
+    if (fds[0].revents & POLLIN)
+    {
+      int fd = accept(listener, nullptr, nullptr);
+      if (fd >= 0)
+      {
+        int one = 1;
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        Connection *c = new Connection{fd, false, {}};
+        c->http.begin({c, socketWrite, socketClose}, &block);
+        conns.push_back(c);
+      }
+    }
+
+    for (size_t i = 1; i < fds.size(); i++)
+    {
+      Connection *c = conns[i - 1];
+      if (fds[i].revents & (POLLIN | POLLHUP))
+      {
+        char buf[1024];
+        ssize_t n = recv(c->fd, buf, sizeof(buf), 0);
+        if (n <= 0)
+          c->close = true;
+        else
+          c->http.receive(buf, n);
+      }
+      c->http.flush();
+    }
+
+    for (size_t i = 0; i < conns.size();)
+    {
+      if (conns[i]->close)
+      {
+        close(conns[i]->fd);
+        delete conns[i];
+        conns.erase(conns.begin() + i);
+      }
+      else
+      {
+        i++;
+      }
+    }
+  }
+}
+
+static int connectClient()
+{
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  connect(fd, (sockaddr *)&addr, sizeof(addr));
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return fd;
+}
+
+// GET /metrics back to back on one keep-alive connection
+static void client()
+{
+  const char *request = "GET /metrics HTTP/1.1\r\nHost: bench\r\n\r\n";
+  char buf[4096];
+  int fd = connectClient();
+
+  while (!stop)
+  {
+    send(fd, request, strlen(request), 0);
+    size_t have = 0;
+    long need = -1;
+    while (need < 0 || (long)have < need)
+    {
+      ssize_t n = recv(fd, buf + have, sizeof(buf) - 1 - have, 0);
+      if (n <= 0)
+        return;
+      have += n;
+      buf[have] = '\0';
+      char *end = strstr(buf, "\r\n\r\n");
+      char *length = strstr(buf, "Content-Length: ");
+      if (end && length)
+        need = (end - buf) + 4 + atol(length + 16);
+    }
+    requests++;
+  }
+}
+
+// GET /metrics/stream, counts the snapshot lines
+static void streamClient()
+{
+  const char *request = "GET /metrics/stream HTTP/1.1\r\nHost: bench\r\n\r\n";
+  char buf[4096];
+  char prev = 0;
+  int fd = connectClient();
+
+  send(fd, request, strlen(request), 0);
+  while (!stop)
+  {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0)
+      return;
+    for (ssize_t i = 0; i < n; i++)
+    {
+      if (buf[i] == '\n' && prev == '}')
+        lines++;
+      prev = buf[i];
+    }
+  }
+}
+
+static UiResult ui(double seconds)
+{
+  std::vector<double> publish, late;
+  auto next = steady_clock::now();
+  auto end = next + duration<double>(seconds);
+  uint32_t frame = 0;
+
+  while (next < end)
+  {
+    next += microseconds(UI_PERIOD_US);
+    std::this_thread::sleep_until(next);
+    late.push_back(duration<double, std::micro>(steady_clock::now() - next).count());
+
+    // Frame work
+    volatile uint32_t x = 0;
+    for (int k = 0; k < 20000; k++)
+      x += k;
+
+    MetricsSample sample{};
+    sample.uptime_ms = ++frame * 16;
+    sample.heap_free = 200000 + frame;
+    sample.fps_x10 = 600;
+    auto start = steady_clock::now();
+    block.publish(sample);
+    publish.push_back(duration<double, std::micro>(steady_clock::now() - start).count());
+  }
+
+  UiResult r{};
+  for (double us : publish)
+    r.publish_avg_us += us / publish.size();
+  for (double us : late)
+    r.late_avg_us += us / late.size();
+  r.publish_max_us = *std::max_element(publish.begin(), publish.end());
+  std::sort(late.begin(), late.end());
+  r.late_p99_us = late[late.size() * 99 / 100];
+  return r;
+}
+
+static void print(const char *name, const UiResult &r)
+{
+  printf("UI %-8s publish avg %5.2f us max %5.1f us, wakeup late avg %6.1f us p99 %7.1f us\n",
+         name, r.publish_avg_us, r.publish_max_us, r.late_avg_us, r.late_p99_us);
+}
+
+int main(int argc, char **argv)
+{
+  int clients = argc > 1 ? atoi(argv[1]) : 4;
+  int streams = argc > 2 ? atoi(argv[2]) : 2;
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addrLen = sizeof(addr);
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  bind(listener, (sockaddr *)&addr, sizeof(addr));
+  getsockname(listener, (sockaddr *)&addr, &addrLen);
+  port = ntohs(addr.sin_port);
+  listen(listener, 16);
+  fcntl(listener, F_SETFL, O_NONBLOCK);
+
+  UiResult idle = ui(2);
+
+  std::thread srv(server, listener);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < clients; i++)
+    threads.emplace_back(client);
+  for (int i = 0; i < streams; i++)
+    threads.emplace_back(streamClient);
+
+  auto start = steady_clock::now();
+  UiResult load = ui(5);
+  double seconds = duration<double>(steady_clock::now() - start).count();
+  uint64_t served = requests;
+  uint64_t streamed = lines;
+
+  stop = true;
+  srv.join();
+
+  printf("%d clients, %d streams: %.0f req/s, %.1f lines/s a stream (%u publishes/s), %u read retries\n",
+         clients, streams, served / seconds, streams ? streamed / seconds / streams : 0.0,
+         (unsigned)((1000000 + UI_PERIOD_US / 2) / UI_PERIOD_US), (unsigned)block.retries());
+  print("idle", idle);
+  print("clients", load);
+  fflush(stdout);
+
+  // The clients may still wait in recv() on connections the server left
+  _exit(0);
+}
@@ -0,0 +1,253 @@
+/*******************************************************************************
+ * Host tests of the GT911 driver and the touch queue (pio test -e native)
+ *
+ * The controller is simulated by a register map which counts the I2C
+ * transactions and the bytes sent on the bus.
+ ******************************************************************************/
+
+#include <unity.h>
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include "gt911.h"
+#include "spsc_queue.h"
+
+#define REG_BASE 0x8000
+#define REG_CNT 0x200
+
+struct FakeGt911
+{
+  uint8_t regs[REG_CNT];
+  uint32_t transactions;
+  uint32_t bus_bytes; // address, register and data bytes
+};
+
+static FakeGt911 fake;
+
+static bool fake_read(void *ctx, uint16_t reg, uint8_t *buf, size_t len)
+{
+  FakeGt911 *f = (FakeGt911 *)ctx;
+  f->transactions++;
+  f->bus_bytes += 1 + 2 + 1 + len; // write address, register, read address, data
+  memcpy(buf, &f->regs[reg - REG_BASE], len);
+  return true;
+}
+
+static bool fake_write(void *ctx, uint16_t reg, const uint8_t *data, size_t len)
+{
+  FakeGt911 *f = (FakeGt911 *)ctx;
+  f->transactions++;
+  f->bus_bytes += 1 + 2 + len;
+  memcpy(&f->regs[reg - REG_BASE], data, len);
+  return true;
+}
+
+static const Gt911Bus fake_bus = {&fake, fake_read, fake_write};
+
+// The controller writes new coordinates
+static void fake_touch(uint8_t count, uint16_t x0, uint16_t y0)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint8_t *p = &fake.regs[GT911_REG_POINT_1 - REG_BASE + i * GT911_POINT_SIZE];
+    uint16_t x = x0 + i * 100;
+    uint16_t y = y0 + i * 50;
+    p[0] = i;
+    p[1] = x & 0xFF;
+    p[2] = x >> 8;
+    p[3] = y & 0xFF;
+    p[4] = y >> 8;
+    p[5] = 30;
+    p[6] = 0;
+  }
+  fake.regs[GT911_REG_STATUS - REG_BASE] = GT911_STATUS_READY | count;
+}
+
+// The previous way: status byte, a 7 byte read for each point, clearing the status
+static void legacy_read(Gt911Frame *frame)
+{
+  uint8_t status;
+  fake_read(&fake, GT911_REG_STATUS, &status, 1);
+  frame->count = status & GT911_STATUS_POINTS;
+  if (status & GT911_STATUS_READY)
+  {
+    for (uint8_t i = 0; i < frame->count; i++)
+    {
+      uint8_t data[7];
+      fake_read(&fake, GT911_REG_POINT_1 + i * GT911_POINT_SIZE, data, 7);
+      frame->points[i].x = data[1] | (data[2] << 8);
+    }
+  }
+  uint8_t zero = 0;
+  fake_write(&fake, GT911_REG_STATUS, &zero, 1);
+}
+
+void setUp(void)
+{
+  memset(&fake, 0, sizeof(fake));
+  uint16_t res[2] = {800, 480};
+  memcpy(&fake.regs[GT911_REG_RESOLUTION - REG_BASE], res, sizeof(res));
+}
+
+void tearDown(void)
+{
+}
+
+void test_begin(void)
+{
+  Gt911 gt(fake_bus);
+  TEST_ASSERT_TRUE(gt.begin());
+  TEST_ASSERT_EQUAL_UINT16(800, gt.width());
+  TEST_ASSERT_EQUAL_UINT16(480, gt.height());
+}
+
+void test_burst_read(void)
+{
+  Gt911 gt(fake_bus);
+  Gt911Frame frame;
+
+  fake_touch(3, 120, 340);
+  TEST_ASSERT_EQUAL(GT911_NEW_DATA, gt.read(&frame));
+  TEST_ASSERT_EQUAL_UINT8(3, frame.count);
+  TEST_ASSERT_EQUAL_UINT16(120, frame.points[0].x);
+  TEST_ASSERT_EQUAL_UINT16(340, frame.points[0].y);
+  TEST_ASSERT_EQUAL_UINT16(320, frame.points[2].x);
+  TEST_ASSERT_EQUAL_UINT16(440, frame.points[2].y);
+  TEST_ASSERT_EQUAL_UINT16(30, frame.points[1].size);
+
+  // One burst and one write to clear the status
+  TEST_ASSERT_EQUAL_UINT32(2, fake.transactions);
+  TEST_ASSERT_EQUAL_UINT8(0, fake.regs[GT911_REG_STATUS - REG_BASE]);
+
+  // The status is not ready: nothing to clear
+  fake.transactions = 0;
+  TEST_ASSERT_EQUAL(GT911_NO_DATA, gt.read(&frame));
+  TEST_ASSERT_EQUAL_UINT32(1, fake.transactions);
+
+  // Release
+  fake_touch(0, 0, 0);
+  TEST_ASSERT_EQUAL(GT911_NEW_DATA, gt.read(&frame));
+  TEST_ASSERT_EQUAL_UINT8(0, frame.count);
+}
+
+void test_poll(void)
+{
+  Gt911 gt(fake_bus);
+  Gt911Frame frame;
+
+  // Nothing new: only the status byte is read
+  TEST_ASSERT_EQUAL(GT911_NO_DATA, gt.poll(&frame));
+  TEST_ASSERT_EQUAL_UINT32(1, fake.transactions);
+  TEST_ASSERT_EQUAL_UINT32(5, fake.bus_bytes);
+
+  fake.transactions = 0;
+  fake_touch(2, 700, 20);
+  TEST_ASSERT_EQUAL(GT911_NEW_DATA, gt.poll(&frame));
+  TEST_ASSERT_EQUAL_UINT8(2, frame.count);
+  TEST_ASSERT_EQUAL_UINT16(800, frame.points[1].x);
+  TEST_ASSERT_EQUAL_UINT32(3, fake.transactions);
+
+  // Invalid number of points
+  fake.regs[GT911_REG_STATUS - REG_BASE] = GT911_STATUS_READY | 9;
+  TEST_ASSERT_EQUAL(GT911_NEW_DATA, gt.poll(&frame));
+  TEST_ASSERT_EQUAL_UINT8(GT911_MAX_POINTS, frame.count);
+}
+
+void test_transactions_per_event(void)
+{
+  Gt911 gt(fake_bus);
+  Gt911Frame frame;
+  uint8_t counts[] = {1, 2, 5};
+
+  for (uint8_t i = 0; i < sizeof(counts); i++)
+  {
+    fake.transactions = 0;
+    fake.bus_bytes = 0;
+    fake_touch(counts[i], 10, 10);
+    legacy_read(&frame);
+    uint32_t legacy_tr = fake.transactions;
+    uint32_t legacy_bytes = fake.bus_bytes;
+
+    fake.transactions = 0;
+    fake.bus_bytes = 0;
+    fake_touch(counts[i], 10, 10);
+    gt.read(&frame);
+
+    printf("%u points: %u I2C transactions (%u bytes), before %u (%u bytes)\n", counts[i],
+           fake.transactions, fake.bus_bytes, legacy_tr, legacy_bytes);
+    TEST_ASSERT_EQUAL_UINT32(2, fake.transactions);
+    TEST_ASSERT_EQUAL_UINT32(counts[i] + 2, legacy_tr);
+  }
+}
+
+void test_queue(void)
+{
+  SpscQueue<uint32_t, 4> q;
+  uint32_t v;
+  TEST_ASSERT_TRUE(q.empty());
+  TEST_ASSERT_FALSE(q.pop(&v));
+
+  // N - 1 items fit
+  TEST_ASSERT_TRUE(q.push(1));
+  TEST_ASSERT_TRUE(q.push(2));
+  TEST_ASSERT_TRUE(q.push(3));
+  TEST_ASSERT_FALSE(q.push(4));
+
+  TEST_ASSERT_TRUE(q.pop(&v));
+  TEST_ASSERT_EQUAL_UINT32(1, v);
+  TEST_ASSERT_TRUE(q.push(4));
+  TEST_ASSERT_TRUE(q.pop(&v));
+  TEST_ASSERT_TRUE(q.pop(&v));
+  TEST_ASSERT_TRUE(q.pop(&v));
+  TEST_ASSERT_EQUAL_UINT32(4, v);
+  TEST_ASSERT_TRUE(q.empty());
+}
+
+void test_queue_threads(void)
+{
+  // A producer and a consumer thread: every item arrives once and in order
+  static SpscQueue<uint32_t, 16> q;
+  const uint32_t cnt = 100000;
+  std::atomic<bool> ok(true);
+
+  std::thread consumer([&] {
+    uint32_t expected = 0;
+    while (expected < cnt)
+    {
+      uint32_t v;
+      if (!q.pop(&v))
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      if (v != expected)
+        ok = false;
+      expected++;
+    }
+  });
+
+  uint32_t i = 0;
+  while (i < cnt)
+  {
+    if (q.push(i))
+      i++;
+    else
+      std::this_thread::yield();
+  }
+  consumer.join();
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_TRUE(q.empty());
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_begin);
+  RUN_TEST(test_burst_read);
+  RUN_TEST(test_poll);
+  RUN_TEST(test_transactions_per_event);
+  RUN_TEST(test_queue);
+  RUN_TEST(test_queue_threads);
+  return UNITY_END();
+}
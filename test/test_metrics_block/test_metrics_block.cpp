@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * Host tests of the double buffered metrics block (pio test -e native)
+ *
+ * A writer thread publishes as fast as it can while readers copy snapshots:
+ * every copy has to be one whole snapshot, never a mix of two.
+ ******************************************************************************/
+
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include "metrics/metrics_block.h"
+
+static MetricsSample sample(uint32_t i)
+{
+  MetricsSample s;
+  memset(&s, 0, sizeof(s));
+  s.uptime_ms = i * 1000;
+  s.heap_free = 200000 + i;
+  s.heap_min = 150000;
+  s.psram_free = 8000000 - i;
+  s.psram_min = 7000000;
+  s.fps_x10 = 598;
+  s.flushes = 16 * 60;
+  s.flush_pixels = 800 * 480;
+  s.flush_us = 9000;
+  s.flush_max_us = 850;
+  s.ui_duty = 12;
+  s.audio_underruns = 2;
+  s.rssi = -61;
+  return s;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_serialize(void)
+{
+  char json[METRICS_JSON_MAX];
+  size_t len = metrics_serialize(sample(3), 7, json, sizeof(json));
+  TEST_ASSERT_EQUAL_STRING("{\"seq\":7,\"uptime_ms\":3000,"
+                           "\"heap\":{\"free\":200003,\"min\":150000},"
+                           "\"psram\":{\"free\":7999997,\"min\":7000000},"
+                           "\"fps\":59.8,"
+                           "\"flush\":{\"count\":960,\"pixels\":384000,\"us\":9000,\"max_us\":850},"
+                           "\"ui_duty\":12,\"audio_underruns\":2,\"rssi\":-61}",
+                           json);
+  TEST_ASSERT_EQUAL_UINT32(strlen(json), len);
+
+  // The largest values still fit
+  MetricsSample big;
+  memset(&big, 0xFF, sizeof(big));
+  big.rssi = -128;
+  TEST_ASSERT_TRUE(metrics_serialize(big, 0xFFFFFFFF, json, sizeof(json)) > 0);
+
+  // Too small a buffer
+  TEST_ASSERT_EQUAL_UINT32(0, metrics_serialize(sample(3), 7, json, 40));
+}
+
+void test_publish_read(void)
+{
+  MetricsBlock block;
+  char json[METRICS_JSON_MAX];
+  uint32_t seq = 0;
+  TEST_ASSERT_EQUAL_UINT32(0, block.sequence());
+  TEST_ASSERT_EQUAL_UINT32(0, block.read(json, sizeof(json), &seq));
+
+  block.publish(sample(1));
+  TEST_ASSERT_EQUAL_UINT32(1, block.sequence());
+  size_t len = block.read(json, sizeof(json), &seq);
+  TEST_ASSERT_EQUAL_UINT32(1, seq);
+  json[len] = '\0';
+  TEST_ASSERT_NOT_NULL(strstr(json, "\"uptime_ms\":1000,"));
+
+  // Flip: the newest snapshot is read, in both buffers
+  for (uint32_t i = 2; i <= 5; i++)
+  {
+    block.publish(sample(i));
+    len = block.read(json, sizeof(json), &seq);
+    json[len] = '\0';
+    TEST_ASSERT_EQUAL_UINT32(i, seq);
+    char expected[32];
+    sprintf(expected, "{\"seq\":%u,\"uptime_ms\":%u,", (unsigned)i, (unsigned)(i * 1000));
+    TEST_ASSERT_EQUAL_INT(0, strncmp(json, expected, strlen(expected)));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, block.retries());
+}
+
+void test_concurrent_readers(void)
+{
+  static MetricsBlock block;
+  std::atomic<bool> stop{false};
+  std::atomic<uint32_t> bad{0};
+  std::atomic<uint32_t> reads{0};
+
+  block.publish(sample(1));
+  std::thread writer([&] {
+    for (uint32_t i = 2; i < 200000; i++)
+      block.publish(sample(i));
+    stop = true;
+  });
+
+  auto reader = [&] {
+    char json[METRICS_JSON_MAX + 1];
+    uint32_t last = 0;
+    while (!stop)
+    {
+      uint32_t seq;
+      size_t len = block.read(json, METRICS_JSON_MAX, &seq);
+      json[len] = '\0';
+      reads++;
+
+      // The copy is the snapshot it claims to be, and never an older one
+      unsigned s, uptime, heap;
+      if (sscanf(json, "{\"seq\":%u,\"uptime_ms\":%u,\"heap\":{\"free\":%u", &s, &uptime, &heap) != 3 ||
+          s != seq || uptime != seq * 1000 || heap != 200000 + seq || seq < last || json[len - 1] != '}')
+        bad++;
+      last = seq;
+    }
+  };
+  std::thread r1(reader);
+  std::thread r2(reader);
+  writer.join();
+  r1.join();
+  r2.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, bad.load());
+  TEST_ASSERT_TRUE(reads.load() > 0);
+  TEST_ASSERT_EQUAL_UINT32(199999, block.sequence());
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_serialize);
+  RUN_TEST(test_publish_read);
+  RUN_TEST(test_concurrent_readers);
+  return UNITY_END();
+}
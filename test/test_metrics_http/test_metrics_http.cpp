@@ -0,0 +1,300 @@
+/*******************************************************************************
+ * Host tests of the metrics server's HTTP connection (pio test -e native)
+ *
+ * A fake sink collects the response bytes and can take only part of them,
+ * like an AsyncClient with a full TCP window.
+ ******************************************************************************/
+
+#include <unity.h>
+#include <string.h>
+#include <stdio.h>
+#include <string>
+#include "metrics/metrics_http.h"
+
+struct FakeSink
+{
+  std::string data;
+  size_t space; // bytes taken by the next writes
+  uint32_t closes;
+};
+
+static FakeSink fake;
+static MetricsBlock *block;
+static MetricsHttpConnection conn;
+static std::string controls;
+
+static size_t fakeWrite(void *ctx, const char *data, size_t len)
+{
+  FakeSink *f = (FakeSink *)ctx;
+  if (len > f->space)
+    len = f->space;
+  f->data.append(data, len);
+  f->space -= len;
+  return len;
+}
+
+static void fakeClose(void *ctx)
+{
+  ((FakeSink *)ctx)->closes++;
+}
+
+static bool fakeControl(void *arg, const char *key, const char *value)
+{
+  controls += std::string(key) + "=" + value + ";";
+  return strcmp(key, "backlight") == 0;
+}
+
+static const MetricsSink sink = {&fake, fakeWrite, fakeClose};
+
+static MetricsSample sample(uint32_t i)
+{
+  MetricsSample s;
+  memset(&s, 0, sizeof(s));
+  s.uptime_ms = i * 1000;
+  s.fps_x10 = 600;
+  s.rssi = -55;
+  return s;
+}
+
+static void receive(const char *request)
+{
+  conn.receive(request, strlen(request));
+}
+
+// Take the next response off the fake sink
+static std::string next()
+{
+  std::string r = fake.data;
+  fake.data.clear();
+  return r;
+}
+
+static int count(const std::string &s, const char *what)
+{
+  int n = 0;
+  for (size_t p = s.find(what); p != std::string::npos; p = s.find(what, p + 1))
+    n++;
+  return n;
+}
+
+void setUp(void)
+{
+  fake.data.clear();
+  fake.space = 1 << 20;
+  fake.closes = 0;
+  controls.clear();
+  delete block;
+  block = new MetricsBlock();
+  conn.begin(sink, block, fakeControl, nullptr);
+}
+
+void tearDown(void)
+{
+}
+
+void test_get_snapshot(void)
+{
+  receive("GET /metrics HTTP/1.1\r\nHost: board\r\n\r\n");
+  TEST_ASSERT_EQUAL_STRING("HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n",
+                           next().c_str());
+
+  block->publish(sample(1));
+  receive("GET /metrics HTTP/1.1\r\nHost: board\r\n\r\n");
+  char json[METRICS_JSON_MAX];
+  size_t len = metrics_serialize(sample(1), 1, json, sizeof(json));
+  char expected[600];
+  sprintf(expected,
+          "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nCache-Control: no-store\r\n"
+          "Content-Length: %u\r\nConnection: keep-alive\r\n\r\n%s",
+          (unsigned)len, json);
+  TEST_ASSERT_EQUAL_STRING(expected, next().c_str());
+  TEST_ASSERT_EQUAL_UINT32(0, fake.closes);
+  TEST_ASSERT_EQUAL_UINT32(2, conn.requests());
+}
+
+void test_keep_alive(void)
+{
+  block->publish(sample(1));
+
+  // Pipelined requests, split at odd places
+  const char *requests = "GET /metrics HTTP/1.1\r\n\r\nGET /metrics HTTP/1.1\r\nConnection: keep-alive\r\n\r\n"
+                         "GET /nothing HTTP/1.1\r\n\r\nGET /metrics HTTP/1.1\r\nConnection: close\r\n\r\n";
+  for (size_t i = 0, len = strlen(requests); i < len; i += 7)
+    conn.receive(requests + i, len - i < 7 ? len - i : 7);
+
+  std::string r = next();
+  TEST_ASSERT_EQUAL_INT(3, count(r, "HTTP/1.1 200 OK"));
+  TEST_ASSERT_EQUAL_INT(1, count(r, "HTTP/1.1 404 Not Found"));
+  TEST_ASSERT_EQUAL_INT(1, count(r, "Connection: close"));
+  TEST_ASSERT_EQUAL_UINT32(1, fake.closes);
+  TEST_ASSERT_EQUAL_UINT32(4, conn.requests());
+
+  // Nothing is answered after the close
+  receive("GET /metrics HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_EQUAL_UINT32(0, next().size());
+}
+
+void test_http10(void)
+{
+  block->publish(sample(1));
+  receive("GET /metrics HTTP/1.0\r\n\r\n");
+  TEST_ASSERT_EQUAL_INT(1, count(next(), "Connection: close"));
+  TEST_ASSERT_EQUAL_UINT32(1, fake.closes);
+
+  conn.begin(sink, block, fakeControl, nullptr);
+  receive("GET /metrics HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n");
+  TEST_ASSERT_EQUAL_INT(1, count(next(), "Connection: keep-alive"));
+  TEST_ASSERT_EQUAL_UINT32(1, fake.closes);
+}
+
+void test_bad_requests(void)
+{
+  receive("HELLO\r\n\r\n");
+  TEST_ASSERT_EQUAL_INT(1, count(next(), "HTTP/1.1 400 Bad Request"));
+  TEST_ASSERT_EQUAL_UINT32(1, fake.closes);
+
+  conn.begin(sink, block, fakeControl, nullptr);
+  receive("GET /metrics HTTP/2.0\r\n\r\n");
+  TEST_ASSERT_EQUAL_INT(1, count(next(), "505"));
+
+  conn.begin(sink, block, fakeControl, nullptr);
+  receive("POST /metrics HTTP/1.1\r\nContent-Length: 3\r\n\r\nabcGET /x HTTP/1.1\r\n\r\n");
+  std::string r = next();
+  TEST_ASSERT_EQUAL_INT(1, count(r, "405 Method Not Allowed"));
+  TEST_ASSERT_EQUAL_INT(1, count(r, "404 Not Found")); // the body was skipped
+
+  // Headers longer than the request buffer
+  conn.begin(sink, block, fakeControl, nullptr);
+  fake.closes = 0;
+  receive("GET /metrics HTTP/1.1\r\n");
+  for (int i = 0; i < 20; i++)
+    receive("X-Padding: 0123456789012345678901234567890123456789\r\n");
+  TEST_ASSERT_EQUAL_INT(1, count(next(), "431"));
+  TEST_ASSERT_EQUAL_UINT32(1, fake.closes);
+}
+
+void test_control(void)
+{
+  receive("POST /control?backlight=0 HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+  TEST_ASSERT_EQUAL_STRING("HTTP/1.1 204 No Content\r\nConnection: keep-alive\r\n\r\n", next().c_str());
+  TEST_ASSERT_EQUAL_STRING("backlight=0;", controls.c_str());
+
+  controls.clear();
+  receive("POST /control?backlight=1&volume=3 HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_EQUAL_INT(1, count(next(), "400 Bad Request"));
+  TEST_ASSERT_EQUAL_STRING("backlight=1;volume=3;", controls.c_str());
+
+  receive("GET /control?backlight=1 HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_EQUAL_INT(1, count(next(), "405"));
+  receive("POST /control HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_EQUAL_INT(1, count(next(), "400"));
+  TEST_ASSERT_EQUAL_UINT32(0, fake.closes);
+}
+
+void test_stream(void)
+{
+  block->publish(sample(1));
+  receive("GET /metrics/stream HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_TRUE(conn.streaming());
+
+  std::string r = next();
+  const char *head = "HTTP/1.1 200 OK\r\nContent-Type: application/x-ndjson\r\nCache-Control: no-store\r\n"
+                     "Transfer-Encoding: chunked\r\n\r\n";
+  TEST_ASSERT_EQUAL_INT(0, r.compare(0, strlen(head), head));
+
+  // First chunk: the current snapshot, one line
+  char json[METRICS_JSON_MAX];
+  size_t len = metrics_serialize(sample(1), 1, json, sizeof(json));
+  char chunk[METRICS_JSON_MAX + 16];
+  sprintf(chunk, "%04x\r\n%s\n\r\n", (unsigned)len + 1, json);
+  TEST_ASSERT_EQUAL_STRING(chunk, r.c_str() + strlen(head));
+
+  // Nothing new: nothing sent
+  conn.flush();
+  TEST_ASSERT_EQUAL_UINT32(0, next().size());
+
+  // Publishing twice between two polls sends only the newest
+  block->publish(sample(2));
+  block->publish(sample(3));
+  conn.flush();
+  len = metrics_serialize(sample(3), 3, json, sizeof(json));
+  sprintf(chunk, "%04x\r\n%s\n\r\n", (unsigned)len + 1, json);
+  TEST_ASSERT_EQUAL_STRING(chunk, next().c_str());
+  TEST_ASSERT_EQUAL_UINT32(2, conn.chunks());
+
+  // Requests on a stream are ignored
+  receive("GET /metrics HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_EQUAL_UINT32(0, next().size());
+
+  // HTTP/1.0: plain lines, closed by the connection
+  conn.begin(sink, block, fakeControl, nullptr);
+  receive("GET /metrics/stream HTTP/1.0\r\n\r\n");
+  r = next();
+  TEST_ASSERT_EQUAL_INT(1, count(r, "Connection: close"));
+  TEST_ASSERT_EQUAL_INT(0, count(r, "chunked"));
+  TEST_ASSERT_EQUAL_INT(1, count(r, "\"seq\":3,"));
+  TEST_ASSERT_EQUAL_UINT32(0, fake.closes);
+}
+
+void test_backpressure(void)
+{
+  block->publish(sample(1));
+
+  // The sink takes nothing: the responses wait in the output buffer, and
+  // the requests which don't fit any more wait for room
+  fake.space = 0;
+  for (int i = 0; i < 6; i++)
+    receive("GET /metrics HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_EQUAL_UINT32(0, fake.data.size());
+  TEST_ASSERT_TRUE(conn.requests() < 6);
+
+  // Drained a few bytes at a time, like ACKs coming in
+  for (int i = 0; i < 400 && count(fake.data, "\"seq\":1,") < 6; i++)
+  {
+    fake.space = 97;
+    conn.flush();
+  }
+  TEST_ASSERT_EQUAL_INT(6, count(fake.data, "HTTP/1.1 200 OK"));
+  TEST_ASSERT_EQUAL_UINT32(6, conn.requests());
+  TEST_ASSERT_EQUAL_INT(6, count(fake.data, "\"seq\":1,"));
+
+  // A stream doesn't queue up snapshots behind a slow client
+  conn.begin(sink, block, fakeControl, nullptr);
+  fake.data.clear();
+  fake.space = 0;
+  receive("GET /metrics/stream HTTP/1.1\r\n\r\n");
+  for (uint32_t i = 2; i < 50; i++)
+  {
+    block->publish(sample(i));
+    conn.flush();
+  }
+  TEST_ASSERT_TRUE(conn.chunks() < 10);
+  fake.space = 1 << 20;
+  conn.flush();
+  conn.flush();
+  TEST_ASSERT_EQUAL_INT(1, count(fake.data, "\"seq\":49,"));
+
+  // A client which only sends, never reads, is dropped
+  conn.begin(sink, block, fakeControl, nullptr);
+  fake.space = 0;
+  fake.closes = 0;
+  for (int i = 0; i < 100; i++)
+    receive("GET /metrics HTTP/1.1\r\n\r\n");
+  TEST_ASSERT_TRUE(conn.closing());
+  fake.space = 1 << 20;
+  conn.flush();
+  TEST_ASSERT_EQUAL_UINT32(1, fake.closes);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_get_snapshot);
+  RUN_TEST(test_keep_alive);
+  RUN_TEST(test_http10);
+  RUN_TEST(test_bad_requests);
+  RUN_TEST(test_control);
+  RUN_TEST(test_stream);
+  RUN_TEST(test_backpressure);
+  return UNITY_END();
+}
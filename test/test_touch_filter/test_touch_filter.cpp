@@ -0,0 +1,335 @@
+/*******************************************************************************
+ * Replay of touch traces through the touch filter (pio test -e native)
+ *
+ * The traces are finger paths sampled like the GT911 in poll mode: every 10 ms
+ * with +-1 ms of jitter, 1.5 px of noise and integer coordinates. Each sample
+ * is displayed predict_us later, the metrics compare the displayed
+ * position with where the finger really is at that time:
+ *   jitter: RMS of the frame to frame acceleration of the displayed position
+ *   lag:    how far the displayed position is behind, in ms of finger motion
+ *   error:  RMS distance to the finger
+ *
+ * A trace recorded on the board (TOUCH_TRACE in touch.h, "t_us,x,y,pressed"
+ * lines) can be replayed with TOUCH_TRACE_FILE=<file>. The finger position is
+ * then estimated by interpolating the raw samples.
+ ******************************************************************************/
+
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "touch_filter.h"
+
+#define SAMPLE_PERIOD_US 10000
+#define NOISE_PX 1.5f
+
+struct TraceSample
+{
+  uint32_t t_us;
+  float x;
+  float y;
+  bool pressed;
+};
+
+typedef void (*finger_cb_t)(float t, float *x, float *y);
+
+struct Trace
+{
+  const char *name;
+  std::vector<TraceSample> samples;
+  finger_cb_t finger; // real position, NULL for recorded traces
+};
+
+struct ReplayResult
+{
+  float jitter_px;
+  float lag_ms;
+  float error_px;
+  float overshoot_px; // largest distance past the end of the path
+};
+
+// =============================================================================
+// Traces
+// =============================================================================
+
+static uint32_t rng_state;
+
+static float rng_uniform()
+{
+  rng_state = rng_state * 1664525u + 1013904223u;
+  return ((rng_state >> 8) + 0.5f) / 16777216.0f;
+}
+
+static float rng_gauss()
+{
+  return sqrtf(-2.0f * logf(rng_uniform())) * cosf(2.0f * (float)M_PI * rng_uniform());
+}
+
+static void finger_hold(float t, float *x, float *y)
+{
+  *x = 400;
+  *y = 240;
+}
+
+static void finger_swipe(float t, float *x, float *y)
+{
+  *x = 100 + 800 * t; // 800 px/s
+  *y = 200 + 100 * t;
+}
+
+static void finger_fling(float t, float *x, float *y)
+{
+  // Accelerates to 2000 px/s and stops at x = 500 after 0.4 s
+  float s = t < 0.4f ? t / 0.4f : 1.0f;
+  *x = 100 + 400 * s * s * (3 - 2 * s);
+  *y = 240;
+}
+
+static void finger_circle(float t, float *x, float *y)
+{
+  *x = 400 + 150 * cosf(2.0f * (float)M_PI * t);
+  *y = 240 + 150 * sinf(2.0f * (float)M_PI * t);
+}
+
+static Trace make_trace(const char *name, finger_cb_t finger, float duration)
+{
+  Trace trace = {name, {}, finger};
+  rng_state = 12345;
+  for (uint32_t t = 0; t < duration * 1e6f; t += SAMPLE_PERIOD_US)
+  {
+    uint32_t t_us = t + (uint32_t)(rng_uniform() * 2000);
+    float x, y;
+    finger(t_us / 1e6f, &x, &y);
+    x = roundf(x + NOISE_PX * rng_gauss());
+    y = roundf(y + NOISE_PX * rng_gauss());
+    trace.samples.push_back({t_us, x, y, true});
+  }
+  return trace;
+}
+
+static bool load_trace(const char *path, Trace *trace)
+{
+  FILE *f = fopen(path, "r");
+  if (!f)
+    return false;
+
+  trace->name = path;
+  trace->finger = nullptr;
+  unsigned t_us, x, y, pressed;
+  while (fscanf(f, "%u,%u,%u,%u", &t_us, &x, &y, &pressed) == 4)
+    trace->samples.push_back({t_us, (float)x, (float)y, pressed != 0});
+  fclose(f);
+  return !trace->samples.empty();
+}
+
+// Position of the finger: the real one or the raw samples interpolated
+static void finger_at(const Trace &trace, uint32_t t_us, float *x, float *y)
+{
+  if (trace.finger)
+  {
+    trace.finger(t_us / 1e6f, x, y);
+    return;
+  }
+
+  const std::vector<TraceSample> &s = trace.samples;
+  size_t i = 1;
+  while (i < s.size() - 1 && s[i].t_us < t_us)
+    i++;
+  float k = (float)(int32_t)(t_us - s[i - 1].t_us) / (float)(s[i].t_us - s[i - 1].t_us);
+  if (k > 1)
+    k = 1;
+  *x = s[i - 1].x + k * (s[i].x - s[i - 1].x);
+  *y = s[i - 1].y + k * (s[i].y - s[i - 1].y);
+}
+
+// =============================================================================
+// Replay
+// =============================================================================
+
+static ReplayResult replay(const Trace &trace, const TouchFilterConfig &config)
+{
+  TouchFilter filter(config);
+  std::vector<TouchSample> shown;
+  float err2 = 0, lag = 0, overshoot = 0;
+  uint32_t lag_cnt = 0;
+
+  float start_x, start_y, end_x, end_y;
+  finger_at(trace, trace.samples.front().t_us, &start_x, &start_y);
+  finger_at(trace, trace.samples.back().t_us, &end_x, &end_y);
+
+  for (const TraceSample &raw : trace.samples)
+  {
+    if (!raw.pressed)
+    {
+      filter.reset();
+      continue;
+    }
+
+    filter.update({raw.t_us, raw.x, raw.y});
+    TouchSample out = filter.predict(raw.t_us + config.predict_us);
+    shown.push_back(out);
+
+    float fx, fy;
+    finger_at(trace, out.t_us, &fx, &fy);
+    float ex = fx - out.x;
+    float ey = fy - out.y;
+    err2 += ex * ex + ey * ey;
+
+    // Lag along the direction of motion
+    float fx2, fy2;
+    finger_at(trace, out.t_us + 5000, &fx2, &fy2);
+    float vx = (fx2 - fx) / 0.005f;
+    float vy = (fy2 - fy) / 0.005f;
+    float speed2 = vx * vx + vy * vy;
+    if (speed2 > 200.0f * 200.0f)
+    {
+      lag += (ex * vx + ey * vy) / speed2 * 1000;
+      lag_cnt++;
+    }
+
+    // Past the end point in the direction of the path once the finger stopped
+    float dx = out.x - end_x;
+    float dy = out.y - end_y;
+    float sx = end_x - start_x;
+    float sy = end_y - start_y;
+    float len = sqrtf(sx * sx + sy * sy);
+    if (len > 1 && fabsf(fx - end_x) < 0.5f && fabsf(fy - end_y) < 0.5f)
+    {
+      float past = (dx * sx + dy * sy) / len;
+      if (past > overshoot)
+        overshoot = past;
+    }
+  }
+
+  float acc2 = 0;
+  for (size_t i = 2; i < shown.size(); i++)
+  {
+    float ax = shown[i].x - 2 * shown[i - 1].x + shown[i - 2].x;
+    float ay = shown[i].y - 2 * shown[i - 1].y + shown[i - 2].y;
+    acc2 += ax * ax + ay * ay;
+  }
+
+  ReplayResult res;
+  res.jitter_px = shown.size() > 2 ? sqrtf(acc2 / (shown.size() - 2)) : 0;
+  res.lag_ms = lag_cnt ? lag / lag_cnt : 0;
+  res.error_px = shown.size() ? sqrtf(err2 / shown.size()) : 0;
+  res.overshoot_px = overshoot;
+  return res;
+}
+
+static const char *mode_names[] = {"raw", "1-euro", "kalman"};
+
+static void replay_all(const Trace &trace, ReplayResult *res)
+{
+  for (int m = TOUCH_FILTER_NONE; m <= TOUCH_FILTER_KALMAN; m++)
+  {
+    res[m] = replay(trace, touch_filter_default_config((TouchFilterMode)m));
+    printf("%-8s %-7s jitter %5.2f px, lag %6.2f ms, error %5.2f px, overshoot %5.1f px\n", trace.name,
+           mode_names[m], res[m].jitter_px, res[m].lag_ms, res[m].error_px, res[m].overshoot_px);
+  }
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_hold(void)
+{
+  ReplayResult res[3];
+  replay_all(make_trace("hold", finger_hold, 1.0f), res);
+
+  // The resting finger doesn't shake the UI
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_ONE_EURO].jitter_px < res[TOUCH_FILTER_NONE].jitter_px / 2);
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_KALMAN].jitter_px < res[TOUCH_FILTER_NONE].jitter_px / 2);
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_ONE_EURO].error_px < res[TOUCH_FILTER_NONE].error_px);
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_KALMAN].error_px < res[TOUCH_FILTER_NONE].error_px);
+}
+
+void test_swipe(void)
+{
+  ReplayResult res[3];
+  replay_all(make_trace("swipe", finger_swipe, 0.5f), res);
+
+  // The raw position is displayed one frame late
+  uint32_t frame_ms = touch_filter_default_config(TOUCH_FILTER_NONE).predict_us / 1000;
+  TEST_ASSERT_FLOAT_WITHIN(3.0f, frame_ms, res[TOUCH_FILTER_NONE].lag_ms);
+  // The prediction catches up with the finger
+  TEST_ASSERT_FLOAT_WITHIN(5.0f, 0, res[TOUCH_FILTER_ONE_EURO].lag_ms);
+  TEST_ASSERT_FLOAT_WITHIN(2.0f, 0, res[TOUCH_FILTER_KALMAN].lag_ms);
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_ONE_EURO].error_px < res[TOUCH_FILTER_NONE].error_px / 2);
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_KALMAN].error_px < res[TOUCH_FILTER_NONE].error_px / 2);
+}
+
+void test_fling(void)
+{
+  ReplayResult res[3];
+  replay_all(make_trace("fling", finger_fling, 0.6f), res);
+
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_ONE_EURO].lag_ms < res[TOUCH_FILTER_NONE].lag_ms);
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_KALMAN].lag_ms < res[TOUCH_FILTER_NONE].lag_ms);
+  // The prediction doesn't run far past the stop
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_ONE_EURO].overshoot_px < 20.0f);
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_KALMAN].overshoot_px < 20.0f);
+}
+
+void test_circle(void)
+{
+  ReplayResult res[3];
+  replay_all(make_trace("circle", finger_circle, 1.0f), res);
+
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_ONE_EURO].error_px < res[TOUCH_FILTER_NONE].error_px);
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_KALMAN].error_px < res[TOUCH_FILTER_NONE].error_px);
+  TEST_ASSERT_TRUE(res[TOUCH_FILTER_KALMAN].jitter_px < res[TOUCH_FILTER_NONE].jitter_px);
+}
+
+void test_new_stroke(void)
+{
+  TouchFilter filter(touch_filter_default_config(TOUCH_FILTER_KALMAN));
+  filter.update({0, 100, 100});
+  filter.update({10000, 110, 100});
+
+  // A touch after a release starts at its own position without speed
+  filter.reset();
+  TouchSample s = filter.update({20000, 600, 300});
+  TEST_ASSERT_EQUAL_FLOAT(600, s.x);
+  TEST_ASSERT_EQUAL_FLOAT(300, s.y);
+  TEST_ASSERT_EQUAL_FLOAT(0, filter.vx());
+
+  // The prediction stops at the horizon
+  filter.update({30000, 610, 300});
+  TouchSample far = filter.predict(30000 + 1000000);
+  TouchSample max = filter.predict(30000 + touch_filter_default_config(TOUCH_FILTER_KALMAN).max_predict_us);
+  TEST_ASSERT_EQUAL_FLOAT(max.x, far.x);
+}
+
+void test_recorded_trace(void)
+{
+  const char *path = getenv("TOUCH_TRACE_FILE");
+  Trace trace;
+  if (!path || !load_trace(path, &trace))
+    TEST_IGNORE_MESSAGE("set TOUCH_TRACE_FILE to replay a recorded trace");
+
+  ReplayResult res[3];
+  replay_all(trace, res);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_hold);
+  RUN_TEST(test_swipe);
+  RUN_TEST(test_fling);
+  RUN_TEST(test_circle);
+  RUN_TEST(test_new_stroke);
+  RUN_TEST(test_recorded_trace);
+  return UNITY_END();
+}
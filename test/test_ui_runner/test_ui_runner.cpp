@@ -0,0 +1,173 @@
+/*******************************************************************************
+ * Host tests of the UI runner (pio test -e native)
+ *
+ * The LVGL handler is simulated: it returns the time until the next timer.
+ ******************************************************************************/
+
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+#include "ui_runner.h"
+
+static std::atomic<uint32_t> handler_runs;
+static std::atomic<uint32_t> next_deadline_ms;
+static std::atomic<uint32_t> handler_work_us;
+static std::atomic<bool> stop;
+
+static uint32_t clock_us(void)
+{
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t fake_handler(void)
+{
+  handler_runs++;
+  uint32_t work = handler_work_us;
+  uint32_t start = clock_us();
+  while (clock_us() - start < work)
+    ;
+  return next_deadline_ms;
+}
+
+static void ui_task()
+{
+  while (!stop)
+    ui_runner_run_once();
+}
+
+static void stop_ui_task(std::thread &task)
+{
+  stop = true;
+  ui_runner_notify(UI_EVENT_MESSAGE);
+  task.join();
+}
+
+void setUp(void)
+{
+  handler_runs = 0;
+  next_deadline_ms = UI_RUNNER_WAIT_FOREVER;
+  handler_work_us = 0;
+  stop = false;
+  ui_runner_init(fake_handler, clock_us, 1000);
+}
+
+void tearDown(void)
+{
+}
+
+static void sleep_ms(uint32_t ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void test_static_screen_sleeps(void)
+{
+  // No timers: only the max sleep wakes it up
+  std::thread task(ui_task);
+  sleep_ms(1500);
+  UiRunnerStats stats;
+  ui_runner_get_stats(&stats);
+  stop_ui_task(task);
+
+  printf("static screen: %u wakeups in 1.5 s, duty cycle %u%%\n", stats.wakeups, stats.duty_percent);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, stats.wakeups);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.event_wakeups);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.duty_percent);
+}
+
+void test_deadline(void)
+{
+  // A 100 ms timer (e.g. a clock label) runs ~10 times in a second, not 1000 times
+  next_deadline_ms = 100;
+  std::thread task(ui_task);
+  sleep_ms(1000);
+  stop_ui_task(task);
+
+  UiRunnerStats stats;
+  ui_runner_get_stats(&stats);
+  printf("100 ms timer: %u handler runs in 1 s\n", (uint32_t)handler_runs);
+  TEST_ASSERT_UINT32_WITHIN(2, 10, stats.deadline_wakeups);
+}
+
+void test_events_wake_up(void)
+{
+  std::thread task(ui_task);
+  sleep_ms(20);
+  uint32_t runs = handler_runs;
+
+  // Touch interrupt: handled right away instead of after the max sleep
+  uint32_t t = clock_us();
+  ui_runner_notify_from_isr(UI_EVENT_TOUCH);
+  while (handler_runs == runs && clock_us() - t < 500000)
+    ;
+  t = clock_us() - t;
+  printf("touch to handler: %u us\n", t);
+  TEST_ASSERT_EQUAL_UINT32(runs + 1, handler_runs);
+  TEST_ASSERT_LESS_THAN_UINT32(50000, t);
+
+  stop_ui_task(task);
+  UiRunnerStats stats;
+  ui_runner_get_stats(&stats);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.event_wakeups);
+}
+
+static std::atomic<uint32_t> message_sum;
+static std::thread::id message_thread;
+
+static void message_cb(void *arg)
+{
+  message_sum += (uint32_t)(uintptr_t)arg;
+  message_thread = std::this_thread::get_id();
+}
+
+void test_messages(void)
+{
+  message_sum = 0;
+  std::thread task(ui_task);
+  sleep_ms(20);
+
+  // Called in the UI task, before the handler
+  TEST_ASSERT_TRUE(ui_runner_post(message_cb, (void *)1));
+  TEST_ASSERT_TRUE(ui_runner_post(message_cb, (void *)2));
+  uint32_t t = clock_us();
+  while (message_sum != 3 && clock_us() - t < 500000)
+    ;
+  TEST_ASSERT_EQUAL_UINT32(3, message_sum);
+  TEST_ASSERT_TRUE(message_thread == task.get_id());
+  stop_ui_task(task);
+
+  // The queue is limited while the UI task doesn't run
+  uint32_t i;
+  for (i = 0; i < UI_RUNNER_QUEUE_LEN; i++)
+    TEST_ASSERT_TRUE(ui_runner_post(message_cb, (void *)0));
+  TEST_ASSERT_FALSE(ui_runner_post(message_cb, (void *)0));
+}
+
+void test_duty_cycle(void)
+{
+  // 2 ms of work every 10 ms
+  next_deadline_ms = 8;
+  handler_work_us = 2000;
+  std::thread task(ui_task);
+  sleep_ms(500);
+  UiRunnerStats stats;
+  ui_runner_get_stats(&stats);
+  stop_ui_task(task);
+
+  printf("busy UI: %u wakeups, duty cycle %u%%\n", stats.wakeups, stats.duty_percent);
+  TEST_ASSERT_UINT32_WITHIN(8, 20, stats.duty_percent);
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_static_screen_sleeps);
+  RUN_TEST(test_deadline);
+  RUN_TEST(test_events_wake_up);
+  RUN_TEST(test_messages);
+  RUN_TEST(test_duty_cycle);
+  return UNITY_END();
+}
@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * Host tests of the WiFi profiles and the network selection (pio test -e native)
+ *
+ * The scan tables are synthetic: a few APs of known and unknown networks with
+ * chosen signal levels.
+ ******************************************************************************/
+
+#include <unity.h>
+#include <string.h>
+#include "wifi/wifi_profiles.h"
+
+static const WiFiRoamParams params = {-85, -70, 8};
+static WiFiProfileStore store;
+
+static WiFiScanEntry ap(const char *ssid, uint8_t id, int8_t rssi)
+{
+  WiFiScanEntry e;
+  memset(&e, 0, sizeof(e));
+  strcpy(e.ssid, ssid);
+  memset(e.bssid, id, sizeof(e.bssid));
+  e.channel = id % 13 + 1;
+  e.rssi = rssi;
+  return e;
+}
+
+void setUp(void)
+{
+  store = WiFiProfileStore();
+  store.add("home", "secret", 0);
+  store.add("office", "secret2", 0);
+  store.add("phone", "hotspot", -10); // only if nothing else
+}
+
+void tearDown(void)
+{
+}
+
+void test_store(void)
+{
+  TEST_ASSERT_EQUAL_INT(3, store.count());
+  TEST_ASSERT_EQUAL_INT(1, store.find("office"));
+  TEST_ASSERT_EQUAL_INT(-1, store.find("cafe"));
+
+  // Update in place
+  TEST_ASSERT_TRUE(store.add("office", "newpass", 5));
+  TEST_ASSERT_EQUAL_INT(3, store.count());
+  TEST_ASSERT_EQUAL_STRING("newpass", store.get(1).password);
+  TEST_ASSERT_EQUAL_INT8(5, store.get(1).priority);
+
+  TEST_ASSERT_TRUE(store.remove("home"));
+  TEST_ASSERT_FALSE(store.remove("home"));
+  TEST_ASSERT_EQUAL_INT(2, store.count());
+  TEST_ASSERT_EQUAL_STRING("office", store.get(0).ssid);
+
+  // Limits
+  TEST_ASSERT_FALSE(store.add("", "x", 0));
+  TEST_ASSERT_FALSE(store.add("0123456789012345678901234567890123", "x", 0));
+  for (int i = 0; i < WIFI_MAX_PROFILES; i++)
+  {
+    char ssid[8];
+    sprintf(ssid, "net%d", i);
+    store.add(ssid, "", 0);
+  }
+  TEST_ASSERT_EQUAL_INT(WIFI_MAX_PROFILES, store.count());
+  TEST_ASSERT_FALSE(store.add("one too many", "", 0));
+}
+
+void test_store_load(void)
+{
+  // Round trip through the raw data as stored in NVS
+  WiFiProfile raw[WIFI_MAX_PROFILES];
+  memcpy(raw, store.data(), store.count() * sizeof(WiFiProfile));
+  raw[1].ssid[WIFI_SSID_LEN] = 'x'; // not terminated
+  memset(raw[2].ssid, 0, sizeof(raw[2].ssid));
+
+  WiFiProfileStore loaded;
+  loaded.load(raw, 3);
+  TEST_ASSERT_EQUAL_INT(2, loaded.count());
+  TEST_ASSERT_EQUAL_STRING("office", loaded.get(1).ssid);
+}
+
+void test_select_best(void)
+{
+  WiFiScanEntry scan[] = {
+      ap("cafe", 1, -40),   // unknown
+      ap("home", 2, -75),
+      ap("office", 3, -60),
+      ap("home", 4, -55),   // second AP of the same network
+      ap("phone", 5, -50),  // strong but lower priority
+  };
+
+  WiFiChoice c = wifiSelectNetwork(store, scan, 5, nullptr, params);
+  TEST_ASSERT_EQUAL_INT(3, c.entry);
+  TEST_ASSERT_EQUAL_INT(0, c.profile);
+
+  // Nothing known in reach
+  WiFiScanEntry far[] = {ap("cafe", 1, -40), ap("home", 2, -90)};
+  c = wifiSelectNetwork(store, far, 2, nullptr, params);
+  TEST_ASSERT_EQUAL_INT(-1, c.entry);
+
+  // Only the hotspot
+  WiFiScanEntry hotspot[] = {ap("home", 2, -88), ap("phone", 5, -50)};
+  c = wifiSelectNetwork(store, hotspot, 2, nullptr, params);
+  TEST_ASSERT_EQUAL_INT(1, c.entry);
+  TEST_ASSERT_EQUAL_INT(2, c.profile);
+
+  c = wifiSelectNetwork(store, scan, 0, nullptr, params);
+  TEST_ASSERT_EQUAL_INT(-1, c.entry);
+}
+
+void test_stay_on_good_link(void)
+{
+  WiFiScanEntry scan[] = {ap("home", 2, -65), ap("home", 4, -40)};
+
+  // -65 dBm is still good: don't drop the connection for a stronger AP
+  WiFiScanEntry current = ap("home", 2, -65);
+  WiFiChoice c = wifiSelectNetwork(store, scan, 2, &current, params);
+  TEST_ASSERT_EQUAL_INT(-1, c.entry);
+
+  // Already on the best AP
+  current = ap("home", 4, -40);
+  c = wifiSelectNetwork(store, scan, 2, &current, params);
+  TEST_ASSERT_EQUAL_INT(-1, c.entry);
+}
+
+void test_roam_on_weak_link(void)
+{
+  WiFiScanEntry scan[] = {ap("home", 2, -78), ap("home", 4, -62), ap("office", 3, -74)};
+
+  // Weak, and a much better AP: roam before the link is lost
+  WiFiScanEntry current = ap("home", 2, -78);
+  WiFiChoice c = wifiSelectNetwork(store, scan, 3, &current, params);
+  TEST_ASSERT_EQUAL_INT(1, c.entry);
+
+  // Hysteresis: two APs of about the same strength don't ping-pong
+  WiFiScanEntry similar[] = {ap("home", 2, -76), ap("home", 4, -72)};
+  current = ap("home", 2, -76);
+  c = wifiSelectNetwork(store, similar, 2, &current, params);
+  TEST_ASSERT_EQUAL_INT(-1, c.entry);
+  current = ap("home", 4, -72);
+  c = wifiSelectNetwork(store, similar, 2, &current, params);
+  TEST_ASSERT_EQUAL_INT(-1, c.entry);
+
+  // The live RSSI of the connection counts, not the one in the older scan
+  current = ap("home", 2, -66);
+  c = wifiSelectNetwork(store, scan, 3, &current, params);
+  TEST_ASSERT_EQUAL_INT(-1, c.entry);
+}
+
+void test_preferred_network(void)
+{
+  WiFiScanEntry scan[] = {ap("phone", 5, -45), ap("home", 2, -60)};
+
+  // On the hotspot with a good signal, home comes in reach: move to it
+  WiFiScanEntry current = ap("phone", 5, -45);
+  WiFiChoice c = wifiSelectNetwork(store, scan, 2, &current, params);
+  TEST_ASSERT_EQUAL_INT(1, c.entry);
+  TEST_ASSERT_EQUAL_INT(0, c.profile);
+
+  // ... but not while home is still weak
+  WiFiScanEntry weak[] = {ap("phone", 5, -45), ap("home", 2, -75)};
+  c = wifiSelectNetwork(store, weak, 2, &current, params);
+  TEST_ASSERT_EQUAL_INT(-1, c.entry);
+
+  // A lower priority network is never preferred over a good link
+  current = ap("home", 2, -60);
+  WiFiScanEntry strong_phone[] = {ap("phone", 5, -30), ap("home", 2, -60)};
+  c = wifiSelectNetwork(store, strong_phone, 2, &current, params);
+  TEST_ASSERT_EQUAL_INT(-1, c.entry);
+}
+
+void test_roam_sequence(void)
+{
+  // Walking from AP 2 to AP 4: the signals cross, the roam happens once,
+  // after the crossing by the hysteresis and while the link still works
+  WiFiScanEntry current = ap("home", 2, -50);
+  int roams = 0;
+  int roam_at = 0;
+  for (int step = 0; step <= 30; step++)
+  {
+    int8_t a = -50 - step;
+    int8_t b = -80 + step;
+    WiFiScanEntry scan[] = {ap("home", 2, a), ap("home", 4, b)};
+    current.rssi = current.bssid[0] == 2 ? a : b;
+
+    WiFiChoice c = wifiSelectNetwork(store, scan, 2, &current, params);
+    if (c.entry >= 0)
+    {
+      roams++;
+      roam_at = step;
+      current = scan[c.entry];
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(1, roams);
+  TEST_ASSERT_EQUAL_UINT8(4, current.bssid[0]);
+  TEST_ASSERT_TRUE(roam_at > 15);  // after the crossing
+  TEST_ASSERT_TRUE(-50 - roam_at > params.minRssi); // before the old AP is unusable
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_store);
+  RUN_TEST(test_store_load);
+  RUN_TEST(test_select_best);
+  RUN_TEST(test_stay_on_good_link);
+  RUN_TEST(test_roam_on_weak_link);
+  RUN_TEST(test_preferred_network);
+  RUN_TEST(test_roam_sequence);
+  return UNITY_END();
+}
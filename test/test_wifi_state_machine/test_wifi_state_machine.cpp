@@ -0,0 +1,343 @@
+/*******************************************************************************
+ * Host tests of the WiFi state machine (pio test -e native)
+ *
+ * A fake driver records the calls and the tests play the WiFi events at
+ * chosen times.
+ ******************************************************************************/
+
+#include <unity.h>
+#include <string.h>
+#include "wifi/wifi_state_machine.h"
+
+struct FakeWiFi
+{
+  uint32_t connects;
+  uint32_t fastConnects;
+  uint32_t disconnects;
+  uint32_t saves;
+  WiFiLink lastLink; // link of the last fast connect
+  WiFiLink saved;
+};
+
+static FakeWiFi fake;
+
+static void fakeConnect(void *ctx, const WiFiLink *link)
+{
+  FakeWiFi *f = (FakeWiFi *)ctx;
+  f->connects++;
+  if (link)
+  {
+    f->fastConnects++;
+    f->lastLink = *link;
+  }
+}
+
+static void fakeDisconnect(void *ctx)
+{
+  ((FakeWiFi *)ctx)->disconnects++;
+}
+
+static void fakeSave(void *ctx, const WiFiLink *link)
+{
+  FakeWiFi *f = (FakeWiFi *)ctx;
+  f->saves++;
+  f->saved = *link;
+}
+
+static const WiFiDriver fakeDriver = {&fake, fakeConnect, fakeDisconnect, fakeSave};
+static const WiFiTimings timings = {1500, 10000, 1000, 60000};
+
+static WiFiLink homeLink()
+{
+  WiFiLink link = {{0x10, 0x20, 0x30, 0x40, 0x50, 0x60}, 6, 0x6401A8C0, 0x0101A8C0, 0x00FFFFFF, 0x0101A8C0};
+  return link;
+}
+
+// Run the deadline like the timer would
+static void runUntil(WiFiStateMachine &sm, uint32_t *now, uint32_t end)
+{
+  while (true)
+  {
+    uint32_t left = sm.timeUntilDeadline(*now);
+    if (left == WIFI_SM_NO_DEADLINE || *now + left > end)
+      break;
+    *now += left;
+    sm.timeout(*now);
+  }
+  *now = end;
+}
+
+void setUp(void)
+{
+  memset(&fake, 0, sizeof(fake));
+}
+
+void tearDown(void)
+{
+}
+
+void test_first_connect(void)
+{
+  WiFiStateMachine sm(fakeDriver, timings);
+
+  // Nothing cached: normal connection
+  sm.start(0, nullptr);
+  TEST_ASSERT_EQUAL(WIFI_SM_CONNECT, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(1, fake.connects);
+  TEST_ASSERT_EQUAL_UINT32(0, fake.fastConnects);
+  TEST_ASSERT_EQUAL_UINT32(10000, sm.timeUntilDeadline(0));
+
+  WiFiLink link = homeLink();
+  sm.gotIP(3200, link);
+  TEST_ASSERT_EQUAL(WIFI_SM_CONNECTED, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(WIFI_SM_NO_DEADLINE, sm.timeUntilDeadline(3200));
+
+  // The link is stored for the next boot
+  TEST_ASSERT_EQUAL_UINT32(1, fake.saves);
+  TEST_ASSERT_EQUAL_UINT8(6, fake.saved.channel);
+  TEST_ASSERT_EQUAL_UINT32(link.ip, fake.saved.ip);
+
+  const WiFiStats &stats = sm.getStats();
+  TEST_ASSERT_EQUAL_UINT32(3200, stats.lastConnectMs);
+  TEST_ASSERT_EQUAL_UINT32(3200, stats.connectMs);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.connects);
+}
+
+void test_fast_connect(void)
+{
+  WiFiStateMachine sm(fakeDriver, timings);
+  WiFiLink link = homeLink();
+
+  sm.start(0, &link);
+  TEST_ASSERT_EQUAL(WIFI_SM_FAST_CONNECT, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(1, fake.fastConnects);
+  TEST_ASSERT_EQUAL_MEMORY(link.bssid, fake.lastLink.bssid, 6);
+  TEST_ASSERT_EQUAL_UINT32(1500, sm.timeUntilDeadline(0));
+
+  sm.gotIP(180, link);
+  TEST_ASSERT_EQUAL(WIFI_SM_CONNECTED, sm.getState());
+  // Same network: no flash write
+  TEST_ASSERT_EQUAL_UINT32(0, fake.saves);
+  TEST_ASSERT_EQUAL_UINT32(180, sm.getStats().fastConnectMs);
+  TEST_ASSERT_EQUAL_UINT32(1, sm.getStats().fastConnects);
+}
+
+void test_stale_link(void)
+{
+  WiFiStateMachine sm(fakeDriver, timings);
+  WiFiLink link = homeLink();
+
+  // The AP moved to an other channel: the fast attempt times out
+  sm.start(0, &link);
+  uint32_t now = 0;
+  runUntil(sm, &now, 1500);
+  TEST_ASSERT_EQUAL(WIFI_SM_CONNECT, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(2, fake.connects);
+  TEST_ASSERT_EQUAL_UINT32(1, fake.fastConnects);
+  TEST_ASSERT_EQUAL_UINT32(1, sm.getStats().failures);
+
+  WiFiLink moved = link;
+  moved.channel = 11;
+  sm.gotIP(4000, moved);
+  TEST_ASSERT_EQUAL_UINT32(1, fake.saves);
+  TEST_ASSERT_EQUAL_UINT8(11, fake.saved.channel);
+  TEST_ASSERT_EQUAL_UINT32(2500, sm.getStats().lastConnectMs);
+
+  // A rejected fast attempt (disconnect event) falls back right away too
+  memset(&fake, 0, sizeof(fake));
+  WiFiStateMachine sm2(fakeDriver, timings);
+  sm2.start(0, &link);
+  sm2.disconnected(50);
+  TEST_ASSERT_EQUAL(WIFI_SM_CONNECT, sm2.getState());
+  TEST_ASSERT_EQUAL_UINT32(10000, sm2.timeUntilDeadline(50));
+}
+
+void test_backoff(void)
+{
+  WiFiStateMachine sm(fakeDriver, timings);
+  uint32_t now = 0;
+  sm.start(now, nullptr);
+
+  // The AP is off: every attempt times out, the wait doubles up to the maximum
+  uint32_t expected[] = {1000, 2000, 4000, 8000, 16000, 32000, 60000, 60000};
+  for (uint32_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++)
+  {
+    TEST_ASSERT_EQUAL(WIFI_SM_CONNECT, sm.getState());
+    now += 10000;
+    sm.timeout(now);
+    TEST_ASSERT_EQUAL(WIFI_SM_BACKOFF, sm.getState());
+    TEST_ASSERT_EQUAL_UINT32(expected[i], sm.timeUntilDeadline(now));
+    TEST_ASSERT_EQUAL_UINT32(expected[i], sm.getStats().backoffMs);
+
+    // Nothing happens before the deadline
+    sm.timeout(now + expected[i] - 1);
+    TEST_ASSERT_EQUAL(WIFI_SM_BACKOFF, sm.getState());
+    now += expected[i];
+    sm.timeout(now);
+  }
+  TEST_ASSERT_EQUAL_UINT32(9, fake.connects);
+  TEST_ASSERT_EQUAL_UINT32(8, sm.getStats().failures);
+
+  // A success resets the backoff
+  sm.gotIP(now + 3000, homeLink());
+  sm.disconnected(now + 5000);
+  TEST_ASSERT_EQUAL(WIFI_SM_FAST_CONNECT, sm.getState());
+  sm.disconnected(now + 5100);
+  sm.disconnected(now + 6000);
+  TEST_ASSERT_EQUAL(WIFI_SM_BACKOFF, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(1000, sm.timeUntilDeadline(now + 6000));
+}
+
+void test_reconnect(void)
+{
+  WiFiStateMachine sm(fakeDriver, timings);
+  WiFiLink link = homeLink();
+  sm.start(0, nullptr);
+  sm.gotIP(3000, link);
+
+  // Lost connection: rejoin the same AP at once, no backoff
+  sm.disconnected(60000);
+  TEST_ASSERT_EQUAL(WIFI_SM_FAST_CONNECT, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(1, sm.getStats().disconnects);
+  TEST_ASSERT_EQUAL_UINT32(1, fake.fastConnects);
+  TEST_ASSERT_EQUAL_UINT32(link.ip, fake.lastLink.ip);
+
+  sm.gotIP(60150, link);
+  const WiFiStats &stats = sm.getStats();
+  TEST_ASSERT_EQUAL_UINT32(150, stats.lastConnectMs);
+  TEST_ASSERT_EQUAL_UINT32(150, stats.fastConnectMs);
+  TEST_ASSERT_EQUAL_UINT32(3000, stats.connectMs);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.connects);
+}
+
+void test_roam(void)
+{
+  WiFiStateMachine sm(fakeDriver, timings);
+  sm.start(0, nullptr);
+  WiFiLink other = homeLink();
+  other.channel = 11;
+  other.ip = 0;
+
+  // Not while an attempt is running
+  sm.roam(100, other);
+  TEST_ASSERT_EQUAL(WIFI_SM_CONNECT, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(1, fake.connects);
+
+  // From a connection: leave the AP and join the other one directly
+  sm.gotIP(3000, homeLink());
+  sm.roam(20000, other);
+  TEST_ASSERT_EQUAL(WIFI_SM_FAST_CONNECT, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(1, fake.disconnects);
+  TEST_ASSERT_EQUAL_UINT8(11, fake.lastLink.channel);
+  TEST_ASSERT_EQUAL_UINT32(1, sm.getStats().roams);
+
+  sm.gotIP(20300, other);
+  TEST_ASSERT_EQUAL_UINT32(300, sm.getStats().lastConnectMs);
+  TEST_ASSERT_EQUAL_UINT8(11, fake.saved.channel);
+
+  // From the backoff: try the other network without waiting
+  sm.disconnected(30000);
+  sm.disconnected(30100);
+  sm.disconnected(30200);
+  TEST_ASSERT_EQUAL(WIFI_SM_BACKOFF, sm.getState());
+  sm.roam(30300, homeLink());
+  TEST_ASSERT_EQUAL(WIFI_SM_FAST_CONNECT, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(1, sm.getStats().roams);
+}
+
+void test_scan(void)
+{
+  WiFiStateMachine sm(fakeDriver, timings);
+  uint32_t now = 0;
+
+  // Not during an attempt
+  sm.start(now, nullptr);
+  TEST_ASSERT_FALSE(sm.scanStart(now, 1760));
+
+  // Not if the backoff ends before the scan would
+  now += 10000;
+  sm.timeout(now);
+  TEST_ASSERT_EQUAL_UINT32(1000, sm.timeUntilDeadline(now));
+  TEST_ASSERT_FALSE(sm.scanStart(now, 1760));
+  runUntil(sm, &now, now + 1000);
+  now += 10000;
+  sm.timeout(now);
+  TEST_ASSERT_EQUAL_UINT32(2000, sm.timeUntilDeadline(now));
+  TEST_ASSERT_TRUE(sm.scanStart(now, 1760));
+
+  // The scan took longer: the attempt waits for its end
+  uint32_t connects = fake.connects;
+  runUntil(sm, &now, now + 2500);
+  TEST_ASSERT_EQUAL(WIFI_SM_BACKOFF, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(connects, fake.connects);
+  TEST_ASSERT_EQUAL_UINT32(WIFI_SM_NO_DEADLINE, sm.timeUntilDeadline(now));
+
+  sm.scanEnd(now);
+  TEST_ASSERT_EQUAL_UINT32(0, sm.timeUntilDeadline(now));
+  sm.timeout(now);
+  TEST_ASSERT_EQUAL(WIFI_SM_CONNECT, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(connects + 1, fake.connects);
+
+  // Connection lost during a scan: rejoin after it
+  sm.gotIP(now + 3000, homeLink());
+  now += 20000;
+  TEST_ASSERT_TRUE(sm.scanStart(now, 1760));
+  sm.disconnected(now + 500);
+  TEST_ASSERT_EQUAL(WIFI_SM_BACKOFF, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(connects + 1, fake.connects);
+  sm.scanEnd(now + 1760);
+  sm.timeout(now + 1760);
+  TEST_ASSERT_EQUAL(WIFI_SM_FAST_CONNECT, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(connects + 2, fake.connects);
+
+  // A scan without anything due changes nothing
+  sm.gotIP(now + 2000, homeLink());
+  TEST_ASSERT_TRUE(sm.scanStart(now + 30000, 1760));
+  sm.scanEnd(now + 31760);
+  TEST_ASSERT_EQUAL(WIFI_SM_CONNECTED, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(WIFI_SM_NO_DEADLINE, sm.timeUntilDeadline(now + 31760));
+}
+
+void test_stop(void)
+{
+  WiFiStateMachine sm(fakeDriver, timings);
+  sm.start(0, nullptr);
+  sm.stop(100);
+  TEST_ASSERT_EQUAL(WIFI_SM_IDLE, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(1, fake.disconnects);
+  TEST_ASSERT_EQUAL_UINT32(WIFI_SM_NO_DEADLINE, sm.timeUntilDeadline(100));
+
+  // Late events of the stopped attempt are ignored
+  sm.gotIP(200, homeLink());
+  sm.disconnected(300);
+  sm.timeout(20000);
+  TEST_ASSERT_EQUAL(WIFI_SM_IDLE, sm.getState());
+  TEST_ASSERT_EQUAL_UINT32(1, fake.connects);
+}
+
+void test_clock_wrap(void)
+{
+  WiFiStateMachine sm(fakeDriver, timings);
+  uint32_t now = 0xFFFFFF00;
+  sm.start(now, nullptr);
+  TEST_ASSERT_EQUAL_UINT32(10000, sm.timeUntilDeadline(now));
+  sm.timeout(now + 5000);
+  TEST_ASSERT_EQUAL(WIFI_SM_CONNECT, sm.getState());
+  sm.timeout(now + 10000);
+  TEST_ASSERT_EQUAL(WIFI_SM_BACKOFF, sm.getState());
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_first_connect);
+  RUN_TEST(test_fast_connect);
+  RUN_TEST(test_stale_link);
+  RUN_TEST(test_backoff);
+  RUN_TEST(test_reconnect);
+  RUN_TEST(test_roam);
+  RUN_TEST(test_scan);
+  RUN_TEST(test_stop);
+  RUN_TEST(test_clock_wrap);
+  return UNITY_END();
+}